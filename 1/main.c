@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <errno.h>
+#include <ctype.h>
+#include <limits.h>
+
+/* 数值解析与格式化与 2/、3/ 共用。Number parsing and formatting shared with 2/ and 3/.
+ * 编译 Build: gcc -std=c11 -I../common main.c ../common/numtext.c -o signal_seq */
+#include "numtext.h"
 
 /**
  * @brief 输入结束标记（停止记号）字符串；用户输入该字符串时结束序列输入。Stop token string; inputting this ends the sequence input.
@@ -9,22 +14,156 @@
 #define STOP_TOKEN "STOP"
 
 /**
- * @brief 初始容量；用于可扩展序列的起始分配大小。Initial capacity for dynamic sequence allocation.
+ * @brief 段长的以 2 为底的对数；每段 1024 个样本（8 KiB）。Log2 of the segment length; 1024 samples (8 KiB) per segment.
+ */
+#define SEGMENT_SHIFT 10
+
+/**
+ * @brief 每段样本数。Samples per segment.
  */
-#define INITIAL_CAPACITY 8
+#define SEGMENT_SIZE (1 << SEGMENT_SHIFT)
+
+/**
+ * @brief 段内偏移掩码。Mask of the offset within a segment.
+ */
+#define SEGMENT_MASK (SEGMENT_SIZE - 1)
+
+/**
+ * @brief 段索引的初始槽数；可扩展序列从这里开始按需翻倍。Initial slots of the segment index, doubled on demand.
+ */
+#define INITIAL_SEGMENTS 8
 
 /**
  * @brief 信号序列结构体，支持自定义起始下标和动态长度。Signal sequence with custom start index and dynamic length.
+ *
+ * @note 样本保存在定长段中，段指针集中在段索引里，已用段位于索引中部：
+ *       两端增长都只新分配一段，已有样本从不搬移，只在索引用尽时复制段指针，
+ *       因此头尾追加均摊 O(1)，按下标访问 O(1)。
+ *       Samples live in fixed-size segments whose pointers sit in the middle
+ *       of a segment index: growth at either end only allocates one new
+ *       segment and never moves samples, and only the segment pointers are
+ *       copied when the index runs out, so append and prepend are amortized
+ *       O(1) and indexed access is O(1).
  */
 typedef struct
 {
-    int start;        /**< 序列起始下标；可以为负数。Start index, can be negative. */
-    int length;       /**< 当前已使用长度。Current logical length. */
-    int capacity;     /**< 已分配容量。Allocated capacity. */
-    int allow_expand; /**< 是否允许扩展（1=可无限追加，0=固定长度）。Whether expansion is allowed. */
-    double *data;     /**< 实际数据存储区。Underlying data buffer. */
+    int start;          /**< 序列起始下标；可以为负数。Start index, can be negative. */
+    int length;         /**< 当前已使用长度。Current logical length. */
+    int allow_expand;   /**< 是否允许扩展（1=可在两端无限追加，0=固定长度）。Whether expansion is allowed. */
+    double **segments;  /**< 段索引。Segment index. */
+    int index_capacity; /**< 段索引槽数。Slots in the segment index. */
+    int first_segment;  /**< 第一个已用段在索引中的位置。Index slot of the first segment in use. */
+    int segment_count;  /**< 已分配段数。Number of allocated segments. */
+    int head;           /**< 第 0 个样本在第一段内的偏移。Offset of sample 0 within the first segment. */
 } SignalSeq;
 
+/**
+ * @brief 释放信号序列占用的内存。Free resources owned by a signal sequence.
+ *
+ * @param seq [in,out] 需要释放的序列；可为NULL。Sequence to free; may be NULL.
+ * @note 调用后段索引置为 NULL，长度清零。The segment index will be NULL after this call.
+ */
+static void signal_seq_free(SignalSeq *seq)
+{
+    if (seq == NULL)
+    {
+        return;
+    }
+    if (seq->segments != NULL)
+    {
+        for (int i = 0; i < seq->segment_count; ++i)
+        {
+            free(seq->segments[seq->first_segment + i]);
+        }
+        free(seq->segments);
+        seq->segments = NULL;
+    }
+    seq->start = 0;
+    seq->length = 0;
+    seq->allow_expand = 0;
+    seq->index_capacity = 0;
+    seq->first_segment = 0;
+    seq->segment_count = 0;
+    seq->head = 0;
+}
+
+/**
+ * @brief 扩大段索引，已用段重新置于中部。Grow the segment index and re-centre the segments in use.
+ *
+ * @param seq [in,out] 序列指针。Sequence pointer.
+ * @return 0 表示成功；非0表示失败。0 on success; non-zero on failure.
+ * @note 只复制段指针，不搬移样本。Only segment pointers are copied, never samples.
+ */
+static int signal_seq_grow_index(SignalSeq *seq)
+{
+    int new_capacity = (seq->index_capacity > 0) ? seq->index_capacity : INITIAL_SEGMENTS;
+    if (seq->segment_count + 2 > new_capacity / 2)
+    {
+        if (new_capacity > INT_MAX / 2)
+        {
+            fprintf(stderr, "Error: segment index is too large.\n");
+            return -1;
+        }
+        new_capacity *= 2;
+    }
+
+    double **index = (double **)calloc((size_t)new_capacity, sizeof(double *));
+    if (index == NULL)
+    {
+        fprintf(stderr, "Error: failed to allocate the segment index.\n");
+        return -1;
+    }
+
+    int first = (new_capacity - seq->segment_count) / 2;
+    if (seq->segment_count > 0)
+    {
+        memcpy(index + first, seq->segments + seq->first_segment,
+               (size_t)seq->segment_count * sizeof(double *));
+    }
+    free(seq->segments);
+    seq->segments = index;
+    seq->index_capacity = new_capacity;
+    seq->first_segment = first;
+    return 0;
+}
+
+/**
+ * @brief 在一端新增一个段。Add one segment at either end.
+ *
+ * @param seq [in,out] 序列指针。Sequence pointer.
+ * @param at_front [in] 非0加在前端，否则加在后端。Non-zero adds at the front, else at the back.
+ * @return 0 表示成功；非0表示失败。0 on success; non-zero on failure.
+ */
+static int signal_seq_add_segment(SignalSeq *seq, int at_front)
+{
+    int full = at_front ? (seq->first_segment == 0)
+                        : (seq->first_segment + seq->segment_count >= seq->index_capacity);
+    if (full && signal_seq_grow_index(seq) != 0)
+    {
+        return -1;
+    }
+
+    double *segment = (double *)malloc((size_t)SEGMENT_SIZE * sizeof(double));
+    if (segment == NULL)
+    {
+        fprintf(stderr, "Error: failed to allocate a sequence segment.\n");
+        return -1;
+    }
+
+    if (at_front)
+    {
+        seq->first_segment -= 1;
+        seq->segments[seq->first_segment] = segment;
+        seq->head += SEGMENT_SIZE;
+    }
+    else
+    {
+        seq->segments[seq->first_segment + seq->segment_count] = segment;
+    }
+    seq->segment_count += 1;
+    return 0;
+}
+
 /**
  * @brief 初始化信号序列。Initialize a signal sequence.
  *
@@ -33,7 +172,8 @@ typedef struct
  * @param initial_length [in] 初始长度（固定模式下为目标长度；可扩展模式下通常为0）。Initial length.
  * @param allow_expand [in] 是否允许扩展（非0为可扩展）。Whether expansion is allowed.
  * @return 0 表示成功；非0表示失败。0 on success; non-zero on failure.
- * @note 若失败，seq->data 将为 NULL。On failure, seq->data will be NULL.
+ * @note 若失败，seq->segments 将为 NULL。初始样本未初始化。
+ *       On failure, seq->segments will be NULL. Initial samples are uninitialized.
  */
 static int signal_seq_init(SignalSeq *seq, int start, int initial_length, int allow_expand)
 {
@@ -43,81 +183,70 @@ static int signal_seq_init(SignalSeq *seq, int start, int initial_length, int al
         return -1;
     }
 
+    memset(seq, 0, sizeof(*seq));
     if (initial_length < 0)
     {
         fprintf(stderr, "Error: initial length must be non-negative.\n");
         return -1;
     }
+    if (start > INT_MAX - initial_length)
+    {
+        fprintf(stderr, "Error: sequence end index overflows.\n");
+        return -1;
+    }
 
-    int capacity = initial_length;
-    if (allow_expand)
+    int segments = (initial_length >> SEGMENT_SHIFT) + ((initial_length & SEGMENT_MASK) != 0);
+    int capacity = segments;
+    if (allow_expand && capacity < INITIAL_SEGMENTS)
     {
-        if (capacity < INITIAL_CAPACITY)
-        {
-            capacity = INITIAL_CAPACITY;
-        }
+        capacity = INITIAL_SEGMENTS;
     }
 
-    double *buffer = NULL;
     if (capacity > 0)
     {
-        buffer = (double *)malloc((size_t)capacity * sizeof(double));
-        if (buffer == NULL)
+        seq->segments = (double **)calloc((size_t)capacity, sizeof(double *));
+        if (seq->segments == NULL)
         {
             fprintf(stderr, "Error: failed to allocate memory for sequence.\n");
             return -1;
         }
+        seq->index_capacity = capacity;
+        seq->first_segment = (capacity - segments) / 2;
+    }
+
+    for (int i = 0; i < segments; ++i)
+    {
+        if (signal_seq_add_segment(seq, 0) != 0)
+        {
+            signal_seq_free(seq);
+            return -1;
+        }
     }
 
     seq->start = start;
     seq->length = initial_length;
-    seq->capacity = capacity;
     seq->allow_expand = allow_expand ? 1 : 0;
-    seq->data = buffer;
 
     return 0;
 }
 
 /**
- * @brief 释放信号序列占用的内存。Free resources owned by a signal sequence.
- *
- * @param seq [in,out] 需要释放的序列；可为NULL。Sequence to free; may be NULL.
- * @note 调用后 seq->data 置为 NULL，长度与容量清零。Data pointer will be NULL after this call.
- */
-static void signal_seq_free(SignalSeq *seq)
-{
-    if (seq == NULL)
-    {
-        return;
-    }
-    if (seq->data != NULL)
-    {
-        free(seq->data);
-        seq->data = NULL;
-    }
-    seq->start = 0;
-    seq->length = 0;
-    seq->capacity = 0;
-    seq->allow_expand = 0;
-}
-
-/**
- * @brief 将逻辑下标转换为物理下标。Map logical index to physical index.
+ * @brief 将逻辑下标转换为物理位置。Map logical index to its storage slot.
  *
  * @param seq [in] 序列指针。Sequence pointer.
  * @param logical_index [in] 逻辑下标。Logical index.
- * @param physical_index [out] 物理下标输出。Mapped physical index.
+ * @param slot [out] 样本地址输出。Address of the sample.
  * @return 0 表示成功；非0 表示越界或参数错误。0 on success; non-zero on error.
  */
-static int signal_seq_logical_to_physical(const SignalSeq *seq, int logical_index, int *physical_index)
+static int signal_seq_logical_to_physical(const SignalSeq *seq, int logical_index, double **slot)
 {
-    if (seq == NULL || physical_index == NULL)
+    if (seq == NULL || slot == NULL)
     {
         fprintf(stderr, "Error: NULL pointer in logical_to_physical.\n");
         return -1;
     }
 
-    int offset = logical_index - seq->start;
+    long long offset = (long long)logical_index - seq->start;
     if (offset < 0 || offset >= seq->length)
     {
         fprintf(stderr, "Error: logical index %d is out of range [%d, %d].\n",
@@ -125,7 +254,8 @@ static int signal_seq_logical_to_physical(const SignalSeq *seq, int logical_inde
         return -1;
     }
 
-    *physical_index = offset;
+    long long pos = seq->head + offset;
+    *slot = seq->segments[seq->first_segment + (int)(pos >> SEGMENT_SHIFT)] + (pos & SEGMENT_MASK);
     return 0;
 }
 
@@ -139,12 +269,12 @@ static int signal_seq_logical_to_physical(const SignalSeq *seq, int logical_inde
  */
 static int signal_seq_set(SignalSeq *seq, int logical_index, double value)
 {
-    int pos = 0;
-    if (signal_seq_logical_to_physical(seq, logical_index, &pos) != 0)
+    double *slot = NULL;
+    if (signal_seq_logical_to_physical(seq, logical_index, &slot) != 0)
     {
         return -1;
     }
-    seq->data[pos] = value;
+    *slot = value;
     return 0;
 }
 
@@ -158,17 +288,50 @@ static int signal_seq_set(SignalSeq *seq, int logical_index, double value)
  */
 static int signal_seq_get(const SignalSeq *seq, int logical_index, double *out_value)
 {
-    int pos = 0;
+    double *slot = NULL;
     if (out_value == NULL)
     {
         fprintf(stderr, "Error: out_value is NULL in signal_seq_get.\n");
         return -1;
     }
-    if (signal_seq_logical_to_physical(seq, logical_index, &pos) != 0)
+    if (signal_seq_logical_to_physical(seq, logical_index, &slot) != 0)
     {
         return -1;
     }
-    *out_value = seq->data[pos];
+    *out_value = *slot;
+    return 0;
+}
+
+/**
+ * @brief 取从逻辑下标开始的一段连续存储。Get the contiguous run of storage starting at a logical index.
+ *
+ * @param seq [in] 序列指针。Sequence pointer.
+ * @param logical_index [in] 起始逻辑下标。First logical index.
+ * @param data [out] 连续样本的地址。Address of the contiguous samples.
+ * @param count [out] 连续样本数（至多到段尾）。Number of contiguous samples (up to the segment end).
+ * @return 0 表示成功；非0 表示越界或参数错误。0 on success; non-zero on error.
+ * @note 逐段取出即可把整条序列交给 2/ 的 seq_stream_process() 或 3/ 的块接口，无需先拷贝成整块数组。
+ *       Walking it segment by segment feeds the whole sequence to
+ *       seq_stream_process() in 2/ or the block interfaces of 3/ without
+ *       first copying it into one flat array.
+ */
+static int signal_seq_span(const SignalSeq *seq, int logical_index, const double **data, int *count)
+{
+    double *slot = NULL;
+    if (data == NULL || count == NULL)
+    {
+        fprintf(stderr, "Error: NULL output in signal_seq_span.\n");
+        return -1;
+    }
+    if (signal_seq_logical_to_physical(seq, logical_index, &slot) != 0)
+    {
+        return -1;
+    }
+
+    int pos = (int)(((long long)seq->head + logical_index - seq->start) & SEGMENT_MASK);
+    int left = seq->start + seq->length - logical_index;
+    *data = slot;
+    *count = (SEGMENT_SIZE - pos < left) ? SEGMENT_SIZE - pos : left;
     return 0;
 }
 
@@ -178,7 +341,8 @@ static int signal_seq_get(const SignalSeq *seq, int logical_index, double *out_v
  * @param seq [in,out] 序列指针。Sequence pointer.
  * @param value [in] 要追加的值。Value to append.
  * @return 0 表示成功；非0 表示失败。0 on success; non-zero on error.
- * @note 固定长度序列不允许追加。Fixed-length sequences cannot be appended.
+ * @note 固定长度序列不允许追加。均摊 O(1)，已有样本不搬移。
+ *       Fixed-length sequences cannot be appended. Amortized O(1); existing samples never move.
  */
 static int signal_seq_append(SignalSeq *seq, double value)
 {
@@ -190,29 +354,71 @@ static int signal_seq_append(SignalSeq *seq, double value)
 
     if (!seq->allow_expand)
     {
-        if (seq->length >= seq->capacity)
+        fprintf(stderr, "Error: sequence is fixed-length; cannot append.\n");
+        return -1;
+    }
+
+    if (seq->length == INT_MAX || seq->start > INT_MAX - seq->length - 1)
+    {
+        fprintf(stderr, "Error: sequence end index overflows.\n");
+        return -1;
+    }
+
+    long long pos = (long long)seq->head + seq->length;
+    if (pos >= (long long)seq->segment_count * SEGMENT_SIZE)
+    {
+        if (signal_seq_add_segment(seq, 0) != 0)
         {
-            fprintf(stderr, "Error: sequence is fixed-length; cannot append.\n");
             return -1;
         }
     }
 
-    if (seq->length >= seq->capacity)
+    seq->length += 1;
+    return signal_seq_set(seq, seq->start + seq->length - 1, value);
+}
+
+/**
+ * @brief 在可扩展序列起点之前插入一个值，起始下标减一。Prepend a value before the start of an expandable sequence.
+ *
+ * @param seq [in,out] 序列指针。Sequence pointer.
+ * @param value [in] 新的 x[start-1]。The new x[start-1].
+ * @return 0 表示成功；非0 表示失败。0 on success; non-zero on error.
+ * @note 与追加对称，均摊 O(1)，已有样本的下标与存储都不变。
+ *       Symmetric to append: amortized O(1), and existing samples keep both
+ *       their indices and their storage.
+ */
+static int signal_seq_prepend(SignalSeq *seq, double value)
+{
+    if (seq == NULL)
+    {
+        fprintf(stderr, "Error: NULL sequence in signal_seq_prepend.\n");
+        return -1;
+    }
+
+    if (!seq->allow_expand)
+    {
+        fprintf(stderr, "Error: sequence is fixed-length; cannot prepend.\n");
+        return -1;
+    }
+
+    if (seq->length == INT_MAX || seq->start == INT_MIN)
+    {
+        fprintf(stderr, "Error: sequence start index underflows.\n");
+        return -1;
+    }
+
+    if (seq->head == 0)
     {
-        int new_capacity = (seq->capacity > 0) ? (seq->capacity * 2) : INITIAL_CAPACITY;
-        double *new_data = (double *)realloc(seq->data, (size_t)new_capacity * sizeof(double));
-        if (new_data == NULL)
+        if (signal_seq_add_segment(seq, 1) != 0)
         {
-            fprintf(stderr, "Error: failed to reallocate memory when appending.\n");
             return -1;
         }
-        seq->data = new_data;
-        seq->capacity = new_capacity;
     }
 
-    seq->data[seq->length] = value;
+    seq->head -= 1;
+    seq->start -= 1;
     seq->length += 1;
-    return 0;
+    return signal_seq_set(seq, seq->start, value);
 }
 
 /**
@@ -225,7 +431,7 @@ static int signal_seq_append(SignalSeq *seq, double value)
  */
 static int input_fixed_length(SignalSeq *seq)
 {
-    if (seq == NULL || seq->data == NULL)
+    if (seq == NULL || (seq->segments == NULL && seq->length > 0))
     {
         fprintf(stderr, "Error: invalid sequence in input_fixed_length.\n");
         return -1;
@@ -246,16 +452,22 @@ static int input_fixed_length(SignalSeq *seq)
                 return -1;
             }
 
-            char *endptr = NULL;
-            errno = 0;
-            double v = strtod(buffer, &endptr);
-            if (endptr == buffer || errno != 0)
+            const char *p = buffer;
+            while (isspace((unsigned char)*p))
+            {
+                ++p;
+            }
+            double v = 0.0;
+            if (num_scan_double_strict(p, strlen(p), &v) == 0)
             {
                 fprintf(stderr, "Error: invalid number, please try again.\n");
                 continue;
             }
 
-            seq->data[i] = v;
+            if (signal_seq_set(seq, logical_index, v) != 0)
+            {
+                return -1;
+            }
             break;
         }
     }
@@ -270,7 +482,9 @@ static int input_fixed_length(SignalSeq *seq)
  * @param stop_token [in] 停止记号字符串。Stop token string.
  * @return 0 表示成功；非0 表示失败。0 on success; non-zero on error.
  * @example
- * 用户逐行输入数值，输入 "STOP" 后结束。User inputs values line by line; type "STOP" to finish.
+ * 用户逐行输入数值，输入 "STOP" 后结束；以 '<' 开头的值插到当前起点之前。
+ * User inputs values line by line; type "STOP" to finish. A value prefixed
+ * with '<' is inserted before the current start.
  */
 static int input_unbounded(SignalSeq *seq, const char *stop_token)
 {
@@ -290,14 +504,14 @@ static int input_unbounded(SignalSeq *seq, const char *stop_token)
         return -1;
     }
 
-    printf("Enter values one per line. Type %s to stop.\n", stop_token);
+    printf("Enter values one per line. Type %s to stop; prefix a value with '<' to insert it before the start.\n",
+           stop_token);
 
     char buffer[256];
-    int i = 0;
     for (;;)
     {
-        int logical_index = seq->start + i;
-        printf("value[%d] (index=%d): ", i, logical_index);
+        int logical_index = seq->start + seq->length;
+        printf("value[%d] (index=%d): ", seq->length, logical_index);
 
         if (fgets(buffer, sizeof(buffer), stdin) == NULL)
         {
@@ -317,20 +531,27 @@ static int input_unbounded(SignalSeq *seq, const char *stop_token)
             break;
         }
 
-        char *endptr = NULL;
-        errno = 0;
-        double v = strtod(buffer, &endptr);
-        if (endptr == buffer || *endptr != '\0' || errno != 0)
+        const char *p = buffer;
+        while (isspace((unsigned char)*p))
+        {
+            ++p;
+        }
+        int front = (*p == '<');
+        if (front)
+        {
+            ++p;
+        }
+        double v = 0.0;
+        if (num_parse_double(p, strlen(p), &v) != 0)
         {
             fprintf(stderr, "Error: invalid number, please try again.\n");
             continue;
         }
 
-        if (signal_seq_append(seq, v) != 0)
+        if ((front ? signal_seq_prepend(seq, v) : signal_seq_append(seq, v)) != 0)
         {
             return -1;
         }
-        ++i;
     }
 
     return 0;
@@ -360,18 +581,24 @@ static void print_sequence(const SignalSeq *seq)
         return;
     }
 
-    if (seq->data == NULL)
-    {
-        fprintf(stderr, "Error: sequence data is NULL while length > 0.\n");
-        return;
-    }
-
     printf("  values     :\n");
 
-    for (int i = 0; i < seq->length; ++i)
+    int logical_index = seq->start;
+    while (logical_index - seq->start < seq->length)
     {
-        int logical_index = seq->start + i;
-        printf("    x[%d] = %.6g\n", logical_index, seq->data[i]);
+        const double *data = NULL;
+        int count = 0;
+        if (signal_seq_span(seq, logical_index, &data, &count) != 0)
+        {
+            return;
+        }
+        for (int k = 0; k < count; ++k)
+        {
+            char text[NUM_FORMAT_MAX];
+            num_format_g(text, data[k], 6);
+            printf("    x[%d] = %s\n", logical_index + k, text);
+        }
+        logical_index += count;
     }
 }
 
@@ -0,0 +1,209 @@
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief 溢出块头部，后接对齐的数据区。Overflow block header, followed by aligned data.
+ */
+typedef struct seq_arena_spill
+{
+    struct seq_arena_spill *next; /**< 下一块。Next block. */
+} seq_arena_spill_t;
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void arena_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[arena] error: %s\n", msg);
+}
+
+/**
+ * @brief 对齐所需的填充字节数。Padding needed to align a pointer.
+ *
+ * @param p [in] 指针。Pointer.
+ * @return 填充字节数。Padding bytes.
+ */
+static size_t arena_pad(const void *p)
+{
+    uintptr_t u = (uintptr_t)p;
+    return (size_t)((SEQ_ARENA_ALIGN - (u % SEQ_ARENA_ALIGN)) % SEQ_ARENA_ALIGN);
+}
+
+/**
+ * @brief 释放全部溢出块。Free every overflow block.
+ *
+ * @param a [in,out] 内存池。Arena.
+ */
+static void arena_free_spills(seq_arena_t *a)
+{
+    seq_arena_spill_t *s = (seq_arena_spill_t *)a->overflow;
+    while (s)
+    {
+        seq_arena_spill_t *next = s->next;
+        free(s);
+        s = next;
+    }
+    a->overflow = NULL;
+    a->spilled = 0;
+}
+
+seq_err_t seq_arena_init(seq_arena_t *a, size_t bytes)
+{
+    if (!a)
+    {
+        arena_log_error("seq_arena_init: null arena");
+        return SEQ_ERR_ARG;
+    }
+
+    a->base = NULL;
+    a->cap = 0;
+    a->used = 0;
+    a->overflow = NULL;
+    a->spilled = 0;
+    a->peak = 0;
+
+    if (bytes > 0)
+    {
+        /* 多留一个对齐宽度，保证首个分配可对齐。Extra slack so the first allocation can be aligned. */
+        a->base = (unsigned char *)malloc(bytes + SEQ_ARENA_ALIGN);
+        if (!a->base)
+        {
+            arena_log_error("seq_arena_init: out of memory");
+            return SEQ_ERR_NOMEM;
+        }
+        a->cap = bytes + SEQ_ARENA_ALIGN;
+    }
+    return SEQ_OK;
+}
+
+void seq_arena_dispose(seq_arena_t *a)
+{
+    if (!a)
+    {
+        return;
+    }
+    arena_free_spills(a);
+    free(a->base);
+    a->base = NULL;
+    a->cap = 0;
+    a->used = 0;
+    a->peak = 0;
+}
+
+seq_err_t seq_arena_reset(seq_arena_t *a)
+{
+    if (!a)
+    {
+        arena_log_error("seq_arena_reset: null arena");
+        return SEQ_ERR_ARG;
+    }
+
+    size_t round = a->used + a->spilled;
+    if (round > a->peak)
+    {
+        a->peak = round;
+    }
+    a->used = 0;
+
+    if (!a->overflow)
+    {
+        return SEQ_OK;
+    }
+
+    /* 本轮溢出过：按峰值扩大主块，使下一轮不再溢出。
+     * This round spilled: grow the main block to the peak so the next round will not. */
+    arena_free_spills(a);
+    size_t want = a->peak + a->peak / 4 + SEQ_ARENA_ALIGN;
+    unsigned char *grown = (unsigned char *)malloc(want);
+    if (!grown)
+    {
+        arena_log_error("seq_arena_reset: out of memory while growing");
+        return SEQ_ERR_NOMEM;
+    }
+    free(a->base);
+    a->base = grown;
+    a->cap = want;
+    return SEQ_OK;
+}
+
+void *seq_arena_alloc(seq_arena_t *a, size_t bytes)
+{
+    if (!a)
+    {
+        arena_log_error("seq_arena_alloc: null arena");
+        return NULL;
+    }
+    if (bytes == 0)
+    {
+        bytes = 1;
+    }
+
+    if (a->base)
+    {
+        size_t pad = arena_pad(a->base + a->used);
+        if (a->used + pad <= a->cap && bytes <= a->cap - a->used - pad)
+        {
+            void *p = a->base + a->used + pad;
+            a->used += pad + bytes;
+            return p;
+        }
+    }
+
+    /* 主块不足：临时溢出到堆，下一次复位时合并。Main block exhausted: spill to the heap until the next reset. */
+    size_t head = sizeof(seq_arena_spill_t) + SEQ_ARENA_ALIGN;
+    if (bytes > SIZE_MAX - head)
+    {
+        arena_log_error("seq_arena_alloc: size overflow");
+        return NULL;
+    }
+    seq_arena_spill_t *s = (seq_arena_spill_t *)malloc(head + bytes);
+    if (!s)
+    {
+        arena_log_error("seq_arena_alloc: out of memory");
+        return NULL;
+    }
+    s->next = (seq_arena_spill_t *)a->overflow;
+    a->overflow = s;
+    a->spilled += bytes + SEQ_ARENA_ALIGN;
+
+    unsigned char *data = (unsigned char *)(s + 1);
+    return data + arena_pad(data);
+}
+
+seq_err_t seq_arena_seq(seq_arena_t *a, size_t length, seq_t *seq)
+{
+    if (!a || !seq)
+    {
+        arena_log_error("seq_arena_seq: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    seq->data = NULL;
+    seq->length = 0;
+
+    if (length == 0)
+    {
+        return SEQ_OK;
+    }
+    if (length > SIZE_MAX / sizeof(double))
+    {
+        arena_log_error("seq_arena_seq: length too large");
+        return SEQ_ERR_ARG;
+    }
+
+    seq->data = (double *)seq_arena_alloc(a, length * sizeof(double));
+    if (!seq->data)
+    {
+        return SEQ_ERR_NOMEM;
+    }
+    seq->length = length;
+    return SEQ_OK;
+}
@@ -0,0 +1,93 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/**
+ * @file arena.h
+ * @brief 按帧复位的线性内存池。Linear memory arena reset once per frame.
+ *
+ * 分配只移动偏移量，seq_arena_reset 一次性回收全部分配。主块不够时临时向堆申请溢出块，
+ * 下一次复位时按峰值用量扩大主块；因此预热之后的稳态处理不再触碰堆。
+ * Allocation only bumps an offset and seq_arena_reset reclaims everything at
+ * once. When the main block runs out, overflow blocks come from the heap and
+ * the next reset grows the main block to the peak usage, so steady-state
+ * processing after warm-up never touches the heap.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/** 分配对齐（字节）。Allocation alignment in bytes. */
+#define SEQ_ARENA_ALIGN 64
+
+/**
+ * @brief 内存池。Memory arena.
+ *
+ * @note 视为不透明，仅通过 API 操作。Treat as opaque; use only via API.
+ */
+typedef struct
+{
+    unsigned char *base; /**< 主块。Main block. */
+    size_t cap;          /**< 主块容量（字节）。Main block capacity in bytes. */
+    size_t used;         /**< 主块已用字节。Bytes used in the main block. */
+    void *overflow;      /**< 溢出块链表。List of overflow blocks. */
+    size_t spilled;      /**< 本轮溢出字节数。Bytes spilled this round. */
+    size_t peak;         /**< 单轮最大用量。Peak usage of any round. */
+} seq_arena_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化内存池。Initialize an arena.
+     *
+     * @param a [out] 内存池。Arena.
+     * @param bytes [in] 主块初始容量，可为 0。Initial main block capacity, may be 0.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_arena_init(seq_arena_t *a, size_t bytes);
+
+    /**
+     * @brief 释放内存池全部内存。Free all memory of an arena.
+     *
+     * @param a [in,out] 内存池，可为 NULL。Arena, may be NULL.
+     */
+    void seq_arena_dispose(seq_arena_t *a);
+
+    /**
+     * @brief 回收本轮全部分配。Reclaim every allocation of this round.
+     *
+     * @param a [in,out] 内存池。Arena.
+     * @return SEQ_OK；扩大主块失败时返回 SEQ_ERR_NOMEM（内存池仍可用）。
+     *         SEQ_OK, or SEQ_ERR_NOMEM if growing the main block failed (the arena stays usable).
+     *
+     * @note 之前由池分配的指针全部失效。Every pointer handed out before becomes invalid.
+     */
+    seq_err_t seq_arena_reset(seq_arena_t *a);
+
+    /**
+     * @brief 分配 bytes 字节（不清零，SEQ_ARENA_ALIGN 对齐）。Allocate bytes (not zeroed, SEQ_ARENA_ALIGN aligned).
+     *
+     * @param a [in,out] 内存池。Arena.
+     * @param bytes [in] 字节数。Byte count.
+     * @return 指针；失败返回 NULL。Pointer, or NULL on failure.
+     */
+    void *seq_arena_alloc(seq_arena_t *a, size_t bytes);
+
+    /**
+     * @brief 从内存池取出长度为 length 的序列（不清零）。Carve a sequence of length samples from the arena (not zeroed).
+     *
+     * @param a [in,out] 内存池。Arena.
+     * @param length [in] 样本数。Number of samples.
+     * @param seq [out] 序列；不可对其调用 seq_free。Sequence; never call seq_free on it.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_arena_seq(seq_arena_t *a, size_t length, seq_t *seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -1,11 +1,88 @@
 #include "cli.h"
 #include "sequence.h"
+#include "pipeline.h"
+#include "seqio.h"
+#include "ooc.h"
+#include "multichan.h"
+#include "stats.h"
+#include "numtext.h"
+#include "ring.h"
+#include "server.h"
+#include "snapshot.h"
+#include "snapio.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
+/** 流式模式每次交给 seq_stream_process 的输入块大小。Input block size per seq_stream_process call. */
+#define CLI_STREAM_BLOCK 4096
+
+/** 流式流水线每个环的块数。Blocks per ring of the streaming pipeline. */
+#define CLI_PIPE_DEPTH 8
+
+/** chain 规格允许的最大级数。Maximum number of stages in a chain spec. */
+#define CLI_MAX_STAGES 32
+
+/** sdft 最多跟踪的频点数。Maximum number of bins tracked by sdft. */
+#define CLI_SDFT_MAX_BINS 64
+
+/** chain 中一级最多的字段数（操作名 + 参数）。Maximum fields of one chain stage (op name + parameters). */
+#define CLI_STAGE_FIELDS (2 + CLI_SDFT_MAX_BINS)
+
+/** 默认两次检查点之间的输入样本数（--checkpoint-every）。Default input samples between checkpoints. */
+#define CLI_CHECKPOINT_EVERY (1 << 20)
+
+/** 二进制模式下 stdin/stdout 的 stdio 缓冲大小。stdio buffer size for stdin/stdout in binary mode. */
+#define CLI_IO_BUFFER (1 << 20)
+
+/** 输入样本格式（--format / --in-format）。Input sample format. */
+static seq_fmt_t cli_in_fmt = SEQ_FMT_TEXT;
+
+/** 输出样本格式（--format / --out-format）。Output sample format. */
+static seq_fmt_t cli_out_fmt = SEQ_FMT_TEXT;
+
+/** ooc 模式的块大小（--chunk），0 表示默认。Chunk size of ooc mode (--chunk), 0 for the default. */
+static size_t cli_chunk = 0;
+
+/** 交织通道数（--channels），仅 stream 模式。Interleaved channel count (--channels), stream mode only. */
+static size_t cli_channels = 1;
+
+/** serve 模式的监听地址（--listen）。Listening address of serve mode (--listen). */
+static const char *cli_listen = NULL;
+
+/** serve 模式的工作线程数（--threads），0 表示全部 CPU。Worker threads of serve mode (--threads), 0 for all CPUs. */
+static size_t cli_threads = 1;
+
+/** serve 模式结束这么多路流后退出（--sessions），0 表示一直运行。Exit after this many streams in serve mode (--sessions), 0 to run forever. */
+static size_t cli_sessions = 0;
+
+/** 结束时输出统计（--stats）。Dump statistics at exit (--stats). */
+static int cli_stats = 0;
+
+/** 单操作 sdft 的频点（命令行参数）。Bins of single-op sdft (command-line parameters). */
+static size_t cli_sdft_bins[CLI_SDFT_MAX_BINS];
+
+/** cli_sdft_bins 中的频点数。Number of bins in cli_sdft_bins. */
+static size_t cli_sdft_nbins = 0;
+
+/** 检查点快照文件（--checkpoint），NULL 表示不写。Checkpoint snapshot file (--checkpoint), NULL for none. */
+static const char *cli_checkpoint = NULL;
+
+/** 两次检查点之间的输入样本数（--checkpoint-every）。Input samples between checkpoints (--checkpoint-every). */
+static size_t cli_checkpoint_every = CLI_CHECKPOINT_EVERY;
+
+/** 启动时恢复的快照文件（--restore）。Snapshot file restored at startup (--restore). */
+static const char *cli_restore = NULL;
+
+/** 文本输入的 stdin 记号读取器。stdin token reader for text input. */
+static num_reader_t cli_text;
+
+/** 文本输出的有效数字位数。Significant digits of text output. */
+#define CLI_TEXT_DIGITS 10
+
 /* ---------- 内部工具：日志与用法 ---------- */
 
 /**
@@ -31,6 +108,27 @@ static void cli_print_usage(void)
             "Usage:\n"
             "  seqops <op> [params...] finite\n"
             "  seqops <op> [params...] stream\n"
+            "  seqops <op> [params...] ooc   (reverse, advance, pad-back; binary input)\n"
+            "  seqops <op> [params...] serve --listen=ADDR   (binary formats)\n"
+            "  seqops chain <spec> finite|stream\n"
+            "\n"
+            "Options (anywhere on the command line):\n"
+            "  --format=FMT      input and output sample format\n"
+            "  --in-format=FMT   input sample format\n"
+            "  --out-format=FMT  output sample format\n"
+            "  FMT: text (default), f64, f32, s16 (raw little-endian, no header)\n"
+            "  --chunk=N         samples per chunk in ooc mode (default 65536)\n"
+            "  --channels=C      stream mode: input is C interleaved channels, each\n"
+            "                    processed independently (output interleaved too)\n"
+            "  --listen=ADDR     serve mode: unix:PATH, tcp:PORT or tcp:HOST:PORT\n"
+            "  --threads=N       serve mode: worker threads (default 1, 0 = all CPUs)\n"
+            "  --sessions=N      serve mode: exit after N streams (default 0 = never)\n"
+            "  --stats           print per-op calls, samples and time to stderr at exit\n"
+            "  --checkpoint=FILE stream mode (single op or chain): snapshot the state to\n"
+            "                    FILE every --checkpoint-every input samples\n"
+            "  --checkpoint-every=N  input samples between checkpoints (default 1048576)\n"
+            "  --restore=FILE    stream mode: resume from a snapshot taken with the same\n"
+            "                    op and parameters; prints RESUME:IN=<n> OUT=<n> to stderr\n"
             "\n"
             "Operations (op):\n"
             "  pad-front <zeros>\n"
@@ -42,18 +140,48 @@ static void cli_print_usage(void)
             "  downsample <factor>\n"
             "  diff\n"
             "  cumsum\n"
+            "  fir       <taps-file> [block]\n"
+            "  resample  <up> <down> <taps-file>\n"
+            "  sdft      <window> <bin> [bin...]   (per sample: |X_bin| over the last\n"
+            "            <window> samples, one value per bin; at most 64 bins)\n"
             "\n"
             "Finite mode input (from stdin):\n"
             "  First line : N (length)\n"
             "  Second line: N double values\n"
             "\n"
+            "Taps file (fir, resample): N followed by N double values.\n"
+            "\n"
+            "Chain spec: comma-separated stages, parameters separated by ':'\n"
+            "  e.g. \"delay:2:0,upsample:3,fir:taps.txt,downsample:3,diff\"\n"
+            "  Stages: pad-front:<zeros> pad-back:<zeros> delay:<delay>[:<fill>]\n"
+            "          advance:<advance>[:<fill>] upsample:<factor> downsample:<factor>\n"
+            "          diff cumsum fir:<taps-file>[:<block>] resample:<up>:<down>:<taps-file>\n"
+            "          sdft:<window>:<bin>[:<bin>...]\n"
+            "\n"
             "Stream mode input (from stdin):\n"
             "  Sequence of double tokens separated by spaces/newlines,\n"
             "  terminated by the token END (case-insensitive).\n"
             "\n"
+            "Binary input: raw samples up to EOF (no length, no END).\n"
+            "\n"
+            "Out-of-core mode (ooc): binary input is processed in fixed-size chunks\n"
+            "  with bounded memory; reverse needs a regular file on stdin.\n"
+            "\n"
+            "Serve mode: every connection is one stream of the op. The client sends\n"
+            "  binary samples and shuts down its write side to end the input; the\n"
+            "  output comes back on the same connection, which is then closed.\n"
+            "  The actual address is printed to stderr as LISTEN:<addr>.\n"
+            "\n"
+            "Checkpoints: a snapshot holds the full streaming state and the position\n"
+            "  (IN input samples consumed, OUT output samples produced). To resume,\n"
+            "  keep the first OUT output samples, feed input from sample IN onward\n"
+            "  and pass --restore; the output continues bit-identically.\n"
+            "\n"
             "Output format:\n"
             "  First line : ONLINE:YES or ONLINE:NO\n"
-            "  Second line: result sequence values on a single line.\n");
+            "  Second line: result sequence values on a single line.\n"
+            "  With a binary output format the ONLINE line goes to stderr and\n"
+            "  stdout carries raw samples only.\n");
 }
 
 /* ---------- 内部工具：解析函数 ---------- */
@@ -117,6 +245,21 @@ static int cli_parse_op(const char *name, seq_op_type *op)
         *op = SEQ_OP_CUMSUM;
         return 0;
     }
+    if (strcmp(name, "fir") == 0)
+    {
+        *op = SEQ_OP_FIR;
+        return 0;
+    }
+    if (strcmp(name, "resample") == 0)
+    {
+        *op = SEQ_OP_RESAMPLE;
+        return 0;
+    }
+    if (strcmp(name, "sdft") == 0)
+    {
+        *op = SEQ_OP_SDFT;
+        return 0;
+    }
 
     return -1;
 }
@@ -157,21 +300,47 @@ static int cli_parse_size(const char *s, size_t *out)
  */
 static int cli_parse_double(const char *s, double *out)
 {
-    char *end = NULL;
-    double v;
-
     if (!s || !out)
     {
         return -1;
     }
+    return num_parse_double(s, strlen(s), out);
+}
 
-    errno = 0;
-    v = strtod(s, &end);
-    if (errno != 0 || end == s || *end != '\0')
+/**
+ * @brief 解析 sdft 的窗口长度与频点列表。Parse the window length and bin list of sdft.
+ *
+ * @param fields [in] 窗口长度及其后的各频点。Window length followed by the bins.
+ * @param count [in] 字段数。Number of fields.
+ * @param n [out] 窗口长度。Window length.
+ * @param bins [out] 频点，容量 CLI_SDFT_MAX_BINS。Bins, capacity CLI_SDFT_MAX_BINS.
+ * @param nbins [out] 频点数。Number of bins.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_parse_sdft(const char *const *fields, size_t count, size_t *n, size_t *bins, size_t *nbins)
+{
+    size_t i = 1;
+
+    if (count < 2 || count > 1 + CLI_SDFT_MAX_BINS)
+    {
+        cli_log_error("sdft expects <window> and 1 to 64 bins");
+        return -1;
+    }
+    if (cli_parse_size(fields[0], n) != 0 || *n == 0)
     {
+        cli_log_error("invalid sdft window length");
         return -1;
     }
-    *out = v;
+    while (i < count)
+    {
+        if (cli_parse_size(fields[i], &bins[i - 1]) != 0 || bins[i - 1] >= *n)
+        {
+            cli_log_error("invalid sdft bin (must be below the window length)");
+            return -1;
+        }
+        i++;
+    }
+    *nbins = count - 1;
     return 0;
 }
 
@@ -194,7 +363,7 @@ static int cli_read_finite(seq_t *seq)
         return -1;
     }
 
-    if (scanf("%zu", &n) != 1)
+    if (num_read_size(&cli_text, &n) != 0)
     {
         cli_log_error("failed to read length N for finite mode");
         return -1;
@@ -206,7 +375,7 @@ static int cli_read_finite(seq_t *seq)
     }
     while (i < n)
     {
-        if (scanf("%lf", &seq->data[i]) != 1)
+        if (num_read_double(&cli_text, &seq->data[i]) != 0)
         {
             cli_log_error("not enough samples for finite sequence");
             seq_free(seq);
@@ -217,6 +386,113 @@ static int cli_read_finite(seq_t *seq)
     return 0;
 }
 
+/**
+ * @brief 从文件读取 FIR 冲激响应。Read FIR impulse response from a file.
+ *
+ * @param path [in] 文件路径，格式同有限模式输入。File path, same format as finite input.
+ * @param taps [out] 冲激响应序列。Impulse response sequence.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_read_taps(const char *path, seq_t *taps)
+{
+    FILE *fp;
+    num_reader_t rd;
+    size_t n = 0;
+    size_t i = 0;
+
+    fp = fopen(path, "r");
+    if (!fp)
+    {
+        cli_log_error("cannot open taps file");
+        return -1;
+    }
+    if (num_reader_init(&rd, fp, 0) != 0)
+    {
+        fclose(fp);
+        return -1;
+    }
+    if (num_read_size(&rd, &n) != 0 || n == 0)
+    {
+        cli_log_error("failed to read tap count from taps file");
+        num_reader_free(&rd);
+        fclose(fp);
+        return -1;
+    }
+    if (seq_alloc(taps, n) != SEQ_OK)
+    {
+        cli_log_error("memory allocation failed for taps");
+        num_reader_free(&rd);
+        fclose(fp);
+        return -1;
+    }
+    while (i < n)
+    {
+        if (num_read_double(&rd, &taps->data[i]) != 0)
+        {
+            cli_log_error("not enough values in taps file");
+            seq_free(taps);
+            num_reader_free(&rd);
+            fclose(fp);
+            return -1;
+        }
+        i++;
+    }
+    num_reader_free(&rd);
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * @brief 按格式读入有限序列：文本为 N 加 N 个值，二进制为直到 EOF 的原始样本。
+ *        Load a finite sequence: N plus N values as text, or raw samples up to EOF in binary.
+ *
+ * @param in [out] 载入结果，用 seq_io_release 释放。Loaded result, release with seq_io_release.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_load_finite(seq_io_buf_t *in)
+{
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        const uint64_t t0 = SEQ_STATS_START();
+        if (seq_io_load(stdin, cli_in_fmt, in) != SEQ_OK)
+        {
+            cli_log_error("failed to load binary finite input");
+            return -1;
+        }
+        SEQ_STATS_PHASE(SEQ_STATS_PARSE, t0, in->seq.length, 0);
+        return 0;
+    }
+    memset(in, 0, sizeof(*in));
+    const uint64_t t0 = SEQ_STATS_START();
+    if (cli_read_finite(&in->seq) != 0)
+    {
+        return -1;
+    }
+    SEQ_STATS_PHASE(SEQ_STATS_PARSE, t0, in->seq.length, 0);
+    return 0;
+}
+
+/**
+ * @brief 输出 ONLINE 判定行；二进制输出时写到 stderr。Print the ONLINE line; to stderr for binary output.
+ *
+ * @param yes [in] 非 0 表示 YES。Non-zero for YES.
+ */
+static void cli_print_online(int yes)
+{
+    fprintf((cli_out_fmt == SEQ_FMT_TEXT) ? stdout : stderr, "ONLINE:%s\n", yes ? "YES" : "NO");
+}
+
+/**
+ * @brief 结束一行文本输出；二进制输出时不写任何内容。End the text output line; nothing for binary output.
+ */
+static void cli_end_output(void)
+{
+    if (cli_out_fmt == SEQ_FMT_TEXT)
+    {
+        putchar('\n');
+    }
+}
+
 /**
  * @brief 打印序列到 stdout。Print sequence to stdout.
  *
@@ -225,6 +501,18 @@ static int cli_read_finite(seq_t *seq)
 static void cli_print_sequence(const seq_t *seq)
 {
     size_t i;
+    num_writer_t w;
+    const uint64_t t0 = SEQ_STATS_START();
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        if (seq && seq->length > 0)
+        {
+            seq_io_write(stdout, cli_out_fmt, seq->data, seq->length);
+            SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, seq->length, 0);
+        }
+        return;
+    }
 
     if (!seq || !seq->data)
     {
@@ -238,15 +526,18 @@ static void cli_print_sequence(const seq_t *seq)
         return;
     }
 
+    num_writer_init(&w, stdout);
     for (i = 0; i < seq->length; ++i)
     {
         if (i > 0)
         {
-            putchar(' ');
+            num_write_char(&w, ' ');
         }
-        printf("%.10g", seq->data[i]);
+        num_write_g(&w, seq->data[i], CLI_TEXT_DIGITS);
     }
-    putchar('\n');
+    num_write_char(&w, '\n');
+    num_writer_flush(&w);
+    SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, seq->length, 0);
 }
 
 /**
@@ -254,67 +545,90 @@ static void cli_print_sequence(const seq_t *seq)
  *
  * @param op 操作类型。Operation type.
  * @param param_main 主参数。Main parameter.
+ * @param param_aux 辅助参数（resample 的下采样因子）。Aux parameter (resample down factor).
  * @param fill 填充值。Fill value.
+ * @param taps 冲激响应，仅 fir/resample 使用。Impulse response, fir/resample only.
  * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
  */
-static int cli_run_finite(seq_op_type op, size_t param_main, double fill)
+static int cli_run_finite(seq_op_type op, size_t param_main, size_t param_aux, double fill,
+                          const seq_t *taps)
 {
-    seq_t src = {0}, dst = {0};
+    seq_io_buf_t in;
+    seq_t dst = {0};
+    const seq_t *src = &in.seq;
+    seq_t *out = &dst;
     seq_err_t err;
 
-    if (cli_read_finite(&src) != 0)
+    if (cli_load_finite(&in) != 0)
     {
         return 1;
     }
 
+    /* 等长操作直接改写载入的缓冲区（堆或私有可写映射），省去第二块缓冲。
+     * Length-preserving ops rewrite the loaded buffer (heap or private writable
+     * mapping) and skip the second buffer. */
+    if (seq_inplace_capable(op))
+    {
+        out = &in.seq;
+    }
+
     switch (op)
     {
     case SEQ_OP_PAD_FRONT:
-        err = seq_pad_front(&src, param_main, &dst);
+        err = seq_pad_front(src, param_main, out);
         break;
     case SEQ_OP_PAD_BACK:
-        err = seq_pad_back(&src, param_main, &dst);
+        err = seq_pad_back(src, param_main, out);
         break;
     case SEQ_OP_DELAY:
-        err = seq_delay(&src, param_main, fill, &dst);
+        err = seq_delay(src, param_main, fill, out);
         break;
     case SEQ_OP_ADVANCE:
-        err = seq_advance(&src, param_main, fill, &dst);
+        err = seq_advance(src, param_main, fill, out);
         break;
     case SEQ_OP_REVERSE:
-        err = seq_reverse(&src, &dst);
+        err = seq_reverse(src, out);
         break;
     case SEQ_OP_UPSAMPLE:
-        err = seq_upsample(&src, param_main, &dst);
+        err = seq_upsample(src, param_main, out);
         break;
     case SEQ_OP_DOWNSAMPLE:
-        err = seq_downsample(&src, param_main, &dst);
+        err = seq_downsample(src, param_main, out);
         break;
     case SEQ_OP_DIFF:
-        err = seq_diff(&src, &dst);
+        err = seq_diff(src, out);
         break;
     case SEQ_OP_CUMSUM:
-        err = seq_cumsum(&src, &dst);
+        err = seq_cumsum(src, out);
+        break;
+    case SEQ_OP_FIR:
+        err = seq_fir_filter(src, taps->data, taps->length, out);
+        break;
+    case SEQ_OP_RESAMPLE:
+        err = seq_resample(src, param_main, param_aux, taps->data, taps->length, out);
+        break;
+    case SEQ_OP_SDFT:
+        err = seq_sliding_dft(src, param_main, cli_sdft_bins, cli_sdft_nbins, out);
         break;
     default:
         cli_log_error("unsupported operation in finite mode");
-        seq_free(&src);
+        seq_io_release(&in);
         return 1;
     }
 
     if (err != SEQ_OK)
     {
         cli_log_error("sequence operation failed in finite mode");
-        seq_free(&src);
+        seq_io_release(&in);
         seq_free(&dst);
         return 1;
     }
 
     /* 对有限输入的“在线可实现性”判定。 */
-    printf("ONLINE:%s\n", seq_online_capable(op, 0) ? "YES" : "NO");
-    cli_print_sequence(&dst);
+    cli_print_online(seq_online_capable(op, 0));
+    cli_print_sequence(out);
 
-    seq_free(&src);
+    seq_io_release(&in);
     seq_free(&dst);
     return 0;
 }
@@ -324,148 +638,1411 @@ static int cli_run_finite(seq_op_type op, size_t param_main, double fill)
 /**
  * @brief 是否是 END 标记（忽略大小写）。Check if token is END sentinel (case-insensitive).
  */
-static int cli_is_end_token(const char *s)
+static int cli_is_end_token(const char *s, size_t len)
 {
-    if (!s)
+    if (!s || len != 3)
     {
         return 0;
     }
-    return (strcasecmp(s, "END") == 0);
+    return (s[0] == 'E' || s[0] == 'e') && (s[1] == 'N' || s[1] == 'n') && (s[2] == 'D' || s[2] == 'd');
 }
 
 /**
- * @brief 执行流式模式操作。Execute operation in stream mode.
+ * @brief 读取一块流式输入，遇到 END 或输入结束时置 done。Read one block of stream input; set done on END or EOF.
  *
- * @param op 操作类型。Operation type.
- * @param param_main 主参数。Main parameter.
- * @param fill 填充值。Fill value.
- * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ * 二进制输入格式下按原始样本读取，直到 EOF。Binary input formats read raw samples up to EOF.
+ *
+ * @param in [out] 输入缓冲。Input buffer.
+ * @param cap [in] 缓冲容量。Buffer capacity.
+ * @param n [out] 读到的样本数。Number of samples read.
+ * @param done [out] 非 0 表示输入已结束。Non-zero once input has ended.
+ * @return 0 成功；非 0 表示遇到非法输入。0 on success, non-zero on invalid input.
  */
-static int cli_run_stream(seq_op_type op, size_t param_main, double fill)
+static int cli_read_stream_block(double *in, size_t cap, size_t *n, int *done)
 {
-    seq_stream_t st;
-    char token[128];
-    int rc;
-    double x, y;
-    int has_output;
-
-    if (!seq_online_capable(op, 1))
-    {
-        printf("ONLINE:NO\n");
-        cli_log_error("operation not supported for online infinite input");
-        return 1;
-    }
+    const uint64_t t0 = SEQ_STATS_START();
 
-    rc = seq_stream_init(&st, op, param_main, 0, fill);
-    if (rc != SEQ_OK)
+    if (cli_in_fmt != SEQ_FMT_TEXT)
     {
-        printf("ONLINE:NO\n");
-        cli_log_error("failed to initialize streaming state");
-        return 1;
+        if (seq_io_read(stdin, cli_in_fmt, in, cap, n) != SEQ_OK)
+        {
+            return -1;
+        }
+        *done = (*n < cap);
+        SEQ_STATS_PHASE(SEQ_STATS_PARSE, t0, *n, 0);
+        return 0;
     }
 
-    printf("ONLINE:YES\n");
-
-    /* 对于需要起始补零的操作（如 pad-front），先冲刷前缀输出。 */
-    while (1)
+    *n = 0;
+    while (*n < cap)
     {
-        rc = seq_stream_step(&st, 0, 0.0, &y, &has_output);
-        if (rc != SEQ_OK)
+        int rc = num_read_double(&cli_text, &in[*n]);
+        if (rc == 0)
         {
-            cli_log_error("streaming step failed during initial flush");
-            seq_stream_dispose(&st);
-            return 1;
+            (*n)++;
+            continue;
         }
-        if (!has_output)
+        if (rc < 0)
         {
-            break;
+            /* 不是数的记号只能是 END。A non-numeric token may only be END. */
+            const char *tok;
+            size_t len;
+            if (num_read_token(&cli_text, &tok, &len) != 0 || !cli_is_end_token(tok, len))
+            {
+                cli_log_error("invalid numeric token in stream input");
+                return -1;
+            }
         }
-        printf("%.10g ", y);
+        *done = 1;
+        break;
+    }
+    SEQ_STATS_PHASE(SEQ_STATS_PARSE, t0, *n, 0);
+    return 0;
+}
+
+/**
+ * @brief 打印一块流式输出（每个值后跟一个空格；二进制格式为原始样本）。
+ *        Print a block of stream outputs, each followed by a space (raw samples in binary formats).
+ *
+ * @param v [in] 输出值。Output values.
+ * @param n [in] 个数。Count.
+ */
+static void cli_print_values(const double *v, size_t n)
+{
+    size_t i = 0;
+    num_writer_t w;
+    const uint64_t t0 = SEQ_STATS_START();
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        seq_io_write(stdout, cli_out_fmt, v, n);
+        SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, n, 0);
+        return;
+    }
+    num_writer_init(&w, stdout);
+    while (i < n)
+    {
+        num_write_g(&w, v[i], CLI_TEXT_DIGITS);
+        num_write_char(&w, ' ');
+        i++;
+    }
+    num_writer_flush(&w);
+    SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, n, 0);
+}
+
+/* ---------- 流式运行时：输入、计算、输出三级流水 ---------- */
+
+/**
+ * @brief 流式计算：处理一块输入；输入结束后以 in = NULL、n_in = 0 调用以冲刷尾部。
+ *        Streaming compute: process one input block; after the end of input, called
+ *        with in = NULL and n_in = 0 to drain the tail.
+ *
+ * @param ctx [in,out] 计算状态。Compute state.
+ * @param in [in] 输入样本。Input samples.
+ * @param n_in [in] 输入样本数，为帧长的整数倍。Input samples, a whole number of frames.
+ * @param out [out] 输出缓冲。Output buffer.
+ * @param out_cap [in] 输出容量（样本）。Output capacity in samples.
+ * @param n_out [out] 输出样本数。Output samples.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+typedef seq_err_t (*cli_stream_step_fn)(void *ctx, const double *in, size_t n_in, double *out, size_t out_cap,
+                                        size_t *n_out);
+
+/**
+ * @brief 流式计算的描述。Description of a streaming computation.
+ */
+typedef struct
+{
+    cli_stream_step_fn step;          /**< 逐块计算。Per-block compute. */
+    seq_err_t (*finish)(void *ctx);   /**< 通知输入结束。Signals the end of input. */
+    void *ctx;                        /**< 计算状态。Compute state. */
+    size_t in_cap;                    /**< 每块输入样本数。Input samples per block. */
+    size_t frame;                     /**< 每帧样本数（通道数）。Samples per frame (channel count). */
+    size_t out_cap;                   /**< 每块输出容量（样本）。Output capacity per block in samples. */
+} cli_stream_t;
+
+/**
+ * @brief 流水线：输入线程 → in 环 → 计算（调用线程）→ out 环 → 输出线程。
+ *        Pipeline: input thread → in ring → compute (caller thread) → out ring → output thread.
+ */
+typedef struct
+{
+    const cli_stream_t *s; /**< 计算描述。Computation. */
+    ring_t in;             /**< 已解析的输入块。Parsed input blocks. */
+    ring_t out;            /**< 待输出的结果块。Result blocks to print. */
+} cli_pipe_t;
+
+/**
+ * @brief 串行执行：读一块、算一块、写一块。Serial run: read, compute and print one block at a time.
+ *
+ * @param s [in] 计算描述。Computation.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t cli_stream_serial(const cli_stream_t *s)
+{
+    seq_err_t rc = SEQ_OK;
+    int done = 0;
+    size_t n_in = 0;
+    size_t n_out = 0;
+    double *in = (double *)malloc(s->in_cap * sizeof(double));
+    double *out = (double *)malloc(s->out_cap * sizeof(double));
+
+    if (!in || !out)
+    {
+        cli_log_error("memory allocation failed for stream buffers");
+        free(in);
+        free(out);
+        return SEQ_ERR_NOMEM;
     }
 
-    /* 读取流式输入，直到 END。*/
-    while (scanf("%127s", token) == 1)
+    /* 读取流式输入，直到 END 或 EOF；每满一块交给计算。Read up to END or EOF, one block per compute call. */
+    while (!done)
     {
-        if (cli_is_end_token(token))
+        if (cli_read_stream_block(in, s->in_cap, &n_in, &done) != 0)
         {
+            rc = SEQ_ERR_ARG;
             break;
         }
-
-        if (cli_parse_double(token, &x) != 0)
+        if (n_in % s->frame != 0)
         {
-            cli_log_error("invalid numeric token in stream input");
-            seq_stream_dispose(&st);
-            return 1;
+            cli_log_error("stream input is not a whole number of frames");
+            rc = SEQ_ERR_ARG;
+            break;
         }
-
-        rc = seq_stream_step(&st, 1, x, &y, &has_output);
+        rc = s->step(s->ctx, in, n_in, out, s->out_cap, &n_out);
         if (rc != SEQ_OK)
         {
             cli_log_error("streaming step failed");
-            seq_stream_dispose(&st);
-            return 1;
+            break;
         }
-        if (has_output)
+        cli_print_values(out, n_out);
+    }
+
+    /* 通知输入结束并冲刷尾部输出（如 FIR 残余块、补零），直到不再有输出。 */
+    if (rc == SEQ_OK)
+    {
+        rc = s->finish(s->ctx);
+    }
+    while (rc == SEQ_OK)
+    {
+        rc = s->step(s->ctx, NULL, 0, out, s->out_cap, &n_out);
+        if (rc != SEQ_OK)
         {
-            printf("%.10g ", y);
+            cli_log_error("streaming step failed during final flush");
         }
-
-        /* 对可能产生额外输出的操作（上采样等）进行尾随冲刷。*/
-        while (1)
+        else if (n_out == 0)
         {
-            rc = seq_stream_step(&st, 0, 0.0, &y, &has_output);
-            if (rc != SEQ_OK)
-            {
-                cli_log_error("streaming step failed during extra flush");
-                seq_stream_dispose(&st);
-                return 1;
-            }
-            if (!has_output)
-            {
-                break;
-            }
-            printf("%.10g ", y);
+            break;
+        }
+        else
+        {
+            cli_print_values(out, n_out);
         }
     }
 
-    /* 当前设计的流式算子不会在 END 后继续产生无限尾部输出。
-       若后续扩展需要，可在此位置增加有限次数 flush。 */
-    putchar('\n');
-
-    seq_stream_dispose(&st);
-    return 0;
+    free(in);
+    free(out);
+    return rc;
 }
 
-/* ---------- 对外主入口 ---------- */
-
-int cli_main(int argc, char **argv)
+/**
+ * @brief 输入线程：把 stdin 解析进 in 环的槽，环满时等待计算。
+ *        Input thread: parses stdin straight into slots of the in ring, waiting while it is full.
+ *
+ * @param arg [in] cli_pipe_t。
+ * @return NULL。
+ */
+static void *cli_pipe_reader(void *arg)
 {
-    seq_op_type op;
-    const char *mode;
-    size_t param_main = 0;
-    double fill = 0.0;
+    cli_pipe_t *p = (cli_pipe_t *)arg;
+    int done = 0;
 
-    if (argc < 3)
+    while (!done)
     {
-        cli_log_error("not enough arguments");
-        cli_print_usage();
-        return 1;
+        double *blk = (double *)ring_acquire(&p->in);
+        size_t n = 0;
+        if (!blk)
+        {
+            /* 计算已失败退出。Compute has failed and left. */
+            break;
+        }
+        if (cli_read_stream_block(blk, p->s->in_cap, &n, &done) != 0)
+        {
+            ring_close(&p->in, -1);
+            return NULL;
+        }
+        ring_commit(&p->in, n);
     }
+    ring_close(&p->in, 0);
+    return NULL;
+}
 
-    /* 最后一个参数固定视为模式：finite 或 stream */
-    mode = argv[argc - 1];
+/**
+ * @brief 输出线程：按序写出 out 环中的结果块。Output thread: prints the result blocks of the out ring in order.
+ *
+ * @param arg [in] cli_pipe_t。
+ * @return NULL。
+ */
+static void *cli_pipe_writer(void *arg)
+{
+    cli_pipe_t *p = (cli_pipe_t *)arg;
+    const double *v;
+    size_t n = 0;
 
-    if (cli_parse_op(argv[1], &op) != 0)
+    while ((v = (const double *)ring_peek(&p->out, &n)) != NULL)
     {
-        cli_log_error("unknown operation");
-        cli_print_usage();
-        return 1;
+        cli_print_values(v, n);
+        ring_release(&p->out);
     }
+    return NULL;
+}
 
-    /* 解析各操作参数：argv[2] .. argv[argc-2]（不含 mode） */
-    {
-        int param_count = argc - 3; /* ✅ 正确减掉 程序名+操作名+模式 */
-        const char **params = (const char **)&argv[2];
+/**
+ * @brief 流水线的计算级，在调用线程上运行：从 in 环取块，结果直接写入 out 环的槽。
+ *        Compute stage of the pipeline, on the caller thread: takes blocks from the in ring
+ *        and writes results straight into slots of the out ring.
+ *
+ * @param p [in,out] 流水线。Pipeline.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t cli_pipe_compute(cli_pipe_t *p)
+{
+    const cli_stream_t *s = p->s;
+    seq_err_t rc = SEQ_OK;
+    size_t n_in = 0;
+    size_t n_out = 0;
+    const double *in;
+    double *out;
+
+    while ((in = (const double *)ring_peek(&p->in, &n_in)) != NULL)
+    {
+        if (n_in % s->frame != 0)
+        {
+            cli_log_error("stream input is not a whole number of frames");
+            rc = SEQ_ERR_ARG;
+            break;
+        }
+        /* 输出线程从不提前退出，取槽只会等待。The output thread never leaves early, so this only waits. */
+        out = (double *)ring_acquire(&p->out);
+        rc = s->step(s->ctx, in, n_in, out, s->out_cap, &n_out);
+        ring_release(&p->in);
+        if (rc != SEQ_OK)
+        {
+            cli_log_error("streaming step failed");
+            break;
+        }
+        if (n_out != 0)
+        {
+            ring_commit(&p->out, n_out);
+        }
+    }
+    if (!in && ring_status(&p->in) != 0)
+    {
+        rc = SEQ_ERR_ARG;
+    }
+    if (rc != SEQ_OK)
+    {
+        /* 使输入线程在下一次取槽时停止。Make the input thread stop at its next acquire. */
+        ring_abort(&p->in);
+        return rc;
+    }
+
+    rc = s->finish(s->ctx);
+    while (rc == SEQ_OK)
+    {
+        out = (double *)ring_acquire(&p->out);
+        rc = s->step(s->ctx, NULL, 0, out, s->out_cap, &n_out);
+        if (rc != SEQ_OK)
+        {
+            cli_log_error("streaming step failed during final flush");
+        }
+        else if (n_out == 0)
+        {
+            break;
+        }
+        else
+        {
+            ring_commit(&p->out, n_out);
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief 执行流式计算：默认三级流水，解析、计算与输出各占一个线程，吞吐取决于最慢的一级。
+ *        Run a streaming computation: by default a three-stage pipeline with parsing,
+ *        compute and output on their own threads, so throughput is set by the slowest stage.
+ *
+ * @param s [in] 计算描述。Computation.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ *
+ * @note 输出与串行执行逐字节一致。开启 --stats 时串行执行：统计不加锁，且各阶段计时只在
+ *       不重叠时才有意义；环或线程创建失败时同样退回串行。
+ *       Output is byte-identical to the serial run. With --stats the run is serial,
+ *       since the counters are unlocked and per-phase times only mean something when
+ *       the phases do not overlap; failing to create the rings or threads falls back
+ *       to serial as well.
+ */
+static seq_err_t cli_stream_run(const cli_stream_t *s)
+{
+    cli_pipe_t p;
+    pthread_t reader;
+    pthread_t writer;
+    seq_err_t rc;
+
+    if (seq_stats_enabled())
+    {
+        return cli_stream_serial(s);
+    }
+
+    p.s = s;
+    if (ring_init(&p.in, CLI_PIPE_DEPTH, s->in_cap * sizeof(double)) != 0)
+    {
+        return cli_stream_serial(s);
+    }
+    if (ring_init(&p.out, CLI_PIPE_DEPTH, (s->out_cap > 0 ? s->out_cap : 1) * sizeof(double)) != 0)
+    {
+        ring_free(&p.in);
+        return cli_stream_serial(s);
+    }
+    /* 先起输出线程：输入线程起不来时关掉 out 环即可干净退回。
+       Start the output thread first: if the input thread fails, closing the out ring backs out cleanly. */
+    if (pthread_create(&writer, NULL, cli_pipe_writer, &p) != 0)
+    {
+        ring_free(&p.in);
+        ring_free(&p.out);
+        return cli_stream_serial(s);
+    }
+    if (pthread_create(&reader, NULL, cli_pipe_reader, &p) != 0)
+    {
+        ring_close(&p.out, 0);
+        pthread_join(writer, NULL);
+        ring_free(&p.in);
+        ring_free(&p.out);
+        return cli_stream_serial(s);
+    }
+
+    rc = cli_pipe_compute(&p);
+    ring_close(&p.out, 0);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    ring_free(&p.in);
+    ring_free(&p.out);
+    return rc;
+}
+
+/**
+ * @brief 单通道流式计算。Single-channel streaming compute.
+ */
+static seq_err_t cli_step_single(void *ctx, const double *in, size_t n_in, double *out, size_t out_cap,
+                                 size_t *n_out)
+{
+    return seq_stream_process((seq_stream_t *)ctx, in, n_in, out, out_cap, n_out);
+}
+
+/**
+ * @brief 单通道输入结束。End of single-channel input.
+ */
+static seq_err_t cli_finish_single(void *ctx)
+{
+    return seq_stream_finish((seq_stream_t *)ctx);
+}
+
+/* ---------- 检查点：--checkpoint / --restore ---------- */
+
+/**
+ * @brief 检查点状态：流位置与快照缓冲。Checkpoint state: stream position and snapshot buffer.
+ *
+ * @note st 与 pl 恰有一个非 NULL。Exactly one of st and pl is non-NULL.
+ */
+typedef struct
+{
+    seq_stream_t *st;       /**< 单操作状态。Single-op state. */
+    seq_pipeline_t *pl;     /**< chain 流水线。Chain pipeline. */
+    seq_snapshot_pos_t pos; /**< 当前流位置。Current stream position. */
+    size_t since;           /**< 上次检查点以来的输入样本数。Input samples since the last checkpoint. */
+    unsigned char *buf;     /**< 快照缓冲。Snapshot buffer. */
+    size_t cap;             /**< 快照缓冲容量。Snapshot buffer capacity. */
+} cli_ckpt_t;
+
+/**
+ * @brief 按 --restore 恢复状态并按 --checkpoint 准备快照缓冲。
+ *        Restore the state from --restore and set up the snapshot buffer for --checkpoint.
+ *
+ * @param c [out] 检查点状态。Checkpoint state.
+ * @param st [in,out] 单操作状态，或 NULL。Single-op state, or NULL.
+ * @param pl [in,out] chain 流水线，或 NULL。Chain pipeline, or NULL.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_ckpt_open(cli_ckpt_t *c, seq_stream_t *st, seq_pipeline_t *pl)
+{
+    memset(c, 0, sizeof(*c));
+    c->st = st;
+    c->pl = pl;
+
+    if (cli_restore)
+    {
+        unsigned char *snap = NULL;
+        size_t len = 0;
+        seq_err_t rc;
+
+        if (snap_file_read(cli_restore, &snap, &len) != 0)
+        {
+            cli_log_error("cannot read the --restore snapshot");
+            return -1;
+        }
+        rc = st ? seq_stream_restore(st, snap, len, &c->pos) : seq_pipeline_restore(pl, snap, len, &c->pos);
+        free(snap);
+        if (rc != SEQ_OK)
+        {
+            cli_log_error("snapshot does not match this operation or is damaged");
+            return -1;
+        }
+        fprintf(stderr, "RESUME:IN=%llu OUT=%llu\n",
+                (unsigned long long)c->pos.in, (unsigned long long)c->pos.out);
+        fflush(stderr);
+    }
+
+    if (cli_checkpoint)
+    {
+        c->cap = st ? seq_stream_snapshot_size(st) : seq_pipeline_snapshot_size(pl);
+        c->buf = (unsigned char *)malloc(c->cap);
+        if (!c->buf)
+        {
+            cli_log_error("memory allocation failed for the checkpoint buffer");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 记一块的进度，满 --checkpoint-every 个输入样本时写快照。
+ *        Account one block and write a snapshot once --checkpoint-every input samples have passed.
+ *
+ * @param c [in,out] 检查点状态。Checkpoint state.
+ * @param n_in [in] 该块输入样本数；0 表示冲刷尾部，不写快照。Input samples of the block; 0 for the tail flush, which is never snapshotted.
+ * @param n_out [in] 该块输出样本数。Output samples of the block.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t cli_ckpt_advance(cli_ckpt_t *c, size_t n_in, size_t n_out)
+{
+    seq_err_t rc;
+    size_t len = 0;
+
+    c->pos.in += n_in;
+    c->pos.out += n_out;
+    c->since += n_in;
+    if (!c->buf || n_in == 0 || c->since < cli_checkpoint_every)
+    {
+        return SEQ_OK;
+    }
+    c->since = 0;
+
+    if (c->st)
+    {
+        rc = seq_stream_snapshot(c->st, &c->pos, c->buf, c->cap, &len);
+    }
+    else
+    {
+        rc = seq_pipeline_snapshot(c->pl, &c->pos, c->buf, c->cap, &len);
+    }
+    if (rc != SEQ_OK)
+    {
+        return rc;
+    }
+    if (snap_file_write(cli_checkpoint, c->buf, len) != 0)
+    {
+        cli_log_error("failed to write the checkpoint");
+        return SEQ_ERR_STATE;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 单通道流式计算，带检查点。Single-channel streaming compute with checkpoints.
+ *
+ * @note 在计算线程上调用，快照与计算不会并发。Runs on the compute thread, so snapshots never race the compute.
+ */
+static seq_err_t cli_step_ckpt(void *ctx, const double *in, size_t n_in, double *out, size_t out_cap,
+                               size_t *n_out)
+{
+    cli_ckpt_t *c = (cli_ckpt_t *)ctx;
+    seq_err_t rc = seq_stream_process(c->st, in, n_in, out, out_cap, n_out);
+
+    if (rc != SEQ_OK)
+    {
+        return rc;
+    }
+    return cli_ckpt_advance(c, n_in, *n_out);
+}
+
+/**
+ * @brief 带检查点的单通道输入结束。End of single-channel input with checkpoints.
+ */
+static seq_err_t cli_finish_ckpt(void *ctx)
+{
+    return seq_stream_finish(((cli_ckpt_t *)ctx)->st);
+}
+
+/**
+ * @brief 多通道流式计算的状态。State of a multichannel streaming compute.
+ */
+typedef struct
+{
+    seq_mc_stream_t st; /**< 各通道状态。Per-channel state. */
+    size_t ch;          /**< 通道数。Channel count. */
+    size_t out_frames;  /**< 每块输出上界（帧）。Output bound per block in frames. */
+} cli_mc_ctx_t;
+
+/**
+ * @brief 多通道流式计算：交织帧进、交织帧出。Multichannel streaming compute: interleaved frames in and out.
+ */
+static seq_err_t cli_step_mc(void *ctx, const double *in, size_t n_in, double *out, size_t out_cap,
+                             size_t *n_out)
+{
+    cli_mc_ctx_t *mc = (cli_mc_ctx_t *)ctx;
+    seq_mc_t src = {(double *)in, n_in / mc->ch, mc->ch, SEQ_MC_INTERLEAVED};
+    seq_mc_t dst = {out, mc->out_frames, mc->ch, SEQ_MC_INTERLEAVED};
+    size_t frames = 0;
+    seq_err_t rc;
+
+    (void)out_cap;
+    rc = seq_mc_stream_process(&mc->st, &src, &dst, &frames);
+    *n_out = frames * mc->ch;
+    return rc;
+}
+
+/**
+ * @brief 多通道输入结束。End of multichannel input.
+ */
+static seq_err_t cli_finish_mc(void *ctx)
+{
+    return seq_mc_stream_finish(&((cli_mc_ctx_t *)ctx)->st);
+}
+
+/**
+ * @brief 多通道流式模式：输入为交织帧，各通道独立处理。
+ *        Multichannel stream mode: input is interleaved frames, each channel processed independently.
+ *
+ * @param op 操作类型。Operation type.
+ * @param param_main 主参数。Main parameter.
+ * @param param_aux 辅助参数（resample 的下采样因子）。Aux parameter (resample down factor).
+ * @param fill 填充值。Fill value.
+ * @param taps 冲激响应，仅 fir/resample 使用。Impulse response, fir/resample only.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_run_stream_mc(seq_op_type op, size_t param_main, size_t param_aux, double fill,
+                             const seq_t *taps)
+{
+    const size_t ch = cli_channels;
+    cli_mc_ctx_t mc;
+    cli_stream_t s;
+    seq_err_t rc;
+
+    if (op == SEQ_OP_FIR)
+    {
+        rc = seq_mc_stream_init_fir(&mc.st, ch, taps->data, taps->length, param_main);
+    }
+    else if (op == SEQ_OP_RESAMPLE)
+    {
+        rc = seq_mc_stream_init_resample(&mc.st, ch, param_main, param_aux, taps->data, taps->length);
+    }
+    else if (op == SEQ_OP_SDFT)
+    {
+        rc = seq_mc_stream_init_sdft(&mc.st, ch, param_main, cli_sdft_bins, cli_sdft_nbins);
+    }
+    else
+    {
+        rc = seq_mc_stream_init(&mc.st, op, ch, param_main, fill);
+    }
+    if (rc != SEQ_OK)
+    {
+        cli_print_online(0);
+        cli_log_error("failed to initialize multichannel streaming state");
+        return 1;
+    }
+
+    cli_print_online(1);
+
+    /* 每次读 CLI_STREAM_BLOCK 帧，直到 END 或 EOF。Read CLI_STREAM_BLOCK frames at a time up to END or EOF. */
+    mc.ch = ch;
+    mc.out_frames = seq_mc_stream_output_bound(&mc.st, CLI_STREAM_BLOCK);
+    s.step = cli_step_mc;
+    s.finish = cli_finish_mc;
+    s.ctx = &mc;
+    s.in_cap = CLI_STREAM_BLOCK * ch;
+    s.frame = ch;
+    s.out_cap = (mc.out_frames > 0 ? mc.out_frames : 1) * ch;
+    rc = cli_stream_run(&s);
+    cli_end_output();
+
+    seq_mc_stream_dispose(&mc.st);
+    return (rc == SEQ_OK) ? 0 : 1;
+}
+
+/**
+ * @brief 按操作与参数初始化单路流式状态。Initialize a single streaming state from the op and its parameters.
+ *
+ * @param st [out] 流式状态。Streaming state.
+ * @param op 操作类型。Operation type.
+ * @param param_main 主参数。Main parameter.
+ * @param param_aux 辅助参数（resample 的下采样因子）。Aux parameter (resample down factor).
+ * @param fill 填充值。Fill value.
+ * @param taps 冲激响应，仅 fir/resample 使用。Impulse response, fir/resample only.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t cli_init_stream_state(seq_stream_t *st, seq_op_type op, size_t param_main, size_t param_aux,
+                                       double fill, const seq_t *taps)
+{
+    if (op == SEQ_OP_FIR)
+    {
+        return seq_stream_init_fir(st, taps->data, taps->length, param_main);
+    }
+    if (op == SEQ_OP_RESAMPLE)
+    {
+        return seq_stream_init_resample(st, param_main, param_aux, taps->data, taps->length);
+    }
+    if (op == SEQ_OP_SDFT)
+    {
+        return seq_stream_init_sdft(st, param_main, cli_sdft_bins, cli_sdft_nbins);
+    }
+    return seq_stream_init(st, op, param_main, 0, fill);
+}
+
+/**
+ * @brief 执行流式模式操作。Execute operation in stream mode.
+ *
+ * @param op 操作类型。Operation type.
+ * @param param_main 主参数。Main parameter.
+ * @param param_aux 辅助参数（resample 的下采样因子）。Aux parameter (resample down factor).
+ * @param fill 填充值。Fill value.
+ * @param taps 冲激响应，仅 fir/resample 使用。Impulse response, fir/resample only.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_run_stream(seq_op_type op, size_t param_main, size_t param_aux, double fill,
+                          const seq_t *taps)
+{
+    seq_stream_t st;
+    cli_stream_t s;
+    cli_ckpt_t ck = {0};
+    seq_err_t rc;
+
+    if (!seq_online_capable(op, 1))
+    {
+        cli_print_online(0);
+        cli_log_error("operation not supported for online infinite input");
+        return 1;
+    }
+    if (cli_channels > 1)
+    {
+        return cli_run_stream_mc(op, param_main, param_aux, fill, taps);
+    }
+
+    rc = cli_init_stream_state(&st, op, param_main, param_aux, fill, taps);
+    if (rc != SEQ_OK)
+    {
+        cli_print_online(0);
+        cli_log_error("failed to initialize streaming state");
+        return 1;
+    }
+
+    if ((cli_checkpoint || cli_restore) && cli_ckpt_open(&ck, &st, NULL) != 0)
+    {
+        cli_print_online(0);
+        free(ck.buf);
+        seq_stream_dispose(&st);
+        return 1;
+    }
+
+    cli_print_online(1);
+
+    s.step = cli_step_single;
+    s.finish = cli_finish_single;
+    s.ctx = &st;
+    if (cli_checkpoint || cli_restore)
+    {
+        s.step = cli_step_ckpt;
+        s.finish = cli_finish_ckpt;
+        s.ctx = &ck;
+    }
+    s.in_cap = CLI_STREAM_BLOCK;
+    s.frame = 1;
+    s.out_cap = seq_stream_output_bound(&st, CLI_STREAM_BLOCK);
+    rc = cli_stream_run(&s);
+    cli_end_output();
+
+    free(ck.buf);
+    seq_stream_dispose(&st);
+    return (rc == SEQ_OK) ? 0 : 1;
+}
+
+/* ---------- 多级流水线（chain） ---------- */
+
+/**
+ * @brief 解析并初始化 chain 规格中的一级，如 "delay:2:0"。Parse and init one chain stage such as "delay:2:0".
+ *
+ * @param text [in,out] 该级文本，':' 会被就地改写为 '\0'。Stage text; ':' is overwritten with '\0'.
+ * @param st [out] 已初始化的流式状态。Initialized streaming state.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_parse_stage(char *text, seq_stream_t *st)
+{
+    const char *fields[CLI_STAGE_FIELDS] = {NULL};
+    size_t nfields = 0;
+    char *p = text;
+    seq_op_type op;
+    size_t param_main = 0;
+    size_t param_aux = 0;
+    double fill = 0.0;
+
+    while (p && nfields < CLI_STAGE_FIELDS)
+    {
+        char *sep = strchr(p, ':');
+        fields[nfields++] = p;
+        if (sep)
+        {
+            *sep = '\0';
+            p = sep + 1;
+        }
+        else
+        {
+            p = NULL;
+        }
+    }
+    if (p)
+    {
+        cli_log_error("too many parameters in chain stage");
+        return -1;
+    }
+    if (cli_parse_op(fields[0], &op) != 0)
+    {
+        cli_log_error("unknown operation in chain spec");
+        return -1;
+    }
+    if (!seq_online_capable(op, 1))
+    {
+        cli_log_error("chain stage not supported for online infinite input");
+        return -1;
+    }
+
+    switch (op)
+    {
+    case SEQ_OP_PAD_FRONT:
+    case SEQ_OP_PAD_BACK:
+    case SEQ_OP_UPSAMPLE:
+    case SEQ_OP_DOWNSAMPLE:
+        if (nfields != 2 || cli_parse_size(fields[1], &param_main) != 0)
+        {
+            cli_log_error("chain stage expects one size parameter");
+            return -1;
+        }
+        break;
+
+    case SEQ_OP_DELAY:
+    case SEQ_OP_ADVANCE:
+        if (nfields < 2 || nfields > 3 || cli_parse_size(fields[1], &param_main) != 0 ||
+            (nfields == 3 && cli_parse_double(fields[2], &fill) != 0))
+        {
+            cli_log_error("chain delay/advance expects <op>:<amount>[:<fill>]");
+            return -1;
+        }
+        break;
+
+    case SEQ_OP_DIFF:
+    case SEQ_OP_CUMSUM:
+        if (nfields != 1)
+        {
+            cli_log_error("chain stage takes no parameters");
+            return -1;
+        }
+        break;
+
+    case SEQ_OP_FIR:
+    {
+        seq_t taps = {0};
+        seq_err_t err;
+        if (nfields < 2 || nfields > 3 ||
+            (nfields == 3 && cli_parse_size(fields[2], &param_main) != 0))
+        {
+            cli_log_error("chain fir expects fir:<taps-file>[:<block>]");
+            return -1;
+        }
+        if (cli_read_taps(fields[1], &taps) != 0)
+        {
+            return -1;
+        }
+        err = seq_stream_init_fir(st, taps.data, taps.length, param_main);
+        seq_free(&taps);
+        if (err != SEQ_OK)
+        {
+            cli_log_error("failed to initialize chain fir stage");
+            return -1;
+        }
+        return 0;
+    }
+
+    case SEQ_OP_RESAMPLE:
+    {
+        seq_t taps = {0};
+        seq_err_t err;
+        if (nfields != 4 || cli_parse_size(fields[1], &param_main) != 0 ||
+            cli_parse_size(fields[2], &param_aux) != 0)
+        {
+            cli_log_error("chain resample expects resample:<up>:<down>:<taps-file>");
+            return -1;
+        }
+        if (cli_read_taps(fields[3], &taps) != 0)
+        {
+            return -1;
+        }
+        err = seq_stream_init_resample(st, param_main, param_aux, taps.data, taps.length);
+        seq_free(&taps);
+        if (err != SEQ_OK)
+        {
+            cli_log_error("failed to initialize chain resample stage");
+            return -1;
+        }
+        return 0;
+    }
+
+    case SEQ_OP_SDFT:
+    {
+        size_t bins[CLI_SDFT_MAX_BINS];
+        size_t nbins = 0;
+        if (cli_parse_sdft(fields + 1, nfields - 1, &param_main, bins, &nbins) != 0)
+        {
+            cli_log_error("chain sdft expects sdft:<window>:<bin>[:<bin>...]");
+            return -1;
+        }
+        if (seq_stream_init_sdft(st, param_main, bins, nbins) != SEQ_OK)
+        {
+            cli_log_error("failed to initialize chain sdft stage");
+            return -1;
+        }
+        return 0;
+    }
+
+    default:
+        cli_log_error("unsupported operation in chain spec");
+        return -1;
+    }
+
+    if (seq_stream_init(st, op, param_main, 0, fill) != SEQ_OK)
+    {
+        cli_log_error("failed to initialize chain stage");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 流式输出回调：格式同 stream 模式。Stream-mode sink, same format as stream mode.
+ *
+ * @param ctx [in,out] 已输出个数 (size_t *)。Count of values printed so far (size_t *).
+ */
+static seq_err_t cli_sink_stream(void *ctx, const double *y, size_t n)
+{
+    *(size_t *)ctx += n;
+    cli_print_values(y, n);
+    return SEQ_OK;
+}
+
+/**
+ * @brief 有限模式输出回调：格式同 finite 模式。Finite-mode sink, same format as finite mode.
+ *
+ * @param ctx [in,out] 已输出个数 (size_t *)。Count of values printed so far (size_t *).
+ */
+static seq_err_t cli_sink_finite(void *ctx, const double *y, size_t n)
+{
+    size_t *count = (size_t *)ctx;
+    size_t i = 0;
+    num_writer_t w;
+    const uint64_t t0 = SEQ_STATS_START();
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        seq_err_t err = seq_io_write(stdout, cli_out_fmt, y, n);
+        SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, n, 0);
+        return err;
+    }
+    num_writer_init(&w, stdout);
+    while (i < n)
+    {
+        if (*count > 0)
+        {
+            num_write_char(&w, ' ');
+        }
+        num_write_g(&w, y[i], CLI_TEXT_DIGITS);
+        (*count)++;
+        i++;
+    }
+    SEQ_STATS_PHASE(SEQ_STATS_FORMAT, t0, n, 0);
+    return (num_writer_flush(&w) == 0) ? SEQ_OK : SEQ_ERR_STATE;
+}
+
+/**
+ * @brief 执行 chain：按规格构造流水线并处理 stdin。Run a chain: build a pipeline from the spec and process stdin.
+ *
+ * @param spec [in] 逗号分隔的级列表。Comma-separated stage list.
+ * @param finite [in] 非 0 表示有限模式输入。Non-zero for finite-mode input.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ *
+ * @note 有限模式下结果与逐个运行各级的 stream 模式一致（仅限可在线实现的操作）。
+ *       In finite mode the result equals running each stage in stream mode in turn
+ *       (online-capable operations only).
+ */
+static int cli_run_chain(const char *spec, int finite)
+{
+    seq_stream_t stages[CLI_MAX_STAGES];
+    seq_pipeline_t pl;
+    size_t nstages = 0;
+    size_t count = 0;
+    char *text;
+    char *p;
+    int rc = SEQ_OK;
+
+    text = (char *)malloc(strlen(spec) + 1);
+    if (!text)
+    {
+        cli_log_error("memory allocation failed for chain spec");
+        return 1;
+    }
+    strcpy(text, spec);
+
+    p = text;
+    while (p && rc == SEQ_OK)
+    {
+        char *sep = strchr(p, ',');
+        if (sep)
+        {
+            *sep = '\0';
+        }
+        if (nstages == CLI_MAX_STAGES)
+        {
+            cli_log_error("too many stages in chain spec");
+            rc = SEQ_ERR_ARG;
+        }
+        else if (cli_parse_stage(p, &stages[nstages]) != 0)
+        {
+            rc = SEQ_ERR_ARG;
+        }
+        else
+        {
+            nstages++;
+        }
+        p = sep ? sep + 1 : NULL;
+    }
+    free(text);
+
+    if (rc == SEQ_OK)
+    {
+        rc = seq_pipeline_init(&pl, stages, nstages, 0,
+                               finite ? cli_sink_finite : cli_sink_stream, &count);
+    }
+    if (rc != SEQ_OK)
+    {
+        while (nstages > 0)
+        {
+            seq_stream_dispose(&stages[--nstages]);
+        }
+        cli_print_online(0);
+        return 1;
+    }
+
+    if (finite)
+    {
+        seq_io_buf_t src;
+        if (cli_load_finite(&src) != 0)
+        {
+            seq_pipeline_dispose(&pl);
+            return 1;
+        }
+        cli_print_online(1);
+        rc = seq_pipeline_push(&pl, src.seq.data, src.seq.length);
+        seq_io_release(&src);
+    }
+    else
+    {
+        double *in = (double *)malloc(CLI_STREAM_BLOCK * sizeof(double));
+        cli_ckpt_t ck = {0};
+        size_t n_in = 0;
+        int done = 0;
+
+        if (!in || ((cli_checkpoint || cli_restore) && cli_ckpt_open(&ck, NULL, &pl) != 0))
+        {
+            if (!in)
+            {
+                cli_log_error("memory allocation failed for stream buffer");
+            }
+            free(in);
+            free(ck.buf);
+            seq_pipeline_dispose(&pl);
+            cli_print_online(0);
+            return 1;
+        }
+        cli_print_online(1);
+        while (!done && rc == SEQ_OK)
+        {
+            const size_t before = count;
+            if (cli_read_stream_block(in, CLI_STREAM_BLOCK, &n_in, &done) != 0)
+            {
+                rc = SEQ_ERR_ARG;
+                break;
+            }
+            rc = seq_pipeline_push(&pl, in, n_in);
+            if (rc == SEQ_OK && (cli_checkpoint || cli_restore))
+            {
+                rc = cli_ckpt_advance(&ck, n_in, count - before);
+            }
+        }
+        free(ck.buf);
+        free(in);
+    }
+
+    if (rc == SEQ_OK)
+    {
+        rc = seq_pipeline_finish(&pl);
+    }
+    if (rc != SEQ_OK)
+    {
+        cli_log_error("chain processing failed");
+    }
+    cli_end_output();
+
+    seq_pipeline_dispose(&pl);
+    return (rc == SEQ_OK) ? 0 : 1;
+}
+
+/* ---------- 分块离线模式 ---------- */
+
+/**
+ * @brief 执行分块离线（out-of-core）模式。Execute out-of-core chunked mode.
+ *
+ * @param op 操作类型。Operation type.
+ * @param param_main 主参数。Main parameter.
+ * @param fill 填充值。Fill value.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ *
+ * @note 输出格式同 finite 模式，但整条序列不会同时驻留内存。
+ *       Output matches finite mode, but the sequence is never held in memory as a whole.
+ */
+static int cli_run_ooc(seq_op_type op, size_t param_main, double fill)
+{
+    size_t count = 0;
+    seq_err_t err;
+
+    if (!seq_ooc_capable(op))
+    {
+        cli_log_error("operation has no out-of-core form (use stream mode for causal ops)");
+        return 1;
+    }
+    if (cli_in_fmt == SEQ_FMT_TEXT)
+    {
+        cli_log_error("ooc mode needs a binary input format (--format or --in-format)");
+        return 1;
+    }
+
+    cli_print_online(seq_online_capable(op, 0));
+    err = seq_ooc_apply(op, stdin, cli_in_fmt, param_main, fill, cli_chunk, cli_sink_finite, &count);
+    cli_end_output();
+    if (err != SEQ_OK)
+    {
+        cli_log_error("out-of-core processing failed");
+        return 1;
+    }
+    return 0;
+}
+
+/* ---------- 多路流服务（serve） ---------- */
+
+/**
+ * @brief serve 模式中每路流共用的操作参数。Op parameters shared by every stream in serve mode.
+ */
+typedef struct
+{
+    seq_op_type op;    /**< 操作类型。Operation type. */
+    size_t param_main; /**< 主参数。Main parameter. */
+    size_t param_aux;  /**< 辅助参数。Aux parameter. */
+    double fill;       /**< 填充值。Fill value. */
+    const seq_t *taps; /**< 冲激响应。Impulse response. */
+} cli_serve_ctx_t;
+
+/**
+ * @brief 新连接的初始化回调。Init callback for a new connection.
+ */
+static seq_err_t cli_serve_init(void *ctx, seq_stream_t *st)
+{
+    const cli_serve_ctx_t *c = (const cli_serve_ctx_t *)ctx;
+    return cli_init_stream_state(st, c->op, c->param_main, c->param_aux, c->fill, c->taps);
+}
+
+/**
+ * @brief 执行 serve 模式：每个连接是一路独立的流。Execute serve mode: every connection is an independent stream.
+ *
+ * @param op 操作类型。Operation type.
+ * @param param_main 主参数。Main parameter.
+ * @param param_aux 辅助参数（resample 的下采样因子）。Aux parameter (resample down factor).
+ * @param fill 填充值。Fill value.
+ * @param taps 冲激响应，仅 fir/resample 使用。Impulse response, fir/resample only.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int cli_run_serve(seq_op_type op, size_t param_main, size_t param_aux, double fill,
+                         const seq_t *taps)
+{
+    cli_serve_ctx_t ctx;
+    seq_server_cfg_t cfg;
+    seq_stream_t probe;
+    unsigned port = 0;
+    int fd = -1;
+    seq_err_t err;
+
+    if (!seq_online_capable(op, 1))
+    {
+        cli_print_online(0);
+        cli_log_error("operation not supported for online infinite input");
+        return 1;
+    }
+    if (cli_in_fmt == SEQ_FMT_TEXT || cli_out_fmt == SEQ_FMT_TEXT)
+    {
+        cli_log_error("serve mode needs binary input and output formats (--format)");
+        return 1;
+    }
+    if (!cli_listen)
+    {
+        cli_log_error("serve mode needs --listen=ADDR");
+        return 1;
+    }
+
+    /* 先试初始化一次，参数错误在监听前报告。Init once up front so bad parameters fail before listening. */
+    if (cli_init_stream_state(&probe, op, param_main, param_aux, fill, taps) != SEQ_OK)
+    {
+        cli_print_online(0);
+        cli_log_error("failed to initialize streaming state");
+        return 1;
+    }
+    seq_stream_dispose(&probe);
+
+    if (seq_server_listen(cli_listen, &fd, &port) != SEQ_OK)
+    {
+        cli_log_error("cannot listen on --listen address");
+        return 1;
+    }
+    cli_print_online(1);
+    if (strncmp(cli_listen, "tcp:", 4) == 0)
+    {
+        fprintf(stderr, "LISTEN:tcp:%u\n", port);
+    }
+    else
+    {
+        fprintf(stderr, "LISTEN:%s\n", cli_listen);
+    }
+    fflush(stderr);
+
+    ctx.op = op;
+    ctx.param_main = param_main;
+    ctx.param_aux = param_aux;
+    ctx.fill = fill;
+    ctx.taps = taps;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.in_fmt = cli_in_fmt;
+    cfg.out_fmt = cli_out_fmt;
+    cfg.threads = cli_threads;
+    cfg.sessions = cli_sessions;
+    cfg.init = cli_serve_init;
+    cfg.ctx = &ctx;
+    err = seq_server_run(fd, &cfg);
+    seq_server_close(fd);
+    if (err != SEQ_OK)
+    {
+        cli_log_error("server stopped on an error");
+        return 1;
+    }
+    return 0;
+}
+
+/* ---------- 对外主入口 ---------- */
+
+/**
+ * @brief 解析并移除 --format 类选项，其余参数原地前移。Parse and remove --format style options, compacting argv in place.
+ *
+ * @param argc [in,out] 参数个数。Argument count.
+ * @param argv [in,out] 参数数组。Argument vector.
+ * @return 0 成功；非 0 表示未知选项或格式。0 on success, non-zero on an unknown option or format.
+ */
+static int cli_parse_options(int *argc, char **argv)
+{
+    int i = 1;
+    int kept = 1;
+
+    while (i < *argc)
+    {
+        const char *arg = argv[i];
+        seq_fmt_t fmt;
+
+        if (strncmp(arg, "--", 2) != 0)
+        {
+            argv[kept++] = argv[i++];
+            continue;
+        }
+        if (strncmp(arg, "--format=", 9) == 0 && seq_fmt_parse(arg + 9, &fmt) == SEQ_OK)
+        {
+            cli_in_fmt = fmt;
+            cli_out_fmt = fmt;
+        }
+        else if (strncmp(arg, "--in-format=", 12) == 0 && seq_fmt_parse(arg + 12, &fmt) == SEQ_OK)
+        {
+            cli_in_fmt = fmt;
+        }
+        else if (strncmp(arg, "--out-format=", 13) == 0 && seq_fmt_parse(arg + 13, &fmt) == SEQ_OK)
+        {
+            cli_out_fmt = fmt;
+        }
+        else if (strncmp(arg, "--channels=", 11) == 0)
+        {
+            if (cli_parse_size(arg + 11, &cli_channels) != 0 || cli_channels == 0)
+            {
+                cli_log_error("invalid --channels value");
+                return -1;
+            }
+        }
+        else if (strncmp(arg, "--listen=", 9) == 0 && arg[9] != '\0')
+        {
+            cli_listen = arg + 9;
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0)
+        {
+            if (cli_parse_size(arg + 10, &cli_threads) != 0)
+            {
+                cli_log_error("invalid --threads value");
+                return -1;
+            }
+        }
+        else if (strncmp(arg, "--sessions=", 11) == 0)
+        {
+            if (cli_parse_size(arg + 11, &cli_sessions) != 0)
+            {
+                cli_log_error("invalid --sessions value");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--stats") == 0)
+        {
+            cli_stats = 1;
+        }
+        else if (strncmp(arg, "--checkpoint=", 13) == 0 && arg[13] != '\0')
+        {
+            cli_checkpoint = arg + 13;
+        }
+        else if (strncmp(arg, "--checkpoint-every=", 19) == 0)
+        {
+            if (cli_parse_size(arg + 19, &cli_checkpoint_every) != 0 || cli_checkpoint_every == 0)
+            {
+                cli_log_error("invalid --checkpoint-every value");
+                return -1;
+            }
+        }
+        else if (strncmp(arg, "--restore=", 10) == 0 && arg[10] != '\0')
+        {
+            cli_restore = arg + 10;
+        }
+        else if (strncmp(arg, "--chunk=", 8) == 0)
+        {
+            if (cli_parse_size(arg + 8, &cli_chunk) != 0 || cli_chunk == 0)
+            {
+                cli_log_error("invalid --chunk value");
+                return -1;
+            }
+        }
+        else
+        {
+            cli_log_error("unknown option or sample format");
+            return -1;
+        }
+        i++;
+    }
+    *argc = kept;
+    return 0;
+}
+
+/**
+ * @brief 按已去掉选项的参数执行操作。Run the operation given the arguments with options removed.
+ *
+ * @param argc [in] 参数个数。Argument count.
+ * @param argv [in] 参数数组。Argument vector.
+ * @return 进程退出码。Process exit code.
+ */
+static int cli_dispatch(int argc, char **argv)
+{
+    seq_op_type op;
+    const char *mode;
+    size_t param_main = 0;
+    size_t param_aux = 0;
+    double fill = 0.0;
+    seq_t taps = {0};
+    int rc;
+
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        seq_io_binary_mode(stdin);
+        setvbuf(stdin, NULL, _IOFBF, CLI_IO_BUFFER);
+    }
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        seq_io_binary_mode(stdout);
+        setvbuf(stdout, NULL, _IOFBF, CLI_IO_BUFFER);
+    }
+
+    if (argc < 3)
+    {
+        cli_log_error("not enough arguments");
+        cli_print_usage();
+        return 1;
+    }
+
+    /* 最后一个参数固定视为模式：finite 或 stream */
+    mode = argv[argc - 1];
+
+    if (cli_channels > 1 && (strcmp(argv[1], "chain") == 0 || strcmp(mode, "stream") != 0))
+    {
+        cli_log_error("--channels is only supported by single-op stream mode");
+        return 1;
+    }
+
+    if ((cli_checkpoint || cli_restore) && (cli_channels > 1 || strcmp(mode, "stream") != 0))
+    {
+        cli_log_error("--checkpoint/--restore are only supported by single-channel stream mode");
+        return 1;
+    }
+
+    /* chain <spec> <mode>：多级流水线。Multi-stage pipeline. */
+    if (strcmp(argv[1], "chain") == 0)
+    {
+        if (argc != 4)
+        {
+            cli_log_error("chain expects <spec> finite|stream");
+            cli_print_usage();
+            return 1;
+        }
+        if (strcmp(mode, "finite") != 0 && strcmp(mode, "stream") != 0)
+        {
+            cli_log_error("unknown mode (expected 'finite' or 'stream')");
+            cli_print_usage();
+            return 1;
+        }
+        return cli_run_chain(argv[2], strcmp(mode, "finite") == 0);
+    }
+
+    if (cli_parse_op(argv[1], &op) != 0)
+    {
+        cli_log_error("unknown operation");
+        cli_print_usage();
+        return 1;
+    }
+
+    /* 解析各操作参数：argv[2] .. argv[argc-2]（不含 mode） */
+    {
+        int param_count = argc - 3; /* ✅ 正确减掉 程序名+操作名+模式 */
+        const char **params = (const char **)&argv[2];
 
         if (param_count < 0)
         {
@@ -522,6 +2099,51 @@ int cli_main(int argc, char **argv)
             }
             break;
 
+        case SEQ_OP_FIR:
+            if (param_count != 1 && param_count != 2)
+            {
+                cli_log_error("fir expects <taps-file> [block]");
+                cli_print_usage();
+                return 1;
+            }
+            if (param_count == 2 && cli_parse_size(params[1], &param_main) != 0)
+            {
+                cli_log_error("invalid block parameter");
+                return 1;
+            }
+            if (cli_read_taps(params[0], &taps) != 0)
+            {
+                return 1;
+            }
+            break;
+
+        case SEQ_OP_RESAMPLE:
+            if (param_count != 3)
+            {
+                cli_log_error("resample expects <up> <down> <taps-file>");
+                cli_print_usage();
+                return 1;
+            }
+            if (cli_parse_size(params[0], &param_main) != 0 ||
+                cli_parse_size(params[1], &param_aux) != 0)
+            {
+                cli_log_error("invalid resample factor");
+                return 1;
+            }
+            if (cli_read_taps(params[2], &taps) != 0)
+            {
+                return 1;
+            }
+            break;
+
+        case SEQ_OP_SDFT:
+            if (cli_parse_sdft(params, (size_t)param_count, &param_main, cli_sdft_bins, &cli_sdft_nbins) != 0)
+            {
+                cli_print_usage();
+                return 1;
+            }
+            break;
+
         default:
             cli_log_error("unsupported operation");
             return 1;
@@ -531,14 +2153,59 @@ int cli_main(int argc, char **argv)
     /* 根据模式选择运行方式 */
     if (strcmp(mode, "finite") == 0)
     {
-        return cli_run_finite(op, param_main, fill);
+        rc = cli_run_finite(op, param_main, param_aux, fill, &taps);
+    }
+    else if (strcmp(mode, "stream") == 0)
+    {
+        rc = cli_run_stream(op, param_main, param_aux, fill, &taps);
+    }
+    else if (strcmp(mode, "ooc") == 0)
+    {
+        rc = cli_run_ooc(op, param_main, fill);
+    }
+    else if (strcmp(mode, "serve") == 0)
+    {
+        rc = cli_run_serve(op, param_main, param_aux, fill, &taps);
+    }
+    else
+    {
+        cli_log_error("unknown mode (expected 'finite', 'stream', 'ooc' or 'serve')");
+        cli_print_usage();
+        rc = 1;
+    }
+
+    seq_free(&taps);
+    return rc;
+}
+
+int cli_main(int argc, char **argv)
+{
+    int rc;
+
+    if (cli_parse_options(&argc, argv) != 0)
+    {
+        cli_print_usage();
+        return 1;
+    }
+    if (cli_stats && seq_stats_enable(1) != SEQ_OK)
+    {
+        cli_log_error("--stats is not available in this build");
+        return 1;
     }
-    if (strcmp(mode, "stream") == 0)
+
+    if (cli_in_fmt == SEQ_FMT_TEXT && num_reader_init(&cli_text, stdin, 0) != 0)
     {
-        return cli_run_stream(op, param_main, fill);
+        cli_log_error("failed to allocate the text input buffer");
+        return 1;
     }
 
-    cli_log_error("unknown mode (expected 'finite' or 'stream')");
-    cli_print_usage();
-    return 1;
-}
\ No newline at end of file
+    rc = cli_dispatch(argc, argv);
+
+    num_reader_free(&cli_text);
+    if (cli_stats)
+    {
+        fflush(stdout);
+        seq_stats_dump(stderr);
+    }
+    return rc;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file fft.c
+ * @brief 实序列 FFT 实现：Stockham 自排序混合基复变换 + 实变换后处理。
+ *        Real-input FFT: self-sorting Stockham mixed-radix complex transform
+ *        plus a real-signal post-pass.
+ */
+
+#include "fft.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define FFT_PI 3.14159265358979323846
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void fft_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[fft] error: %s\n", msg);
+}
+
+/**
+ * @brief 把 half 分解为 4、2、3、5 及其余素因子。Factorize half into 4, 2, 3, 5 and other primes.
+ *
+ * @param p [in,out] 计划。Plan.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t fft_factorize(fft_plan_t *p)
+{
+    size_t m = p->half;
+    size_t nf = 0;
+
+    while (m % 4 == 0 && nf < FFT_MAX_FACTORS)
+    {
+        p->factors[nf++] = 4;
+        m /= 4;
+    }
+    while (m % 2 == 0 && nf < FFT_MAX_FACTORS)
+    {
+        p->factors[nf++] = 2;
+        m /= 2;
+    }
+    for (size_t f = 3; m > 1 && nf < FFT_MAX_FACTORS; f += 2)
+    {
+        if (f * f > m)
+        {
+            f = m;
+        }
+        while (m % f == 0 && nf < FFT_MAX_FACTORS)
+        {
+            p->factors[nf++] = f;
+            m /= f;
+        }
+    }
+
+    if (m != 1)
+    {
+        fft_log_error("fft_plan_init: too many radix factors");
+        return SEQ_ERR_ARG;
+    }
+
+    p->nfactors = nf;
+    return SEQ_OK;
+}
+
+seq_err_t fft_plan_init(fft_plan_t *p, size_t n)
+{
+    if (!p)
+    {
+        fft_log_error("fft_plan_init: null plan");
+        return SEQ_ERR_ARG;
+    }
+
+    p->n = 0;
+    p->half = 0;
+    p->nfactors = 0;
+    p->twiddle = NULL;
+    p->rtwiddle = NULL;
+
+    if (n < 2 || (n % 2) != 0)
+    {
+        fft_log_error("fft_plan_init: length must be a positive even number");
+        return SEQ_ERR_ARG;
+    }
+
+    p->n = n;
+    p->half = n / 2;
+
+    if (fft_factorize(p) != SEQ_OK)
+    {
+        fft_plan_free(p);
+        return SEQ_ERR_ARG;
+    }
+
+    p->twiddle = (fft_cpx_t *)malloc(p->half * sizeof(fft_cpx_t));
+    p->rtwiddle = (fft_cpx_t *)malloc(p->half * sizeof(fft_cpx_t));
+    if (!p->twiddle || !p->rtwiddle)
+    {
+        fft_log_error("fft_plan_init: out of memory");
+        fft_plan_free(p);
+        return SEQ_ERR_NOMEM;
+    }
+
+    {
+        size_t k = 0;
+        while (k < p->half)
+        {
+            double ph = -2.0 * FFT_PI * (double)k / (double)p->half;
+            double rph = -2.0 * FFT_PI * (double)k / (double)n;
+            p->twiddle[k].re = cos(ph);
+            p->twiddle[k].im = sin(ph);
+            p->rtwiddle[k].re = cos(rph);
+            p->rtwiddle[k].im = sin(rph);
+            k++;
+        }
+    }
+    return SEQ_OK;
+}
+
+void fft_plan_free(fft_plan_t *p)
+{
+    if (!p)
+    {
+        return;
+    }
+    free(p->twiddle);
+    free(p->rtwiddle);
+    p->twiddle = NULL;
+    p->rtwiddle = NULL;
+    p->n = 0;
+    p->half = 0;
+    p->nfactors = 0;
+}
+
+/* ---------- 复变换内核 ---------- */
+
+/*
+ * 前向 Stockham 变换：x 为输入，y 为等长工作区，返回保存结果的缓冲区。
+ * Forward Stockham transform: x is the input, y a scratch of equal size;
+ * returns whichever buffer holds the result.
+ *
+ * 第 i 级：长度 len 拆为 f 个长度 m 的子序列，步长 s 为已处理因子之积。
+ * Stage i splits length len into f sub-sequences of length m; stride s
+ * is the product of the factors already processed.
+ */
+static fft_cpx_t *fft_cfft_forward(const fft_plan_t *p, fft_cpx_t *x, fft_cpx_t *y)
+{
+    const size_t nn = p->half;
+    const fft_cpx_t *w = p->twiddle;
+    size_t len = nn;
+    size_t s = 1;
+    fft_cpx_t *src = x;
+    fft_cpx_t *dst = y;
+
+    for (size_t fi = 0; fi < p->nfactors; ++fi)
+    {
+        const size_t f = p->factors[fi];
+        const size_t m = len / f;
+
+        for (size_t q = 0; q < m; ++q)
+        {
+            for (size_t k = 0; k < s; ++k)
+            {
+                const fft_cpx_t *in = src + k + s * q;
+                fft_cpx_t *out = dst + k + s * f * q;
+                const size_t is = s * m; /* 输入基间距 / input radix stride */
+
+                if (f == 2)
+                {
+                    fft_cpx_t a0 = in[0], a1 = in[is];
+                    fft_cpx_t b1 = {a0.re - a1.re, a0.im - a1.im};
+                    fft_cpx_t t1 = w[q * s];
+                    out[0].re = a0.re + a1.re;
+                    out[0].im = a0.im + a1.im;
+                    out[s].re = b1.re * t1.re - b1.im * t1.im;
+                    out[s].im = b1.re * t1.im + b1.im * t1.re;
+                }
+                else if (f == 4)
+                {
+                    fft_cpx_t a0 = in[0], a1 = in[is], a2 = in[2 * is], a3 = in[3 * is];
+                    fft_cpx_t s02 = {a0.re + a2.re, a0.im + a2.im};
+                    fft_cpx_t d02 = {a0.re - a2.re, a0.im - a2.im};
+                    fft_cpx_t s13 = {a1.re + a3.re, a1.im + a3.im};
+                    fft_cpx_t d13 = {a1.re - a3.re, a1.im - a3.im};
+                    /* b1 = d02 - i·d13, b3 = d02 + i·d13 */
+                    fft_cpx_t b[4];
+                    b[0].re = s02.re + s13.re;
+                    b[0].im = s02.im + s13.im;
+                    b[1].re = d02.re + d13.im;
+                    b[1].im = d02.im - d13.re;
+                    b[2].re = s02.re - s13.re;
+                    b[2].im = s02.im - s13.im;
+                    b[3].re = d02.re - d13.im;
+                    b[3].im = d02.im + d13.re;
+
+                    out[0] = b[0];
+                    for (size_t t = 1; t < 4; ++t)
+                    {
+                        fft_cpx_t tw = w[q * t * s];
+                        out[t * s].re = b[t].re * tw.re - b[t].im * tw.im;
+                        out[t * s].im = b[t].re * tw.im + b[t].im * tw.re;
+                    }
+                }
+                else
+                {
+                    /* 通用基：O(f^2) 小 DFT / generic radix: O(f^2) small DFT */
+                    const size_t wstep = nn / f;
+                    for (size_t t = 0; t < f; ++t)
+                    {
+                        double re = 0.0, im = 0.0;
+                        size_t idx = 0; /* (r*t) mod f */
+                        for (size_t r = 0; r < f; ++r)
+                        {
+                            fft_cpx_t a = in[r * is];
+                            fft_cpx_t c = w[idx * wstep];
+                            re += a.re * c.re - a.im * c.im;
+                            im += a.re * c.im + a.im * c.re;
+                            idx += t;
+                            if (idx >= f)
+                                idx -= f;
+                        }
+                        fft_cpx_t tw = w[q * t * s];
+                        out[t * s].re = re * tw.re - im * tw.im;
+                        out[t * s].im = re * tw.im + im * tw.re;
+                    }
+                }
+            }
+        }
+
+        len = m;
+        s *= f;
+        fft_cpx_t *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+seq_err_t fft_rfft(const fft_plan_t *p, const double *in, fft_cpx_t *out, fft_cpx_t *work)
+{
+    if (!p || !in || !out || !work || p->half == 0)
+    {
+        fft_log_error("fft_rfft: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    const size_t h = p->half;
+    fft_cpx_t *z = work;
+    for (size_t k = 0; k < h; ++k)
+    {
+        z[k].re = in[2 * k];
+        z[k].im = in[2 * k + 1];
+    }
+
+    const fft_cpx_t *zf = fft_cfft_forward(p, z, work + h);
+
+    out[0].re = zf[0].re + zf[0].im;
+    out[0].im = 0.0;
+    out[h].re = zf[0].re - zf[0].im;
+    out[h].im = 0.0;
+
+    for (size_t k = 1; k < h; ++k)
+    {
+        fft_cpx_t zk = zf[k];
+        fft_cpx_t zc = {zf[h - k].re, -zf[h - k].im}; /* conj(Z[h-k]) */
+        fft_cpx_t e = {0.5 * (zk.re + zc.re), 0.5 * (zk.im + zc.im)};
+        /* o = -i·(zk - zc)/2 */
+        fft_cpx_t o = {0.5 * (zk.im - zc.im), -0.5 * (zk.re - zc.re)};
+        fft_cpx_t tw = p->rtwiddle[k];
+        out[k].re = e.re + o.re * tw.re - o.im * tw.im;
+        out[k].im = e.im + o.re * tw.im + o.im * tw.re;
+    }
+
+    return SEQ_OK;
+}
+
+seq_err_t fft_irfft(const fft_plan_t *p, const fft_cpx_t *in, double *out, fft_cpx_t *work)
+{
+    if (!p || !in || !out || !work || p->half == 0)
+    {
+        fft_log_error("fft_irfft: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    const size_t h = p->half;
+    fft_cpx_t *z = work;
+
+    /* 重建 Z[k] = E[k] + i·O[k]，并取共轭以复用正变换。
+     * Rebuild Z[k] = E[k] + i·O[k], conjugated so the forward kernel can be reused. */
+    for (size_t k = 0; k < h; ++k)
+    {
+        fft_cpx_t xk = in[k];
+        fft_cpx_t xc = {in[h - k].re, -in[h - k].im}; /* conj(X[h-k]) */
+        fft_cpx_t e = {0.5 * (xk.re + xc.re), 0.5 * (xk.im + xc.im)};
+        fft_cpx_t d = {0.5 * (xk.re - xc.re), 0.5 * (xk.im - xc.im)};
+        fft_cpx_t tw = p->rtwiddle[k]; /* o = d·conj(tw) */
+        fft_cpx_t o = {d.re * tw.re + d.im * tw.im, d.im * tw.re - d.re * tw.im};
+        z[k].re = e.re - o.im;
+        z[k].im = -(e.im + o.re);
+    }
+
+    const fft_cpx_t *zt = fft_cfft_forward(p, z, work + h);
+    const double scale = 1.0 / (double)h;
+
+    for (size_t k = 0; k < h; ++k)
+    {
+        out[2 * k] = zt[k].re * scale;
+        out[2 * k + 1] = -zt[k].im * scale;
+    }
+
+    return SEQ_OK;
+}
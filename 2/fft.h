@@ -0,0 +1,88 @@
+#ifndef FFT_H
+#define FFT_H
+
+/**
+ * @file fft.h
+ * @brief 实序列快速傅里叶变换。Real-input fast Fourier transform.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/**
+ * @brief 复数样本。Complex sample.
+ */
+typedef struct
+{
+    double re; /**< 实部。Real part. */
+    double im; /**< 虚部。Imaginary part. */
+} fft_cpx_t;
+
+/** 最大分解因子个数。Maximum number of radix factors. */
+#define FFT_MAX_FACTORS 64
+
+/**
+ * @brief FFT 计划：旋转因子表与基分解。FFT plan: twiddle tables and radix factors.
+ *
+ * @note 长度 n 的实变换通过 n/2 点混合基复变换实现。
+ *       A length-n real transform runs on an n/2-point mixed-radix complex transform.
+ */
+typedef struct
+{
+    size_t n;                        /**< 实序列长度（偶数）。Real length (even). */
+    size_t half;                     /**< n/2。Complex length. */
+    size_t factors[FFT_MAX_FACTORS]; /**< half 的基分解。Radix factors of half. */
+    size_t nfactors;                 /**< 因子个数。Number of factors. */
+    fft_cpx_t *twiddle;              /**< e^{-2πik/half}。Complex twiddles. */
+    fft_cpx_t *rtwiddle;             /**< e^{-2πik/n}。Real post-pass twiddles. */
+} fft_plan_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化 FFT 计划。Initialize an FFT plan.
+     *
+     * @param p [out] 计划。Plan.
+     * @param n [in] 实序列长度，须为正偶数。Real length, must be positive and even.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t fft_plan_init(fft_plan_t *p, size_t n);
+
+    /**
+     * @brief 释放 FFT 计划。Free an FFT plan.
+     *
+     * @param p [in,out] 计划，可为 NULL。Plan, may be NULL.
+     */
+    void fft_plan_free(fft_plan_t *p);
+
+    /**
+     * @brief 实序列正变换（未归一化）。Forward real transform (unnormalized).
+     *
+     * @param p [in] 计划。Plan.
+     * @param in [in] 输入，长度 p->n。Input of length p->n.
+     * @param out [out] 频谱，长度 p->half + 1。Spectrum of p->half + 1 bins.
+     * @param work [in,out] 工作区，p->n 个复数。Scratch of p->n complex values.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t fft_rfft(const fft_plan_t *p, const double *in, fft_cpx_t *out, fft_cpx_t *work);
+
+    /**
+     * @brief 实序列逆变换（含 1/n 归一化）。Inverse real transform (includes 1/n scaling).
+     *
+     * @param p [in] 计划。Plan.
+     * @param in [in] 频谱，长度 p->half + 1。Spectrum of p->half + 1 bins.
+     * @param out [out] 输出，长度 p->n。Output of length p->n.
+     * @param work [in,out] 工作区，p->n 个复数。Scratch of p->n complex values.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t fft_irfft(const fft_plan_t *p, const fft_cpx_t *in, double *out, fft_cpx_t *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFT_H */
@@ -0,0 +1,261 @@
+/**
+ * @file fir.c
+ * @brief 均匀分区重叠保留 FIR 引擎实现。Uniformly partitioned overlap-save FIR engine.
+ */
+
+#include "fir.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void fir_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[fir] error: %s\n", msg);
+}
+
+/**
+ * @brief 按抽头数选择默认块长。Pick the default block length from the tap count.
+ *
+ * @param ntaps [in] 抽头数。Number of taps.
+ * @return 位于 [SEQ_FIR_MIN_BLOCK, SEQ_FIR_MAX_BLOCK] 的 2 的幂。
+ *         A power of two in [SEQ_FIR_MIN_BLOCK, SEQ_FIR_MAX_BLOCK].
+ */
+static size_t fir_default_block(size_t ntaps)
+{
+    size_t b = SEQ_FIR_MIN_BLOCK;
+    while (b < ntaps && b < SEQ_FIR_MAX_BLOCK)
+    {
+        b *= 2;
+    }
+    return b;
+}
+
+/**
+ * @brief 处理一个完整输入块。Process one full input block.
+ *
+ * @param f [in,out] 状态。State.
+ */
+static void fir_process_block(seq_fir_t *f)
+{
+    const size_t B = f->block;
+    const size_t nb = f->nbin;
+    fft_cpx_t *x = f->fdl + f->fdl_head * nb;
+    size_t p = 0;
+
+    fft_rfft(&f->plan, f->inbuf, x, f->work);
+
+    memset(f->acc, 0, nb * sizeof(fft_cpx_t));
+    while (p < f->parts)
+    {
+        /* 分区 p 与 p 块之前的输入频谱相乘。Partition p pairs with the spectrum p blocks ago. */
+        size_t slot = (f->fdl_head + f->parts - p) % f->parts;
+        const fft_cpx_t *h = f->kspec + p * nb;
+        const fft_cpx_t *xs = f->fdl + slot * nb;
+        size_t k = 0;
+        while (k < nb)
+        {
+            f->acc[k].re += h[k].re * xs[k].re - h[k].im * xs[k].im;
+            f->acc[k].im += h[k].re * xs[k].im + h[k].im * xs[k].re;
+            k++;
+        }
+        p++;
+    }
+
+    fft_irfft(&f->plan, f->acc, f->tbuf, f->work);
+
+    /* 重叠保留：后 B 个点为有效线性卷积。Overlap-save: the last B points are valid. */
+    memcpy(f->outbuf, f->tbuf + B, B * sizeof(double));
+    f->out_pos = 0;
+    f->out_count = B;
+
+    memcpy(f->inbuf, f->inbuf + B, B * sizeof(double));
+    f->in_fill = 0;
+    f->fdl_head = (f->fdl_head + 1) % f->parts;
+}
+
+seq_err_t seq_fir_init(seq_fir_t *f, const double *taps, size_t ntaps, size_t block)
+{
+    size_t p = 0;
+
+    if (!f)
+    {
+        fir_log_error("seq_fir_init: null state");
+        return SEQ_ERR_ARG;
+    }
+    memset(f, 0, sizeof(*f));
+
+    if (!taps || ntaps == 0)
+    {
+        fir_log_error("seq_fir_init: kernel must have at least one tap");
+        return SEQ_ERR_ARG;
+    }
+
+    f->taps = ntaps;
+    f->block = (block > 0) ? block : fir_default_block(ntaps);
+    f->parts = (ntaps + f->block - 1) / f->block;
+    f->nbin = f->block + 1;
+
+    if (fft_plan_init(&f->plan, 2 * f->block) != SEQ_OK)
+    {
+        return SEQ_ERR_ARG;
+    }
+
+    f->kspec = (fft_cpx_t *)malloc(f->parts * f->nbin * sizeof(fft_cpx_t));
+    f->fdl = (fft_cpx_t *)calloc(f->parts * f->nbin, sizeof(fft_cpx_t));
+    f->acc = (fft_cpx_t *)malloc(f->nbin * sizeof(fft_cpx_t));
+    f->work = (fft_cpx_t *)malloc(2 * f->block * sizeof(fft_cpx_t));
+    f->inbuf = (double *)calloc(2 * f->block, sizeof(double));
+    f->tbuf = (double *)malloc(2 * f->block * sizeof(double));
+    f->outbuf = (double *)malloc(f->block * sizeof(double));
+    if (!f->kspec || !f->fdl || !f->acc || !f->work || !f->inbuf || !f->tbuf || !f->outbuf)
+    {
+        fir_log_error("seq_fir_init: out of memory");
+        seq_fir_dispose(f);
+        return SEQ_ERR_NOMEM;
+    }
+
+    /* 预先变换各分区：[h[pB .. pB+B) | 0...0]。Pre-transform each partition. */
+    while (p < f->parts)
+    {
+        size_t base = p * f->block;
+        size_t len = (ntaps - base < f->block) ? (ntaps - base) : f->block;
+        memset(f->tbuf, 0, 2 * f->block * sizeof(double));
+        memcpy(f->tbuf, taps + base, len * sizeof(double));
+        fft_rfft(&f->plan, f->tbuf, f->kspec + p * f->nbin, f->work);
+        p++;
+    }
+
+    return SEQ_OK;
+}
+
+void seq_fir_dispose(seq_fir_t *f)
+{
+    if (!f)
+    {
+        return;
+    }
+    fft_plan_free(&f->plan);
+    free(f->kspec);
+    free(f->fdl);
+    free(f->acc);
+    free(f->work);
+    free(f->inbuf);
+    free(f->tbuf);
+    free(f->outbuf);
+    memset(f, 0, sizeof(*f));
+}
+
+seq_err_t seq_fir_push(seq_fir_t *f, double x)
+{
+    if (!f || !f->inbuf)
+    {
+        fir_log_error("seq_fir_push: invalid state");
+        return SEQ_ERR_ARG;
+    }
+    if (f->out_count > 0 && f->in_fill + 1 == f->block)
+    {
+        /* 新块即将覆盖未取走的输出。The next block would overwrite unread outputs. */
+        fir_log_error("seq_fir_push: outputs must be drained before the next block");
+        return SEQ_ERR_STATE;
+    }
+
+    f->inbuf[f->block + f->in_fill] = x;
+    f->in_fill++;
+    if (f->in_fill == f->block)
+    {
+        fir_process_block(f);
+    }
+    return SEQ_OK;
+}
+
+int seq_fir_pop(seq_fir_t *f, double *y)
+{
+    if (!f || f->out_count == 0)
+    {
+        return 0;
+    }
+    if (y)
+    {
+        *y = f->outbuf[f->out_pos];
+    }
+    f->out_pos++;
+    f->out_count--;
+    return 1;
+}
+
+seq_err_t seq_fir_process(seq_fir_t *f, const double *in, size_t n, double *out, size_t *n_out)
+{
+    size_t i = 0;
+    size_t o = 0;
+
+    if (!f || !f->inbuf || !n_out || (n > 0 && !in) || !out)
+    {
+        fir_log_error("seq_fir_process: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    /* 先取走此前残留的输出。Drain outputs left over from earlier calls. */
+    memcpy(out, f->outbuf + f->out_pos, f->out_count * sizeof(double));
+    o = f->out_count;
+    f->out_pos = 0;
+    f->out_count = 0;
+
+    while (i < n)
+    {
+        size_t take = f->block - f->in_fill;
+        if (take > n - i)
+        {
+            take = n - i;
+        }
+        memcpy(f->inbuf + f->block + f->in_fill, in + i, take * sizeof(double));
+        f->in_fill += take;
+        i += take;
+
+        if (f->in_fill == f->block)
+        {
+            fir_process_block(f);
+            memcpy(out + o, f->outbuf, f->block * sizeof(double));
+            o += f->block;
+            f->out_count = 0;
+        }
+    }
+
+    *n_out = o;
+    return SEQ_OK;
+}
+
+seq_err_t seq_fir_finish(seq_fir_t *f)
+{
+    size_t rest;
+
+    if (!f || !f->inbuf)
+    {
+        fir_log_error("seq_fir_finish: invalid state");
+        return SEQ_ERR_ARG;
+    }
+    if (f->in_fill == 0)
+    {
+        return SEQ_OK;
+    }
+    if (f->out_count > 0)
+    {
+        fir_log_error("seq_fir_finish: outputs must be drained first");
+        return SEQ_ERR_STATE;
+    }
+
+    rest = f->in_fill;
+    memset(f->inbuf + f->block + rest, 0, (f->block - rest) * sizeof(double));
+    fir_process_block(f);
+    f->out_count = rest;
+    return SEQ_OK;
+}
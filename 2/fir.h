@@ -0,0 +1,127 @@
+#ifndef FIR_H
+#define FIR_H
+
+/**
+ * @file fir.h
+ * @brief 均匀分区重叠保留 FIR 引擎。Uniformly partitioned overlap-save FIR engine.
+ *
+ * 核 h 被切成 P = ceil(taps/B) 段长度为 B 的分区，每段预先变换到 2B 点频域；
+ * 输入每满一块 B 个样本做一次 2B 点 FFT，存入频域延迟线 (FDL)，
+ * 与各分区频谱相乘累加后逆变换，得到 B 个输出。
+ * The kernel h is cut into P = ceil(taps/B) partitions of length B, each
+ * pre-transformed to a 2B-point spectrum. Every full input block of B samples
+ * is transformed once, stored in a frequency-domain delay line (FDL),
+ * multiplied-accumulated against the partition spectra and transformed back
+ * to produce B outputs.
+ *
+ * 每样本代价 O(log B + taps/B)，输出延迟不超过 B-1 个样本。
+ * Per-sample cost is O(log B + taps/B); output latency is at most B-1 samples.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+#include "fft.h"
+
+/** 默认块长上限（决定最大延迟）。Default block-length cap (bounds latency). */
+#define SEQ_FIR_MAX_BLOCK 4096
+
+/** 默认块长下限。Default minimum block length. */
+#define SEQ_FIR_MIN_BLOCK 16
+
+/**
+ * @brief FIR 滤波状态。FIR filter state.
+ */
+struct seq_fir
+{
+    size_t taps;  /**< 抽头数。Number of taps. */
+    size_t block; /**< 块长 B。Block length B. */
+    size_t parts; /**< 分区数 P。Number of partitions P. */
+    size_t nbin;  /**< 每个频谱的频点数 B+1。Bins per spectrum, B+1. */
+
+    fft_plan_t plan;  /**< 2B 点实 FFT 计划。2B-point real FFT plan. */
+    fft_cpx_t *kspec; /**< P×nbin 分区核频谱。Partition kernel spectra. */
+    fft_cpx_t *fdl;   /**< P×nbin 频域延迟线。Frequency-domain delay line. */
+    size_t fdl_head;  /**< 最新输入频谱所在槽。Slot of the newest input spectrum. */
+    fft_cpx_t *acc;   /**< nbin 频域累加器。Spectral accumulator. */
+    fft_cpx_t *work;  /**< 2B 复数工作区。FFT scratch. */
+
+    double *inbuf;  /**< 2B 时域输入 [上一块 | 当前块]。Input [previous | current]. */
+    size_t in_fill; /**< 当前块已有样本数。Samples in the current block. */
+    double *tbuf;   /**< 2B 时域工作区。Time-domain scratch. */
+
+    double *outbuf;   /**< 已计算、待取走的输出。Computed outputs awaiting pop. */
+    size_t out_pos;   /**< 输出读位置。Read position. */
+    size_t out_count; /**< 输出队列长度。Number of queued outputs. */
+};
+
+typedef struct seq_fir seq_fir_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化 FIR 状态。Initialize FIR state.
+     *
+     * @param f [out] 状态。State.
+     * @param taps [in] 冲激响应。Impulse response.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @param block [in] 块长；0 表示按抽头数自动选择 2 的幂。Block length; 0 picks a power of two from ntaps.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_fir_init(seq_fir_t *f, const double *taps, size_t ntaps, size_t block);
+
+    /**
+     * @brief 释放 FIR 状态。Free FIR state.
+     *
+     * @param f [in,out] 状态，可为 NULL。State, may be NULL.
+     */
+    void seq_fir_dispose(seq_fir_t *f);
+
+    /**
+     * @brief 推入一个输入样本；块满时计算 B 个输出。Push one sample; a full block computes B outputs.
+     *
+     * @param f [in,out] 状态。State.
+     * @param x [in] 输入样本。Input sample.
+     * @return SEQ_OK 或错误码（输出队列未取空时为 SEQ_ERR_STATE）。
+     *         SEQ_OK or error code (SEQ_ERR_STATE if queued outputs were not drained).
+     */
+    seq_err_t seq_fir_push(seq_fir_t *f, double x);
+
+    /**
+     * @brief 取出一个已计算的输出。Pop one computed output.
+     *
+     * @param f [in,out] 状态。State.
+     * @param y [out] 输出样本。Output sample.
+     * @return 1 表示 y 有效；0 表示暂无输出。1 if y is valid, 0 if no output is pending.
+     */
+    int seq_fir_pop(seq_fir_t *f, double *y);
+
+    /**
+     * @brief 块处理：推入 n 个样本并取出所有已就绪输出。Block processing: push n samples, pop all ready outputs.
+     *
+     * @param f [in,out] 状态。State.
+     * @param in [in] 输入样本，可在 n==0 时为 NULL。Input samples, may be NULL when n==0.
+     * @param n [in] 输入个数。Number of inputs.
+     * @param out [out] 输出缓冲，容量至少 n + 2·block - 1。Output buffer, capacity >= n + 2·block - 1.
+     * @param n_out [out] 实际输出个数。Number of outputs written.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_fir_process(seq_fir_t *f, const double *in, size_t n, double *out, size_t *n_out);
+
+    /**
+     * @brief 输入结束：以零补齐残余块并只输出与输入等量的样本。
+     *        End of input: zero-pad the partial block and queue only as many outputs as inputs.
+     *
+     * @param f [in,out] 状态。State.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_fir_finish(seq_fir_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIR_H */
@@ -0,0 +1,813 @@
+#include "multichan.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void mc_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[multichan] error: %s\n", msg);
+}
+
+/**
+ * @brief 第 n 帧、第 c 通道的下标。Index of frame n, channel c.
+ *
+ * @param m [in] 序列；平面布局按 m->length 跨通道。Sequence; planar layout strides channels by m->length.
+ * @param n [in] 帧。Frame.
+ * @param c [in] 通道。Channel.
+ * @return 在 m->data 中的下标。Index into m->data.
+ */
+static size_t mc_index(const seq_mc_t *m, size_t n, size_t c)
+{
+    return (m->layout == SEQ_MC_INTERLEAVED) ? n * m->channels + c : c * m->length + n;
+}
+
+/**
+ * @brief 拷贝连续若干帧。Copy a run of frames.
+ *
+ * @param in [in] 源（与 out 同布局）。Source, same layout as out.
+ * @param src [in] 源起始帧。First source frame.
+ * @param out [in,out] 目标。Destination.
+ * @param dst [in] 目标起始帧。First destination frame.
+ * @param n [in] 帧数。Number of frames.
+ */
+static void mc_copy_frames(const seq_mc_t *in, size_t src, seq_mc_t *out, size_t dst, size_t n)
+{
+    size_t c = 0;
+
+    if (n == 0)
+    {
+        return;
+    }
+    if (in->layout == SEQ_MC_INTERLEAVED)
+    {
+        memcpy(out->data + dst * out->channels, in->data + src * in->channels,
+               n * in->channels * sizeof(double));
+        return;
+    }
+    while (c < in->channels)
+    {
+        memcpy(out->data + c * out->length + dst, in->data + c * in->length + src, n * sizeof(double));
+        c++;
+    }
+}
+
+/**
+ * @brief 以同一值填充连续若干帧。Fill a run of frames with one value.
+ *
+ * @param out [in,out] 目标。Destination.
+ * @param dst [in] 起始帧。First frame.
+ * @param n [in] 帧数。Number of frames.
+ * @param v [in] 值。Value.
+ */
+static void mc_fill_frames(seq_mc_t *out, size_t dst, size_t n, double v)
+{
+    size_t c = 0;
+
+    while (c < out->channels)
+    {
+        size_t i = 0;
+        while (i < n)
+        {
+            out->data[mc_index(out, dst + i, c)] = v;
+            i++;
+        }
+        c++;
+    }
+}
+
+seq_err_t seq_mc_alloc(seq_mc_t *m, size_t length, size_t channels, seq_mc_layout_t layout)
+{
+    if (!m || channels == 0)
+    {
+        mc_log_error("seq_mc_alloc: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    m->data = NULL;
+    m->length = length;
+    m->channels = channels;
+    m->layout = layout;
+    if (length == 0)
+    {
+        return SEQ_OK;
+    }
+    if (length > SIZE_MAX / sizeof(double) / channels)
+    {
+        mc_log_error("seq_mc_alloc: size overflow");
+        return SEQ_ERR_ARG;
+    }
+    m->data = (double *)calloc(length * channels, sizeof(double));
+    if (!m->data)
+    {
+        mc_log_error("seq_mc_alloc: out of memory");
+        return SEQ_ERR_NOMEM;
+    }
+    return SEQ_OK;
+}
+
+void seq_mc_free(seq_mc_t *m)
+{
+    if (!m)
+    {
+        return;
+    }
+    free(m->data);
+    m->data = NULL;
+    m->length = 0;
+}
+
+seq_err_t seq_mc_convert(const seq_mc_t *src, seq_mc_t *dst)
+{
+    size_t c = 0;
+
+    if (!src || !dst || src->length != dst->length || src->channels != dst->channels ||
+        (src->length > 0 && (!src->data || !dst->data)))
+    {
+        mc_log_error("seq_mc_convert: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    if (src->layout == dst->layout)
+    {
+        if (dst->data != src->data)
+        {
+            mc_copy_frames(src, 0, dst, 0, src->length);
+        }
+        return SEQ_OK;
+    }
+
+    /* 转置：按目标顺序写，读端跨步。Transpose: write in destination order, stride on reads. */
+    while (c < src->channels)
+    {
+        size_t n = 0;
+        while (n < src->length)
+        {
+            dst->data[mc_index(dst, n, c)] = src->data[mc_index(src, n, c)];
+            n++;
+        }
+        c++;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 重置状态到初始值，但不假设其已被初始化。Reset state without assuming prior init.
+ *
+ * @param st [out] 状态。State.
+ * @param op [in] 操作类型。Operation type.
+ * @param channels [in] 通道数。Number of channels.
+ */
+static void mc_stream_reset(seq_mc_stream_t *st, seq_op_type op, size_t channels)
+{
+    memset(st, 0, sizeof(*st));
+    st->op = op;
+    st->channels = channels;
+}
+
+seq_err_t seq_mc_stream_init(seq_mc_stream_t *st,
+                             seq_op_type op,
+                             size_t channels,
+                             size_t param_main,
+                             double fill)
+{
+    if (!st || channels == 0)
+    {
+        mc_log_error("seq_mc_stream_init: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    mc_stream_reset(st, op, channels);
+    st->param_main = param_main;
+    st->fill = fill;
+
+    switch (op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        st->remaining = param_main;
+        break;
+
+    case SEQ_OP_PAD_BACK:
+    case SEQ_OP_ADVANCE:
+        break;
+
+    case SEQ_OP_UPSAMPLE:
+    case SEQ_OP_DOWNSAMPLE:
+        if (param_main == 0)
+        {
+            mc_log_error("seq_mc_stream_init: rate factor must be > 0");
+            return SEQ_ERR_ARG;
+        }
+        break;
+
+    case SEQ_OP_DELAY:
+        if (param_main > 0)
+        {
+            size_t i = 0;
+            if (param_main > SIZE_MAX / sizeof(double) / channels)
+            {
+                mc_log_error("seq_mc_stream_init: delay too large");
+                return SEQ_ERR_ARG;
+            }
+            st->ring = (double *)malloc(param_main * channels * sizeof(double));
+            if (!st->ring)
+            {
+                mc_log_error("seq_mc_stream_init: delay buffer oom");
+                return SEQ_ERR_NOMEM;
+            }
+            while (i < param_main * channels)
+            {
+                st->ring[i++] = fill;
+            }
+        }
+        break;
+
+    case SEQ_OP_DIFF:
+        st->last = (double *)calloc(channels, sizeof(double));
+        if (!st->last)
+        {
+            mc_log_error("seq_mc_stream_init: state oom");
+            return SEQ_ERR_NOMEM;
+        }
+        break;
+
+    case SEQ_OP_CUMSUM:
+        st->acc = (double *)calloc(channels, sizeof(double));
+        if (!st->acc)
+        {
+            mc_log_error("seq_mc_stream_init: state oom");
+            return SEQ_ERR_NOMEM;
+        }
+        break;
+
+    case SEQ_OP_FIR:
+    case SEQ_OP_RESAMPLE:
+    case SEQ_OP_SDFT:
+        mc_log_error("seq_mc_stream_init: kernel ops need seq_mc_stream_init_fir/_resample/_sdft");
+        return SEQ_ERR_ARG;
+
+    case SEQ_OP_REVERSE:
+    default:
+        mc_log_error("seq_mc_stream_init: unsupported op for streaming");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    st->active = 1;
+    return SEQ_OK;
+}
+
+/**
+ * @brief 逐通道状态初始化完成后分配批缓冲。Allocate batch buffers once the per-channel states exist.
+ *
+ * @param st [in,out] 状态，chan 已全部初始化。State with every chan initialized.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t mc_stream_init_batch(seq_mc_stream_t *st)
+{
+    st->batch_cap = seq_stream_output_bound(&st->chan[0], SEQ_MC_BATCH);
+    st->scratch = (double *)malloc((SEQ_MC_BATCH + st->batch_cap) * sizeof(double));
+    if (!st->scratch)
+    {
+        mc_log_error("mc_stream_init_batch: scratch oom");
+        return SEQ_ERR_NOMEM;
+    }
+    st->active = 1;
+    return SEQ_OK;
+}
+
+seq_err_t seq_mc_stream_init_fir(seq_mc_stream_t *st,
+                                 size_t channels,
+                                 const double *taps,
+                                 size_t ntaps,
+                                 size_t block)
+{
+    seq_err_t err = SEQ_OK;
+    size_t c = 0;
+
+    if (!st || channels == 0)
+    {
+        mc_log_error("seq_mc_stream_init_fir: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    mc_stream_reset(st, SEQ_OP_FIR, channels);
+    st->chan = (seq_stream_t *)calloc(channels, sizeof(seq_stream_t));
+    if (!st->chan)
+    {
+        mc_log_error("seq_mc_stream_init_fir: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    while (c < channels && err == SEQ_OK)
+    {
+        err = seq_stream_init_fir(&st->chan[c++], taps, ntaps, block);
+    }
+    if (err == SEQ_OK)
+    {
+        err = mc_stream_init_batch(st);
+    }
+    if (err != SEQ_OK)
+    {
+        seq_mc_stream_dispose(st);
+    }
+    return err;
+}
+
+seq_err_t seq_mc_stream_init_resample(seq_mc_stream_t *st,
+                                      size_t channels,
+                                      size_t up,
+                                      size_t down,
+                                      const double *taps,
+                                      size_t ntaps)
+{
+    seq_err_t err = SEQ_OK;
+    size_t c = 0;
+
+    if (!st || channels == 0)
+    {
+        mc_log_error("seq_mc_stream_init_resample: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    mc_stream_reset(st, SEQ_OP_RESAMPLE, channels);
+    st->chan = (seq_stream_t *)calloc(channels, sizeof(seq_stream_t));
+    if (!st->chan)
+    {
+        mc_log_error("seq_mc_stream_init_resample: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    while (c < channels && err == SEQ_OK)
+    {
+        err = seq_stream_init_resample(&st->chan[c++], up, down, taps, ntaps);
+    }
+    if (err == SEQ_OK)
+    {
+        err = mc_stream_init_batch(st);
+    }
+    if (err != SEQ_OK)
+    {
+        seq_mc_stream_dispose(st);
+    }
+    return err;
+}
+
+seq_err_t seq_mc_stream_init_sdft(seq_mc_stream_t *st,
+                                  size_t channels,
+                                  size_t n,
+                                  const size_t *bins,
+                                  size_t nbins)
+{
+    seq_err_t err = SEQ_OK;
+    size_t c = 0;
+
+    if (!st || channels == 0)
+    {
+        mc_log_error("seq_mc_stream_init_sdft: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    mc_stream_reset(st, SEQ_OP_SDFT, channels);
+    st->chan = (seq_stream_t *)calloc(channels, sizeof(seq_stream_t));
+    if (!st->chan)
+    {
+        mc_log_error("seq_mc_stream_init_sdft: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    while (c < channels && err == SEQ_OK)
+    {
+        err = seq_stream_init_sdft(&st->chan[c++], n, bins, nbins);
+    }
+    if (err == SEQ_OK)
+    {
+        err = mc_stream_init_batch(st);
+    }
+    if (err != SEQ_OK)
+    {
+        seq_mc_stream_dispose(st);
+    }
+    return err;
+}
+
+seq_err_t seq_mc_stream_finish(seq_mc_stream_t *st)
+{
+    size_t c = 0;
+
+    if (!st || !st->active)
+    {
+        mc_log_error("seq_mc_stream_finish: state not active");
+        return SEQ_ERR_STATE;
+    }
+    if (st->ended)
+    {
+        return SEQ_OK;
+    }
+    st->ended = 1;
+
+    if (st->op == SEQ_OP_ADVANCE)
+    {
+        st->remaining = st->counter;
+    }
+    else if (st->op == SEQ_OP_PAD_BACK)
+    {
+        st->remaining = st->param_main;
+    }
+    while (st->chan && c < st->channels)
+    {
+        seq_err_t err = seq_stream_finish(&st->chan[c++]);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+    }
+    return SEQ_OK;
+}
+
+size_t seq_mc_stream_output_bound(const seq_mc_stream_t *st, size_t frames_in)
+{
+    if (!st || !st->active)
+    {
+        return 0;
+    }
+
+    switch (st->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        return st->param_main + frames_in;
+    case SEQ_OP_UPSAMPLE:
+        return frames_in * st->param_main;
+    case SEQ_OP_DOWNSAMPLE:
+        return (frames_in + st->param_main - 1) / st->param_main;
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+        return frames_in + ((st->param_main < SEQ_STREAM_TAIL_BLOCK) ? st->param_main : SEQ_STREAM_TAIL_BLOCK);
+    case SEQ_OP_FIR:
+    case SEQ_OP_RESAMPLE:
+    case SEQ_OP_SDFT:
+        return seq_stream_output_bound(&st->chan[0], frames_in);
+    default:
+        return frames_in;
+    }
+}
+
+/**
+ * @brief 延迟：逐帧与环交换。Delay: swap each frame with the ring.
+ */
+static void mc_delay(seq_mc_stream_t *st, const seq_mc_t *in, seq_mc_t *out)
+{
+    const size_t ch = st->channels;
+    size_t n = 0;
+
+    while (n < in->length)
+    {
+        double *slot = st->ring + st->head * ch;
+        if (in->layout == SEQ_MC_INTERLEAVED)
+        {
+            memcpy(out->data + n * ch, slot, ch * sizeof(double));
+            memcpy(slot, in->data + n * ch, ch * sizeof(double));
+        }
+        else
+        {
+            size_t c = 0;
+            while (c < ch)
+            {
+                out->data[c * out->length + n] = slot[c];
+                slot[c] = in->data[c * in->length + n];
+                c++;
+            }
+        }
+        st->head++;
+        if (st->head >= st->param_main)
+        {
+            st->head = 0;
+        }
+        n++;
+    }
+}
+
+/**
+ * @brief 差分：交织布局内层沿通道，平面布局内层沿时间。Diff: inner loop across channels (interleaved) or time (planar).
+ */
+static void mc_diff(seq_mc_stream_t *st, const seq_mc_t *in, seq_mc_t *out)
+{
+    const size_t ch = st->channels;
+    const size_t len = in->length;
+    size_t c = 0;
+
+    if (len == 0)
+    {
+        return;
+    }
+    if (in->layout == SEQ_MC_INTERLEAVED)
+    {
+        const double *x = in->data;
+        double *y = out->data;
+        size_t i = ch;
+        while (c < ch)
+        {
+            y[c] = st->has_last ? (x[c] - st->last[c]) : x[c];
+            c++;
+        }
+        while (i < len * ch)
+        {
+            y[i] = x[i] - x[i - ch];
+            i++;
+        }
+        memcpy(st->last, x + (len - 1) * ch, ch * sizeof(double));
+    }
+    else
+    {
+        while (c < ch)
+        {
+            const double *x = in->data + c * in->length;
+            double *y = out->data + c * out->length;
+            size_t i = 1;
+            y[0] = st->has_last ? (x[0] - st->last[c]) : x[0];
+            while (i < len)
+            {
+                y[i] = x[i] - x[i - 1];
+                i++;
+            }
+            st->last[c] = x[len - 1];
+            c++;
+        }
+    }
+    st->has_last = 1;
+}
+
+/**
+ * @brief 前缀和：每通道顺序累加，与 seq_cumsum 逐位一致。Cumsum: sequential per channel, bit-identical to seq_cumsum.
+ */
+static void mc_cumsum(seq_mc_stream_t *st, const seq_mc_t *in, seq_mc_t *out)
+{
+    const size_t ch = st->channels;
+    size_t n = 0;
+    size_t c = 0;
+
+    if (in->layout == SEQ_MC_INTERLEAVED)
+    {
+        double *acc = st->acc;
+        while (n < in->length)
+        {
+            const double *x = in->data + n * ch;
+            double *y = out->data + n * ch;
+            c = 0;
+            while (c < ch)
+            {
+                acc[c] += x[c];
+                y[c] = acc[c];
+                c++;
+            }
+            n++;
+        }
+        return;
+    }
+    while (c < ch)
+    {
+        const double *x = in->data + c * in->length;
+        double *y = out->data + c * out->length;
+        double acc = st->acc[c];
+        n = 0;
+        while (n < in->length)
+        {
+            acc += x[n];
+            y[n] = acc;
+            n++;
+        }
+        st->acc[c] = acc;
+        c++;
+    }
+}
+
+/**
+ * @brief FIR/重采样/滑动 DFT：按批收集每个通道，交给该通道的单通道状态。
+ *        FIR/resampling/sliding DFT: gather each channel per batch and run its single-channel state.
+ *
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t mc_per_channel(seq_mc_stream_t *st, const seq_mc_t *in, seq_mc_t *out, size_t *frames_out)
+{
+    double *xs = st->scratch;
+    double *ys = st->scratch + SEQ_MC_BATCH;
+    size_t f0 = 0;
+    size_t o = 0;
+
+    do
+    {
+        size_t nb = in->length - f0;
+        size_t produced = 0;
+        size_t c = 0;
+
+        if (nb > SEQ_MC_BATCH)
+        {
+            nb = SEQ_MC_BATCH;
+        }
+        while (c < st->channels)
+        {
+            const double *x = xs;
+            size_t n_ch = 0;
+            size_t i = 0;
+            seq_err_t err;
+
+            if (in->layout == SEQ_MC_PLANAR && nb > 0)
+            {
+                x = in->data + c * in->length + f0;
+            }
+            else
+            {
+                while (i < nb)
+                {
+                    xs[i] = in->data[(f0 + i) * st->channels + c];
+                    i++;
+                }
+            }
+            err = seq_stream_process(&st->chan[c], x, nb, ys, st->batch_cap, &n_ch);
+            if (err != SEQ_OK)
+            {
+                return err;
+            }
+            if (c == 0)
+            {
+                produced = n_ch;
+            }
+            else if (n_ch != produced)
+            {
+                mc_log_error("mc_per_channel: channels out of step");
+                return SEQ_ERR_STATE;
+            }
+            i = 0;
+            while (i < n_ch)
+            {
+                out->data[mc_index(out, o + i, c)] = ys[i];
+                i++;
+            }
+            c++;
+        }
+        o += produced;
+        f0 += nb;
+    } while (f0 < in->length);
+
+    *frames_out = o;
+    return SEQ_OK;
+}
+
+seq_err_t seq_mc_stream_process(seq_mc_stream_t *st,
+                                const seq_mc_t *in,
+                                seq_mc_t *out,
+                                size_t *frames_out)
+{
+    size_t o = 0;
+
+    if (!st || !in || !out || !frames_out || (in->length > 0 && !in->data))
+    {
+        mc_log_error("seq_mc_stream_process: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    *frames_out = 0;
+    if (!st->active)
+    {
+        mc_log_error("seq_mc_stream_process: state not active");
+        return SEQ_ERR_STATE;
+    }
+    if (in->channels != st->channels || out->channels != st->channels || in->layout != out->layout)
+    {
+        mc_log_error("seq_mc_stream_process: channel count or layout mismatch");
+        return SEQ_ERR_ARG;
+    }
+    if (in->length > 0 && st->ended)
+    {
+        mc_log_error("seq_mc_stream_process: input after seq_mc_stream_finish");
+        return SEQ_ERR_STATE;
+    }
+    if (out->length < seq_mc_stream_output_bound(st, in->length) || (!out->data && out->length > 0))
+    {
+        mc_log_error("seq_mc_stream_process: output capacity too small");
+        return SEQ_ERR_ARG;
+    }
+    if (!out->data)
+    {
+        return SEQ_OK;
+    }
+
+    switch (st->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        mc_fill_frames(out, 0, st->remaining, 0.0);
+        o = st->remaining;
+        st->remaining = 0;
+        mc_copy_frames(in, 0, out, o, in->length);
+        o += in->length;
+        break;
+
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+    {
+        size_t skip = 0;
+        size_t tail = (st->remaining < SEQ_STREAM_TAIL_BLOCK) ? st->remaining : SEQ_STREAM_TAIL_BLOCK;
+
+        if (st->op == SEQ_OP_ADVANCE && st->counter < st->param_main)
+        {
+            skip = st->param_main - st->counter;
+            if (skip > in->length)
+            {
+                skip = in->length;
+            }
+            st->counter += skip;
+        }
+        mc_copy_frames(in, skip, out, 0, in->length - skip);
+        o = in->length - skip;
+        mc_fill_frames(out, o, tail, (st->op == SEQ_OP_ADVANCE) ? st->fill : 0.0);
+        st->remaining -= tail;
+        o += tail;
+        break;
+    }
+
+    case SEQ_OP_DELAY:
+        if (st->param_main == 0)
+        {
+            mc_copy_frames(in, 0, out, 0, in->length);
+        }
+        else
+        {
+            mc_delay(st, in, out);
+        }
+        o = in->length;
+        break;
+
+    case SEQ_OP_UPSAMPLE:
+    {
+        size_t n = 0;
+        o = in->length * st->param_main;
+        mc_fill_frames(out, 0, o, 0.0);
+        while (n < in->length)
+        {
+            size_t c = 0;
+            while (c < st->channels)
+            {
+                out->data[mc_index(out, n * st->param_main, c)] = in->data[mc_index(in, n, c)];
+                c++;
+            }
+            n++;
+        }
+        break;
+    }
+
+    case SEQ_OP_DOWNSAMPLE:
+    {
+        const size_t factor = st->param_main;
+        size_t i = (factor - st->counter % factor) % factor;
+        while (i < in->length)
+        {
+            mc_copy_frames(in, i, out, o++, 1);
+            i += factor;
+        }
+        st->counter = (st->counter + in->length) % factor;
+        break;
+    }
+
+    case SEQ_OP_DIFF:
+        mc_diff(st, in, out);
+        o = in->length;
+        break;
+
+    case SEQ_OP_CUMSUM:
+        mc_cumsum(st, in, out);
+        o = in->length;
+        break;
+
+    case SEQ_OP_FIR:
+    case SEQ_OP_RESAMPLE:
+    case SEQ_OP_SDFT:
+        return mc_per_channel(st, in, out, frames_out);
+
+    case SEQ_OP_REVERSE:
+    default:
+        mc_log_error("seq_mc_stream_process: unsupported op");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    *frames_out = o;
+    return SEQ_OK;
+}
+
+void seq_mc_stream_dispose(seq_mc_stream_t *st)
+{
+    size_t c = 0;
+
+    if (!st)
+    {
+        return;
+    }
+    while (st->chan && c < st->channels)
+    {
+        seq_stream_dispose(&st->chan[c++]);
+    }
+    free(st->chan);
+    free(st->scratch);
+    free(st->ring);
+    free(st->last);
+    free(st->acc);
+    mc_stream_reset(st, SEQ_OP_PAD_FRONT, 0);
+}
@@ -0,0 +1,241 @@
+#ifndef MULTICHAN_H
+#define MULTICHAN_H
+
+/**
+ * @file multichan.h
+ * @brief 多通道序列与批量流式处理。Multichannel sequences and batch streaming.
+ *
+ * 一个 seq_mc_stream_t 以同一参数同时处理 C 个通道，各通道状态按结构数组存放
+ * （每种状态一个长度 C 的数组），一次块调用处理全部通道。交织布局下内层循环沿通道，
+ * 平面布局下内层循环沿时间，两种情况内层访问都是连续的，便于编译器向量化。
+ * One seq_mc_stream_t runs C channels with the same parameters. Per-channel
+ * state is kept as a structure of arrays (one length-C array per state
+ * variable) and one block call covers every channel. With the interleaved
+ * layout the inner loop runs across channels, with the planar layout it runs
+ * along time; either way the inner accesses are contiguous and vectorize.
+ *
+ * 每个通道的结果与对该通道单独使用 seq_stream_process 完全一致。
+ * Each channel's result is identical to running seq_stream_process on that channel alone.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/** FIR/重采样/滑动 DFT 逐通道处理时每批的帧数。Frames per batch when FIR/resampling/sliding DFT runs per channel. */
+#define SEQ_MC_BATCH 256
+
+/**
+ * @brief 多通道数据布局。Multichannel data layout.
+ */
+typedef enum
+{
+    SEQ_MC_INTERLEAVED = 0, /**< 帧优先：data[n·C + c]。Frame-major: data[n·C + c]. */
+    SEQ_MC_PLANAR           /**< 通道优先：data[c·length + n]。Channel-major: data[c·length + n]. */
+} seq_mc_layout_t;
+
+/**
+ * @brief 多通道序列。Multichannel sequence.
+ *
+ * @note length 为帧数（每通道样本数）；data 共 length·channels 个 double。
+ *       length is the frame count (samples per channel); data holds length·channels doubles.
+ */
+typedef struct
+{
+    double *data;           /**< 数据指针。Pointer to data. */
+    size_t length;          /**< 帧数。Number of frames. */
+    size_t channels;        /**< 通道数 (>0)。Number of channels (>0). */
+    seq_mc_layout_t layout; /**< 数据布局。Data layout. */
+} seq_mc_t;
+
+/**
+ * @brief 多通道流式状态。Multichannel streaming state.
+ *
+ * @note 此结构应视为不透明，仅通过提供的 API 操作。Treat as opaque; use only via API.
+ */
+typedef struct
+{
+    int active;       /**< 状态是否已初始化。Whether state is initialized. */
+    int ended;        /**< 是否已调用 seq_mc_stream_finish。Whether input has been finished. */
+    seq_op_type op;   /**< 操作类型。Operation type. */
+    size_t channels;  /**< 通道数。Number of channels. */
+
+    size_t param_main; /**< 主参数，同 seq_stream_init。Main parameter, as in seq_stream_init. */
+    double fill;       /**< 边界填充值。Boundary fill value. */
+
+    size_t counter;   /**< 帧计数（各通道共用）。Frame counter, shared by all channels. */
+    size_t remaining; /**< 待输出的填充帧数。Pending fill frames. */
+    int has_last;     /**< last 是否有效。Whether last is valid. */
+
+    double *last; /**< 每通道上一个样本（差分）。Per-channel last sample (diff). */
+    double *acc;  /**< 每通道累加器（前缀和）。Per-channel accumulator (cumsum). */
+    double *ring; /**< 延迟环，param_main 帧，帧内交织。Delay ring of param_main interleaved frames. */
+    size_t head;  /**< 环的读写位置（帧）。Ring position in frames. */
+
+    seq_stream_t *chan; /**< FIR/重采样/滑动 DFT 的逐通道状态。Per-channel states for FIR/resampling/sliding DFT. */
+    double *scratch;    /**< 逐通道处理的批缓冲。Batch buffers for per-channel processing. */
+    size_t batch_cap;   /**< 每批输出容量（样本）。Per-batch output capacity in samples. */
+} seq_mc_stream_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 分配多通道序列。Allocate a multichannel sequence.
+     *
+     * @param m [out] 序列。Sequence.
+     * @param length [in] 帧数，可为 0。Number of frames, may be 0.
+     * @param channels [in] 通道数 (>0)。Number of channels (>0).
+     * @param layout [in] 数据布局。Data layout.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 数据初始化为 0。Data is zero-initialized.
+     */
+    seq_err_t seq_mc_alloc(seq_mc_t *m, size_t length, size_t channels, seq_mc_layout_t layout);
+
+    /**
+     * @brief 释放多通道序列。Free a multichannel sequence.
+     *
+     * @param m [in,out] 序列，可为 NULL。Sequence, may be NULL.
+     */
+    void seq_mc_free(seq_mc_t *m);
+
+    /**
+     * @brief 在两种布局之间转换。Convert between the two layouts.
+     *
+     * @param src [in] 源序列。Source sequence.
+     * @param dst [in,out] 已分配、帧数与通道数相同的目标，布局任意。
+     *                     Allocated destination with the same frames and channels, any layout.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_mc_convert(const seq_mc_t *src, seq_mc_t *dst);
+
+    /**
+     * @brief 初始化多通道流式状态。Initialize multichannel streaming state.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param op [in] 操作类型，FIR/RESAMPLE/SDFT 除外。Operation type, except FIR/RESAMPLE/SDFT.
+     * @param channels [in] 通道数 (>0)。Number of channels (>0).
+     * @param param_main [in] 主参数，同 seq_stream_init。Main parameter, as in seq_stream_init.
+     * @param fill [in] 边界填充值。Boundary fill value.
+     * @return SEQ_OK 或错误码；REVERSE 返回 SEQ_ERR_UNSUPPORTED。SEQ_OK or error code; SEQ_ERR_UNSUPPORTED for REVERSE.
+     */
+    seq_err_t seq_mc_stream_init(seq_mc_stream_t *st,
+                                 seq_op_type op,
+                                 size_t channels,
+                                 size_t param_main,
+                                 double fill);
+
+    /**
+     * @brief 初始化多通道 FIR 流式状态，各通道使用同一冲激响应。
+     *        Initialize multichannel streaming FIR, every channel with the same kernel.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param channels [in] 通道数 (>0)。Number of channels (>0).
+     * @param taps [in] 冲激响应。Impulse response.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @param block [in] 块长，同 seq_stream_init_fir。Block length, as in seq_stream_init_fir.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_mc_stream_init_fir(seq_mc_stream_t *st,
+                                     size_t channels,
+                                     const double *taps,
+                                     size_t ntaps,
+                                     size_t block);
+
+    /**
+     * @brief 初始化多通道多相重采样流式状态。Initialize multichannel streaming polyphase resampling.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param channels [in] 通道数 (>0)。Number of channels (>0).
+     * @param up [in] 上采样因子 L (>0)。Upsampling factor L (>0).
+     * @param down [in] 下采样因子 M (>0)。Downsampling factor M (>0).
+     * @param taps [in] 插值滤波器。Interpolation filter.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_mc_stream_init_resample(seq_mc_stream_t *st,
+                                          size_t channels,
+                                          size_t up,
+                                          size_t down,
+                                          const double *taps,
+                                          size_t ntaps);
+
+    /**
+     * @brief 初始化多通道滑动 DFT 流式状态。Initialize multichannel streaming sliding DFT.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param channels [in] 通道数 (>0)。Number of channels (>0).
+     * @param n [in] 窗口长度 N (>0)。Window length N (>0).
+     * @param bins [in] 频点序号，每个均 < N。Bin indices, each < N.
+     * @param nbins [in] 频点数 (>0)。Number of bins (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 每个输入帧产生 nbins 个输出帧，第 j 帧为各通道第 j 个频点的幅度。
+     *       Each input frame yields nbins output frames; frame j holds bin j of every channel.
+     */
+    seq_err_t seq_mc_stream_init_sdft(seq_mc_stream_t *st,
+                                      size_t channels,
+                                      size_t n,
+                                      const size_t *bins,
+                                      size_t nbins);
+
+    /**
+     * @brief 通知输入结束。Signal end of input.
+     *
+     * @param st [in,out] 状态。State.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 之后以 0 帧输入反复调用 seq_mc_stream_process，直到输出 0 帧。
+     *       Afterwards call seq_mc_stream_process with 0 input frames until it yields 0 frames.
+     */
+    seq_err_t seq_mc_stream_finish(seq_mc_stream_t *st);
+
+    /**
+     * @brief 块处理所需输出帧数的上界。Upper bound of output frames for block processing.
+     *
+     * @param st [in] 已初始化的状态。Initialized state.
+     * @param frames_in [in] 输入帧数。Number of input frames.
+     * @return 对任意状态都成立的输出帧数上界；st 无效时返回 0。
+     *         Output-frame bound valid in any state; 0 if st is invalid.
+     */
+    size_t seq_mc_stream_output_bound(const seq_mc_stream_t *st, size_t frames_in);
+
+    /**
+     * @brief 多通道块流式处理。Multichannel block streaming.
+     *
+     * @param st [in,out] 状态。State.
+     * @param in [in] 输入，通道数须与状态一致；length 为输入帧数，可为 0（data 可为 NULL）。
+     *                Input with the state's channel count; length is the input frame count, may be 0 (data may be NULL).
+     * @param out [in,out] 输出缓冲，布局与通道数须与 in 一致；length 为容量（帧），
+     *                     须 >= seq_mc_stream_output_bound(st, in->length)。
+     *                     Output buffer with in's layout and channel count; length is its capacity
+     *                     in frames and must be >= seq_mc_stream_output_bound(st, in->length).
+     * @param frames_out [out] 实际输出帧数。Output frames written.
+     * @return SEQ_OK 或错误码；容量不足时返回 SEQ_ERR_ARG 且不消费输入。
+     *         SEQ_OK or error code; SEQ_ERR_ARG without consuming input if capacity is short.
+     *
+     * @note 平面布局的输出中，通道 c 从 data + c·out->length 开始（按容量），前 frames_out 个有效。
+     *       in 与 out 不得重叠。
+     *       In planar output, channel c starts at data + c·out->length (by capacity) and its
+     *       first frames_out samples are valid. in and out must not overlap.
+     */
+    seq_err_t seq_mc_stream_process(seq_mc_stream_t *st,
+                                    const seq_mc_t *in,
+                                    seq_mc_t *out,
+                                    size_t *frames_out);
+
+    /**
+     * @brief 释放多通道流式状态。Free multichannel streaming state.
+     *
+     * @param st [in,out] 状态，可为 NULL。State, may be NULL.
+     */
+    void seq_mc_stream_dispose(seq_mc_stream_t *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MULTICHAN_H */
@@ -0,0 +1,297 @@
+/**
+ * @file ooc.c
+ * @brief 超出内存的分块离线处理实现。Out-of-core chunked offline processing implementation.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "ooc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void ooc_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[ooc] error: %s\n", msg);
+}
+
+/**
+ * @brief 定位到字节偏移（支持 2 GiB 以上）。Seek to a byte offset (beyond 2 GiB too).
+ *
+ * @param fp [in] 文件流。File stream.
+ * @param off [in] 偏移。Offset.
+ * @param whence [in] SEEK_SET 或 SEEK_END。SEEK_SET or SEEK_END.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int ooc_seek(FILE *fp, int64_t off, int whence)
+{
+#ifdef _WIN32
+    return _fseeki64(fp, off, whence);
+#else
+    return fseeko(fp, (off_t)off, whence);
+#endif
+}
+
+/**
+ * @brief 当前字节偏移。Current byte offset.
+ *
+ * @param fp [in] 文件流。File stream.
+ * @return 偏移；失败返回 -1。Offset, or -1 on failure.
+ */
+static int64_t ooc_tell(FILE *fp)
+{
+#ifdef _WIN32
+    return (int64_t)_ftelli64(fp);
+#else
+    return (int64_t)ftello(fp);
+#endif
+}
+
+/**
+ * @brief 以至多 chunk 个一批输出 n 个相同的值。Emit n copies of a value in batches of at most chunk.
+ *
+ * @param buf [in] 暂存区，容量 chunk。Scratch of chunk samples.
+ * @param chunk [in] 块大小。Chunk size.
+ * @param v [in] 值。Value.
+ * @param n [in] 个数。Count.
+ * @param sink [in] 输出回调。Output callback.
+ * @param ctx [in] 回调上下文。Callback context.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t ooc_emit_fill(double *buf, size_t chunk, double v, uint64_t n,
+                               seq_pipeline_sink_fn sink, void *ctx)
+{
+    size_t i = 0;
+    while (i < chunk)
+    {
+        buf[i++] = v;
+    }
+    while (n > 0)
+    {
+        size_t m = (n < chunk) ? (size_t)n : chunk;
+        seq_err_t err = sink(ctx, buf, m);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        n -= m;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 把输入剩余部分逐块转发。Forward the rest of the input chunk by chunk.
+ *
+ * @param in [in] 输入流。Input stream.
+ * @param fmt [in] 格式。Format.
+ * @param buf [in] 暂存区。Scratch.
+ * @param chunk [in] 块大小。Chunk size.
+ * @param sink [in] 输出回调。Output callback.
+ * @param ctx [in] 回调上下文。Callback context.
+ * @param total [out] 转发的样本数。Samples forwarded.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ */
+static seq_err_t ooc_copy(FILE *in, seq_fmt_t fmt, double *buf, size_t chunk,
+                          seq_pipeline_sink_fn sink, void *ctx, uint64_t *total)
+{
+    *total = 0;
+    for (;;)
+    {
+        size_t got = 0;
+        seq_err_t err = seq_io_read(in, fmt, buf, chunk, &got);
+        if (err == SEQ_OK && got > 0)
+        {
+            err = sink(ctx, buf, got);
+        }
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        *total += got;
+        if (got < chunk)
+        {
+            return SEQ_OK;
+        }
+    }
+}
+
+/**
+ * @brief 分块提前：丢弃前 advance 个样本，末尾补同样多的 fill。Chunked advance.
+ */
+static seq_err_t ooc_advance(FILE *in, seq_fmt_t fmt, size_t advance, double fill, double *buf,
+                             size_t chunk, seq_pipeline_sink_fn sink, void *ctx)
+{
+    uint64_t skipped = 0;
+    uint64_t kept = 0;
+    seq_err_t err;
+
+    /* 读取并丢弃，管道输入同样适用；N < advance 时只丢 N 个。
+     * Read and drop, which also works on pipes; only N are dropped if N < advance. */
+    while (skipped < advance)
+    {
+        size_t want = (advance - skipped < chunk) ? (size_t)(advance - skipped) : chunk;
+        size_t got = 0;
+        err = seq_io_read(in, fmt, buf, want, &got);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        skipped += got;
+        if (got < want)
+        {
+            break;
+        }
+    }
+
+    err = ooc_copy(in, fmt, buf, chunk, sink, ctx, &kept);
+    if (err != SEQ_OK)
+    {
+        return err;
+    }
+    return ooc_emit_fill(buf, chunk, fill, skipped, sink, ctx);
+}
+
+/**
+ * @brief 分块反转：从文件尾部向前逐块读取，块内反转后输出。Chunked reverse reading backwards from the end.
+ */
+static seq_err_t ooc_reverse(FILE *in, seq_fmt_t fmt, double *buf, size_t chunk,
+                             seq_pipeline_sink_fn sink, void *ctx)
+{
+    const size_t sz = seq_fmt_size(fmt);
+    int64_t start = ooc_tell(in);
+    int64_t end;
+
+    if (start < 0 || ooc_seek(in, 0, SEEK_END) != 0 || (end = ooc_tell(in)) < start)
+    {
+        ooc_log_error("reverse needs a seekable input file");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    if ((uint64_t)(end - start) % sz != 0)
+    {
+        ooc_log_error("input is not a whole number of samples");
+        return SEQ_ERR_ARG;
+    }
+
+    uint64_t pos = (uint64_t)(end - start) / sz;
+    while (pos > 0)
+    {
+        size_t m = (pos < chunk) ? (size_t)pos : chunk;
+        size_t got = 0;
+        seq_err_t err;
+
+        pos -= m;
+        if (ooc_seek(in, start + (int64_t)(pos * sz), SEEK_SET) != 0)
+        {
+            ooc_log_error("seek failed");
+            return SEQ_ERR_STATE;
+        }
+        err = seq_io_read(in, fmt, buf, m, &got);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        if (got != m)
+        {
+            ooc_log_error("short read while reversing");
+            return SEQ_ERR_STATE;
+        }
+
+        size_t i = 0;
+        size_t j = m - 1;
+        while (i < j)
+        {
+            double t = buf[i];
+            buf[i] = buf[j];
+            buf[j] = t;
+            i++;
+            j--;
+        }
+        err = sink(ctx, buf, m);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+    }
+    return SEQ_OK;
+}
+
+int seq_ooc_capable(seq_op_type op)
+{
+    switch (op)
+    {
+    case SEQ_OP_REVERSE:
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+seq_err_t seq_ooc_apply(seq_op_type op, FILE *in, seq_fmt_t fmt, size_t param_main, double fill,
+                        size_t chunk, seq_pipeline_sink_fn sink, void *ctx)
+{
+    double *buf;
+    seq_err_t err;
+    uint64_t total = 0;
+
+    if (!in || !sink || seq_fmt_size(fmt) == 0)
+    {
+        ooc_log_error("seq_ooc_apply: invalid argument (binary input required)");
+        return SEQ_ERR_ARG;
+    }
+    if (!seq_ooc_capable(op))
+    {
+        ooc_log_error("seq_ooc_apply: operation has no out-of-core form");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    if (chunk == 0)
+    {
+        chunk = SEQ_OOC_CHUNK_DEFAULT;
+    }
+
+    buf = (double *)malloc(chunk * sizeof(double));
+    if (!buf)
+    {
+        ooc_log_error("seq_ooc_apply: out of memory");
+        return SEQ_ERR_NOMEM;
+    }
+
+    switch (op)
+    {
+    case SEQ_OP_REVERSE:
+        err = ooc_reverse(in, fmt, buf, chunk, sink, ctx);
+        break;
+    case SEQ_OP_ADVANCE:
+        err = ooc_advance(in, fmt, param_main, fill, buf, chunk, sink, ctx);
+        break;
+    default: /* SEQ_OP_PAD_BACK */
+        err = ooc_copy(in, fmt, buf, chunk, sink, ctx, &total);
+        if (err == SEQ_OK)
+        {
+            err = ooc_emit_fill(buf, chunk, 0.0, param_main, sink, ctx);
+        }
+        break;
+    }
+
+    free(buf);
+    return err;
+}
@@ -0,0 +1,63 @@
+#ifndef OOC_H
+#define OOC_H
+
+/**
+ * @file ooc.h
+ * @brief 超出内存的分块离线处理。Out-of-core chunked offline processing.
+ *
+ * reverse、advance、pad-back 对有限序列不是因果的，无法走流式状态机，但也不需要整条序列常驻内存：
+ * 这里按固定块大小读二进制输入、经回调写出结果，内存占用与序列长度无关。
+ * reverse, advance and pad-back are not causal on finite sequences, so they
+ * cannot run as stream state machines, yet they never need the whole sequence
+ * in memory: binary input is read in fixed-size chunks and results go to a
+ * sink callback, so memory use does not depend on the sequence length.
+ */
+
+#include <stdio.h>
+
+#include "pipeline.h"
+#include "seqio.h"
+
+/** 默认块大小（样本数）。Default chunk size in samples. */
+#define SEQ_OOC_CHUNK_DEFAULT ((size_t)1 << 16)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 判断操作是否有分块离线实现。Check if an op has an out-of-core implementation.
+     *
+     * @param op [in] 操作类型。Operation type.
+     * @return 非 0 表示支持（REVERSE/ADVANCE/PAD_BACK）。Non-zero if supported (REVERSE/ADVANCE/PAD_BACK).
+     */
+    int seq_ooc_capable(seq_op_type op);
+
+    /**
+     * @brief 分块执行离线操作。Run an offline op chunk by chunk.
+     *
+     * @param op [in] SEQ_OP_REVERSE、SEQ_OP_ADVANCE 或 SEQ_OP_PAD_BACK。Operation.
+     * @param in [in] 二进制输入流，读到 EOF。Binary input stream, read up to EOF.
+     * @param fmt [in] 输入格式（非 SEQ_FMT_TEXT）。Input format (not SEQ_FMT_TEXT).
+     * @param param_main [in] 提前量或补零个数。Advance or number of zeros.
+     * @param fill [in] ADVANCE 的填充值。Fill value for ADVANCE.
+     * @param chunk [in] 块大小（样本数），0 表示 SEQ_OOC_CHUNK_DEFAULT。Chunk size in samples, 0 for the default.
+     * @param sink [in] 输出回调，每次至多 chunk 个样本。Output callback, at most chunk samples per call.
+     * @param ctx [in] 回调上下文。Callback context.
+     * @return SEQ_OK 或错误码；REVERSE 的输入不可定位时返回 SEQ_ERR_UNSUPPORTED。
+     *         SEQ_OK or error code; SEQ_ERR_UNSUPPORTED if REVERSE input is not seekable.
+     *
+     * @note 内存为 O(chunk)。REVERSE 从文件尾部向前逐块读取，要求输入为普通文件；
+     *       ADVANCE 与 PAD_BACK 只顺序读取，管道输入同样适用。
+     *       Memory is O(chunk). REVERSE reads chunks backwards from the end and
+     *       needs a regular file; ADVANCE and PAD_BACK only read forwards and work on pipes.
+     */
+    seq_err_t seq_ooc_apply(seq_op_type op, FILE *in, seq_fmt_t fmt, size_t param_main, double fill,
+                            size_t chunk, seq_pipeline_sink_fn sink, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OOC_H */
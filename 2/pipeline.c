@@ -0,0 +1,269 @@
+/**
+ * @file pipeline.c
+ * @brief 多级流式流水线实现。Multi-stage streaming pipeline implementation.
+ */
+
+#include "pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void pipeline_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[pipeline] error: %s\n", msg);
+}
+
+/**
+ * @brief 把一段样本送入第 i 级及其后各级。Feed samples into stage i and everything after it.
+ *
+ * @param pl [in,out] 流水线。Pipeline.
+ * @param i [in] 级序号；等于 nstages 时交给输出回调。Stage index; nstages means the sink.
+ * @param in [in] 输入样本。Input samples.
+ * @param n [in] 样本数；0 仅在冲刷时使用，反复调用该级直到不再有输出。
+ *              Number of samples; 0 is used only when flushing and calls the stage
+ *              repeatedly until it yields nothing.
+ * @return SEQ_OK 或错误码。SEQ_OK or error code.
+ *
+ * @note 第 i 级的输出缓冲只由第 i 级写入，下游按块消费完毕后才会被覆盖。
+ *       Stage i's buffer is written only by stage i and is fully consumed
+ *       downstream before it is overwritten.
+ */
+static seq_err_t pipeline_run(seq_pipeline_t *pl, size_t i, const double *in, size_t n)
+{
+    size_t off = 0;
+    size_t n_out = 0;
+
+    if (i == pl->nstages)
+    {
+        return (n > 0) ? pl->sink(pl->sink_ctx, in, n) : SEQ_OK;
+    }
+
+    do
+    {
+        size_t take = n - off;
+        seq_err_t err;
+
+        if (take > pl->chunk)
+        {
+            take = pl->chunk;
+        }
+        err = seq_stream_process(&pl->stages[i], in ? in + off : NULL, take,
+                                 pl->bufs[i], pl->caps[i], &n_out);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        if (n_out > 0)
+        {
+            err = pipeline_run(pl, i + 1, pl->bufs[i], n_out);
+            if (err != SEQ_OK)
+            {
+                return err;
+            }
+        }
+        off += take;
+    } while (off < n || (n == 0 && n_out > 0));
+
+    return SEQ_OK;
+}
+
+seq_err_t seq_pipeline_init(seq_pipeline_t *pl,
+                            seq_stream_t *stages,
+                            size_t nstages,
+                            size_t chunk,
+                            seq_pipeline_sink_fn sink,
+                            void *sink_ctx)
+{
+    size_t i = 0;
+
+    if (!pl)
+    {
+        pipeline_log_error("seq_pipeline_init: null pipeline");
+        return SEQ_ERR_ARG;
+    }
+    memset(pl, 0, sizeof(*pl));
+
+    if (!stages || nstages == 0 || !sink)
+    {
+        pipeline_log_error("seq_pipeline_init: need at least one stage and a sink");
+        return SEQ_ERR_ARG;
+    }
+    while (i < nstages)
+    {
+        if (!stages[i].active || stages[i].ended)
+        {
+            pipeline_log_error("seq_pipeline_init: every stage must be initialized and not finished");
+            return SEQ_ERR_STATE;
+        }
+        i++;
+    }
+
+    pl->chunk = (chunk > 0) ? chunk : SEQ_PIPELINE_CHUNK;
+    pl->stages = (seq_stream_t *)malloc(nstages * sizeof(seq_stream_t));
+    pl->bufs = (double **)calloc(nstages, sizeof(double *));
+    pl->caps = (size_t *)calloc(nstages, sizeof(size_t));
+    if (!pl->stages || !pl->bufs || !pl->caps)
+    {
+        pipeline_log_error("seq_pipeline_init: out of memory");
+        free(pl->stages);
+        free(pl->bufs);
+        free(pl->caps);
+        memset(pl, 0, sizeof(*pl));
+        return SEQ_ERR_NOMEM;
+    }
+
+    i = 0;
+    while (i < nstages)
+    {
+        /* 容量按单块上界分配；上界与状态无关。Capacity is the per-chunk bound, valid in any state. */
+        pl->caps[i] = seq_stream_output_bound(&stages[i], pl->chunk);
+        pl->bufs[i] = (double *)malloc((pl->caps[i] > 0 ? pl->caps[i] : 1) * sizeof(double));
+        if (!pl->bufs[i])
+        {
+            size_t k = 0;
+            pipeline_log_error("seq_pipeline_init: stage buffer oom");
+            while (k < i)
+            {
+                free(pl->bufs[k]);
+                k++;
+            }
+            free(pl->stages);
+            free(pl->bufs);
+            free(pl->caps);
+            memset(pl, 0, sizeof(*pl));
+            return SEQ_ERR_NOMEM;
+        }
+        i++;
+    }
+
+    /* 所有权转移：拷贝状态并清空调用者的副本。Move ownership: copy states and clear the caller's. */
+    memcpy(pl->stages, stages, nstages * sizeof(seq_stream_t));
+    memset(stages, 0, nstages * sizeof(seq_stream_t));
+    pl->nstages = nstages;
+    pl->sink = sink;
+    pl->sink_ctx = sink_ctx;
+    return SEQ_OK;
+}
+
+seq_err_t seq_pipeline_push(seq_pipeline_t *pl, const double *in, size_t n)
+{
+    if (!pl || !pl->stages || (n > 0 && !in))
+    {
+        pipeline_log_error("seq_pipeline_push: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    if (pl->ended)
+    {
+        pipeline_log_error("seq_pipeline_push: input after seq_pipeline_finish");
+        return SEQ_ERR_STATE;
+    }
+    if (n == 0)
+    {
+        return SEQ_OK;
+    }
+    return pipeline_run(pl, 0, in, n);
+}
+
+seq_err_t seq_pipeline_finish(seq_pipeline_t *pl)
+{
+    size_t i = 0;
+
+    if (!pl || !pl->stages)
+    {
+        pipeline_log_error("seq_pipeline_finish: invalid pipeline");
+        return SEQ_ERR_ARG;
+    }
+    if (pl->ended)
+    {
+        return SEQ_OK;
+    }
+    pl->ended = 1;
+
+    while (i < pl->nstages)
+    {
+        seq_err_t err = seq_stream_finish(&pl->stages[i]);
+        if (err == SEQ_OK)
+        {
+            /* 以 n_in=0 取出该级全部尾部。Drain the whole tail of the stage with n_in=0. */
+            err = pipeline_run(pl, i, NULL, 0);
+        }
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        i++;
+    }
+    return SEQ_OK;
+}
+
+size_t seq_pipeline_latency(const seq_pipeline_t *pl)
+{
+    double rate = 1.0; /* 第 i 级每个流水线输入对应的输入数。Stage-i inputs per pipeline input. */
+    double total = 0.0;
+    size_t i = 0;
+
+    if (!pl || !pl->stages)
+    {
+        return 0;
+    }
+
+    while (i < pl->nstages)
+    {
+        const seq_stream_t *st = &pl->stages[i];
+        total += (double)seq_stream_latency(st) / rate;
+
+        if (st->op == SEQ_OP_UPSAMPLE)
+        {
+            rate *= (double)st->param_main;
+        }
+        else if (st->op == SEQ_OP_DOWNSAMPLE)
+        {
+            rate /= (double)st->param_main;
+        }
+        else if (st->op == SEQ_OP_RESAMPLE)
+        {
+            rate = rate * (double)st->param_main / (double)st->param_aux;
+        }
+        else if (st->op == SEQ_OP_SDFT)
+        {
+            rate *= (double)st->param_aux;
+        }
+        i++;
+    }
+
+    /* 向上取整，容忍比值运算的舍入。Round up, tolerating rounding in the ratios. */
+    {
+        size_t whole = (size_t)total;
+        return (total - (double)whole > 1e-9) ? whole + 1 : whole;
+    }
+}
+
+void seq_pipeline_dispose(seq_pipeline_t *pl)
+{
+    size_t i = 0;
+
+    if (!pl)
+    {
+        return;
+    }
+    while (i < pl->nstages)
+    {
+        seq_stream_dispose(&pl->stages[i]);
+        free(pl->bufs[i]);
+        i++;
+    }
+    free(pl->stages);
+    free(pl->bufs);
+    free(pl->caps);
+    memset(pl, 0, sizeof(*pl));
+}
@@ -0,0 +1,127 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/**
+ * @file pipeline.h
+ * @brief 多级流式流水线（算子串联）。Multi-stage streaming pipeline (operator chaining).
+ *
+ * 流水线由若干已初始化的 seq_stream_t 级组成，第 i 级的输出直接作为第 i+1 级的输入。
+ * 每级拥有一块输出缓冲，输入按 chunk 个样本切块送入 seq_stream_process，
+ * 块的输出立即交给下一级，因此各级之间无需拷贝或文本格式化，且工作集保持在缓存大小内。
+ * A pipeline is a list of initialized seq_stream_t stages where the outputs of
+ * stage i feed stage i+1 directly. Each stage owns one output buffer; input is
+ * cut into chunks of `chunk` samples for seq_stream_process and every chunk's
+ * output is handed to the next stage at once, so no copies or text formatting
+ * happen between stages and the working set stays cache-sized.
+ *
+ * 结果与把各级逐个作用于整段输入完全一致。
+ * Results are identical to running each stage over the whole input in turn.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/** 默认切块大小（样本数）。Default chunk size in samples. */
+#define SEQ_PIPELINE_CHUNK 1024
+
+/**
+ * @brief 输出回调：接收最后一级的一块输出。Sink callback receiving one block of final-stage outputs.
+ *
+ * @param ctx [in] 用户上下文。User context.
+ * @param y [in] 输出样本。Output samples.
+ * @param n [in] 样本数 (>0)。Number of samples (>0).
+ * @return SEQ_OK 继续；其他值中止处理并原样返回。SEQ_OK to continue; anything else aborts and is returned.
+ */
+typedef seq_err_t (*seq_pipeline_sink_fn)(void *ctx, const double *y, size_t n);
+
+/**
+ * @brief 流水线状态。Pipeline state.
+ *
+ * @note 此结构应视为不透明，仅通过提供的 API 操作。Treat as opaque; use only via API.
+ */
+typedef struct
+{
+    seq_stream_t *stages; /**< 各级状态（归流水线所有）。Stage states, owned by the pipeline. */
+    size_t nstages;       /**< 级数。Number of stages. */
+    size_t chunk;         /**< 每次送入一级的最大样本数。Max samples fed to a stage per call. */
+
+    double **bufs; /**< 每级的输出缓冲。Per-stage output buffers. */
+    size_t *caps;  /**< 每级缓冲容量。Per-stage buffer capacities. */
+
+    seq_pipeline_sink_fn sink; /**< 输出回调。Sink callback. */
+    void *sink_ctx;            /**< 回调上下文。Sink context. */
+    int ended;                 /**< 是否已调用 seq_pipeline_finish。Whether input has been finished. */
+} seq_pipeline_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 以已初始化的流式级构造流水线。Build a pipeline from initialized streaming stages.
+     *
+     * @param pl [out] 流水线。Pipeline.
+     * @param stages [in] 已初始化的各级，按执行顺序排列。Initialized stages in execution order.
+     * @param nstages [in] 级数 (>0)。Number of stages (>0).
+     * @param chunk [in] 切块大小；0 表示 SEQ_PIPELINE_CHUNK。Chunk size; 0 selects SEQ_PIPELINE_CHUNK.
+     * @param sink [in] 输出回调。Sink callback.
+     * @param sink_ctx [in] 回调上下文。Sink context.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 成功时各级状态的所有权转移给流水线，调用者不得再 dispose；失败时所有权仍归调用者。
+     *       On success the stage states are moved into the pipeline and the caller must not
+     *       dispose them; on failure the caller keeps ownership.
+     */
+    seq_err_t seq_pipeline_init(seq_pipeline_t *pl,
+                                seq_stream_t *stages,
+                                size_t nstages,
+                                size_t chunk,
+                                seq_pipeline_sink_fn sink,
+                                void *sink_ctx);
+
+    /**
+     * @brief 推入一块输入，沿流水线传递到输出回调。Push a block of input through to the sink.
+     *
+     * @param pl [in,out] 流水线。Pipeline.
+     * @param in [in] 输入样本，n==0 时可为 NULL。Input samples, may be NULL when n==0.
+     * @param n [in] 输入个数，任意大小。Number of inputs, any size.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_pipeline_push(seq_pipeline_t *pl, const double *in, size_t n);
+
+    /**
+     * @brief 输入结束：依次结束各级并冲刷尾部输出。End of input: finish each stage in order and flush tails.
+     *
+     * @param pl [in,out] 流水线。Pipeline.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 第 i 级冲刷出的尾部先流过后续各级，再结束第 i+1 级。
+     *       The tail flushed from stage i runs through the later stages before stage i+1 is finished.
+     */
+    seq_err_t seq_pipeline_finish(seq_pipeline_t *pl);
+
+    /**
+     * @brief 流水线的总输出延迟。Total output latency of the pipeline.
+     *
+     * @param pl [in] 流水线。Pipeline.
+     * @return 各级 seq_stream_latency 按前面各级的速率换算为流水线输入样本后求和，向上取整；
+     *         pl 无效时返回 0。
+     *         Sum of each stage's seq_stream_latency converted to pipeline input
+     *         samples through the rates of the stages before it, rounded up; 0 if pl is invalid.
+     */
+    size_t seq_pipeline_latency(const seq_pipeline_t *pl);
+
+    /**
+     * @brief 释放流水线及其所有级。Free the pipeline and all its stages.
+     *
+     * @param pl [in,out] 流水线，可为 NULL。Pipeline, may be NULL.
+     */
+    void seq_pipeline_dispose(seq_pipeline_t *pl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,197 @@
+/**
+ * @file resample.c
+ * @brief 多相有理倍率重采样器实现。Polyphase rational-ratio resampler implementation.
+ */
+
+#include "resample.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void resample_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[resample] error: %s\n", msg);
+}
+
+/**
+ * @brief 写入一个输入，并计算它完成的所有输出。Store one input and compute every output it completes.
+ *
+ * @param r [in,out] 状态。State.
+ * @param x [in] 输入样本。Input sample.
+ * @param out [out] 输出，至多 qcap 个。Outputs, at most qcap.
+ * @return 输出个数。Number of outputs.
+ */
+static size_t resample_one(seq_resampler_t *r, double x, double *out)
+{
+    const size_t tpp = r->tpp;
+    const double *win;
+    size_t o = 0;
+
+    /* 镜像写入，使最近 tpp 个输入总是连续的（从旧到新）。
+     * Mirrored write so the latest tpp inputs are always contiguous, oldest first. */
+    r->hist[r->head] = x;
+    r->hist[r->head + tpp] = x;
+    r->head = (r->head + 1 == tpp) ? 0 : r->head + 1;
+    win = r->hist + r->head;
+
+    while (r->pos < r->up)
+    {
+        const double *e = r->phases + r->pos * tpp;
+        double acc = 0.0;
+        size_t s = 0;
+        while (s < tpp)
+        {
+            acc += e[s] * win[s];
+            s++;
+        }
+        out[o++] = acc;
+        r->pos += r->down;
+    }
+    r->pos -= r->up;
+    return o;
+}
+
+seq_err_t seq_resampler_init(seq_resampler_t *r, size_t up, size_t down,
+                             const double *taps, size_t ntaps)
+{
+    size_t p = 0;
+
+    if (!r)
+    {
+        resample_log_error("seq_resampler_init: null state");
+        return SEQ_ERR_ARG;
+    }
+    memset(r, 0, sizeof(*r));
+
+    if (up == 0 || down == 0)
+    {
+        resample_log_error("seq_resampler_init: factors must be > 0");
+        return SEQ_ERR_ARG;
+    }
+    if (!taps || ntaps == 0)
+    {
+        resample_log_error("seq_resampler_init: kernel must have at least one tap");
+        return SEQ_ERR_ARG;
+    }
+
+    r->up = up;
+    r->down = down;
+    r->tpp = (ntaps + up - 1) / up;
+    r->qcap = (up + down - 1) / down;
+
+    r->phases = (double *)calloc(up * r->tpp, sizeof(double));
+    r->hist = (double *)calloc(2 * r->tpp, sizeof(double));
+    r->qbuf = (double *)malloc(r->qcap * sizeof(double));
+    if (!r->phases || !r->hist || !r->qbuf)
+    {
+        resample_log_error("seq_resampler_init: out of memory");
+        seq_resampler_dispose(r);
+        return SEQ_ERR_NOMEM;
+    }
+
+    /* 相位 p 的第 t 个抽头 h[p + tL] 放在逆序位置 tpp-1-t，与从旧到新的历史对齐。
+     * Tap t of phase p, h[p + tL], goes to reversed slot tpp-1-t to line up with
+     * the oldest-first history. */
+    while (p < up)
+    {
+        size_t t = 0;
+        while (p + t * up < ntaps)
+        {
+            r->phases[p * r->tpp + (r->tpp - 1 - t)] = taps[p + t * up];
+            t++;
+        }
+        p++;
+    }
+    return SEQ_OK;
+}
+
+void seq_resampler_dispose(seq_resampler_t *r)
+{
+    if (!r)
+    {
+        return;
+    }
+    free(r->phases);
+    free(r->hist);
+    free(r->qbuf);
+    memset(r, 0, sizeof(*r));
+}
+
+seq_err_t seq_resampler_push(seq_resampler_t *r, double x)
+{
+    if (!r || !r->hist)
+    {
+        resample_log_error("seq_resampler_push: invalid state");
+        return SEQ_ERR_ARG;
+    }
+    if (r->out_count > 0)
+    {
+        resample_log_error("seq_resampler_push: outputs must be drained before the next input");
+        return SEQ_ERR_STATE;
+    }
+    r->out_count = resample_one(r, x, r->qbuf);
+    r->out_pos = 0;
+    return SEQ_OK;
+}
+
+int seq_resampler_pop(seq_resampler_t *r, double *y)
+{
+    if (!r || r->out_count == 0)
+    {
+        return 0;
+    }
+    if (y)
+    {
+        *y = r->qbuf[r->out_pos];
+    }
+    r->out_pos++;
+    r->out_count--;
+    return 1;
+}
+
+size_t seq_resampler_output_bound(const seq_resampler_t *r, size_t n)
+{
+    if (!r || !r->hist)
+    {
+        return 0;
+    }
+    return (n * r->up + r->down - 1) / r->down + r->qcap;
+}
+
+seq_err_t seq_resampler_process(seq_resampler_t *r, const double *in, size_t n,
+                                double *out, size_t *n_out)
+{
+    size_t i = 0;
+    size_t o = 0;
+
+    if (!r || !r->hist || !n_out || (n > 0 && !in) || !out)
+    {
+        resample_log_error("seq_resampler_process: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    /* 先取走此前残留的输出。Drain outputs left over from earlier calls. */
+    memcpy(out, r->qbuf + r->out_pos, r->out_count * sizeof(double));
+    o = r->out_count;
+    r->out_pos = 0;
+    r->out_count = 0;
+
+    while (i < n)
+    {
+        o += resample_one(r, in[i], out + o);
+        i++;
+    }
+
+    *n_out = o;
+    return SEQ_OK;
+}
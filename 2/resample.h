@@ -0,0 +1,127 @@
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+/**
+ * @file resample.h
+ * @brief 多相有理倍率重采样器。Polyphase rational-ratio resampler.
+ *
+ * 计算 y = downsample_M(h * upsample_L(x))，结果与流式串联 upsample → FIR → downsample 相同
+ * （离线 seq_downsample 截断到 floor(N·L/M)，只与前 floor(N·L/M) 个相同），
+ * 但不计算与插入零相乘的乘积，也不计算被丢弃的输出：
+ * 核 h 被拆成 L 个相位子滤波器 E_p[t] = h[p + tL]，第 m 个输出只用一个相位，
+ * y[m] = sum_t E_p[t] x[floor(mM/L) - t]，其中 p = mM mod L。
+ * Computes y = downsample_M(h * upsample_L(x)), identical to the streaming
+ * chain upsample → FIR → downsample (offline seq_downsample truncates to
+ * floor(N·L/M), so only that many leading samples match), without forming
+ * products with the inserted zeros or computing discarded outputs: h is
+ * split into L phase sub-filters
+ * E_p[t] = h[p + tL] and output m uses a single phase,
+ * y[m] = sum_t E_p[t] x[floor(mM/L) - t] with p = mM mod L.
+ *
+ * 每个输出代价 ceil(taps/L) 次乘加，而串联方式为每个输出 M·taps 量级，约为 L·M 倍。
+ * Each output costs ceil(taps/L) multiply-adds, against roughly M·taps per
+ * output for the materialized chain, a factor of about L·M.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/**
+ * @brief 重采样状态。Resampler state.
+ */
+struct seq_resampler
+{
+    size_t up;   /**< 上采样因子 L。Upsampling factor L. */
+    size_t down; /**< 下采样因子 M。Downsampling factor M. */
+    size_t tpp;  /**< 每相抽头数 ceil(taps/L)。Taps per phase, ceil(taps/L). */
+
+    double *phases; /**< L×tpp 逆序相位子滤波器。Phase sub-filters, stored reversed. */
+    double *hist;   /**< 2·tpp 镜像输入历史。Mirrored input history of 2·tpp samples. */
+    size_t head;    /**< 下一个写入位置。Next write index. */
+    size_t pos;     /**< 下一个输出在上采样域中相对当前输入的位置。Next output offset in the upsampled domain. */
+
+    double *qbuf;     /**< 单个输入产生的待取输出。Outputs of one input awaiting pop. */
+    size_t qcap;      /**< 队列容量 ceil(L/M)。Queue capacity, ceil(L/M). */
+    size_t out_pos;   /**< 输出读位置。Read position. */
+    size_t out_count; /**< 输出队列长度。Number of queued outputs. */
+};
+
+typedef struct seq_resampler seq_resampler_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化重采样器。Initialize a resampler.
+     *
+     * @param r [out] 状态。State.
+     * @param up [in] 上采样因子 L (>0)。Upsampling factor L (>0).
+     * @param down [in] 下采样因子 M (>0)。Downsampling factor M (>0).
+     * @param taps [in] 工作在 L 倍速率上的插值滤波器。Interpolation filter running at L times the input rate.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_resampler_init(seq_resampler_t *r, size_t up, size_t down,
+                                 const double *taps, size_t ntaps);
+
+    /**
+     * @brief 释放重采样器。Free a resampler.
+     *
+     * @param r [in,out] 状态，可为 NULL。State, may be NULL.
+     */
+    void seq_resampler_dispose(seq_resampler_t *r);
+
+    /**
+     * @brief 推入一个输入样本，计算其对应的 0 ~ ceil(L/M) 个输出。
+     *        Push one sample and compute the 0 to ceil(L/M) outputs it completes.
+     *
+     * @param r [in,out] 状态。State.
+     * @param x [in] 输入样本。Input sample.
+     * @return SEQ_OK 或错误码（输出队列未取空时为 SEQ_ERR_STATE）。
+     *         SEQ_OK or error code (SEQ_ERR_STATE if queued outputs were not drained).
+     */
+    seq_err_t seq_resampler_push(seq_resampler_t *r, double x);
+
+    /**
+     * @brief 取出一个已计算的输出。Pop one computed output.
+     *
+     * @param r [in,out] 状态。State.
+     * @param y [out] 输出样本。Output sample.
+     * @return 1 表示 y 有效；0 表示暂无输出。1 if y is valid, 0 if no output is pending.
+     */
+    int seq_resampler_pop(seq_resampler_t *r, double *y);
+
+    /**
+     * @brief n 个输入最多产生的输出个数（含队列残留）。Max outputs for n inputs, queued leftovers included.
+     *
+     * @param r [in] 状态。State.
+     * @param n [in] 输入个数。Number of inputs.
+     * @return ceil(n·L/M) + ceil(L/M)。
+     */
+    size_t seq_resampler_output_bound(const seq_resampler_t *r, size_t n);
+
+    /**
+     * @brief 块处理：推入 n 个样本并写出所有已就绪输出。Block processing: push n samples, write every ready output.
+     *
+     * @param r [in,out] 状态。State.
+     * @param in [in] 输入样本，可在 n==0 时为 NULL。Input samples, may be NULL when n==0.
+     * @param n [in] 输入个数。Number of inputs.
+     * @param out [out] 输出缓冲，容量至少 seq_resampler_output_bound(r, n)。
+     *                  Output buffer of at least seq_resampler_output_bound(r, n).
+     * @param n_out [out] 实际输出个数。Number of outputs written.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 有限输入 N 个样本共产生 ceil(N·L/M) 个输出，无尾部需冲刷。
+     *       N inputs yield exactly ceil(N·L/M) outputs; there is no tail to flush.
+     */
+    seq_err_t seq_resampler_process(seq_resampler_t *r, const double *in, size_t n,
+                                    double *out, size_t *n_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RESAMPLE_H */
@@ -0,0 +1,265 @@
+/**
+ * @file sdft.c
+ * @brief 滑动 DFT 实现。Sliding DFT implementation.
+ */
+
+#include "sdft.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define SDFT_PI 3.14159265358979323846
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void sdft_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[sdft] error: %s\n", msg);
+}
+
+/**
+ * @brief 从历史窗口直接重算各频点。Recompute every bin directly from the history window.
+ *
+ * @param s [in,out] 状态。State.
+ *
+ * @note 相位序号 k·m mod N 逐项递增，不做乘法与取模。
+ *       The phase index k·m mod N is advanced incrementally, without multiply or modulo.
+ */
+static void sdft_anchor(seq_sdft_t *s)
+{
+    const size_t n = s->n;
+    size_t b = 0;
+
+    while (b < s->nbins)
+    {
+        const size_t k = s->bins[b];
+        double re = 0.0;
+        double im = 0.0;
+        size_t idx = 0;
+        size_t pos = s->head;
+        size_t m = 0;
+
+        /* 从最旧样本（m = 0）开始。Start at the oldest sample (m = 0). */
+        while (m < n)
+        {
+            const double v = s->hist[pos];
+            re += v * s->cos_tab[idx];
+            im -= v * s->sin_tab[idx];
+            idx += k;
+            if (idx >= n)
+            {
+                idx -= n;
+            }
+            pos = (pos + 1 == n) ? 0 : pos + 1;
+            m++;
+        }
+        s->x_re[b] = re;
+        s->x_im[b] = im;
+        b++;
+    }
+}
+
+/**
+ * @brief 写入一个输入，更新各频点并写出其幅度。Store one input, update every bin and write its magnitude.
+ *
+ * @param s [in,out] 状态。State.
+ * @param x [in] 输入样本。Input sample.
+ * @param out [out] nbins 个幅度。The nbins magnitudes.
+ */
+static void sdft_one(seq_sdft_t *s, double x, double *out)
+{
+    const double delta = x - s->hist[s->head];
+    size_t b = 0;
+
+    s->hist[s->head] = x;
+    s->head = (s->head + 1 == s->n) ? 0 : s->head + 1;
+
+    while (b < s->nbins)
+    {
+        const double re = s->x_re[b] + delta;
+        const double im = s->x_im[b];
+        s->x_re[b] = re * s->w_re[b] - im * s->w_im[b];
+        s->x_im[b] = re * s->w_im[b] + im * s->w_re[b];
+        b++;
+    }
+
+    if (++s->since_anchor == SEQ_SDFT_ANCHOR_WINDOWS * s->n)
+    {
+        sdft_anchor(s);
+        s->since_anchor = 0;
+    }
+
+    b = 0;
+    while (b < s->nbins)
+    {
+        out[b] = sqrt(s->x_re[b] * s->x_re[b] + s->x_im[b] * s->x_im[b]);
+        b++;
+    }
+}
+
+seq_err_t seq_sdft_init(seq_sdft_t *s, size_t n, const size_t *bins, size_t nbins)
+{
+    size_t i = 0;
+
+    if (!s)
+    {
+        sdft_log_error("seq_sdft_init: null state");
+        return SEQ_ERR_ARG;
+    }
+    memset(s, 0, sizeof(*s));
+
+    if (n == 0)
+    {
+        sdft_log_error("seq_sdft_init: window length must be > 0");
+        return SEQ_ERR_ARG;
+    }
+    if (!bins || nbins == 0)
+    {
+        sdft_log_error("seq_sdft_init: at least one bin is required");
+        return SEQ_ERR_ARG;
+    }
+    while (i < nbins)
+    {
+        if (bins[i] >= n)
+        {
+            sdft_log_error("seq_sdft_init: bin index must be < window length");
+            return SEQ_ERR_ARG;
+        }
+        i++;
+    }
+
+    s->n = n;
+    s->nbins = nbins;
+    s->bins = (size_t *)malloc(nbins * sizeof(size_t));
+    s->w_re = (double *)malloc(nbins * sizeof(double));
+    s->w_im = (double *)malloc(nbins * sizeof(double));
+    s->x_re = (double *)calloc(nbins, sizeof(double));
+    s->x_im = (double *)calloc(nbins, sizeof(double));
+    s->cos_tab = (double *)malloc(n * sizeof(double));
+    s->sin_tab = (double *)malloc(n * sizeof(double));
+    s->hist = (double *)calloc(n, sizeof(double));
+    s->qbuf = (double *)malloc(nbins * sizeof(double));
+    if (!s->bins || !s->w_re || !s->w_im || !s->x_re || !s->x_im ||
+        !s->cos_tab || !s->sin_tab || !s->hist || !s->qbuf)
+    {
+        sdft_log_error("seq_sdft_init: out of memory");
+        seq_sdft_dispose(s);
+        return SEQ_ERR_NOMEM;
+    }
+
+    i = 0;
+    while (i < n)
+    {
+        const double ph = 2.0 * SDFT_PI * (double)i / (double)n;
+        s->cos_tab[i] = cos(ph);
+        s->sin_tab[i] = sin(ph);
+        i++;
+    }
+    memcpy(s->bins, bins, nbins * sizeof(size_t));
+    i = 0;
+    while (i < nbins)
+    {
+        s->w_re[i] = s->cos_tab[bins[i]];
+        s->w_im[i] = s->sin_tab[bins[i]];
+        i++;
+    }
+    return SEQ_OK;
+}
+
+void seq_sdft_dispose(seq_sdft_t *s)
+{
+    if (!s)
+    {
+        return;
+    }
+    free(s->bins);
+    free(s->w_re);
+    free(s->w_im);
+    free(s->x_re);
+    free(s->x_im);
+    free(s->cos_tab);
+    free(s->sin_tab);
+    free(s->hist);
+    free(s->qbuf);
+    memset(s, 0, sizeof(*s));
+}
+
+seq_err_t seq_sdft_push(seq_sdft_t *s, double x)
+{
+    if (!s || !s->hist)
+    {
+        sdft_log_error("seq_sdft_push: invalid state");
+        return SEQ_ERR_ARG;
+    }
+    if (s->out_count > 0)
+    {
+        sdft_log_error("seq_sdft_push: outputs must be drained before the next input");
+        return SEQ_ERR_STATE;
+    }
+    sdft_one(s, x, s->qbuf);
+    s->out_pos = 0;
+    s->out_count = s->nbins;
+    return SEQ_OK;
+}
+
+int seq_sdft_pop(seq_sdft_t *s, double *y)
+{
+    if (!s || s->out_count == 0)
+    {
+        return 0;
+    }
+    if (y)
+    {
+        *y = s->qbuf[s->out_pos];
+    }
+    s->out_pos++;
+    s->out_count--;
+    return 1;
+}
+
+size_t seq_sdft_output_bound(const seq_sdft_t *s, size_t n)
+{
+    if (!s || !s->hist)
+    {
+        return 0;
+    }
+    return (n + 1) * s->nbins;
+}
+
+seq_err_t seq_sdft_process(seq_sdft_t *s, const double *in, size_t n,
+                           double *out, size_t *n_out)
+{
+    size_t i = 0;
+    size_t o = 0;
+
+    if (!s || !s->hist || !n_out || (n > 0 && !in) || !out)
+    {
+        sdft_log_error("seq_sdft_process: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    /* 先取走此前残留的输出。Drain outputs left over from earlier calls. */
+    memcpy(out, s->qbuf + s->out_pos, s->out_count * sizeof(double));
+    o = s->out_count;
+    s->out_pos = 0;
+    s->out_count = 0;
+
+    while (i < n)
+    {
+        sdft_one(s, in[i], out + o);
+        o += s->nbins;
+        i++;
+    }
+
+    *n_out = o;
+    return SEQ_OK;
+}
@@ -0,0 +1,130 @@
+#ifndef SDFT_H
+#define SDFT_H
+
+/**
+ * @file sdft.h
+ * @brief 滑动 DFT：逐样本跟踪选定频点。Sliding DFT: per-sample tracking of selected bins.
+ *
+ * 对最近 N 个输入的窗口 X_k(n) = sum_m x(n-N+1+m) e^{-j2πkm/N}，
+ * 每个新样本按递推 X_k(n) = e^{j2πk/N} (X_k(n-1) + x(n) - x(n-N)) 更新，
+ * 每个频点每样本一次复数乘法，与 N 无关；开始前的历史视为零。
+ * For the window of the latest N inputs, X_k(n) = sum_m x(n-N+1+m) e^{-j2πkm/N},
+ * each new sample applies X_k(n) = e^{j2πk/N} (X_k(n-1) + x(n) - x(n-N)):
+ * one complex multiply per bin per sample, independent of N. History before
+ * the first sample counts as zeros.
+ *
+ * 递推的舍入误差会随时间累积，因此每 SEQ_SDFT_ANCHOR_WINDOWS·N 个样本
+ * 从历史窗口直接重算一次各频点（重新锚定），摊销后仍是每频点每样本 O(1)。
+ * Rounding errors of the recursion accumulate over time, so every
+ * SEQ_SDFT_ANCHOR_WINDOWS·N samples the bins are recomputed directly from the
+ * history window (re-anchored); amortized this is still O(1) per bin per sample.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/** 两次重新锚定之间的窗口数。Windows between two re-anchors. */
+#define SEQ_SDFT_ANCHOR_WINDOWS 16
+
+/**
+ * @brief 滑动 DFT 状态。Sliding DFT state.
+ */
+struct seq_sdft
+{
+    size_t n;     /**< 窗口长度 N。Window length N. */
+    size_t nbins; /**< 跟踪的频点数。Number of tracked bins. */
+    size_t *bins; /**< 频点序号 k (< N)。Bin indices k (< N). */
+
+    double *w_re; /**< 每频点旋转因子 e^{j2πk/N} 实部。Per-bin twiddle e^{j2πk/N}, real part. */
+    double *w_im; /**< 旋转因子虚部。Twiddle, imaginary part. */
+    double *x_re; /**< 当前 X_k 实部。Current X_k, real part. */
+    double *x_im; /**< 当前 X_k 虚部。Current X_k, imaginary part. */
+
+    double *cos_tab; /**< cos(2πm/N)，m < N，重新锚定用。cos(2πm/N) for m < N, for re-anchoring. */
+    double *sin_tab; /**< sin(2πm/N)，m < N。sin(2πm/N) for m < N. */
+
+    double *hist;        /**< 最近 N 个输入的环。Ring of the latest N inputs. */
+    size_t head;         /**< 最旧样本位置，即下一个写入位置。Oldest sample, i.e. next write index. */
+    size_t since_anchor; /**< 上次重新锚定后的样本数。Samples since the last re-anchor. */
+
+    double *qbuf;     /**< 单个输入产生的 nbins 个待取幅度。The nbins magnitudes of one input awaiting pop. */
+    size_t out_pos;   /**< 输出读位置。Read position. */
+    size_t out_count; /**< 输出队列长度。Number of queued outputs. */
+};
+
+typedef struct seq_sdft seq_sdft_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化滑动 DFT。Initialize a sliding DFT.
+     *
+     * @param s [out] 状态。State.
+     * @param n [in] 窗口长度 N (>0)。Window length N (>0).
+     * @param bins [in] 频点序号，每个均 < N，函数内部拷贝。Bin indices, each < N, copied internally.
+     * @param nbins [in] 频点数 (>0)。Number of bins (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_sdft_init(seq_sdft_t *s, size_t n, const size_t *bins, size_t nbins);
+
+    /**
+     * @brief 释放滑动 DFT。Free a sliding DFT.
+     *
+     * @param s [in,out] 状态，可为 NULL。State, may be NULL.
+     */
+    void seq_sdft_dispose(seq_sdft_t *s);
+
+    /**
+     * @brief 推入一个输入样本，计算各频点的幅度 |X_k|。Push one sample and compute the magnitude |X_k| of every bin.
+     *
+     * @param s [in,out] 状态。State.
+     * @param x [in] 输入样本。Input sample.
+     * @return SEQ_OK 或错误码（输出队列未取空时为 SEQ_ERR_STATE）。
+     *         SEQ_OK or error code (SEQ_ERR_STATE if queued outputs were not drained).
+     */
+    seq_err_t seq_sdft_push(seq_sdft_t *s, double x);
+
+    /**
+     * @brief 按 bins 顺序取出一个幅度。Pop one magnitude, in the order of bins.
+     *
+     * @param s [in,out] 状态。State.
+     * @param y [out] 输出样本。Output sample.
+     * @return 1 表示 y 有效；0 表示暂无输出。1 if y is valid, 0 if no output is pending.
+     */
+    int seq_sdft_pop(seq_sdft_t *s, double *y);
+
+    /**
+     * @brief n 个输入最多产生的输出个数（含队列残留）。Max outputs for n inputs, queued leftovers included.
+     *
+     * @param s [in] 状态。State.
+     * @param n [in] 输入个数。Number of inputs.
+     * @return (n + 1)·nbins。
+     */
+    size_t seq_sdft_output_bound(const seq_sdft_t *s, size_t n);
+
+    /**
+     * @brief 块处理：推入 n 个样本并写出所有幅度。Block processing: push n samples, write every magnitude.
+     *
+     * @param s [in,out] 状态。State.
+     * @param in [in] 输入样本，可在 n==0 时为 NULL。Input samples, may be NULL when n==0.
+     * @param n [in] 输入个数。Number of inputs.
+     * @param out [out] 输出缓冲，容量至少 seq_sdft_output_bound(s, n)。
+     *                  Output buffer of at least seq_sdft_output_bound(s, n).
+     * @param n_out [out] 实际输出个数。Number of outputs written.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 每个输入产生 nbins 个交织输出（一帧），无尾部需冲刷。
+     *       Each input yields one frame of nbins interleaved outputs; there is no tail.
+     */
+    seq_err_t seq_sdft_process(seq_sdft_t *s, const double *in, size_t n,
+                               double *out, size_t *n_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SDFT_H */
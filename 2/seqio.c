@@ -0,0 +1,471 @@
+/**
+ * @file seqio.c
+ * @brief 二进制与内存映射序列 I/O 实现。Binary and memory-mapped sequence I/O implementation.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "seqio.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/** 非 float64 格式转换时的分块样本数。Samples per chunk when converting non-float64 formats. */
+#define SEQIO_CHUNK 2048
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void seqio_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[seqio] error: %s\n", msg);
+}
+
+/**
+ * @brief 主机是否为小端。Whether the host is little-endian.
+ */
+static int seqio_host_le(void)
+{
+    const unsigned short one = 1;
+    return *(const unsigned char *)&one == 1;
+}
+
+/**
+ * @brief 按需把 n 字节就地反转为小端顺序。Reverse n bytes in place when the host is big-endian.
+ *
+ * @param p [in,out] 字节。Bytes.
+ * @param n [in] 字节数。Byte count.
+ */
+static void seqio_to_le(unsigned char *p, size_t n)
+{
+    size_t i = 0;
+    if (seqio_host_le())
+    {
+        return;
+    }
+    while (i < n / 2)
+    {
+        unsigned char t = p[i];
+        p[i] = p[n - 1 - i];
+        p[n - 1 - i] = t;
+        i++;
+    }
+}
+
+void seq_io_decode(const void *raw, seq_fmt_t fmt, double *dst, size_t n)
+{
+    const unsigned char *src = (const unsigned char *)raw;
+    size_t i = 0;
+    unsigned char b[8];
+
+    if (fmt == SEQ_FMT_F64 && seqio_host_le())
+    {
+        memcpy(dst, src, n * sizeof(double));
+        return;
+    }
+
+    while (i < n)
+    {
+        switch (fmt)
+        {
+        case SEQ_FMT_F64:
+        {
+            double v;
+            memcpy(b, src + 8 * i, 8);
+            seqio_to_le(b, 8);
+            memcpy(&v, b, 8);
+            dst[i] = v;
+            break;
+        }
+        case SEQ_FMT_F32:
+        {
+            float v;
+            memcpy(b, src + 4 * i, 4);
+            seqio_to_le(b, 4);
+            memcpy(&v, b, 4);
+            dst[i] = (double)v;
+            break;
+        }
+        case SEQ_FMT_S16:
+        default:
+        {
+            const unsigned char *q = src + 2 * i;
+            unsigned int u = (unsigned int)q[0] | ((unsigned int)q[1] << 8);
+            dst[i] = (double)((u >= 0x8000u) ? (int)u - 0x10000 : (int)u);
+            break;
+        }
+        }
+        i++;
+    }
+}
+
+void seq_io_encode(const double *src, seq_fmt_t fmt, void *raw, size_t n)
+{
+    unsigned char *dst = (unsigned char *)raw;
+    size_t i = 0;
+
+    while (i < n)
+    {
+        switch (fmt)
+        {
+        case SEQ_FMT_F64:
+            memcpy(dst + 8 * i, &src[i], 8);
+            seqio_to_le(dst + 8 * i, 8);
+            break;
+        case SEQ_FMT_F32:
+        {
+            float v = (float)src[i];
+            memcpy(dst + 4 * i, &v, 4);
+            seqio_to_le(dst + 4 * i, 4);
+            break;
+        }
+        case SEQ_FMT_S16:
+        default:
+        {
+            /* 四舍五入并饱和；NaN 写为 0。Round to nearest and saturate; NaN becomes 0. */
+            double x = src[i];
+            int v;
+            if (x != x)
+            {
+                v = 0;
+            }
+            else if (x >= 32767.0)
+            {
+                v = 32767;
+            }
+            else if (x <= -32768.0)
+            {
+                v = -32768;
+            }
+            else
+            {
+                v = (int)((x >= 0.0) ? x + 0.5 : x - 0.5);
+            }
+            dst[2 * i] = (unsigned char)((unsigned int)v & 0xFFu);
+            dst[2 * i + 1] = (unsigned char)(((unsigned int)v >> 8) & 0xFFu);
+            break;
+        }
+        }
+        i++;
+    }
+}
+
+seq_err_t seq_fmt_parse(const char *name, seq_fmt_t *fmt)
+{
+    if (!name || !fmt)
+    {
+        return SEQ_ERR_ARG;
+    }
+    if (strcmp(name, "text") == 0)
+    {
+        *fmt = SEQ_FMT_TEXT;
+    }
+    else if (strcmp(name, "f64") == 0)
+    {
+        *fmt = SEQ_FMT_F64;
+    }
+    else if (strcmp(name, "f32") == 0)
+    {
+        *fmt = SEQ_FMT_F32;
+    }
+    else if (strcmp(name, "s16") == 0)
+    {
+        *fmt = SEQ_FMT_S16;
+    }
+    else
+    {
+        return SEQ_ERR_ARG;
+    }
+    return SEQ_OK;
+}
+
+size_t seq_fmt_size(seq_fmt_t fmt)
+{
+    switch (fmt)
+    {
+    case SEQ_FMT_F64:
+        return 8;
+    case SEQ_FMT_F32:
+        return 4;
+    case SEQ_FMT_S16:
+        return 2;
+    case SEQ_FMT_TEXT:
+    default:
+        return 0;
+    }
+}
+
+void seq_io_binary_mode(FILE *fp)
+{
+#ifdef _WIN32
+    if (fp)
+    {
+        _setmode(_fileno(fp), _O_BINARY);
+    }
+#else
+    (void)fp;
+#endif
+}
+
+seq_err_t seq_io_read(FILE *fp, seq_fmt_t fmt, double *out, size_t cap, size_t *n)
+{
+    const size_t sz = seq_fmt_size(fmt);
+    size_t got = 0;
+
+    if (!fp || !out || !n || sz == 0)
+    {
+        seqio_log_error("seq_io_read: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    *n = 0;
+
+    if (fmt == SEQ_FMT_F64 && seqio_host_le())
+    {
+        /* 直接读入输出缓冲。Read straight into the output buffer. */
+        size_t bytes = fread(out, 1, cap * sizeof(double), fp);
+        if (bytes % sizeof(double) != 0)
+        {
+            seqio_log_error("seq_io_read: trailing partial sample in binary input");
+            return SEQ_ERR_ARG;
+        }
+        *n = bytes / sizeof(double);
+        return SEQ_OK;
+    }
+
+    while (got < cap)
+    {
+        unsigned char raw[SEQIO_CHUNK * 8];
+        size_t want = cap - got;
+        size_t bytes;
+        if (want > SEQIO_CHUNK)
+        {
+            want = SEQIO_CHUNK;
+        }
+        bytes = fread(raw, 1, want * sz, fp);
+        if (bytes % sz != 0)
+        {
+            seqio_log_error("seq_io_read: trailing partial sample in binary input");
+            return SEQ_ERR_ARG;
+        }
+        seq_io_decode(raw, fmt, out + got, bytes / sz);
+        got += bytes / sz;
+        if (bytes < want * sz)
+        {
+            break;
+        }
+    }
+    *n = got;
+    return SEQ_OK;
+}
+
+seq_err_t seq_io_write(FILE *fp, seq_fmt_t fmt, const double *v, size_t n)
+{
+    const size_t sz = seq_fmt_size(fmt);
+    size_t done = 0;
+
+    if (!fp || (n > 0 && !v) || sz == 0)
+    {
+        seqio_log_error("seq_io_write: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    if (fmt == SEQ_FMT_F64 && seqio_host_le())
+    {
+        if (fwrite(v, sizeof(double), n, fp) != n)
+        {
+            seqio_log_error("seq_io_write: short write");
+            return SEQ_ERR_STATE;
+        }
+        return SEQ_OK;
+    }
+
+    while (done < n)
+    {
+        unsigned char raw[SEQIO_CHUNK * 8];
+        size_t take = n - done;
+        if (take > SEQIO_CHUNK)
+        {
+            take = SEQIO_CHUNK;
+        }
+        seq_io_encode(v + done, fmt, raw, take);
+        if (fwrite(raw, sz, take, fp) != take)
+        {
+            seqio_log_error("seq_io_write: short write");
+            return SEQ_ERR_STATE;
+        }
+        done += take;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 尝试用 mmap 载入普通文件。Try to load a regular file with mmap.
+ *
+ * @param fp [in] 输入流。Input stream.
+ * @param fmt [in] 格式。Format.
+ * @param buf [out] 载入结果。Loaded result.
+ * @return SEQ_OK 已载入；SEQ_ERR_UNSUPPORTED 表示不可映射，应回退；其他为错误。
+ *         SEQ_OK if loaded; SEQ_ERR_UNSUPPORTED if unmappable and the caller should fall back;
+ *         anything else is an error.
+ */
+static seq_err_t seqio_load_mapped(FILE *fp, seq_fmt_t fmt, seq_io_buf_t *buf)
+{
+#ifdef _WIN32
+    (void)fp;
+    (void)fmt;
+    (void)buf;
+    return SEQ_ERR_UNSUPPORTED;
+#else
+    const size_t sz = seq_fmt_size(fmt);
+    struct stat sb;
+    long off;
+    size_t bytes;
+    unsigned char *base;
+
+    if (fstat(fileno(fp), &sb) != 0 || !S_ISREG(sb.st_mode))
+    {
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    off = ftell(fp);
+    if (off < 0 || (off_t)off > sb.st_size)
+    {
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    bytes = (size_t)(sb.st_size - off);
+    if (bytes % sz != 0)
+    {
+        seqio_log_error("seq_io_load: input is not a whole number of samples");
+        return SEQ_ERR_ARG;
+    }
+    if (bytes == 0)
+    {
+        return SEQ_OK;
+    }
+
+    base = (unsigned char *)mmap(NULL, (size_t)sb.st_size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE, fileno(fp), 0);
+    if (base == (unsigned char *)MAP_FAILED)
+    {
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    posix_madvise(base, (size_t)sb.st_size, POSIX_MADV_SEQUENTIAL);
+
+    if (fmt == SEQ_FMT_F64 && seqio_host_le() && off % sizeof(double) == 0)
+    {
+        /* 零拷贝：私有映射，写入只影响本进程副本。Zero-copy: private mapping, writes stay local. */
+        buf->seq.data = (double *)(base + off);
+        buf->seq.length = bytes / sz;
+        buf->map = base;
+        buf->map_len = (size_t)sb.st_size;
+        buf->zero_copy = 1;
+    }
+    else
+    {
+        seq_err_t err = seq_alloc(&buf->seq, bytes / sz);
+        if (err != SEQ_OK)
+        {
+            munmap(base, (size_t)sb.st_size);
+            return err;
+        }
+        seq_io_decode(base + off, fmt, buf->seq.data, bytes / sz);
+        munmap(base, (size_t)sb.st_size);
+    }
+    fseek(fp, 0, SEEK_END);
+    return SEQ_OK;
+#endif
+}
+
+seq_err_t seq_io_load(FILE *fp, seq_fmt_t fmt, seq_io_buf_t *buf)
+{
+    size_t cap = 0;
+    seq_err_t err;
+
+    if (!buf)
+    {
+        seqio_log_error("seq_io_load: null buffer");
+        return SEQ_ERR_ARG;
+    }
+    memset(buf, 0, sizeof(*buf));
+    if (!fp || seq_fmt_size(fmt) == 0)
+    {
+        seqio_log_error("seq_io_load: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+
+    err = seqio_load_mapped(fp, fmt, buf);
+    if (err != SEQ_ERR_UNSUPPORTED)
+    {
+        return err;
+    }
+
+    /* 回退：按容量加倍的大块读取。Fallback: large reads into a doubling buffer. */
+    cap = 1 << 16;
+    buf->seq.data = (double *)malloc(cap * sizeof(double));
+    if (!buf->seq.data)
+    {
+        seqio_log_error("seq_io_load: out of memory");
+        return SEQ_ERR_NOMEM;
+    }
+    for (;;)
+    {
+        size_t got = 0;
+        err = seq_io_read(fp, fmt, buf->seq.data + buf->seq.length, cap - buf->seq.length, &got);
+        if (err != SEQ_OK)
+        {
+            seq_io_release(buf);
+            return err;
+        }
+        buf->seq.length += got;
+        if (buf->seq.length < cap)
+        {
+            break;
+        }
+        {
+            double *grown = (double *)realloc(buf->seq.data, 2 * cap * sizeof(double));
+            if (!grown)
+            {
+                seqio_log_error("seq_io_load: out of memory");
+                seq_io_release(buf);
+                return SEQ_ERR_NOMEM;
+            }
+            buf->seq.data = grown;
+            cap *= 2;
+        }
+    }
+    return SEQ_OK;
+}
+
+void seq_io_release(seq_io_buf_t *buf)
+{
+    if (!buf)
+    {
+        return;
+    }
+#ifndef _WIN32
+    if (buf->zero_copy)
+    {
+        munmap(buf->map, buf->map_len);
+    }
+    else
+#endif
+    {
+        seq_free(&buf->seq);
+    }
+    memset(buf, 0, sizeof(*buf));
+}
@@ -0,0 +1,148 @@
+#ifndef SEQIO_H
+#define SEQIO_H
+
+/**
+ * @file seqio.h
+ * @brief 二进制与内存映射序列 I/O。Binary and memory-mapped sequence I/O.
+ *
+ * 支持原始小端 float64 / float32 / int16 样本（无文件头）。int16 样本按整数值读写，
+ * 不做归一化；写出时四舍五入并饱和到 [-32768, 32767]。
+ * Raw little-endian float64 / float32 / int16 samples without a header.
+ * int16 samples are taken at their integer value with no normalization;
+ * on output they are rounded to nearest and saturated to [-32768, 32767].
+ *
+ * 有限输入为普通文件时使用 mmap 载入；float64 且主机为小端时 seq_t 直接指向映射（零拷贝）。
+ * When finite input is a regular file it is loaded with mmap, and for float64
+ * on a little-endian host the seq_t points straight into the mapping (zero-copy).
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "sequence.h"
+
+/**
+ * @brief 样本格式。Sample format.
+ */
+typedef enum
+{
+    SEQ_FMT_TEXT = 0, /**< 文本（现有格式）。Text (existing format). */
+    SEQ_FMT_F64,      /**< 小端 IEEE-754 双精度。Little-endian IEEE-754 double. */
+    SEQ_FMT_F32,      /**< 小端 IEEE-754 单精度。Little-endian IEEE-754 float. */
+    SEQ_FMT_S16       /**< 小端有符号 16 位整数。Little-endian signed 16-bit integer. */
+} seq_fmt_t;
+
+/**
+ * @brief 载入的有限序列及其底层存储。Loaded finite sequence with its backing storage.
+ *
+ * @note 必须用 seq_io_release 释放，不可对 seq 调用 seq_free。
+ *       Release with seq_io_release; never call seq_free on seq.
+ */
+typedef struct
+{
+    seq_t seq;      /**< 载入的序列。Loaded sequence. */
+    void *map;      /**< 映射基址；未映射时为 NULL。Mapping base, NULL if not mapped. */
+    size_t map_len; /**< 映射长度（字节）。Mapping length in bytes. */
+    int zero_copy;  /**< seq.data 是否直接指向映射。Whether seq.data points into the mapping. */
+} seq_io_buf_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 解析格式名 text/f64/f32/s16。Parse a format name: text/f64/f32/s16.
+     *
+     * @param name [in] 格式名。Format name.
+     * @param fmt [out] 格式。Format.
+     * @return SEQ_OK 或 SEQ_ERR_ARG。SEQ_OK or SEQ_ERR_ARG.
+     */
+    seq_err_t seq_fmt_parse(const char *name, seq_fmt_t *fmt);
+
+    /**
+     * @brief 每个样本的字节数；文本格式返回 0。Bytes per sample; 0 for text.
+     *
+     * @param fmt [in] 格式。Format.
+     * @return 字节数。Byte count.
+     */
+    size_t seq_fmt_size(seq_fmt_t fmt);
+
+    /**
+     * @brief 把流切换为二进制模式（仅 Windows 需要）。Switch a stream to binary mode (Windows only).
+     *
+     * @param fp [in] 文件流。File stream.
+     */
+    void seq_io_binary_mode(FILE *fp);
+
+    /**
+     * @brief 读入整个二进制输入直到 EOF。Load a whole binary input up to EOF.
+     *
+     * @param fp [in] 输入流。Input stream.
+     * @param fmt [in] 二进制格式（非 SEQ_FMT_TEXT）。Binary format (not SEQ_FMT_TEXT).
+     * @param buf [out] 载入结果。Loaded result.
+     * @return SEQ_OK 或错误码；字节数不是样本大小的整数倍时返回 SEQ_ERR_ARG。
+     *         SEQ_OK or error code; SEQ_ERR_ARG if the byte count is not a whole number of samples.
+     *
+     * @note 普通文件走 mmap，管道等不可映射的输入回退为大块 fread。
+     *       Regular files are mmap'ed; pipes and other unmappable inputs fall back to large freads.
+     */
+    seq_err_t seq_io_load(FILE *fp, seq_fmt_t fmt, seq_io_buf_t *buf);
+
+    /**
+     * @brief 释放 seq_io_load 的结果。Release the result of seq_io_load.
+     *
+     * @param buf [in,out] 载入结果，可为 NULL。Loaded result, may be NULL.
+     */
+    void seq_io_release(seq_io_buf_t *buf);
+
+    /**
+     * @brief 读取至多 cap 个二进制样本。Read up to cap binary samples.
+     *
+     * @param fp [in] 输入流。Input stream.
+     * @param fmt [in] 二进制格式。Binary format.
+     * @param out [out] 输出缓冲。Output buffer.
+     * @param cap [in] 缓冲容量。Buffer capacity.
+     * @param n [out] 读到的样本数；小于 cap 表示已到 EOF。Samples read; fewer than cap means EOF.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_io_read(FILE *fp, seq_fmt_t fmt, double *out, size_t cap, size_t *n);
+
+    /**
+     * @brief 以二进制格式写出 n 个样本。Write n samples in a binary format.
+     *
+     * @param fp [in] 输出流。Output stream.
+     * @param fmt [in] 二进制格式。Binary format.
+     * @param v [in] 样本。Samples.
+     * @param n [in] 样本数。Number of samples.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_io_write(FILE *fp, seq_fmt_t fmt, const double *v, size_t n);
+
+    /**
+     * @brief 把内存中的 n 个小端样本解码为 double（供套接字等非 FILE 输入使用）。
+     *        Decode n little-endian samples held in memory (for sockets and other non-FILE input).
+     *
+     * @param raw [in] 原始字节，n·seq_fmt_size(fmt) 个。Raw bytes, n·seq_fmt_size(fmt) of them.
+     * @param fmt [in] 二进制格式。Binary format.
+     * @param dst [out] 输出样本。Output samples.
+     * @param n [in] 样本数。Number of samples.
+     */
+    void seq_io_decode(const void *raw, seq_fmt_t fmt, double *dst, size_t n);
+
+    /**
+     * @brief 把 n 个 double 编码为内存中的小端样本（s16 四舍五入并饱和）。
+     *        Encode n doubles as little-endian samples in memory (s16 rounds and saturates).
+     *
+     * @param src [in] 样本。Samples.
+     * @param fmt [in] 二进制格式。Binary format.
+     * @param raw [out] 原始字节，n·seq_fmt_size(fmt) 个。Raw bytes, n·seq_fmt_size(fmt) of them.
+     * @param n [in] 样本数。Number of samples.
+     */
+    void seq_io_encode(const double *src, seq_fmt_t fmt, void *raw, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEQIO_H */
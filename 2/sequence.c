@@ -1,5 +1,10 @@
 #include "sequence.h"
+#include "fir.h"
+#include "resample.h"
+#include "sdft.h"
+#include "stats.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -76,6 +81,11 @@ static void seq_stream_reset(seq_stream_t *st)
     st->has_last = 0;
 
     st->acc = 0.0;
+
+    st->fir = NULL;
+    st->rs = NULL;
+    st->sdft = NULL;
+    st->ended = 0;
 }
 
 seq_err_t seq_alloc(seq_t *seq, size_t length)
@@ -93,6 +103,7 @@ seq_err_t seq_alloc(seq_t *seq, size_t length)
         return SEQ_OK;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq->data = (double *)calloc(length, sizeof(double));
     if (!seq->data)
     {
@@ -100,6 +111,7 @@ seq_err_t seq_alloc(seq_t *seq, size_t length)
         return SEQ_ERR_NOMEM;
     }
     seq->length = length;
+    SEQ_STATS_PHASE(SEQ_STATS_ALLOC, t0, length, length * sizeof(double));
     return SEQ_OK;
 }
 
@@ -154,6 +166,7 @@ seq_err_t seq_pad_front(const seq_t *src, size_t zeros, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     const size_t out_len = src->length + zeros;
     seq_err_t err = seq_prepare_output(dst, out_len);
     if (err != SEQ_OK)
@@ -171,6 +184,7 @@ seq_err_t seq_pad_front(const seq_t *src, size_t zeros, seq_t *dst)
     {
         dst->data[i++] = src->data[j++];
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_PAD_FRONT, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -182,6 +196,7 @@ seq_err_t seq_pad_back(const seq_t *src, size_t zeros, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     const size_t out_len = src->length + zeros;
     seq_err_t err = seq_prepare_output(dst, out_len);
     if (err != SEQ_OK)
@@ -200,6 +215,7 @@ seq_err_t seq_pad_back(const seq_t *src, size_t zeros, seq_t *dst)
         dst->data[i] = 0.0;
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_PAD_BACK, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -211,25 +227,28 @@ seq_err_t seq_delay(const seq_t *src, size_t delay, double fill, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq_err_t err = seq_prepare_output(dst, src->length);
     if (err != SEQ_OK)
     {
         return err;
     }
 
+    /* memmove 允许 dst == src：右移一次完成，无需第二块缓冲。
+     * memmove allows dst == src: one right shift, no second buffer. */
+    const size_t n = src->length;
+    const size_t head = delay < n ? delay : n;
+    if (head < n)
+    {
+        memmove(dst->data + head, src->data, (n - head) * sizeof(double));
+    }
     size_t i = 0;
-    while (i < src->length)
+    while (i < head)
     {
-        if (i < delay)
-        {
-            dst->data[i] = fill;
-        }
-        else
-        {
-            dst->data[i] = src->data[i - delay];
-        }
+        dst->data[i] = fill;
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_DELAY, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -241,26 +260,27 @@ seq_err_t seq_advance(const seq_t *src, size_t advance, double fill, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq_err_t err = seq_prepare_output(dst, src->length);
     if (err != SEQ_OK)
     {
         return err;
     }
 
-    size_t i = 0;
-    while (i < src->length)
+    /* memmove 允许 dst == src：左移一次完成。memmove allows dst == src: one left shift. */
+    const size_t n = src->length;
+    const size_t keep = advance < n ? n - advance : 0;
+    if (keep > 0)
     {
-        size_t idx = i + advance;
-        if (idx < src->length)
-        {
-            dst->data[i] = src->data[idx];
-        }
-        else
-        {
-            dst->data[i] = fill;
-        }
+        memmove(dst->data, src->data + advance, keep * sizeof(double));
+    }
+    size_t i = keep;
+    while (i < n)
+    {
+        dst->data[i] = fill;
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_ADVANCE, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -272,6 +292,7 @@ seq_err_t seq_reverse(const seq_t *src, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq_err_t err = seq_prepare_output(dst, src->length);
     if (err != SEQ_OK)
     {
@@ -280,11 +301,27 @@ seq_err_t seq_reverse(const seq_t *src, seq_t *dst)
 
     if (src->length == 0)
     {
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_REVERSE, t0, src->length, dst->length);
         return SEQ_OK;
     }
 
     size_t i = 0;
     size_t j = src->length - 1;
+    if (dst->data == src->data)
+    {
+        /* 原地：首尾对换，一趟完成。In place: swap from both ends in one pass. */
+        while (i < j)
+        {
+            double t = dst->data[i];
+            dst->data[i] = dst->data[j];
+            dst->data[j] = t;
+            i++;
+            j--;
+        }
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_REVERSE, t0, src->length, dst->length);
+        return SEQ_OK;
+    }
+
     while (i < src->length)
     {
         dst->data[i] = src->data[j];
@@ -295,6 +332,7 @@ seq_err_t seq_reverse(const seq_t *src, seq_t *dst)
         i++;
         j--;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_REVERSE, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -305,6 +343,8 @@ seq_err_t seq_upsample(const seq_t *src, size_t factor, seq_t *dst)
         seq_log_error("seq_upsample: null pointer");
         return SEQ_ERR_ARG;
     }
+
+    const uint64_t t0 = SEQ_STATS_START();
     if (factor == 0)
     {
         seq_log_error("seq_upsample: factor must be > 0");
@@ -331,6 +371,7 @@ seq_err_t seq_upsample(const seq_t *src, size_t factor, seq_t *dst)
         dst->data[i * factor] = src->data[i];
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_UPSAMPLE, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -341,6 +382,8 @@ seq_err_t seq_downsample(const seq_t *src, size_t factor, seq_t *dst)
         seq_log_error("seq_downsample: null pointer");
         return SEQ_ERR_ARG;
     }
+
+    const uint64_t t0 = SEQ_STATS_START();
     if (factor == 0)
     {
         seq_log_error("seq_downsample: factor must be > 0");
@@ -360,6 +403,7 @@ seq_err_t seq_downsample(const seq_t *src, size_t factor, seq_t *dst)
         dst->data[i] = src->data[i * factor];
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_DOWNSAMPLE, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -371,6 +415,7 @@ seq_err_t seq_diff(const seq_t *src, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq_err_t err = seq_prepare_output(dst, src->length);
     if (err != SEQ_OK)
     {
@@ -379,16 +424,23 @@ seq_err_t seq_diff(const seq_t *src, seq_t *dst)
 
     if (src->length == 0)
     {
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_DIFF, t0, src->length, dst->length);
         return SEQ_OK;
     }
 
-    dst->data[0] = src->data[0];
+    /* 先保存 x[n-1] 再写 y[n]，因此 dst == src 时同样正确。
+     * x[n-1] is kept before y[n] is written, so dst == src works too. */
+    double prev = src->data[0];
+    dst->data[0] = prev;
     size_t i = 1;
     while (i < src->length)
     {
-        dst->data[i] = src->data[i] - src->data[i - 1];
+        double cur = src->data[i];
+        dst->data[i] = cur - prev;
+        prev = cur;
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_DIFF, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
@@ -400,6 +452,7 @@ seq_err_t seq_cumsum(const seq_t *src, seq_t *dst)
         return SEQ_ERR_ARG;
     }
 
+    const uint64_t t0 = SEQ_STATS_START();
     seq_err_t err = seq_prepare_output(dst, src->length);
     if (err != SEQ_OK)
     {
@@ -414,9 +467,278 @@ seq_err_t seq_cumsum(const seq_t *src, seq_t *dst)
         dst->data[i] = acc;
         i++;
     }
+    SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_CUMSUM, t0, src->length, dst->length);
     return SEQ_OK;
 }
 
+seq_err_t seq_fir_filter(const seq_t *src, const double *taps, size_t ntaps, seq_t *dst)
+{
+    seq_fir_t fir;
+    seq_err_t err;
+    size_t i = 0;
+    size_t o = 0;
+
+    if (!src || !dst)
+    {
+        seq_log_error("seq_fir_filter: null pointer");
+        return SEQ_ERR_ARG;
+    }
+
+    const uint64_t t0 = SEQ_STATS_START();
+    err = seq_fir_init(&fir, taps, ntaps, 0);
+    if (err != SEQ_OK)
+    {
+        return err;
+    }
+
+    err = seq_prepare_output(dst, src->length);
+    if (err != SEQ_OK)
+    {
+        seq_fir_dispose(&fir);
+        return err;
+    }
+
+    while (i < src->length)
+    {
+        err = seq_fir_push(&fir, src->data[i]);
+        if (err != SEQ_OK)
+        {
+            break;
+        }
+        while (seq_fir_pop(&fir, &dst->data[o]))
+        {
+            o++;
+        }
+        i++;
+    }
+    if (err == SEQ_OK)
+    {
+        err = seq_fir_finish(&fir);
+    }
+    while (err == SEQ_OK && seq_fir_pop(&fir, &dst->data[o]))
+    {
+        o++;
+    }
+
+    seq_fir_dispose(&fir);
+    if (err == SEQ_OK)
+    {
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_FIR, t0, src->length, dst->length);
+    }
+    return err;
+}
+
+seq_err_t seq_resample(const seq_t *src, size_t up, size_t down,
+                       const double *taps, size_t ntaps, seq_t *dst)
+{
+    seq_resampler_t rs;
+    seq_err_t err;
+    size_t n_out = 0;
+
+    if (!src || !dst)
+    {
+        seq_log_error("seq_resample: null pointer");
+        return SEQ_ERR_ARG;
+    }
+
+    const uint64_t t0 = SEQ_STATS_START();
+    err = seq_resampler_init(&rs, up, down, taps, ntaps);
+    if (err != SEQ_OK)
+    {
+        return err;
+    }
+
+    /* N 个输入恰好产生 ceil(N·L/M) 个输出。N inputs yield exactly ceil(N·L/M) outputs. */
+    err = seq_prepare_output(dst, (src->length * up + down - 1) / down);
+    if (err == SEQ_OK && dst->length > 0)
+    {
+        err = seq_resampler_process(&rs, src->data, src->length, dst->data, &n_out);
+    }
+
+    seq_resampler_dispose(&rs);
+    if (err == SEQ_OK)
+    {
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_RESAMPLE, t0, src->length, dst->length);
+    }
+    return err;
+}
+
+seq_err_t seq_sliding_dft(const seq_t *src, size_t n, const size_t *bins, size_t nbins,
+                          seq_t *dst)
+{
+    seq_sdft_t sd;
+    seq_err_t err;
+    size_t n_out = 0;
+
+    if (!src || !dst)
+    {
+        seq_log_error("seq_sliding_dft: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (nbins > 0 && src->length > SIZE_MAX / nbins)
+    {
+        seq_log_error("seq_sliding_dft: length overflow");
+        return SEQ_ERR_ARG;
+    }
+
+    const uint64_t t0 = SEQ_STATS_START();
+    err = seq_sdft_init(&sd, n, bins, nbins);
+    if (err != SEQ_OK)
+    {
+        return err;
+    }
+
+    /* 每个输入恰好产生 nbins 个输出。Every input yields exactly nbins outputs. */
+    err = seq_prepare_output(dst, src->length * nbins);
+    if (err == SEQ_OK && dst->length > 0)
+    {
+        err = seq_sdft_process(&sd, src->data, src->length, dst->data, &n_out);
+    }
+
+    seq_sdft_dispose(&sd);
+    if (err == SEQ_OK)
+    {
+        SEQ_STATS_OP(SEQ_STATS_OFFLINE, SEQ_OP_SDFT, t0, src->length, dst->length);
+    }
+    return err;
+}
+
+seq_err_t seq_output_length(seq_op_type op, size_t n, size_t param_main, size_t *len)
+{
+    if (!len)
+    {
+        seq_log_error("seq_output_length: null len");
+        return SEQ_ERR_ARG;
+    }
+
+    switch (op)
+    {
+    case SEQ_OP_PAD_FRONT:
+    case SEQ_OP_PAD_BACK:
+        if (param_main > SIZE_MAX - n)
+        {
+            seq_log_error("seq_output_length: length overflow");
+            return SEQ_ERR_ARG;
+        }
+        *len = n + param_main;
+        return SEQ_OK;
+    case SEQ_OP_DELAY:
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_REVERSE:
+    case SEQ_OP_DIFF:
+    case SEQ_OP_CUMSUM:
+        *len = n;
+        return SEQ_OK;
+    case SEQ_OP_UPSAMPLE:
+        if (param_main == 0 || (n > 0 && param_main > SIZE_MAX / n))
+        {
+            seq_log_error("seq_output_length: invalid upsample factor");
+            return SEQ_ERR_ARG;
+        }
+        *len = n * param_main;
+        return SEQ_OK;
+    case SEQ_OP_DOWNSAMPLE:
+        if (param_main == 0)
+        {
+            seq_log_error("seq_output_length: invalid downsample factor");
+            return SEQ_ERR_ARG;
+        }
+        *len = n / param_main;
+        return SEQ_OK;
+    case SEQ_OP_FIR:
+    case SEQ_OP_RESAMPLE:
+    case SEQ_OP_SDFT:
+    default:
+        seq_log_error("seq_output_length: unsupported op");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+}
+
+seq_err_t seq_apply_into(seq_op_type op, const seq_t *src, size_t param_main, double fill,
+                         double *out, size_t cap, size_t *n_out)
+{
+    size_t len = 0;
+    seq_err_t err;
+
+    if (!src || !n_out || (!out && cap > 0))
+    {
+        seq_log_error("seq_apply_into: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    *n_out = 0;
+
+    err = seq_output_length(op, src->length, param_main, &len);
+    if (err != SEQ_OK)
+    {
+        return err;
+    }
+    if (len > cap)
+    {
+        seq_log_error("seq_apply_into: output capacity too small");
+        return SEQ_ERR_ARG;
+    }
+
+    /* 长度恰好匹配的视图让 seq_prepare_output 直接复用调用方内存。
+     * An exact-length view makes seq_prepare_output reuse the caller's memory as is. */
+    seq_t view;
+    view.data = len > 0 ? out : NULL;
+    view.length = len;
+
+    switch (op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        err = seq_pad_front(src, param_main, &view);
+        break;
+    case SEQ_OP_PAD_BACK:
+        err = seq_pad_back(src, param_main, &view);
+        break;
+    case SEQ_OP_DELAY:
+        err = seq_delay(src, param_main, fill, &view);
+        break;
+    case SEQ_OP_ADVANCE:
+        err = seq_advance(src, param_main, fill, &view);
+        break;
+    case SEQ_OP_REVERSE:
+        err = seq_reverse(src, &view);
+        break;
+    case SEQ_OP_UPSAMPLE:
+        err = seq_upsample(src, param_main, &view);
+        break;
+    case SEQ_OP_DOWNSAMPLE:
+        err = seq_downsample(src, param_main, &view);
+        break;
+    case SEQ_OP_DIFF:
+        err = seq_diff(src, &view);
+        break;
+    case SEQ_OP_CUMSUM:
+        err = seq_cumsum(src, &view);
+        break;
+    default:
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    if (err == SEQ_OK)
+    {
+        *n_out = len;
+    }
+    return err;
+}
+
+int seq_inplace_capable(seq_op_type op)
+{
+    switch (op)
+    {
+    case SEQ_OP_DELAY:
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_REVERSE:
+    case SEQ_OP_DIFF:
+    case SEQ_OP_CUMSUM:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 int seq_online_capable(seq_op_type op, int infinite_input)
 {
     if (infinite_input)
@@ -429,9 +751,12 @@ int seq_online_capable(seq_op_type op, int infinite_input)
         case SEQ_OP_DOWNSAMPLE:
         case SEQ_OP_DIFF:
         case SEQ_OP_CUMSUM:
+        case SEQ_OP_FIR:
+        case SEQ_OP_RESAMPLE:
+        case SEQ_OP_SDFT:
+        case SEQ_OP_ADVANCE:  /* k 个样本的前瞻延迟。k samples of lookahead latency. */
+        case SEQ_OP_PAD_BACK: /* 无限输入永不补零，即直通。Infinite input never pads: pass-through. */
             return 1;
-        case SEQ_OP_PAD_BACK:
-        case SEQ_OP_ADVANCE:
         case SEQ_OP_REVERSE:
         default:
             return 0;
@@ -451,6 +776,9 @@ int seq_online_capable(seq_op_type op, int infinite_input)
     case SEQ_OP_DOWNSAMPLE:
     case SEQ_OP_DIFF:
     case SEQ_OP_CUMSUM:
+    case SEQ_OP_FIR:
+    case SEQ_OP_RESAMPLE:
+    case SEQ_OP_SDFT:
         return 1;
     default:
         return 0;
@@ -541,8 +869,28 @@ seq_err_t seq_stream_init(seq_stream_t *st,
         st->active = 1;
         return SEQ_OK;
 
-    case SEQ_OP_PAD_BACK:
     case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+        /* counter 记已丢弃的输入，remaining 在结束时置为尾部长度。
+         * counter counts dropped inputs; remaining is set to the tail length at finish. */
+        st->param_main = param_main;
+        st->counter = 0;
+        st->remaining = 0;
+        st->active = 1;
+        return SEQ_OK;
+
+    case SEQ_OP_FIR:
+        seq_log_error("seq_stream_init: FIR needs a kernel, use seq_stream_init_fir");
+        return SEQ_ERR_ARG;
+
+    case SEQ_OP_RESAMPLE:
+        seq_log_error("seq_stream_init: resampling needs a kernel, use seq_stream_init_resample");
+        return SEQ_ERR_ARG;
+
+    case SEQ_OP_SDFT:
+        seq_log_error("seq_stream_init: sliding DFT needs bins, use seq_stream_init_sdft");
+        return SEQ_ERR_ARG;
+
     case SEQ_OP_REVERSE:
     default:
         seq_log_error("seq_stream_init: unsupported op for streaming");
@@ -550,11 +898,157 @@ seq_err_t seq_stream_init(seq_stream_t *st,
     }
 }
 
-seq_err_t seq_stream_step(seq_stream_t *st,
-                          int has_input,
-                          double x,
-                          double *y,
-                          int *has_output)
+seq_err_t seq_stream_init_fir(seq_stream_t *st,
+                              const double *taps,
+                              size_t ntaps,
+                              size_t block)
+{
+    seq_err_t err;
+
+    if (!st)
+    {
+        seq_log_error("seq_stream_init_fir: null state");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_stream_reset(st);
+    st->op = SEQ_OP_FIR;
+
+    st->fir = (struct seq_fir *)malloc(sizeof(struct seq_fir));
+    if (!st->fir)
+    {
+        seq_log_error("seq_stream_init_fir: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    err = seq_fir_init(st->fir, taps, ntaps, block);
+    if (err != SEQ_OK)
+    {
+        free(st->fir);
+        st->fir = NULL;
+        return err;
+    }
+
+    st->param_main = ntaps;
+    st->param_aux = st->fir->block;
+    st->active = 1;
+    return SEQ_OK;
+}
+
+seq_err_t seq_stream_init_resample(seq_stream_t *st,
+                                   size_t up,
+                                   size_t down,
+                                   const double *taps,
+                                   size_t ntaps)
+{
+    seq_err_t err;
+
+    if (!st)
+    {
+        seq_log_error("seq_stream_init_resample: null state");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_stream_reset(st);
+    st->op = SEQ_OP_RESAMPLE;
+
+    st->rs = (struct seq_resampler *)malloc(sizeof(struct seq_resampler));
+    if (!st->rs)
+    {
+        seq_log_error("seq_stream_init_resample: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    err = seq_resampler_init(st->rs, up, down, taps, ntaps);
+    if (err != SEQ_OK)
+    {
+        free(st->rs);
+        st->rs = NULL;
+        return err;
+    }
+
+    st->param_main = up;
+    st->param_aux = down;
+    st->active = 1;
+    return SEQ_OK;
+}
+
+seq_err_t seq_stream_init_sdft(seq_stream_t *st,
+                               size_t n,
+                               const size_t *bins,
+                               size_t nbins)
+{
+    seq_err_t err;
+
+    if (!st)
+    {
+        seq_log_error("seq_stream_init_sdft: null state");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_stream_reset(st);
+    st->op = SEQ_OP_SDFT;
+
+    st->sdft = (struct seq_sdft *)malloc(sizeof(struct seq_sdft));
+    if (!st->sdft)
+    {
+        seq_log_error("seq_stream_init_sdft: state oom");
+        return SEQ_ERR_NOMEM;
+    }
+    err = seq_sdft_init(st->sdft, n, bins, nbins);
+    if (err != SEQ_OK)
+    {
+        free(st->sdft);
+        st->sdft = NULL;
+        return err;
+    }
+
+    st->param_main = n;
+    st->param_aux = nbins;
+    st->active = 1;
+    return SEQ_OK;
+}
+
+seq_err_t seq_stream_finish(seq_stream_t *st)
+{
+    if (!st)
+    {
+        seq_log_error("seq_stream_finish: null state");
+        return SEQ_ERR_ARG;
+    }
+    if (!st->active)
+    {
+        seq_log_error("seq_stream_finish: state not active");
+        return SEQ_ERR_STATE;
+    }
+    if (st->ended)
+    {
+        return SEQ_OK;
+    }
+    st->ended = 1;
+
+    if (st->op == SEQ_OP_FIR)
+    {
+        return seq_fir_finish(st->fir);
+    }
+    if (st->op == SEQ_OP_ADVANCE)
+    {
+        /* 丢了几个就补几个；N < k 时只补 N 个。As many fills as drops; only N if N < k. */
+        st->remaining = st->counter;
+    }
+    else if (st->op == SEQ_OP_PAD_BACK)
+    {
+        st->remaining = st->param_main;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief seq_stream_step 的实现，不含统计。seq_stream_step without the statistics.
+ */
+static seq_err_t seq_stream_step_impl(seq_stream_t *st,
+                                      int has_input,
+                                      double x,
+                                      double *y,
+                                      int *has_output)
 {
     if (!st || !has_output)
     {
@@ -569,6 +1063,12 @@ seq_err_t seq_stream_step(seq_stream_t *st,
 
     *has_output = 0;
 
+    if (has_input && st->ended)
+    {
+        seq_log_error("seq_stream_step: input after seq_stream_finish");
+        return SEQ_ERR_STATE;
+    }
+
     switch (st->op)
     {
     case SEQ_OP_PAD_FRONT:
@@ -710,8 +1210,70 @@ seq_err_t seq_stream_step(seq_stream_t *st,
         *has_output = 1;
         return SEQ_OK;
 
-    case SEQ_OP_PAD_BACK:
+    case SEQ_OP_FIR:
+        if (has_input)
+        {
+            seq_err_t err = seq_fir_push(st->fir, x);
+            if (err != SEQ_OK)
+            {
+                return err;
+            }
+        }
+        *has_output = seq_fir_pop(st->fir, y);
+        return SEQ_OK;
+
+    case SEQ_OP_RESAMPLE:
+        if (has_input)
+        {
+            seq_err_t err = seq_resampler_push(st->rs, x);
+            if (err != SEQ_OK)
+            {
+                return err;
+            }
+        }
+        *has_output = seq_resampler_pop(st->rs, y);
+        return SEQ_OK;
+
+    case SEQ_OP_SDFT:
+        if (has_input)
+        {
+            seq_err_t err = seq_sdft_push(st->sdft, x);
+            if (err != SEQ_OK)
+            {
+                return err;
+            }
+        }
+        *has_output = seq_sdft_pop(st->sdft, y);
+        return SEQ_OK;
+
     case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+        if (!has_input)
+        {
+            if (st->remaining > 0)
+            {
+                if (y)
+                {
+                    *y = (st->op == SEQ_OP_ADVANCE) ? st->fill : 0.0;
+                }
+                st->remaining--;
+                *has_output = 1;
+            }
+            return SEQ_OK;
+        }
+        if (st->op == SEQ_OP_ADVANCE && st->counter < st->param_main)
+        {
+            st->counter++;
+            return SEQ_OK;
+        }
+        if (!y)
+        {
+            return SEQ_ERR_ARG;
+        }
+        *y = x;
+        *has_output = 1;
+        return SEQ_OK;
+
     case SEQ_OP_REVERSE:
     default:
         seq_log_error("seq_stream_step: unsupported op");
@@ -719,6 +1281,324 @@ seq_err_t seq_stream_step(seq_stream_t *st,
     }
 }
 
+seq_err_t seq_stream_step(seq_stream_t *st,
+                          int has_input,
+                          double x,
+                          double *y,
+                          int *has_output)
+{
+    const uint64_t t0 = SEQ_STATS_START();
+    seq_err_t err = seq_stream_step_impl(st, has_input, x, y, has_output);
+    if (err == SEQ_OK)
+    {
+        SEQ_STATS_OP(SEQ_STATS_STEP, st->op, t0, has_input ? 1 : 0, *has_output ? 1 : 0);
+    }
+    return err;
+}
+
+size_t seq_stream_output_bound(const seq_stream_t *st, size_t n_in)
+{
+    if (!st || !st->active)
+    {
+        return 0;
+    }
+
+    switch (st->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        return st->param_main + n_in;
+    case SEQ_OP_UPSAMPLE:
+        return n_in * st->param_main + (st->param_main - 1);
+    case SEQ_OP_DOWNSAMPLE:
+        return (n_in + st->param_main - 1) / st->param_main;
+    case SEQ_OP_FIR:
+        return n_in + 2 * st->fir->block - 1;
+    case SEQ_OP_RESAMPLE:
+        return seq_resampler_output_bound(st->rs, n_in);
+    case SEQ_OP_SDFT:
+        return seq_sdft_output_bound(st->sdft, n_in);
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+        return n_in + ((st->param_main < SEQ_STREAM_TAIL_BLOCK) ? st->param_main : SEQ_STREAM_TAIL_BLOCK);
+    case SEQ_OP_DELAY:
+    case SEQ_OP_DIFF:
+    case SEQ_OP_CUMSUM:
+    default:
+        return n_in;
+    }
+}
+
+/**
+ * @brief 延迟的块处理：环形缓冲区整段拷贝。Block delay via whole-span ring-buffer copies.
+ *
+ * @param st [in,out] 状态（param_main > 0）。State (param_main > 0).
+ * @param in [in] 输入。Input.
+ * @param n [in] 输入个数。Number of inputs.
+ * @param out [out] 输出，n 个。Output, n samples.
+ */
+static void seq_stream_delay_block(seq_stream_t *st, const double *in, size_t n, double *out)
+{
+    const size_t d = st->buf_size;
+    const size_t tail = d - st->buf_head; /* 从 head 到缓冲末尾。From head to buffer end. */
+
+    if (n >= d)
+    {
+        /* 输出整个环（按时间顺序），再直通，最后用输入末尾 d 个样本重建环。
+         * Emit the whole ring in time order, pass the rest through, refill the ring. */
+        memcpy(out, st->buf + st->buf_head, tail * sizeof(double));
+        memcpy(out + tail, st->buf, st->buf_head * sizeof(double));
+        memcpy(out + d, in, (n - d) * sizeof(double));
+        memcpy(st->buf, in + (n - d), d * sizeof(double));
+        st->buf_head = 0;
+        return;
+    }
+
+    if (n <= tail)
+    {
+        memcpy(out, st->buf + st->buf_head, n * sizeof(double));
+        memcpy(st->buf + st->buf_head, in, n * sizeof(double));
+    }
+    else
+    {
+        memcpy(out, st->buf + st->buf_head, tail * sizeof(double));
+        memcpy(out + tail, st->buf, (n - tail) * sizeof(double));
+        memcpy(st->buf + st->buf_head, in, tail * sizeof(double));
+        memcpy(st->buf, in + tail, (n - tail) * sizeof(double));
+    }
+    st->buf_head = (st->buf_head + n) % d;
+}
+
+/**
+ * @brief seq_stream_process 的实现，不含统计。seq_stream_process without the statistics.
+ */
+static seq_err_t seq_stream_process_impl(seq_stream_t *st,
+                                         const double *in,
+                                         size_t n_in,
+                                         double *out,
+                                         size_t out_cap,
+                                         size_t *n_out)
+{
+    size_t o = 0;
+    size_t i = 0;
+
+    if (!st || !n_out || (n_in > 0 && !in))
+    {
+        seq_log_error("seq_stream_process: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    *n_out = 0;
+    if (!st->active)
+    {
+        seq_log_error("seq_stream_process: state not active");
+        return SEQ_ERR_STATE;
+    }
+    if (n_in > 0 && st->ended)
+    {
+        seq_log_error("seq_stream_process: input after seq_stream_finish");
+        return SEQ_ERR_STATE;
+    }
+    if (out_cap < seq_stream_output_bound(st, n_in) || (!out && out_cap > 0))
+    {
+        seq_log_error("seq_stream_process: output capacity too small");
+        return SEQ_ERR_ARG;
+    }
+    if (!out)
+    {
+        /* 上界为 0：无输入且无待输出。Bound is 0: nothing to consume or emit. */
+        return SEQ_OK;
+    }
+
+    switch (st->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        memset(out, 0, st->remaining * sizeof(double));
+        o = st->remaining;
+        st->remaining = 0;
+        if (n_in > 0)
+        {
+            memcpy(out + o, in, n_in * sizeof(double));
+        }
+        o += n_in;
+        break;
+
+    case SEQ_OP_DELAY:
+        if (n_in > 0 && st->param_main == 0)
+        {
+            memcpy(out, in, n_in * sizeof(double));
+        }
+        else if (n_in > 0)
+        {
+            seq_stream_delay_block(st, in, n_in, out);
+        }
+        o = n_in;
+        break;
+
+    case SEQ_OP_UPSAMPLE:
+    {
+        const size_t factor = st->param_main;
+        memset(out, 0, (st->remaining + n_in * factor) * sizeof(double));
+        o = st->remaining;
+        st->remaining = 0;
+        while (i < n_in)
+        {
+            out[o] = in[i];
+            o += factor;
+            i++;
+        }
+        break;
+    }
+
+    case SEQ_OP_DOWNSAMPLE:
+    {
+        const size_t factor = st->param_main;
+        /* 第一个满足 (counter + i) % factor == 0 的 i。First i with (counter + i) % factor == 0. */
+        i = (factor - st->counter % factor) % factor;
+        while (i < n_in)
+        {
+            out[o++] = in[i];
+            i += factor;
+        }
+        st->counter = (st->counter + n_in) % factor;
+        break;
+    }
+
+    case SEQ_OP_DIFF:
+        if (n_in == 0)
+        {
+            break;
+        }
+        out[0] = st->has_last ? (in[0] - st->last) : in[0];
+        i = 1;
+        while (i < n_in)
+        {
+            out[i] = in[i] - in[i - 1];
+            i++;
+        }
+        st->last = in[n_in - 1];
+        st->has_last = 1;
+        o = n_in;
+        break;
+
+    case SEQ_OP_CUMSUM:
+    {
+        /* 顺序累加，保证与 seq_cumsum 逐位一致。Sequential so results match seq_cumsum bit for bit. */
+        double acc = st->acc;
+        while (i < n_in)
+        {
+            acc += in[i];
+            out[i] = acc;
+            i++;
+        }
+        st->acc = acc;
+        o = n_in;
+        break;
+    }
+
+    case SEQ_OP_FIR:
+    {
+        seq_err_t err = seq_fir_process(st->fir, in, n_in, out, &o);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        break;
+    }
+
+    case SEQ_OP_RESAMPLE:
+    {
+        seq_err_t err = seq_resampler_process(st->rs, in, n_in, out, &o);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        break;
+    }
+
+    case SEQ_OP_SDFT:
+    {
+        seq_err_t err = seq_sdft_process(st->sdft, in, n_in, out, &o);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        break;
+    }
+
+    case SEQ_OP_ADVANCE:
+    case SEQ_OP_PAD_BACK:
+    {
+        size_t tail = (st->remaining < SEQ_STREAM_TAIL_BLOCK) ? st->remaining : SEQ_STREAM_TAIL_BLOCK;
+        const double v = (st->op == SEQ_OP_ADVANCE) ? st->fill : 0.0;
+
+        if (st->op == SEQ_OP_ADVANCE && st->counter < st->param_main)
+        {
+            i = st->param_main - st->counter;
+            if (i > n_in)
+            {
+                i = n_in;
+            }
+            st->counter += i;
+        }
+        if (i < n_in)
+        {
+            memcpy(out, in + i, (n_in - i) * sizeof(double));
+        }
+        o = n_in - i;
+
+        /* 尾部只在结束后出现，此时 n_in == 0。The tail appears only after finish, when n_in == 0. */
+        st->remaining -= tail;
+        while (tail > 0)
+        {
+            out[o++] = v;
+            tail--;
+        }
+        break;
+    }
+
+    case SEQ_OP_REVERSE:
+    default:
+        seq_log_error("seq_stream_process: unsupported op");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    *n_out = o;
+    return SEQ_OK;
+}
+
+seq_err_t seq_stream_process(seq_stream_t *st,
+                             const double *in,
+                             size_t n_in,
+                             double *out,
+                             size_t out_cap,
+                             size_t *n_out)
+{
+    const uint64_t t0 = SEQ_STATS_START();
+    seq_err_t err = seq_stream_process_impl(st, in, n_in, out, out_cap, n_out);
+    if (err == SEQ_OK)
+    {
+        SEQ_STATS_OP(SEQ_STATS_BLOCK, st->op, t0, n_in, *n_out);
+    }
+    return err;
+}
+
+size_t seq_stream_latency(const seq_stream_t *st)
+{
+    if (!st || !st->active)
+    {
+        return 0;
+    }
+
+    switch (st->op)
+    {
+    case SEQ_OP_ADVANCE:
+        return st->param_main;
+    case SEQ_OP_FIR:
+        return st->fir->block - 1;
+    default:
+        return 0;
+    }
+}
+
 void seq_stream_dispose(seq_stream_t *st)
 {
     if (!st)
@@ -727,6 +1607,25 @@ void seq_stream_dispose(seq_stream_t *st)
     }
     free(st->buf);
     st->buf = NULL;
+    if (st->fir)
+    {
+        seq_fir_dispose(st->fir);
+        free(st->fir);
+        st->fir = NULL;
+    }
+    if (st->rs)
+    {
+        seq_resampler_dispose(st->rs);
+        free(st->rs);
+        st->rs = NULL;
+    }
+    if (st->sdft)
+    {
+        seq_sdft_dispose(st->sdft);
+        free(st->sdft);
+        st->sdft = NULL;
+    }
+    st->ended = 0;
     st->buf_size = 0;
     st->buf_head = 0;
     st->active = 0;
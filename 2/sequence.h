@@ -28,9 +28,26 @@ typedef enum
     SEQ_OP_UPSAMPLE,      /**< 上采样。Upsample. */
     SEQ_OP_DOWNSAMPLE,    /**< 下采样。Downsample. */
     SEQ_OP_DIFF,          /**< 差分。Difference. */
-    SEQ_OP_CUMSUM         /**< 累加。Cumulative sum. */
+    SEQ_OP_CUMSUM,        /**< 累加。Cumulative sum. */
+    SEQ_OP_FIR,           /**< FIR 滤波（分区重叠保留）。FIR filter (partitioned overlap-save). */
+    SEQ_OP_RESAMPLE,      /**< 多相 L/M 重采样。Polyphase L/M resampling. */
+    SEQ_OP_SDFT           /**< 滑动 DFT 频点幅度。Sliding DFT bin magnitudes. */
 } seq_op_type;
 
+struct seq_fir;
+struct seq_resampler;
+struct seq_sdft;
+
+/**
+ * @brief 每次块调用最多写出的尾部样本数（ADVANCE 填充、PAD_BACK 补零）。
+ *        Max tail samples written per block call (ADVANCE fill, PAD_BACK zeros).
+ *
+ * @note 使输出上界与补零个数无关，尾部分多次以 n_in=0 取出。
+ *       Keeps the output bound independent of the padding length; the tail is
+ *       drained over several n_in=0 calls.
+ */
+#define SEQ_STREAM_TAIL_BLOCK ((size_t)4096)
+
 /**
  * @brief 离散序列结构体。Discrete-time sequence structure.
  *
@@ -67,6 +84,11 @@ typedef struct
     int has_last; /**< 是否已有上一个样本。Whether last is valid. */
 
     double acc; /**< 累加器，用于前缀和。Accumulator. */
+
+    struct seq_fir *fir;      /**< FIR 卷积状态，仅 SEQ_OP_FIR 使用。FIR state, SEQ_OP_FIR only. */
+    struct seq_resampler *rs; /**< 重采样状态，仅 SEQ_OP_RESAMPLE 使用。Resampler state, SEQ_OP_RESAMPLE only. */
+    struct seq_sdft *sdft;    /**< 滑动 DFT 状态，仅 SEQ_OP_SDFT 使用。Sliding DFT state, SEQ_OP_SDFT only. */
+    int ended;                /**< 是否已调用 seq_stream_finish。Whether input has been finished. */
 } seq_stream_t;
 
 #ifdef __cplusplus
@@ -125,7 +147,7 @@ extern "C"
      * @param src 输入序列。Input sequence.
      * @param delay 延迟样本数。Delay in samples.
      * @param fill 边界填充值。Boundary fill value.
-     * @param dst 输出序列。Output sequence.
+     * @param dst 输出序列，可与 src 相同（原地）。Output sequence, may be src (in place).
      */
     seq_err_t seq_delay(const seq_t *src, size_t delay, double fill, seq_t *dst);
 
@@ -135,7 +157,7 @@ extern "C"
      * @param src 输入序列。Input sequence.
      * @param advance 提前样本数。Advance in samples.
      * @param fill 边界填充值。Boundary fill value.
-     * @param dst 输出序列。Output sequence.
+     * @param dst 输出序列，可与 src 相同（原地）。Output sequence, may be src (in place).
      */
     seq_err_t seq_advance(const seq_t *src, size_t advance, double fill, seq_t *dst);
 
@@ -143,7 +165,7 @@ extern "C"
      * @brief 序列反转（离线）。Reverse sequence (offline).
      *
      * @param src 输入序列。Input sequence.
-     * @param dst 输出序列。Output sequence.
+     * @param dst 输出序列，可与 src 相同（原地首尾对换）。Output sequence, may be src (swapped in place).
      */
     seq_err_t seq_reverse(const seq_t *src, seq_t *dst);
 
@@ -169,7 +191,7 @@ extern "C"
      * @brief 差分（离线）：y[n] = x[n] - x[n-1]，x[-1] 视为 0。Difference (offline).
      *
      * @param src 输入序列。Input sequence.
-     * @param dst 输出序列。Output sequence.
+     * @param dst 输出序列，可与 src 相同（原地）。Output sequence, may be src (in place).
      */
     seq_err_t seq_diff(const seq_t *src, seq_t *dst);
 
@@ -177,10 +199,113 @@ extern "C"
      * @brief 累加（离线）：前缀和。Cumulative sum (offline).
      *
      * @param src 输入序列。Input sequence.
-     * @param dst 输出序列。Output sequence.
+     * @param dst 输出序列，可与 src 相同（原地）。Output sequence, may be src (in place).
      */
     seq_err_t seq_cumsum(const seq_t *src, seq_t *dst);
 
+    /**
+     * @brief FIR 滤波（离线）：y[n] = sum_k h[k] x[n-k]，输出与输入等长。FIR filter (offline).
+     *
+     * @param src 输入序列。Input sequence.
+     * @param taps 冲激响应 h。Impulse response h.
+     * @param ntaps 抽头数 (>0)。Number of taps (>0).
+     * @param dst 输出序列，长度同 src。Output sequence, same length as src.
+     *
+     * @note 结果等于线性卷积的前 N 个样本，内部使用与流式相同的分区 FFT 引擎。
+     *       Equals the first N samples of the linear convolution; uses the same
+     *       partitioned FFT engine as streaming mode.
+     */
+    seq_err_t seq_fir_filter(const seq_t *src, const double *taps, size_t ntaps, seq_t *dst);
+
+    /**
+     * @brief 多相重采样（离线）：y = downsample_M(h * upsample_L(x))。Polyphase resampling (offline).
+     *
+     * @param src [in] 输入序列。Input sequence.
+     * @param up [in] 上采样因子 L (>0)。Upsampling factor L (>0).
+     * @param down [in] 下采样因子 M (>0)。Downsampling factor M (>0).
+     * @param taps [in] L 倍速率上的插值滤波器 h。Interpolation filter h at L times the input rate.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @param dst [out] 输出序列，长度 ceil(N·L/M)。Output sequence of length ceil(N·L/M).
+     *
+     * @note 串联 seq_upsample → seq_fir_filter → seq_downsample 得到 floor(N·L/M) 个样本，
+     *       与本函数的前 floor(N·L/M) 个相同（舍入误差内）；M 不整除 N·L 时本函数多出最后一个样本
+     *       y[floor(N·L/M)]，即 seq_downsample 截断掉的那个相位。本函数不计算插入零的乘积与被丢弃的输出。
+     *       The cascade seq_upsample → seq_fir_filter → seq_downsample yields
+     *       floor(N·L/M) samples, equal (up to rounding) to the first
+     *       floor(N·L/M) of this function; when M does not divide N·L this
+     *       function has one more final sample, y[floor(N·L/M)], the phase
+     *       seq_downsample truncates. No products with inserted zeros or
+     *       discarded outputs are computed.
+     */
+    seq_err_t seq_resample(const seq_t *src, size_t up, size_t down,
+                           const double *taps, size_t ntaps, seq_t *dst);
+
+    /**
+     * @brief 滑动 DFT（离线）：每个样本输出选定频点在最近 n 个样本上的幅度。Sliding DFT (offline).
+     *
+     * @param src [in] 输入序列。Input sequence.
+     * @param n [in] 窗口长度 N (>0)。Window length N (>0).
+     * @param bins [in] 频点序号，每个均 < N。Bin indices, each < N.
+     * @param nbins [in] 频点数 (>0)。Number of bins (>0).
+     * @param dst [out] 输出序列，长度 length·nbins，第 i 帧为 |X_k(i)|，k 依 bins 顺序。
+     *                  Output of length·nbins; frame i holds |X_k(i)| in the order of bins.
+     *
+     * @note 第一个样本之前的历史视为零，因此前 N-1 帧是补零窗口的频谱。
+     *       History before the first sample counts as zeros, so the first N-1
+     *       frames are spectra of zero-padded windows.
+     */
+    seq_err_t seq_sliding_dft(const seq_t *src, size_t n, const size_t *bins, size_t nbins,
+                              seq_t *dst);
+
+    /**
+     * @brief 计算离线操作的输出长度。Output length of an offline op.
+     *
+     * @param op [in] 操作类型（FIR/RESAMPLE/SDFT 除外）。Operation type (not FIR/RESAMPLE/SDFT).
+     * @param n [in] 输入长度。Input length.
+     * @param param_main [in] 主参数，含义同 seq_stream_init。Main parameter, as in seq_stream_init.
+     * @param len [out] 输出长度。Output length.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_output_length(seq_op_type op, size_t n, size_t param_main, size_t *len);
+
+    /**
+     * @brief 离线操作写入调用方缓冲区，不做任何堆分配。Run an offline op into a caller buffer without heap allocation.
+     *
+     * @param op [in] 操作类型（FIR/RESAMPLE/SDFT 除外）。Operation type (not FIR/RESAMPLE/SDFT).
+     * @param src [in] 输入序列。Input sequence.
+     * @param param_main [in] 主参数，含义同 seq_stream_init。Main parameter, as in seq_stream_init.
+     * @param fill [in] 边界填充值（DELAY/ADVANCE）。Boundary fill value (DELAY/ADVANCE).
+     * @param out [out] 输出缓冲区；仅 seq_inplace_capable(op) 时可等于 src->data，否则不得重叠。
+     *                  Output buffer; may equal src->data only if seq_inplace_capable(op), must not overlap otherwise.
+     * @param cap [in] 输出容量（样本数）。Output capacity in samples.
+     * @param n_out [out] 实际输出样本数。Samples written.
+     * @return SEQ_OK 或错误码；cap 不足时返回 SEQ_ERR_ARG 且不写入。
+     *         SEQ_OK or error code; SEQ_ERR_ARG without writing if cap is short.
+     *
+     * @note FIR/RESAMPLE/SDFT 返回 SEQ_ERR_UNSUPPORTED：其内部状态需要分配，请改用
+     *       seq_stream_process，初始化之后它不再分配。
+     *       FIR/RESAMPLE/SDFT return SEQ_ERR_UNSUPPORTED since their state needs
+     *       allocation; use seq_stream_process, which does not allocate after init.
+     */
+    seq_err_t seq_apply_into(seq_op_type op, const seq_t *src, size_t param_main, double fill,
+                             double *out, size_t cap, size_t *n_out);
+
+    /**
+     * @brief 判断离线操作是否支持原地执行（dst == src）。Check if an offline op may run in place (dst == src).
+     *
+     * @details DELAY/ADVANCE/REVERSE/DIFF/CUMSUM 输出与输入等长，且按单趟原地算法实现，
+     *          不需要第二块缓冲；其余操作改变长度或需要历史样本，必须使用独立的 dst。
+     *          DELAY/ADVANCE/REVERSE/DIFF/CUMSUM keep the length and run as single-pass
+     *          in-place algorithms without a second buffer; the other ops change the
+     *          length or need past samples and require a separate dst.
+     *
+     * @param op [in] 操作类型。Operation type.
+     * @return 非 0 表示支持；0 表示不支持。Non-zero if supported, 0 otherwise.
+     *
+     * @note dst 与 src 只允许完全相同，不允许部分重叠。dst must either be src or not overlap it.
+     */
+    int seq_inplace_capable(seq_op_type op);
+
     /**
      * @brief 判断操作在给定条件下是否支持随来随处理。Check if op supports online streaming.
      *
@@ -206,6 +331,15 @@ extern "C"
      * @param fill [in] 边界填充值，部分操作会使用。Boundary fill value.
      * @return SEQ_OK 或错误码。SEQ_OK or error code.
      *
+     * @note ADVANCE 丢弃前 k 个输入后直通，延迟为 k 个样本（见 seq_stream_latency）；
+     *       PAD_BACK 直通。二者的尾部（k 个 fill、补零）在 seq_stream_finish 之后取出。
+     *       内存为 O(1)，与 k 和补零个数无关。REVERSE 仍返回 SEQ_ERR_UNSUPPORTED。
+     *       ADVANCE drops the first k inputs and then passes through, with a
+     *       latency of k samples (see seq_stream_latency); PAD_BACK passes through.
+     *       Their tails (k fill values, the zeros) come out after seq_stream_finish.
+     *       Memory is O(1) regardless of k or the padding length. REVERSE still
+     *       returns SEQ_ERR_UNSUPPORTED.
+     *
      * @example
      * // 例：初始化差分的流式处理。
      * // Example: init streaming difference.
@@ -218,6 +352,80 @@ extern "C"
                               size_t param_aux,
                               double fill);
 
+    /**
+     * @brief 初始化 FIR 流式状态。Initialize streaming FIR state.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param taps [in] 冲激响应，函数内部拷贝。Impulse response, copied internally.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @param block [in] 块长 B，0 表示自动。输出延迟不超过 B-1 个样本。
+     *                   Block length B, 0 for automatic. Output latency is at most B-1 samples.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 每满 B 个输入产生 B 个输出：第 B 个输入的 step 返回第一个，其余用 has_input=0 取出。
+     *       Every B inputs yield B outputs: the step taking the B-th input returns the first one,
+     *       the rest are drained with has_input=0.
+     */
+    seq_err_t seq_stream_init_fir(seq_stream_t *st,
+                                  const double *taps,
+                                  size_t ntaps,
+                                  size_t block);
+
+    /**
+     * @brief 初始化多相重采样流式状态。Initialize streaming polyphase resampling state.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param up [in] 上采样因子 L (>0)。Upsampling factor L (>0).
+     * @param down [in] 下采样因子 M (>0)。Downsampling factor M (>0).
+     * @param taps [in] 插值滤波器，函数内部拷贝。Interpolation filter, copied internally.
+     * @param ntaps [in] 抽头数 (>0)。Number of taps (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 每个输入产生 0 ~ ceil(L/M) 个输出：step 返回第一个，其余用 has_input=0 取出。
+     *       无输出延迟，也没有需要冲刷的尾部。
+     *       Each input yields 0 to ceil(L/M) outputs: the step returns the first,
+     *       the rest are drained with has_input=0. There is no latency and no tail.
+     */
+    seq_err_t seq_stream_init_resample(seq_stream_t *st,
+                                       size_t up,
+                                       size_t down,
+                                       const double *taps,
+                                       size_t ntaps);
+
+    /**
+     * @brief 初始化滑动 DFT 流式状态。Initialize streaming sliding DFT state.
+     *
+     * @param st [out] 状态对象。State object.
+     * @param n [in] 窗口长度 N (>0)。Window length N (>0).
+     * @param bins [in] 频点序号，每个均 < N，函数内部拷贝。Bin indices, each < N, copied internally.
+     * @param nbins [in] 频点数 (>0)。Number of bins (>0).
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 每个输入产生 nbins 个输出（各频点幅度）：step 返回第一个，其余用 has_input=0 取出。
+     *       无输出延迟，也没有需要冲刷的尾部。
+     *       Each input yields nbins outputs (the bin magnitudes): the step returns
+     *       the first, the rest are drained with has_input=0. There is no latency
+     *       and no tail.
+     */
+    seq_err_t seq_stream_init_sdft(seq_stream_t *st,
+                                   size_t n,
+                                   const size_t *bins,
+                                   size_t nbins);
+
+    /**
+     * @brief 通知输入结束。Signal end of input.
+     *
+     * @param st [in,out] 流式状态。Streaming state.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 调用后不可再提供输入；继续以 has_input=0 调用 seq_stream_step 直至无输出，
+     *       以取出尾部（如 FIR 残余块、ADVANCE 填充、PAD_BACK 补零）。
+     *       No more input may follow; keep calling seq_stream_step with has_input=0
+     *       until it yields nothing to drain the tail (e.g. the partial FIR block,
+     *       ADVANCE fill or PAD_BACK zeros).
+     */
+    seq_err_t seq_stream_finish(seq_stream_t *st);
+
     /**
      * @brief 流式处理一步。One step of streaming processing.
      *
@@ -238,6 +446,58 @@ extern "C"
                               double *y,
                               int *has_output);
 
+    /**
+     * @brief 块处理所需输出容量的上界。Upper bound of output capacity for block processing.
+     *
+     * @param st [in] 已初始化的流式状态。Initialized streaming state.
+     * @param n_in [in] 本次输入样本数。Number of input samples.
+     * @return 对任意状态都成立的输出个数上界；st 无效时返回 0。
+     *         Output-count bound valid in any state; 0 if st is invalid.
+     */
+    size_t seq_stream_output_bound(const seq_stream_t *st, size_t n_in);
+
+    /**
+     * @brief 块流式处理：一次消费 n_in 个输入，写出所有已就绪输出。
+     *        Block streaming: consume n_in inputs at once and write every ready output.
+     *
+     * @param st [in,out] 流式状态。Streaming state.
+     * @param in [in] 输入样本，n_in==0 时可为 NULL。Input samples, may be NULL when n_in==0.
+     * @param n_in [in] 输入样本数。Number of input samples.
+     * @param out [out] 输出缓冲，不得与 in 重叠。Output buffer, must not overlap in.
+     * @param out_cap [in] 输出容量，须 >= seq_stream_output_bound(st, n_in)。
+     *                     Output capacity, must be >= seq_stream_output_bound(st, n_in).
+     * @param n_out [out] 实际输出个数。Number of outputs written.
+     * @return SEQ_OK 或错误码；容量不足时返回 SEQ_ERR_ARG 且不消费输入。
+     *         SEQ_OK or error code; SEQ_ERR_ARG without consuming input if capacity is short.
+     *
+     * @note 结果与逐样本调用 seq_stream_step（含 has_input=0 冲刷）完全一致，
+     *       两种接口可交替使用。输入结束后以 n_in=0 调用以取出尾部。
+     *       Results are identical to per-sample seq_stream_step calls (including
+     *       has_input=0 flushes); both APIs may be mixed. After seq_stream_finish,
+     *       call with n_in=0 until n_out is 0 to drain the tail.
+     */
+    seq_err_t seq_stream_process(seq_stream_t *st,
+                                 const double *in,
+                                 size_t n_in,
+                                 double *out,
+                                 size_t out_cap,
+                                 size_t *n_out);
+
+    /**
+     * @brief 流式状态的输出延迟。Output latency of a streaming state.
+     *
+     * @param st [in] 已初始化的流式状态。Initialized streaming state.
+     * @return 输出 y[n] 最迟在消费第 n + latency 个输入（按输入计数）时给出；
+     *         ADVANCE 为 k，FIR 为 B-1，其余为 0；st 无效时返回 0。
+     *         y[n] is emitted no later than when input n + latency is consumed
+     *         (counted in inputs); k for ADVANCE, B-1 for FIR, 0 otherwise, and 0 if st is invalid.
+     *
+     * @note 这是实现带来的额外等待，不含 DELAY 等操作本身定义的时移。
+     *       This is the extra wait added by the implementation, not the time
+     *       shift that ops such as DELAY define.
+     */
+    size_t seq_stream_latency(const seq_stream_t *st);
+
     /**
      * @brief 释放流式状态中的内部资源。Free resources in streaming state.
      *
@@ -0,0 +1,1050 @@
+/**
+ * @file server.c
+ * @brief 多路流服务实现（epoll + 工作窃取线程池）。Multi-stream server implementation (epoll + work-stealing pool).
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "server.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void server_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[server] error: %s\n", msg);
+}
+
+#ifdef __linux__
+
+/** 缓存行大小（字节）。Cache line size in bytes. */
+#define SERVER_CACHE_LINE 64
+
+/** 每次 epoll_wait 取回的事件数，也是一批的上限。Events per epoll_wait, which is also the batch limit. */
+#define SERVER_EVENTS 256
+
+/** 监听套接字在 epoll 中的标识。Id of the listening socket in epoll. */
+#define SERVER_LISTEN_ID UINT64_MAX
+
+/**
+ * @brief 一路流处理一轮后等待的事件。What a stream waits for after a turn.
+ */
+typedef enum
+{
+    SERVER_WANT_IN = 0, /**< 可读。Readable. */
+    SERVER_WANT_OUT,    /**< 可写（有未写出的输出）。Writable (output is pending). */
+    SERVER_WANT_CLOSE   /**< 已结束或出错，断开。Finished or failed: drop it. */
+} server_want_t;
+
+/**
+ * @brief 状态表中的一路流，按缓存行对齐，相邻两路不共享缓存行。
+ *        One stream in the state table, cache-line aligned so neighbours never share a line.
+ */
+typedef struct
+{
+    _Alignas(SERVER_CACHE_LINE) seq_stream_t st; /**< 流式状态。Streaming state. */
+    int fd;                                      /**< 连接，-1 表示空槽。Connection, -1 for a free slot. */
+    int ended;                                   /**< 已读到 EOF，正在冲刷尾部。EOF seen, draining the tail. */
+    server_want_t want;                          /**< 本轮结果。Result of the last turn. */
+    size_t carry_len;                            /**< 不足一个样本的字节数。Bytes short of a whole sample. */
+    unsigned char carry[8];                      /**< 不足一个样本的字节。Bytes short of a whole sample. */
+    unsigned char *pend;                         /**< 未写出的输出。Output not yet written. */
+    size_t pend_off;                             /**< pend 中已写出的字节。Bytes of pend already written. */
+    size_t pend_len;                             /**< pend 中的字节数。Bytes in pend. */
+    size_t pend_cap;                             /**< pend 容量。Capacity of pend. */
+    size_t next_free;                            /**< 空闲链表中的下一个槽。Next slot on the free list. */
+} server_feed_t;
+
+struct server;
+
+/**
+ * @brief 工作线程：自己的就绪队列与读写暂存。Worker: its own ready queue and I/O scratch.
+ */
+typedef struct
+{
+    _Alignas(SERVER_CACHE_LINE) pthread_mutex_t mu; /**< 保护队列。Guards the queue. */
+    size_t items[SERVER_EVENTS];                    /**< 就绪的流，[head, tail)。Ready streams, [head, tail). */
+    size_t head;                                    /**< 窃取端。Steal end. */
+    size_t tail;                                    /**< 自取端。Owner end. */
+    unsigned char *raw;                             /**< 读缓冲。Read buffer. */
+    double *in;                                     /**< 解码后的输入。Decoded input. */
+    double *out;                                    /**< 输出样本。Output samples. */
+    size_t out_cap;                                 /**< out 容量。Capacity of out. */
+    unsigned char *enc;                             /**< 编码后的输出。Encoded output. */
+    size_t enc_cap;                                 /**< enc 容量（字节）。Capacity of enc in bytes. */
+    struct server *s;                               /**< 所属服务。Owning server. */
+    pthread_t thread;                               /**< 线程（0 号为事件循环线程）。Thread (worker 0 is the loop thread). */
+} server_worker_t;
+
+/**
+ * @brief 服务状态。Server state.
+ */
+typedef struct server
+{
+    const seq_server_cfg_t *cfg; /**< 配置。Configuration. */
+    size_t in_sz;                /**< 输入样本字节数。Bytes per input sample. */
+    size_t out_sz;               /**< 输出样本字节数。Bytes per output sample. */
+    server_feed_t *feeds;        /**< 状态表。State table. */
+    void *feeds_mem;             /**< 状态表的原始分配。Raw allocation of the table. */
+    size_t nfeeds;               /**< 状态表大小。Table size. */
+    size_t free_head;            /**< 空闲链表头，nfeeds 表示没有空槽。Free list head, nfeeds when full. */
+    size_t live;                 /**< 在线的流数。Streams connected. */
+    size_t ended;                /**< 已结束的流数。Streams ended. */
+    server_worker_t *workers;    /**< 工作线程。Workers. */
+    void *workers_mem;           /**< 工作线程数组的原始分配。Raw allocation of the workers. */
+    size_t nworkers;             /**< 工作线程数（含事件循环线程）。Workers, loop thread included. */
+    size_t started;              /**< 已启动的线程数。Threads started. */
+    size_t ninit;                /**< 已初始化的槽数，teardown 按它释放。Slots initialized, released by teardown. */
+    int epfd;                    /**< epoll 描述符。epoll descriptor. */
+    int listen_fd;               /**< 监听描述符。Listening descriptor. */
+    int listening;               /**< 监听套接字是否已登记等待。Whether the listener is armed. */
+    size_t batch[SERVER_EVENTS]; /**< 本批就绪的流。Streams ready in this batch. */
+    size_t nbatch;               /**< 本批个数。Batch size. */
+    pthread_mutex_t mu;          /**< 保护以下字段。Guards the fields below. */
+    pthread_cond_t work;         /**< 新的一批。A new batch. */
+    pthread_cond_t done;         /**< 一批完成。A batch finished. */
+    unsigned long gen;           /**< 批次编号。Batch number. */
+    size_t busy;                 /**< 尚未完成本批的线程数。Threads still on this batch. */
+    int stop;                    /**< 退出标志。Shutdown flag. */
+} server_t;
+
+/**
+ * @brief 分配按缓存行对齐、清零的数组。Allocate a zeroed, cache-line aligned array.
+ *
+ * @param n [in] 元素个数。Element count.
+ * @param size [in] 元素大小（缓存行的整数倍）。Element size, a multiple of the cache line.
+ * @param mem [out] 原始分配，供 free。Raw allocation, for free.
+ * @return 对齐后的起点；失败为 NULL。Aligned start, or NULL on failure.
+ */
+static void *server_alloc_aligned(size_t n, size_t size, void **mem)
+{
+    uintptr_t base;
+    if (n == 0 || size > (SIZE_MAX - SERVER_CACHE_LINE) / n)
+    {
+        return NULL;
+    }
+    *mem = calloc(1, n * size + SERVER_CACHE_LINE);
+    if (!*mem)
+    {
+        return NULL;
+    }
+    base = (uintptr_t)*mem;
+    base = (base + SERVER_CACHE_LINE - 1) / SERVER_CACHE_LINE * SERVER_CACHE_LINE;
+    return (void *)base;
+}
+
+/**
+ * @brief 按需扩大暂存。Grow a scratch buffer on demand.
+ *
+ * @param p [in,out] 缓冲。Buffer.
+ * @param cap [in,out] 容量（元素）。Capacity in elements.
+ * @param need [in] 需要的元素数。Elements needed.
+ * @param elem [in] 元素大小。Element size.
+ * @return 0 成功；非 0 表示内存不足。0 on success, non-zero when out of memory.
+ */
+static int server_grow(void **p, size_t *cap, size_t need, size_t elem)
+{
+    void *q;
+    size_t n = *cap ? *cap : SEQ_SERVER_READ_BLOCK;
+    if (need <= *cap)
+    {
+        return 0;
+    }
+    while (n < need)
+    {
+        if (n > SIZE_MAX / 2 / elem)
+        {
+            return -1;
+        }
+        n *= 2;
+    }
+    q = realloc(*p, n * elem);
+    if (!q)
+    {
+        return -1;
+    }
+    *p = q;
+    *cap = n;
+    return 0;
+}
+
+/**
+ * @brief 设为非阻塞。Make a descriptor non-blocking.
+ *
+ * @param fd [in] 描述符。Descriptor.
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int server_set_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------- 监听 ---------- */
+
+/**
+ * @brief 在 Unix 域路径上监听。Listen on a Unix domain path.
+ */
+static seq_err_t server_listen_unix(const char *path, int *fd, unsigned *port)
+{
+    struct sockaddr_un sa;
+    int s;
+
+    if (strlen(path) == 0 || strlen(path) >= sizeof(sa.sun_path))
+    {
+        server_log_error("seq_server_listen: bad unix socket path");
+        return SEQ_ERR_ARG;
+    }
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    memcpy(sa.sun_path, path, strlen(path));
+
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0)
+    {
+        server_log_error("seq_server_listen: socket failed");
+        return SEQ_ERR_STATE;
+    }
+    unlink(path);
+    if (bind(s, (const struct sockaddr *)&sa, sizeof(sa)) != 0 || listen(s, SOMAXCONN) != 0 ||
+        server_set_nonblock(s) != 0)
+    {
+        server_log_error("seq_server_listen: cannot listen on unix socket");
+        close(s);
+        return SEQ_ERR_STATE;
+    }
+    *fd = s;
+    if (port)
+    {
+        *port = 0;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 在 TCP 端口上监听，spec 为 "PORT" 或 "HOST:PORT"。Listen on a TCP port; spec is "PORT" or "HOST:PORT".
+ */
+static seq_err_t server_listen_tcp(const char *spec, int *fd, unsigned *port)
+{
+    char buf[256];
+    char *host = NULL;
+    char *serv = buf;
+    char *colon;
+    struct addrinfo hints;
+    struct addrinfo *res = NULL;
+    struct addrinfo *ai;
+    int s = -1;
+
+    if (strlen(spec) == 0 || strlen(spec) >= sizeof(buf))
+    {
+        server_log_error("seq_server_listen: bad tcp address");
+        return SEQ_ERR_ARG;
+    }
+    memcpy(buf, spec, strlen(spec) + 1);
+    colon = strrchr(buf, ':');
+    if (colon)
+    {
+        *colon = '\0';
+        host = buf;
+        serv = colon + 1;
+        /* "[::1]:9000" 形式的 IPv6 地址。IPv6 literal in brackets. */
+        if (host[0] == '[' && colon > buf + 1 && colon[-1] == ']')
+        {
+            colon[-1] = '\0';
+            host++;
+        }
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo((host && host[0]) ? host : NULL, serv, &hints, &res) != 0)
+    {
+        server_log_error("seq_server_listen: cannot resolve tcp address");
+        return SEQ_ERR_ARG;
+    }
+
+    ai = res;
+    while (ai)
+    {
+        const int one = 1;
+        s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s >= 0)
+        {
+            setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(s, ai->ai_addr, ai->ai_addrlen) == 0 && listen(s, SOMAXCONN) == 0 &&
+                server_set_nonblock(s) == 0)
+            {
+                break;
+            }
+            close(s);
+            s = -1;
+        }
+        ai = ai->ai_next;
+    }
+    freeaddrinfo(res);
+    if (s < 0)
+    {
+        server_log_error("seq_server_listen: cannot listen on tcp address");
+        return SEQ_ERR_STATE;
+    }
+
+    if (port)
+    {
+        struct sockaddr_storage ss;
+        socklen_t len = sizeof(ss);
+        *port = 0;
+        if (getsockname(s, (struct sockaddr *)&ss, &len) == 0)
+        {
+            if (ss.ss_family == AF_INET)
+            {
+                *port = ntohs(((const struct sockaddr_in *)&ss)->sin_port);
+            }
+            else if (ss.ss_family == AF_INET6)
+            {
+                *port = ntohs(((const struct sockaddr_in6 *)&ss)->sin6_port);
+            }
+        }
+    }
+    *fd = s;
+    return SEQ_OK;
+}
+
+seq_err_t seq_server_listen(const char *addr, int *fd, unsigned *port)
+{
+    if (!addr || !fd)
+    {
+        server_log_error("seq_server_listen: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (strncmp(addr, "unix:", 5) == 0)
+    {
+        return server_listen_unix(addr + 5, fd, port);
+    }
+    if (strncmp(addr, "tcp:", 4) == 0)
+    {
+        return server_listen_tcp(addr + 4, fd, port);
+    }
+    server_log_error("seq_server_listen: address must be unix:PATH or tcp:[HOST:]PORT");
+    return SEQ_ERR_ARG;
+}
+
+/* ---------- 单路流的一轮处理（在工作线程上） ---------- */
+
+/**
+ * @brief 尽量写出字节，写不完的留到 pend。Write as much as possible and keep the rest in pend.
+ *
+ * @param f [in,out] 流，调用时 pend 为空。Stream, with pend empty on entry.
+ * @param p [in] 字节。Bytes.
+ * @param n [in] 字节数。Byte count.
+ * @return 0 全部写出；1 连接暂时写不进；-1 出错。0 when all written, 1 when the connection is full, -1 on error.
+ */
+static int server_write(server_feed_t *f, const unsigned char *p, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t k = send(f->fd, p, n, MSG_NOSIGNAL);
+        if (k > 0)
+        {
+            p += k;
+            n -= (size_t)k;
+            continue;
+        }
+        if (k < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (server_grow((void **)&f->pend, &f->pend_cap, n, 1) != 0)
+            {
+                server_log_error("out of memory for pending output");
+                return -1;
+            }
+            memcpy(f->pend, p, n);
+            f->pend_off = 0;
+            f->pend_len = n;
+            return 1;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 继续写出 pend。Keep writing pend.
+ *
+ * @param f [in,out] 流。Stream.
+ * @return 0 已写空；1 连接暂时写不进；-1 出错。0 once empty, 1 when the connection is full, -1 on error.
+ */
+static int server_write_pending(server_feed_t *f)
+{
+    while (f->pend_len > 0)
+    {
+        ssize_t k = send(f->fd, f->pend + f->pend_off, f->pend_len, MSG_NOSIGNAL);
+        if (k > 0)
+        {
+            f->pend_off += (size_t)k;
+            f->pend_len -= (size_t)k;
+            continue;
+        }
+        if (k < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return 1;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 处理一块输入并写出结果；in 为 NULL 时冲刷尾部。Process one input block and write the result; NULL in drains the tail.
+ *
+ * @param s [in] 服务。Server.
+ * @param f [in,out] 流。Stream.
+ * @param w [in,out] 当前线程的暂存。Scratch of the current thread.
+ * @param in [in] 输入样本。Input samples.
+ * @param n [in] 输入个数。Input count.
+ * @param n_out [out] 输出个数。Output count.
+ * @return 同 server_write。As server_write.
+ */
+static int server_step(const server_t *s, server_feed_t *f, server_worker_t *w,
+                       const double *in, size_t n, size_t *n_out)
+{
+    const size_t bound = seq_stream_output_bound(&f->st, n);
+
+    if (server_grow((void **)&w->out, &w->out_cap, bound, sizeof(double)) != 0 ||
+        server_grow((void **)&w->enc, &w->enc_cap, bound * s->out_sz, 1) != 0)
+    {
+        server_log_error("out of memory for stream output");
+        return -1;
+    }
+    if (seq_stream_process(&f->st, in, n, w->out, bound, n_out) != SEQ_OK)
+    {
+        server_log_error("streaming step failed");
+        return -1;
+    }
+    if (*n_out == 0)
+    {
+        return 0;
+    }
+    seq_io_encode(w->out, s->cfg->out_fmt, w->enc, *n_out);
+    return server_write(f, w->enc, *n_out * s->out_sz);
+}
+
+/**
+ * @brief 一路流的一轮：先写出积压，再读至多 SEQ_SERVER_TURN_READS 块（或冲刷同样多块尾部）。
+ *        One turn of a stream: write the backlog, then read up to SEQ_SERVER_TURN_READS blocks
+ *        (or drain as many tail blocks).
+ *
+ * @param s [in] 服务。Server.
+ * @param f [in,out] 流。Stream.
+ * @param w [in,out] 当前线程的暂存。Scratch of the current thread.
+ * @return 之后等待的事件。What to wait for next.
+ */
+static server_want_t server_turn(const server_t *s, server_feed_t *f, server_worker_t *w)
+{
+    size_t turn = 0;
+    size_t n_out = 0;
+    int rc = server_write_pending(f);
+
+    if (rc != 0)
+    {
+        return (rc < 0) ? SERVER_WANT_CLOSE : SERVER_WANT_OUT;
+    }
+
+    while (!f->ended && turn < SEQ_SERVER_TURN_READS)
+    {
+        size_t total;
+        size_t n;
+        ssize_t k;
+
+        memcpy(w->raw, f->carry, f->carry_len);
+        k = recv(f->fd, w->raw + f->carry_len, SEQ_SERVER_READ_BLOCK * s->in_sz, 0);
+        if (k < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return SERVER_WANT_IN;
+            }
+            server_log_error("read failed on a stream");
+            return SERVER_WANT_CLOSE;
+        }
+        if (k == 0)
+        {
+            if (f->carry_len != 0)
+            {
+                server_log_error("stream ended inside a sample");
+                return SERVER_WANT_CLOSE;
+            }
+            f->ended = 1;
+            if (seq_stream_finish(&f->st) != SEQ_OK)
+            {
+                return SERVER_WANT_CLOSE;
+            }
+            break;
+        }
+
+        /* 不足一个样本的尾巴留到下一次读。Bytes short of a sample wait for the next read. */
+        total = f->carry_len + (size_t)k;
+        n = total / s->in_sz;
+        f->carry_len = total % s->in_sz;
+        memcpy(f->carry, w->raw + n * s->in_sz, f->carry_len);
+        seq_io_decode(w->raw, s->cfg->in_fmt, w->in, n);
+
+        rc = server_step(s, f, w, w->in, n, &n_out);
+        if (rc != 0)
+        {
+            return (rc < 0) ? SERVER_WANT_CLOSE : SERVER_WANT_OUT;
+        }
+        turn++;
+    }
+    if (!f->ended)
+    {
+        /* 本轮读满，留给其他流；数据仍在，会立即再次就绪。Turn used up; the data is still there and fires again at once. */
+        return SERVER_WANT_IN;
+    }
+
+    /* 冲刷尾部直到不再有输出。Drain the tail until no more output. */
+    while (turn < SEQ_SERVER_TURN_READS)
+    {
+        rc = server_step(s, f, w, NULL, 0, &n_out);
+        if (rc != 0)
+        {
+            return (rc < 0) ? SERVER_WANT_CLOSE : SERVER_WANT_OUT;
+        }
+        if (n_out == 0)
+        {
+            return SERVER_WANT_CLOSE;
+        }
+        turn++;
+    }
+    /* 尾部未完：连接可写，下一轮立即继续。Tail not done: the socket is writable, so the next turn follows at once. */
+    return SERVER_WANT_OUT;
+}
+
+/* ---------- 工作窃取线程池 ---------- */
+
+/**
+ * @brief 取一路就绪的流：先取自己队列尾部，再从其他队列头部窃取。
+ *        Take a ready stream: from the back of the own queue, else steal from the front of another.
+ *
+ * @param s [in,out] 服务。Server.
+ * @param self [in] 当前线程编号。Current worker index.
+ * @param id [out] 流编号。Stream index.
+ * @return 非 0 表示取到。Non-zero if one was taken.
+ */
+static int server_take(server_t *s, size_t self, size_t *id)
+{
+    server_worker_t *w = &s->workers[self];
+    size_t i = 1;
+    int got = 0;
+
+    pthread_mutex_lock(&w->mu);
+    if (w->tail > w->head)
+    {
+        *id = w->items[--w->tail];
+        got = 1;
+    }
+    pthread_mutex_unlock(&w->mu);
+
+    while (!got && i < s->nworkers)
+    {
+        server_worker_t *v = &s->workers[(self + i) % s->nworkers];
+        pthread_mutex_lock(&v->mu);
+        if (v->tail > v->head)
+        {
+            *id = v->items[v->head++];
+            got = 1;
+        }
+        pthread_mutex_unlock(&v->mu);
+        i++;
+    }
+    return got;
+}
+
+/**
+ * @brief 处理就绪的流，直到所有队列都空。Handle ready streams until every queue is empty.
+ *
+ * @param s [in,out] 服务。Server.
+ * @param self [in] 当前线程编号。Current worker index.
+ */
+static void server_drain(server_t *s, size_t self)
+{
+    size_t id;
+    while (server_take(s, self, &id))
+    {
+        server_feed_t *f = &s->feeds[id];
+        f->want = server_turn(s, f, &s->workers[self]);
+    }
+}
+
+/**
+ * @brief 工作线程主循环：每来一批就参与处理。Worker main loop: joins in on every batch.
+ *
+ * @param arg [in] server_worker_t。
+ * @return NULL。
+ */
+static void *server_worker(void *arg)
+{
+    server_worker_t *w = (server_worker_t *)arg;
+    server_t *s = w->s;
+    const size_t self = (size_t)(w - s->workers);
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&s->mu);
+    while (1)
+    {
+        while (s->gen == seen && !s->stop)
+        {
+            pthread_cond_wait(&s->work, &s->mu);
+        }
+        if (s->stop)
+        {
+            break;
+        }
+        seen = s->gen;
+        pthread_mutex_unlock(&s->mu);
+
+        server_drain(s, self);
+
+        pthread_mutex_lock(&s->mu);
+        if (--s->busy == 0)
+        {
+            pthread_cond_signal(&s->done);
+        }
+    }
+    pthread_mutex_unlock(&s->mu);
+    return NULL;
+}
+
+/**
+ * @brief 处理本批就绪的流：分到各线程队列，事件循环线程一起处理并等待全部完成。
+ *        Handle this batch: spread it over the worker queues; the loop thread joins in and waits for all.
+ *
+ * @param s [in,out] 服务。Server.
+ */
+static void server_run_batch(server_t *s)
+{
+    size_t i = 0;
+
+    while (i < s->nworkers)
+    {
+        s->workers[i].head = 0;
+        s->workers[i].tail = 0;
+        i++;
+    }
+    i = 0;
+    while (i < s->nbatch)
+    {
+        server_worker_t *w = &s->workers[i % s->nworkers];
+        w->items[w->tail++] = s->batch[i];
+        i++;
+    }
+    if (s->nworkers == 1 || s->nbatch < 2)
+    {
+        server_drain(s, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&s->mu);
+    s->busy = s->nworkers - 1;
+    s->gen++;
+    pthread_cond_broadcast(&s->work);
+    pthread_mutex_unlock(&s->mu);
+
+    server_drain(s, 0);
+
+    pthread_mutex_lock(&s->mu);
+    while (s->busy > 0)
+    {
+        pthread_cond_wait(&s->done, &s->mu);
+    }
+    pthread_mutex_unlock(&s->mu);
+}
+
+/* ---------- 状态表与事件循环 ---------- */
+
+/**
+ * @brief 断开一路流并归还槽位。Drop a stream and return its slot.
+ *
+ * @param s [in,out] 服务。Server.
+ * @param id [in] 流编号。Stream index.
+ */
+static void server_close_feed(server_t *s, size_t id)
+{
+    server_feed_t *f = &s->feeds[id];
+
+    close(f->fd);
+    seq_stream_dispose(&f->st);
+    free(f->pend);
+    memset(f, 0, sizeof(*f));
+    f->fd = -1;
+    f->next_free = s->free_head;
+    s->free_head = id;
+    s->live--;
+    s->ended++;
+}
+
+/**
+ * @brief 重新登记流或监听套接字的事件。Re-arm the events of a stream or of the listener.
+ *
+ * @param s [in] 服务。Server.
+ * @param fd [in] 描述符。Descriptor.
+ * @param id [in] epoll 标识。epoll id.
+ * @param events [in] EPOLLIN 或 EPOLLOUT。EPOLLIN or EPOLLOUT.
+ * @param op [in] EPOLL_CTL_ADD 或 EPOLL_CTL_MOD。
+ * @return 0 成功；非 0 失败。0 on success, non-zero on failure.
+ */
+static int server_arm(const server_t *s, int fd, uint64_t id, uint32_t events, int op)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events | EPOLLONESHOT;
+    ev.data.u64 = id;
+    return epoll_ctl(s->epfd, op, fd, &ev);
+}
+
+/**
+ * @brief 接受全部待接入的连接，状态表满时暂停监听。Accept every pending connection; pause listening when the table is full.
+ *
+ * @param s [in,out] 服务。Server.
+ */
+static void server_accept(server_t *s)
+{
+    s->listening = 0;
+    while (s->free_head < s->nfeeds)
+    {
+        const int one = 1;
+        const size_t id = s->free_head;
+        server_feed_t *f = &s->feeds[id];
+        int fd = accept(s->listen_fd, NULL, NULL);
+
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                server_log_error("accept failed");
+            }
+            break;
+        }
+        if (server_set_nonblock(fd) != 0)
+        {
+            server_log_error("cannot make a connection non-blocking");
+            close(fd);
+            continue;
+        }
+        /* 流式输出要尽快送达；Unix 域套接字上此调用无效，忽略失败。
+           Stream output should go out at once; this fails harmlessly on Unix sockets. */
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (s->cfg->init(s->cfg->ctx, &f->st) != SEQ_OK)
+        {
+            server_log_error("cannot initialize the state of a new stream");
+            close(fd);
+            continue;
+        }
+        s->free_head = f->next_free;
+        f->fd = fd;
+        s->live++;
+        if (server_arm(s, fd, id, EPOLLIN, EPOLL_CTL_ADD) != 0)
+        {
+            server_log_error("cannot watch a new stream");
+            server_close_feed(s, id);
+        }
+    }
+    if (s->free_head < s->nfeeds && server_arm(s, s->listen_fd, SERVER_LISTEN_ID, EPOLLIN, EPOLL_CTL_MOD) == 0)
+    {
+        s->listening = 1;
+    }
+}
+
+/**
+ * @brief 按本轮结果重新登记或断开一路流。Re-arm or drop a stream after its turn.
+ *
+ * @param s [in,out] 服务。Server.
+ * @param id [in] 流编号。Stream index.
+ */
+static void server_settle(server_t *s, size_t id)
+{
+    server_feed_t *f = &s->feeds[id];
+
+    if (f->want != SERVER_WANT_CLOSE &&
+        server_arm(s, f->fd, id, (f->want == SERVER_WANT_OUT) ? EPOLLOUT : EPOLLIN, EPOLL_CTL_MOD) == 0)
+    {
+        return;
+    }
+    server_close_feed(s, id);
+}
+
+/**
+ * @brief 停止并回收工作线程，断开全部连接，释放内存。Stop the workers, drop every connection and free memory.
+ *
+ * @param s [in,out] 服务。Server.
+ */
+static void server_teardown(server_t *s)
+{
+    size_t i = 1;
+
+    pthread_mutex_lock(&s->mu);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->work);
+    pthread_mutex_unlock(&s->mu);
+    while (i < s->started)
+    {
+        pthread_join(s->workers[i].thread, NULL);
+        i++;
+    }
+
+    i = 0;
+    while (s->feeds && i < s->nfeeds)
+    {
+        if (s->feeds[i].fd >= 0)
+        {
+            server_close_feed(s, i);
+        }
+        i++;
+    }
+    i = 0;
+    while (s->workers && i < s->ninit)
+    {
+        pthread_mutex_destroy(&s->workers[i].mu);
+        free(s->workers[i].raw);
+        free(s->workers[i].in);
+        free(s->workers[i].out);
+        free(s->workers[i].enc);
+        i++;
+    }
+    if (s->epfd >= 0)
+    {
+        close(s->epfd);
+    }
+    pthread_cond_destroy(&s->work);
+    pthread_cond_destroy(&s->done);
+    pthread_mutex_destroy(&s->mu);
+    free(s->feeds_mem);
+    free(s->workers_mem);
+}
+
+seq_err_t seq_server_run(int listen_fd, const seq_server_cfg_t *cfg)
+{
+    server_t s;
+    struct epoll_event ev[SERVER_EVENTS];
+    seq_err_t err = SEQ_OK;
+    size_t i;
+
+    if (!cfg || !cfg->init || listen_fd < 0)
+    {
+        server_log_error("seq_server_run: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    if (seq_fmt_size(cfg->in_fmt) == 0 || seq_fmt_size(cfg->out_fmt) == 0)
+    {
+        server_log_error("seq_server_run: streams need binary input and output formats");
+        return SEQ_ERR_ARG;
+    }
+
+    memset(&s, 0, sizeof(s));
+    s.cfg = cfg;
+    s.in_sz = seq_fmt_size(cfg->in_fmt);
+    s.out_sz = seq_fmt_size(cfg->out_fmt);
+    s.listen_fd = listen_fd;
+    s.nfeeds = cfg->max_feeds ? cfg->max_feeds : SEQ_SERVER_MAX_FEEDS;
+    s.nworkers = cfg->threads;
+    if (s.nworkers == 0)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        s.nworkers = (n > 0) ? (size_t)n : 1;
+    }
+    if (seq_stats_enabled())
+    {
+        /* 统计不加锁：只在一个线程上处理。The statistics are unlocked: handle streams on one thread. */
+        s.nworkers = 1;
+    }
+    s.epfd = -1;
+    pthread_mutex_init(&s.mu, NULL);
+    pthread_cond_init(&s.work, NULL);
+    pthread_cond_init(&s.done, NULL);
+
+    s.feeds = (server_feed_t *)server_alloc_aligned(s.nfeeds, sizeof(server_feed_t), &s.feeds_mem);
+    s.workers = (server_worker_t *)server_alloc_aligned(s.nworkers, sizeof(server_worker_t), &s.workers_mem);
+    if (!s.feeds || !s.workers)
+    {
+        server_log_error("seq_server_run: out of memory for the state table");
+        server_teardown(&s);
+        return SEQ_ERR_NOMEM;
+    }
+
+    /* 空闲链表按编号顺序串起全部槽。The free list chains every slot in index order. */
+    i = 0;
+    while (i < s.nfeeds)
+    {
+        s.feeds[i].fd = -1;
+        s.feeds[i].next_free = i + 1;
+        i++;
+    }
+    i = 0;
+    while (i < s.nworkers)
+    {
+        server_worker_t *w = &s.workers[i];
+        pthread_mutex_init(&w->mu, NULL);
+        s.ninit = i + 1;
+        w->s = &s;
+        w->raw = (unsigned char *)malloc(SEQ_SERVER_READ_BLOCK * s.in_sz + sizeof(w->raw[0]) * 8);
+        w->in = (double *)malloc(SEQ_SERVER_READ_BLOCK * sizeof(double) + sizeof(double));
+        if (!w->raw || !w->in)
+        {
+            server_log_error("seq_server_run: out of memory for worker buffers");
+            server_teardown(&s);
+            return SEQ_ERR_NOMEM;
+        }
+        i++;
+    }
+
+    s.epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (s.epfd < 0 || server_arm(&s, listen_fd, SERVER_LISTEN_ID, EPOLLIN, EPOLL_CTL_ADD) != 0)
+    {
+        server_log_error("seq_server_run: cannot set up epoll");
+        server_teardown(&s);
+        return SEQ_ERR_STATE;
+    }
+    s.listening = 1;
+
+    s.started = 1;
+    while (s.started < s.nworkers)
+    {
+        if (pthread_create(&s.workers[s.started].thread, NULL, server_worker, &s.workers[s.started]) != 0)
+        {
+            /* 起不来的线程不参与，已有线程照样工作；其余槽仍由 teardown 按 ninit 释放。
+             * Threads that fail to start just do not take part; teardown still
+             * releases the remaining slots up to ninit. */
+            s.nworkers = s.started;
+            break;
+        }
+        s.started++;
+    }
+
+    while (cfg->sessions == 0 || s.ended < cfg->sessions)
+    {
+        int k = epoll_wait(s.epfd, ev, SERVER_EVENTS, -1);
+        int j = 0;
+        if (k < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            server_log_error("epoll_wait failed");
+            err = SEQ_ERR_STATE;
+            break;
+        }
+
+        s.nbatch = 0;
+        while (j < k)
+        {
+            if (ev[j].data.u64 == SERVER_LISTEN_ID)
+            {
+                server_accept(&s);
+            }
+            else
+            {
+                s.batch[s.nbatch++] = (size_t)ev[j].data.u64;
+            }
+            j++;
+        }
+
+        server_run_batch(&s);
+        i = 0;
+        while (i < s.nbatch)
+        {
+            server_settle(&s, s.batch[i]);
+            i++;
+        }
+        if (!s.listening && s.free_head < s.nfeeds &&
+            server_arm(&s, listen_fd, SERVER_LISTEN_ID, EPOLLIN, EPOLL_CTL_MOD) == 0)
+        {
+            s.listening = 1;
+        }
+    }
+
+    server_teardown(&s);
+    return err;
+}
+
+void seq_server_close(int listen_fd)
+{
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+    }
+}
+
+#else /* !__linux__ */
+
+seq_err_t seq_server_listen(const char *addr, int *fd, unsigned *port)
+{
+    (void)addr;
+    (void)fd;
+    (void)port;
+    server_log_error("serve mode needs epoll (Linux only)");
+    return SEQ_ERR_UNSUPPORTED;
+}
+
+seq_err_t seq_server_run(int listen_fd, const seq_server_cfg_t *cfg)
+{
+    (void)listen_fd;
+    (void)cfg;
+    server_log_error("serve mode needs epoll (Linux only)");
+    return SEQ_ERR_UNSUPPORTED;
+}
+
+void seq_server_close(int listen_fd)
+{
+    (void)listen_fd;
+}
+
+#endif /* __linux__ */
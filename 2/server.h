@@ -0,0 +1,115 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/**
+ * @file server.h
+ * @brief 多路流服务：一个进程复用成千上万路流式状态。Multi-stream server: one process multiplexing thousands of streaming states.
+ *
+ * 每个连接（TCP 或 Unix 域套接字）是一路独立的流：客户端写入二进制样本，半关闭写端表示输入结束；
+ * 服务端在同一连接上按到达顺序写回该路 seq_stream_t 的输出，冲刷尾部后关闭连接。
+ * 各路状态存放在按缓存行对齐的定长状态表中，槽位经空闲链表复用，接入与断开不分配状态表内存。
+ * 事件循环以 epoll（EPOLLONESHOT）收集一批就绪的流，分到各工作线程的队列上成批处理；
+ * 线程先取自己队列的尾部，空了再从其他队列头部窃取，因此少数繁忙的流不会让其余线程空等。
+ * Every connection (TCP or Unix domain socket) is one independent stream:
+ * the client writes binary samples and half-closes its write side to end
+ * the input; the server writes the output of that stream's seq_stream_t back
+ * on the same connection in arrival order, drains the tail and closes it.
+ * Stream states live in a fixed, cache-line aligned state table whose slots
+ * are recycled through a free list, so connecting and disconnecting never
+ * allocate table memory. The event loop collects a batch of ready streams
+ * with epoll (EPOLLONESHOT) and spreads it over per-worker queues; a worker
+ * takes from the back of its own queue and, once that is empty, steals from
+ * the front of the others, so a few busy streams never leave the other
+ * threads idle.
+ *
+ * @note 同一路流同一时刻只在一个线程上处理，输出顺序与单独运行 stream 模式一致。
+ *       某路写不出去时只暂停读取这一路（背压），不影响其他流。仅 Linux（epoll）可用，
+ *       其他平台返回 SEQ_ERR_UNSUPPORTED。统计不加锁，开启统计时只用一个线程处理。
+ *       A stream is only ever handled by one thread at a time, so its output
+ *       matches running stream mode on it alone. A stream whose output cannot
+ *       be written only pauses reading that stream (backpressure) and does not
+ *       hold up the others. Linux only (epoll); other platforms get
+ *       SEQ_ERR_UNSUPPORTED. The statistics are unlocked, so with statistics
+ *       on a single thread does the processing.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+#include "seqio.h"
+
+/** 默认状态表大小（同时在线的流数）。Default state table size (concurrent streams). */
+#define SEQ_SERVER_MAX_FEEDS 4096
+
+/** 每次读取的样本数上限。Samples per read, at most. */
+#define SEQ_SERVER_READ_BLOCK 4096
+
+/** 每路流每轮最多读取的次数，保证各路公平。Reads per stream per turn, for fairness across streams. */
+#define SEQ_SERVER_TURN_READS 4
+
+/**
+ * @brief 为新连接初始化一路流式状态。Initialize the streaming state of a new connection.
+ *
+ * @param ctx [in] seq_server_cfg_t::ctx。
+ * @param st [out] 待初始化的状态。State to initialize.
+ * @return SEQ_OK；失败时拒绝该连接。SEQ_OK, or an error to refuse the connection.
+ */
+typedef seq_err_t (*seq_server_init_fn)(void *ctx, seq_stream_t *st);
+
+/**
+ * @brief 服务配置。Server configuration.
+ */
+typedef struct
+{
+    seq_fmt_t in_fmt;        /**< 输入格式（二进制）。Input format (binary). */
+    seq_fmt_t out_fmt;       /**< 输出格式（二进制）。Output format (binary). */
+    size_t max_feeds;        /**< 状态表大小，0 表示 SEQ_SERVER_MAX_FEEDS。State table size, 0 for the default. */
+    size_t threads;          /**< 工作线程数（含事件循环线程），0 表示全部在线 CPU。Workers including the loop thread, 0 for all online CPUs. */
+    size_t sessions;         /**< 结束这么多路流后返回，0 表示一直运行。Return after this many streams end, 0 to run forever. */
+    seq_server_init_fn init; /**< 每路流的初始化回调。Per-stream init callback. */
+    void *ctx;               /**< 回调上下文。Callback context. */
+} seq_server_cfg_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 创建监听套接字。Create a listening socket.
+     *
+     * @param addr [in] "unix:PATH"、"tcp:PORT" 或 "tcp:HOST:PORT"（PORT 为 0 时由系统选择）。
+     *                  "unix:PATH", "tcp:PORT" or "tcp:HOST:PORT" (PORT 0 lets the system choose).
+     * @param fd [out] 非阻塞的监听描述符。Non-blocking listening descriptor.
+     * @param port [out] TCP 实际端口（Unix 域为 0），可为 NULL。Actual TCP port (0 for Unix), may be NULL.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note Unix 域路径上已有的文件会先被删除。An existing file at the Unix socket path is removed first.
+     */
+    seq_err_t seq_server_listen(const char *addr, int *fd, unsigned *port);
+
+    /**
+     * @brief 在监听套接字上运行服务。Run the server on a listening socket.
+     *
+     * @param listen_fd [in] seq_server_listen 返回的描述符，由调用方以 seq_server_close 关闭。Descriptor from seq_server_listen, closed by the caller with seq_server_close.
+     * @param cfg [in] 配置。Configuration.
+     * @return 达到 cfg->sessions 后返回 SEQ_OK；出错返回错误码。单路流的错误只断开该连接。
+     *         SEQ_OK once cfg->sessions streams have ended, or an error code.
+     *         Errors of a single stream only drop that connection.
+     *
+     * @note 状态表满时暂停接受新连接，直到有流结束。Accepting pauses while the table is full until a stream ends.
+     */
+    seq_err_t seq_server_run(int listen_fd, const seq_server_cfg_t *cfg);
+
+    /**
+     * @brief 关闭监听套接字。Close a listening socket.
+     *
+     * @param listen_fd [in] seq_server_listen 返回的描述符，负数时不做任何事。Descriptor from seq_server_listen; negative is a no-op.
+     */
+    void seq_server_close(int listen_fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SERVER_H */
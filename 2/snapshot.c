@@ -0,0 +1,564 @@
+/**
+ * @file snapshot.c
+ * @brief 流式状态快照实现。Streaming state snapshot implementation.
+ *
+ * 布局：头部（魔数 "SQST"、版本、种类、级数、流位置、流水线结束标志），随后每级一条记录：
+ * 操作与参数、通用字段与 buf，再接该操作的内核状态。恢复分两趟：第一趟只校验
+ * （配置一致、下标与计数在范围内），第二趟才写入，因此失败时状态保持原样。
+ * Layout: a header (magic "SQST", version, kind, stage count, stream
+ * position, pipeline end flag), then one record per stage: the op and its
+ * parameters, the common fields and buf, followed by the op's kernel state.
+ * Restoring takes two passes: the first only validates (matching
+ * configuration, indices and counters in range) and the second writes, so
+ * a failure leaves the state as it was.
+ */
+
+#include "snapshot.h"
+#include "fir.h"
+#include "resample.h"
+#include "sdft.h"
+#include "snapio.h"
+
+#include <string.h>
+#include <stdio.h>
+
+/** 快照魔数。Snapshot magic. */
+static const char snapshot_magic[4] = {'S', 'Q', 'S', 'T'};
+
+/** 快照种类。Snapshot kinds. */
+#define SNAPSHOT_KIND_STREAM 1u
+#define SNAPSHOT_KIND_PIPELINE 2u
+
+/** 每级记录的标志位。Per-stage record flags. */
+#define SNAPSHOT_FLAG_ENDED 1u
+#define SNAPSHOT_FLAG_HAS_LAST 2u
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void snapshot_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[snapshot] error: %s\n", msg);
+}
+
+/**
+ * @brief double 的位模式。Bit pattern of a double.
+ */
+static uint64_t snapshot_bits(double v)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief 内核系数摘要（按小端位模式的 FNV-1a），用于确认恢复目标使用相同的抽头。
+ *        Digest of kernel coefficients (FNV-1a over little-endian bit patterns),
+ *        used to check that the restore target uses the same taps.
+ *
+ * @param v [in] 系数。Coefficients.
+ * @param n [in] 个数。Count.
+ * @return 摘要。Digest.
+ */
+static uint64_t snapshot_digest(const double *v, size_t n)
+{
+    unsigned char le[8];
+    uint64_t h = SNAP_CHECKSUM_INIT;
+    size_t i = 0;
+
+    while (i < n)
+    {
+        const uint64_t bits = snapshot_bits(v[i]);
+        size_t b = 0;
+        while (b < 8)
+        {
+            le[b] = (unsigned char)(bits >> (8 * b));
+            b++;
+        }
+        h = snap_checksum_update(h, le, sizeof(le));
+        i++;
+    }
+    return h;
+}
+
+/**
+ * @brief 写出一级记录。Write the record of one stage.
+ *
+ * @param w [in,out] 写入端。Writer.
+ * @param st [in] 状态。State.
+ */
+static void snapshot_put_stage(snap_writer_t *w, const seq_stream_t *st)
+{
+    uint32_t flags = 0;
+
+    if (st->ended)
+    {
+        flags |= SNAPSHOT_FLAG_ENDED;
+    }
+    if (st->has_last)
+    {
+        flags |= SNAPSHOT_FLAG_HAS_LAST;
+    }
+
+    snap_put_u32(w, (uint32_t)st->op);
+    snap_put_u32(w, flags);
+    snap_put_u64(w, st->param_main);
+    snap_put_u64(w, st->param_aux);
+    snap_put_f64(w, st->fill);
+    snap_put_u64(w, st->buf_size);
+    snap_put_u64(w, st->buf_head);
+    snap_put_u64(w, st->counter);
+    snap_put_u64(w, st->remaining);
+    snap_put_f64(w, st->last);
+    snap_put_f64(w, st->acc);
+    snap_put_f64s(w, st->buf, st->buf_size);
+
+    if (st->fir)
+    {
+        const seq_fir_t *f = st->fir;
+        snap_put_u64(w, f->taps);
+        snap_put_u64(w, f->block);
+        snap_put_u64(w, f->parts);
+        snap_put_u64(w, snapshot_digest((const double *)f->kspec, 2 * f->parts * f->nbin));
+        snap_put_u64(w, f->fdl_head);
+        snap_put_u64(w, f->in_fill);
+        snap_put_u64(w, f->out_count);
+        snap_put_f64s(w, (const double *)f->fdl, 2 * f->parts * f->nbin);
+        snap_put_f64s(w, f->inbuf, 2 * f->block);
+        snap_put_f64s(w, f->outbuf + f->out_pos, f->out_count);
+    }
+    if (st->rs)
+    {
+        const seq_resampler_t *r = st->rs;
+        snap_put_u64(w, r->up);
+        snap_put_u64(w, r->down);
+        snap_put_u64(w, r->tpp);
+        snap_put_u64(w, snapshot_digest(r->phases, r->up * r->tpp));
+        snap_put_u64(w, r->head);
+        snap_put_u64(w, r->pos);
+        snap_put_u64(w, r->out_count);
+        snap_put_f64s(w, r->hist, 2 * r->tpp);
+        snap_put_f64s(w, r->qbuf + r->out_pos, r->out_count);
+    }
+    if (st->sdft)
+    {
+        const seq_sdft_t *s = st->sdft;
+        size_t b = 0;
+        snap_put_u64(w, s->n);
+        snap_put_u64(w, s->nbins);
+        while (b < s->nbins)
+        {
+            snap_put_u64(w, s->bins[b]);
+            b++;
+        }
+        snap_put_u64(w, s->head);
+        snap_put_u64(w, s->since_anchor);
+        snap_put_u64(w, s->out_count);
+        snap_put_f64s(w, s->x_re, s->nbins);
+        snap_put_f64s(w, s->x_im, s->nbins);
+        snap_put_f64s(w, s->hist, s->n);
+        snap_put_f64s(w, s->qbuf + s->out_pos, s->out_count);
+    }
+}
+
+/**
+ * @brief 检查 counter 与 remaining 是否在该操作可能达到的范围内，
+ *        seq_stream_output_bound() 按 param_main 给出的容量依赖于此。
+ *        Check that counter and remaining lie in the range the op can reach;
+ *        the capacity seq_stream_output_bound() derives from param_main relies on it.
+ *
+ * @param st [in] 以相同配置初始化的状态。State initialized with the same configuration.
+ * @param ended [in] 快照中的结束标志。End flag from the snapshot.
+ * @param counter [in] 快照中的 counter。counter from the snapshot.
+ * @param remaining [in] 快照中的 remaining。remaining from the snapshot.
+ * @return 在范围内为 1，否则为 0。1 if in range, 0 otherwise.
+ */
+static int snapshot_counters_ok(const seq_stream_t *st, int ended, uint64_t counter, uint64_t remaining)
+{
+    switch (st->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        return remaining <= st->param_main;
+    case SEQ_OP_UPSAMPLE:
+        return remaining < st->param_main;
+    case SEQ_OP_ADVANCE:
+        /* 结束后补齐的个数等于已丢弃的个数。After finish, the fills equal the drops. */
+        return counter <= st->param_main && (ended ? remaining <= counter : remaining == 0);
+    case SEQ_OP_PAD_BACK:
+        return ended ? remaining <= st->param_main : remaining == 0;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief 读取一级记录：apply 为 0 时只校验，非 0 时写入状态。
+ *        Read the record of one stage: validate only when apply is 0, write the state otherwise.
+ *
+ * @param r [in,out] 读取端。Reader.
+ * @param st [in,out] 以相同配置初始化的状态。State initialized with the same configuration.
+ * @param apply [in] 是否写入。Whether to write.
+ * @return SEQ_OK 或 SEQ_ERR_ARG。SEQ_OK or SEQ_ERR_ARG.
+ */
+static seq_err_t snapshot_get_stage(snap_reader_t *r, seq_stream_t *st, int apply)
+{
+    const uint32_t op = snap_get_u32(r);
+    const uint32_t flags = snap_get_u32(r);
+    const uint64_t param_main = snap_get_u64(r);
+    const uint64_t param_aux = snap_get_u64(r);
+    const double fill = snap_get_f64(r);
+    const uint64_t buf_size = snap_get_u64(r);
+    const uint64_t buf_head = snap_get_u64(r);
+    const uint64_t counter = snap_get_u64(r);
+    const uint64_t remaining = snap_get_u64(r);
+    const double last = snap_get_f64(r);
+    const double acc = snap_get_f64(r);
+
+    if (r->fail || !st->active || op != (uint32_t)st->op || param_main != st->param_main ||
+        param_aux != st->param_aux || snapshot_bits(fill) != snapshot_bits(st->fill) ||
+        buf_size != st->buf_size)
+    {
+        snapshot_log_error("snapshot does not match the stream configuration");
+        return SEQ_ERR_ARG;
+    }
+    if (buf_size > 0 ? buf_head >= buf_size : buf_head != 0)
+    {
+        snapshot_log_error("corrupt snapshot: buffer index out of range");
+        return SEQ_ERR_ARG;
+    }
+    if (!snapshot_counters_ok(st, (flags & SNAPSHOT_FLAG_ENDED) != 0, counter, remaining))
+    {
+        snapshot_log_error("corrupt snapshot: stage counter out of range");
+        return SEQ_ERR_ARG;
+    }
+    snap_get_f64s(r, apply ? st->buf : NULL, st->buf_size);
+    if (apply)
+    {
+        st->ended = (flags & SNAPSHOT_FLAG_ENDED) != 0;
+        st->has_last = (flags & SNAPSHOT_FLAG_HAS_LAST) != 0;
+        st->buf_head = (size_t)buf_head;
+        st->counter = (size_t)counter;
+        st->remaining = (size_t)remaining;
+        st->last = last;
+        st->acc = acc;
+    }
+
+    if (st->fir)
+    {
+        seq_fir_t *f = st->fir;
+        const uint64_t taps = snap_get_u64(r);
+        const uint64_t block = snap_get_u64(r);
+        const uint64_t parts = snap_get_u64(r);
+        const uint64_t digest = snap_get_u64(r);
+        const uint64_t fdl_head = snap_get_u64(r);
+        const uint64_t in_fill = snap_get_u64(r);
+        const uint64_t out_count = snap_get_u64(r);
+
+        if (r->fail || taps != f->taps || block != f->block || parts != f->parts ||
+            digest != snapshot_digest((const double *)f->kspec, 2 * f->parts * f->nbin))
+        {
+            snapshot_log_error("snapshot does not match the FIR kernel");
+            return SEQ_ERR_ARG;
+        }
+        if (fdl_head >= parts || in_fill >= block || out_count > block)
+        {
+            snapshot_log_error("corrupt snapshot: FIR index out of range");
+            return SEQ_ERR_ARG;
+        }
+        snap_get_f64s(r, apply ? (double *)f->fdl : NULL, 2 * f->parts * f->nbin);
+        snap_get_f64s(r, apply ? f->inbuf : NULL, 2 * f->block);
+        snap_get_f64s(r, apply ? f->outbuf : NULL, (size_t)out_count);
+        if (apply)
+        {
+            f->fdl_head = (size_t)fdl_head;
+            f->in_fill = (size_t)in_fill;
+            f->out_pos = 0;
+            f->out_count = (size_t)out_count;
+        }
+    }
+    if (st->rs)
+    {
+        seq_resampler_t *rs = st->rs;
+        const uint64_t up = snap_get_u64(r);
+        const uint64_t down = snap_get_u64(r);
+        const uint64_t tpp = snap_get_u64(r);
+        const uint64_t digest = snap_get_u64(r);
+        const uint64_t head = snap_get_u64(r);
+        const uint64_t pos = snap_get_u64(r);
+        const uint64_t out_count = snap_get_u64(r);
+
+        if (r->fail || up != rs->up || down != rs->down || tpp != rs->tpp ||
+            digest != snapshot_digest(rs->phases, rs->up * rs->tpp))
+        {
+            snapshot_log_error("snapshot does not match the resampling kernel");
+            return SEQ_ERR_ARG;
+        }
+        if (head >= tpp || pos >= up + down || out_count > rs->qcap)
+        {
+            snapshot_log_error("corrupt snapshot: resampler index out of range");
+            return SEQ_ERR_ARG;
+        }
+        snap_get_f64s(r, apply ? rs->hist : NULL, 2 * rs->tpp);
+        snap_get_f64s(r, apply ? rs->qbuf : NULL, (size_t)out_count);
+        if (apply)
+        {
+            rs->head = (size_t)head;
+            rs->pos = (size_t)pos;
+            rs->out_pos = 0;
+            rs->out_count = (size_t)out_count;
+        }
+    }
+    if (st->sdft)
+    {
+        seq_sdft_t *s = st->sdft;
+        const uint64_t n = snap_get_u64(r);
+        const uint64_t nbins = snap_get_u64(r);
+        uint64_t head;
+        uint64_t since_anchor;
+        uint64_t out_count;
+        size_t b = 0;
+
+        if (r->fail || n != s->n || nbins != s->nbins)
+        {
+            snapshot_log_error("snapshot does not match the sliding DFT");
+            return SEQ_ERR_ARG;
+        }
+        while (b < s->nbins)
+        {
+            if (snap_get_u64(r) != s->bins[b])
+            {
+                snapshot_log_error("snapshot does not match the sliding DFT bins");
+                return SEQ_ERR_ARG;
+            }
+            b++;
+        }
+        head = snap_get_u64(r);
+        since_anchor = snap_get_u64(r);
+        out_count = snap_get_u64(r);
+        if (r->fail || head >= n || since_anchor >= SEQ_SDFT_ANCHOR_WINDOWS * n || out_count > nbins)
+        {
+            snapshot_log_error("corrupt snapshot: sliding DFT index out of range");
+            return SEQ_ERR_ARG;
+        }
+        snap_get_f64s(r, apply ? s->x_re : NULL, s->nbins);
+        snap_get_f64s(r, apply ? s->x_im : NULL, s->nbins);
+        snap_get_f64s(r, apply ? s->hist : NULL, s->n);
+        snap_get_f64s(r, apply ? s->qbuf : NULL, (size_t)out_count);
+        if (apply)
+        {
+            s->head = (size_t)head;
+            s->since_anchor = (size_t)since_anchor;
+            s->out_pos = 0;
+            s->out_count = (size_t)out_count;
+        }
+    }
+
+    if (r->fail)
+    {
+        snapshot_log_error("corrupt snapshot: truncated stage record");
+        return SEQ_ERR_ARG;
+    }
+    return SEQ_OK;
+}
+
+/**
+ * @brief 写出完整快照（writer 的 buf 为 NULL 时只计数）。Write a whole snapshot (counting only for a NULL buf).
+ */
+static void snapshot_put(snap_writer_t *w, uint32_t kind, const seq_stream_t *stages, size_t nstages,
+                         int ended, const seq_snapshot_pos_t *pos)
+{
+    size_t i = 0;
+
+    snap_put_header(w, snapshot_magic, SEQ_SNAPSHOT_VERSION);
+    snap_put_u32(w, kind);
+    snap_put_u32(w, ended ? 1u : 0u);
+    snap_put_u64(w, nstages);
+    snap_put_u64(w, pos ? pos->in : 0);
+    snap_put_u64(w, pos ? pos->out : 0);
+    while (i < nstages)
+    {
+        snapshot_put_stage(w, &stages[i]);
+        i++;
+    }
+}
+
+/**
+ * @brief 校验并（apply 非 0 时）恢复完整快照。Validate and, when apply is non-zero, restore a whole snapshot.
+ */
+static seq_err_t snapshot_get(const unsigned char *buf, size_t len, uint32_t kind, seq_stream_t *stages,
+                              size_t nstages, int *ended, seq_snapshot_pos_t *pos, int apply)
+{
+    snap_reader_t r;
+    uint32_t version = 0;
+    uint32_t got_kind;
+    uint32_t got_ended;
+    uint64_t got_stages;
+    seq_snapshot_pos_t got_pos;
+    size_t i = 0;
+
+    if (snap_reader_init(&r, buf, len) != 0)
+    {
+        snapshot_log_error("corrupt snapshot: checksum mismatch or truncated");
+        return SEQ_ERR_ARG;
+    }
+    if (snap_get_header(&r, snapshot_magic, &version) != 0)
+    {
+        snapshot_log_error("not a stream snapshot");
+        return SEQ_ERR_ARG;
+    }
+    if (version != SEQ_SNAPSHOT_VERSION)
+    {
+        snapshot_log_error("unsupported snapshot version");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+    got_kind = snap_get_u32(&r);
+    got_ended = snap_get_u32(&r);
+    got_stages = snap_get_u64(&r);
+    got_pos.in = snap_get_u64(&r);
+    got_pos.out = snap_get_u64(&r);
+    if (r.fail || got_kind != kind || got_stages != nstages)
+    {
+        snapshot_log_error("snapshot does not match the stage layout");
+        return SEQ_ERR_ARG;
+    }
+
+    while (i < nstages)
+    {
+        seq_err_t err = snapshot_get_stage(&r, &stages[i], apply);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+        i++;
+    }
+    if (!snap_reader_done(&r))
+    {
+        snapshot_log_error("corrupt snapshot: trailing bytes");
+        return SEQ_ERR_ARG;
+    }
+
+    if (apply)
+    {
+        if (ended)
+        {
+            *ended = got_ended != 0;
+        }
+        if (pos)
+        {
+            *pos = got_pos;
+        }
+    }
+    return SEQ_OK;
+}
+
+size_t seq_stream_snapshot_size(const seq_stream_t *st)
+{
+    snap_writer_t w;
+    size_t len = 0;
+
+    if (!st || !st->active)
+    {
+        return 0;
+    }
+    snap_writer_init(&w, NULL, 0);
+    snapshot_put(&w, SNAPSHOT_KIND_STREAM, st, 1, 0, NULL);
+    snap_writer_finish(&w, &len);
+    return len;
+}
+
+seq_err_t seq_stream_snapshot(const seq_stream_t *st, const seq_snapshot_pos_t *pos,
+                              unsigned char *buf, size_t cap, size_t *len)
+{
+    snap_writer_t w;
+
+    if (!st || !st->active || !buf || !len)
+    {
+        snapshot_log_error("seq_stream_snapshot: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    snap_writer_init(&w, buf, cap);
+    snapshot_put(&w, SNAPSHOT_KIND_STREAM, st, 1, 0, pos);
+    if (snap_writer_finish(&w, len) != 0)
+    {
+        snapshot_log_error("seq_stream_snapshot: buffer too small");
+        return SEQ_ERR_ARG;
+    }
+    return SEQ_OK;
+}
+
+seq_err_t seq_stream_restore(seq_stream_t *st, const unsigned char *buf, size_t len,
+                             seq_snapshot_pos_t *pos)
+{
+    seq_err_t err;
+
+    if (!st || !buf)
+    {
+        snapshot_log_error("seq_stream_restore: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    err = snapshot_get(buf, len, SNAPSHOT_KIND_STREAM, st, 1, NULL, pos, 0);
+    if (err == SEQ_OK)
+    {
+        err = snapshot_get(buf, len, SNAPSHOT_KIND_STREAM, st, 1, NULL, pos, 1);
+    }
+    return err;
+}
+
+size_t seq_pipeline_snapshot_size(const seq_pipeline_t *pl)
+{
+    snap_writer_t w;
+    size_t len = 0;
+
+    if (!pl || !pl->stages)
+    {
+        return 0;
+    }
+    snap_writer_init(&w, NULL, 0);
+    snapshot_put(&w, SNAPSHOT_KIND_PIPELINE, pl->stages, pl->nstages, pl->ended, NULL);
+    snap_writer_finish(&w, &len);
+    return len;
+}
+
+seq_err_t seq_pipeline_snapshot(const seq_pipeline_t *pl, const seq_snapshot_pos_t *pos,
+                                unsigned char *buf, size_t cap, size_t *len)
+{
+    snap_writer_t w;
+
+    if (!pl || !pl->stages || !buf || !len)
+    {
+        snapshot_log_error("seq_pipeline_snapshot: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    snap_writer_init(&w, buf, cap);
+    snapshot_put(&w, SNAPSHOT_KIND_PIPELINE, pl->stages, pl->nstages, pl->ended, pos);
+    if (snap_writer_finish(&w, len) != 0)
+    {
+        snapshot_log_error("seq_pipeline_snapshot: buffer too small");
+        return SEQ_ERR_ARG;
+    }
+    return SEQ_OK;
+}
+
+seq_err_t seq_pipeline_restore(seq_pipeline_t *pl, const unsigned char *buf, size_t len,
+                               seq_snapshot_pos_t *pos)
+{
+    seq_err_t err;
+
+    if (!pl || !pl->stages || !buf)
+    {
+        snapshot_log_error("seq_pipeline_restore: invalid argument");
+        return SEQ_ERR_ARG;
+    }
+    err = snapshot_get(buf, len, SNAPSHOT_KIND_PIPELINE, pl->stages, pl->nstages, NULL, pos, 0);
+    if (err == SEQ_OK)
+    {
+        err = snapshot_get(buf, len, SNAPSHOT_KIND_PIPELINE, pl->stages, pl->nstages, &pl->ended, pos, 1);
+    }
+    return err;
+}
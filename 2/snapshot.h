@@ -0,0 +1,133 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/**
+ * @file snapshot.h
+ * @brief 流式状态与流水线的快照和恢复。Snapshot and restore of streaming state and pipelines.
+ *
+ * 快照保存 seq_stream_t 的全部运行状态（延迟环 buf、acc、last、counter、remaining，
+ * 以及 FIR 频域延迟线、重采样历史、滑动 DFT 频点等内核状态）和调用方给出的流位置，
+ * 重启后恢复即可从断点继续，输出与不中断运行逐位一致，无需重放输入。
+ * A snapshot holds the whole running state of a seq_stream_t (delay ring
+ * buf, acc, last, counter, remaining, plus kernel state such as the FIR
+ * frequency-domain delay line, the resampler history or the sliding DFT
+ * bins) and a stream position given by the caller. Restoring it after a
+ * restart continues from the checkpoint with output bit-identical to an
+ * uninterrupted run, without replaying any input.
+ *
+ * 快照只含运行状态，不含配置：恢复的目标须先用与快照时相同的参数（及相同的抽头）初始化，
+ * 快照记录操作、参数与内核摘要，不一致时拒绝恢复。编码见 ../common/snapio.h。
+ * Snapshots carry running state, not configuration: the target must first
+ * be initialized with the parameters (and taps) in use when the snapshot
+ * was taken. The snapshot records the op, its parameters and a digest of
+ * the kernel and refuses to restore into anything else. The encoding is
+ * described in ../common/snapio.h.
+ *
+ * @note 快照大小与状态大小同阶（延迟量、FIR 抽头数、窗口长度），与已处理的样本数无关。
+ *       The snapshot size is on the order of the state (delay, FIR taps, window
+ *       length), independent of how many samples have been processed.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sequence.h"
+#include "pipeline.h"
+
+/** 快照格式版本。Snapshot format version. */
+#define SEQ_SNAPSHOT_VERSION 1
+
+/**
+ * @brief 快照对应的流位置，由调用方维护、随快照原样保存。
+ *        Stream position of a snapshot, kept by the caller and stored verbatim.
+ */
+typedef struct
+{
+    uint64_t in;  /**< 已消费的输入样本数。Input samples consumed. */
+    uint64_t out; /**< 已产生的输出样本数。Output samples produced. */
+} seq_snapshot_pos_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 单路流式状态的快照大小（字节）。Snapshot size of one streaming state in bytes.
+     *
+     * @param st [in] 已初始化的状态。Initialized state.
+     * @return 字节数；状态无效时为 0。Byte count, 0 for an invalid state.
+     */
+    size_t seq_stream_snapshot_size(const seq_stream_t *st);
+
+    /**
+     * @brief 把流式状态写成快照。Write a streaming state as a snapshot.
+     *
+     * @param st [in] 已初始化的状态。Initialized state.
+     * @param pos [in] 流位置，可为 NULL（记为 0）。Stream position, may be NULL (stored as 0).
+     * @param buf [out] 快照缓冲。Snapshot buffer.
+     * @param cap [in] 缓冲容量，至少 seq_stream_snapshot_size(st)。Capacity, at least seq_stream_snapshot_size(st).
+     * @param len [out] 快照字节数。Snapshot bytes.
+     * @return SEQ_OK 或错误码；cap 不足时返回 SEQ_ERR_ARG。SEQ_OK or error code; SEQ_ERR_ARG if cap is short.
+     */
+    seq_err_t seq_stream_snapshot(const seq_stream_t *st, const seq_snapshot_pos_t *pos,
+                                  unsigned char *buf, size_t cap, size_t *len);
+
+    /**
+     * @brief 从快照恢复流式状态。Restore a streaming state from a snapshot.
+     *
+     * @param st [in,out] 以相同配置初始化的状态。State initialized with the same configuration.
+     * @param buf [in] 快照。Snapshot.
+     * @param len [in] 快照字节数。Snapshot bytes.
+     * @param pos [out] 快照的流位置，可为 NULL。Stream position of the snapshot, may be NULL.
+     * @return SEQ_OK；快照损坏或与配置不符时为 SEQ_ERR_ARG，版本不同为 SEQ_ERR_UNSUPPORTED。
+     *         任何失败都不修改 st。
+     *         SEQ_OK; SEQ_ERR_ARG for a corrupt snapshot or one that does not match
+     *         the configuration, SEQ_ERR_UNSUPPORTED for another version. st is
+     *         left untouched on any failure.
+     */
+    seq_err_t seq_stream_restore(seq_stream_t *st, const unsigned char *buf, size_t len,
+                                 seq_snapshot_pos_t *pos);
+
+    /**
+     * @brief 流水线的快照大小（字节）。Snapshot size of a pipeline in bytes.
+     *
+     * @param pl [in] 已初始化的流水线。Initialized pipeline.
+     * @return 字节数；流水线无效时为 0。Byte count, 0 for an invalid pipeline.
+     */
+    size_t seq_pipeline_snapshot_size(const seq_pipeline_t *pl);
+
+    /**
+     * @brief 把流水线各级状态写成一个快照。Write the state of every pipeline stage as one snapshot.
+     *
+     * @param pl [in] 流水线。Pipeline.
+     * @param pos [in] 流位置，可为 NULL。Stream position, may be NULL.
+     * @param buf [out] 快照缓冲。Snapshot buffer.
+     * @param cap [in] 缓冲容量。Capacity.
+     * @param len [out] 快照字节数。Snapshot bytes.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     *
+     * @note 只能在两次 seq_pipeline_push 之间调用，此时各级之间没有在途样本。
+     *       Only between seq_pipeline_push calls, when no samples are in flight between stages.
+     */
+    seq_err_t seq_pipeline_snapshot(const seq_pipeline_t *pl, const seq_snapshot_pos_t *pos,
+                                    unsigned char *buf, size_t cap, size_t *len);
+
+    /**
+     * @brief 从快照恢复流水线。Restore a pipeline from a snapshot.
+     *
+     * @param pl [in,out] 以相同各级配置初始化的流水线。Pipeline initialized with the same stages.
+     * @param buf [in] 快照。Snapshot.
+     * @param len [in] 快照字节数。Snapshot bytes.
+     * @param pos [out] 快照的流位置，可为 NULL。Stream position of the snapshot, may be NULL.
+     * @return 同 seq_stream_restore；失败时不修改任何一级。
+     *         As seq_stream_restore; no stage is modified on failure.
+     */
+    seq_err_t seq_pipeline_restore(seq_pipeline_t *pl, const unsigned char *buf, size_t len,
+                                   seq_snapshot_pos_t *pos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,216 @@
+/**
+ * @file stats.c
+ * @brief 逐操作计数与计时实现。Per-op counters and timers implementation.
+ */
+
+#include "stats.h"
+
+#include <time.h>
+
+/**
+ * @brief 全部统计状态。All statistics state.
+ */
+typedef struct
+{
+    int on;                                              /**< 是否记录。Whether recording. */
+    seq_stats_entry_t op[SEQ_STATS_PATHS][SEQ_OP_COUNT]; /**< 各路径各操作。Per path and op. */
+    seq_stats_entry_t phase[SEQ_STATS_PHASES];           /**< 各阶段。Per phase. */
+    char op_name[SEQ_STATS_PATHS][SEQ_OP_COUNT][32];     /**< 操作项名。Op entry names. */
+    seq_stats_hook_fn hook;                              /**< 事件回调。Event hook. */
+    void *hook_ctx;                                      /**< 回调上下文。Hook context. */
+} seq_stats_state_t;
+
+static seq_stats_state_t stats;
+
+/** 路径前缀。Path prefixes. */
+static const char *const stats_path_names[SEQ_STATS_PATHS] = {"offline", "step", "block"};
+
+/** 操作名，与 CLI 一致。Op names, as on the CLI. */
+static const char *const stats_op_names[SEQ_OP_COUNT] = {
+    "pad-front", "pad-back", "delay", "advance", "reverse", "upsample",
+    "downsample", "diff", "cumsum", "fir", "resample", "sdft"};
+
+/** 阶段项名。Phase entry names. */
+static const char *const stats_phase_names[SEQ_STATS_PHASES] = {"io/parse", "io/format", "alloc"};
+
+/**
+ * @brief 当前时间（纳秒）。Current time in ns.
+ */
+static uint64_t stats_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 生成操作项名。Build the op entry names.
+ */
+static void stats_build_names(void)
+{
+    size_t p = 0;
+    while (p < SEQ_STATS_PATHS)
+    {
+        size_t o = 0;
+        while (o < SEQ_OP_COUNT)
+        {
+            snprintf(stats.op_name[p][o], sizeof(stats.op_name[p][o]), "%s/%s",
+                     stats_path_names[p], stats_op_names[o]);
+            o++;
+        }
+        p++;
+    }
+}
+
+/**
+ * @brief 累加一次记录并调用事件回调。Accumulate one record and call the event hook.
+ */
+static void stats_add(seq_stats_entry_t *e, const char *name, uint64_t t0,
+                      size_t n_in, size_t n_out, size_t bytes)
+{
+    seq_stats_entry_t d;
+    d.calls = 1;
+    d.samples_in = n_in;
+    d.samples_out = n_out;
+    d.bytes = bytes;
+    d.ns = t0 ? stats_now_ns() - t0 : 0;
+
+    e->calls++;
+    e->samples_in += d.samples_in;
+    e->samples_out += d.samples_out;
+    e->bytes += d.bytes;
+    e->ns += d.ns;
+
+    if (stats.hook)
+    {
+        stats.hook(stats.hook_ctx, name, &d);
+    }
+}
+
+seq_err_t seq_stats_enable(int on)
+{
+#ifdef SEQ_NO_STATS
+    if (on)
+    {
+        fprintf(stderr, "[stats] error: statistics were compiled out (SEQ_NO_STATS)\n");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+#endif
+    if (on && !stats.op_name[0][0][0])
+    {
+        stats_build_names();
+    }
+    stats.on = on ? 1 : 0;
+    return SEQ_OK;
+}
+
+int seq_stats_enabled(void)
+{
+    return stats.on;
+}
+
+void seq_stats_reset(void)
+{
+    size_t p = 0;
+    while (p < SEQ_STATS_PATHS)
+    {
+        size_t o = 0;
+        while (o < SEQ_OP_COUNT)
+        {
+            stats.op[p][o] = (seq_stats_entry_t){0};
+            o++;
+        }
+        p++;
+    }
+    p = 0;
+    while (p < SEQ_STATS_PHASES)
+    {
+        stats.phase[p] = (seq_stats_entry_t){0};
+        p++;
+    }
+}
+
+void seq_stats_set_hook(seq_stats_hook_fn hook, void *ctx)
+{
+    stats.hook = hook;
+    stats.hook_ctx = ctx;
+}
+
+void seq_stats_visit(seq_stats_visit_fn visit, void *ctx)
+{
+    size_t p = 0;
+
+    if (!visit || !stats.op_name[0][0][0])
+    {
+        return;
+    }
+    while (p < SEQ_STATS_PHASES)
+    {
+        if (stats.phase[p].calls)
+        {
+            visit(ctx, stats_phase_names[p], &stats.phase[p]);
+        }
+        p++;
+    }
+    p = 0;
+    while (p < SEQ_STATS_PATHS)
+    {
+        size_t o = 0;
+        while (o < SEQ_OP_COUNT)
+        {
+            if (stats.op[p][o].calls)
+            {
+                visit(ctx, stats.op_name[p][o], &stats.op[p][o]);
+            }
+            o++;
+        }
+        p++;
+    }
+}
+
+/**
+ * @brief seq_stats_dump 的遍历回调。Visitor behind seq_stats_dump.
+ */
+static void stats_dump_row(void *ctx, const char *name, const seq_stats_entry_t *e)
+{
+    uint64_t n = e->samples_in > e->samples_out ? e->samples_in : e->samples_out;
+    fprintf((FILE *)ctx, "[stats] %-18s %10llu %12llu %12llu %12llu %11.3f %10.2f\n", name,
+            (unsigned long long)e->calls, (unsigned long long)e->samples_in,
+            (unsigned long long)e->samples_out, (unsigned long long)e->bytes,
+            (double)e->ns / 1e6, n ? (double)e->ns / (double)n : 0.0);
+}
+
+void seq_stats_dump(FILE *fp)
+{
+    if (!fp)
+    {
+        return;
+    }
+    fprintf(fp, "[stats] %-18s %10s %12s %12s %12s %11s %10s\n", "entry", "calls",
+            "samples_in", "samples_out", "bytes", "ms", "ns/sample");
+    seq_stats_visit(stats_dump_row, fp);
+}
+
+uint64_t seq_stats_start(void)
+{
+    return stats.on ? stats_now_ns() : 0;
+}
+
+void seq_stats_record_op(seq_stats_path_t path, seq_op_type op, uint64_t t0, size_t n_in, size_t n_out)
+{
+    if (!stats.on || (size_t)path >= SEQ_STATS_PATHS || (size_t)op >= SEQ_OP_COUNT)
+    {
+        return;
+    }
+    stats_add(&stats.op[path][op], stats.op_name[path][op], t0, n_in, n_out, 0);
+}
+
+void seq_stats_record_phase(seq_stats_phase_t phase, uint64_t t0, size_t n, size_t bytes)
+{
+    if (!stats.on || (size_t)phase >= SEQ_STATS_PHASES)
+    {
+        return;
+    }
+    stats_add(&stats.phase[phase], stats_phase_names[phase], t0,
+              phase == SEQ_STATS_FORMAT ? 0 : n, phase == SEQ_STATS_FORMAT ? n : 0, bytes);
+}
@@ -0,0 +1,176 @@
+#ifndef STATS_H
+#define STATS_H
+
+/**
+ * @file stats.h
+ * @brief 逐操作的计数与计时。Per-op counters and timers.
+ *
+ * 记录每个操作在离线接口、seq_stream_step 与 seq_stream_process 三条路径上的调用次数、
+ * 输入输出样本数与耗时，以及 CLI 的解析、格式化和 seq_alloc 的分配字节。
+ * 运行时默认关闭，关闭时每个记录点只多一次分支；以 -DSEQ_NO_STATS 编译则记录点完全消失。
+ * Records calls, input/output samples and time for every op on the offline
+ * API, seq_stream_step and seq_stream_process paths, plus CLI parsing,
+ * formatting and the bytes allocated by seq_alloc. Off at run time by
+ * default, costing one branch per record point; compiling with
+ * -DSEQ_NO_STATS removes the record points entirely.
+ *
+ * @note 计数器为全局状态，不加锁，只应在一个线程中记录。
+ *       Counters are unlocked global state; record from one thread only.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "sequence.h"
+
+/** seq_op_type 的操作个数。Number of ops in seq_op_type. */
+#define SEQ_OP_COUNT ((size_t)SEQ_OP_SDFT + 1)
+
+/**
+ * @brief 操作的调用路径。Call path of an op.
+ */
+typedef enum
+{
+    SEQ_STATS_OFFLINE = 0, /**< 离线接口（seq_pad_front 等）。Offline API (seq_pad_front etc.). */
+    SEQ_STATS_STEP,        /**< seq_stream_step。 */
+    SEQ_STATS_BLOCK,       /**< seq_stream_process。 */
+    SEQ_STATS_PATHS        /**< 路径个数。Number of paths. */
+} seq_stats_path_t;
+
+/**
+ * @brief 操作之外的阶段。Phases outside the ops.
+ */
+typedef enum
+{
+    SEQ_STATS_PARSE = 0, /**< 输入解码（文本解析或二进制读取）。Input decoding (text parsing or binary reads). */
+    SEQ_STATS_FORMAT,    /**< 输出编码。Output encoding. */
+    SEQ_STATS_ALLOC,     /**< seq_alloc。 */
+    SEQ_STATS_PHASES     /**< 阶段个数。Number of phases. */
+} seq_stats_phase_t;
+
+/**
+ * @brief 一项统计。One statistics entry.
+ */
+typedef struct
+{
+    uint64_t calls;       /**< 调用次数。Calls. */
+    uint64_t samples_in;  /**< 输入样本数。Input samples. */
+    uint64_t samples_out; /**< 输出样本数。Output samples. */
+    uint64_t bytes;       /**< 分配字节数（仅 alloc）。Bytes allocated (alloc only). */
+    uint64_t ns;          /**< 累计耗时（纳秒）。Accumulated time in ns. */
+} seq_stats_entry_t;
+
+/**
+ * @brief 事件回调：每次记录后以本次增量调用。Event hook, called with the delta of every record.
+ *
+ * @param ctx [in] 注册时的上下文。Context given at registration.
+ * @param name [in] 统计项名，如 "block/fir"、"io/parse"。Entry name such as "block/fir" or "io/parse".
+ * @param delta [in] 本次增量。Delta of this record.
+ */
+typedef void (*seq_stats_hook_fn)(void *ctx, const char *name, const seq_stats_entry_t *delta);
+
+/**
+ * @brief 遍历回调：对每个非空统计项调用一次。Visitor, called once per non-empty entry.
+ *
+ * @param ctx [in] 调用方上下文。Caller context.
+ * @param name [in] 统计项名。Entry name.
+ * @param total [in] 累计值。Accumulated totals.
+ */
+typedef void (*seq_stats_visit_fn)(void *ctx, const char *name, const seq_stats_entry_t *total);
+
+#ifndef SEQ_NO_STATS
+/** 开始计时；未启用时为 0。Start timing; 0 when disabled. */
+#define SEQ_STATS_START() seq_stats_start()
+/** 记录一次操作。Record one op call. */
+#define SEQ_STATS_OP(path, op, t0, n_in, n_out) seq_stats_record_op((path), (op), (t0), (n_in), (n_out))
+/** 记录一次阶段。Record one phase. */
+#define SEQ_STATS_PHASE(phase, t0, n, bytes) seq_stats_record_phase((phase), (t0), (n), (bytes))
+#else
+#define SEQ_STATS_START() ((uint64_t)0)
+#define SEQ_STATS_OP(path, op, t0, n_in, n_out) ((void)(t0))
+#define SEQ_STATS_PHASE(phase, t0, n, bytes) ((void)(t0))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 开启或关闭记录。Turn recording on or off.
+     *
+     * @param on [in] 非 0 开启。Non-zero to turn on.
+     * @return SEQ_OK；以 SEQ_NO_STATS 编译时开启返回 SEQ_ERR_UNSUPPORTED。
+     *         SEQ_OK; SEQ_ERR_UNSUPPORTED when turning on in a SEQ_NO_STATS build.
+     */
+    seq_err_t seq_stats_enable(int on);
+
+    /**
+     * @brief 是否正在记录。Whether recording is on.
+     *
+     * @return 非 0 表示开启。Non-zero if on.
+     */
+    int seq_stats_enabled(void);
+
+    /**
+     * @brief 清零全部统计。Clear every entry.
+     */
+    void seq_stats_reset(void);
+
+    /**
+     * @brief 注册事件回调，NULL 取消。Register the event hook, NULL to remove it.
+     *
+     * @param hook [in] 回调。Hook.
+     * @param ctx [in] 回调上下文。Hook context.
+     */
+    void seq_stats_set_hook(seq_stats_hook_fn hook, void *ctx);
+
+    /**
+     * @brief 遍历非空统计项，用于导出到外部监控。Visit non-empty entries, e.g. to export them.
+     *
+     * @param visit [in] 遍历回调。Visitor.
+     * @param ctx [in] 回调上下文。Visitor context.
+     */
+    void seq_stats_visit(seq_stats_visit_fn visit, void *ctx);
+
+    /**
+     * @brief 以表格输出非空统计项。Print non-empty entries as a table.
+     *
+     * @param fp [in] 输出流。Output stream.
+     */
+    void seq_stats_dump(FILE *fp);
+
+    /**
+     * @brief 记录点内部使用：开始计时。Record-point helper: start timing.
+     *
+     * @return 当前时间（纳秒）；未开启时为 0。Current time in ns; 0 when off.
+     */
+    uint64_t seq_stats_start(void);
+
+    /**
+     * @brief 记录点内部使用：记录一次操作。Record-point helper: record one op call.
+     *
+     * @param path [in] 调用路径。Call path.
+     * @param op [in] 操作。Op.
+     * @param t0 [in] seq_stats_start 的返回值。Value returned by seq_stats_start.
+     * @param n_in [in] 输入样本数。Input samples.
+     * @param n_out [in] 输出样本数。Output samples.
+     */
+    void seq_stats_record_op(seq_stats_path_t path, seq_op_type op, uint64_t t0, size_t n_in, size_t n_out);
+
+    /**
+     * @brief 记录点内部使用：记录一次阶段。Record-point helper: record one phase.
+     *
+     * @param phase [in] 阶段。Phase.
+     * @param t0 [in] seq_stats_start 的返回值。Value returned by seq_stats_start.
+     * @param n [in] 样本数（解析为输入、格式化为输出）。Samples (input for parse, output for format).
+     * @param bytes [in] 分配字节数。Bytes allocated.
+     */
+    void seq_stats_record_phase(seq_stats_phase_t phase, uint64_t t0, size_t n, size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATS_H */
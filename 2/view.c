@@ -0,0 +1,381 @@
+#include "view.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief 内部错误日志（英文，输出到 stderr）。Internal error log (English, stderr).
+ *
+ * @param msg [in] 错误消息。Error message.
+ */
+static void view_log_error(const char *msg)
+{
+    if (!msg)
+    {
+        return;
+    }
+    fprintf(stderr, "[view] error: %s\n", msg);
+}
+
+/**
+ * @brief 置为全部是 fill 的视图，长度不变。Turn a view into all fill, keeping its length.
+ *
+ * @param v [in,out] 视图。View.
+ * @param fill [in] 填充值。Fill value.
+ */
+static void view_set_fill(seq_view_t *v, double fill)
+{
+    v->count = 0;
+    v->lead = v->length;
+    v->lead_fill = fill;
+    v->tail_fill = fill;
+}
+
+/**
+ * @brief 尾部填充区的长度。Length of the tail fill region.
+ *
+ * @param v [in] 视图。View.
+ * @return 尾部填充个数。Tail fill elements.
+ */
+static size_t view_tail(const seq_view_t *v)
+{
+    return v->length - v->lead - v->count;
+}
+
+seq_err_t seq_view_of(const seq_t *src, seq_view_t *v)
+{
+    if (!src || !v || (!src->data && src->length != 0))
+    {
+        view_log_error("seq_view_of: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    v->base = src->data;
+    v->stride = 1;
+    v->count = src->length;
+    v->lead = 0;
+    v->length = src->length;
+    v->lead_fill = 0.0;
+    v->tail_fill = 0.0;
+    return SEQ_OK;
+}
+
+double seq_view_get(const seq_view_t *v, size_t i)
+{
+    if (i < v->lead)
+    {
+        return v->lead_fill;
+    }
+    i -= v->lead;
+    if (i < v->count)
+    {
+        return v->base[(ptrdiff_t)i * v->stride];
+    }
+    return v->tail_fill;
+}
+
+seq_err_t seq_view_pad_front(const seq_view_t *src, size_t zeros, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_pad_front: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (zeros > SIZE_MAX - src->length)
+    {
+        view_log_error("seq_view_pad_front: length overflow");
+        return SEQ_ERR_ARG;
+    }
+    if (src->lead != 0 && src->lead_fill != 0.0)
+    {
+        view_log_error("seq_view_pad_front: front fill is not zero, materialize first");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    seq_view_t v = *src;
+    v.lead += zeros;
+    v.length += zeros;
+    v.lead_fill = 0.0;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_pad_back(const seq_view_t *src, size_t zeros, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_pad_back: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (zeros > SIZE_MAX - src->length)
+    {
+        view_log_error("seq_view_pad_back: length overflow");
+        return SEQ_ERR_ARG;
+    }
+    if (view_tail(src) != 0 && src->tail_fill != 0.0)
+    {
+        view_log_error("seq_view_pad_back: tail fill is not zero, materialize first");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    seq_view_t v = *src;
+    v.length += zeros;
+    v.tail_fill = 0.0;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_delay(const seq_view_t *src, size_t delay, double fill, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_delay: null pointer");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_view_t v = *src;
+    if (delay >= v.length)
+    {
+        view_set_fill(&v, fill);
+        *dst = v;
+        return SEQ_OK;
+    }
+    if (v.lead != 0 && v.lead_fill != fill)
+    {
+        view_log_error("seq_view_delay: fill differs from the front fill, materialize first");
+        return SEQ_ERR_UNSUPPORTED;
+    }
+
+    /* 整体右移 delay，末尾 delay 个移出视图。Shift right by delay; the last delay elements fall off. */
+    const size_t keep = v.length - delay;
+    if (v.lead >= keep)
+    {
+        view_set_fill(&v, fill);
+        *dst = v;
+        return SEQ_OK;
+    }
+    if (v.count > keep - v.lead)
+    {
+        v.count = keep - v.lead;
+    }
+    v.lead += delay;
+    v.lead_fill = fill;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_advance(const seq_view_t *src, size_t advance, double fill, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_advance: null pointer");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_view_t v = *src;
+    if (advance >= v.length)
+    {
+        view_set_fill(&v, fill);
+        *dst = v;
+        return SEQ_OK;
+    }
+
+    /* 整体左移 advance：先从前部填充区扣除，再从存储区扣除。
+       Shift left by advance: taken from the front fill first, then from the stored run. */
+    if (advance <= v.lead)
+    {
+        v.lead -= advance;
+    }
+    else
+    {
+        size_t skip = advance - v.lead;
+        if (skip > v.count)
+        {
+            skip = v.count;
+        }
+        if (skip != 0)
+        {
+            v.base += (ptrdiff_t)skip * v.stride;
+        }
+        v.count -= skip;
+        v.lead = 0;
+    }
+
+    /* 原尾部填充区剩下 [lead + count, length - advance)。The old tail keeps [lead + count, length - advance). */
+    const size_t end = v.length - advance;
+    if (v.lead + v.count < end && v.tail_fill != fill)
+    {
+        if (v.count != 0 || v.lead != 0)
+        {
+            view_log_error("seq_view_advance: fill differs from the tail fill, materialize first");
+            return SEQ_ERR_UNSUPPORTED;
+        }
+        /* 只剩原尾部：改作前部填充。Only the old tail is left: it becomes the front fill. */
+        v.lead = end;
+        v.lead_fill = v.tail_fill;
+    }
+    v.tail_fill = fill;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_reverse(const seq_view_t *src, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_reverse: null pointer");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_view_t v = *src;
+    if (v.count != 0)
+    {
+        v.base += (ptrdiff_t)(v.count - 1) * v.stride;
+    }
+    v.stride = -v.stride;
+    v.lead = view_tail(src);
+    v.lead_fill = src->tail_fill;
+    v.tail_fill = src->lead_fill;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_downsample(const seq_view_t *src, size_t factor, seq_view_t *dst)
+{
+    if (!src || !dst)
+    {
+        view_log_error("seq_view_downsample: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (factor == 0)
+    {
+        view_log_error("seq_view_downsample: factor must be > 0");
+        return SEQ_ERR_ARG;
+    }
+    const size_t mag = (size_t)(src->stride < 0 ? -src->stride : src->stride);
+    if (factor > (size_t)PTRDIFF_MAX || (mag != 0 && factor > (size_t)PTRDIFF_MAX / mag))
+    {
+        view_log_error("seq_view_downsample: stride overflow");
+        return SEQ_ERR_ARG;
+    }
+
+    seq_view_t v = *src;
+    v.length = src->length / factor;
+
+    /* 第一个落入存储区的输出下标 i0 = ceil(lead / factor)。First output index in the stored run. */
+    const size_t i0 = src->lead / factor + (src->lead % factor != 0);
+    size_t count = 0;
+    if (i0 < v.length)
+    {
+        const size_t s0 = i0 * factor - src->lead;
+        if (s0 < src->count)
+        {
+            count = (src->count - s0 - 1) / factor + 1;
+            v.base += (ptrdiff_t)s0 * src->stride;
+        }
+        if (count > v.length - i0)
+        {
+            count = v.length - i0;
+        }
+        v.lead = i0;
+    }
+    else
+    {
+        v.lead = v.length;
+    }
+    v.count = count;
+    v.stride = src->stride * (ptrdiff_t)factor;
+    *dst = v;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_apply(seq_op_type op, const seq_view_t *src, size_t param, double fill, seq_view_t *dst)
+{
+    switch (op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        return seq_view_pad_front(src, param, dst);
+    case SEQ_OP_PAD_BACK:
+        return seq_view_pad_back(src, param, dst);
+    case SEQ_OP_DELAY:
+        return seq_view_delay(src, param, fill, dst);
+    case SEQ_OP_ADVANCE:
+        return seq_view_advance(src, param, fill, dst);
+    case SEQ_OP_REVERSE:
+        return seq_view_reverse(src, dst);
+    case SEQ_OP_DOWNSAMPLE:
+        return seq_view_downsample(src, param, dst);
+    default:
+        break;
+    }
+    view_log_error("seq_view_apply: op computes samples, not a re-indexing op");
+    return SEQ_ERR_UNSUPPORTED;
+}
+
+seq_err_t seq_view_copy_into(const seq_view_t *v, double *out, size_t cap, size_t *n_out)
+{
+    if (!v || !n_out || (!out && v->length != 0))
+    {
+        view_log_error("seq_view_copy_into: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (cap < v->length)
+    {
+        view_log_error("seq_view_copy_into: output buffer too small");
+        return SEQ_ERR_ARG;
+    }
+
+    size_t i = 0;
+    while (i < v->lead)
+    {
+        out[i++] = v->lead_fill;
+    }
+
+    double *dst = out + v->lead;
+    const double *p = v->base;
+    size_t k = 0;
+    if (v->stride == 1)
+    {
+        while (k < v->count)
+        {
+            dst[k] = p[k];
+            k++;
+        }
+    }
+    else
+    {
+        while (k < v->count)
+        {
+            dst[k] = p[(ptrdiff_t)k * v->stride];
+            k++;
+        }
+    }
+
+    i = v->lead + v->count;
+    while (i < v->length)
+    {
+        out[i++] = v->tail_fill;
+    }
+    *n_out = v->length;
+    return SEQ_OK;
+}
+
+seq_err_t seq_view_materialize(const seq_view_t *v, seq_t *dst)
+{
+    if (!v || !dst)
+    {
+        view_log_error("seq_view_materialize: null pointer");
+        return SEQ_ERR_ARG;
+    }
+    if (!dst->data || dst->length != v->length)
+    {
+        seq_free(dst);
+        seq_err_t err = seq_alloc(dst, v->length);
+        if (err != SEQ_OK)
+        {
+            return err;
+        }
+    }
+
+    size_t n = 0;
+    return seq_view_copy_into(v, dst->data, dst->length, &n);
+}
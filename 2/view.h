@@ -0,0 +1,174 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+/**
+ * @file view.h
+ * @brief 零拷贝序列视图。Zero-copy sequence views.
+ *
+ * 视图由底层存储中的一段等间隔元素（起点、带符号步长、个数）和前后两段常数填充区组成，
+ * 因此补零、延迟、提前、反转与下采样都只改写几个字段，O(1) 完成且不触碰样本；串联多个操作后
+ * 只在 seq_view_copy_into / seq_view_materialize 时按一趟收集写出。
+ * A view is an evenly spaced run of elements in some storage (start, signed
+ * stride, count) framed by a constant fill region at each end, so padding,
+ * delay, advance, reverse and downsampling only rewrite a few fields in O(1)
+ * without touching samples; a chain of them is written out by a single
+ * gather pass in seq_view_copy_into / seq_view_materialize.
+ *
+ * @note 视图不拥有存储，期间底层序列不可释放或改动。两段填充值不同时仍可表示；
+ *       只有操作要求同一区域出现两种填充值（如对已有非零前部使用不同 fill 的延迟）时
+ *       返回 SEQ_ERR_UNSUPPORTED，此时应先物化再调用 seq_t 接口。
+ *       A view owns no storage; the underlying sequence must stay alive and
+ *       unchanged. The two fill values may differ; only an op that would need
+ *       two fill values in one region (e.g. delaying with a different fill
+ *       over an existing front region) returns SEQ_ERR_UNSUPPORTED, in which
+ *       case materialize first and use the seq_t API.
+ */
+
+#include <stddef.h>
+
+#include "sequence.h"
+
+/**
+ * @brief 序列视图：第 i 个元素在 i < lead 时为 lead_fill，lead <= i < lead + count 时为
+ *        base[(i - lead) * stride]，其余为 tail_fill。
+ *        Sequence view: element i is lead_fill for i < lead, base[(i - lead) * stride]
+ *        for lead <= i < lead + count, and tail_fill otherwise.
+ *
+ * @note 满足 lead + count <= length。Satisfies lead + count <= length.
+ */
+typedef struct
+{
+    const double *base; /**< 第 0 个存储元素。Stored element 0. */
+    ptrdiff_t stride;   /**< 相邻存储元素的间隔，可为负。Step between stored elements, may be negative. */
+    size_t count;       /**< 存储元素个数。Number of stored elements. */
+    size_t lead;        /**< 存储区之前的填充个数。Fill elements before the stored run. */
+    size_t length;      /**< 视图长度。View length. */
+    double lead_fill;   /**< 前部填充值。Front fill value. */
+    double tail_fill;   /**< 尾部填充值。Tail fill value. */
+} seq_view_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 以整个序列为视图。View a whole sequence.
+     *
+     * @param src [in] 输入序列。Input sequence.
+     * @param v [out] 视图。View.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_of(const seq_t *src, seq_view_t *v);
+
+    /**
+     * @brief 读取第 i 个元素。Read element i.
+     *
+     * @param v [in] 视图。View.
+     * @param i [in] 下标，须小于 v->length。Index, must be below v->length.
+     * @return 元素值。Element value.
+     */
+    double seq_view_get(const seq_view_t *v, size_t i);
+
+    /**
+     * @brief 前补零（O(1)）。Zero pad at front (O(1)).
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param zeros [in] 补零个数。Number of zeros to prepend.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK；已有非零前部填充时返回 SEQ_ERR_UNSUPPORTED。
+     *         SEQ_OK, or SEQ_ERR_UNSUPPORTED over a non-zero front fill.
+     */
+    seq_err_t seq_view_pad_front(const seq_view_t *src, size_t zeros, seq_view_t *dst);
+
+    /**
+     * @brief 后补零（O(1)）。Zero pad at back (O(1)).
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param zeros [in] 补零个数。Number of zeros to append.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK；已有非零尾部填充时返回 SEQ_ERR_UNSUPPORTED。
+     *         SEQ_OK, or SEQ_ERR_UNSUPPORTED over a non-zero tail fill.
+     */
+    seq_err_t seq_view_pad_back(const seq_view_t *src, size_t zeros, seq_view_t *dst);
+
+    /**
+     * @brief 延迟（O(1)）：y[n] = x[n-delay]，长度不变，与 seq_delay 一致。Delay (O(1)), same as seq_delay.
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param delay [in] 延迟样本数。Delay in samples.
+     * @param fill [in] 边界填充值。Boundary fill value.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_delay(const seq_view_t *src, size_t delay, double fill, seq_view_t *dst);
+
+    /**
+     * @brief 提前（O(1)）：y[n] = x[n+advance]，长度不变，与 seq_advance 一致。Advance (O(1)), same as seq_advance.
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param advance [in] 提前样本数。Advance in samples.
+     * @param fill [in] 边界填充值。Boundary fill value.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_advance(const seq_view_t *src, size_t advance, double fill, seq_view_t *dst);
+
+    /**
+     * @brief 反转（O(1)）：步长取负，前后填充对换。Reverse (O(1)): negated stride, fills swapped.
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_reverse(const seq_view_t *src, seq_view_t *dst);
+
+    /**
+     * @brief 下采样（O(1)）：步长乘以 factor，与 seq_downsample 一致。Downsample (O(1)), same as seq_downsample.
+     *
+     * @param src [in] 输入视图。Input view.
+     * @param factor [in] 下采样因子 (>0)。Downsampling factor (>0).
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_downsample(const seq_view_t *src, size_t factor, seq_view_t *dst);
+
+    /**
+     * @brief 按操作类型施加一个重排操作。Apply one re-indexing op by type.
+     *
+     * @param op [in] PAD_FRONT、PAD_BACK、DELAY、ADVANCE、REVERSE 或 DOWNSAMPLE。
+     *                PAD_FRONT, PAD_BACK, DELAY, ADVANCE, REVERSE or DOWNSAMPLE.
+     * @param src [in] 输入视图。Input view.
+     * @param param [in] 主参数，含义同 seq_apply_into。Main parameter, as in seq_apply_into.
+     * @param fill [in] DELAY / ADVANCE 的填充值。Fill value for DELAY / ADVANCE.
+     * @param dst [out] 输出视图，可与 src 相同。Output view, may be src.
+     * @return SEQ_OK；其余操作需要计算样本，返回 SEQ_ERR_UNSUPPORTED。
+     *         SEQ_OK; other ops compute samples and return SEQ_ERR_UNSUPPORTED.
+     */
+    seq_err_t seq_view_apply(seq_op_type op, const seq_view_t *src, size_t param, double fill, seq_view_t *dst);
+
+    /**
+     * @brief 一趟收集视图到调用方缓冲区。Gather a view into a caller buffer in one pass.
+     *
+     * @param v [in] 视图。View.
+     * @param out [out] 输出缓冲区，不可与视图存储重叠。Output buffer, must not overlap the view storage.
+     * @param cap [in] 缓冲区容量（样本数）。Buffer capacity in samples.
+     * @param n_out [out] 写出个数 (= v->length)。Samples written (= v->length).
+     * @return SEQ_OK；容量不足时返回 SEQ_ERR_ARG。SEQ_OK, or SEQ_ERR_ARG if cap is too small.
+     */
+    seq_err_t seq_view_copy_into(const seq_view_t *v, double *out, size_t cap, size_t *n_out);
+
+    /**
+     * @brief 物化为新序列（长度相同时复用 dst）。Materialize into a sequence (dst reused at equal length).
+     *
+     * @param v [in] 视图。View.
+     * @param dst [out] 输出序列，不可与视图存储重叠。Output sequence, must not overlap the view storage.
+     * @return SEQ_OK 或错误码。SEQ_OK or error code.
+     */
+    seq_err_t seq_view_materialize(const seq_view_t *v, seq_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VIEW_H */
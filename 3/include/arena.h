@@ -0,0 +1,45 @@
+/**
+ * @file arena.h
+ * @brief 线性内存池接口 (Linear memory arena interface)
+ *
+ * 分配只移动偏移量，复位一次性回收；主块不足时临时向堆申请溢出块，
+ * 复位时按峰值扩大主块，因此预热之后的稳态处理不再触碰堆。
+ * Allocation only bumps an offset and a reset reclaims everything at once.
+ * When the main block runs out, overflow blocks come from the heap and the
+ * reset grows the main block to the peak usage, so steady-state processing
+ * after warm-up never touches the heap.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/** 分配对齐（字节）/ Allocation alignment in bytes */
+#define ARENA_ALIGN 64
+
+/**
+ * @brief 内存池 / Memory arena
+ *
+ * @note 字段仅供实现使用 / fields are private to the implementation
+ */
+typedef struct
+{
+    unsigned char *base; /**< 主块 / main block */
+    size_t cap;          /**< 主块容量（字节）/ main block capacity in bytes */
+    size_t used;         /**< 主块已用字节 / bytes used in the main block */
+    void *overflow;      /**< 溢出块链表 / list of overflow blocks */
+    size_t spilled;      /**< 本轮溢出字节数 / bytes spilled this round */
+    size_t peak;         /**< 单轮最大用量 / peak usage of any round */
+} arena_t;
+
+/* === 接口声明 (Function declarations) === */
+int arena_init(arena_t *a, size_t bytes);
+void arena_free(arena_t *a);
+int arena_reset(arena_t *a);
+
+void *arena_alloc(arena_t *a, size_t bytes);
+size_t arena_mark(const arena_t *a);
+int arena_rewind(arena_t *a, size_t mark);
+
+#endif /* ARENA_H */
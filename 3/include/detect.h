@@ -0,0 +1,97 @@
+/**
+ * @file detect.h
+ * @brief 流式匹配滤波检测接口 / Streaming matched-filter detection interface
+ *
+ * 固定模板 t（长度 K）在流 x 中的每个完全重叠位置 p 上求 c[p] = Σ_m t[m]·x[p+m]，
+ * 以分块重叠保留 FFT 计算，并用窗口内 Σx、Σx² 的滑动和就地归一化为皮尔逊相关系数；
+ * 峰值经非极大抑制后按阈值逐个交给回调，或只保留得分最高的 top_k 个。
+ * 内存只与 K 和 top_k 有关，与流长无关，且只输出检测结果而不输出整条相关序列。
+ * For a fixed template t of length K, computes c[p] = Σ_m t[m]·x[p+m] at
+ * every fully overlapping position p of a stream x by blocked overlap-save
+ * FFT, normalizing it on the fly to a Pearson coefficient from sliding sums
+ * of Σx and Σx² over the window. Peaks go through non-maximum suppression
+ * and are handed to a sink one by one above a threshold, or only the top_k
+ * best are kept. Memory depends on K and top_k only, never on the stream
+ * length, and only detections are produced, not the whole correlation.
+ */
+
+#ifndef DETECT_H
+#define DETECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "seq.h"
+#include "fft.h"
+
+/** 块变换的最小长度 / Minimum block transform length */
+#define DETECT_MIN_FFT 4096
+
+/** 默认检测阈值（归一化得分）/ Default detection threshold (normalized score) */
+#define DETECT_THRESHOLD_DEFAULT 0.5
+
+/**
+ * @brief 一次检测 / One detection
+ */
+typedef struct
+{
+    uint64_t lag; /**< 模板起点在流中的下标 / stream index where the template starts */
+    double score; /**< 得分：归一化时为相关系数，否则同 dot / score: the coefficient when normalized, else dot */
+    double dot;   /**< 未归一化的 Σ t[m]·x[lag+m] / unnormalized Σ t[m]·x[lag+m] */
+} detect_hit_t;
+
+/**
+ * @brief 检测回调：按 lag 递增（top_k 时按得分递减）收到每个检测 /
+ *        Sink receiving each detection in increasing lag (decreasing score with top_k).
+ *
+ * @return 0 表示继续；非 0 表示中止 / 0 to continue; non-zero to abort.
+ */
+typedef int (*detect_sink_fn)(void *ctx, const detect_hit_t *hit);
+
+/**
+ * @brief 检测配置 / Detection settings
+ */
+typedef struct
+{
+    double threshold; /**< 得分不低于此值才算峰值 / peaks need a score of at least this */
+    size_t top_k;     /**< 0 表示逐个输出；否则只在结束时输出最高的 top_k 个 / 0 emits as found; else the best top_k at finish */
+    size_t min_sep;   /**< 峰值最小间隔，0 表示 K / minimum peak spacing, 0 for K */
+    int normalize;    /**< 非 0 时得分为皮尔逊相关系数 / non-zero scores by the Pearson coefficient */
+} detect_cfg_t;
+
+/**
+ * @brief 检测器状态 / Detector state
+ */
+typedef struct
+{
+    detect_cfg_t cfg;      /**< 配置（min_sep 已取定）/ settings, min_sep resolved */
+    detect_sink_fn sink;   /**< 检测回调 / detection sink */
+    void *ctx;             /**< 回调上下文 / sink context */
+    size_t k;              /**< 模板长度 / template length */
+    double t_mean;         /**< 模板均值 / template mean */
+    double t_m2;           /**< Σ(t - mean)² */
+    fft_plan_t plan;       /**< 块变换计划 / block transform plan */
+    fft_cpx_t *h;          /**< 反转模板的频谱 / spectrum of the reversed template */
+    fft_cpx_t *spec;       /**< 块频谱 / block spectrum */
+    fft_cpx_t *work;       /**< 变换工作区 / transform workspace */
+    double *buf;           /**< 当前块输入，前 K-1 个为上块尾部 / block input; first K-1 carry the previous tail */
+    double *y;             /**< 块卷积输出 / block convolution output */
+    size_t block;          /**< 每块位置数 / positions per block */
+    size_t fill;           /**< buf 中已有样本数 / samples in buf */
+    uint64_t base;         /**< buf[0] 在流中的下标 / stream index of buf[0] */
+    detect_hit_t pending;  /**< 待定峰值 / pending peak */
+    int has_pending;       /**< 是否有待定峰值 / whether a peak is pending */
+    detect_hit_t *best;    /**< top_k 最小堆 / min-heap of the top_k best */
+    size_t nbest;          /**< 堆中个数 / entries in the heap */
+    size_t emitted;        /**< 本次调用交给回调的个数 / hits sent to the sink in this call */
+    int finished;          /**< 已调用 detect_finish / detect_finish has run */
+} detect_t;
+
+/* === 接口声明 (Function declarations) === */
+void detect_cfg_default(detect_cfg_t *cfg);
+int detect_init(detect_t *d, const seq_t *tmpl, const detect_cfg_t *cfg, detect_sink_fn sink, void *ctx);
+void detect_free(detect_t *d);
+int detect_push(detect_t *d, const seq_sample_t *x, size_t n);
+int detect_finish(detect_t *d);
+
+#endif /* DETECT_H */
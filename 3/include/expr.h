@@ -0,0 +1,99 @@
+/**
+ * @file expr.h
+ * @brief 延迟求值的逐点表达式接口 / Lazily evaluated element-wise expression interface
+ *
+ * 先用 expr_leaf() 等构造表达式树，例如 diff(delay(a, d) * b + c)，再一次性求值：
+ * 求值器按 EXPR_BLOCK 个输出分块，每块自顶向下把整棵树算完再写出，中间结果只占
+ * 每个节点一块的暂存并留在缓存里，因此 k 个运算的内存读写与临时量从 O(k·N) 降到 O(N)。
+ * 叶子与不需要填充的平移直接引用原存储，不复制。
+ * Build an expression tree with expr_leaf() and friends, e.g.
+ * diff(delay(a, d) * b + c), then evaluate it in one go: the evaluator walks
+ * blocks of EXPR_BLOCK outputs and computes the whole tree per block before
+ * writing it out, so intermediates take one block of scratch per node and
+ * stay in cache, and memory traffic and temporaries drop from O(k·N) for k
+ * operations to O(N). Leaves and shifts that need no fill reference the
+ * storage as is.
+ *
+ * 逐点运算与 seq_add() / seq_mul() 逐位一致（长度取最短）；平移与差分的定义同 2/ 的
+ * seq_delay() / seq_advance() / seq_diff()（长度不变，x[-1] 视为 0）。
+ * Element-wise ops match seq_add() / seq_mul() bit for bit (the shortest
+ * length wins); shifts and differences follow seq_delay() / seq_advance() /
+ * seq_diff() in 2/ (length unchanged, x[-1] taken as 0).
+ */
+
+#ifndef EXPR_H
+#define EXPR_H
+
+#include <stddef.h>
+
+#include "seq.h"
+
+/** 每块输出数 / Outputs per evaluation block */
+#define EXPR_BLOCK 1024
+
+/**
+ * @brief 节点类型 / Node kind
+ */
+typedef enum
+{
+    EXPR_LEAF = 0, /**< 输入序列 / input sequence */
+    EXPR_ADD,      /**< a + b */
+    EXPR_SUB,      /**< a - b */
+    EXPR_MUL,      /**< a · b */
+    EXPR_SCALE,    /**< a · c（常数 / constant） */
+    EXPR_DELAY,    /**< y[n] = a[n - k]，越界为 fill / fill out of range */
+    EXPR_ADVANCE,  /**< y[n] = a[n + k]，越界为 fill / fill out of range */
+    EXPR_DIFF      /**< y[n] = a[n] - a[n - 1]，a[-1] = 0 */
+} expr_kind_t;
+
+/**
+ * @brief 表达式节点 / Expression node
+ */
+typedef struct
+{
+    expr_kind_t kind;    /**< 类型 / kind */
+    int a;               /**< 第一个子节点 / first child */
+    int b;               /**< 第二个子节点 / second child */
+    int has_parent;      /**< 是否已被引用 / whether a parent uses it */
+    const seq_t *leaf;   /**< 叶子的序列 / sequence of a leaf */
+    size_t shift;        /**< 平移量 / shift */
+    seq_sample_t value;  /**< 填充值或常数 / fill value or constant */
+    size_t length;       /**< 输出长度 / output length */
+    size_t need;         /**< 每块最多求值的个数 / most outputs evaluated per block */
+    seq_sample_t *buf;   /**< 块暂存（叶子为 NULL）/ block scratch (NULL for leaves) */
+} expr_node_t;
+
+/**
+ * @brief 表达式 / Expression
+ *
+ * 节点编号按创建顺序递增，子节点总是先于父节点创建。非叶子节点只能有一个父节点，
+ * 所以求值时每块每个节点只算一次；叶子可被任意多次引用。
+ * Node ids grow in creation order and children always precede their parent.
+ * A non-leaf node takes at most one parent, so every node is computed once
+ * per block; leaves may be referenced any number of times.
+ */
+typedef struct
+{
+    expr_node_t *nodes;  /**< 节点数组 / node array */
+    size_t count;        /**< 节点数 / node count */
+    size_t capacity;     /**< 数组容量 / array capacity */
+    seq_sample_t *work;  /**< 全部块暂存，求值之间复用 / all block scratch, reused across evaluations */
+    size_t work_len;     /**< 暂存样本数 / scratch samples */
+} expr_t;
+
+/* === 接口声明 (Function declarations) === */
+void expr_init(expr_t *e);
+void expr_free(expr_t *e);
+int expr_leaf(expr_t *e, const seq_t *s);
+int expr_add(expr_t *e, int a, int b);
+int expr_sub(expr_t *e, int a, int b);
+int expr_mul(expr_t *e, int a, int b);
+int expr_scale(expr_t *e, int a, seq_sample_t c);
+int expr_delay(expr_t *e, int a, size_t k, seq_sample_t fill);
+int expr_advance(expr_t *e, int a, size_t k, seq_sample_t fill);
+int expr_diff(expr_t *e, int a);
+size_t expr_length(const expr_t *e, int root);
+int expr_eval_into(expr_t *e, int root, seq_sample_t *out, size_t cap, size_t *n_out);
+int expr_eval(expr_t *e, int root, seq_t *out);
+
+#endif /* EXPR_H */
@@ -0,0 +1,55 @@
+/**
+ * @file fft.h
+ * @brief 实序列快速傅里叶变换接口 / Real-input fast Fourier transform interface
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stddef.h>
+
+/**
+ * @brief 复数样本 / Complex sample
+ */
+typedef struct
+{
+    double re; /**< 实部 / real part */
+    double im; /**< 虚部 / imaginary part */
+} fft_cpx_t;
+
+/** 最大分解因子个数 / Maximum number of radix factors */
+#define FFT_MAX_FACTORS 64
+
+/** 计划缓存槽位数 / Number of slots in the plan cache */
+#define FFT_CACHE_SIZE 16
+
+/**
+ * @brief FFT 计划 (FFT plan)
+ *
+ * @note 长度 n 的实变换由 n/2 点混合基 (4/2/3/5/通用) 复变换实现。
+ *       A length-n real transform is computed through an n/2-point
+ *       mixed-radix (4/2/3/5/generic) complex transform.
+ */
+typedef struct
+{
+    size_t n;                         /**< 实序列长度（偶数）/ real length (even) */
+    size_t half;                      /**< 复变换长度 n/2 / complex length n/2 */
+    size_t factors[FFT_MAX_FACTORS];  /**< 基分解 / radix factors of half */
+    size_t nfactors;                  /**< 因子个数 / number of factors */
+    fft_cpx_t *twiddle;               /**< e^{-2πik/half}, k < half */
+    fft_cpx_t *rtwiddle;              /**< e^{-2πik/n}, k < half */
+} fft_plan_t;
+
+/* === 接口声明 (Function declarations) === */
+int fft_plan_init(fft_plan_t *p, size_t n);
+void fft_plan_free(fft_plan_t *p);
+
+const fft_plan_t *fft_plan_get(size_t n);
+void fft_cache_clear(void);
+
+size_t fft_good_size(size_t n);
+
+int fft_rfft(const fft_plan_t *p, const double *in, fft_cpx_t *out, fft_cpx_t *work);
+int fft_irfft(const fft_plan_t *p, const fft_cpx_t *in, double *out, fft_cpx_t *work);
+
+#endif /* FFT_H */
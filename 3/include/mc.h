@@ -0,0 +1,49 @@
+/**
+ * @file mc.h
+ * @brief 多通道序列与批量卷积 / 相关接口 / Multichannel sequences and batch convolution / correlation
+ *
+ * 一次调用处理全部通道。交织布局的直接求和以通道为最内层循环（每个输出帧一组通道累加器），
+ * 可跨通道向量化；需要 FFT 的长卷积与平面布局逐通道调用单通道内核。
+ * One call covers every channel. Direct sums on the interleaved layout run
+ * with channels as the innermost loop (one vector of channel accumulators per
+ * output frame) and vectorize across channels; long convolutions that take
+ * the FFT and the planar layout call the single-channel kernels per channel.
+ */
+
+#ifndef MC_H
+#define MC_H
+
+#include <stddef.h>
+
+#include "ops.h"
+#include "seq.h"
+
+/**
+ * @brief 多通道数据布局 / Multichannel data layout
+ */
+typedef enum
+{
+    SEQ_MC_INTERLEAVED = 0, /**< 帧优先 data[n·C + c] / frame-major data[n·C + c] */
+    SEQ_MC_PLANAR           /**< 通道优先 data[c·length + n] / channel-major data[c·length + n] */
+} seq_mc_layout_t;
+
+/**
+ * @brief 多通道序列 (Multichannel sequence)
+ */
+typedef struct
+{
+    seq_sample_t *data;     /**< 数据指针 / pointer to data (length·channels samples) */
+    size_t length;          /**< 帧数 / number of frames (samples per channel) */
+    size_t channels;        /**< 通道数 / number of channels */
+    seq_mc_layout_t layout; /**< 数据布局 / data layout */
+} seq_mc_t;
+
+/* === 接口声明 (Function declarations) === */
+int seq_mc_init(seq_mc_t *m, size_t len, size_t channels, seq_mc_layout_t layout);
+void seq_mc_free(seq_mc_t *m);
+int seq_mc_channel(const seq_mc_t *m, size_t c, seq_t *view);
+
+int seq_mc_conv_linear(ops_ctx_t *ctx, const seq_mc_t *a, const seq_mc_t *b, seq_mc_t *out);
+int seq_mc_corr_cross(const seq_mc_t *a, const seq_mc_t *b, seq_mc_t *out);
+
+#endif /* MC_H */
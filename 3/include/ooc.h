@@ -0,0 +1,38 @@
+/**
+ * @file ooc.h
+ * @brief 超出内存的分块卷积接口 / Out-of-core chunked convolution interface
+ *
+ * 两条序列都留在文件中，按块读取并以频域分块重叠相加计算线性卷积，
+ * 结果经回调逐块写出，内存占用由块大小与缓存上限决定，与序列长度无关。
+ * Both sequences stay in the file; they are read block by block and the
+ * linear convolution is computed by frequency-domain block overlap-add.
+ * Results go to a sink callback block by block, so memory use is set by the
+ * block size and the cache limit rather than by the sequence lengths.
+ */
+
+#ifndef OOC_H
+#define OOC_H
+
+#include <stddef.h>
+
+#include "seq.h"
+#include "seqio.h"
+
+/** 默认块大小（样本数）/ Default block size in samples */
+#define OOC_BLOCK_DEFAULT ((size_t)1 << 15)
+
+/** 默认频谱缓存上限（字节）/ Default spectrum cache limit in bytes */
+#define OOC_CACHE_BYTES_DEFAULT ((size_t)256 << 20)
+
+/**
+ * @brief 输出回调：按顺序收到连续的输出样本 / Sink callback receiving consecutive output samples in order.
+ *
+ * @return 0 表示继续；非 0 表示中止 / 0 to continue; non-zero to abort.
+ */
+typedef int (*ooc_sink_fn)(void *ctx, const seq_sample_t *y, size_t n);
+
+/* === 接口声明 (Function declarations) === */
+int ooc_conv_linear(const seq_file_t *a, const seq_file_t *b, size_t block, size_t cache_bytes,
+                    ooc_sink_fn sink, void *ctx);
+
+#endif /* OOC_H */
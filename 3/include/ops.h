@@ -7,12 +7,117 @@
 #define OPS_H
 
 #include "seq.h"
+#include "arena.h"
+#include "fft.h"
+
+/**
+ * @brief FFT 快速路径的默认阈值 / Default threshold of the FFT fast path.
+ *
+ * 当 min(La, Lb)（线性卷积）或 N（圆周卷积）不小于阈值时，卷积改走 FFT：
+ * 结果与直接求和的差异在 |Δy[n]| ≤ 1e-13·‖a‖₂·‖b‖₂ 量级（N ≤ 2^24，double）。
+ * When min(La, Lb) (linear) or N (circular) reaches the threshold, convolution
+ * switches to the FFT; results match the direct sums within
+ * |Δy[n]| ≤ 1e-13·‖a‖₂·‖b‖₂ (N ≤ 2^24, double precision).
+ */
+#define OPS_FFT_THRESHOLD_DEFAULT 128
+
+/* FFT 阈值设置 / FFT threshold control (SIZE_MAX disables the fast path) */
+void ops_set_fft_threshold(size_t threshold);
+size_t ops_get_fft_threshold(void);
+
+/**
+ * @brief 分块 FFT 卷积的长度比 / Length ratio for the blocked FFT convolution.
+ *
+ * 长序列不短于短序列的该倍数时按块重叠保留，块长约为短序列长度的 OPS_FFT_BLOCK_FACTOR 倍。
+ * When the long input is at least this many times the short one, the FFT
+ * path runs block-wise overlap-save with blocks of about
+ * OPS_FFT_BLOCK_FACTOR times the short length.
+ */
+#define OPS_FFT_BLOCK_RATIO 4
+#define OPS_FFT_BLOCK_FACTOR 8
+
+/**
+ * @brief 拆分到多线程的最小工作量（乘加次数）/ Minimum work (multiply-adds) worth splitting across threads.
+ */
+#define OPS_PAR_MIN_WORK ((size_t)1 << 18)
+
+/* 线程数设置 / Thread count control (0 = all online CPUs, 1 = single-threaded) */
+int ops_set_threads(size_t nthreads);
+size_t ops_get_threads(void);
+
+/**
+ * @brief 运算上下文 / Operation context
+ *
+ * 持有 FFT 暂存区所用的内存池。同一上下文复用时，预热之后 *_into 不再做堆分配。
+ * 一个上下文同一时刻只能被一个线程使用。
+ * Owns the arena for FFT scratch. When one context is reused, the *_into
+ * calls stop allocating after warm-up. Use a context from one thread at a time.
+ */
+typedef struct
+{
+    arena_t arena; /**< 暂存内存池 / scratch arena */
+} ops_ctx_t;
+
+int ops_ctx_init(ops_ctx_t *ctx, size_t bytes);
+void ops_ctx_free(ops_ctx_t *ctx);
+int ops_ctx_reset(ops_ctx_t *ctx);
+int ops_ctx_seq(ops_ctx_t *ctx, size_t len, seq_t *s);
+
+/* 写入调用方缓冲区的变体 / Variants writing into caller-owned buffers (no output allocation) */
+int seq_add_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out);
+int seq_mul_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out);
+int seq_conv_linear_into(ops_ctx_t *ctx, const seq_t *a, const seq_t *b,
+                         seq_sample_t *out, size_t cap, size_t *n_out);
+int seq_conv_circular_into(ops_ctx_t *ctx, const seq_t *a, const seq_t *b,
+                           seq_sample_t *out, size_t cap, size_t *n_out);
+int seq_corr_cross_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out);
+
+/* 接受零拷贝视图的变体 / Variants taking zero-copy views (see seq_view_t) */
+int seq_conv_linear_view_into(ops_ctx_t *ctx, const seq_view_t *a, const seq_view_t *b,
+                              seq_sample_t *out, size_t cap, size_t *n_out);
+int seq_corr_cross_view_into(ops_ctx_t *ctx, const seq_view_t *a, const seq_view_t *b,
+                             seq_sample_t *out, size_t cap, size_t *n_out);
+
+/**
+ * @brief 固定核的卷积 / 互相关计划 (Convolution / cross-correlation plan for a fixed kernel)
+ *
+ * 初始化时复制核，并在 min(K, max_len) 达到 FFT 阈值时预先算好分块重叠保留所需的
+ * 私有变换计划（含旋转因子）、核频谱与全部暂存；之后每个新块的 seq_conv_plan_exec()
+ * 只做块变换本身，不分配内存。一个计划同一时刻只能被一个线程执行。
+ * Copies the kernel and, when min(K, max_len) reaches the FFT threshold,
+ * precomputes a private transform plan with its twiddles, the kernel
+ * spectrum and all scratch of the blocked overlap-save path; afterwards
+ * seq_conv_plan_exec() on each new block only runs the block transforms and
+ * never allocates. Execute a plan from one thread at a time.
+ */
+typedef struct
+{
+    seq_t kernel;          /**< 核副本（未反转）/ copy of the kernel (not reversed) */
+    size_t max_len;        /**< 最大块长 / maximum block length */
+    int correlate;         /**< 非 0 表示互相关 / non-zero for cross-correlation */
+    size_t threshold;      /**< 初始化时的 FFT 阈值 / FFT threshold at init */
+    fft_plan_t fft;        /**< 块变换计划，直接求和时 n 为 0 / block transform plan; n = 0 for direct sums */
+    fft_cpx_t *spec;       /**< 核频谱（互相关时为反转模板）/ kernel spectrum (reversed template for correlation) */
+    size_t block;          /**< 每块输出数 / outputs per block */
+    size_t span;           /**< 需经变换计算的输出数上限 / most outputs computed through the transform */
+    unsigned char *slots;  /**< 各并行块的暂存槽 / scratch slot per parallel chunk */
+    size_t slot_bytes;     /**< 暂存槽字节数 / bytes per slot */
+    size_t nslots;         /**< 暂存槽个数 / number of slots */
+    seq_sample_t *stage;   /**< 互相关的中间输出 / intermediate outputs of the correlation */
+} seq_conv_plan_t;
+
+int seq_conv_plan_init(seq_conv_plan_t *p, const seq_t *kernel, size_t max_len);
+int seq_corr_plan_init(seq_conv_plan_t *p, const seq_t *tmpl, size_t max_len);
+void seq_conv_plan_free(seq_conv_plan_t *p);
+int seq_conv_plan_exec(seq_conv_plan_t *p, const seq_t *x, seq_sample_t *out, size_t cap, size_t *n_out);
 
 /* 加法 / Addition */
 int seq_add(const seq_t *a, const seq_t *b, seq_t *out);
+int seq_add_inplace(seq_t *a, const seq_t *b);
 
 /* 乘法 / Multiplication */
 int seq_mul(const seq_t *a, const seq_t *b, seq_t *out);
+int seq_mul_inplace(seq_t *a, const seq_t *b);
 
 /* 线性卷积 / Linear convolution */
 int seq_conv_linear(const seq_t *a, const seq_t *b, seq_t *out);
@@ -26,4 +131,93 @@ int seq_corr_cross(const seq_t *a, const seq_t *b, seq_t *out);
 /* 滑动窗口归一化相关 / Normalized correlation (windowed) */
 int seq_corr_window_norm(const seq_window_t *wa, const seq_window_t *wb, seq_sample_t *out);
 
+/**
+ * @brief 零方差判定的相对容差 / Relative tolerance for the zero-variance test.
+ *
+ * 增量更新后 Σ(x-mx)² ≤ tol·Σx² 视为方差为 0。
+ * After incremental updates, Σ(x-mx)² ≤ tol·Σx² counts as zero variance.
+ */
+#define SEQ_CORR_ZERO_TOL 1e-20
+
+/**
+ * @brief 触发立即重同步的二阶矩骤降比例 / Moment collapse ratio that forces a resync.
+ *
+ * 单次更新后 Σ(x-mx)² 降到原值的该比例以下时，立即精确重算。
+ * If one update shrinks Σ(x-mx)² below this fraction of its previous value,
+ * the moments are recomputed exactly at once.
+ */
+#define SEQ_CORR_COLLAPSE 1e-6
+
+/**
+ * @brief 增量滑动窗口相关器 (Incremental sliding-window Pearson correlator)
+ *
+ * 维护窗口内的均值与中心化二阶矩 (Welford 增删更新)，每个样本 O(1)；
+ * 每 resync_period 次推入按窗口内容精确重算一次，以限制累积漂移。
+ * Keeps windowed means and centred second moments with Welford-style
+ * add/remove updates, O(1) per sample; every resync_period pushes they are
+ * recomputed exactly from the window contents to bound drift.
+ */
+typedef struct
+{
+    seq_mwindow_t wa;     /**< 窗口 A / window A */
+    seq_mwindow_t wb;     /**< 窗口 B / window B */
+    double mean_x;        /**< A 的均值 / mean of A */
+    double mean_y;        /**< B 的均值 / mean of B */
+    double m2x;           /**< Σ(x-mx)² */
+    double m2y;           /**< Σ(y-my)² */
+    double cxy;           /**< Σ(x-mx)(y-my) */
+    size_t since_sync;    /**< 距上次重同步的推入次数 / pushes since last resync */
+    size_t resync_period; /**< 重同步周期 / resync period in pushes */
+} seq_corr_stream_t;
+
+int seq_corr_stream_init(seq_corr_stream_t *cs, size_t capacity, size_t resync_period);
+void seq_corr_stream_free(seq_corr_stream_t *cs);
+int seq_corr_stream_push(seq_corr_stream_t *cs, seq_sample_t x, seq_sample_t y);
+int seq_corr_stream_get(const seq_corr_stream_t *cs, seq_sample_t *out);
+
+/**
+ * @brief 一组窗口统计量 (Statistics of one window)
+ */
+typedef struct
+{
+    size_t count; /**< 窗口内样本数 / samples in the window */
+    double mean;  /**< 均值 / mean */
+    double var;   /**< 总体方差 Σ(x-mean)²/n / population variance */
+    double rms;   /**< 均方根 sqrt(Σx²/n) / root mean square */
+    double min;   /**< 最小值 / minimum */
+    double max;   /**< 最大值 / maximum */
+} seq_winstat_result_t;
+
+/**
+ * @brief 滑动窗口统计引擎 (Streaming sliding-window statistics)
+ *
+ * 每推入一个样本一次性更新全部统计量：均值与二阶矩按 Welford 增删更新（与 seq_corr_stream_t 相同，
+ * 周期或骤降时精确重同步），最小与最大值各用一个单调队列（存绝对下标，值取自窗口），均摊 O(1)。
+ * Every push updates all statistics at once: the mean and second moment by
+ * Welford add/remove updates (as in seq_corr_stream_t, with periodic or
+ * collapse-triggered exact resyncs), and min and max by one monotonic deque
+ * each (holding absolute indices whose values live in the window), amortized O(1).
+ */
+typedef struct
+{
+    seq_mwindow_t w;      /**< 窗口 / window */
+    size_t *qmin;         /**< 最小值单调队列，w.size 个槽 / min deque, w.size slots */
+    size_t *qmax;         /**< 最大值单调队列，w.size 个槽 / max deque, w.size slots */
+    size_t qmin_head;     /**< 最小值队首（只增计数）/ min deque front, a growing counter */
+    size_t qmin_tail;     /**< 最小值队尾 / min deque back */
+    size_t qmax_head;     /**< 最大值队首 / max deque front */
+    size_t qmax_tail;     /**< 最大值队尾 / max deque back */
+    size_t t;             /**< 已推入的样本数，即下一个样本的绝对下标 / samples pushed, the next absolute index */
+    double mean;          /**< 均值 / mean */
+    double m2;            /**< Σ(x-mean)² */
+    size_t since_sync;    /**< 距上次重同步的推入次数 / pushes since last resync */
+    size_t resync_period; /**< 重同步周期 / resync period in pushes */
+} seq_winstat_t;
+
+int seq_winstat_init(seq_winstat_t *ws, size_t capacity, size_t resync_period);
+void seq_winstat_free(seq_winstat_t *ws);
+int seq_winstat_push(seq_winstat_t *ws, seq_sample_t x);
+int seq_winstat_push_n(seq_winstat_t *ws, const seq_sample_t *x, size_t n, seq_winstat_result_t *out);
+int seq_winstat_get(const seq_winstat_t *ws, seq_winstat_result_t *out);
+
 #endif /* OPS_H */
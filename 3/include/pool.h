@@ -0,0 +1,38 @@
+/**
+ * @file pool.h
+ * @brief 线程池接口 (Thread pool interface)
+ *
+ * 固定数量的工作线程按块领取 [0, n) 的下标区间，调用线程同样参与。
+ * 每块由哪个线程执行不影响结果：任务只写入自己负责的输出区间。
+ * A fixed set of workers claims index chunks of [0, n); the calling thread
+ * joins in. Which thread runs a chunk never affects the result, since a task
+ * only writes the outputs of its own range.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/**
+ * @brief 区间任务 / Range task
+ *
+ * @param ctx 用户上下文 / user context
+ * @param begin 起始下标（含）/ first index (inclusive)
+ * @param end 结束下标（不含）/ last index (exclusive)
+ * @return 0 表示成功；非 0 表示失败。/ 0 on success; non-zero on failure.
+ */
+typedef int (*pool_task_fn)(void *ctx, size_t begin, size_t end);
+
+/** 线程池（不透明）/ Opaque thread pool */
+typedef struct pool pool_t;
+
+/* === 接口声明 (Function declarations) === */
+pool_t *pool_create(size_t nthreads);
+void pool_destroy(pool_t *p);
+size_t pool_size(const pool_t *p);
+int pool_run(pool_t *p, size_t n, size_t grain, pool_task_fn fn, void *ctx);
+
+size_t pool_cpu_count(void);
+
+#endif /* POOL_H */
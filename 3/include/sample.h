@@ -0,0 +1,182 @@
+/**
+ * @file sample.h
+ * @brief 样本与累加器类型特化 (Sample and accumulator type specialization)
+ *
+ * 存储精度在编译期选定，三选一 / Storage precision, chosen at compile time:
+ *   - SEQ_PRECISION_DOUBLE（默认）：double
+ *   - SEQ_PRECISION_FLOAT        ：float
+ *   - SEQ_PRECISION_Q15          ：int16_t 定点，x = code / 32768，运算饱和
+ *                                  (int16_t fixed point, saturating arithmetic)
+ *
+ * 累加精度独立选定 / Accumulation precision, chosen independently:
+ *   - 浮点存储：SEQ_ACCUM_FLOAT / SEQ_ACCUM_DOUBLE（默认）/ SEQ_ACCUM_LONG_DOUBLE
+ *   - Q15 存储 ：SEQ_ACCUM_INT32（Q30，逐次饱和）/ SEQ_ACCUM_INT64（Q30，默认，仅输出时饱和）
+ *   For Q15, INT32 saturates on every accumulation, INT64 only when narrowed.
+ *
+ * 所有内核只通过本文件的内联函数访问样本，同一份源码即可编译出各精度版本。
+ * Kernels only touch samples through the inline helpers below, so one source
+ * builds every precision.
+ */
+
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <stdint.h>
+
+#if (defined(SEQ_PRECISION_FLOAT) + defined(SEQ_PRECISION_Q15) + defined(SEQ_PRECISION_DOUBLE)) > 1
+#error "sample.h: define at most one of SEQ_PRECISION_DOUBLE / SEQ_PRECISION_FLOAT / SEQ_PRECISION_Q15"
+#endif
+
+/* === 定点 Q15 (Fixed point Q15) === */
+#if defined(SEQ_PRECISION_Q15)
+
+typedef int16_t seq_sample_t;
+
+#define SEQ_PRECISION_NAME "q15"
+#define SEQ_SAMPLE_IS_FIXED 1
+#define SEQ_SAMPLE_IS_DOUBLE 0
+#define SEQ_ACCUM_IS_DOUBLE 0
+#define SEQ_Q15_ONE 32768.0
+
+#if defined(SEQ_ACCUM_INT32)
+typedef int32_t seq_accum_t;
+#elif defined(SEQ_ACCUM_INT64) || !(defined(SEQ_ACCUM_FLOAT) || defined(SEQ_ACCUM_DOUBLE) || defined(SEQ_ACCUM_LONG_DOUBLE))
+typedef int64_t seq_accum_t;
+#else
+#error "sample.h: Q15 storage needs SEQ_ACCUM_INT32 or SEQ_ACCUM_INT64"
+#endif
+
+/* 内部工具：饱和到 int16 / internal helper: saturate to int16 */
+static inline seq_sample_t seq_q15_sat(int64_t v)
+{
+    if (v > INT16_MAX)
+        return INT16_MAX;
+    if (v < INT16_MIN)
+        return INT16_MIN;
+    return (seq_sample_t)v;
+}
+
+/* 内部工具：Q30 四舍五入到 Q15（假定算术右移）/ round Q30 to Q15 (assumes arithmetic shift) */
+static inline seq_sample_t seq_q30_to_q15(int64_t v)
+{
+    return seq_q15_sat((v + (1 << 14)) >> 15);
+}
+
+static inline seq_sample_t seq_sample_from_double(double x)
+{
+    /* 四舍五入并饱和；NaN 记为 0 / round, saturate; NaN becomes 0 */
+    if (x != x)
+        return 0;
+    x *= SEQ_Q15_ONE;
+    if (x >= (double)INT16_MAX)
+        return INT16_MAX;
+    if (x <= (double)INT16_MIN)
+        return INT16_MIN;
+    return (seq_sample_t)((x >= 0.0) ? x + 0.5 : x - 0.5);
+}
+
+static inline double seq_sample_to_double(seq_sample_t x)
+{
+    return (double)x / SEQ_Q15_ONE;
+}
+
+static inline seq_sample_t seq_sample_add(seq_sample_t a, seq_sample_t b)
+{
+    return seq_q15_sat((int64_t)a + (int64_t)b);
+}
+
+static inline seq_sample_t seq_sample_sub(seq_sample_t a, seq_sample_t b)
+{
+    return seq_q15_sat((int64_t)a - (int64_t)b);
+}
+
+static inline seq_sample_t seq_sample_mul(seq_sample_t a, seq_sample_t b)
+{
+    return seq_q30_to_q15((int64_t)a * (int64_t)b);
+}
+
+static inline seq_accum_t seq_accum_mac(seq_accum_t acc, seq_sample_t a, seq_sample_t b)
+{
+#if defined(SEQ_ACCUM_INT32)
+    int64_t s = (int64_t)acc + (int64_t)((int32_t)a * (int32_t)b);
+    if (s > INT32_MAX)
+        return INT32_MAX;
+    if (s < INT32_MIN)
+        return INT32_MIN;
+    return (seq_accum_t)s;
+#else
+    return acc + (int64_t)((int32_t)a * (int32_t)b);
+#endif
+}
+
+static inline seq_sample_t seq_accum_to_sample(seq_accum_t acc)
+{
+    return seq_q30_to_q15((int64_t)acc);
+}
+
+/* === 浮点 (Floating point) === */
+#else
+
+#if defined(SEQ_PRECISION_FLOAT)
+typedef float seq_sample_t;
+#define SEQ_PRECISION_NAME "float"
+#define SEQ_SAMPLE_IS_DOUBLE 0
+#else
+typedef double seq_sample_t;
+#define SEQ_PRECISION_NAME "double"
+#define SEQ_SAMPLE_IS_DOUBLE 1
+#endif
+
+#define SEQ_SAMPLE_IS_FIXED 0
+
+#if defined(SEQ_ACCUM_FLOAT)
+typedef float seq_accum_t;
+#define SEQ_ACCUM_IS_DOUBLE 0
+#elif defined(SEQ_ACCUM_LONG_DOUBLE)
+typedef long double seq_accum_t;
+#define SEQ_ACCUM_IS_DOUBLE 0
+#elif defined(SEQ_ACCUM_DOUBLE) || !(defined(SEQ_ACCUM_INT32) || defined(SEQ_ACCUM_INT64))
+typedef double seq_accum_t;
+#define SEQ_ACCUM_IS_DOUBLE 1
+#else
+#error "sample.h: floating-point storage needs SEQ_ACCUM_FLOAT, SEQ_ACCUM_DOUBLE or SEQ_ACCUM_LONG_DOUBLE"
+#endif
+
+static inline seq_sample_t seq_sample_from_double(double x)
+{
+    return (seq_sample_t)x;
+}
+
+static inline double seq_sample_to_double(seq_sample_t x)
+{
+    return (double)x;
+}
+
+static inline seq_sample_t seq_sample_add(seq_sample_t a, seq_sample_t b)
+{
+    return a + b;
+}
+
+static inline seq_sample_t seq_sample_sub(seq_sample_t a, seq_sample_t b)
+{
+    return a - b;
+}
+
+static inline seq_sample_t seq_sample_mul(seq_sample_t a, seq_sample_t b)
+{
+    return a * b;
+}
+
+static inline seq_accum_t seq_accum_mac(seq_accum_t acc, seq_sample_t a, seq_sample_t b)
+{
+    return acc + (seq_accum_t)a * (seq_accum_t)b;
+}
+
+static inline seq_sample_t seq_accum_to_sample(seq_accum_t acc)
+{
+    return (seq_sample_t)acc;
+}
+
+#endif
+
+#endif /* SAMPLE_H */
@@ -8,7 +8,7 @@
 
 #include <stddef.h>
 
-typedef double seq_sample_t;
+#include "sample.h" /* seq_sample_t / seq_accum_t */
 
 /**
  * @brief 序列结构 (Sequence object)
@@ -30,6 +30,46 @@ typedef struct
     size_t count;      /**< 当前元素数量 / current element count */
 } seq_window_t;
 
+/**
+ * @brief 镜像滑动窗口 (Mirrored sliding window)
+ *
+ * 存储长度取不小于 capacity 的 2 的幂 size，下标以 mask 取低位；每个样本同时写入 buf[i] 与
+ * buf[i + size]，因此最新的 count 个样本总是 buf 中按时间顺序连续的一段，
+ * 窗口内核可以直接拿指针做普通（可向量化）的循环。
+ * The ring length size is the power of two not below capacity and indices
+ * take its low bits with mask; every sample is written to both buf[i] and
+ * buf[i + size], so the latest count samples are always one contiguous,
+ * time-ordered span of buf and windowed kernels can run plain (vectorizable)
+ * loops over a pointer.
+ */
+typedef struct
+{
+    seq_sample_t *buf; /**< 镜像存储，2 * size 个样本 / mirrored storage, 2 * size samples */
+    size_t size;       /**< 环长，2 的幂 / ring length, a power of two */
+    size_t mask;       /**< size - 1 */
+    size_t capacity;   /**< 最大窗口长度 / max window length */
+    size_t head;       /**< 下一个写入位置 / next write position */
+    size_t count;      /**< 当前元素数量 / current element count */
+} seq_mwindow_t;
+
+/**
+ * @brief 零拷贝序列视图 (Zero-copy sequence view)
+ *
+ * 第 i 个元素在 lead <= i < lead + count 时为 base[(i - lead) * stride]，其余为 0；
+ * 反转、下采样、平移与补零都只改写字段，O(1) 完成。视图不拥有存储。
+ * Element i is base[(i - lead) * stride] for lead <= i < lead + count and 0
+ * elsewhere; reverse, downsample, shift and padding only rewrite fields in
+ * O(1). A view owns no storage.
+ */
+typedef struct
+{
+    const seq_sample_t *base; /**< 第 0 个存储元素 / stored element 0 */
+    ptrdiff_t stride;         /**< 存储元素间隔，可为负 / step between stored elements, may be negative */
+    size_t count;             /**< 存储元素个数 / stored elements */
+    size_t lead;              /**< 存储区前的零个数 / zeros before the stored run */
+    size_t length;            /**< 视图长度，lead + count 之后补零 / view length, zeros after lead + count */
+} seq_view_t;
+
 /* === 接口声明 (Function declarations) === */
 int seq_init(seq_t *s, size_t len);
 void seq_free(seq_t *s);
@@ -39,4 +79,42 @@ void seq_window_free(seq_window_t *w);
 void seq_window_push(seq_window_t *w, seq_sample_t x);
 seq_sample_t seq_window_get(const seq_window_t *w, size_t i);
 
+int seq_mwindow_init(seq_mwindow_t *w, size_t capacity);
+void seq_mwindow_free(seq_mwindow_t *w);
+void seq_mwindow_push_n(seq_mwindow_t *w, const seq_sample_t *x, size_t n);
+
+int seq_view_of(seq_view_t *v, const seq_t *s);
+seq_sample_t seq_view_get(const seq_view_t *v, size_t i);
+int seq_view_reverse(seq_view_t *v);
+int seq_view_downsample(seq_view_t *v, size_t factor);
+int seq_view_shift(seq_view_t *v, ptrdiff_t k);
+int seq_view_pad(seq_view_t *v, size_t front, size_t back);
+int seq_view_copy_into(const seq_view_t *v, seq_sample_t *out, size_t cap, size_t *n_out);
+
+/**
+ * @brief 向镜像窗口推入一个样本，已满时挤出最旧样本 / Push one sample into a mirrored window, evicting the oldest when full.
+ *
+ * @param w 已初始化的窗口；热路径不做检查 / Initialized window; not checked on this hot path
+ * @param x 新样本 / New sample
+ */
+static inline void seq_mwindow_push(seq_mwindow_t *w, seq_sample_t x)
+{
+    w->buf[w->head] = x;
+    w->buf[w->head + w->size] = x;
+    w->head = (w->head + 1) & w->mask;
+    if (w->count < w->capacity)
+        w->count++;
+}
+
+/**
+ * @brief 窗口内容的连续视图，最旧在前，共 w->count 个 / Contiguous span of the window, oldest first, w->count samples.
+ *
+ * @param w 已初始化的窗口 / Initialized window
+ * @return 指向最旧样本的指针，下一次推入前有效 / Pointer to the oldest sample, valid until the next push
+ */
+static inline const seq_sample_t *seq_mwindow_data(const seq_mwindow_t *w)
+{
+    return w->buf + ((w->head - w->count) & w->mask);
+}
+
 #endif /* SEQ_H */
@@ -0,0 +1,91 @@
+/**
+ * @file seqio.h
+ * @brief 二进制与内存映射序列 I/O 接口 / Binary and memory-mapped sequence I/O interface
+ *
+ * 二进制格式：每条序列为 8 字节小端无符号长度，后接 length 个原始小端样本
+ * (float64 / float32 / int16)。int16 按整数值读写，写出时四舍五入并饱和；
+ * Q15 构建中 int16 直接为 Q15 码值。
+ * Binary layout: each sequence is an 8-byte little-endian unsigned length
+ * followed by that many raw little-endian samples (float64 / float32 / int16).
+ * int16 samples are taken at their integer value; output rounds and saturates.
+ * In Q15 builds int16 is the raw Q15 code.
+ *
+ * 格式与 seq_sample_t 布局一致时（double/f64、float/f32、Q15/s16）零拷贝。
+ * Input whose format matches the seq_sample_t layout (double/f64, float/f32,
+ * Q15/s16) is used without copying.
+ */
+
+#ifndef SEQIO_H
+#define SEQIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "seq.h"
+
+/**
+ * @brief 样本格式 / Sample format
+ */
+typedef enum
+{
+    SEQ_FMT_TEXT = 0, /**< 文本（现有格式）/ text (existing format) */
+    SEQ_FMT_F64,      /**< 小端 float64 / little-endian float64 */
+    SEQ_FMT_F32,      /**< 小端 float32 / little-endian float32 */
+    SEQ_FMT_S16       /**< 小端 int16 / little-endian int16 */
+} seq_fmt_t;
+
+/**
+ * @brief 二进制输入读取器 (Binary input reader)
+ *
+ * @note 输入为普通文件时整体 mmap，与 seq_sample_t 同布局的序列可直接指向映射（零拷贝）；
+ *       否则回退为带缓冲的 fread。
+ *       A regular-file input is mmap'ed as a whole and sequences matching the
+ *       seq_sample_t layout may point straight into the mapping (zero-copy);
+ *       otherwise buffered fread is used.
+ */
+typedef struct
+{
+    FILE *fp;           /**< 输入流 / input stream */
+    seq_fmt_t fmt;      /**< 样本格式 / sample format */
+    unsigned char *map; /**< 映射基址，未映射为 NULL / mapping base, NULL if unmapped */
+    size_t map_len;     /**< 映射长度 / mapping length */
+    size_t pos;         /**< 映射内读位置 / read offset inside the mapping */
+} seq_reader_t;
+
+/**
+ * @brief 文件中的序列 (File-backed sequence)
+ *
+ * 只记录位置，不载入数据；按需定位读取任意区间，内存占用与长度无关。
+ * Records the location only and loads nothing; any range is read on demand
+ * by seeking, so memory use does not depend on the length.
+ */
+typedef struct
+{
+    FILE *fp;        /**< 可定位的输入流 / seekable input stream */
+    seq_fmt_t fmt;   /**< 样本格式 / sample format */
+    uint64_t offset; /**< 首样本的字节偏移 / byte offset of the first sample */
+    uint64_t length; /**< 样本数 / number of samples */
+} seq_file_t;
+
+/* === 接口声明 (Function declarations) === */
+int seq_fmt_parse(const char *name, seq_fmt_t *fmt);
+size_t seq_fmt_size(seq_fmt_t fmt);
+void seq_io_binary_mode(FILE *fp);
+
+int seq_reader_open(seq_reader_t *r, FILE *fp, seq_fmt_t fmt);
+void seq_reader_close(seq_reader_t *r);
+int seq_reader_u64(seq_reader_t *r, uint64_t *v);
+int seq_reader_seq(seq_reader_t *r, seq_t *s);
+int seq_reader_samples(seq_reader_t *r, seq_sample_t *out, size_t cap, size_t *n);
+void seq_reader_release(const seq_reader_t *r, seq_t *s);
+
+int seq_file_open(seq_file_t *f, FILE *fp, seq_fmt_t fmt, uint64_t offset);
+uint64_t seq_file_end(const seq_file_t *f);
+int seq_file_read(const seq_file_t *f, uint64_t first, seq_sample_t *out, size_t n);
+
+int seq_io_write_u64(FILE *fp, uint64_t v);
+int seq_io_write(FILE *fp, seq_fmt_t fmt, const seq_sample_t *v, size_t n);
+int seq_io_write_seq(FILE *fp, seq_fmt_t fmt, const seq_t *s);
+
+#endif /* SEQIO_H */
@@ -0,0 +1,40 @@
+/**
+ * @file simd.h
+ * @brief 向量化 double 内核与运行时指令集分发 / Vectorized double kernels with runtime ISA dispatch
+ *
+ * 各指令集内核与标量实现逐位一致：每个输出按相同顺序累加，且不使用 FMA。
+ * Every ISA kernel is bit-identical to the scalar code: each output is
+ * accumulated in the same order and no FMA contraction is used.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+
+/**
+ * @brief 指令集 (Instruction set)
+ */
+typedef enum
+{
+    SIMD_ISA_SCALAR = 0, /**< 标量 / scalar */
+    SIMD_ISA_SSE2,       /**< x86 SSE2，2 路 / 2 lanes */
+    SIMD_ISA_AVX2,       /**< x86 AVX2，4 路 / 4 lanes */
+    SIMD_ISA_AVX512,     /**< x86 AVX-512F，8 路 / 8 lanes */
+    SIMD_ISA_NEON        /**< AArch64 NEON，2 路 / 2 lanes */
+} simd_isa_t;
+
+/* === 接口声明 (Function declarations) === */
+simd_isa_t simd_get_isa(void);
+int simd_set_isa(simd_isa_t isa);
+int simd_isa_supported(simd_isa_t isa);
+const char *simd_isa_name(simd_isa_t isa);
+int simd_isa_parse(const char *name, simd_isa_t *isa);
+
+void simd_add_f64(const double *a, const double *b, double *y, size_t n);
+void simd_mul_f64(const double *a, const double *b, double *y, size_t n);
+void simd_dot_tile_f64(const double *w, ptrdiff_t wstep, size_t taps,
+                       const double *x, ptrdiff_t xstep,
+                       double *y, size_t count);
+
+#endif /* SIMD_H */
@@ -0,0 +1,45 @@
+/**
+ * @file snapshot.h
+ * @brief 窗口与相关器状态的快照接口 (Snapshot interface for window and correlator state)
+ *
+ * 把滑动窗口、增量相关器与窗口统计的运行状态写成紧凑的二进制快照（编码见 ../common/snapio.h），
+ * 进程重启后恢复即可继续推入，结果与不中断运行逐位一致。快照只含运行状态：恢复目标须先以
+ * 相同的容量（及重同步周期）初始化；快照记录种类、样本精度与这些参数，不一致时拒绝恢复。
+ * Writes the running state of sliding windows, the incremental correlator
+ * and window statistics as a compact binary snapshot (encoding in
+ * ../common/snapio.h); after a restart, restoring it lets pushes continue
+ * with results bit-identical to an uninterrupted run. Snapshots hold running
+ * state only: the target must first be initialized with the same capacity
+ * (and resync period). The snapshot records its kind, the sample precision
+ * and these parameters and refuses to restore into anything else.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+
+#include "ops.h"
+#include "seq.h"
+
+/** 快照格式版本 / Snapshot format version */
+#define SNAPSHOT_VERSION 1
+
+/* === 接口声明 (Function declarations) === */
+size_t seq_window_snapshot_size(const seq_window_t *w);
+int seq_window_snapshot(const seq_window_t *w, unsigned char *buf, size_t cap, size_t *len);
+int seq_window_restore(seq_window_t *w, const unsigned char *buf, size_t len);
+
+size_t seq_mwindow_snapshot_size(const seq_mwindow_t *w);
+int seq_mwindow_snapshot(const seq_mwindow_t *w, unsigned char *buf, size_t cap, size_t *len);
+int seq_mwindow_restore(seq_mwindow_t *w, const unsigned char *buf, size_t len);
+
+size_t seq_corr_stream_snapshot_size(const seq_corr_stream_t *cs);
+int seq_corr_stream_snapshot(const seq_corr_stream_t *cs, unsigned char *buf, size_t cap, size_t *len);
+int seq_corr_stream_restore(seq_corr_stream_t *cs, const unsigned char *buf, size_t len);
+
+size_t seq_winstat_snapshot_size(const seq_winstat_t *ws);
+int seq_winstat_snapshot(const seq_winstat_t *ws, unsigned char *buf, size_t cap, size_t *len);
+int seq_winstat_restore(seq_winstat_t *ws, const unsigned char *buf, size_t len);
+
+#endif /* SNAPSHOT_H */
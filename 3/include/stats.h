@@ -0,0 +1,85 @@
+/**
+ * @file stats.h
+ * @brief 逐运算计数与计时接口 (Per-operation counters and timers interface)
+ *
+ * 记录每个运算的调用次数、输入输出样本数与耗时，以及 CLI 的解析、格式化和
+ * seq_init 的分配字节。运行时默认关闭，关闭时每个记录点只多一次分支；
+ * 以 -DSEQ_NO_STATS 编译则记录点完全消失。
+ * Records calls, input/output samples and time for every operation, plus
+ * CLI parsing, formatting and the bytes allocated by seq_init. Off at run
+ * time by default, costing one branch per record point; compiling with
+ * -DSEQ_NO_STATS removes the record points entirely.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief 统计项 / Statistics entry
+ */
+typedef enum
+{
+    STATS_ADD = 0,       /**< seq_add_into（含分配与原地版本）/ seq_add_into and its wrappers */
+    STATS_MUL,           /**< seq_mul_into 及其包装 / seq_mul_into and its wrappers */
+    STATS_CONV_LINEAR,   /**< seq_conv_linear_into、卷积计划及其包装 / seq_conv_linear_into, conv plans and wrappers */
+    STATS_CONV_CIRCULAR, /**< seq_conv_circular_into 及其包装 / seq_conv_circular_into and its wrappers */
+    STATS_CORR_CROSS,    /**< seq_corr_cross_into、相关计划及其包装 / seq_corr_cross_into, corr plans and wrappers */
+    STATS_CORR_WINDOW,   /**< seq_corr_window_norm */
+    STATS_CORR_STREAM,   /**< seq_corr_stream_push */
+    STATS_WINSTAT,       /**< seq_winstat_push / seq_winstat_push_n */
+    STATS_DETECT,        /**< detect_push / detect_finish */
+    STATS_EXPR,          /**< expr_eval_into 及其包装 / expr_eval_into and its wrapper */
+    STATS_IO_PARSE,      /**< 输入解码 / input decoding */
+    STATS_IO_FORMAT,     /**< 输出编码 / output encoding */
+    STATS_ALLOC,         /**< seq_init */
+    STATS_COUNT          /**< 统计项个数 / number of entries */
+} stats_id_t;
+
+/**
+ * @brief 一项统计 / One statistics entry
+ */
+typedef struct
+{
+    uint64_t calls;       /**< 调用次数 / calls */
+    uint64_t samples_in;  /**< 输入样本数 / input samples */
+    uint64_t samples_out; /**< 输出样本数 / output samples */
+    uint64_t bytes;       /**< 分配字节数（仅 alloc）/ bytes allocated (alloc only) */
+    uint64_t ns;          /**< 累计耗时（纳秒）/ accumulated time in ns */
+} stats_entry_t;
+
+/**
+ * @brief 事件回调：每次记录后以本次增量调用 / Event hook, called with the delta of every record
+ */
+typedef void (*stats_hook_fn)(void *ctx, const char *name, const stats_entry_t *delta);
+
+/**
+ * @brief 遍历回调：对每个非空统计项调用一次 / Visitor, called once per non-empty entry
+ */
+typedef void (*stats_visit_fn)(void *ctx, const char *name, const stats_entry_t *total);
+
+#ifndef SEQ_NO_STATS
+/** 开始计时，未启用时为 0 / Start timing; 0 when disabled */
+#define STATS_START() stats_start()
+/** 记录一次调用 / Record one call */
+#define STATS_RECORD(id, t0, n_in, n_out, bytes) stats_record((id), (t0), (n_in), (n_out), (bytes))
+#else
+#define STATS_START() ((uint64_t)0)
+#define STATS_RECORD(id, t0, n_in, n_out, bytes) ((void)(t0))
+#endif
+
+/* === 接口声明 (Function declarations) === */
+int stats_enable(int on);
+int stats_enabled(void);
+void stats_reset(void);
+void stats_set_hook(stats_hook_fn hook, void *ctx);
+void stats_visit(stats_visit_fn visit, void *ctx);
+void stats_dump(FILE *fp);
+
+uint64_t stats_start(void);
+void stats_record(stats_id_t id, uint64_t t0, size_t n_in, size_t n_out, size_t bytes);
+
+#endif /* STATS_H */
@@ -0,0 +1,101 @@
+/**
+ * @file tune.h
+ * @brief 卷积 / 相关内核的运行时调优与分发表 (Run-time tuning and dispatch table for convolution / correlation kernels)
+ *
+ * seq_conv_linear、seq_conv_circular 与 seq_corr_cross 各有直接求和（按构建与 CPU 选用向量内核）、
+ * 多线程直接求和与 FFT 几条路径，交叉点随机器、长度与精度而变。校准在本机上按长度网格
+ * （min(La, Lb) 与 max(La, Lb) 各按 2 的幂分档）逐档计时各路径，得到分发表并存入缓存文件；
+ * 之后的进程只需载入表，每次调用按两档长度 O(1) 查表，启动时不再计时。
+ * seq_conv_linear, seq_conv_circular and seq_corr_cross each have a direct
+ * path (vector kernels as the build and CPU allow), a threaded direct path
+ * and an FFT path, with crossovers that depend on the machine, the lengths
+ * and the precision. Calibration times every path over a length grid on
+ * this host (min(La, Lb) and max(La, Lb) each binned by powers of two) and
+ * yields a dispatch table that is saved to a cache file; later processes
+ * simply load it, and each call looks up its two length classes in O(1)
+ * without any timing at startup.
+ *
+ * 多通道接口（mc.h）按每个通道的长度查同一张表：表中为 DIRECT（或未装表时按内置规则走直接求和）
+ * 的交织输入一次覆盖全部通道，其余逐通道调用单通道接口，因此结果与逐通道调用逐位一致。
+ * The multichannel entry points (mc.h) look up the same table by the
+ * per-channel lengths: interleaved inputs whose cell is DIRECT (or that take
+ * direct sums under the built-in rules) are covered in one cross-channel
+ * pass, everything else calls the single-channel entry point per channel,
+ * so results stay bit-identical to per-channel calls.
+ *
+ * @note 表与精度、累加器、指令集和线程数绑定，载入时任一不符即拒绝，仍用内置阈值。
+ *       A table is tied to the precision, the accumulator, the ISA and the
+ *       thread count; loading refuses it if any differs, and the built-in
+ *       thresholds stay in use.
+ */
+
+#ifndef TUNE_H
+#define TUNE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** 缓存文件格式版本 / Cache file format version */
+#define TUNE_VERSION 1
+
+/** 长度分档数：第 c 档为 [2^c, 2^(c+1)) / Length classes: class c is [2^c, 2^(c+1)) */
+#define TUNE_CLASSES 32
+
+/** 默认校准的最大长度 / Default largest length calibrated */
+#define TUNE_MAX_LEN_DEFAULT ((size_t)1 << 14)
+
+/**
+ * @brief 可调优的运算 (Tunable operation)
+ */
+typedef enum
+{
+    TUNE_OP_CONV_LINEAR = 0, /**< seq_conv_linear */
+    TUNE_OP_CONV_CIRCULAR,   /**< seq_conv_circular */
+    TUNE_OP_CORR_CROSS,      /**< seq_corr_cross */
+    TUNE_OP_COUNT
+} tune_op_t;
+
+/**
+ * @brief 内核路径 (Kernel path)
+ */
+typedef enum
+{
+    TUNE_PATH_AUTO = 0, /**< 内置规则（FFT 阈值、OPS_PAR_MIN_WORK）/ built-in rules */
+    TUNE_PATH_DIRECT,   /**< 调用线程上直接求和 / direct sums on the calling thread */
+    TUNE_PATH_THREADED, /**< 拆到线程池的直接求和 / direct sums split across the pool */
+    TUNE_PATH_FFT,      /**< FFT（长短悬殊时分块）/ FFT, blocked for very unequal lengths */
+    TUNE_PATH_COUNT
+} tune_path_t;
+
+/**
+ * @brief 分发表 (Dispatch table)
+ *
+ * path[op][cmin][cmax] 为 min / max 长度分档下的最快路径，cmin ≤ cmax ≤ max_class；
+ * 超过 max_class 的长度按 max_class 查。圆周卷积只用 cmin == cmax。
+ * path[op][cmin][cmax] is the fastest path for the min / max length
+ * classes, cmin ≤ cmax ≤ max_class; longer lengths look up max_class.
+ * Circular convolution only uses cmin == cmax.
+ */
+typedef struct
+{
+    unsigned char path[TUNE_OP_COUNT][TUNE_CLASSES][TUNE_CLASSES]; /**< 路径 / paths */
+    uint32_t max_class;   /**< 已校准的最高档 / highest calibrated class */
+    uint32_t precision;   /**< 样本精度：0 double，1 float，2 Q15 / sample precision */
+    uint32_t accum_bytes; /**< sizeof(seq_accum_t) */
+    uint32_t isa;         /**< 校准时的 simd_isa_t / simd_isa_t at calibration */
+    uint64_t threads;     /**< 校准时的线程数 / thread count at calibration */
+} tune_table_t;
+
+/* === 接口声明 (Function declarations) === */
+int tune_calibrate(tune_table_t *t, size_t max_len, FILE *log);
+int tune_save(const tune_table_t *t, const char *path);
+int tune_load(tune_table_t *t, const char *path);
+int tune_check(const tune_table_t *t);
+void tune_install(const tune_table_t *t);
+void tune_print(const tune_table_t *t, FILE *fp);
+
+const char *tune_path_name(tune_path_t path);
+tune_path_t tune_path(tune_op_t op, size_t lmin, size_t lmax);
+
+#endif /* TUNE_H */
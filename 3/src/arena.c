@@ -0,0 +1,212 @@
+/**
+ * @file arena.c
+ * @brief 线性内存池实现 / Linear memory arena implementation
+ */
+
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief 溢出块头部，后接数据区 / Overflow block header, followed by the data
+ */
+typedef struct arena_spill
+{
+    struct arena_spill *next; /**< 下一块 / next block */
+} arena_spill_t;
+
+/* 内部工具：对齐 p 所需的填充字节 / padding needed to align p */
+static size_t arena_pad(const void *p)
+{
+    uintptr_t u = (uintptr_t)p;
+    return (size_t)((ARENA_ALIGN - (u % ARENA_ALIGN)) % ARENA_ALIGN);
+}
+
+/* 内部工具：释放全部溢出块 / free every overflow block */
+static void arena_free_spills(arena_t *a)
+{
+    arena_spill_t *s = (arena_spill_t *)a->overflow;
+    while (s != NULL)
+    {
+        arena_spill_t *next = s->next;
+        free(s);
+        s = next;
+    }
+    a->overflow = NULL;
+    a->spilled = 0;
+}
+
+/**
+ * @brief 初始化内存池 / Initialize an arena.
+ *
+ * @param a 内存池 / Arena
+ * @param bytes 主块初始容量，可为 0 / Initial main block capacity, may be 0
+ * @return 0 表示成功；非 0 表示参数非法或内存失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ */
+int arena_init(arena_t *a, size_t bytes)
+{
+    if (a == NULL)
+    {
+        fprintf(stderr, "arena_init: arena pointer is NULL.\n");
+        return -1;
+    }
+
+    a->base = NULL;
+    a->cap = 0;
+    a->used = 0;
+    a->overflow = NULL;
+    a->spilled = 0;
+    a->peak = 0;
+
+    if (bytes == 0)
+        return 0;
+
+    /* 多留一个对齐宽度，保证首个分配可对齐 / slack so the first allocation can be aligned */
+    a->base = (unsigned char *)malloc(bytes + ARENA_ALIGN);
+    if (a->base == NULL)
+    {
+        fprintf(stderr, "arena_init: failed to allocate %zu bytes.\n", bytes);
+        return -1;
+    }
+    a->cap = bytes + ARENA_ALIGN;
+    return 0;
+}
+
+/**
+ * @brief 释放内存池全部内存 / Free all memory of an arena.
+ *
+ * @param a 内存池，可为 NULL / Arena, may be NULL
+ */
+void arena_free(arena_t *a)
+{
+    if (a == NULL)
+        return;
+
+    arena_free_spills(a);
+    free(a->base);
+    a->base = NULL;
+    a->cap = 0;
+    a->used = 0;
+    a->peak = 0;
+}
+
+/**
+ * @brief 回收全部分配 / Reclaim every allocation.
+ *
+ * @param a 内存池 / Arena
+ * @return 0 表示成功；非 0 表示扩大主块失败（内存池仍可用）。
+ *         0 on success; non-zero if growing the main block failed (the arena stays usable).
+ *
+ * @note 之前分配的指针全部失效；本轮发生过溢出时主块扩大到峰值的 1.25 倍。
+ *       Every pointer handed out becomes invalid; if this round spilled, the
+ *       main block grows to 1.25 times the peak.
+ */
+int arena_reset(arena_t *a)
+{
+    return arena_rewind(a, 0);
+}
+
+/**
+ * @brief 分配 bytes 字节（不清零，ARENA_ALIGN 对齐）/ Allocate bytes (not zeroed, ARENA_ALIGN aligned).
+ *
+ * @param a 内存池 / Arena
+ * @param bytes 字节数 / Byte count
+ * @return 指针；失败返回 NULL。/ Pointer, or NULL on failure.
+ */
+void *arena_alloc(arena_t *a, size_t bytes)
+{
+    if (a == NULL)
+    {
+        fprintf(stderr, "arena_alloc: arena pointer is NULL.\n");
+        return NULL;
+    }
+    if (bytes == 0)
+        bytes = 1;
+
+    if (a->base != NULL)
+    {
+        size_t pad = arena_pad(a->base + a->used);
+        if (a->used + pad <= a->cap && bytes <= a->cap - a->used - pad)
+        {
+            void *p = a->base + a->used + pad;
+            a->used += pad + bytes;
+            return p;
+        }
+    }
+
+    /* 主块不足：溢出到堆，复位时合并 / main block exhausted: spill to the heap until the reset */
+    size_t head = sizeof(arena_spill_t) + ARENA_ALIGN;
+    if (bytes > SIZE_MAX - head)
+    {
+        fprintf(stderr, "arena_alloc: size overflow.\n");
+        return NULL;
+    }
+    arena_spill_t *s = (arena_spill_t *)malloc(head + bytes);
+    if (s == NULL)
+    {
+        fprintf(stderr, "arena_alloc: failed to allocate %zu bytes.\n", bytes);
+        return NULL;
+    }
+    s->next = (arena_spill_t *)a->overflow;
+    a->overflow = s;
+    a->spilled += bytes + ARENA_ALIGN;
+
+    unsigned char *data = (unsigned char *)(s + 1);
+    return data + arena_pad(data);
+}
+
+/**
+ * @brief 记录当前位置 / Record the current position.
+ *
+ * @param a 内存池 / Arena
+ * @return 供 arena_rewind 使用的标记 / Mark for arena_rewind
+ */
+size_t arena_mark(const arena_t *a)
+{
+    return (a == NULL) ? 0 : a->used;
+}
+
+/**
+ * @brief 回退到标记位置 / Rewind to a mark.
+ *
+ * @param a 内存池 / Arena
+ * @param mark arena_mark 的返回值 / Value returned by arena_mark
+ * @return 0 表示成功；非 0 表示参数非法或扩大主块失败。
+ *         0 on success; non-zero on invalid argument or failure to grow.
+ *
+ * @note 标记之后的主块分配失效；溢出块保留到回退至 0 为止（等同 arena_reset）。
+ *       Main-block allocations after the mark become invalid; overflow blocks
+ *       are kept until the arena rewinds to 0, which equals arena_reset.
+ */
+int arena_rewind(arena_t *a, size_t mark)
+{
+    if (a == NULL || mark > a->used)
+    {
+        fprintf(stderr, "arena_rewind: invalid arena or mark.\n");
+        return -1;
+    }
+
+    if (a->used + a->spilled > a->peak)
+        a->peak = a->used + a->spilled;
+    a->used = mark;
+
+    if (mark != 0 || a->overflow == NULL)
+        return 0;
+
+    /* 本轮溢出过：按峰值扩大主块，使下一轮不再溢出 / grow to the peak so the next round does not spill */
+    arena_free_spills(a);
+    size_t want = a->peak + a->peak / 4 + ARENA_ALIGN;
+    unsigned char *grown = (unsigned char *)malloc(want);
+    if (grown == NULL)
+    {
+        fprintf(stderr, "arena_rewind: failed to grow to %zu bytes.\n", want);
+        return -1;
+    }
+    free(a->base);
+    a->base = grown;
+    a->cap = want;
+    return 0;
+}
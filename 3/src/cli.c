@@ -7,14 +7,84 @@
  * invoking operation functions and printing results.
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "cli.h"
 #include "seq.h"
+#include "detect.h"
+#include "ooc.h"
 #include "ops.h"
+#include "seqio.h"
+#include "simd.h"
+#include "stats.h"
+#include "tune.h"
+#include "numtext.h"
+#include "ring.h"
 
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/* 二进制模式下 stdin/stdout 的缓冲大小 / stdio buffer size in binary mode */
+#define CLI_IO_BUFFER (1 << 20)
+
+/* corr-window 每批读取的样本对数 / pairs per batch in corr-window */
+#define CLI_PAIR_BLOCK 4096
+
+/* corr-window 流水线每个环的块数 / blocks per ring of the corr-window pipeline */
+#define CLI_PIPE_DEPTH 8
+
+/* corr-window 的一个结果 / one corr-window result */
+typedef struct
+{
+    seq_sample_t rho; /**< 相关系数 / coefficient */
+    int rc;           /**< seq_corr_stream_get() 的返回值 / return value of seq_corr_stream_get() */
+} cli_rho_t;
+
+/* win-stats 模式每批推入的样本数 / samples per push in win-stats mode */
+#define CLI_WINSTAT_BLOCK 4096
+
+/* detect 模式每批推入的样本数 / samples per push in detect mode */
+#define CLI_DETECT_BLOCK 4096
+
+/* 输入/输出样本格式 / input and output sample formats */
+static seq_fmt_t cli_in_fmt = SEQ_FMT_TEXT;
+static seq_fmt_t cli_out_fmt = SEQ_FMT_TEXT;
+
+/* 二进制输入读取器 / binary input reader */
+static seq_reader_t cli_reader;
+
+/* 文本输入的记号读取器与输出有效位数 / token reader for text input and significant digits of text output */
+static num_reader_t cli_text;
+#define CLI_TEXT_DIGITS 10
+
+/* 超出内存模式与块大小 / out-of-core mode and block size */
+static int cli_ooc = 0;
+static size_t cli_chunk = 0;
+
+/* 结束时在 stderr 输出统计 / print statistics to stderr at exit */
+static int cli_stats = 0;
+
+/* detect 模式的配置及是否给出了其选项 / detect settings and whether any of their options was given */
+static detect_cfg_t cli_detect = {DETECT_THRESHOLD_DEFAULT, 0, 0, 1};
+static int cli_detect_opts = 0;
+
+/* 分发表缓存文件与校准的最大长度（0 为默认）/ dispatch table cache file and largest calibrated length (0 = default) */
+static const char *cli_tune_file = NULL;
+static size_t cli_tune_max = 0;
+
 /* ==== 内部函数声明 / Internal function declarations ==== */
 
 static void cli_print_usage(const char *prog);
@@ -22,12 +92,21 @@ static void cli_print_usage(const char *prog);
 static int cli_mode_add(void);
 static int cli_mode_mul(void);
 static int cli_mode_conv_linear(void);
+static int cli_mode_conv_linear_ooc(void);
 static int cli_mode_conv_circular(void);
 static int cli_mode_corr(void);
 static int cli_mode_corr_window(void);
+static int cli_mode_win_stats(void);
+static int cli_mode_detect(void);
+static int cli_mode_calibrate(void);
+
+static int cli_parse_options(int *argc, char **argv);
+static int cli_dispatch(const char *mode, const char *prog);
+static void cli_load_tune(void);
 
 static int cli_read_seq(seq_t *s);
 static int cli_read_two_seqs(seq_t *a, seq_t *b);
+static void cli_free_input(seq_t *s);
 static void cli_print_seq(const seq_t *s);
 
 /**
@@ -42,14 +121,185 @@ static void cli_print_seq(const seq_t *s);
  */
 int cli_run(int argc, char **argv)
 {
-    if (argc < 2)
+    if (cli_parse_options(&argc, argv) != 0 || argc < 2)
     {
         cli_print_usage(argv[0]);
         return 1;
     }
 
-    const char *mode = argv[1];
+    if (cli_ooc && strcmp(argv[1], "conv-linear") != 0)
+    {
+        fprintf(stderr, "--ooc is only supported by conv-linear.\n");
+        return 1;
+    }
+    if (cli_detect_opts && strcmp(argv[1], "detect") != 0)
+    {
+        fprintf(stderr, "--threshold, --top, --sep and --raw are only supported by detect.\n");
+        return 1;
+    }
+    if (cli_ooc && cli_in_fmt == SEQ_FMT_TEXT)
+    {
+        fprintf(stderr, "--ooc needs a binary input format.\n");
+        return 1;
+    }
+    if (cli_tune_max > 0 && strcmp(argv[1], "calibrate") != 0)
+    {
+        fprintf(stderr, "--tune-max is only supported by calibrate.\n");
+        return 1;
+    }
+    if (cli_tune_file != NULL && strcmp(argv[1], "calibrate") != 0)
+        cli_load_tune();
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        seq_io_binary_mode(stdout);
+        setvbuf(stdout, NULL, _IOFBF, CLI_IO_BUFFER);
+    }
+    if (cli_ooc)
+    {
+        /* 按块定位读取，不用大缓冲也不建读取器 / blocks are read by seeking: no big buffer, no reader */
+        seq_io_binary_mode(stdin);
+    }
+    else if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        seq_io_binary_mode(stdin);
+        setvbuf(stdin, NULL, _IOFBF, CLI_IO_BUFFER);
+        if (seq_reader_open(&cli_reader, stdin, cli_in_fmt) != 0)
+            return 1;
+    }
+    else if (num_reader_init(&cli_text, stdin, 0) != 0)
+    {
+        return 1;
+    }
+
+    int rc = cli_dispatch(argv[1], argv[0]);
 
+    if (cli_in_fmt != SEQ_FMT_TEXT && !cli_ooc)
+        seq_reader_close(&cli_reader);
+    num_reader_free(&cli_text);
+    ops_set_threads(1); /* 回收工作线程 / join the workers */
+    if (cli_stats)
+    {
+        fflush(stdout);
+        stats_dump(stderr);
+    }
+    return rc;
+}
+
+/**
+ * @brief 解析并移除 --format、--simd 等选项 / Parse and strip --format, --simd and similar options.
+ *
+ * @param argc 参数个数，返回剩余个数 / Argument count, updated to the remaining count.
+ * @param argv 参数数组，原地压缩 / Argument vector, compacted in place.
+ * @return 0 表示成功；非 0 表示未知选项或格式。
+ *         0 on success; non-zero on an unknown option or format.
+ */
+static int cli_parse_options(int *argc, char **argv)
+{
+    int kept = 1;
+
+    for (int i = 1; i < *argc; ++i)
+    {
+        const char *arg = argv[i];
+        seq_fmt_t fmt;
+        simd_isa_t isa;
+
+        if (strncmp(arg, "--", 2) != 0)
+            argv[kept++] = argv[i];
+        else if (strncmp(arg, "--format=", 9) == 0 && seq_fmt_parse(arg + 9, &fmt) == 0)
+            cli_in_fmt = cli_out_fmt = fmt;
+        else if (strncmp(arg, "--in-format=", 12) == 0 && seq_fmt_parse(arg + 12, &fmt) == 0)
+            cli_in_fmt = fmt;
+        else if (strncmp(arg, "--out-format=", 13) == 0 && seq_fmt_parse(arg + 13, &fmt) == 0)
+            cli_out_fmt = fmt;
+        else if (strncmp(arg, "--threads=", 10) == 0 && isdigit((unsigned char)arg[10]))
+        {
+            if (ops_set_threads((size_t)strtoul(arg + 10, NULL, 10)) != 0)
+                return -1;
+        }
+        else if (strcmp(arg, "--ooc") == 0)
+            cli_ooc = 1;
+        else if (strncmp(arg, "--tune=", 7) == 0 && arg[7] != '\0')
+            cli_tune_file = arg + 7;
+        else if (strncmp(arg, "--tune-max=", 11) == 0 && isdigit((unsigned char)arg[11]))
+        {
+            cli_tune_max = (size_t)strtoul(arg + 11, NULL, 10);
+            if (cli_tune_max == 0)
+            {
+                fprintf(stderr, "Calibration length must be positive: %s\n", arg);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--stats") == 0)
+        {
+            if (stats_enable(1) != 0)
+            {
+                fprintf(stderr, "--stats is not available in this build.\n");
+                return -1;
+            }
+            cli_stats = 1;
+        }
+        else if (strncmp(arg, "--chunk=", 8) == 0 && isdigit((unsigned char)arg[8]))
+        {
+            cli_chunk = (size_t)strtoul(arg + 8, NULL, 10);
+            if (cli_chunk == 0)
+            {
+                fprintf(stderr, "Block size must be positive: %s\n", arg);
+                return -1;
+            }
+        }
+        else if (strncmp(arg, "--threshold=", 12) == 0)
+        {
+            if (num_parse_double(arg + 12, strlen(arg + 12), &cli_detect.threshold) != 0)
+            {
+                fprintf(stderr, "Invalid threshold: %s\n", arg);
+                return -1;
+            }
+            cli_detect_opts = 1;
+        }
+        else if (strncmp(arg, "--top=", 6) == 0 && isdigit((unsigned char)arg[6]))
+        {
+            cli_detect.top_k = (size_t)strtoul(arg + 6, NULL, 10);
+            cli_detect_opts = 1;
+        }
+        else if (strncmp(arg, "--sep=", 6) == 0 && isdigit((unsigned char)arg[6]))
+        {
+            cli_detect.min_sep = (size_t)strtoul(arg + 6, NULL, 10);
+            cli_detect_opts = 1;
+        }
+        else if (strcmp(arg, "--raw") == 0)
+        {
+            cli_detect.normalize = 0;
+            cli_detect_opts = 1;
+        }
+        else if (strncmp(arg, "--simd=", 7) == 0 && simd_isa_parse(arg + 7, &isa) == 0)
+        {
+            if (simd_set_isa(isa) != 0)
+            {
+                fprintf(stderr, "SIMD kernel set not supported on this CPU: %s\n", arg + 7);
+                return -1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option or sample format: %s\n", arg);
+            return -1;
+        }
+    }
+
+    *argc = kept;
+    return 0;
+}
+
+/**
+ * @brief 按模式名分发 / Dispatch on the mode name.
+ *
+ * @param mode 模式名 / Mode name.
+ * @param prog 程序名 / Program name.
+ * @return 进程退出码 / Process exit code.
+ */
+static int cli_dispatch(const char *mode, const char *prog)
+{
     if (strcmp(mode, "add") == 0)
     {
         return cli_mode_add();
@@ -60,7 +310,7 @@ int cli_run(int argc, char **argv)
     }
     else if (strcmp(mode, "conv-linear") == 0)
     {
-        return cli_mode_conv_linear();
+        return cli_ooc ? cli_mode_conv_linear_ooc() : cli_mode_conv_linear();
     }
     else if (strcmp(mode, "conv-circular") == 0)
     {
@@ -74,10 +324,22 @@ int cli_run(int argc, char **argv)
     {
         return cli_mode_corr_window();
     }
+    else if (strcmp(mode, "win-stats") == 0)
+    {
+        return cli_mode_win_stats();
+    }
+    else if (strcmp(mode, "detect") == 0)
+    {
+        return cli_mode_detect();
+    }
+    else if (strcmp(mode, "calibrate") == 0)
+    {
+        return cli_mode_calibrate();
+    }
     else
     {
         fprintf(stderr, "Unknown mode: %s\n", mode);
-        cli_print_usage(argv[0]);
+        cli_print_usage(prog);
         return 1;
     }
 }
@@ -90,7 +352,28 @@ int cli_run(int argc, char **argv)
 static void cli_print_usage(const char *prog)
 {
     fprintf(stderr,
-            "Usage: %s [mode]\n"
+            "Usage: %s [options] [mode]\n"
+            "Options:\n"
+            "  --format=FMT      input and output sample format\n"
+            "  --in-format=FMT   input sample format\n"
+            "  --out-format=FMT  output sample format\n"
+            "  FMT: text (default), f64, f32, s16\n"
+            "  --threads=N       worker threads for conv/corr (0 = all CPUs, default 1)\n"
+            "  --simd=ISA        force kernels: scalar, sse2, avx2, avx512, neon\n"
+            "                    (default: widest supported by the CPU)\n"
+            "  --ooc             conv-linear out of core: both sequences stay in the\n"
+            "                    input file (binary, redirected from a regular file)\n"
+            "  --chunk=N         block size in samples for --ooc (default 32768)\n"
+            "  --stats           print per-operation counters and timings to stderr\n"
+            "  --tune=FILE       pick conv/corr kernels (single and multichannel) from a\n"
+            "                    calibrated dispatch table\n"
+            "                    (calibrate: the file to write)\n"
+            "  --tune-max=N      calibrate: largest length timed (default 16384)\n"
+            "  --threshold=X     detect: minimum peak score (default 0.5)\n"
+            "  --top=K           detect: only report the K best peaks, at EOF\n"
+            "  --sep=N           detect: minimum peak spacing (default: template length)\n"
+            "  --raw             detect: score by the raw matched-filter output\n"
+            "                    instead of the normalized correlation\n"
             "Modes:\n"
             "  add             Point-wise addition of two sequences\n"
             "  mul             Point-wise multiplication of two sequences\n"
@@ -98,6 +381,10 @@ static void cli_print_usage(const char *prog)
             "  conv-circular   Circular convolution of two sequences (same length)\n"
             "  corr            Cross-correlation of two sequences\n"
             "  corr-window     Streaming normalized correlation using sliding windows\n"
+            "  win-stats       Streaming mean, variance, RMS, min and max over a window\n"
+            "  detect          Streaming matched-filter detection of a template\n"
+            "  calibrate       Time the conv/corr kernels on this host and save the\n"
+            "                  dispatch table to --tune=FILE (no input)\n"
             "\n"
             "Input format for two-sequence modes:\n"
             "  <len_a> a0 a1 ... a(len_a-1)\n"
@@ -107,7 +394,26 @@ static void cli_print_usage(const char *prog)
             "  <win_size>\n"
             "  ax0 bx0\n"
             "  ax1 bx1\n"
-            "  ... (pairs until EOF)\n",
+            "  ... (pairs until EOF)\n"
+            "\n"
+            "For win-stats mode:\n"
+            "  <win_size>\n"
+            "  x0 x1 x2 ... (stream samples until EOF)\n"
+            "  output: one \"mean var rms min max\" line per sample\n"
+            "\n"
+            "For detect mode:\n"
+            "  <len_t> t0 t1 ... t(len_t-1)\n"
+            "  x0 x1 x2 ... (stream samples until EOF)\n"
+            "  output: one \"<lag> <score>\" text line per detection\n"
+            "\n"
+            "Binary formats (raw little-endian samples):\n"
+            "  sequence    : u64 length, then length samples\n"
+            "  corr-window : u64 win_size, then interleaved a,b samples until EOF;\n"
+            "                output is one sample per pair (NaN when undefined)\n"
+            "  win-stats   : u64 win_size, then samples until EOF;\n"
+            "                output is mean, var, rms, min, max per sample\n"
+            "  detect      : template as a sequence, then samples until EOF;\n"
+            "                detections are always written as text\n",
             prog);
 }
 
@@ -122,11 +428,23 @@ static void cli_print_usage(const char *prog)
  *
  * @note 输入格式:
  *       <len> v0 v1 ... v(len-1)
+ *       二进制格式为 u64 长度加原始样本，见 seqio.h。
+ *       Binary formats use a u64 length plus raw samples, see seqio.h.
  */
 static int cli_read_seq(seq_t *s)
 {
+    const uint64_t t0 = STATS_START();
+
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        if (seq_reader_seq(&cli_reader, s) != 0)
+            return -1;
+        STATS_RECORD(STATS_IO_PARSE, t0, s->length, 0, 0);
+        return 0;
+    }
+
     size_t len = 0;
-    if (scanf("%zu", &len) != 1)
+    if (num_read_size(&cli_text, &len) != 0)
     {
         fprintf(stderr, "Failed to read sequence length.\n");
         return -1;
@@ -141,15 +459,16 @@ static int cli_read_seq(seq_t *s)
     for (size_t i = 0; i < len; ++i)
     {
         double v;
-        if (scanf("%lf", &v) != 1)
+        if (num_read_double(&cli_text, &v) != 0)
         {
             fprintf(stderr, "Failed to read sequence element at index %zu.\n", i);
             seq_free(s);
             return -1;
         }
-        s->data[i] = (seq_sample_t)v;
+        s->data[i] = seq_sample_from_double(v);
     }
 
+    STATS_RECORD(STATS_IO_PARSE, t0, len, 0, 0);
     return 0;
 }
 
@@ -167,13 +486,23 @@ static int cli_read_two_seqs(seq_t *a, seq_t *b)
 
     if (cli_read_seq(b) != 0)
     {
-        seq_free(a);
+        cli_free_input(a);
         return -1;
     }
 
     return 0;
 }
 
+/**
+ * @brief 释放输入序列（可能指向输入映射）/ Free an input sequence, which may live in the input mapping.
+ *
+ * @param s 输入序列 / Input sequence.
+ */
+static void cli_free_input(seq_t *s)
+{
+    seq_reader_release(&cli_reader, s);
+}
+
 /**
  * @brief 打印序列到标准输出 / Print sequence to stdout.
  *
@@ -184,6 +513,8 @@ static int cli_read_two_seqs(seq_t *a, seq_t *b)
  *       第二行: 所有元素（空格分隔）
  *       First line: length
  *       Second line: elements separated by spaces.
+ *       二进制输出格式下写出 u64 长度加原始样本。
+ *       With a binary output format a u64 length and raw samples are written.
  */
 static void cli_print_seq(const seq_t *s)
 {
@@ -193,14 +524,29 @@ static void cli_print_seq(const seq_t *s)
         return;
     }
 
+    const uint64_t t0 = STATS_START();
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        if (seq_io_write_seq(stdout, cli_out_fmt, s) != 0)
+            fprintf(stderr, "cli_print_seq: write failed.\n");
+        STATS_RECORD(STATS_IO_FORMAT, t0, 0, s->length, 0);
+        return;
+    }
+
+    num_writer_t w;
     printf("%zu\n", s->length);
+    num_writer_init(&w, stdout);
     for (size_t i = 0; i < s->length; ++i)
     {
-        printf("%.10g", (double)s->data[i]);
+        num_write_g(&w, seq_sample_to_double(s->data[i]), CLI_TEXT_DIGITS);
         if (i + 1 < s->length)
-            printf(" ");
+            num_write_char(&w, ' ');
     }
-    printf("\n");
+    num_write_char(&w, '\n');
+    if (num_writer_flush(&w) != 0)
+        fprintf(stderr, "cli_print_seq: write failed.\n");
+    STATS_RECORD(STATS_IO_FORMAT, t0, 0, s->length, 0);
 }
 
 /* ==== 各模式实现 / Mode handlers ==== */
@@ -210,24 +556,24 @@ static void cli_print_seq(const seq_t *s)
  */
 static int cli_mode_add(void)
 {
-    seq_t a = {0}, b = {0}, out = {0};
+    seq_t a = {0}, b = {0};
 
     if (cli_read_two_seqs(&a, &b) != 0)
         return 1;
 
-    if (seq_add(&a, &b, &out) != 0)
+    /* 结果写回 a，不再分配输出 / the result overwrites a, no output allocation */
+    if (seq_add_inplace(&a, &b) != 0)
     {
         fprintf(stderr, "Add operation failed.\n");
-        seq_free(&a);
-        seq_free(&b);
+        cli_free_input(&a);
+        cli_free_input(&b);
         return 1;
     }
 
-    cli_print_seq(&out);
+    cli_print_seq(&a);
 
-    seq_free(&a);
-    seq_free(&b);
-    seq_free(&out);
+    cli_free_input(&a);
+    cli_free_input(&b);
     return 0;
 }
 
@@ -236,24 +582,24 @@ static int cli_mode_add(void)
  */
 static int cli_mode_mul(void)
 {
-    seq_t a = {0}, b = {0}, out = {0};
+    seq_t a = {0}, b = {0};
 
     if (cli_read_two_seqs(&a, &b) != 0)
         return 1;
 
-    if (seq_mul(&a, &b, &out) != 0)
+    /* 结果写回 a，不再分配输出 / the result overwrites a, no output allocation */
+    if (seq_mul_inplace(&a, &b) != 0)
     {
         fprintf(stderr, "Mul operation failed.\n");
-        seq_free(&a);
-        seq_free(&b);
+        cli_free_input(&a);
+        cli_free_input(&b);
         return 1;
     }
 
-    cli_print_seq(&out);
+    cli_print_seq(&a);
 
-    seq_free(&a);
-    seq_free(&b);
-    seq_free(&out);
+    cli_free_input(&a);
+    cli_free_input(&b);
     return 0;
 }
 
@@ -270,19 +616,93 @@ static int cli_mode_conv_linear(void)
     if (seq_conv_linear(&a, &b, &out) != 0)
     {
         fprintf(stderr, "Linear convolution failed.\n");
-        seq_free(&a);
-        seq_free(&b);
+        cli_free_input(&a);
+        cli_free_input(&b);
         return 1;
     }
 
     cli_print_seq(&out);
 
-    seq_free(&a);
-    seq_free(&b);
+    cli_free_input(&a);
+    cli_free_input(&b);
     seq_free(&out);
     return 0;
 }
 
+/* --ooc 输出回调的上下文 / context of the --ooc output sink */
+typedef struct
+{
+    uint64_t written; /* 已写出样本数 / samples written so far */
+} cli_ooc_out_t;
+
+/* --ooc 输出回调：逐块写到标准输出 / --ooc sink writing each block to stdout */
+static int cli_ooc_sink(void *ctx, const seq_sample_t *y, size_t n)
+{
+    cli_ooc_out_t *o = (cli_ooc_out_t *)ctx;
+    const uint64_t t0 = STATS_START();
+    int rc;
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        rc = seq_io_write(stdout, cli_out_fmt, y, n);
+    }
+    else
+    {
+        num_writer_t w;
+        num_writer_init(&w, stdout);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (o->written + i != 0)
+                num_write_char(&w, ' ');
+            num_write_g(&w, seq_sample_to_double(y[i]), CLI_TEXT_DIGITS);
+        }
+        rc = num_writer_flush(&w);
+    }
+    o->written += n;
+    STATS_RECORD(STATS_IO_FORMAT, t0, 0, n, 0);
+    return rc;
+}
+
+/**
+ * @brief 模式: 超出内存的线性卷积 / Mode: out-of-core linear convolution.
+ *
+ * @note 两条序列按块从输入文件定位读取，结果边算边写，输出格式与 conv-linear 相同。
+ *       Both sequences are read block by block from the input file by seeking
+ *       and results are written as they are produced, in the same format as conv-linear.
+ */
+static int cli_mode_conv_linear_ooc(void)
+{
+    seq_file_t a, b;
+
+    if (seq_file_open(&a, stdin, cli_in_fmt, 0) != 0 ||
+        seq_file_open(&b, stdin, cli_in_fmt, seq_file_end(&a)) != 0)
+    {
+        fprintf(stderr, "Failed to open the input sequences (--ooc needs input redirected from a file).\n");
+        return 1;
+    }
+
+    uint64_t ly = (a.length == 0 || b.length == 0) ? 0 : a.length + b.length - 1;
+    cli_ooc_out_t out = {0};
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        if (seq_io_write_u64(stdout, ly) != 0)
+            return 1;
+    }
+    else
+        printf("%llu\n", (unsigned long long)ly);
+
+    if (ooc_conv_linear(&a, &b, cli_chunk, OOC_CACHE_BYTES_DEFAULT, cli_ooc_sink, &out) != 0)
+    {
+        fprintf(stderr, "Linear convolution failed.\n");
+        return 1;
+    }
+
+    if (cli_out_fmt == SEQ_FMT_TEXT)
+        printf("\n");
+    return 0;
+}
+
 /**
  * @brief 模式: 圆周卷积 / Mode: circular convolution.
  */
@@ -296,15 +716,15 @@ static int cli_mode_conv_circular(void)
     if (seq_conv_circular(&a, &b, &out) != 0)
     {
         fprintf(stderr, "Circular convolution failed.\n");
-        seq_free(&a);
-        seq_free(&b);
+        cli_free_input(&a);
+        cli_free_input(&b);
         return 1;
     }
 
     cli_print_seq(&out);
 
-    seq_free(&a);
-    seq_free(&b);
+    cli_free_input(&a);
+    cli_free_input(&b);
     seq_free(&out);
     return 0;
 }
@@ -322,19 +742,267 @@ static int cli_mode_corr(void)
     if (seq_corr_cross(&a, &b, &out) != 0)
     {
         fprintf(stderr, "Cross-correlation failed.\n");
-        seq_free(&a);
-        seq_free(&b);
+        cli_free_input(&a);
+        cli_free_input(&b);
         return 1;
     }
 
     cli_print_seq(&out);
 
-    seq_free(&a);
-    seq_free(&b);
+    cli_free_input(&a);
+    cli_free_input(&b);
     seq_free(&out);
     return 0;
 }
 
+/* 内部工具：stdin 是否为终端 / whether stdin is a terminal */
+static int cli_stdin_is_tty(void)
+{
+#ifdef _WIN32
+    return _isatty(_fileno(stdin));
+#else
+    return isatty(fileno(stdin));
+#endif
+}
+
+/**
+ * @brief 写出一个相关系数 / Emit one coefficient.
+ *
+ * @param rho 相关系数 / Coefficient.
+ * @param rc seq_corr_stream_get() 的返回值 / Return value of seq_corr_stream_get().
+ *
+ * @note 无法计算时文本输出 "nan"，二进制输出 NaN（s16 或定点构建为 0）。
+ *       When undefined, text output is "nan" and binary output is NaN (0 for s16 or fixed-point builds).
+ */
+static void cli_corr_window_emit(seq_sample_t rho, int rc)
+{
+    const uint64_t t0 = STATS_START();
+
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        if (rc != 0)
+            rho = seq_sample_from_double(NAN);
+        seq_io_write(stdout, cli_out_fmt, &rho, 1);
+    }
+    else if (rc == 0)
+    {
+        /* 逐行写出，交互使用时结果立即可见 / one line at a time so results show up at once interactively */
+        char line[NUM_FORMAT_MAX + 1];
+        size_t n = num_format_g(line, seq_sample_to_double(rho), CLI_TEXT_DIGITS);
+        line[n++] = '\n';
+        fwrite(line, 1, n, stdout);
+    }
+    else
+    {
+        /* 无法计算时输出 nan，错误详情已在 stderr。 */
+        fputs("nan\n", stdout);
+    }
+    STATS_RECORD(STATS_IO_FORMAT, t0, 0, 1, 0);
+}
+
+/**
+ * @brief 推入一对样本并输出当前相关系数 / Push one pair and emit the current coefficient.
+ *
+ * @param cs 相关器 / Correlator.
+ * @param ax 序列 a 的样本 / Sample of a.
+ * @param bx 序列 b 的样本 / Sample of b.
+ */
+static void cli_corr_window_step(seq_corr_stream_t *cs, seq_sample_t ax, seq_sample_t bx)
+{
+    seq_corr_stream_push(cs, ax, bx);
+
+    seq_sample_t rho = 0;
+    int rc = seq_corr_stream_get(cs, &rho);
+    cli_corr_window_emit(rho, rc);
+}
+
+/**
+ * @brief corr-window 串行执行：读一对、算一对、写一行 / Serial corr-window: read, compute and emit one pair at a time.
+ *
+ * @param cs 相关器 / Correlator.
+ * @return 0 表示成功；非 0 表示输入截断或内存不足 / 0 on success; non-zero on truncated input or allocation failure.
+ */
+static int cli_corr_window_serial(seq_corr_stream_t *cs)
+{
+    int rc = 0;
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        /* 二进制：成批读取交织的样本对 / binary: read interleaved pairs in batches */
+        seq_sample_t *pairs = (seq_sample_t *)malloc(2 * CLI_PAIR_BLOCK * sizeof(seq_sample_t));
+        size_t n = 0;
+        if (pairs == NULL)
+        {
+            fprintf(stderr, "corr-window: failed to allocate input buffer.\n");
+            rc = 1;
+        }
+        while (rc == 0)
+        {
+            const uint64_t t0 = STATS_START();
+            if (seq_reader_samples(&cli_reader, pairs, 2 * CLI_PAIR_BLOCK, &n) != 0 || n % 2 != 0)
+            {
+                fprintf(stderr, "corr-window: truncated sample pair in binary input.\n");
+                rc = 1;
+                break;
+            }
+            STATS_RECORD(STATS_IO_PARSE, t0, n, 0, 0);
+            for (size_t i = 0; i < n; i += 2)
+                cli_corr_window_step(cs, pairs[i], pairs[i + 1]);
+            if (n < 2 * CLI_PAIR_BLOCK)
+                break;
+        }
+        free(pairs);
+    }
+    else
+    {
+        double ax, bx;
+        uint64_t t0 = STATS_START();
+        while (num_read_double(&cli_text, &ax) == 0 && num_read_double(&cli_text, &bx) == 0)
+        {
+            STATS_RECORD(STATS_IO_PARSE, t0, 2, 0, 0);
+            cli_corr_window_step(cs, seq_sample_from_double(ax), seq_sample_from_double(bx));
+            t0 = STATS_START();
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief corr-window 的输入线程：把样本对成块解析进环，环满时等待 /
+ *        Input thread of corr-window: parses sample pairs into ring blocks, waiting while the ring is full.
+ *
+ * @param arg 输入环 / Input ring.
+ * @return NULL
+ *
+ * @note 二进制输入截断时以失败状态关环，由计算线程报告，stderr 上的顺序因此与串行执行相同。
+ *       On truncated binary input the ring is closed with a failure status and the
+ *       compute thread reports it, so stderr reads the same as in the serial run.
+ */
+static void *cli_corr_window_reader(void *arg)
+{
+    ring_t *in = (ring_t *)arg;
+    const size_t cap = 2 * CLI_PAIR_BLOCK;
+    size_t n = cap;
+
+    while (n == cap)
+    {
+        seq_sample_t *pairs = (seq_sample_t *)ring_acquire(in);
+        if (pairs == NULL)
+            return NULL; /* 计算线程已退出 / the compute thread has left */
+
+        n = 0;
+        if (cli_in_fmt != SEQ_FMT_TEXT)
+        {
+            if (seq_reader_samples(&cli_reader, pairs, cap, &n) != 0 || n % 2 != 0)
+            {
+                ring_close(in, -1);
+                return NULL;
+            }
+        }
+        else
+        {
+            double ax, bx;
+            while (n < cap && num_read_double(&cli_text, &ax) == 0 && num_read_double(&cli_text, &bx) == 0)
+            {
+                pairs[n++] = seq_sample_from_double(ax);
+                pairs[n++] = seq_sample_from_double(bx);
+            }
+        }
+        if (n != 0)
+            ring_commit(in, n);
+    }
+    ring_close(in, 0);
+    return NULL;
+}
+
+/**
+ * @brief corr-window 的输出线程：按序写出结果块 / Output thread of corr-window: emits result blocks in order.
+ *
+ * @param arg 输出环 / Output ring.
+ * @return NULL
+ */
+static void *cli_corr_window_writer(void *arg)
+{
+    ring_t *out = (ring_t *)arg;
+    const cli_rho_t *r;
+    size_t n = 0;
+
+    while ((r = (const cli_rho_t *)ring_peek(out, &n)) != NULL)
+    {
+        for (size_t i = 0; i < n; ++i)
+            cli_corr_window_emit(r[i].rho, r[i].rc);
+        ring_release(out);
+    }
+    return NULL;
+}
+
+/**
+ * @brief corr-window 三级流水：解析、相关与输出各占一个线程，经无锁环传递整块 /
+ *        Three-stage corr-window: parsing, correlation and output each on a thread, passing whole blocks through lock-free rings.
+ *
+ * @param cs 相关器 / Correlator.
+ * @param rc 成功启动时写入结果（同 cli_corr_window_serial）/ Result when started (as cli_corr_window_serial).
+ * @return 0 表示已执行；非 0 表示环或线程创建失败，尚未读取任何输入。
+ *         0 once run; non-zero if the rings or threads could not be set up, before any input was read.
+ */
+static int cli_corr_window_pipe(seq_corr_stream_t *cs, int *rc)
+{
+    ring_t in, out;
+    pthread_t reader, writer;
+
+    if (ring_init(&in, CLI_PIPE_DEPTH, 2 * CLI_PAIR_BLOCK * sizeof(seq_sample_t)) != 0)
+        return -1;
+    if (ring_init(&out, CLI_PIPE_DEPTH, CLI_PAIR_BLOCK * sizeof(cli_rho_t)) != 0)
+    {
+        ring_free(&in);
+        return -1;
+    }
+    /* 先起输出线程：输入线程起不来时关掉输出环即可干净退回 /
+       output thread first: if the input thread fails, closing its ring backs out cleanly */
+    if (pthread_create(&writer, NULL, cli_corr_window_writer, &out) != 0)
+    {
+        ring_free(&in);
+        ring_free(&out);
+        return -1;
+    }
+    if (pthread_create(&reader, NULL, cli_corr_window_reader, &in) != 0)
+    {
+        ring_close(&out, 0);
+        pthread_join(writer, NULL);
+        ring_free(&in);
+        ring_free(&out);
+        return -1;
+    }
+
+    const seq_sample_t *pairs;
+    size_t n = 0;
+    while ((pairs = (const seq_sample_t *)ring_peek(&in, &n)) != NULL)
+    {
+        /* 输出线程从不提前退出，取槽只会等待 / the output thread never leaves early, so this only waits */
+        cli_rho_t *r = (cli_rho_t *)ring_acquire(&out);
+        for (size_t i = 0; i < n; i += 2)
+        {
+            seq_corr_stream_push(cs, pairs[i], pairs[i + 1]);
+            r[i / 2].rho = 0;
+            r[i / 2].rc = seq_corr_stream_get(cs, &r[i / 2].rho);
+        }
+        ring_release(&in);
+        ring_commit(&out, n / 2);
+    }
+    ring_close(&out, 0);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    *rc = 0;
+    if (ring_status(&in) != 0)
+    {
+        fprintf(stderr, "corr-window: truncated sample pair in binary input.\n");
+        *rc = 1;
+    }
+    ring_free(&in);
+    ring_free(&out);
+    return 0;
+}
+
 /**
  * @brief 模式: 滑动窗口归一化相关 (流式) /
  *        Mode: streaming normalized correlation using sliding windows.
@@ -346,52 +1014,331 @@ static int cli_mode_corr(void)
  *   ...
  * 直到 EOF。
  *
+ * 使用增量相关器 seq_corr_stream_t，每对样本 O(1)。
+ * Uses the incremental correlator seq_corr_stream_t, O(1) per pair.
+ *
+ * 二进制输入为 u64 窗口大小加交织的 a,b 样本，成批读取。
+ * Binary input is a u64 window size followed by interleaved a,b samples, read in batches.
+ *
  * 对于每一对输入样本，更新窗口并尝试计算当前归一化相关系数:
  *   - 若成功, 输出一行相关系数。
  *   - 若由于窗口未满或方差为 0 导致失败, 输出 "nan"。
+ *
+ * 默认以三级流水执行（见 cli_corr_window_pipe），吞吐取决于解析、相关、输出中最慢的一级，
+ * 慢的 stdout 只在环满后才反压输入。输出与串行执行逐字节一致；以下情况串行执行：
+ * 开启 --stats（统计不加锁，且各阶段计时只在不重叠时有意义），或文本输入来自终端
+ * （逐行立即给出结果）。
+ * Runs as a three-stage pipeline by default (see cli_corr_window_pipe), so
+ * throughput is set by the slowest of parsing, correlation and output, and a
+ * slow stdout only pushes back on input once the rings are full. Output is
+ * byte-identical to the serial run, which is used instead with --stats (the
+ * counters are unlocked and per-phase times only mean something when the
+ * phases do not overlap) or for text input from a terminal (each line
+ * answered at once).
  */
 static int cli_mode_corr_window(void)
 {
     size_t win_size = 0;
-    if (scanf("%zu", &win_size) != 1 || win_size == 0)
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        uint64_t w = 0;
+        if (seq_reader_u64(&cli_reader, &w) != 0 || w == 0 || w > SIZE_MAX)
+        {
+            fprintf(stderr, "corr-window: invalid window size.\n");
+            return 1;
+        }
+        win_size = (size_t)w;
+    }
+    else if (num_read_size(&cli_text, &win_size) != 0 || win_size == 0)
     {
         fprintf(stderr, "corr-window: invalid window size.\n");
         return 1;
     }
 
-    seq_window_t wa, wb;
-    if (seq_window_init(&wa, win_size) != 0)
+    seq_corr_stream_t cs;
+    if (seq_corr_stream_init(&cs, win_size, 0) != 0)
     {
-        fprintf(stderr, "corr-window: failed to initialize window A.\n");
+        fprintf(stderr, "corr-window: failed to initialize correlator.\n");
         return 1;
     }
-    if (seq_window_init(&wb, win_size) != 0)
+
+    int rc = 0;
+    if (stats_enabled() || (cli_in_fmt == SEQ_FMT_TEXT && cli_stdin_is_tty()) ||
+        cli_corr_window_pipe(&cs, &rc) != 0)
+        rc = cli_corr_window_serial(&cs);
+
+    seq_corr_stream_free(&cs);
+    return rc;
+}
+
+/**
+ * @brief 写出一批窗口统计量 / Emit a batch of window statistics.
+ *
+ * @param r 统计量 / Statistics.
+ * @param n 个数 / Count.
+ *
+ * @note 文本每个样本一行 "mean var rms min max"，二进制每个样本 5 个样本值。
+ *       Text is one "mean var rms min max" line per sample; binary is 5 values per sample.
+ */
+static void cli_win_stats_emit(const seq_winstat_result_t *r, size_t n)
+{
+    const uint64_t t0 = STATS_START();
+
+    for (size_t i = 0; i < n; ++i)
     {
-        fprintf(stderr, "corr-window: failed to initialize window B.\n");
-        seq_window_free(&wa);
+        const double v[5] = {r[i].mean, r[i].var, r[i].rms, r[i].min, r[i].max};
+        if (cli_out_fmt != SEQ_FMT_TEXT)
+        {
+            seq_sample_t raw[5];
+            for (size_t k = 0; k < 5; ++k)
+                raw[k] = seq_sample_from_double(v[k]);
+            seq_io_write(stdout, cli_out_fmt, raw, 5);
+        }
+        else
+        {
+            char line[5 * (NUM_FORMAT_MAX + 1)];
+            size_t len = 0;
+            for (size_t k = 0; k < 5; ++k)
+            {
+                len += num_format_g(line + len, v[k], CLI_TEXT_DIGITS);
+                line[len++] = (k < 4) ? ' ' : '\n';
+            }
+            fwrite(line, 1, len, stdout);
+        }
+    }
+    STATS_RECORD(STATS_IO_FORMAT, t0, 0, 5 * n, 0);
+}
+
+/**
+ * @brief 模式: 滑动窗口统计 (流式) / Mode: streaming sliding-window statistics.
+ *
+ * 输入格式:
+ *   <win_size>
+ *   x0 x1 x2 ...
+ * 直到 EOF；二进制为 u64 窗口大小加样本，成批读取。
+ * Until EOF; binary input is a u64 window size followed by samples, read in batches.
+ *
+ * 每个输入样本推入 seq_winstat_t 后输出当前窗口的均值、方差、均方根、最小与最大值，
+ * 窗口未满时统计已到达的样本。
+ * After each sample is pushed into seq_winstat_t, the mean, variance, RMS,
+ * minimum and maximum of the current window are emitted; before the window
+ * fills, the samples so far count.
+ */
+static int cli_mode_win_stats(void)
+{
+    size_t win_size = 0;
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        uint64_t w = 0;
+        if (seq_reader_u64(&cli_reader, &w) != 0 || w == 0 || w > SIZE_MAX)
+        {
+            fprintf(stderr, "win-stats: invalid window size.\n");
+            return 1;
+        }
+        win_size = (size_t)w;
+    }
+    else if (num_read_size(&cli_text, &win_size) != 0 || win_size == 0)
+    {
+        fprintf(stderr, "win-stats: invalid window size.\n");
+        return 1;
+    }
+
+    seq_winstat_t ws;
+    if (seq_winstat_init(&ws, win_size, 0) != 0)
+    {
+        fprintf(stderr, "win-stats: failed to initialize statistics.\n");
+        return 1;
+    }
+
+    int rc = 0;
+    seq_winstat_result_t r[CLI_WINSTAT_BLOCK];
+    if (cli_in_fmt != SEQ_FMT_TEXT)
+    {
+        seq_sample_t *x = (seq_sample_t *)malloc(CLI_WINSTAT_BLOCK * sizeof(seq_sample_t));
+        size_t n = CLI_WINSTAT_BLOCK;
+        if (x == NULL)
+        {
+            fprintf(stderr, "win-stats: failed to allocate input buffer.\n");
+            rc = 1;
+        }
+        while (rc == 0 && n == CLI_WINSTAT_BLOCK)
+        {
+            const uint64_t t0 = STATS_START();
+            if (seq_reader_samples(&cli_reader, x, CLI_WINSTAT_BLOCK, &n) != 0)
+            {
+                fprintf(stderr, "win-stats: truncated sample in binary input.\n");
+                rc = 1;
+                break;
+            }
+            STATS_RECORD(STATS_IO_PARSE, t0, n, 0, 0);
+            seq_winstat_push_n(&ws, x, n, r);
+            cli_win_stats_emit(r, n);
+        }
+        free(x);
+    }
+    else
+    {
+        double v;
+        uint64_t t0 = STATS_START();
+        while (num_read_double(&cli_text, &v) == 0)
+        {
+            STATS_RECORD(STATS_IO_PARSE, t0, 1, 0, 0);
+            const seq_sample_t x = seq_sample_from_double(v);
+            seq_winstat_push_n(&ws, &x, 1, r);
+            cli_win_stats_emit(r, 1);
+            t0 = STATS_START();
+        }
+    }
+
+    seq_winstat_free(&ws);
+    return rc;
+}
+
+/**
+ * @brief detect 模式的检测回调：每个检测输出一行 "lag score" / Sink of detect mode: one "lag score" line per detection.
+ */
+static int cli_detect_sink(void *ctx, const detect_hit_t *hit)
+{
+    (void)ctx;
+    const uint64_t t0 = STATS_START();
+
+    /* 逐行写出，交互使用时结果立即可见 / one line at a time so results show up at once interactively */
+    char line[24 + NUM_FORMAT_MAX + 1];
+    int n = snprintf(line, sizeof(line), "%llu ", (unsigned long long)hit->lag);
+    n += (int)num_format_g(line + n, hit->score, CLI_TEXT_DIGITS);
+    line[n++] = '\n';
+    size_t w = fwrite(line, 1, (size_t)n, stdout);
+
+    STATS_RECORD(STATS_IO_FORMAT, t0, 0, 1, 0);
+    if (w != (size_t)n)
+    {
+        fprintf(stderr, "detect: write failed.\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 模式: 流式匹配滤波检测 / Mode: streaming matched-filter detection.
+ *
+ * 输入格式:
+ *   <len_t> t0 t1 ... t(len_t-1)
+ *   x0 x1 x2 ...
+ * 直到 EOF。
+ *
+ * 模板读入后，流样本成批推入 detect_t：FFT 分块相关、就地归一化，经非极大抑制的峰值
+ * 按 --threshold / --top / --sep 输出为 "lag score" 行，不输出整条相关序列，内存与流长无关。
+ * After the template, stream samples are pushed to detect_t in batches:
+ * blocked FFT correlation with on-the-fly normalization; peaks that survive
+ * non-maximum suppression are printed as "lag score" lines according to
+ * --threshold / --top / --sep. The full correlation is never produced and
+ * memory does not grow with the stream.
+ *
+ * 二进制输入为序列格式的模板加原始样本，直到 EOF；输出总是文本。
+ * Binary input is the template in sequence format followed by raw samples
+ * until EOF; output is always text.
+ */
+static int cli_mode_detect(void)
+{
+    if (cli_out_fmt != SEQ_FMT_TEXT)
+    {
+        fprintf(stderr, "detect: detections are written as text; use a text output format.\n");
         return 1;
     }
 
-    double ax, bx;
-    while (scanf("%lf %lf", &ax, &bx) == 2)
+    seq_t t = {0};
+    if (cli_read_seq(&t) != 0)
+        return 1;
+
+    detect_t d;
+    int init_rc = detect_init(&d, &t, &cli_detect, cli_detect_sink, NULL);
+    cli_free_input(&t);
+    if (init_rc != 0)
     {
-        seq_window_push(&wa, (seq_sample_t)ax);
-        seq_window_push(&wb, (seq_sample_t)bx);
+        fprintf(stderr, "detect: failed to initialize detector.\n");
+        return 1;
+    }
+
+    seq_sample_t *xs = (seq_sample_t *)malloc(CLI_DETECT_BLOCK * sizeof(seq_sample_t));
+    int rc = 0;
+    if (xs == NULL)
+    {
+        fprintf(stderr, "detect: failed to allocate input buffer.\n");
+        rc = 1;
+    }
 
-        seq_sample_t rho = 0.0;
-        int rc = seq_corr_window_norm(&wa, &wb, &rho);
-        if (rc == 0)
+    while (rc == 0)
+    {
+        const uint64_t t0 = STATS_START();
+        size_t n = 0;
+        if (cli_in_fmt != SEQ_FMT_TEXT)
         {
-            printf("%.10g\n", (double)rho);
+            if (seq_reader_samples(&cli_reader, xs, CLI_DETECT_BLOCK, &n) != 0)
+            {
+                fprintf(stderr, "detect: failed to read stream samples.\n");
+                rc = 1;
+                break;
+            }
         }
         else
         {
-            /* 无法计算时输出 nan，错误详情已在 stderr。 */
-            printf("nan\n");
+            double v;
+            while (n < CLI_DETECT_BLOCK && num_read_double(&cli_text, &v) == 0)
+                xs[n++] = seq_sample_from_double(v);
         }
+        STATS_RECORD(STATS_IO_PARSE, t0, n, 0, 0);
+
+        if (detect_push(&d, xs, n) != 0)
+            rc = 1;
+        if (n < CLI_DETECT_BLOCK)
+            break;
     }
 
-    seq_window_free(&wa);
-    seq_window_free(&wb);
+    if (rc == 0 && detect_finish(&d) != 0)
+        rc = 1;
+
+    free(xs);
+    detect_free(&d);
+    return rc;
+}
+
+/**
+ * @brief 模式: 校准卷积 / 相关内核并写出分发表 / Mode: calibrate the conv/corr kernels and save the dispatch table.
+ *
+ * 在当前的 --threads 与 --simd 下逐档计时（见 tune.h），表写入 --tune=FILE，
+ * 进度写到 stderr，表的文本形式写到 stdout。不读取输入。
+ * Times every length class (see tune.h) with the current --threads and
+ * --simd, writes the table to --tune=FILE, progress to stderr and the table
+ * as text to stdout. Reads no input.
+ */
+static int cli_mode_calibrate(void)
+{
+    tune_table_t t;
+
+    if (cli_tune_file == NULL)
+    {
+        fprintf(stderr, "calibrate needs --tune=FILE.\n");
+        return 1;
+    }
+    if (tune_calibrate(&t, cli_tune_max, stderr) != 0 || tune_save(&t, cli_tune_file) != 0)
+        return 1;
+    tune_print(&t, stdout);
     return 0;
 }
+
+/**
+ * @brief 载入并装入 --tune 的分发表 / Load and install the --tune dispatch table.
+ *
+ * @note 文件缺失、损坏或与本机、本构建不符时只警告，沿用内置阈值。
+ *       A missing or corrupt file, or one that does not fit this host and
+ *       build, only draws a warning; the built-in thresholds stay in use.
+ */
+static void cli_load_tune(void)
+{
+    tune_table_t t;
+
+    if (tune_load(&t, cli_tune_file) == 0 && tune_check(&t) == 0)
+        tune_install(&t);
+    else
+        fprintf(stderr, "--tune: ignoring '%s', using the built-in thresholds.\n", cli_tune_file);
+}
@@ -0,0 +1,442 @@
+/**
+ * @file detect.c
+ * @brief 流式匹配滤波检测实现 / Streaming matched-filter detection implementation
+ *
+ * 输入累积在长 N 的块缓冲中，前 K-1 个样本是上一块的尾部。块满后与反转模板的频谱相乘，
+ * 逆变换的第 K-1 点起依次是 B = N-(K-1) 个位置的 c[p]（重叠保留）；窗口的均值与中心化
+ * 二阶矩在每块开头精确计算，其后按固定窗长增删更新。计算统一用 double。
+ * Input accumulates in a block buffer of length N whose first K-1 samples
+ * are the tail of the previous block. A full block is multiplied by the
+ * spectrum of the reversed template; from point K-1 on, the inverse
+ * transform holds c[p] for B = N-(K-1) positions (overlap-save). The window
+ * mean and centred second moment are computed exactly at the start of each
+ * block and then updated by fixed-length add/remove steps. Arithmetic is
+ * always in double.
+ */
+
+#include "detect.h"
+#include "ops.h"
+#include "stats.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 模板不长于此时每个位置都精确重算窗口矩，代价与增删更新相当 /
+   templates up to this length recompute the window moments exactly at every position, at about the cost of an update */
+#define DETECT_EXACT_K 16
+
+/**
+ * @brief 填入默认配置 / Fill in the default settings.
+ *
+ * @param cfg 配置 / Settings
+ *
+ * @note 默认归一化、阈值 DETECT_THRESHOLD_DEFAULT、逐个输出、峰值间隔 K。
+ *       Defaults: normalized, threshold DETECT_THRESHOLD_DEFAULT, emit as
+ *       found, peak spacing K.
+ */
+void detect_cfg_default(detect_cfg_t *cfg)
+{
+    if (cfg == NULL)
+        return;
+    cfg->threshold = DETECT_THRESHOLD_DEFAULT;
+    cfg->top_k = 0;
+    cfg->min_sep = 0;
+    cfg->normalize = 1;
+}
+
+/**
+ * @brief 初始化检测器 / Initialize a detector.
+ *
+ * @param d 检测器 / Detector
+ * @param tmpl 模板，长度 K > 0；内容被复制进频谱 / Template of length K > 0, captured in its spectrum
+ * @param cfg 配置，NULL 表示默认 / Settings, NULL for the defaults
+ * @param sink 检测回调 / Detection sink
+ * @param ctx 回调上下文 / Sink context
+ * @return 0 表示成功；非 0 表示错误（检测器保持可释放的空状态）。
+ *         0 on success; non-zero on error (the detector is left empty and freeable).
+ *
+ * @note 归一化时模板不得为常数（方差为 0）。块长取 fft_good_size(max(OPS_FFT_BLOCK_FACTOR·K,
+ *       DETECT_MIN_FFT))；此后不再分配内存。
+ *       A normalizing detector rejects a constant (zero-variance) template.
+ *       The block length is fft_good_size(max(OPS_FFT_BLOCK_FACTOR·K,
+ *       DETECT_MIN_FFT)); nothing is allocated afterwards.
+ */
+int detect_init(detect_t *d, const seq_t *tmpl, const detect_cfg_t *cfg, detect_sink_fn sink, void *ctx)
+{
+    if (d == NULL || tmpl == NULL || sink == NULL)
+    {
+        fprintf(stderr, "detect_init: NULL pointer argument.\n");
+        return -1;
+    }
+    memset(d, 0, sizeof(*d));
+
+    size_t k = tmpl->length;
+    if (k == 0)
+    {
+        fprintf(stderr, "detect_init: template must not be empty.\n");
+        return -1;
+    }
+
+    if (cfg != NULL)
+        d->cfg = *cfg;
+    else
+        detect_cfg_default(&d->cfg);
+    if (d->cfg.min_sep == 0)
+        d->cfg.min_sep = k;
+    d->sink = sink;
+    d->ctx = ctx;
+    d->k = k;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < k; ++i)
+        sum += seq_sample_to_double(tmpl->data[i]);
+    d->t_mean = sum / (double)k;
+    double energy = 0.0;
+    for (size_t i = 0; i < k; ++i)
+    {
+        double v = seq_sample_to_double(tmpl->data[i]);
+        d->t_m2 += (v - d->t_mean) * (v - d->t_mean);
+        energy += v * v;
+    }
+    if (d->cfg.normalize && d->t_m2 <= SEQ_CORR_ZERO_TOL * energy)
+    {
+        fprintf(stderr, "detect_init: template has zero variance, cannot normalize.\n");
+        return -1;
+    }
+
+    size_t nfft = OPS_FFT_BLOCK_FACTOR * k;
+    if (nfft < DETECT_MIN_FFT)
+        nfft = DETECT_MIN_FFT;
+    nfft = fft_good_size(nfft);
+    size_t nbin = nfft / 2 + 1;
+
+    if (fft_plan_init(&d->plan, nfft) != 0)
+    {
+        fprintf(stderr, "detect_init: failed to create FFT plan of length %zu.\n", nfft);
+        return -1;
+    }
+    d->block = nfft - (k - 1);
+
+    /* 频谱在前以保持对齐 / spectra first to keep them aligned */
+    d->h = (fft_cpx_t *)malloc((2 * nbin + nfft) * sizeof(fft_cpx_t) + 2 * nfft * sizeof(double));
+    if (d->cfg.top_k > 0)
+        d->best = (detect_hit_t *)malloc(d->cfg.top_k * sizeof(detect_hit_t));
+    if (d->h == NULL || (d->cfg.top_k > 0 && d->best == NULL))
+    {
+        fprintf(stderr, "detect_init: failed to allocate buffers.\n");
+        detect_free(d);
+        return -1;
+    }
+    d->spec = d->h + nbin;
+    d->work = d->spec + nbin;
+    d->buf = (double *)(d->work + nfft);
+    d->y = d->buf + nfft;
+
+    for (size_t i = 0; i < nfft; ++i)
+        d->buf[i] = (i < k) ? seq_sample_to_double(tmpl->data[k - 1 - i]) : 0.0;
+    fft_rfft(&d->plan, d->buf, d->h, d->work);
+    return 0;
+}
+
+/**
+ * @brief 释放检测器 / Free a detector.
+ *
+ * @param d 检测器，可为 NULL / Detector, may be NULL
+ */
+void detect_free(detect_t *d)
+{
+    if (d == NULL)
+        return;
+    fft_plan_free(&d->plan);
+    free(d->h);
+    free(d->best);
+    memset(d, 0, sizeof(*d));
+}
+
+/* 内部工具：a 是否排在 b 之前（得分高者先，同分时 lag 小者先）/ internal helper: whether a ranks before b */
+static int detect_ranks_before(const detect_hit_t *a, const detect_hit_t *b)
+{
+    return a->score > b->score || (a->score == b->score && a->lag < b->lag);
+}
+
+/* 内部工具：把 top_k 最小堆中下标 i 的元素下沉 / internal helper: sift entry i down the top_k min-heap */
+static void detect_heap_down(detect_hit_t *heap, size_t n, size_t i)
+{
+    for (;;)
+    {
+        size_t worst = i;
+        size_t l = 2 * i + 1;
+        size_t r = l + 1;
+        if (l < n && detect_ranks_before(&heap[worst], &heap[l]))
+            worst = l;
+        if (r < n && detect_ranks_before(&heap[worst], &heap[r]))
+            worst = r;
+        if (worst == i)
+            return;
+        detect_hit_t tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+/* 内部工具：输出一个确定的峰值 / internal helper: emit one settled peak */
+static int detect_emit(detect_t *d, const detect_hit_t *hit)
+{
+    if (d->cfg.top_k == 0)
+    {
+        d->emitted++;
+        return (d->sink(d->ctx, hit) == 0) ? 0 : -1;
+    }
+
+    if (d->nbest < d->cfg.top_k)
+    {
+        /* 上浮 / sift up */
+        size_t i = d->nbest++;
+        d->best[i] = *hit;
+        while (i > 0 && detect_ranks_before(&d->best[(i - 1) / 2], &d->best[i]))
+        {
+            detect_hit_t tmp = d->best[i];
+            d->best[i] = d->best[(i - 1) / 2];
+            d->best[(i - 1) / 2] = tmp;
+            i = (i - 1) / 2;
+        }
+    }
+    else if (detect_ranks_before(hit, &d->best[0]))
+    {
+        d->best[0] = *hit;
+        detect_heap_down(d->best, d->nbest, 0);
+    }
+    return 0;
+}
+
+/**
+ * @brief 内部工具：非极大抑制 / internal helper: non-maximum suppression.
+ *
+ * @note 离待定峰值不足 min_sep 的候选只在得分更高时取而代之；更远的候选到来时待定峰值才确定。
+ *       A candidate closer than min_sep to the pending peak only replaces it
+ *       when it scores higher; the pending peak is settled once a farther
+ *       candidate arrives.
+ */
+static int detect_candidate(detect_t *d, const detect_hit_t *hit)
+{
+    if (d->has_pending && hit->lag - d->pending.lag < d->cfg.min_sep)
+    {
+        if (hit->score > d->pending.score)
+            d->pending = *hit;
+        return 0;
+    }
+
+    int rc = d->has_pending ? detect_emit(d, &d->pending) : 0;
+    d->pending = *hit;
+    d->has_pending = 1;
+    return rc;
+}
+
+/* 内部工具：精确计算 x[0..k-1] 的均值与中心二阶矩 / internal helper: exact mean and centred second moment of x[0..k-1] */
+static void detect_moments(const double *x, size_t k, double *mean, double *m2)
+{
+    double s = 0.0;
+    for (size_t m = 0; m < k; ++m)
+        s += x[m];
+    s /= (double)k;
+
+    double q = 0.0;
+    for (size_t m = 0; m < k; ++m)
+        q += (x[m] - s) * (x[m] - s);
+    *mean = s;
+    *m2 = q;
+}
+
+/**
+ * @brief 内部工具：处理缓冲中的一块，得到前 count 个位置的得分 / internal helper: score the first count positions of the buffered block.
+ */
+static int detect_block(detect_t *d, size_t count)
+{
+    size_t k = d->k;
+    size_t nbin = d->plan.n / 2 + 1;
+    const double *x = d->buf;
+
+    fft_rfft(&d->plan, x, d->spec, d->work);
+    for (size_t q = 0; q < nbin; ++q)
+    {
+        double re = d->spec[q].re * d->h[q].re - d->spec[q].im * d->h[q].im;
+        double im = d->spec[q].re * d->h[q].im + d->spec[q].im * d->h[q].re;
+        d->spec[q].re = re;
+        d->spec[q].im = im;
+    }
+    fft_irfft(&d->plan, d->spec, d->y, d->work);
+
+    /* 窗口矩在块首精确计算 / window moments computed exactly at the block start */
+    double mean = 0.0, m2 = 0.0;
+    if (d->cfg.normalize)
+        detect_moments(x, k, &mean, &m2);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (d->cfg.normalize && i > 0)
+        {
+            /* 定长窗口的增删更新；每 K 个位置，或 m2 相对骤降（响段移出后的抵消误差）时，
+             * 与 ops_winstat_step 相同地从窗口精确重算；短模板每个位置都重算。
+             * Fixed-length add/remove update; as in ops_winstat_step, the
+             * moments are recomputed exactly from the window every K
+             * positions, or when m2 collapses relative to its previous value
+             * (cancellation after a loud stretch leaves the window); short
+             * templates recompute at every position. */
+            double out = x[i - 1];
+            double in = x[i + k - 1];
+            double mean0 = mean;
+            double m2_before = m2;
+            mean += (in - out) / (double)k;
+            m2 += (in - out) * (in - mean + out - mean0);
+            if (k <= DETECT_EXACT_K || i % k == 0 || m2 < SEQ_CORR_COLLAPSE * m2_before)
+                detect_moments(x + i, k, &mean, &m2);
+            else if (m2 < 0.0)
+                m2 = 0.0;
+        }
+
+        detect_hit_t hit;
+        hit.lag = d->base + i;
+        hit.dot = d->y[i + k - 1];
+        hit.score = hit.dot;
+        if (d->cfg.normalize)
+        {
+            double energy = m2 + (double)k * mean * mean; /* Σx² */
+            if (m2 <= SEQ_CORR_ZERO_TOL * energy)
+                continue; /* 方差为 0，得分无定义 / zero variance, score undefined */
+            hit.score = (hit.dot - d->t_mean * (double)k * mean) / sqrt(d->t_m2 * m2);
+            if (hit.score > 1.0)
+                hit.score = 1.0;
+            else if (hit.score < -1.0)
+                hit.score = -1.0;
+        }
+
+        if (hit.score >= d->cfg.threshold && detect_candidate(d, &hit) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 推入流样本 / Push stream samples.
+ *
+ * @param d 检测器 / Detector
+ * @param x 样本 / Samples
+ * @param n 样本数 / Sample count
+ * @return 0 表示成功；非 0 表示错误或回调中止。
+ *         0 on success; non-zero on error or a sink abort.
+ *
+ * @note 每凑满一块就计算该块全部位置；峰值在其后 min_sep 个位置内没有更高者时才交给回调，
+ *       因此检测相对输入有约一块的延迟。
+ *       Every full block is scored at once; a peak reaches the sink after
+ *       min_sep positions pass without a higher one, so detections lag the
+ *       input by about one block.
+ */
+int detect_push(detect_t *d, const seq_sample_t *x, size_t n)
+{
+    if (d == NULL || (x == NULL && n > 0))
+    {
+        fprintf(stderr, "detect_push: NULL pointer argument.\n");
+        return -1;
+    }
+    if (d->buf == NULL || d->finished)
+    {
+        fprintf(stderr, "detect_push: detector is not initialized or already finished.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    size_t nfft = d->plan.n;
+    d->emitted = 0;
+
+    for (size_t i = 0; i < n;)
+    {
+        size_t m = nfft - d->fill;
+        if (m > n - i)
+            m = n - i;
+        for (size_t j = 0; j < m; ++j)
+            d->buf[d->fill + j] = seq_sample_to_double(x[i + j]);
+        d->fill += m;
+        i += m;
+
+        if (d->fill == nfft)
+        {
+            if (detect_block(d, d->block) != 0)
+                return -1;
+            memmove(d->buf, d->buf + d->block, (d->k - 1) * sizeof(double));
+            d->fill = d->k - 1;
+            d->base += d->block;
+        }
+    }
+
+    STATS_RECORD(STATS_DETECT, t0, n, d->emitted, 0);
+    return 0;
+}
+
+/* 内部工具：qsort 比较，按排名 / internal helper: qsort comparison by rank */
+static int detect_cmp_rank(const void *pa, const void *pb)
+{
+    const detect_hit_t *a = (const detect_hit_t *)pa;
+    const detect_hit_t *b = (const detect_hit_t *)pb;
+    if (detect_ranks_before(a, b))
+        return -1;
+    return detect_ranks_before(b, a) ? 1 : 0;
+}
+
+/**
+ * @brief 结束输入，处理剩余位置并输出其余检测 / End the input, score the remaining positions and emit the rest.
+ *
+ * @param d 检测器 / Detector
+ * @return 0 表示成功；非 0 表示错误或回调中止。
+ *         0 on success; non-zero on error or a sink abort.
+ *
+ * @note 只计算模板与流完全重叠的位置，流短于 K 时没有检测。
+ *       top_k > 0 时此处按得分递减（同分按 lag 递增）一次输出最高的 top_k 个。
+ *       Only positions where the template fully overlaps the stream are
+ *       scored, so a stream shorter than K yields nothing. With top_k > 0 the
+ *       best top_k are emitted here in decreasing score (then increasing lag).
+ */
+int detect_finish(detect_t *d)
+{
+    if (d == NULL || d->buf == NULL || d->finished)
+    {
+        fprintf(stderr, "detect_finish: detector is not initialized or already finished.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    d->finished = 1;
+    d->emitted = 0;
+
+    if (d->fill >= d->k)
+    {
+        size_t count = d->fill - d->k + 1;
+        for (size_t i = d->fill; i < d->plan.n; ++i)
+            d->buf[i] = 0.0;
+        if (detect_block(d, count) != 0)
+            return -1;
+    }
+
+    if (d->has_pending)
+    {
+        d->has_pending = 0;
+        if (detect_emit(d, &d->pending) != 0)
+            return -1;
+    }
+
+    if (d->nbest > 0)
+    {
+        qsort(d->best, d->nbest, sizeof(detect_hit_t), detect_cmp_rank);
+        for (size_t i = 0; i < d->nbest; ++i)
+        {
+            d->emitted++;
+            if (d->sink(d->ctx, &d->best[i]) != 0)
+                return -1;
+        }
+    }
+
+    STATS_RECORD(STATS_DETECT, t0, 0, d->emitted, 0);
+    return 0;
+}
@@ -0,0 +1,527 @@
+/**
+ * @file expr.c
+ * @brief 延迟求值的逐点表达式实现 / Implementation of lazily evaluated element-wise expressions
+ *
+ * @note 求值按块拉取：父节点向子节点要 [n0, n1) 的结果，子节点返回指向结果的指针——叶子
+ *       直接指向原序列，无需填充的平移直接转交子节点的结果，其余写入本节点的块暂存。
+ *       根节点的块暂存就是调用方输出的对应位置，因此逐点运算的结果只写一次。
+ *       Evaluation pulls blocks: a parent asks a child for [n0, n1) and gets a
+ *       pointer to the result. A leaf points into its sequence, a shift that
+ *       needs no fill hands on its child's result, and everything else writes
+ *       into the node's block scratch. The root's scratch is the matching
+ *       slice of the caller's output, so element-wise results are written
+ *       exactly once.
+ */
+
+#include "expr.h"
+#include "simd.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* double 存储与累加时使用向量化内核，与 seq_add() / seq_mul() 相同 / vector kernels as in seq_add() / seq_mul() */
+#if SEQ_SAMPLE_IS_DOUBLE && SEQ_ACCUM_IS_DOUBLE
+#define EXPR_SIMD 1
+#else
+#define EXPR_SIMD 0
+#endif
+
+/**
+ * @brief 初始化空表达式 / Initialize an empty expression.
+ *
+ * @param e 表达式，不能为空 / Expression, must not be NULL
+ */
+void expr_init(expr_t *e)
+{
+    if (e != NULL)
+        memset(e, 0, sizeof(*e));
+}
+
+/**
+ * @brief 释放表达式 / Free an expression.
+ *
+ * @param e 表达式，可以为 NULL / Expression, may be NULL
+ *
+ * @note 叶子引用的序列不归表达式所有，不会释放。/ Sequences referenced by leaves are not owned and stay alive.
+ */
+void expr_free(expr_t *e)
+{
+    if (e == NULL)
+        return;
+    free(e->nodes);
+    free(e->work);
+    memset(e, 0, sizeof(*e));
+}
+
+/* 内部工具：追加节点，返回编号 / internal helper: append a node and return its id */
+static int expr_push(expr_t *e, const char *fn, const expr_node_t *node)
+{
+    if (e->count >= (size_t)INT32_MAX)
+    {
+        fprintf(stderr, "%s: too many nodes.\n", fn);
+        return -1;
+    }
+    if (e->count == e->capacity)
+    {
+        size_t cap = (e->capacity != 0) ? 2 * e->capacity : 16;
+        expr_node_t *nodes = (expr_node_t *)realloc(e->nodes, cap * sizeof(expr_node_t));
+        if (nodes == NULL)
+        {
+            fprintf(stderr, "%s: failed to grow the node array.\n", fn);
+            return -1;
+        }
+        e->nodes = nodes;
+        e->capacity = cap;
+    }
+    e->nodes[e->count] = *node;
+    return (int)e->count++;
+}
+
+/* 内部工具：检查子节点可被引用 / internal helper: check that a child may be referenced */
+static int expr_check_child(const expr_t *e, const char *fn, int id)
+{
+    if (id < 0 || (size_t)id >= e->count)
+    {
+        fprintf(stderr, "%s: invalid node id %d.\n", fn, id);
+        return -1;
+    }
+    const expr_node_t *n = &e->nodes[id];
+    if (n->kind != EXPR_LEAF && n->has_parent)
+    {
+        fprintf(stderr, "%s: node %d already has a parent; build shared subexpressions twice.\n", fn, id);
+        return -1;
+    }
+    return 0;
+}
+
+/* 内部工具：一元节点 / internal helper: unary node */
+static int expr_unary(expr_t *e, const char *fn, expr_kind_t kind, int a, size_t k, seq_sample_t value)
+{
+    if (e == NULL)
+    {
+        fprintf(stderr, "%s: expression pointer is NULL.\n", fn);
+        return -1;
+    }
+    if (expr_check_child(e, fn, a) != 0)
+        return -1;
+
+    expr_node_t node = {0};
+    node.kind = kind;
+    node.a = a;
+    node.b = -1;
+    node.shift = k;
+    node.value = value;
+    node.length = e->nodes[a].length;
+
+    int id = expr_push(e, fn, &node);
+    if (id >= 0)
+        e->nodes[a].has_parent = 1;
+    return id;
+}
+
+/* 内部工具：二元节点，长度取较短者 / internal helper: binary node, the shorter length wins */
+static int expr_binary(expr_t *e, const char *fn, expr_kind_t kind, int a, int b)
+{
+    if (e == NULL)
+    {
+        fprintf(stderr, "%s: expression pointer is NULL.\n", fn);
+        return -1;
+    }
+    if (expr_check_child(e, fn, a) != 0 || expr_check_child(e, fn, b) != 0)
+        return -1;
+    if (a == b && e->nodes[a].kind != EXPR_LEAF)
+    {
+        fprintf(stderr, "%s: node %d cannot be both operands; build it twice.\n", fn, a);
+        return -1;
+    }
+
+    expr_node_t node = {0};
+    node.kind = kind;
+    node.a = a;
+    node.b = b;
+    node.length = (e->nodes[a].length < e->nodes[b].length) ? e->nodes[a].length : e->nodes[b].length;
+
+    int id = expr_push(e, fn, &node);
+    if (id >= 0)
+    {
+        e->nodes[a].has_parent = 1;
+        e->nodes[b].has_parent = 1;
+    }
+    return id;
+}
+
+/**
+ * @brief 添加叶子 / Add a leaf.
+ *
+ * @param e 表达式 / Expression
+ * @param s 输入序列；求值时须仍然有效 / Input sequence; must stay valid until evaluation
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_leaf(expr_t *e, const seq_t *s)
+{
+    if (e == NULL || s == NULL || (s->data == NULL && s->length != 0))
+    {
+        fprintf(stderr, "expr_leaf: null pointer argument.\n");
+        return -1;
+    }
+
+    expr_node_t node = {0};
+    node.kind = EXPR_LEAF;
+    node.a = -1;
+    node.b = -1;
+    node.leaf = s;
+    node.length = s->length;
+    return expr_push(e, "expr_leaf", &node);
+}
+
+/**
+ * @brief 逐点加法节点 / Point-wise addition node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_add(expr_t *e, int a, int b)
+{
+    return expr_binary(e, "expr_add", EXPR_ADD, a, b);
+}
+
+/**
+ * @brief 逐点减法节点 / Point-wise subtraction node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_sub(expr_t *e, int a, int b)
+{
+    return expr_binary(e, "expr_sub", EXPR_SUB, a, b);
+}
+
+/**
+ * @brief 逐点乘法节点 / Point-wise multiplication node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_mul(expr_t *e, int a, int b)
+{
+    return expr_binary(e, "expr_mul", EXPR_MUL, a, b);
+}
+
+/**
+ * @brief 常数缩放节点 / Scale-by-constant node.
+ *
+ * @param c 常数（样本类型，Q15 时在 [-1, 1) 内）/ Constant in the sample type ([-1, 1) for Q15)
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_scale(expr_t *e, int a, seq_sample_t c)
+{
+    return expr_unary(e, "expr_scale", EXPR_SCALE, a, 0, c);
+}
+
+/**
+ * @brief 延迟节点：y[n] = a[n - k]，n < k 时为 fill / Delay node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_delay(expr_t *e, int a, size_t k, seq_sample_t fill)
+{
+    return expr_unary(e, "expr_delay", EXPR_DELAY, a, k, fill);
+}
+
+/**
+ * @brief 提前节点：y[n] = a[n + k]，越过末尾时为 fill / Advance node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_advance(expr_t *e, int a, size_t k, seq_sample_t fill)
+{
+    return expr_unary(e, "expr_advance", EXPR_ADVANCE, a, k, fill);
+}
+
+/**
+ * @brief 差分节点：y[n] = a[n] - a[n - 1]，a[-1] = 0 / Difference node.
+ *
+ * @return 节点编号；失败返回 -1。/ Node id, or -1 on failure.
+ */
+int expr_diff(expr_t *e, int a)
+{
+    return expr_unary(e, "expr_diff", EXPR_DIFF, a, 0, (seq_sample_t)0);
+}
+
+/**
+ * @brief 节点的输出长度 / Output length of a node.
+ *
+ * @return 长度；编号无效时为 0。/ Length, or 0 for an invalid id.
+ */
+size_t expr_length(const expr_t *e, int root)
+{
+    if (e == NULL || root < 0 || (size_t)root >= e->count)
+        return 0;
+    return e->nodes[root].length;
+}
+
+/**
+ * @brief 内部工具：按块大小分配各节点的暂存 / internal helper: size and hand out the block scratch of every node.
+ *
+ * @note 编号递减即为自顶向下，差分的子节点每块多要一个样本。根节点不占暂存。
+ *       Decreasing ids walk top-down; a difference asks its child for one
+ *       extra sample per block. The root takes no scratch.
+ */
+static int expr_prepare(expr_t *e, int root)
+{
+    for (int i = 0; i <= root; ++i)
+        e->nodes[i].need = 0;
+    e->nodes[root].need = EXPR_BLOCK;
+
+    size_t total = 0;
+    for (int i = root; i >= 0; --i)
+    {
+        expr_node_t *n = &e->nodes[i];
+        if (n->need == 0 || n->kind == EXPR_LEAF)
+            continue;
+        if (i != root)
+            total += n->need;
+
+        size_t child_need = n->need + (n->kind == EXPR_DIFF);
+        if (e->nodes[n->a].need < child_need)
+            e->nodes[n->a].need = child_need;
+        if (n->b >= 0 && e->nodes[n->b].need < child_need)
+            e->nodes[n->b].need = child_need;
+    }
+
+    if (total > e->work_len)
+    {
+        seq_sample_t *work = (seq_sample_t *)realloc(e->work, total * sizeof(seq_sample_t));
+        if (work == NULL)
+        {
+            fprintf(stderr, "expr_eval_into: failed to allocate %zu scratch samples.\n", total);
+            return -1;
+        }
+        e->work = work;
+        e->work_len = total;
+    }
+
+    size_t off = 0;
+    for (int i = 0; i < root; ++i)
+    {
+        expr_node_t *n = &e->nodes[i];
+        n->buf = NULL;
+        if (n->need != 0 && n->kind != EXPR_LEAF)
+        {
+            n->buf = e->work + off;
+            off += n->need;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 内部工具：求节点在 [n0, n1) 上的值 / internal helper: evaluate a node over [n0, n1).
+ *
+ * @return 指向 n1 - n0 个结果的指针 / Pointer to the n1 - n0 results
+ *
+ * @note 要求 n0 < n1 <= 节点长度，且 n1 - n0 不超过节点的 need。
+ *       Requires n0 < n1 <= the node length and n1 - n0 within the node's need.
+ */
+static const seq_sample_t *expr_node_eval(const expr_t *e, int id, size_t n0, size_t n1)
+{
+    const expr_node_t *nd = &e->nodes[id];
+    size_t n = n1 - n0;
+    seq_sample_t *y = nd->buf;
+    const seq_sample_t *pa;
+    const seq_sample_t *pb;
+
+    switch (nd->kind)
+    {
+    case EXPR_LEAF:
+        return nd->leaf->data + n0;
+
+    case EXPR_ADD:
+        pa = expr_node_eval(e, nd->a, n0, n1);
+        pb = expr_node_eval(e, nd->b, n0, n1);
+#if EXPR_SIMD
+        simd_add_f64(pa, pb, y, n);
+#else
+        for (size_t i = 0; i < n; ++i)
+            y[i] = seq_sample_add(pa[i], pb[i]);
+#endif
+        return y;
+
+    case EXPR_SUB:
+        pa = expr_node_eval(e, nd->a, n0, n1);
+        pb = expr_node_eval(e, nd->b, n0, n1);
+        for (size_t i = 0; i < n; ++i)
+            y[i] = seq_sample_sub(pa[i], pb[i]);
+        return y;
+
+    case EXPR_MUL:
+        pa = expr_node_eval(e, nd->a, n0, n1);
+        pb = expr_node_eval(e, nd->b, n0, n1);
+#if EXPR_SIMD
+        simd_mul_f64(pa, pb, y, n);
+#else
+        for (size_t i = 0; i < n; ++i)
+            y[i] = seq_sample_mul(pa[i], pb[i]);
+#endif
+        return y;
+
+    case EXPR_SCALE:
+        pa = expr_node_eval(e, nd->a, n0, n1);
+        for (size_t i = 0; i < n; ++i)
+            y[i] = seq_sample_mul(pa[i], nd->value);
+        return y;
+
+    case EXPR_DELAY:
+    {
+        size_t k = nd->shift;
+        if (n0 >= k)
+            return expr_node_eval(e, nd->a, n0 - k, n1 - k);
+
+        size_t nf = ((n1 < k) ? n1 : k) - n0;
+        for (size_t i = 0; i < nf; ++i)
+            y[i] = nd->value;
+        if (n1 > k)
+        {
+            pa = expr_node_eval(e, nd->a, 0, n1 - k);
+            memcpy(y + nf, pa, (n1 - k) * sizeof(seq_sample_t));
+        }
+        return y;
+    }
+
+    case EXPR_ADVANCE:
+    {
+        size_t k = nd->shift;
+        if (k <= nd->length - n1)
+            return expr_node_eval(e, nd->a, n0 + k, n1 + k);
+
+        /* 下标 < end 的输出还有来源 / outputs below end still have a source */
+        size_t end = (nd->length > k) ? nd->length - k : 0;
+        size_t m = (end > n0) ? end - n0 : 0;
+        if (m != 0)
+        {
+            pa = expr_node_eval(e, nd->a, n0 + k, n0 + k + m);
+            memcpy(y, pa, m * sizeof(seq_sample_t));
+        }
+        for (size_t i = m; i < n; ++i)
+            y[i] = nd->value;
+        return y;
+    }
+
+    case EXPR_DIFF:
+    {
+        const seq_sample_t *x;
+        seq_sample_t prev;
+        if (n0 > 0)
+        {
+            pa = expr_node_eval(e, nd->a, n0 - 1, n1);
+            prev = pa[0];
+            x = pa + 1;
+        }
+        else
+        {
+            x = expr_node_eval(e, nd->a, 0, n1);
+            prev = (seq_sample_t)0;
+        }
+        y[0] = seq_sample_sub(x[0], prev);
+        for (size_t i = 1; i < n; ++i)
+            y[i] = seq_sample_sub(x[i], x[i - 1]);
+        return y;
+    }
+    }
+    return y;
+}
+
+/**
+ * @brief 求值写入调用方缓冲区 / Evaluate into a caller-owned buffer.
+ *
+ * @param e 表达式 / Expression
+ * @param root 根节点编号 / Root node id
+ * @param out 输出缓冲区，不得与叶子序列重叠 / Output buffer; must not overlap the leaf sequences
+ * @param cap 输出容量，须 ≥ expr_length(e, root) / Capacity, at least expr_length(e, root)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note
+ * - 每块 EXPR_BLOCK 个输出一次算完整棵树；暂存为每个节点一块，首次求值时分配并在之后复用，
+ *   因此同一表达式（或节点数不增加的表达式）再次求值不再分配。
+ *   Each block of EXPR_BLOCK outputs runs the whole tree. Scratch is one
+ *   block per node, allocated on the first evaluation and reused, so
+ *   evaluating the same expression again does not allocate.
+ * - 根节点可以是任意节点，只求它的子树。/ Any node may serve as the root; only its subtree is evaluated.
+ */
+int expr_eval_into(expr_t *e, int root, seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (e == NULL || n_out == NULL)
+    {
+        fprintf(stderr, "expr_eval_into: null pointer argument.\n");
+        return -1;
+    }
+    *n_out = 0;
+    if (root < 0 || (size_t)root >= e->count)
+    {
+        fprintf(stderr, "expr_eval_into: invalid root node id %d.\n", root);
+        return -1;
+    }
+
+    size_t len = e->nodes[root].length;
+    if (len > cap)
+    {
+        fprintf(stderr, "expr_eval_into: output capacity %zu is below the required %zu.\n", cap, len);
+        return -1;
+    }
+    if (len == 0)
+        return 0;
+    if (out == NULL)
+    {
+        fprintf(stderr, "expr_eval_into: null output buffer.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    if (expr_prepare(e, root) != 0)
+        return -1;
+
+    expr_node_t *r = &e->nodes[root];
+    for (size_t n0 = 0; n0 < len; n0 += EXPR_BLOCK)
+    {
+        size_t n1 = (len - n0 < EXPR_BLOCK) ? len : n0 + EXPR_BLOCK;
+        r->buf = out + n0;
+        const seq_sample_t *p = expr_node_eval(e, root, n0, n1);
+        if (p != out + n0)
+            memcpy(out + n0, p, (n1 - n0) * sizeof(seq_sample_t));
+    }
+    r->buf = NULL;
+
+    *n_out = len;
+    STATS_RECORD(STATS_EXPR, t0, len, len, 0);
+    return 0;
+}
+
+/**
+ * @brief 求值为新序列 / Evaluate into a newly allocated sequence.
+ *
+ * @param e 表达式 / Expression
+ * @param root 根节点编号 / Root node id
+ * @param out 输出序列 / Output sequence
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 等价于 seq_init() 后调用 expr_eval_into()。/ Equivalent to seq_init() followed by expr_eval_into().
+ */
+int expr_eval(expr_t *e, int root, seq_t *out)
+{
+    if (e == NULL || out == NULL)
+    {
+        fprintf(stderr, "expr_eval: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t len = expr_length(e, root);
+    if (seq_init(out, len) != 0)
+        return -1;
+    if (expr_eval_into(e, root, out->data, len, &len) != 0)
+    {
+        seq_free(out);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file fft.c
+ * @brief 实序列快速傅里叶变换实现 / Implementation of real-input FFT
+ *
+ * 复变换采用自排序 (Stockham) 混合基算法，无需位反转；实变换通过
+ * n/2 点复变换加一次后处理完成。
+ * The complex transform is a self-sorting (Stockham) mixed-radix algorithm,
+ * so no bit-reversal pass is needed; the real transform packs even/odd
+ * samples into an n/2-point complex transform followed by one post-pass.
+ */
+
+#include "fft.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define FFT_PI 3.14159265358979323846
+
+/* 内部工具：把 half 分解为 4,2,3,5,... / internal helper: factorize half */
+static int fft_factorize(fft_plan_t *p)
+{
+    size_t m = p->half;
+    size_t nf = 0;
+
+    while (m % 4 == 0 && nf < FFT_MAX_FACTORS)
+    {
+        p->factors[nf++] = 4;
+        m /= 4;
+    }
+    while (m % 2 == 0 && nf < FFT_MAX_FACTORS)
+    {
+        p->factors[nf++] = 2;
+        m /= 2;
+    }
+    for (size_t f = 3; m > 1 && nf < FFT_MAX_FACTORS; f += 2)
+    {
+        /* 大素因子直接作为一个基 / large prime factor becomes a single radix */
+        if (f * f > m)
+            f = m;
+        while (m % f == 0 && nf < FFT_MAX_FACTORS)
+        {
+            p->factors[nf++] = f;
+            m /= f;
+        }
+    }
+
+    if (m != 1)
+    {
+        fprintf(stderr, "fft_plan_init: too many radix factors.\n");
+        return -1;
+    }
+
+    p->nfactors = nf;
+    return 0;
+}
+
+/**
+ * @brief 初始化 FFT 计划 / Initialize an FFT plan.
+ *
+ * @param p 计划指针，不能为空。/ Plan pointer, must not be NULL.
+ * @param n 实序列长度，必须为正偶数。/ Real length, must be a positive even number.
+ * @return 0 表示成功；非 0 表示参数无效或内存分配失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ *
+ * @note 任意偶数长度均可；2^a·3^b·5^c 形式（见 fft_good_size）最快。
+ *       Any even length works; 2^a·3^b·5^c lengths (see fft_good_size) are fastest.
+ */
+int fft_plan_init(fft_plan_t *p, size_t n)
+{
+    if (p == NULL)
+    {
+        fprintf(stderr, "fft_plan_init: plan pointer is NULL.\n");
+        return -1;
+    }
+
+    p->n = 0;
+    p->half = 0;
+    p->nfactors = 0;
+    p->twiddle = NULL;
+    p->rtwiddle = NULL;
+
+    if (n < 2 || (n % 2) != 0)
+    {
+        fprintf(stderr, "fft_plan_init: length must be a positive even number (got %zu).\n", n);
+        return -1;
+    }
+
+    p->n = n;
+    p->half = n / 2;
+
+    if (fft_factorize(p) != 0)
+    {
+        fft_plan_free(p);
+        return -1;
+    }
+
+    p->twiddle = (fft_cpx_t *)malloc(p->half * sizeof(fft_cpx_t));
+    p->rtwiddle = (fft_cpx_t *)malloc(p->half * sizeof(fft_cpx_t));
+    if (p->twiddle == NULL || p->rtwiddle == NULL)
+    {
+        fprintf(stderr, "fft_plan_init: failed to allocate twiddle tables.\n");
+        fft_plan_free(p);
+        return -1;
+    }
+
+    for (size_t k = 0; k < p->half; ++k)
+    {
+        double ph = -2.0 * FFT_PI * (double)k / (double)p->half;
+        p->twiddle[k].re = cos(ph);
+        p->twiddle[k].im = sin(ph);
+
+        double rph = -2.0 * FFT_PI * (double)k / (double)n;
+        p->rtwiddle[k].re = cos(rph);
+        p->rtwiddle[k].im = sin(rph);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 释放 FFT 计划 / Free an FFT plan.
+ *
+ * @param p 计划指针，可以为 NULL。/ Plan pointer, can be NULL.
+ */
+void fft_plan_free(fft_plan_t *p)
+{
+    if (p == NULL)
+        return;
+
+    free(p->twiddle);
+    free(p->rtwiddle);
+    p->twiddle = NULL;
+    p->rtwiddle = NULL;
+    p->n = 0;
+    p->half = 0;
+    p->nfactors = 0;
+}
+
+/* ==== 计划缓存 / Plan cache ==== */
+
+typedef struct
+{
+    fft_plan_t plan;
+    unsigned long stamp; /* 最近使用时间戳，0 表示空槽 / LRU stamp, 0 = empty */
+} fft_cache_slot_t;
+
+static fft_cache_slot_t fft_cache[FFT_CACHE_SIZE];
+static unsigned long fft_cache_clock = 0;
+
+/**
+ * @brief 获取缓存的 FFT 计划 / Get a cached FFT plan.
+ *
+ * @param n 实序列长度（正偶数）。/ Real length (positive even number).
+ * @return 计划指针；失败返回 NULL。/ Plan pointer, or NULL on failure.
+ *
+ * @note
+ * - 缓存按最近最少使用 (LRU) 淘汰，最多保留 FFT_CACHE_SIZE 个长度。
+ *   The cache evicts least-recently-used plans and keeps up to FFT_CACHE_SIZE lengths.
+ * - 返回的指针在随后 FFT_CACHE_SIZE - 1 次其他长度的查询内保持有效。
+ *   The pointer stays valid across at least FFT_CACHE_SIZE - 1 lookups of other lengths.
+ * - 非线程安全。/ Not thread-safe.
+ */
+const fft_plan_t *fft_plan_get(size_t n)
+{
+    size_t victim = 0;
+
+    for (size_t i = 0; i < FFT_CACHE_SIZE; ++i)
+    {
+        if (fft_cache[i].stamp != 0 && fft_cache[i].plan.n == n)
+        {
+            fft_cache[i].stamp = ++fft_cache_clock;
+            return &fft_cache[i].plan;
+        }
+        if (fft_cache[i].stamp < fft_cache[victim].stamp)
+            victim = i;
+    }
+
+    if (fft_cache[victim].stamp != 0)
+        fft_plan_free(&fft_cache[victim].plan);
+    fft_cache[victim].stamp = 0;
+
+    if (fft_plan_init(&fft_cache[victim].plan, n) != 0)
+        return NULL;
+
+    fft_cache[victim].stamp = ++fft_cache_clock;
+    return &fft_cache[victim].plan;
+}
+
+/**
+ * @brief 清空计划缓存并释放内存 / Clear the plan cache and release its memory.
+ */
+void fft_cache_clear(void)
+{
+    for (size_t i = 0; i < FFT_CACHE_SIZE; ++i)
+    {
+        if (fft_cache[i].stamp != 0)
+            fft_plan_free(&fft_cache[i].plan);
+        fft_cache[i].stamp = 0;
+    }
+}
+
+/**
+ * @brief 求不小于 n 的高效变换长度 / Smallest efficient transform length >= n.
+ *
+ * @param n 最小长度。/ Minimum length.
+ * @return 形如 2·2^a·3^b·5^c 的偶数长度。/ An even length of the form 2·2^a·3^b·5^c.
+ */
+size_t fft_good_size(size_t n)
+{
+    size_t m = (n + 1) / 2;
+    if (m < 1)
+        m = 1;
+
+    for (;; ++m)
+    {
+        size_t r = m;
+        while (r % 2 == 0)
+            r /= 2;
+        while (r % 3 == 0)
+            r /= 3;
+        while (r % 5 == 0)
+            r /= 5;
+        if (r == 1)
+            return 2 * m;
+    }
+}
+
+/* ==== 复变换内核 / Complex transform kernel ==== */
+
+/*
+ * 前向 Stockham 变换：x 为输入，y 为等长工作区，返回保存结果的缓冲区。
+ * Forward Stockham transform: x is the input, y a scratch of equal size;
+ * returns whichever buffer holds the result.
+ *
+ * 第 i 级：长度 len 拆为 f 个长度 m 的子序列，步长 s 为已处理因子之积。
+ * Stage i splits length len into f sub-sequences of length m; stride s
+ * is the product of the factors already processed.
+ */
+static fft_cpx_t *fft_cfft_forward(const fft_plan_t *p, fft_cpx_t *x, fft_cpx_t *y)
+{
+    const size_t nn = p->half;
+    const fft_cpx_t *w = p->twiddle;
+    size_t len = nn;
+    size_t s = 1;
+    fft_cpx_t *src = x;
+    fft_cpx_t *dst = y;
+
+    for (size_t fi = 0; fi < p->nfactors; ++fi)
+    {
+        const size_t f = p->factors[fi];
+        const size_t m = len / f;
+
+        for (size_t q = 0; q < m; ++q)
+        {
+            for (size_t k = 0; k < s; ++k)
+            {
+                const fft_cpx_t *in = src + k + s * q;
+                fft_cpx_t *out = dst + k + s * f * q;
+                const size_t is = s * m; /* 输入基间距 / input radix stride */
+
+                if (f == 2)
+                {
+                    fft_cpx_t a0 = in[0], a1 = in[is];
+                    fft_cpx_t b1 = {a0.re - a1.re, a0.im - a1.im};
+                    fft_cpx_t t1 = w[q * s];
+                    out[0].re = a0.re + a1.re;
+                    out[0].im = a0.im + a1.im;
+                    out[s].re = b1.re * t1.re - b1.im * t1.im;
+                    out[s].im = b1.re * t1.im + b1.im * t1.re;
+                }
+                else if (f == 4)
+                {
+                    fft_cpx_t a0 = in[0], a1 = in[is], a2 = in[2 * is], a3 = in[3 * is];
+                    fft_cpx_t s02 = {a0.re + a2.re, a0.im + a2.im};
+                    fft_cpx_t d02 = {a0.re - a2.re, a0.im - a2.im};
+                    fft_cpx_t s13 = {a1.re + a3.re, a1.im + a3.im};
+                    fft_cpx_t d13 = {a1.re - a3.re, a1.im - a3.im};
+                    /* b1 = d02 - i·d13, b3 = d02 + i·d13 */
+                    fft_cpx_t b[4];
+                    b[0].re = s02.re + s13.re;
+                    b[0].im = s02.im + s13.im;
+                    b[1].re = d02.re + d13.im;
+                    b[1].im = d02.im - d13.re;
+                    b[2].re = s02.re - s13.re;
+                    b[2].im = s02.im - s13.im;
+                    b[3].re = d02.re - d13.im;
+                    b[3].im = d02.im + d13.re;
+
+                    out[0] = b[0];
+                    for (size_t t = 1; t < 4; ++t)
+                    {
+                        fft_cpx_t tw = w[q * t * s];
+                        out[t * s].re = b[t].re * tw.re - b[t].im * tw.im;
+                        out[t * s].im = b[t].re * tw.im + b[t].im * tw.re;
+                    }
+                }
+                else
+                {
+                    /* 通用基：O(f^2) 小 DFT / generic radix: O(f^2) small DFT */
+                    const size_t wstep = nn / f;
+                    for (size_t t = 0; t < f; ++t)
+                    {
+                        double re = 0.0, im = 0.0;
+                        size_t idx = 0; /* (r*t) mod f */
+                        for (size_t r = 0; r < f; ++r)
+                        {
+                            fft_cpx_t a = in[r * is];
+                            fft_cpx_t c = w[idx * wstep];
+                            re += a.re * c.re - a.im * c.im;
+                            im += a.re * c.im + a.im * c.re;
+                            idx += t;
+                            if (idx >= f)
+                                idx -= f;
+                        }
+                        fft_cpx_t tw = w[q * t * s];
+                        out[t * s].re = re * tw.re - im * tw.im;
+                        out[t * s].im = re * tw.im + im * tw.re;
+                    }
+                }
+            }
+        }
+
+        len = m;
+        s *= f;
+        fft_cpx_t *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+/**
+ * @brief 实序列正变换 / Forward real-input transform.
+ *
+ * @param p 计划 / Plan
+ * @param in 输入，长度 p->n / Input of length p->n
+ * @param out 输出频谱，长度 p->half + 1（非负频率）/ Output spectrum, p->half + 1 bins
+ * @param work 工作区，长度 p->n 个复数 / Scratch of p->n complex values
+ * @return 0 表示成功；非 0 表示参数错误。/ 0 on success; non-zero on invalid argument.
+ *
+ * @note 结果未归一化：X[k] = Σ x[j]·e^{-2πijk/n}。
+ *       Unnormalized: X[k] = Σ x[j]·e^{-2πijk/n}.
+ */
+int fft_rfft(const fft_plan_t *p, const double *in, fft_cpx_t *out, fft_cpx_t *work)
+{
+    if (!p || !in || !out || !work || p->half == 0)
+    {
+        fprintf(stderr, "fft_rfft: invalid argument.\n");
+        return -1;
+    }
+
+    const size_t h = p->half;
+    fft_cpx_t *z = work;
+    for (size_t k = 0; k < h; ++k)
+    {
+        z[k].re = in[2 * k];
+        z[k].im = in[2 * k + 1];
+    }
+
+    const fft_cpx_t *zf = fft_cfft_forward(p, z, work + h);
+
+    out[0].re = zf[0].re + zf[0].im;
+    out[0].im = 0.0;
+    out[h].re = zf[0].re - zf[0].im;
+    out[h].im = 0.0;
+
+    for (size_t k = 1; k < h; ++k)
+    {
+        fft_cpx_t zk = zf[k];
+        fft_cpx_t zc = {zf[h - k].re, -zf[h - k].im}; /* conj(Z[h-k]) */
+        fft_cpx_t e = {0.5 * (zk.re + zc.re), 0.5 * (zk.im + zc.im)};
+        /* o = -i·(zk - zc)/2 */
+        fft_cpx_t o = {0.5 * (zk.im - zc.im), -0.5 * (zk.re - zc.re)};
+        fft_cpx_t tw = p->rtwiddle[k];
+        out[k].re = e.re + o.re * tw.re - o.im * tw.im;
+        out[k].im = e.im + o.re * tw.im + o.im * tw.re;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 实序列逆变换 / Inverse real-output transform.
+ *
+ * @param p 计划 / Plan
+ * @param in 输入频谱，长度 p->half + 1 / Input spectrum of p->half + 1 bins
+ * @param out 输出序列，长度 p->n / Output of length p->n
+ * @param work 工作区，长度 p->n 个复数 / Scratch of p->n complex values
+ * @return 0 表示成功；非 0 表示参数错误。/ 0 on success; non-zero on invalid argument.
+ *
+ * @note 已含 1/n 归一化，fft_irfft(fft_rfft(x)) == x。
+ *       Includes the 1/n scaling, so fft_irfft(fft_rfft(x)) == x.
+ */
+int fft_irfft(const fft_plan_t *p, const fft_cpx_t *in, double *out, fft_cpx_t *work)
+{
+    if (!p || !in || !out || !work || p->half == 0)
+    {
+        fprintf(stderr, "fft_irfft: invalid argument.\n");
+        return -1;
+    }
+
+    const size_t h = p->half;
+    fft_cpx_t *z = work;
+
+    /* 重建 Z[k] = E[k] + i·O[k]，并取共轭以复用正变换。
+     * Rebuild Z[k] = E[k] + i·O[k], conjugated so the forward kernel can be reused. */
+    for (size_t k = 0; k < h; ++k)
+    {
+        fft_cpx_t xk = in[k];
+        fft_cpx_t xc = {in[h - k].re, -in[h - k].im}; /* conj(X[h-k]) */
+        fft_cpx_t e = {0.5 * (xk.re + xc.re), 0.5 * (xk.im + xc.im)};
+        fft_cpx_t d = {0.5 * (xk.re - xc.re), 0.5 * (xk.im - xc.im)};
+        fft_cpx_t tw = p->rtwiddle[k]; /* o = d·conj(tw) */
+        fft_cpx_t o = {d.re * tw.re + d.im * tw.im, d.im * tw.re - d.re * tw.im};
+        z[k].re = e.re - o.im;
+        z[k].im = -(e.im + o.re);
+    }
+
+    const fft_cpx_t *zt = fft_cfft_forward(p, z, work + h);
+    const double scale = 1.0 / (double)h;
+
+    for (size_t k = 0; k < h; ++k)
+    {
+        out[2 * k] = zt[k].re * scale;
+        out[2 * k + 1] = -zt[k].im * scale;
+    }
+
+    return 0;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file mc.c
+ * @brief 多通道序列与批量卷积 / 相关实现 / Multichannel sequences and batch convolution / correlation
+ */
+
+#include "mc.h"
+#include "tune.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief 初始化多通道序列 / Initialize a multichannel sequence.
+ *
+ * @param m 序列指针 / Sequence pointer
+ * @param len 帧数，可以为 0 / Number of frames, may be 0
+ * @param channels 通道数，必须 > 0 / Number of channels, must be > 0
+ * @param layout 数据布局 / Data layout
+ * @return 0 表示成功；非 0 表示参数无效或内存分配失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ *
+ * @note 数据初始化为 0；len 为 0 时 data 为 NULL。Data is zeroed; data is NULL when len is 0.
+ */
+int seq_mc_init(seq_mc_t *m, size_t len, size_t channels, seq_mc_layout_t layout)
+{
+    if (m == NULL || channels == 0)
+    {
+        fprintf(stderr, "seq_mc_init: invalid argument.\n");
+        return -1;
+    }
+
+    m->data = NULL;
+    m->length = 0;
+    m->channels = channels;
+    m->layout = layout;
+    if (len == 0)
+        return 0;
+
+    if (len > SIZE_MAX / sizeof(seq_sample_t) / channels)
+    {
+        fprintf(stderr, "seq_mc_init: size overflow.\n");
+        return -1;
+    }
+    m->data = (seq_sample_t *)calloc(len * channels, sizeof(seq_sample_t));
+    if (m->data == NULL)
+    {
+        fprintf(stderr, "seq_mc_init: failed to allocate memory.\n");
+        return -1;
+    }
+    m->length = len;
+    return 0;
+}
+
+/**
+ * @brief 释放多通道序列 / Free a multichannel sequence.
+ *
+ * @param m 序列指针，可以为 NULL / Sequence pointer, may be NULL
+ */
+void seq_mc_free(seq_mc_t *m)
+{
+    if (m == NULL)
+        return;
+
+    free(m->data);
+    m->data = NULL;
+    m->length = 0;
+}
+
+/**
+ * @brief 取平面布局中一个通道的视图 / View one channel of a planar sequence.
+ *
+ * @param m 平面布局序列 / Planar sequence
+ * @param c 通道号 / Channel index
+ * @param view 输出视图，指向 m 的数据，不需释放 / Output view into m's data, not to be freed
+ * @return 0 表示成功；非 0 表示参数无效或布局为交织。
+ *         0 on success; non-zero on invalid arguments or an interleaved layout.
+ */
+int seq_mc_channel(const seq_mc_t *m, size_t c, seq_t *view)
+{
+    if (m == NULL || view == NULL || c >= m->channels || m->layout != SEQ_MC_PLANAR)
+    {
+        fprintf(stderr, "seq_mc_channel: needs a planar sequence and a valid channel.\n");
+        return -1;
+    }
+    view->data = (m->length > 0) ? m->data + c * m->length : NULL;
+    view->length = m->length;
+    return 0;
+}
+
+/* 内部工具：第 n 帧、第 c 通道的下标 / internal helper: index of frame n, channel c */
+static size_t mc_index(const seq_mc_t *m, size_t n, size_t c)
+{
+    return (m->layout == SEQ_MC_INTERLEAVED) ? n * m->channels + c : c * m->length + n;
+}
+
+/* 内部工具：检查输入并分配输出 / internal helper: validate the inputs and allocate the output */
+static int mc_prepare(const char *fn, const seq_mc_t *a, const seq_mc_t *b, seq_mc_t *out)
+{
+    if (a == NULL || b == NULL || out == NULL)
+    {
+        fprintf(stderr, "%s: null pointer argument.\n", fn);
+        return -1;
+    }
+    if (a->channels == 0 || (b->channels != a->channels && b->channels != 1))
+    {
+        fprintf(stderr, "%s: B must have as many channels as A, or one channel shared by all.\n", fn);
+        return -1;
+    }
+    if (b->channels > 1 && b->layout != a->layout)
+    {
+        fprintf(stderr, "%s: A and B must share a layout.\n", fn);
+        return -1;
+    }
+
+    size_t ly = (a->length == 0 || b->length == 0) ? 0 : a->length + b->length - 1;
+    return seq_mc_init(out, ly, a->channels, a->layout);
+}
+
+/**
+ * @brief 内部工具：交织布局的直接求和，通道为最内层 / internal helper: interleaved direct sums, channels innermost.
+ *
+ * @param a 交织输入 A / interleaved input A
+ * @param b 输入 B，单通道或与 A 同布局 / input B, one channel or A's layout
+ * @param corr 0 为线性卷积，非 0 为互相关 / 0 for linear convolution, non-zero for cross-correlation
+ * @param y 交织输出 / interleaved output (already sized)
+ * @return 0 表示成功；非 0 表示失败。
+ *
+ * @note 每个通道按 k 递增累加，与单通道标量内核逐位一致。
+ *       Each channel sums in increasing k, bit-identical to the scalar single-channel kernels.
+ */
+static int mc_direct(const seq_mc_t *a, const seq_mc_t *b, int corr, seq_mc_t *y)
+{
+    const size_t ch = a->channels;
+    const size_t la = a->length;
+    const size_t lb = b->length;
+    const int shared = (b->channels == 1);
+
+    seq_accum_t *acc = (seq_accum_t *)malloc(ch * sizeof(seq_accum_t));
+    if (acc == NULL)
+    {
+        fprintf(stderr, "mc_direct: failed to allocate accumulators.\n");
+        return -1;
+    }
+
+    for (size_t n = 0; n < y->length; ++n)
+    {
+        size_t k_min, k_max;
+        long shift; /* B 的下标 = shift ± k / B index = shift ± k */
+        int empty = 0;
+
+        if (!corr)
+        {
+            /* y[n] = Σ a[k]·b[n-k] */
+            k_min = (n >= lb - 1) ? n - (lb - 1) : 0;
+            k_max = (n < la - 1) ? n : la - 1;
+            shift = (long)n;
+        }
+        else
+        {
+            /* r[n] = Σ a[k]·b[k+lag], lag = n-(Lb-1)，区间同 ops_corr_at / range as in ops_corr_at */
+            long lag = (long)n - (long)(lb - 1);
+            k_min = (lag < 0) ? (size_t)(-lag) : 0;
+            k_max = la - 1;
+            if ((long)k_max + lag > (long)(lb - 1))
+            {
+                if ((long)(lb - 1) - lag < 0)
+                    empty = 1;
+                else
+                    k_max = (size_t)((long)(lb - 1) - lag);
+            }
+            shift = lag;
+        }
+
+        for (size_t c = 0; c < ch; ++c)
+            acc[c] = 0;
+
+        for (size_t k = k_min; !empty && k <= k_max; ++k)
+        {
+            size_t j = corr ? (size_t)((long)k + shift) : (size_t)(shift - (long)k);
+            const seq_sample_t *ap = a->data + k * ch;
+
+            if (shared)
+            {
+                const seq_sample_t bk = b->data[j];
+                for (size_t c = 0; c < ch; ++c)
+                    acc[c] = seq_accum_mac(acc[c], ap[c], bk);
+            }
+            else
+            {
+                const seq_sample_t *bp = b->data + j * ch;
+                for (size_t c = 0; c < ch; ++c)
+                    acc[c] = seq_accum_mac(acc[c], ap[c], bp[c]);
+            }
+        }
+
+        seq_sample_t *yp = y->data + n * ch;
+        for (size_t c = 0; c < ch; ++c)
+            yp[c] = seq_accum_to_sample(acc[c]);
+    }
+
+    free(acc);
+    return 0;
+}
+
+/* 内部工具：取通道 c 的连续副本或视图 / internal helper: contiguous copy or view of channel c */
+static void mc_gather(const seq_mc_t *m, size_t c, seq_sample_t *buf, seq_t *s)
+{
+    size_t cc = (m->channels == 1) ? 0 : c;
+
+    s->length = m->length;
+    if (m->layout == SEQ_MC_PLANAR || m->channels == 1)
+    {
+        s->data = m->data + cc * m->length;
+        return;
+    }
+    for (size_t n = 0; n < m->length; ++n)
+        buf[n] = m->data[n * m->channels + cc];
+    s->data = buf;
+}
+
+/**
+ * @brief 内部工具：逐通道调用单通道内核 / internal helper: run the single-channel kernel per channel.
+ *
+ * @param ctx 运算上下文，可为 NULL（仅卷积使用）/ operation context, may be NULL (convolution only)
+ * @param a 输入 A / input A
+ * @param b 输入 B / input B
+ * @param corr 0 为线性卷积，非 0 为互相关 / 0 for linear convolution, non-zero for cross-correlation
+ * @param y 输出 / output (already sized, A's layout)
+ * @return 0 表示成功；非 0 表示失败。
+ */
+static int mc_per_channel(ops_ctx_t *ctx, const seq_mc_t *a, const seq_mc_t *b, int corr, seq_mc_t *y)
+{
+    const int inter = (a->layout == SEQ_MC_INTERLEAVED);
+    size_t scratch = y->length + (inter ? a->length : 0) +
+                     ((inter && b->channels > 1) ? b->length : 0);
+    seq_sample_t *buf = NULL;
+    int rc = 0;
+
+    if (scratch > 0)
+    {
+        buf = (seq_sample_t *)malloc(scratch * sizeof(seq_sample_t));
+        if (buf == NULL)
+        {
+            fprintf(stderr, "mc_per_channel: failed to allocate channel buffers.\n");
+            return -1;
+        }
+    }
+    seq_sample_t *ybuf = buf;
+    seq_sample_t *abuf = buf + y->length;
+    seq_sample_t *bbuf = abuf + (inter ? a->length : 0);
+
+    for (size_t c = 0; c < a->channels && rc == 0; ++c)
+    {
+        seq_t sa, sb;
+        size_t n_out = 0;
+        /* 平面输出直接写入通道区间 / planar output is written straight into the channel */
+        seq_sample_t *dst = inter ? ybuf : y->data + c * y->length;
+
+        mc_gather(a, c, abuf, &sa);
+        mc_gather(b, c, bbuf, &sb);
+        rc = corr ? seq_corr_cross_into(&sa, &sb, dst, y->length, &n_out)
+                  : seq_conv_linear_into(ctx, &sa, &sb, dst, y->length, &n_out);
+
+        if (rc == 0 && inter)
+        {
+            for (size_t n = 0; n < n_out; ++n)
+                y->data[mc_index(y, n, c)] = ybuf[n];
+        }
+    }
+
+    free(buf);
+    return rc;
+}
+
+/**
+ * @brief 多通道线性卷积 / Multichannel linear convolution.
+ *
+ * @param ctx 运算上下文，传给单通道 FFT 内核，可为 NULL / Context for the single-channel FFT kernels, may be NULL
+ * @param a 输入 A，C 个通道 / Input A with C channels
+ * @param b 输入 B：C 个通道逐通道配对，或 1 个通道供全部通道共用（滤波器组）
+ *          Input B: C channels paired channel by channel, or one channel shared by all (filter bank)
+ * @param out 输出，布局与通道数同 A，帧数 La + Lb - 1 / Output with A's layout and channels, La + Lb - 1 frames
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note
+ * - A 为交织布局且单通道接口会走调用线程上的直接求和时（未装分发表时即 min(La, Lb)
+ *   低于 FFT 阈值，装表时即表中为 DIRECT），直接求和一次覆盖全部通道，
+ *   内层循环沿通道连续，可向量化，单线程；
+ *   When A is interleaved and the single-channel entry point would take
+ *   direct sums on the calling thread (min(La, Lb) below the FFT threshold
+ *   without a dispatch table, DIRECT in an installed one), the direct sums
+ *   cover every channel at once with a contiguous inner loop across
+ *   channels, which vectorizes; this path is single-threaded.
+ * - 其余情况逐通道调用 seq_conv_linear_into()（FFT、向量化、多线程与分发表不变）。
+ *   Otherwise seq_conv_linear_into() runs per channel, keeping its FFT, SIMD,
+ *   thread and dispatch table paths.
+ * - 每个通道的结果与对该通道单独调用 seq_conv_linear() 逐位一致。
+ *   Each channel is bit-identical to seq_conv_linear() on that channel alone.
+ */
+int seq_mc_conv_linear(ops_ctx_t *ctx, const seq_mc_t *a, const seq_mc_t *b, seq_mc_t *out)
+{
+    if (mc_prepare("seq_mc_conv_linear", a, b, out) != 0)
+        return -1;
+    if (out->length == 0)
+        return 0;
+
+    size_t lmin = (a->length < b->length) ? a->length : b->length;
+    size_t lmax = (a->length < b->length) ? b->length : a->length;
+    const tune_path_t path = tune_path(TUNE_OP_CONV_LINEAR, lmin, lmax);
+    const int direct = (path == TUNE_PATH_AUTO) ? (lmin < ops_get_fft_threshold()) : (path == TUNE_PATH_DIRECT);
+    int rc = (a->layout == SEQ_MC_INTERLEAVED && direct) ? mc_direct(a, b, 0, out)
+                                                          : mc_per_channel(ctx, a, b, 0, out);
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_mc_conv_linear: computation failed.\n");
+        seq_mc_free(out);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 多通道互相关 / Multichannel cross-correlation.
+ *
+ * @param a 输入 A，C 个通道 / Input A with C channels
+ * @param b 输入 B：C 个通道或 1 个共用通道 / Input B: C channels or one shared channel
+ * @param out 输出，布局与通道数同 A，帧数 La + Lb - 1 / Output with A's layout and channels, La + Lb - 1 frames
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 定义与滞后下标同 seq_corr_cross()。交织布局走跨通道直接求和，除非装入的分发表
+ *       （tune.h）为这对长度选了多线程或 FFT；平面布局与这些情况逐通道调用
+ *       seq_corr_cross_into()。每个通道的结果都与单通道调用逐位一致。
+ *       Definition and lag indexing follow seq_corr_cross(). The interleaved
+ *       layout takes the cross-channel direct sums unless an installed
+ *       dispatch table (tune.h) picks threaded sums or the FFT for these
+ *       lengths; the planar layout and those cases call seq_corr_cross_into()
+ *       per channel. Each channel is bit-identical to the single-channel call.
+ */
+int seq_mc_corr_cross(const seq_mc_t *a, const seq_mc_t *b, seq_mc_t *out)
+{
+    if (mc_prepare("seq_mc_corr_cross", a, b, out) != 0)
+        return -1;
+    if (out->length == 0)
+        return 0;
+
+    size_t lmin = (a->length < b->length) ? a->length : b->length;
+    size_t lmax = (a->length < b->length) ? b->length : a->length;
+    const tune_path_t path = tune_path(TUNE_OP_CORR_CROSS, lmin, lmax);
+    const int direct = (path == TUNE_PATH_AUTO || path == TUNE_PATH_DIRECT);
+    int rc = (a->layout == SEQ_MC_INTERLEAVED && direct) ? mc_direct(a, b, 1, out)
+                                                          : mc_per_channel(NULL, a, b, 1, out);
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_mc_corr_cross: computation failed.\n");
+        seq_mc_free(out);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file ooc.c
+ * @brief 超出内存的分块卷积实现 / Out-of-core chunked convolution implementation
+ *
+ * 长序列 x 与短序列 h 都切成长度 B 的块，块 X_i、H_j 的 2B 点频谱相乘后
+ * 落在输出块 i + j 上。输出块 m 的频谱 Y_m = Σ_{i+j=m} X_i·H_j 只做一次逆变换，
+ * 前 B 个点加上一块留下的尾部即可写出，后 B 个点作为新的尾部。
+ * The long sequence x and the short sequence h are both cut into blocks of
+ * length B; the product of the 2B-point spectra of X_i and H_j lands on
+ * output block i + j. The spectrum Y_m = Σ_{i+j=m} X_i·H_j of output block m
+ * takes a single inverse transform: its first B points plus the tail left by
+ * the previous block are final, and its last B points become the new tail.
+ */
+
+#include "ooc.h"
+#include "fft.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 内部工具：读取第 idx 块并求其 nfft 点频谱 / internal helper: read block idx and take its nfft-point spectrum */
+static int ooc_block_spectrum(const seq_file_t *f, size_t idx, size_t block,
+                              const fft_plan_t *plan, seq_sample_t *stage, double *buf,
+                              fft_cpx_t *out, fft_cpx_t *work)
+{
+    if (seq_file_read(f, (uint64_t)idx * block, stage, block) != 0)
+        return -1;
+
+    for (size_t i = 0; i < block; ++i)
+        buf[i] = seq_sample_to_double(stage[i]);
+    for (size_t i = block; i < plan->n; ++i)
+        buf[i] = 0.0;
+
+    return fft_rfft(plan, buf, out, work);
+}
+
+/* 内部工具：acc += x·h（逐频点复乘累加）/ internal helper: acc += x·h, bin by bin */
+static void ooc_spectrum_mac(fft_cpx_t *acc, const fft_cpx_t *x, const fft_cpx_t *h, size_t nbin)
+{
+    for (size_t k = 0; k < nbin; ++k)
+    {
+        acc[k].re += x[k].re * h[k].re - x[k].im * h[k].im;
+        acc[k].im += x[k].re * h[k].im + x[k].im * h[k].re;
+    }
+}
+
+/**
+ * @brief 文件中两条序列的线性卷积 / Linear convolution of two file-backed sequences.
+ *
+ * @param a 第一条序列 / First sequence
+ * @param b 第二条序列 / Second sequence
+ * @param block 块大小（样本数），0 表示 OOC_BLOCK_DEFAULT / Block size in samples, 0 for OOC_BLOCK_DEFAULT
+ * @param cache_bytes 频谱缓存上限（字节）/ Spectrum cache limit in bytes
+ * @param sink 输出回调，按顺序收到全部 la + lb - 1 个样本 / Sink receiving all la + lb - 1 samples in order
+ * @param ctx 回调上下文 / Sink context
+ * @return 0 表示成功；非 0 表示参数无效、读取失败、内存不足或回调中止。
+ *         0 on success; non-zero on invalid arguments, a read failure, out of memory or a sink abort.
+ *
+ * @note 若短序列全部块的频谱与长序列最近同样多块的频谱能放进 cache_bytes，
+ *       每块只读取并变换一次，代价与内存版分块 FFT 相同；否则每对块都重新读取
+ *       并变换，内存保持 O(B)，换来 I/O 与变换次数随两者块数的乘积增长。
+ *       任一序列为空时不调用回调。计算统一用 double。
+ *       When the spectra of all blocks of the short sequence and of as many
+ *       recent blocks of the long one fit in cache_bytes, every block is read
+ *       and transformed once and the cost matches the in-memory blocked FFT;
+ *       otherwise each pair of blocks is re-read and re-transformed, keeping
+ *       memory at O(B) while I/O and transforms grow with the product of the
+ *       block counts. The sink is not called when either sequence is empty.
+ *       Arithmetic is always in double.
+ */
+int ooc_conv_linear(const seq_file_t *a, const seq_file_t *b, size_t block, size_t cache_bytes,
+                    ooc_sink_fn sink, void *ctx)
+{
+    if (a == NULL || b == NULL || sink == NULL)
+    {
+        fprintf(stderr, "ooc_conv_linear: NULL pointer argument.\n");
+        return -1;
+    }
+    if (a->length == 0 || b->length == 0)
+        return 0;
+
+    /* x 为较长者，h 为较短者 / x is the longer sequence, h the shorter */
+    const seq_file_t *x = (a->length >= b->length) ? a : b;
+    const seq_file_t *h = (x == a) ? b : a;
+    uint64_t ly = x->length + h->length - 1;
+
+    if (block == 0)
+        block = OOC_BLOCK_DEFAULT;
+    if (block > x->length)
+        block = (size_t)x->length;
+
+    size_t nfft = fft_good_size(2 * block);
+    size_t nbin = nfft / 2 + 1;
+    const fft_plan_t *plan = fft_plan_get(nfft);
+    if (plan == NULL)
+    {
+        fprintf(stderr, "ooc_conv_linear: failed to create FFT plan of length %zu.\n", nfft);
+        return -1;
+    }
+
+    size_t nx = (size_t)((x->length + block - 1) / block);
+    size_t nh = (size_t)((h->length + block - 1) / block);
+    size_t spec_bytes = nbin * sizeof(fft_cpx_t);
+    int cached = nh <= cache_bytes / (2 * spec_bytes);
+
+    /* 缓存模式：hs 为 h 全部块频谱，xs 为 x 最近 nh 块的环形缓冲；
+     * 否则 hs、xs 各只容纳一块。
+     * cached: hs holds every block spectrum of h and xs is a ring of the
+     * last nh block spectra of x; otherwise each holds a single block. */
+    size_t nspec = cached ? nh : 1;
+    fft_cpx_t *acc = (fft_cpx_t *)malloc((1 + 2 * nspec) * spec_bytes + nfft * sizeof(fft_cpx_t) +
+                                         (nfft + block) * sizeof(double) + block * sizeof(seq_sample_t));
+    if (acc == NULL)
+    {
+        fprintf(stderr, "ooc_conv_linear: failed to allocate buffers for block size %zu.\n", block);
+        return -1;
+    }
+    fft_cpx_t *hs = acc + nbin;
+    fft_cpx_t *xs = hs + nspec * nbin;
+    fft_cpx_t *work = xs + nspec * nbin;
+    double *buf = (double *)(work + nfft);
+    double *tail = buf + nfft;
+    seq_sample_t *stage = (seq_sample_t *)(tail + block);
+
+    int rc = 0;
+    for (size_t j = 0; cached && j < nh && rc == 0; ++j)
+        rc = ooc_block_spectrum(h, j, block, plan, stage, buf, hs + j * nbin, work);
+    for (size_t i = 0; i < block; ++i)
+        tail[i] = 0.0;
+
+    uint64_t emitted = 0;
+    size_t nout = nx + nh - 1;
+
+    for (size_t m = 0; m < nout && rc == 0; ++m)
+    {
+        for (size_t k = 0; k < nbin; ++k)
+            acc[k].re = acc[k].im = 0.0;
+
+        if (cached && m < nx)
+            rc = ooc_block_spectrum(x, m, block, plan, stage, buf, xs + (m % nh) * nbin, work);
+
+        size_t i_lo = (m + 1 >= nh) ? m + 1 - nh : 0;
+        size_t i_hi = (m < nx - 1) ? m : nx - 1;
+
+        for (size_t i = i_lo; i <= i_hi && rc == 0; ++i)
+        {
+            size_t j = m - i;
+            if (cached)
+            {
+                ooc_spectrum_mac(acc, xs + (i % nh) * nbin, hs + j * nbin, nbin);
+                continue;
+            }
+            rc = ooc_block_spectrum(x, i, block, plan, stage, buf, xs, work);
+            if (rc == 0)
+                rc = ooc_block_spectrum(h, j, block, plan, stage, buf, hs, work);
+            if (rc == 0)
+                ooc_spectrum_mac(acc, xs, hs, nbin);
+        }
+        if (rc != 0)
+            break;
+
+        fft_irfft(plan, acc, buf, work);
+
+        /* 前 B 点加上旧尾部即为最终输出，后 B 点成为新尾部
+         * the first B points plus the old tail are final; the last B become the new tail */
+        for (size_t i = 0; i < block; ++i)
+        {
+            stage[i] = seq_sample_from_double(buf[i] + tail[i]);
+            tail[i] = buf[block + i];
+        }
+
+        size_t n = (ly - emitted < block) ? (size_t)(ly - emitted) : block;
+        if (n > 0 && sink(ctx, stage, n) != 0)
+            rc = -1;
+        emitted += n;
+    }
+
+    /* 最后一块的尾部 / the tail of the last block */
+    if (rc == 0 && emitted < ly)
+    {
+        size_t n = (size_t)(ly - emitted);
+        for (size_t i = 0; i < n; ++i)
+            stage[i] = seq_sample_from_double(tail[i]);
+        if (sink(ctx, stage, n) != 0)
+            rc = -1;
+    }
+
+    free(acc);
+    if (rc != 0)
+        fprintf(stderr, "ooc_conv_linear: convolution failed.\n");
+    return rc;
+}
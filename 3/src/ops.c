@@ -5,11 +5,62 @@
 
 #include "ops.h"
 #include "seq.h"
+#include "fft.h"
+#include "simd.h"
+#include "pool.h"
+#include "stats.h"
+#include "tune.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
+/* double 存储与累加时使用向量化内核 / vector kernels apply to double storage and accumulation */
+#if SEQ_SAMPLE_IS_DOUBLE && SEQ_ACCUM_IS_DOUBLE
+#define OPS_SIMD 1
+#else
+#define OPS_SIMD 0
+#endif
+
+/* 反向互相关分块的暂存输出数 / staged outputs per chunk of the reversed correlation tile */
+#define OPS_TILE_CHUNK 256
+
+/* FFT 快速路径阈值 / FFT fast-path threshold */
+static size_t ops_fft_threshold = OPS_FFT_THRESHOLD_DEFAULT;
+
+/* 线程池；NULL 表示单线程 / thread pool, NULL when single-threaded */
+static pool_t *ops_pool = NULL;
+
+/**
+ * @brief 两序列运算的任务上下文 / Task context of a two-sequence operation
+ */
+typedef struct
+{
+    const seq_t *a;  /**< 序列 A / sequence A */
+    const seq_t *b;  /**< 序列 B / sequence B */
+    seq_sample_t *y; /**< 输出 / output */
+} ops_pair_ctx_t;
+
+/**
+ * @brief 分块 FFT 卷积的任务上下文 / Task context of the blocked FFT convolution
+ */
+typedef struct
+{
+    const seq_sample_t *x;  /**< 长序列 / long sequence */
+    size_t lx;              /**< 长序列长度 / long length */
+    size_t k;               /**< 短序列长度 / short length */
+    const fft_plan_t *plan; /**< 块变换计划 / block transform plan */
+    const fft_cpx_t *h;     /**< 短序列频谱 / spectrum of the short sequence */
+    size_t block;           /**< 每块输出数 / outputs per block */
+    size_t ly;              /**< 输出长度 / output length */
+    seq_sample_t *y;        /**< 输出 / output */
+    unsigned char *scratch; /**< 每块一个暂存槽 / one scratch slot per chunk */
+    size_t slot_bytes;      /**< 暂存槽字节数 / bytes per scratch slot */
+    size_t grain;           /**< 每块的块数，槽号 = j0 / grain / blocks per chunk; slot = j0 / grain */
+} ops_fft_block_ctx_t;
+
 /* 内部工具：安全释放并清零，用于出错回滚 / internal helper to free sequence on error */
 static void ops_reset_seq(seq_t *s)
 {
@@ -21,294 +72,1695 @@ static void ops_reset_seq(seq_t *s)
 }
 
 /**
- * @brief 序列逐点加法 / Point-wise addition of two sequences.
+ * @brief 设置 FFT 快速路径阈值 / Set the FFT fast-path threshold.
+ *
+ * @param threshold 新阈值；0 表示总是使用 FFT，SIZE_MAX 表示禁用。
+ *                  New threshold; 0 always uses the FFT, SIZE_MAX disables it.
+ */
+void ops_set_fft_threshold(size_t threshold)
+{
+    ops_fft_threshold = threshold;
+}
+
+/**
+ * @brief 读取 FFT 快速路径阈值 / Get the FFT fast-path threshold.
+ */
+size_t ops_get_fft_threshold(void)
+{
+    return ops_fft_threshold;
+}
+
+/**
+ * @brief 设置卷积与相关使用的线程数 / Set the thread count for convolution and correlation.
+ *
+ * @param nthreads 线程总数（含调用线程）；0 表示使用全部在线 CPU，1 表示单线程。
+ *                 Total threads including the caller; 0 uses every online CPU, 1 is single-threaded.
+ * @return 0 表示成功；非 0 表示创建线程失败（此时回到单线程）。
+ *         0 on success; non-zero if the workers could not be started (falls back to one thread).
+ *
+ * @note 结果与线程数无关：每个输出只由一个任务按固定顺序计算，分块方式只取决于序列长度。
+ *       Results do not depend on the thread count: each output is computed by
+ *       one task in a fixed order, and the split depends only on the lengths.
+ */
+int ops_set_threads(size_t nthreads)
+{
+    if (nthreads == 0)
+        nthreads = pool_cpu_count();
+
+    if (nthreads == pool_size(ops_pool))
+        return 0;
+
+    pool_destroy(ops_pool);
+    ops_pool = NULL;
+    if (nthreads == 1)
+        return 0;
+
+    /* 内核分发在主线程上完成检测 / resolve kernel dispatch on this thread first */
+    simd_get_isa();
+
+    ops_pool = pool_create(nthreads);
+    if (ops_pool == NULL)
+    {
+        fprintf(stderr, "ops_set_threads: failed to start %zu threads.\n", nthreads);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 读取线程数 / Get the thread count.
+ */
+size_t ops_get_threads(void)
+{
+    return pool_size(ops_pool);
+}
+
+/**
+ * @brief 内部工具：并行执行的块大小 / internal helper: chunk size of a parallel run.
+ *
+ * @param n 下标总数 / index count
+ * @param cost 每个下标的近似乘加数 / approximate multiply-adds per index
+ * @return 每块下标数；返回 n（或 n 为 0 时 1）表示在调用线程上一次算完。
+ *         Indices per chunk; n (or 1 when n is 0) means one run on the caller.
+ *
+ * @note 总工作量低于 OPS_PAR_MIN_WORK 时不拆分。
+ *       Below OPS_PAR_MIN_WORK total work nothing is split.
+ */
+static size_t ops_grain(size_t n, size_t cost)
+{
+    size_t threads = pool_size(ops_pool);
+
+    if (threads <= 1 || n < 2 || cost == 0 || n < OPS_PAR_MIN_WORK / cost)
+        return (n > 0) ? n : 1;
+
+    /* 每线程约 4 块以平衡负载 / about four chunks per thread for load balance */
+    size_t chunks = 4 * threads;
+    return (n + chunks - 1) / chunks;
+}
+
+/**
+ * @brief 内部工具：按调优路径给出直接求和的块大小 / internal helper: direct-sum grain for a tuned path.
+ *
+ * @param path tune_path() 的结果 / result of tune_path()
+ * @param n 下标总数 / index count
+ * @param cost 每个下标的近似乘加数 / approximate multiply-adds per index
+ * @return DIRECT 不拆分，THREADED 总是拆分（线程数 > 1 时），AUTO 同 ops_grain()。
+ *         DIRECT never splits, THREADED always splits (with more than one
+ *         thread), AUTO is ops_grain().
+ */
+static size_t ops_tuned_grain(tune_path_t path, size_t n, size_t cost)
+{
+    if (path == TUNE_PATH_DIRECT)
+        return (n > 0) ? n : 1;
+    if (path == TUNE_PATH_THREADED)
+        return ops_grain(n, OPS_PAR_MIN_WORK);
+    return ops_grain(n, cost);
+}
+
+/**
+ * @brief 内部工具：按下标区间并行执行 / internal helper: run a range task in parallel.
+ *
+ * @param n 下标总数 / index count
+ * @param grain ops_grain() 给出的块大小 / chunk size from ops_grain()
+ * @param fn 任务 / task
+ * @param ctx 上下文 / context
+ * @return 0 表示成功；非 0 表示失败。
+ */
+static int ops_parallel_for(size_t n, size_t grain, pool_task_fn fn, void *ctx)
+{
+    if (grain >= n)
+        return fn(ctx, 0, n);
+    return pool_run(ops_pool, n, grain, fn, ctx);
+}
+
+/**
+ * @brief 内部工具：取暂存内存 / internal helper: get scratch memory.
+ *
+ * @param ctx 运算上下文；NULL 时使用 malloc / operation context; NULL uses malloc
+ * @param bytes 字节数 / byte count
+ * @return 指针；失败返回 NULL。/ Pointer, or NULL on failure.
+ *
+ * @note 上下文中的暂存在 *_into 返回前统一回退，不需逐个释放。
+ *       Context scratch is rewound as a whole before *_into returns.
+ */
+static void *ops_scratch_get(ops_ctx_t *ctx, size_t bytes)
+{
+    return (ctx != NULL) ? arena_alloc(&ctx->arena, bytes) : malloc(bytes);
+}
+
+/* 内部工具：归还暂存内存 / internal helper: release scratch memory */
+static void ops_scratch_put(ops_ctx_t *ctx, void *p)
+{
+    if (ctx == NULL)
+        free(p);
+}
+
+/**
+ * @brief 内部工具：FFT 线性卷积 / internal helper: linear convolution via FFT.
+ *
+ * @param ctx 暂存来源，可为 NULL / scratch source, may be NULL
+ * @param a 序列 A 数据 / data of A (length la > 0)
+ * @param b 序列 B 数据 / data of B (length lb > 0)
+ * @param fold 0 表示输出完整线性卷积；否则按周期 fold 折叠（圆周卷积）。
+ *             0 emits the full linear convolution; otherwise it is folded modulo fold.
+ * @param y 输出缓冲，长度 la + lb - 1 或 fold / output buffer of length la + lb - 1 or fold
+ * @return 0 表示成功；非 0 表示内存失败。/ 0 on success; non-zero on allocation failure.
+ *
+ * @note 变换始终以 double 计算，仅在写出时转换为 seq_sample_t（定点时饱和）。
+ *       The transform always runs in double; results are narrowed to
+ *       seq_sample_t (saturating for fixed point) only when written out.
+ */
+static int ops_fft_conv(ops_ctx_t *ctx,
+                        const seq_sample_t *a, size_t la,
+                        const seq_sample_t *b, size_t lb,
+                        size_t fold, seq_sample_t *y)
+{
+    size_t ly = la + lb - 1;
+    size_t nfft = fft_good_size(ly);
+    size_t nbin = nfft / 2 + 1;
+
+    const fft_plan_t *plan = fft_plan_get(nfft);
+    if (!plan)
+    {
+        fprintf(stderr, "ops_fft_conv: failed to create FFT plan of length %zu.\n", nfft);
+        return -1;
+    }
+
+    /* 一次取齐全部暂存：频谱在前以保持 16 字节对齐 / one scratch block, spectra first */
+    fft_cpx_t *fa = (fft_cpx_t *)ops_scratch_get(ctx, (2 * nbin + nfft) * sizeof(fft_cpx_t) +
+                                                          nfft * sizeof(double));
+    if (!fa)
+    {
+        fprintf(stderr, "ops_fft_conv: failed to allocate FFT buffers.\n");
+        return -1;
+    }
+    fft_cpx_t *fb = fa + nbin;
+    fft_cpx_t *work = fb + nbin;
+    double *buf = (double *)(work + nfft);
+
+    for (size_t i = 0; i < nfft; ++i)
+        buf[i] = (i < la) ? seq_sample_to_double(a[i]) : 0.0;
+    fft_rfft(plan, buf, fa, work);
+
+    for (size_t i = 0; i < nfft; ++i)
+        buf[i] = (i < lb) ? seq_sample_to_double(b[i]) : 0.0;
+    fft_rfft(plan, buf, fb, work);
+
+    for (size_t k = 0; k < nbin; ++k)
+    {
+        double re = fa[k].re * fb[k].re - fa[k].im * fb[k].im;
+        double im = fa[k].re * fb[k].im + fa[k].im * fb[k].re;
+        fa[k].re = re;
+        fa[k].im = im;
+    }
+    fft_irfft(plan, fa, buf, work);
+
+    if (fold == 0)
+    {
+        for (size_t n = 0; n < ly; ++n)
+            y[n] = seq_sample_from_double(buf[n]);
+    }
+    else
+    {
+        for (size_t n = 0; n < fold; ++n)
+        {
+            double acc = buf[n];
+            if (n + fold < ly)
+                acc += buf[n + fold];
+            y[n] = seq_sample_from_double(acc);
+        }
+    }
+
+    ops_scratch_put(ctx, fa);
+    return 0;
+}
+
+/* 内部工具：直接线性卷积的第 n 个输出 / internal helper: output n of the direct linear convolution */
+static seq_sample_t ops_conv_at(const seq_t *a, const seq_t *b, size_t n)
+{
+    size_t la = a->length;
+    size_t lb = b->length;
+    seq_accum_t acc = 0;
+
+    /* k runs over indices of a; n-k must be valid index of b */
+    size_t k_min = (n >= lb - 1) ? (n - (lb - 1)) : 0;
+    size_t k_max = (n < la - 1) ? n : (la - 1);
+
+    for (size_t k = k_min; k <= k_max; ++k)
+    {
+        size_t j = n - k; /* index into b */
+        acc = seq_accum_mac(acc, a->data[k], b->data[j]);
+    }
+
+    return seq_accum_to_sample(acc);
+}
+
+/* 内部工具：互相关的第 n 个输出 / internal helper: output n of the cross-correlation */
+static seq_sample_t ops_corr_at(const seq_t *a, const seq_t *b, size_t n)
+{
+    size_t la = a->length;
+    size_t lb = b->length;
+    long lag = (long)n - (long)(lb - 1);
+    seq_accum_t acc = 0;
+
+    /* sum over k where indices are in range:
+     * x index = k
+     * y index = k + lag
+     */
+    size_t k_start = 0;
+    if (lag < 0)
+    {
+        k_start = (size_t)(-lag);
+    }
+    size_t k_end = la - 1;
+    int overlap = 1;
+    if ((long)k_end + lag > (long)(lb - 1))
+    {
+        /* lag > lb-1 时没有重叠，避免越界读取 b / no overlap when lag > lb-1; avoid reading past b */
+        if ((long)(lb - 1) - lag < 0)
+            overlap = 0;
+        else
+            k_end = (size_t)((long)(lb - 1) - lag);
+    }
+
+    if (overlap && k_start <= k_end)
+    {
+        for (size_t k = k_start; k <= k_end; ++k)
+        {
+            size_t idx_y = (size_t)((long)k + lag);
+            acc = seq_accum_mac(acc, a->data[k], b->data[idx_y]);
+        }
+    }
+
+    return seq_accum_to_sample(acc);
+}
+
+/**
+ * @brief 内部工具：线性卷积输出区间 [n0, n1) / internal helper: linear convolution outputs [n0, n1).
+ *
+ * @note 稳态区（La ≤ Lb 时 n ∈ [La-1, Lb-1]，反之 n ∈ [Lb-1, La-1]）内每个输出的求和项数相同，
+ *       交给向量分块；其余逐点计算。两者与标量循环逐位一致。
+ *       Outputs in the steady state sum the same number of terms and go to the
+ *       vector tiles; the rest are computed one by one. Both match the scalar
+ *       loop bit for bit.
+ */
+static int ops_conv_task(void *arg, size_t n0, size_t n1)
+{
+    const ops_pair_ctx_t *c = (const ops_pair_ctx_t *)arg;
+    const seq_t *a = c->a;
+    const seq_t *b = c->b;
+    size_t lo = n1;
+    size_t hi = n1;
+
+#if OPS_SIMD
+    size_t la = a->length;
+    size_t lb = b->length;
+    size_t s_lo = (la <= lb) ? la - 1 : lb - 1;
+    size_t s_hi = (la <= lb) ? lb : la;
+    lo = (n0 > s_lo) ? n0 : s_lo;
+    hi = (n1 < s_hi) ? n1 : s_hi;
+    if (lo >= hi)
+    {
+        lo = n1;
+        hi = n1;
+    }
+    else if (la <= lb)
+    {
+        /* y[n] = Σ_k a[k]·b[n-k]，k ∈ [0, La-1] */
+        simd_dot_tile_f64(a->data, 1, la, b->data + lo, -1, c->y + lo, hi - lo);
+    }
+    else
+    {
+        /* y[n] = Σ_t b[Lb-1-t]·a[n-Lb+1+t]，按 k 升序 / in ascending k */
+        simd_dot_tile_f64(b->data + (lb - 1), -1, lb, a->data + (lo - (lb - 1)), 1, c->y + lo, hi - lo);
+    }
+#endif
+
+    for (size_t n = n0; n < lo; ++n)
+        c->y[n] = ops_conv_at(a, b, n);
+    for (size_t n = hi; n < n1; ++n)
+        c->y[n] = ops_conv_at(a, b, n);
+    return 0;
+}
+
+/**
+ * @brief 内部工具：圆周卷积输出区间 [n0, n1) / internal helper: circular convolution outputs [n0, n1).
+ */
+static int ops_conv_circular_task(void *arg, size_t n0, size_t n1)
+{
+    const ops_pair_ctx_t *c = (const ops_pair_ctx_t *)arg;
+    size_t nlen = c->a->length;
+
+    for (size_t n = n0; n < n1; ++n)
+    {
+        seq_accum_t acc = 0;
+        for (size_t k = 0; k < nlen; ++k)
+        {
+            size_t j = (n + nlen - k) % nlen; /* (n-k) mod N */
+            acc = seq_accum_mac(acc, c->a->data[k], c->b->data[j]);
+        }
+        c->y[n] = seq_accum_to_sample(acc);
+    }
+    return 0;
+}
+
+/**
+ * @brief 内部工具：互相关输出区间 [n0, n1) / internal helper: cross-correlation outputs [n0, n1).
+ *
+ * @note 完整重叠的滞后由向量分块计算：La ≤ Lb 时 lag ∈ [0, min(Lb-La, La-1)]，
+ *       r = Σ_k a[k]·b[k+lag]；La > Lb 时 lag = -i ∈ [-min(La-Lb, Lb-1), 0]，
+ *       r = Σ_m b[m]·a[m+i]，按 i 分块算出后逆序写回。
+ *       Lags with full overlap go to the vector tiles; for La > Lb the outputs
+ *       run backwards in i, so they are staged per chunk and written reversed.
+ */
+static int ops_corr_task(void *arg, size_t n0, size_t n1)
+{
+    const ops_pair_ctx_t *c = (const ops_pair_ctx_t *)arg;
+    const seq_t *a = c->a;
+    const seq_t *b = c->b;
+    size_t lo = n1;
+    size_t hi = n1;
+
+#if OPS_SIMD
+    size_t la = a->length;
+    size_t lb = b->length;
+    size_t s_lo, s_hi;
+    if (la <= lb)
+    {
+        s_lo = lb - 1;
+        s_hi = s_lo + ((lb - la < la - 1) ? lb - la : la - 1) + 1;
+    }
+    else
+    {
+        s_hi = lb;
+        s_lo = lb - (((la - lb < lb - 1) ? la - lb : lb - 1) + 1);
+    }
+    lo = (n0 > s_lo) ? n0 : s_lo;
+    hi = (n1 < s_hi) ? n1 : s_hi;
+    if (lo >= hi)
+    {
+        lo = n1;
+        hi = n1;
+    }
+    else if (la <= lb)
+    {
+        simd_dot_tile_f64(a->data, 1, la, b->data + (lo - (lb - 1)), 1, c->y + lo, hi - lo);
+    }
+    else
+    {
+        size_t i_first = lb - hi; /* i = Lb-1-n */
+        size_t cnt = hi - lo;
+        double tmp[OPS_TILE_CHUNK];
+        for (size_t j0 = 0; j0 < cnt; j0 += OPS_TILE_CHUNK)
+        {
+            size_t m = (cnt - j0 < OPS_TILE_CHUNK) ? cnt - j0 : OPS_TILE_CHUNK;
+            simd_dot_tile_f64(b->data, 1, lb, a->data + i_first + j0, 1, tmp, m);
+            for (size_t j = 0; j < m; ++j)
+                c->y[lb - 1 - (i_first + j0 + j)] = tmp[j];
+        }
+    }
+#endif
+
+    for (size_t n = n0; n < lo; ++n)
+        c->y[n] = ops_corr_at(a, b, n);
+    for (size_t n = hi; n < n1; ++n)
+        c->y[n] = ops_corr_at(a, b, n);
+    return 0;
+}
+
+/**
+ * @brief 内部工具：分块 FFT 卷积的块 [j0, j1) / internal helper: blocks [j0, j1) of the blocked FFT convolution.
+ *
+ * @note 重叠保留：第 j 块变换 x[jB-(K-1), jB+B) 并与短序列频谱相乘，
+ *       取后 B 个点作为 y[jB, jB+B)。
+ *       Overlap-save: block j transforms x[jB-(K-1), jB+B), multiplies by the
+ *       short sequence's spectrum and keeps the last B points as y[jB, jB+B).
+ */
+static int ops_fft_block_task(void *arg, size_t j0, size_t j1)
+{
+    const ops_fft_block_ctx_t *c = (const ops_fft_block_ctx_t *)arg;
+    size_t nfft = c->plan->n;
+    size_t nbin = nfft / 2 + 1;
+    size_t k1 = c->k - 1;
+
+    fft_cpx_t *spec = (fft_cpx_t *)(c->scratch + (j0 / c->grain) * c->slot_bytes);
+    fft_cpx_t *work = spec + nbin;
+    double *buf = (double *)(work + nfft);
+
+    for (size_t j = j0; j < j1; ++j)
+    {
+        size_t base = j * c->block;
+
+        for (size_t m = 0; m < nfft; ++m)
+        {
+            size_t off = base + m; /* x 下标 + (K-1) / x index + (K-1) */
+            buf[m] = (off >= k1 && off - k1 < c->lx) ? seq_sample_to_double(c->x[off - k1]) : 0.0;
+        }
+        fft_rfft(c->plan, buf, spec, work);
+
+        for (size_t q = 0; q < nbin; ++q)
+        {
+            double re = spec[q].re * c->h[q].re - spec[q].im * c->h[q].im;
+            double im = spec[q].re * c->h[q].im + spec[q].im * c->h[q].re;
+            spec[q].re = re;
+            spec[q].im = im;
+        }
+        fft_irfft(c->plan, spec, buf, work);
+
+        for (size_t i = 0; i < c->block && base + i < c->ly; ++i)
+            c->y[base + i] = seq_sample_from_double(buf[k1 + i]);
+    }
+    return 0;
+}
+
+/**
+ * @brief 内部工具：长序列与短序列的分块 FFT 卷积 / internal helper: blocked FFT convolution of a long and a short sequence.
+ *
+ * @param ctx 暂存来源，可为 NULL / scratch source, may be NULL
+ * @param x 长序列 / long sequence (length lx)
+ * @param h 短序列 / short sequence (length k ≤ lx)
+ * @param y 输出，长度 lx + k - 1 / output of length lx + k - 1
+ * @return 0 表示成功；非 0 表示失败。
+ *
+ * @note 块长 fft_good_size(OPS_FFT_BLOCK_FACTOR·k) 只取决于 k，各块独立，可并行。
+ *       每个并行块的暂存槽在调用线程上预先取好，工作线程不做分配。
+ *       The block length depends on k only; blocks are independent and run in
+ *       parallel. Each chunk's scratch slot is taken up front on the calling
+ *       thread, so workers never allocate.
+ */
+static int ops_fft_conv_blocked(ops_ctx_t *ctx,
+                                const seq_sample_t *x, size_t lx,
+                                const seq_sample_t *h, size_t k,
+                                seq_sample_t *y)
+{
+    size_t nfft = fft_good_size(OPS_FFT_BLOCK_FACTOR * k);
+    size_t nbin = nfft / 2 + 1;
+    size_t ly = lx + k - 1;
+
+    const fft_plan_t *plan = fft_plan_get(nfft);
+    if (!plan)
+    {
+        fprintf(stderr, "ops_fft_conv_blocked: failed to create FFT plan of length %zu.\n", nfft);
+        return -1;
+    }
+
+    size_t block = nfft - (k - 1);
+    size_t nblocks = (ly + block - 1) / block;
+    size_t grain = ops_grain(nblocks, nfft * 8);
+    size_t nslots = (nblocks + grain - 1) / grain;
+
+    /* 槽按 ARENA_ALIGN 取整，避免相邻线程伪共享 / slots rounded to ARENA_ALIGN against false sharing */
+    size_t slot_bytes = (nbin + nfft) * sizeof(fft_cpx_t) + nfft * sizeof(double);
+    slot_bytes = (slot_bytes + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    fft_cpx_t *hs = (fft_cpx_t *)ops_scratch_get(ctx, nbin * sizeof(fft_cpx_t) + ARENA_ALIGN +
+                                                          nslots * slot_bytes);
+    if (!hs)
+    {
+        fprintf(stderr, "ops_fft_conv_blocked: failed to allocate FFT buffers.\n");
+        return -1;
+    }
+    unsigned char *slots = (unsigned char *)(hs + nbin);
+    slots += (ARENA_ALIGN - (size_t)(slots - (unsigned char *)hs) % ARENA_ALIGN) % ARENA_ALIGN;
+
+    /* 借用第 0 槽计算短序列频谱 / slot 0 doubles as scratch for the short spectrum */
+    fft_cpx_t *work = (fft_cpx_t *)slots + nbin;
+    double *buf = (double *)(work + nfft);
+    for (size_t i = 0; i < nfft; ++i)
+        buf[i] = (i < k) ? seq_sample_to_double(h[i]) : 0.0;
+    fft_rfft(plan, buf, hs, work);
+
+    ops_fft_block_ctx_t bc = {x, lx, k, plan, hs, block, ly, y, slots, slot_bytes, grain};
+    int rc = ops_parallel_for(nblocks, grain, ops_fft_block_task, &bc);
+
+    ops_scratch_put(ctx, hs);
+    return rc;
+}
+
+/**
+ * @brief 初始化运算上下文 / Initialize an operation context.
+ *
+ * @param ctx 上下文 / Context
+ * @param bytes 暂存池初始容量，可为 0（按需增长）/ Initial scratch capacity, may be 0 (grows on demand)
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ */
+int ops_ctx_init(ops_ctx_t *ctx, size_t bytes)
+{
+    if (!ctx)
+    {
+        fprintf(stderr, "ops_ctx_init: null pointer argument.\n");
+        return -1;
+    }
+    return arena_init(&ctx->arena, bytes);
+}
+
+/**
+ * @brief 释放运算上下文 / Free an operation context.
+ *
+ * @param ctx 上下文，可为 NULL / Context, may be NULL
+ */
+void ops_ctx_free(ops_ctx_t *ctx)
+{
+    if (!ctx)
+        return;
+    arena_free(&ctx->arena);
+}
+
+/**
+ * @brief 回收上下文中的全部序列与暂存 / Reclaim every sequence and scratch buffer of a context.
+ *
+ * @param ctx 上下文 / Context
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 每帧调用一次；预热帧若发生溢出，内存池在此一次扩容，之后不再分配。
+ *       Call once per frame; if the warm-up frame spilled, the arena grows
+ *       here once and does not allocate again.
+ */
+int ops_ctx_reset(ops_ctx_t *ctx)
+{
+    if (!ctx)
+    {
+        fprintf(stderr, "ops_ctx_reset: null pointer argument.\n");
+        return -1;
+    }
+    return arena_reset(&ctx->arena);
+}
+
+/**
+ * @brief 从上下文中取一段序列 / Carve a sequence out of a context.
+ *
+ * @param ctx 上下文 / Context
+ * @param len 序列长度，可为 0 / Sequence length, may be 0
+ * @param s 输出序列（不清零，不可对其调用 seq_free）/ Output sequence (not zeroed; never seq_free it)
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 有效期到下一次 ops_ctx_reset() 为止。
+ *       Valid until the next ops_ctx_reset().
+ */
+int ops_ctx_seq(ops_ctx_t *ctx, size_t len, seq_t *s)
+{
+    if (!ctx || !s)
+    {
+        fprintf(stderr, "ops_ctx_seq: null pointer argument.\n");
+        return -1;
+    }
+
+    s->data = NULL;
+    s->length = 0;
+    if (len == 0)
+        return 0;
+
+    if (len > SIZE_MAX / sizeof(seq_sample_t))
+    {
+        fprintf(stderr, "ops_ctx_seq: length %zu too large.\n", len);
+        return -1;
+    }
+    s->data = (seq_sample_t *)arena_alloc(&ctx->arena, len * sizeof(seq_sample_t));
+    if (!s->data)
+        return -1;
+    s->length = len;
+    return 0;
+}
+
+/* 内部工具：检查调用方缓冲区 / internal helper: validate a caller-owned output buffer */
+static int ops_check_out(const char *fn, size_t need, const seq_sample_t *out, size_t cap,
+                         size_t *n_out)
+{
+    if (!n_out)
+    {
+        fprintf(stderr, "%s: null pointer argument.\n", fn);
+        return -1;
+    }
+    *n_out = 0;
+    if (need > cap)
+    {
+        fprintf(stderr, "%s: output capacity %zu is below the required %zu.\n", fn, cap, need);
+        return -1;
+    }
+    if (need > 0 && !out)
+    {
+        fprintf(stderr, "%s: null output buffer.\n", fn);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 逐点加法写入调用方缓冲区 / Point-wise addition into a caller-owned buffer.
+ *
+ * @param a 输入序列 A / Input sequence A
+ * @param b 输入序列 B / Input sequence B
+ * @param out 输出缓冲区，可等于 a->data 或 b->data（原地）/ Output buffer, may equal a->data or b->data (in place)
+ * @param cap 输出容量（样本数），须 ≥ min(La, Lb) / Output capacity in samples, at least min(La, Lb)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误（容量不足时不写入）。
+ *         0 on success; non-zero on error (nothing is written if cap is short).
+ *
+ * @note 每个输出只读同下标的输入，因此与输入完全重合是安全的；部分重叠不允许。
+ *       Each output reads only the inputs at its own index, so an exact alias
+ *       of an input is safe; partial overlap is not.
+ */
+int seq_add_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_add_into: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = (a->length < b->length) ? a->length : b->length;
+    if (ops_check_out("seq_add_into", n, out, cap, n_out) != 0)
+        return -1;
+
+    const uint64_t t0 = STATS_START();
+
+#if OPS_SIMD
+    simd_add_f64(a->data, b->data, out, n);
+#else
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = seq_sample_add(a->data[i], b->data[i]);
+    }
+#endif
+
+    *n_out = n;
+    STATS_RECORD(STATS_ADD, t0, a->length + b->length, n, 0);
+    return 0;
+}
+
+/**
+ * @brief 序列逐点加法 / Point-wise addition of two sequences.
+ *
+ * @param a 输入序列 A / Input sequence A
+ * @param b 输入序列 B / Input sequence B
+ * @param out 输出序列，函数内部分配内存 / Output sequence, allocated inside
+ * @return 0 表示成功；非 0 表示错误（参数非法或内存失败）。
+ *         0 on success; non-zero on invalid arguments or allocation failure.
+ *
+ * @note
+ * - 输出长度为 min(a->length, b->length)。
+ *   Output length is min(a->length, b->length).
+ * - 若任一输入为 NULL，或 min 长度为 0，则返回空序列或错误。
+ * - 等价于 seq_init() 后调用 seq_add_into()。
+ *   Equivalent to seq_init() followed by seq_add_into().
+ */
+int seq_add(const seq_t *a, const seq_t *b, seq_t *out)
+{
+    if (!a || !b || !out)
+    {
+        fprintf(stderr, "seq_add: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = (a->length < b->length) ? a->length : b->length;
+    if (seq_init(out, n) != 0)
+    {
+        fprintf(stderr, "seq_add: failed to allocate output sequence.\n");
+        return -1;
+    }
+
+    if (seq_add_into(a, b, out->data, n, &n) != 0)
+    {
+        ops_reset_seq(out);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 原地逐点加法 a ← a + b / In-place point-wise addition, a ← a + b.
+ *
+ * @param a 输入兼输出序列 / Input and output sequence
+ * @param b 输入序列 B / Input sequence B
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ *
+ * @note
+ * - 单趟完成，不分配内存；a->length 截为 min(La, Lb)，已分配的内存不变，仍由原方式释放。
+ *   Single pass without allocation; a->length is cut to min(La, Lb) while
+ *   the allocation stays as is and is released the usual way.
+ * - b 可以就是 a。b may be a itself.
+ */
+int seq_add_inplace(seq_t *a, const seq_t *b)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_add_inplace: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = 0;
+    if (seq_add_into(a, b, a->data, a->length, &n) != 0)
+        return -1;
+    a->length = n;
+    return 0;
+}
+
+/**
+ * @brief 逐点乘法写入调用方缓冲区 / Point-wise multiplication into a caller-owned buffer.
+ *
+ * @param a 输入序列 A / Input sequence A
+ * @param b 输入序列 B / Input sequence B
+ * @param out 输出缓冲区，可等于 a->data 或 b->data（原地）/ Output buffer, may equal a->data or b->data (in place)
+ * @param cap 输出容量（样本数），须 ≥ min(La, Lb) / Output capacity in samples, at least min(La, Lb)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误（容量不足时不写入）。
+ *         0 on success; non-zero on error (nothing is written if cap is short).
+ *
+ * @note 每个输出只读同下标的输入，因此与输入完全重合是安全的；部分重叠不允许。
+ *       Each output reads only the inputs at its own index, so an exact alias
+ *       of an input is safe; partial overlap is not.
+ */
+int seq_mul_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_mul_into: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = (a->length < b->length) ? a->length : b->length;
+    if (ops_check_out("seq_mul_into", n, out, cap, n_out) != 0)
+        return -1;
+
+    const uint64_t t0 = STATS_START();
+
+#if OPS_SIMD
+    simd_mul_f64(a->data, b->data, out, n);
+#else
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = seq_sample_mul(a->data[i], b->data[i]);
+    }
+#endif
+
+    *n_out = n;
+    STATS_RECORD(STATS_MUL, t0, a->length + b->length, n, 0);
+    return 0;
+}
+
+/**
+ * @brief 序列逐点乘法 / Point-wise multiplication of two sequences.
+ *
+ * @param a 输入序列 A / Input sequence A
+ * @param b 输入序列 B / Input sequence B
+ * @param out 输出序列 / Output sequence (allocated inside)
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ *
+ * @note
+ * - 输出长度为 min(a->length, b->length)。
+ * - 等价于 seq_init() 后调用 seq_mul_into()。
+ *   Equivalent to seq_init() followed by seq_mul_into().
+ */
+int seq_mul(const seq_t *a, const seq_t *b, seq_t *out)
+{
+    if (!a || !b || !out)
+    {
+        fprintf(stderr, "seq_mul: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = (a->length < b->length) ? a->length : b->length;
+    if (seq_init(out, n) != 0)
+    {
+        fprintf(stderr, "seq_mul: failed to allocate output sequence.\n");
+        return -1;
+    }
+
+    if (seq_mul_into(a, b, out->data, n, &n) != 0)
+    {
+        ops_reset_seq(out);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 原地逐点乘法 a ← a · b / In-place point-wise multiplication, a ← a · b.
+ *
+ * @param a 输入兼输出序列 / Input and output sequence
+ * @param b 输入序列 B / Input sequence B
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ *
+ * @note
+ * - 单趟完成，不分配内存；a->length 截为 min(La, Lb)，已分配的内存不变，仍由原方式释放。
+ *   Single pass without allocation; a->length is cut to min(La, Lb) while
+ *   the allocation stays as is and is released the usual way.
+ * - b 可以就是 a。b may be a itself.
+ */
+int seq_mul_inplace(seq_t *a, const seq_t *b)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_mul_inplace: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = 0;
+    if (seq_mul_into(a, b, a->data, a->length, &n) != 0)
+        return -1;
+    a->length = n;
+    return 0;
+}
+
+/**
+ * @brief 线性卷积写入调用方缓冲区 / Linear convolution into a caller-owned buffer.
+ *
+ * @param ctx 暂存来源；NULL 时 FFT 暂存使用 malloc / Scratch source; NULL mallocs the FFT scratch
+ * @param a 输入序列 A / Input sequence A (length = La)
+ * @param b 输入序列 B / Input sequence B (length = Lb)
+ * @param out 输出缓冲区，不得与输入重叠 / Output buffer; must not overlap the inputs
+ * @param cap 输出容量，须 ≥ La + Lb - 1（任一为空时为 0）/ Capacity, at least La + Lb - 1 (0 if either is empty)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 算法选择与 seq_conv_linear() 相同，装入分发表（tune.h）时按表选择路径；
+ *       暂存在返回前回退到调用时的位置。
+ *       Picks the same algorithm as seq_conv_linear(), or the path of an
+ *       installed dispatch table (tune.h); scratch is rewound to its position
+ *       at entry before returning.
+ */
+int seq_conv_linear_into(ops_ctx_t *ctx, const seq_t *a, const seq_t *b,
+                         seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_conv_linear_into: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t la = a->length;
+    size_t lb = b->length;
+    size_t ly = (la == 0 || lb == 0) ? 0 : la + lb - 1;
+
+    if (ops_check_out("seq_conv_linear_into", ly, out, cap, n_out) != 0)
+        return -1;
+    if (ly == 0)
+        return 0;
+
+    const uint64_t t0 = STATS_START();
+
+    size_t lmin = (la < lb) ? la : lb;
+    size_t lmax = (la < lb) ? lb : la;
+    size_t mark = ctx ? arena_mark(&ctx->arena) : 0;
+    const tune_path_t path = tune_path(TUNE_OP_CONV_LINEAR, lmin, lmax);
+    const int fft = (path == TUNE_PATH_AUTO) ? (lmin >= ops_fft_threshold) : (path == TUNE_PATH_FFT);
+    int rc;
+
+    if (fft && lmax / OPS_FFT_BLOCK_RATIO >= lmin)
+    {
+        rc = (la >= lb) ? ops_fft_conv_blocked(ctx, a->data, la, b->data, lb, out)
+                        : ops_fft_conv_blocked(ctx, b->data, lb, a->data, la, out);
+    }
+    else if (fft)
+    {
+        rc = ops_fft_conv(ctx, a->data, la, b->data, lb, 0, out);
+    }
+    else
+    {
+        ops_pair_ctx_t pc = {a, b, out};
+        rc = ops_parallel_for(ly, ops_tuned_grain(path, ly, lmin), ops_conv_task, &pc);
+    }
+
+    if (ctx)
+        arena_rewind(&ctx->arena, mark);
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_conv_linear_into: computation failed.\n");
+        return -1;
+    }
+    *n_out = ly;
+    STATS_RECORD(STATS_CONV_LINEAR, t0, la + lb, ly, 0);
+    return 0;
+}
+
+/**
+ * @brief 线性卷积 / Linear convolution of two sequences.
+ *
+ * @param a 输入序列 A / Input sequence A (length = La)
+ * @param b 输入序列 B / Input sequence B (length = Lb)
+ * @param out 输出序列 / Output sequence
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note
+ * - 若 La == 0 或 Lb == 0，则输出为空序列。
+ * - 输出长度为 La + Lb - 1。
+ * - 定义: y[n] = sum_{k=0}^{La-1} a[k] * b[n-k]，只在合法索引内累加。
+ * - min(La, Lb) >= ops_get_fft_threshold() 时使用 FFT，误差见 OPS_FFT_THRESHOLD_DEFAULT。
+ *   Uses the FFT when min(La, Lb) >= ops_get_fft_threshold(); see
+ *   OPS_FFT_THRESHOLD_DEFAULT for the error bound.
+ * - 长序列不短于短序列的 OPS_FFT_BLOCK_RATIO 倍时，FFT 路径按块重叠保留，O(L log K)。
+ *   When the long input is at least OPS_FFT_BLOCK_RATIO times the short one,
+ *   the FFT path runs block-wise overlap-save in O(L log K).
+ * - 直接求和时，稳态区 n ∈ [min-1, max-1] 由向量分块计算（与标量逐位一致），
+ *   两端斜坡逐点计算。
+ *   For direct sums, the steady-state outputs n ∈ [min-1, max-1] go through
+ *   the vector tiles (bit-identical to scalar); the ramps stay scalar.
+ * - 输出区间或 FFT 块按 ops_set_threads() 的线程数并行，结果与线程数无关。
+ *   Output ranges or FFT blocks run on ops_set_threads() threads; the result
+ *   does not depend on the thread count.
+ * - 等价于 seq_init() 后调用 seq_conv_linear_into(NULL, ...)。
+ *   Equivalent to seq_init() followed by seq_conv_linear_into(NULL, ...).
+ */
+int seq_conv_linear(const seq_t *a, const seq_t *b, seq_t *out)
+{
+    if (!a || !b || !out)
+    {
+        fprintf(stderr, "seq_conv_linear: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t ly = (a->length == 0 || b->length == 0) ? 0 : a->length + b->length - 1;
+    if (seq_init(out, ly) != 0)
+    {
+        fprintf(stderr, "seq_conv_linear: failed to allocate output.\n");
+        return -1;
+    }
+
+    if (seq_conv_linear_into(NULL, a, b, out->data, ly, &ly) != 0)
+    {
+        ops_reset_seq(out);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 圆周卷积写入调用方缓冲区 / Circular convolution into a caller-owned buffer.
  *
+ * @param ctx 暂存来源；NULL 时 FFT 暂存使用 malloc / Scratch source; NULL mallocs the FFT scratch
  * @param a 输入序列 A / Input sequence A
  * @param b 输入序列 B / Input sequence B
- * @param out 输出序列，函数内部分配内存 / Output sequence, allocated inside
- * @return 0 表示成功；非 0 表示错误（参数非法或内存失败）。
- *         0 on success; non-zero on invalid arguments or allocation failure.
- *
- * @note
- * - 输出长度为 min(a->length, b->length)。
- *   Output length is min(a->length, b->length).
- * - 若任一输入为 NULL，或 min 长度为 0，则返回空序列或错误。
+ * @param out 输出缓冲区，不得与输入重叠 / Output buffer; must not overlap the inputs
+ * @param cap 输出容量，须 ≥ N / Capacity, at least N
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
  */
-int seq_add(const seq_t *a, const seq_t *b, seq_t *out)
+int seq_conv_circular_into(ops_ctx_t *ctx, const seq_t *a, const seq_t *b,
+                           seq_sample_t *out, size_t cap, size_t *n_out)
 {
-    if (!a || !b || !out)
+    if (!a || !b)
     {
-        fprintf(stderr, "seq_add: null pointer argument.\n");
+        fprintf(stderr, "seq_conv_circular_into: null pointer argument.\n");
         return -1;
     }
 
-    size_t n = (a->length < b->length) ? a->length : b->length;
-    if (n == 0)
+    if (a->length == 0 || b->length == 0)
     {
-        /* 合法但无输出数据：创建空序列 / Valid but empty result */
-        if (seq_init(out, 0) != 0)
-        {
-            fprintf(stderr, "seq_add: failed to initialize empty output.\n");
-            return -1;
-        }
-        return 0;
+        fprintf(stderr, "seq_conv_circular_into: input length must be > 0.\n");
+        return -1;
     }
 
-    if (seq_init(out, n) != 0)
+    if (a->length != b->length)
     {
-        fprintf(stderr, "seq_add: failed to allocate output sequence.\n");
+        fprintf(stderr, "seq_conv_circular_into: input lengths must match (got %zu and %zu).\n",
+                a->length, b->length);
         return -1;
     }
 
-    for (size_t i = 0; i < n; ++i)
+    size_t nlen = a->length;
+    if (ops_check_out("seq_conv_circular_into", nlen, out, cap, n_out) != 0)
+        return -1;
+
+    const uint64_t t0 = STATS_START();
+    const tune_path_t path = tune_path(TUNE_OP_CONV_CIRCULAR, nlen, nlen);
+    int rc;
+    if ((path == TUNE_PATH_AUTO) ? (nlen >= ops_fft_threshold) : (path == TUNE_PATH_FFT))
+    {
+        size_t mark = ctx ? arena_mark(&ctx->arena) : 0;
+        rc = ops_fft_conv(ctx, a->data, nlen, b->data, nlen, nlen, out);
+        if (ctx)
+            arena_rewind(&ctx->arena, mark);
+    }
+    else
     {
-        out->data[i] = a->data[i] + b->data[i];
+        ops_pair_ctx_t pc = {a, b, out};
+        rc = ops_parallel_for(nlen, ops_tuned_grain(path, nlen, nlen), ops_conv_circular_task, &pc);
     }
 
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_conv_circular_into: computation failed.\n");
+        return -1;
+    }
+    *n_out = nlen;
+    STATS_RECORD(STATS_CONV_CIRCULAR, t0, 2 * nlen, nlen, 0);
     return 0;
 }
 
 /**
- * @brief 序列逐点乘法 / Point-wise multiplication of two sequences.
+ * @brief 圆周卷积 / Circular convolution of two sequences.
  *
  * @param a 输入序列 A / Input sequence A
  * @param b 输入序列 B / Input sequence B
- * @param out 输出序列 / Output sequence (allocated inside)
+ * @param out 输出序列 / Output sequence
  * @return 0 表示成功；非 0 表示错误。
- *         0 on success; non-zero on error.
  *
  * @note
- * - 输出长度为 min(a->length, b->length)。
+ * - 要求 a->length == b->length == N 且 N > 0，否则视为错误。
+ * - 输出长度为 N。
+ * - 定义: y[n] = sum_{k=0}^{N-1} a[k] * b[(n - k) mod N]
+ * - N >= ops_get_fft_threshold() 时先做 FFT 线性卷积再按周期 N 折叠，
+ *   因此任意 N 都只用到高效变换长度。
+ *   When N >= ops_get_fft_threshold(), an FFT linear convolution is folded
+ *   modulo N, so any N only ever uses efficient transform lengths.
+ * - 等价于 seq_init() 后调用 seq_conv_circular_into(NULL, ...)。
+ *   Equivalent to seq_init() followed by seq_conv_circular_into(NULL, ...).
  */
-int seq_mul(const seq_t *a, const seq_t *b, seq_t *out)
+int seq_conv_circular(const seq_t *a, const seq_t *b, seq_t *out)
 {
     if (!a || !b || !out)
     {
-        fprintf(stderr, "seq_mul: null pointer argument.\n");
+        fprintf(stderr, "seq_conv_circular: null pointer argument.\n");
         return -1;
     }
 
-    size_t n = (a->length < b->length) ? a->length : b->length;
-    if (n == 0)
+    size_t nlen = a->length;
+    if (seq_init(out, nlen) != 0)
     {
-        if (seq_init(out, 0) != 0)
-        {
-            fprintf(stderr, "seq_mul: failed to initialize empty output.\n");
-            return -1;
-        }
-        return 0;
+        fprintf(stderr, "seq_conv_circular: failed to allocate output.\n");
+        return -1;
     }
 
-    if (seq_init(out, n) != 0)
+    if (seq_conv_circular_into(NULL, a, b, out->data, nlen, &nlen) != 0)
     {
-        fprintf(stderr, "seq_mul: failed to allocate output sequence.\n");
+        ops_reset_seq(out);
         return -1;
     }
+    return 0;
+}
 
-    for (size_t i = 0; i < n; ++i)
+/**
+ * @brief 内部工具：FFT 互相关 / internal helper: cross-correlation via FFT.
+ *
+ * @param a 序列 A 数据 / data of A (length la > 0)
+ * @param b 序列 B 数据 / data of B (length lb > 0)
+ * @param r 输出缓冲，长度 la + lb - 1 / output buffer of length la + lb - 1
+ * @return 0 表示成功；非 0 表示内存失败。/ 0 on success; non-zero on allocation failure.
+ *
+ * @note c = conv(rev(A), B) 与 r 等长，r[n] = c[n + La - Lb]（越界处为 0），
+ *       因此先把 c 写进 r 再原地平移。
+ *       c = conv(rev(A), B) has the length of r and r[n] = c[n + La - Lb]
+ *       (0 out of range), so c is written into r and shifted in place.
+ */
+static int ops_fft_corr(const seq_sample_t *a, size_t la, const seq_sample_t *b, size_t lb, seq_sample_t *r)
+{
+    const size_t lr = la + lb - 1;
+    seq_sample_t *ra = (seq_sample_t *)ops_scratch_get(NULL, la * sizeof(seq_sample_t));
+    if (ra == NULL)
+        return -1;
+    for (size_t i = 0; i < la; ++i)
+        ra[i] = a[la - 1 - i];
+
+    int rc = ops_fft_conv(NULL, ra, la, b, lb, 0, r);
+    ops_scratch_put(NULL, ra);
+    if (rc != 0)
+        return -1;
+
+    if (la > lb)
     {
-        out->data[i] = a->data[i] * b->data[i];
+        size_t d = la - lb;
+        memmove(r, r + d, (lr - d) * sizeof(seq_sample_t));
+        for (size_t i = lr - d; i < lr; ++i)
+            r[i] = (seq_sample_t)0;
+    }
+    else if (lb > la)
+    {
+        size_t d = lb - la;
+        memmove(r + d, r, (lr - d) * sizeof(seq_sample_t));
+        for (size_t i = 0; i < d; ++i)
+            r[i] = (seq_sample_t)0;
+    }
+    return 0;
+}
+
+/**
+ * @brief 互相关写入调用方缓冲区 / Cross-correlation into a caller-owned buffer.
+ *
+ * @param a 输入序列 x[n] / Input sequence x[n], length La
+ * @param b 输入序列 y[n] / Input sequence y[n], length Lb
+ * @param out 输出缓冲区，不得与输入重叠 / Output buffer; must not overlap the inputs
+ * @param cap 输出容量，须 ≥ La + Lb - 1（任一为空时为 0）/ Capacity, at least La + Lb - 1 (0 if either is empty)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note 直接求和不需要暂存，因此没有上下文参数。只有装入的分发表（tune.h）选中 FFT 时，
+ *       才以 conv(rev(A), B) 平移得到结果，暂存用 malloc，误差与 FFT 卷积相同。
+ *       Direct sums need no scratch, hence no context argument. Only when an
+ *       installed dispatch table (tune.h) picks the FFT is the result taken
+ *       from a shifted conv(rev(A), B), with malloc'd scratch and the same
+ *       rounding error as FFT convolution.
+ */
+int seq_corr_cross_into(const seq_t *a, const seq_t *b, seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (!a || !b)
+    {
+        fprintf(stderr, "seq_corr_cross_into: null pointer argument.\n");
+        return -1;
     }
 
+    size_t la = a->length;
+    size_t lb = b->length;
+    size_t lr = (la == 0 || lb == 0) ? 0 : la + lb - 1;
+
+    if (ops_check_out("seq_corr_cross_into", lr, out, cap, n_out) != 0)
+        return -1;
+    if (lr == 0)
+        return 0;
+
+    const uint64_t t0 = STATS_START();
+    size_t lmin = (la < lb) ? la : lb;
+    const tune_path_t path = tune_path(TUNE_OP_CORR_CROSS, lmin, (la < lb) ? lb : la);
+    int rc;
+    if (path == TUNE_PATH_FFT)
+    {
+        rc = ops_fft_corr(a->data, la, b->data, lb, out);
+    }
+    else
+    {
+        ops_pair_ctx_t pc = {a, b, out};
+        rc = ops_parallel_for(lr, ops_tuned_grain(path, lr, lmin), ops_corr_task, &pc);
+    }
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_corr_cross_into: computation failed.\n");
+        return -1;
+    }
+    *n_out = lr;
+    STATS_RECORD(STATS_CORR_CROSS, t0, la + lb, lr, 0);
     return 0;
 }
 
 /**
- * @brief 线性卷积 / Linear convolution of two sequences.
+ * @brief 互相关 / Cross-correlation between two sequences.
  *
- * @param a 输入序列 A / Input sequence A (length = La)
- * @param b 输入序列 B / Input sequence B (length = Lb)
- * @param out 输出序列 / Output sequence
+ * @param a 输入序列 x[n] / Input sequence x[n], length La
+ * @param b 输入序列 y[n] / Input sequence y[n], length Lb
+ * @param out 输出相关序列 / Output correlation sequence
  * @return 0 表示成功；非 0 表示错误。
  *
  * @note
- * - 若 La == 0 或 Lb == 0，则输出为空序列。
  * - 输出长度为 La + Lb - 1。
- * - 定义: y[n] = sum_{k=0}^{La-1} a[k] * b[n-k]，只在合法索引内累加。
+ * - 下标 n 对应的滞后量 lag = n - (Lb - 1)。
+ *   So lag runs from -(Lb-1) to (La-1).
+ * - 定义:
+ *   r_xy[lag] = sum_n x[n] * y[n + lag]
+ *   在实现中按输出索引 n = lag + (Lb - 1) 展开。
+ * - 求和区间等长的滞后（完整重叠）由向量分块计算，与标量逐位一致。
+ *   Lags with full overlap go through the vector tiles, bit-identical to scalar.
+ * - 输出区间按 ops_set_threads() 的线程数并行，结果与线程数无关。
+ *   Output ranges run on ops_set_threads() threads; the result does not depend on the thread count.
+ * - 等价于 seq_init() 后调用 seq_corr_cross_into()。
+ *   Equivalent to seq_init() followed by seq_corr_cross_into().
  */
-int seq_conv_linear(const seq_t *a, const seq_t *b, seq_t *out)
+int seq_corr_cross(const seq_t *a, const seq_t *b, seq_t *out)
 {
     if (!a || !b || !out)
     {
-        fprintf(stderr, "seq_conv_linear: null pointer argument.\n");
+        fprintf(stderr, "seq_corr_cross: null pointer argument.\n");
         return -1;
     }
 
-    if (a->length == 0 || b->length == 0)
+    size_t lr = (a->length == 0 || b->length == 0) ? 0 : a->length + b->length - 1;
+    if (seq_init(out, lr) != 0)
     {
-        if (seq_init(out, 0) != 0)
-        {
-            fprintf(stderr, "seq_conv_linear: failed to initialize empty output.\n");
-            return -1;
-        }
+        fprintf(stderr, "seq_corr_cross: failed to allocate output.\n");
+        return -1;
+    }
+
+    if (seq_corr_cross_into(a, b, out->data, lr, &lr) != 0)
+    {
+        ops_reset_seq(out);
+        return -1;
+    }
+    return 0;
+}
+
+/* 内部工具：输出区间清零 / internal helper: zero an output range */
+static void ops_zero(seq_sample_t *y, size_t n0, size_t n1)
+{
+    for (size_t n = n0; n < n1; ++n)
+        y[n] = (seq_sample_t)0;
+}
+
+/**
+ * @brief 内部工具：取视图存储区的连续序列 / internal helper: the stored run of a view as a contiguous sequence.
+ *
+ * @param reversed 非 0 时按反序取 / non-zero takes the run in reverse
+ * @param scratch 收集时指向暂存，否则为 NULL / the gather scratch, or NULL when none was needed
+ * @return 0 表示成功；非 0 表示暂存不足。/ 0 on success; non-zero when scratch ran out.
+ *
+ * @note 步长（反序时取负）为 1 时直接引用原存储，否则一趟收集到暂存。要求 v->count > 0。
+ *       A step of 1 (negated when reversed) references the storage as is;
+ *       any other step gathers once into scratch. Requires v->count > 0.
+ */
+static int ops_view_core(ops_ctx_t *ctx, const seq_view_t *v, int reversed, seq_t *core, void **scratch)
+{
+    ptrdiff_t step = reversed ? -v->stride : v->stride;
+    const seq_sample_t *first = reversed ? v->base + (ptrdiff_t)(v->count - 1) * v->stride : v->base;
+
+    *scratch = NULL;
+    core->length = v->count;
+    if (step == 1)
+    {
+        core->data = (seq_sample_t *)first;
         return 0;
     }
 
-    size_t la = a->length;
-    size_t lb = b->length;
-    size_t ly = la + lb - 1;
+    seq_sample_t *buf = (seq_sample_t *)ops_scratch_get(ctx, v->count * sizeof(seq_sample_t));
+    if (buf == NULL)
+        return -1;
+    for (size_t k = 0; k < v->count; ++k)
+        buf[k] = first[(ptrdiff_t)k * step];
+    core->data = buf;
+    *scratch = buf;
+    return 0;
+}
 
-    if (seq_init(out, ly) != 0)
+/**
+ * @brief 视图的线性卷积写入调用方缓冲区 / Linear convolution of two views into a caller-owned buffer.
+ *
+ * @param ctx 暂存来源；NULL 时使用 malloc / Scratch source; NULL mallocs
+ * @param a 输入视图 A / Input view A (length = La)
+ * @param b 输入视图 B / Input view B (length = Lb)
+ * @param out 输出缓冲区，不得与视图存储重叠 / Output buffer; must not overlap the view storage
+ * @param cap 输出容量，须 ≥ La + Lb - 1（任一为空时为 0）/ Capacity, at least La + Lb - 1 (0 if either is empty)
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
+ *
+ * @note
+ * - 结果与先物化两个视图再调用 seq_conv_linear_into() 相同，但零区只变成输出的平移与补零，
+ *   只对两段存储区做卷积；步长为 1 的存储区不复制，其余各收集一次。
+ *   Same result as materializing both views and calling
+ *   seq_conv_linear_into(), but the zero regions only shift and pad the
+ *   output and just the stored runs are convolved; a run with stride 1 is
+ *   used in place, any other is gathered once.
+ * - 存储区的卷积记入 conv-linear 统计。/ The convolution of the runs is recorded under conv-linear.
+ */
+int seq_conv_linear_view_into(ops_ctx_t *ctx, const seq_view_t *a, const seq_view_t *b,
+                              seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (!a || !b)
     {
-        fprintf(stderr, "seq_conv_linear: failed to allocate output.\n");
+        fprintf(stderr, "seq_conv_linear_view_into: null pointer argument.\n");
         return -1;
     }
 
-    for (size_t n = 0; n < ly; ++n)
+    size_t ly = (a->length == 0 || b->length == 0) ? 0 : a->length + b->length - 1;
+    if (ops_check_out("seq_conv_linear_view_into", ly, out, cap, n_out) != 0)
+        return -1;
+    if (a->count == 0 || b->count == 0)
     {
-        double acc = 0.0;
-        /* k runs over indices of a; n-k must be valid index of b */
-        size_t k_min = (n >= lb - 1) ? (n - (lb - 1)) : 0;
-        size_t k_max = (n < la - 1) ? n : (la - 1);
+        ops_zero(out, 0, ly);
+        *n_out = ly;
+        return 0;
+    }
 
-        for (size_t k = k_min; k <= k_max; ++k)
-        {
-            size_t j = n - k; /* index into b */
-            acc += (double)a->data[k] * (double)b->data[j];
-        }
+    size_t off = a->lead + b->lead;
+    size_t lc = a->count + b->count - 1;
+    size_t mark = ctx ? arena_mark(&ctx->arena) : 0;
+    seq_t ca, cb;
+    void *sa = NULL, *sb = NULL;
+    int rc = -1;
 
-        out->data[n] = (seq_sample_t)acc;
-    }
+    if (ops_view_core(ctx, a, 0, &ca, &sa) == 0 && ops_view_core(ctx, b, 0, &cb, &sb) == 0)
+        rc = seq_conv_linear_into(ctx, &ca, &cb, out + off, lc, &lc);
+
+    ops_scratch_put(ctx, sb);
+    ops_scratch_put(ctx, sa);
+    if (ctx)
+        arena_rewind(&ctx->arena, mark);
 
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_conv_linear_view_into: computation failed.\n");
+        return -1;
+    }
+    ops_zero(out, 0, off);
+    ops_zero(out, off + lc, ly);
+    *n_out = ly;
     return 0;
 }
 
 /**
- * @brief 圆周卷积 / Circular convolution of two sequences.
+ * @brief 视图的互相关写入调用方缓冲区 / Cross-correlation of two views into a caller-owned buffer.
  *
- * @param a 输入序列 A / Input sequence A
- * @param b 输入序列 B / Input sequence B
- * @param out 输出序列 / Output sequence
+ * @param ctx 暂存来源；NULL 时使用 malloc / Scratch source; NULL mallocs
+ * @param a 输入视图 x[n] / Input view x[n], length La
+ * @param b 输入视图 y[n] / Input view y[n], length Lb
+ * @param out 输出缓冲区，不得与视图存储重叠 / Output buffer; must not overlap the view storage
+ * @param cap 输出容量，须 ≥ La + Lb - 1（任一为空时为 0）/ Capacity, at least La + Lb - 1 (0 if either is empty)
+ * @param n_out 实际写入的样本数 / Samples written
  * @return 0 表示成功；非 0 表示错误。
  *
  * @note
- * - 要求 a->length == b->length == N 且 N > 0，否则视为错误。
- * - 输出长度为 N。
- * - 定义: y[n] = sum_{k=0}^{N-1} a[k] * b[(n - k) mod N]
+ * - 下标与 seq_corr_cross() 相同：out[n] = r_xy[n - (Lb - 1)]。
+ *   Same indexing as seq_corr_cross(): out[n] = r_xy[n - (Lb - 1)].
+ * - 以存储区的卷积 y_core * rev(x_core) 计算后按零区平移取出，因此长输入同样走 FFT；
+ *   反转只改变读取方向，A 的存储区步长为 -1 时不复制。结果与物化后调用
+ *   seq_corr_cross_into() 在舍入误差内一致（Q15 逐位一致，未达 FFT 阈值时）。
+ *   Computed as the convolution y_core * rev(x_core) of the stored runs,
+ *   shifted by the zero regions, so long inputs take the FFT as well; the
+ *   reversal only flips the read direction and A's run is not copied when
+ *   its stride is -1. Matches seq_corr_cross_into() on the materialized
+ *   views up to rounding (bit for bit in Q15 below the FFT threshold).
+ * - 存储区的卷积记入 conv-linear 统计。/ The convolution of the runs is recorded under conv-linear.
  */
-int seq_conv_circular(const seq_t *a, const seq_t *b, seq_t *out)
+int seq_corr_cross_view_into(ops_ctx_t *ctx, const seq_view_t *a, const seq_view_t *b,
+                             seq_sample_t *out, size_t cap, size_t *n_out)
 {
-    if (!a || !b || !out)
+    if (!a || !b)
     {
-        fprintf(stderr, "seq_conv_circular: null pointer argument.\n");
+        fprintf(stderr, "seq_corr_cross_view_into: null pointer argument.\n");
         return -1;
     }
 
-    if (a->length == 0 || b->length == 0)
+    size_t lr = (a->length == 0 || b->length == 0) ? 0 : a->length + b->length - 1;
+    if (ops_check_out("seq_corr_cross_view_into", lr, out, cap, n_out) != 0)
+        return -1;
+    if (a->count == 0 || b->count == 0)
+    {
+        ops_zero(out, 0, lr);
+        *n_out = lr;
+        return 0;
+    }
+
+    /* 卷积 c[m] 对应 out[m - s]，s = za - zb + Ca - Lb / c[m] lands on out[m - s] */
+    size_t lc = a->count + b->count - 1;
+    ptrdiff_t s = (ptrdiff_t)a->lead - (ptrdiff_t)b->lead + (ptrdiff_t)a->count - (ptrdiff_t)b->length;
+    size_t m0 = (s < 0) ? 0 : (size_t)s;
+    size_t n0 = (s < 0) ? (size_t)(-s) : 0;
+    if (n0 > lr)
+        n0 = lr;
+    size_t n1 = n0;
+    if (m0 < lc && n0 < lr)
+        n1 = (lc - m0 < lr - n0) ? n0 + (lc - m0) : lr;
+
+    size_t mark = ctx ? arena_mark(&ctx->arena) : 0;
+    seq_t ca, cb;
+    void *sa = NULL, *sb = NULL, *sc = NULL;
+    int rc = 0;
+
+    if (n1 > n0)
+    {
+        rc = -1;
+        if (ops_view_core(ctx, a, 1, &ca, &sa) == 0 && ops_view_core(ctx, b, 0, &cb, &sb) == 0)
+        {
+            size_t nc = lc;
+            if (m0 == 0 && n1 - n0 == lc)
+            {
+                /* 整段落在输出内：直接写入 / the whole convolution fits: write it in place */
+                rc = seq_conv_linear_into(ctx, &cb, &ca, out + n0, lc, &nc);
+            }
+            else
+            {
+                seq_sample_t *c = (seq_sample_t *)ops_scratch_get(ctx, lc * sizeof(seq_sample_t));
+                sc = c;
+                if (c != NULL && seq_conv_linear_into(ctx, &cb, &ca, c, lc, &nc) == 0)
+                {
+                    memcpy(out + n0, c + m0, (n1 - n0) * sizeof(seq_sample_t));
+                    rc = 0;
+                }
+            }
+        }
+    }
+
+    ops_scratch_put(ctx, sc);
+    ops_scratch_put(ctx, sb);
+    ops_scratch_put(ctx, sa);
+    if (ctx)
+        arena_rewind(&ctx->arena, mark);
+
+    if (rc != 0)
     {
-        fprintf(stderr, "seq_conv_circular: input length must be > 0.\n");
+        fprintf(stderr, "seq_corr_cross_view_into: computation failed.\n");
         return -1;
     }
+    ops_zero(out, 0, n0);
+    ops_zero(out, n1, lr);
+    *n_out = lr;
+    return 0;
+}
 
-    if (a->length != b->length)
+/**
+ * @brief 内部工具：初始化卷积或互相关计划 / internal helper: initialize a convolution or correlation plan.
+ *
+ * @param fn 报错用的函数名 / function name used in messages
+ * @return 0 表示成功；非 0 表示错误（计划保持可释放的空状态）。
+ *         0 on success; non-zero on error (the plan is left empty and freeable).
+ *
+ * @note 互相关只需变换卷积 x * rev(y) 的前 min(Lx+K-1, 2K-1) 个点，见 seq_conv_plan_exec()。
+ *       并行块的暂存槽按初始化时的线程数准备，之后增加线程不会扩大并行度。
+ *       Correlation only transforms the first min(Lx+K-1, 2K-1) points of
+ *       x * rev(y); see seq_conv_plan_exec(). Scratch slots are sized for the
+ *       thread count at init; adding threads later does not widen the split.
+ */
+static int ops_plan_init(const char *fn, seq_conv_plan_t *p, const seq_t *kernel, size_t max_len,
+                         int correlate)
+{
+    if (p == NULL || kernel == NULL)
     {
-        fprintf(stderr, "seq_conv_circular: input lengths must match (got %zu and %zu).\n",
-                a->length, b->length);
+        fprintf(stderr, "%s: null pointer argument.\n", fn);
+        return -1;
+    }
+    *p = (seq_conv_plan_t){0};
+
+    size_t k = kernel->length;
+    if (k == 0 || max_len == 0)
+    {
+        fprintf(stderr, "%s: kernel length and maximum block length must be > 0.\n", fn);
+        return -1;
+    }
+    if (max_len > SIZE_MAX / sizeof(seq_sample_t) - k)
+    {
+        fprintf(stderr, "%s: maximum block length %zu too large.\n", fn, max_len);
+        return -1;
+    }
+
+    if (seq_init(&p->kernel, k) != 0)
+    {
+        fprintf(stderr, "%s: failed to copy the kernel.\n", fn);
+        return -1;
+    }
+    memcpy(p->kernel.data, kernel->data, k * sizeof(seq_sample_t));
+    p->max_len = max_len;
+    p->correlate = correlate;
+    p->threshold = ops_fft_threshold;
+
+    /* 任一块都走直接求和时无需准备变换 / direct sums for every block need no transform */
+    if (k < p->threshold || max_len < p->threshold)
+        return 0;
+
+    size_t span = max_len + k - 1;
+    if (correlate && span > 2 * k - 1)
+        span = 2 * k - 1;
+    size_t nfft = OPS_FFT_BLOCK_FACTOR * k;
+    if (nfft > span + k - 1)
+        nfft = span + k - 1;
+    nfft = fft_good_size(nfft);
+    size_t nbin = nfft / 2 + 1;
+
+    if (fft_plan_init(&p->fft, nfft) != 0)
+    {
+        fprintf(stderr, "%s: failed to create FFT plan of length %zu.\n", fn, nfft);
+        seq_conv_plan_free(p);
         return -1;
     }
 
-    size_t nlen = a->length;
+    p->block = nfft - (k - 1);
+    p->span = span;
+    size_t nblocks = (span + p->block - 1) / p->block;
+    size_t grain = ops_grain(nblocks, nfft * 8);
+    p->nslots = (nblocks + grain - 1) / grain;
+
+    /* 槽按 ARENA_ALIGN 对齐，避免相邻线程伪共享 / slots aligned to ARENA_ALIGN against false sharing */
+    p->slot_bytes = (nbin + nfft) * sizeof(fft_cpx_t) + nfft * sizeof(double);
+    p->slot_bytes = (p->slot_bytes + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    p->spec = (fft_cpx_t *)malloc(nbin * sizeof(fft_cpx_t) + ARENA_ALIGN + p->nslots * p->slot_bytes);
+    if (correlate)
+        p->stage = (seq_sample_t *)malloc(span * sizeof(seq_sample_t));
+    if (p->spec == NULL || (correlate && p->stage == NULL))
+    {
+        fprintf(stderr, "%s: failed to allocate FFT buffers.\n", fn);
+        seq_conv_plan_free(p);
+        return -1;
+    }
+    p->slots = (unsigned char *)(p->spec + nbin);
+    p->slots += (ARENA_ALIGN - (uintptr_t)p->slots % ARENA_ALIGN) % ARENA_ALIGN;
+
+    /* 借用第 0 槽计算核频谱；互相关变换反转的模板 / slot 0 is scratch for the kernel spectrum; correlation transforms the reversed template */
+    fft_cpx_t *work = (fft_cpx_t *)p->slots + nbin;
+    double *buf = (double *)(work + nfft);
+    for (size_t i = 0; i < nfft; ++i)
+    {
+        if (i >= k)
+            buf[i] = 0.0;
+        else
+            buf[i] = seq_sample_to_double(kernel->data[correlate ? k - 1 - i : i]);
+    }
+    fft_rfft(&p->fft, buf, p->spec, work);
+    return 0;
+}
+
+/**
+ * @brief 初始化线性卷积计划 / Initialize a linear convolution plan.
+ *
+ * @param p 计划 / Plan
+ * @param kernel 固定的核 h，长度 K > 0；内容被复制 / Fixed kernel h of length K > 0; copied
+ * @param max_len 之后执行的块的最大长度 / Largest block length to be executed
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ *
+ * @note 之后 seq_conv_plan_exec(p, x, ...) 等价于 seq_conv_linear_into(ctx, x, kernel, ...)。
+ *       Afterwards seq_conv_plan_exec(p, x, ...) is equivalent to
+ *       seq_conv_linear_into(ctx, x, kernel, ...).
+ */
+int seq_conv_plan_init(seq_conv_plan_t *p, const seq_t *kernel, size_t max_len)
+{
+    return ops_plan_init("seq_conv_plan_init", p, kernel, max_len, 0);
+}
+
+/**
+ * @brief 初始化互相关计划（匹配滤波）/ Initialize a cross-correlation plan (matched filtering).
+ *
+ * @param p 计划 / Plan
+ * @param tmpl 固定的模板 y，长度 K > 0；内容被复制 / Fixed template y of length K > 0; copied
+ * @param max_len 之后执行的块的最大长度 / Largest block length to be executed
+ * @return 0 表示成功；非 0 表示错误。
+ *         0 on success; non-zero on error.
+ *
+ * @note 之后 seq_conv_plan_exec(p, x, ...) 等价于 seq_corr_cross_into(x, tmpl, ...)。
+ *       Afterwards seq_conv_plan_exec(p, x, ...) is equivalent to
+ *       seq_corr_cross_into(x, tmpl, ...).
+ */
+int seq_corr_plan_init(seq_conv_plan_t *p, const seq_t *tmpl, size_t max_len)
+{
+    return ops_plan_init("seq_corr_plan_init", p, tmpl, max_len, 1);
+}
+
+/**
+ * @brief 释放计划 / Free a plan.
+ *
+ * @param p 计划，可为 NULL / Plan, may be NULL
+ */
+void seq_conv_plan_free(seq_conv_plan_t *p)
+{
+    if (p == NULL)
+        return;
+    seq_free(&p->kernel);
+    fft_plan_free(&p->fft);
+    free(p->spec);
+    free(p->stage);
+    *p = (seq_conv_plan_t){0};
+}
 
-    if (seq_init(out, nlen) != 0)
-    {
-        fprintf(stderr, "seq_conv_circular: failed to allocate output.\n");
-        return -1;
-    }
+/* 内部工具：以计划的核频谱做分块 FFT 卷积的前 ly 个输出 / internal helper: first ly outputs of the blocked FFT convolution with the plan's spectrum */
+static int ops_plan_blocks(const seq_conv_plan_t *p, const seq_sample_t *x, size_t lx, size_t ly,
+                           seq_sample_t *y)
+{
+    size_t nblocks = (ly + p->block - 1) / p->block;
+    size_t grain = ops_grain(nblocks, p->fft.n * 8);
 
-    for (size_t n = 0; n < nlen; ++n)
-    {
-        double acc = 0.0;
-        for (size_t k = 0; k < nlen; ++k)
-        {
-            size_t j = (n + nlen - k) % nlen; /* (n-k) mod N */
-            acc += (double)a->data[k] * (double)b->data[j];
-        }
-        out->data[n] = (seq_sample_t)acc;
-    }
+    /* 槽数按初始化时准备，不足时加大块 / slot count is fixed at init; widen chunks when short */
+    if ((nblocks + grain - 1) / grain > p->nslots)
+        grain = (nblocks + p->nslots - 1) / p->nslots;
 
-    return 0;
+    ops_fft_block_ctx_t bc = {x, lx, p->kernel.length, &p->fft, p->spec, p->block, ly, y,
+                              p->slots, p->slot_bytes, grain};
+    return ops_parallel_for(nblocks, grain, ops_fft_block_task, &bc);
 }
 
 /**
- * @brief 互相关 / Cross-correlation between two sequences.
+ * @brief 以计划处理一个新块 / Run a plan on a new block.
  *
- * @param a 输入序列 x[n] / Input sequence x[n], length La
- * @param b 输入序列 y[n] / Input sequence y[n], length Lb
- * @param out 输出相关序列 / Output correlation sequence
+ * @param p 已初始化的计划 / Initialized plan
+ * @param x 输入块，长度 Lx ≤ max_len / Input block of length Lx ≤ max_len
+ * @param out 输出缓冲区，不得与输入重叠 / Output buffer; must not overlap the input
+ * @param cap 输出容量，须 ≥ Lx + K - 1（Lx 为 0 时为 0）/ Capacity, at least Lx + K - 1 (0 if Lx is 0)
+ * @param n_out 实际写入的样本数 / Samples written
  * @return 0 表示成功；非 0 表示错误。
  *
  * @note
- * - 输出长度为 La + Lb - 1。
- * - 下标 n 对应的滞后量 lag = n - (Lb - 1)。
- *   So lag runs from -(Lb-1) to (La-1).
- * - 定义:
- *   r_xy[lag] = sum_n x[n] * y[n + lag]
- *   在实现中按输出索引 n = lag + (Lb - 1) 展开。
+ * - min(Lx, K) 低于初始化时的 FFT 阈值时直接求和，与 seq_conv_linear_into() /
+ *   seq_corr_cross_into() 逐位一致；否则以预先算好的核频谱按块重叠保留，
+ *   误差见 OPS_FFT_THRESHOLD_DEFAULT。
+ *   Below the FFT threshold captured at init, min(Lx, K) uses direct sums,
+ *   bit-identical to seq_conv_linear_into() / seq_corr_cross_into();
+ *   otherwise overlap-save runs against the precomputed spectrum, within the
+ *   error bound of OPS_FFT_THRESHOLD_DEFAULT.
+ * - 互相关 r[n] = Σ_k x[k]·y[k + n - (K-1)] 等于 c[2(K-1) - n]，其中 c = x * rev(y)；
+ *   因此只有 n ≤ 2(K-1) 的输出可能非零，只需变换 c 的前 2K-1 个点。
+ *   The correlation r[n] = Σ_k x[k]·y[k + n - (K-1)] equals c[2(K-1) - n]
+ *   with c = x * rev(y), so only outputs n ≤ 2(K-1) can be non-zero and only
+ *   the first 2K-1 points of c go through the transform.
+ * - 不分配内存；块按初始化时的暂存槽并行，结果与线程数无关。
+ *   Never allocates; blocks run in parallel over the slots prepared at init,
+ *   and the result does not depend on the thread count.
  */
-int seq_corr_cross(const seq_t *a, const seq_t *b, seq_t *out)
+int seq_conv_plan_exec(seq_conv_plan_t *p, const seq_t *x, seq_sample_t *out, size_t cap, size_t *n_out)
 {
-    if (!a || !b || !out)
+    if (p == NULL || x == NULL)
     {
-        fprintf(stderr, "seq_corr_cross: null pointer argument.\n");
+        fprintf(stderr, "seq_conv_plan_exec: null pointer argument.\n");
         return -1;
     }
-
-    if (a->length == 0 || b->length == 0)
+    if (p->kernel.length == 0)
     {
-        if (seq_init(out, 0) != 0)
-        {
-            fprintf(stderr, "seq_corr_cross: failed to initialize empty output.\n");
-            return -1;
-        }
-        return 0;
+        fprintf(stderr, "seq_conv_plan_exec: plan is not initialized.\n");
+        return -1;
     }
 
-    size_t la = a->length;
-    size_t lb = b->length;
-    size_t lr = la + lb - 1;
-
-    if (seq_init(out, lr) != 0)
+    size_t lx = x->length;
+    size_t k = p->kernel.length;
+    if (lx > p->max_len)
     {
-        fprintf(stderr, "seq_corr_cross: failed to allocate output.\n");
+        fprintf(stderr, "seq_conv_plan_exec: block length %zu exceeds the plan maximum %zu.\n",
+                lx, p->max_len);
         return -1;
     }
 
-    for (size_t n = 0; n < lr; ++n)
-    {
-        long lag = (long)n - (long)(lb - 1);
-        double acc = 0.0;
+    size_t ly = (lx == 0) ? 0 : lx + k - 1;
+    if (ops_check_out("seq_conv_plan_exec", ly, out, cap, n_out) != 0)
+        return -1;
+    if (ly == 0)
+        return 0;
 
-        /* sum over k where indices are in range:
-         * x index = k
-         * y index = k + lag
-         */
-        size_t k_start = 0;
-        if (lag < 0)
-        {
-            k_start = (size_t)(-lag);
-        }
-        size_t k_end = la - 1;
-        if ((long)k_end + lag > (long)(lb - 1))
-        {
-            k_end = (size_t)((long)(lb - 1) - lag);
-            if ((long)k_end < 0)
-            {
-                k_end = 0;
-            }
-        }
+    const uint64_t t0 = STATS_START();
+    int rc;
 
-        if (k_start <= k_end)
+    if (p->fft.n == 0 || lx < p->threshold)
+    {
+        ops_pair_ctx_t pc = {x, &p->kernel, out};
+        rc = ops_parallel_for(ly, ops_grain(ly, (lx < k) ? lx : k),
+                              p->correlate ? ops_corr_task : ops_conv_task, &pc);
+    }
+    else if (!p->correlate)
+    {
+        rc = ops_plan_blocks(p, x->data, lx, ly, out);
+    }
+    else
+    {
+        size_t lc = (ly < p->span) ? ly : p->span;
+        rc = ops_plan_blocks(p, x->data, lx, lc, p->stage);
+        for (size_t n = 0; rc == 0 && n < ly; ++n)
         {
-            for (size_t k = k_start; k <= k_end; ++k)
-            {
-                size_t idx_y = (size_t)((long)k + lag);
-                acc += (double)a->data[k] * (double)b->data[idx_y];
-            }
+            size_t m = 2 * (k - 1) - n; /* 仅在 n ≤ 2(K-1) 时使用 / used only when n ≤ 2(K-1) */
+            out[n] = (n <= 2 * (k - 1) && m < lc) ? p->stage[m] : seq_sample_from_double(0.0);
         }
-
-        out->data[n] = (seq_sample_t)acc;
     }
 
+    if (rc != 0)
+    {
+        fprintf(stderr, "seq_conv_plan_exec: computation failed.\n");
+        return -1;
+    }
+    *n_out = ly;
+    STATS_RECORD(p->correlate ? STATS_CORR_CROSS : STATS_CONV_LINEAR, t0, lx + k, ly, 0);
     return 0;
 }
 
@@ -360,6 +1812,8 @@ int seq_corr_window_norm(
         return -1;
     }
 
+    const uint64_t t0 = STATS_START();
+
     /* 为了保持实现简单，我们使用“各自窗口中最旧的 L 个样本按时间对齐”。
      * In practice for streaming,通常 wa、wb 同样大小、同步更新，此定义是自然的。 */
     size_t offset_a = (la > L) ? (la - L) : 0;
@@ -369,8 +1823,8 @@ int seq_corr_window_norm(
 
     for (size_t i = 0; i < L; ++i)
     {
-        double xa = (double)seq_window_get(wa, offset_a + i);
-        double yb = (double)seq_window_get(wb, offset_b + i);
+        double xa = seq_sample_to_double(seq_window_get(wa, offset_a + i));
+        double yb = seq_sample_to_double(seq_window_get(wb, offset_b + i));
         sum_x += xa;
         sum_y += yb;
     }
@@ -384,8 +1838,8 @@ int seq_corr_window_norm(
 
     for (size_t i = 0; i < L; ++i)
     {
-        double xa = (double)seq_window_get(wa, offset_a + i);
-        double yb = (double)seq_window_get(wb, offset_b + i);
+        double xa = seq_sample_to_double(seq_window_get(wa, offset_a + i));
+        double yb = seq_sample_to_double(seq_window_get(wb, offset_b + i));
         double dx = xa - mx;
         double dy = yb - my;
         num += dx * dy;
@@ -406,6 +1860,457 @@ int seq_corr_window_norm(
         return -1;
     }
 
-    *out = (seq_sample_t)(num / denom);
+    *out = seq_sample_from_double(num / denom);
+    STATS_RECORD(STATS_CORR_WINDOW, t0, 2 * L, 1, 0);
+    return 0;
+}
+
+/* ==== 增量相关器 / Incremental correlator ==== */
+
+/* 内部工具：按窗口内容精确重算矩 / internal helper: exact two-pass recomputation */
+static void ops_corr_stream_resync(seq_corr_stream_t *cs)
+{
+    size_t n = cs->wa.count;
+
+    cs->mean_x = cs->mean_y = 0.0;
+    cs->m2x = cs->m2y = cs->cxy = 0.0;
+    cs->since_sync = 0;
+    if (n == 0)
+        return;
+
+    /* 镜像窗口的内容是连续的一段，两遍都是普通循环。
+     * The mirrored windows are contiguous spans, so both passes are plain loops. */
+    const seq_sample_t *a = seq_mwindow_data(&cs->wa);
+    const seq_sample_t *b = seq_mwindow_data(&cs->wb);
+    double sx = 0.0, sy = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        sx += seq_sample_to_double(a[i]);
+        sy += seq_sample_to_double(b[i]);
+    }
+    double mx = sx / (double)n;
+    double my = sy / (double)n;
+
+    double m2x = 0.0, m2y = 0.0, cxy = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double dx = seq_sample_to_double(a[i]) - mx;
+        double dy = seq_sample_to_double(b[i]) - my;
+        m2x += dx * dx;
+        m2y += dy * dy;
+        cxy += dx * dy;
+    }
+
+    cs->mean_x = mx;
+    cs->mean_y = my;
+    cs->m2x = m2x;
+    cs->m2y = m2y;
+    cs->cxy = cxy;
+}
+
+/**
+ * @brief 初始化增量相关器 / Initialize an incremental correlator.
+ *
+ * @param cs 相关器指针，不能为空。/ Correlator pointer, must not be NULL.
+ * @param capacity 窗口长度，必须 > 0。/ Window length, must be > 0.
+ * @param resync_period 精确重同步周期；0 表示取 capacity（摊还 O(1)）。
+ *                      Exact resync period; 0 means capacity (amortized O(1)).
+ * @return 0 表示成功；非 0 表示参数无效或内存分配失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ */
+int seq_corr_stream_init(seq_corr_stream_t *cs, size_t capacity, size_t resync_period)
+{
+    if (!cs)
+    {
+        fprintf(stderr, "seq_corr_stream_init: null pointer argument.\n");
+        return -1;
+    }
+
+    cs->mean_x = cs->mean_y = 0.0;
+    cs->m2x = cs->m2y = cs->cxy = 0.0;
+    cs->since_sync = 0;
+    cs->resync_period = (resync_period > 0) ? resync_period : capacity;
+
+    if (seq_mwindow_init(&cs->wa, capacity) != 0)
+        return -1;
+    if (seq_mwindow_init(&cs->wb, capacity) != 0)
+    {
+        seq_mwindow_free(&cs->wa);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 释放增量相关器 / Free an incremental correlator.
+ *
+ * @param cs 相关器指针，可以为 NULL。/ Correlator pointer, can be NULL.
+ */
+void seq_corr_stream_free(seq_corr_stream_t *cs)
+{
+    if (!cs)
+        return;
+
+    seq_mwindow_free(&cs->wa);
+    seq_mwindow_free(&cs->wb);
+    cs->mean_x = cs->mean_y = 0.0;
+    cs->m2x = cs->m2y = cs->cxy = 0.0;
+    cs->since_sync = 0;
+}
+
+/**
+ * @brief 推入一对新样本 / Push a new sample pair.
+ *
+ * @param cs 相关器 / Correlator
+ * @param x 窗口 A 的新样本 / New sample for window A
+ * @param y 窗口 B 的新样本 / New sample for window B
+ * @return 0 表示成功；非 0 表示相关器无效。/ 0 on success; non-zero if invalid.
+ *
+ * @note 窗口已满时先按 Welford 逆更新移除最旧样本，再加入新样本，摊还 O(1)。
+ *       When full, the oldest pair is removed by an inverse Welford update before
+ *       the new pair is added; amortized O(1) per call.
+ */
+int seq_corr_stream_push(seq_corr_stream_t *cs, seq_sample_t x, seq_sample_t y)
+{
+    if (!cs || !cs->wa.buf || !cs->wb.buf)
+    {
+        fprintf(stderr, "seq_corr_stream_push: invalid correlator.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    size_t n = cs->wa.count;
+    int collapsed = 0;
+
+    if (n == cs->wa.capacity)
+    {
+        double xo = seq_sample_to_double(seq_mwindow_data(&cs->wa)[0]);
+        double yo = seq_sample_to_double(seq_mwindow_data(&cs->wb)[0]);
+        if (n == 1)
+        {
+            cs->mean_x = cs->mean_y = 0.0;
+            cs->m2x = cs->m2y = cs->cxy = 0.0;
+        }
+        else
+        {
+            double dx = xo - cs->mean_x;
+            double dy = yo - cs->mean_y;
+            double m2x_before = cs->m2x;
+            double m2y_before = cs->m2y;
+            cs->mean_x -= dx / (double)(n - 1);
+            cs->mean_y -= dy / (double)(n - 1);
+            cs->m2x -= dx * (xo - cs->mean_x);
+            cs->m2y -= dy * (yo - cs->mean_y);
+            cs->cxy -= dx * (yo - cs->mean_y);
+            collapsed = cs->m2x < SEQ_CORR_COLLAPSE * m2x_before ||
+                        cs->m2y < SEQ_CORR_COLLAPSE * m2y_before;
+        }
+        n--;
+    }
+
+    seq_mwindow_push(&cs->wa, x);
+    seq_mwindow_push(&cs->wb, y);
+
+    double xd = seq_sample_to_double(x);
+    double yd = seq_sample_to_double(y);
+    double dx = xd - cs->mean_x;
+    double dy = yd - cs->mean_y;
+    cs->mean_x += dx / (double)(n + 1);
+    cs->mean_y += dy / (double)(n + 1);
+    cs->m2x += dx * (xd - cs->mean_x);
+    cs->m2y += dy * (yd - cs->mean_y);
+    cs->cxy += dx * (yd - cs->mean_y);
+
+    /* 周期重同步；移除样本后二阶矩骤降（抵消误差被放大）时立即重同步。
+     * Periodic resync; resync at once when removing a sample collapses a
+     * moment, since the cancellation error would then dominate. */
+    if (++cs->since_sync >= cs->resync_period || collapsed)
+        ops_corr_stream_resync(cs);
+
+    STATS_RECORD(STATS_CORR_STREAM, t0, 2, 0, 0);
+    return 0;
+}
+
+/**
+ * @brief 读取当前窗口的皮尔逊相关系数 / Get the Pearson coefficient of the current window.
+ *
+ * @param cs 相关器 / Correlator
+ * @param out 输出相关系数 / Output coefficient
+ * @return 0 表示成功；非 0 表示窗口为空或方差为 0。
+ *         0 on success; non-zero if the window is empty or has zero variance.
+ *
+ * @note 结果与对同一窗口调用 seq_corr_window_norm 一致（舍入误差内），
+ *       零方差判定使用相对容差 SEQ_CORR_ZERO_TOL。
+ *       Matches seq_corr_window_norm on the same windows up to rounding;
+ *       the zero-variance test uses the relative tolerance SEQ_CORR_ZERO_TOL.
+ */
+int seq_corr_stream_get(const seq_corr_stream_t *cs, seq_sample_t *out)
+{
+    if (!cs || !out)
+    {
+        fprintf(stderr, "seq_corr_stream_get: null pointer argument.\n");
+        return -1;
+    }
+
+    size_t n = cs->wa.count;
+    if (n == 0)
+    {
+        fprintf(stderr, "seq_corr_stream_get: window is empty.\n");
+        return -1;
+    }
+
+    double m2x = cs->m2x;
+    double m2y = cs->m2y;
+    double ex = m2x + (double)n * cs->mean_x * cs->mean_x; /* Σx² */
+    double ey = m2y + (double)n * cs->mean_y * cs->mean_y; /* Σy² */
+
+    if (m2x <= SEQ_CORR_ZERO_TOL * ex || m2y <= SEQ_CORR_ZERO_TOL * ey)
+    {
+        fprintf(stderr, "seq_corr_stream_get: zero variance in window, cannot normalize.\n");
+        return -1;
+    }
+
+    double rho = cs->cxy / sqrt(m2x * m2y);
+    /* 漂移可能令 |ρ| 略超 1 / drift may push |rho| marginally past 1 */
+    if (rho > 1.0)
+        rho = 1.0;
+    else if (rho < -1.0)
+        rho = -1.0;
+
+    *out = seq_sample_from_double(rho);
+    return 0;
+}
+
+/* ==== 滑动窗口统计 / Sliding-window statistics ==== */
+
+/* 内部工具：按窗口内容精确重算均值与二阶矩 / internal helper: exact two-pass recomputation */
+static void ops_winstat_resync(seq_winstat_t *ws)
+{
+    const seq_sample_t *x = seq_mwindow_data(&ws->w);
+    size_t n = ws->w.count;
+
+    ws->mean = 0.0;
+    ws->m2 = 0.0;
+    ws->since_sync = 0;
+    if (n == 0)
+        return;
+
+    double sx = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sx += seq_sample_to_double(x[i]);
+    double mean = sx / (double)n;
+
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double d = seq_sample_to_double(x[i]) - mean;
+        m2 += d * d;
+    }
+    ws->mean = mean;
+    ws->m2 = m2;
+}
+
+/* 内部工具：推入一个样本，更新矩与两个单调队列 / internal helper: push one sample, updating the moments and both deques */
+static void ops_winstat_step(seq_winstat_t *ws, seq_sample_t x)
+{
+    size_t n = ws->w.count;
+    int collapsed = 0;
+
+    if (n == ws->w.capacity)
+    {
+        double xo = seq_sample_to_double(seq_mwindow_data(&ws->w)[0]);
+        if (n == 1)
+        {
+            ws->mean = 0.0;
+            ws->m2 = 0.0;
+        }
+        else
+        {
+            double d = xo - ws->mean;
+            double m2_before = ws->m2;
+            ws->mean -= d / (double)(n - 1);
+            ws->m2 -= d * (xo - ws->mean);
+            collapsed = ws->m2 < SEQ_CORR_COLLAPSE * m2_before;
+        }
+        n--;
+    }
+
+    seq_mwindow_push(&ws->w, x);
+
+    double xd = seq_sample_to_double(x);
+    double d = xd - ws->mean;
+    ws->mean += d / (double)(n + 1);
+    ws->m2 += d * (xd - ws->mean);
+
+    /* 绝对下标 j 的样本在 buf[j & mask]，窗口内的下标总有效。先移出刚离开窗口的队首，
+     * 再比较队尾：size == capacity 时离开窗口的槽已被 x 覆盖。
+     * The sample with absolute index j sits at buf[j & mask], valid while j is
+     * in the window. Expire the fronts that just left the window before
+     * comparing backs: with size == capacity their slot now holds x. */
+    const seq_sample_t *buf = ws->w.buf;
+    const size_t mask = ws->w.mask;
+    const size_t t = ws->t++;
+
+    if (ws->qmax_tail != ws->qmax_head && ws->qmax[ws->qmax_head & mask] + ws->w.capacity <= t)
+        ws->qmax_head++;
+    while (ws->qmax_tail != ws->qmax_head && buf[ws->qmax[(ws->qmax_tail - 1) & mask] & mask] <= x)
+        ws->qmax_tail--;
+    ws->qmax[ws->qmax_tail++ & mask] = t;
+
+    if (ws->qmin_tail != ws->qmin_head && ws->qmin[ws->qmin_head & mask] + ws->w.capacity <= t)
+        ws->qmin_head++;
+    while (ws->qmin_tail != ws->qmin_head && buf[ws->qmin[(ws->qmin_tail - 1) & mask] & mask] >= x)
+        ws->qmin_tail--;
+    ws->qmin[ws->qmin_tail++ & mask] = t;
+
+    if (++ws->since_sync >= ws->resync_period || collapsed)
+        ops_winstat_resync(ws);
+}
+
+/* 内部工具：由当前状态填写统计量，窗口非空 / internal helper: fill in the statistics of a non-empty window */
+static void ops_winstat_fill(const seq_winstat_t *ws, seq_winstat_result_t *out)
+{
+    const size_t n = ws->w.count;
+    const double m2 = (ws->m2 > 0.0) ? ws->m2 : 0.0; /* 漂移可能令其略负 / drift may make it marginally negative */
+    const double energy = m2 + (double)n * ws->mean * ws->mean; /* Σx² */
+
+    out->count = n;
+    out->mean = ws->mean;
+    out->var = m2 / (double)n;
+    out->rms = sqrt(energy / (double)n);
+    out->min = seq_sample_to_double(ws->w.buf[ws->qmin[ws->qmin_head & ws->w.mask] & ws->w.mask]);
+    out->max = seq_sample_to_double(ws->w.buf[ws->qmax[ws->qmax_head & ws->w.mask] & ws->w.mask]);
+}
+
+/**
+ * @brief 初始化滑动窗口统计 / Initialize sliding-window statistics.
+ *
+ * @param ws 统计器指针，不能为空。/ Statistics pointer, must not be NULL.
+ * @param capacity 窗口长度，必须 > 0。/ Window length, must be > 0.
+ * @param resync_period 精确重同步周期；0 表示取 capacity（摊还 O(1)）。
+ *                      Exact resync period; 0 means capacity (amortized O(1)).
+ * @return 0 表示成功；非 0 表示参数无效或内存分配失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ */
+int seq_winstat_init(seq_winstat_t *ws, size_t capacity, size_t resync_period)
+{
+    if (!ws)
+    {
+        fprintf(stderr, "seq_winstat_init: null pointer argument.\n");
+        return -1;
+    }
+
+    memset(ws, 0, sizeof(*ws));
+    ws->resync_period = (resync_period > 0) ? resync_period : capacity;
+
+    if (seq_mwindow_init(&ws->w, capacity) != 0)
+        return -1;
+    ws->qmin = (size_t *)malloc(ws->w.size * sizeof(size_t));
+    ws->qmax = (size_t *)malloc(ws->w.size * sizeof(size_t));
+    if (!ws->qmin || !ws->qmax)
+    {
+        fprintf(stderr, "seq_winstat_init: failed to allocate deques.\n");
+        seq_winstat_free(ws);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 释放滑动窗口统计 / Free sliding-window statistics.
+ *
+ * @param ws 统计器指针，可以为 NULL。/ Statistics pointer, can be NULL.
+ */
+void seq_winstat_free(seq_winstat_t *ws)
+{
+    if (!ws)
+        return;
+
+    seq_mwindow_free(&ws->w);
+    free(ws->qmin);
+    free(ws->qmax);
+    memset(ws, 0, sizeof(*ws));
+}
+
+/**
+ * @brief 推入一个样本 / Push one sample.
+ *
+ * @param ws 统计器 / Statistics
+ * @param x 新样本 / New sample
+ * @return 0 表示成功；非 0 表示统计器无效。/ 0 on success; non-zero if invalid.
+ *
+ * @note 窗口已满时先移除最旧样本；全部统计量在同一次更新中维护，均摊 O(1)。
+ *       When full, the oldest sample is removed first; all statistics are kept
+ *       up to date by the same update, amortized O(1).
+ */
+int seq_winstat_push(seq_winstat_t *ws, seq_sample_t x)
+{
+    if (!ws || !ws->w.buf)
+    {
+        fprintf(stderr, "seq_winstat_push: invalid statistics.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    ops_winstat_step(ws, x);
+    STATS_RECORD(STATS_WINSTAT, t0, 1, 0, 0);
+    return 0;
+}
+
+/**
+ * @brief 批量推入样本，可选地给出每次推入后的统计量 / Push a block of samples, optionally reporting the statistics after each.
+ *
+ * @param ws 统计器 / Statistics
+ * @param x 样本 / Samples
+ * @param n 样本数 / Sample count
+ * @param out 长度 n 的结果数组，第 i 项为推入 x[i] 之后的窗口；可以为 NULL。
+ *            Result array of length n, entry i describing the window after pushing x[i]; may be NULL.
+ * @return 0 表示成功；非 0 表示参数无效。/ 0 on success; non-zero on invalid arguments.
+ *
+ * @note 与逐个 seq_winstat_push() 再 seq_winstat_get() 结果相同。
+ *       Same result as seq_winstat_push() followed by seq_winstat_get() per sample.
+ */
+int seq_winstat_push_n(seq_winstat_t *ws, const seq_sample_t *x, size_t n, seq_winstat_result_t *out)
+{
+    if (!ws || !ws->w.buf || (!x && n > 0))
+    {
+        fprintf(stderr, "seq_winstat_push_n: invalid arguments.\n");
+        return -1;
+    }
+
+    const uint64_t t0 = STATS_START();
+    for (size_t i = 0; i < n; ++i)
+    {
+        ops_winstat_step(ws, x[i]);
+        if (out)
+            ops_winstat_fill(ws, &out[i]);
+    }
+    STATS_RECORD(STATS_WINSTAT, t0, n, out ? n : 0, 0);
+    return 0;
+}
+
+/**
+ * @brief 读取当前窗口的统计量 / Get the statistics of the current window.
+ *
+ * @param ws 统计器 / Statistics
+ * @param out 输出统计量 / Output statistics
+ * @return 0 表示成功；非 0 表示窗口为空。/ 0 on success; non-zero if the window is empty.
+ *
+ * @note 窗口未满时统计已推入的全部样本。/ Before the window fills, all samples pushed so far count.
+ */
+int seq_winstat_get(const seq_winstat_t *ws, seq_winstat_result_t *out)
+{
+    if (!ws || !out)
+    {
+        fprintf(stderr, "seq_winstat_get: null pointer argument.\n");
+        return -1;
+    }
+    if (ws->w.count == 0)
+    {
+        fprintf(stderr, "seq_winstat_get: window is empty.\n");
+        return -1;
+    }
+
+    ops_winstat_fill(ws, out);
     return 0;
 }
@@ -0,0 +1,237 @@
+/**
+ * @file pool.c
+ * @brief 线程池实现 (POSIX threads) / Thread pool implementation (POSIX threads)
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 线程池 / Thread pool
+ *
+ * @note 一次只执行一个作业；next < n 表示作业仍有未领取的块。
+ *       One job at a time; next < n means the job still has unclaimed chunks.
+ */
+struct pool
+{
+    pthread_mutex_t mu;   /**< 保护以下字段 / guards the fields below */
+    pthread_cond_t work;  /**< 有新块可领 / chunks became available */
+    pthread_cond_t done;  /**< 最后一个块完成 / last chunk finished */
+    pthread_t *threads;   /**< 工作线程 / worker threads */
+    size_t nworkers;      /**< 工作线程数（不含调用线程）/ workers, excluding the caller */
+    pool_task_fn fn;      /**< 当前任务 / current task */
+    void *ctx;            /**< 当前上下文 / current context */
+    size_t n;             /**< 下标总数 / index count */
+    size_t grain;         /**< 块大小 / chunk size */
+    size_t next;          /**< 下一个未领取下标 / next unclaimed index */
+    size_t active;        /**< 正在执行的块数 / chunks in flight */
+    int failed;           /**< 是否有任务失败 / whether any task failed */
+    int stop;             /**< 退出标志 / shutdown flag */
+};
+
+/* 内部工具：领取并执行一块，调用时持有锁 / claim and run one chunk; called with the lock held */
+static void pool_run_chunk(pool_t *p)
+{
+    size_t begin = p->next;
+    size_t end = (p->n - begin < p->grain) ? p->n : begin + p->grain;
+    pool_task_fn fn = p->fn;
+    void *ctx = p->ctx;
+
+    p->next = end;
+    p->active++;
+    pthread_mutex_unlock(&p->mu);
+
+    int rc = fn(ctx, begin, end);
+
+    pthread_mutex_lock(&p->mu);
+    p->active--;
+    if (rc != 0)
+        p->failed = 1;
+    if (p->next >= p->n && p->active == 0)
+        pthread_cond_signal(&p->done);
+}
+
+/* 内部工具：工作线程主循环 / internal helper: worker main loop */
+static void *pool_worker(void *arg)
+{
+    pool_t *p = (pool_t *)arg;
+
+    pthread_mutex_lock(&p->mu);
+    for (;;)
+    {
+        while (!p->stop && p->next >= p->n)
+            pthread_cond_wait(&p->work, &p->mu);
+        if (p->stop)
+            break;
+        pool_run_chunk(p);
+    }
+    pthread_mutex_unlock(&p->mu);
+    return NULL;
+}
+
+/**
+ * @brief 创建线程池 / Create a thread pool.
+ *
+ * @param nthreads 总线程数（含调用线程），至少为 1 / Total threads including the caller, at least 1
+ * @return 线程池；失败返回 NULL。/ The pool, or NULL on failure.
+ */
+pool_t *pool_create(size_t nthreads)
+{
+    if (nthreads == 0)
+    {
+        fprintf(stderr, "pool_create: thread count must be > 0.\n");
+        return NULL;
+    }
+
+    pool_t *p = (pool_t *)calloc(1, sizeof(pool_t));
+    if (p == NULL)
+    {
+        fprintf(stderr, "pool_create: allocation failed.\n");
+        return NULL;
+    }
+
+    if (nthreads > 1)
+    {
+        p->threads = (pthread_t *)malloc((nthreads - 1) * sizeof(pthread_t));
+        if (p->threads == NULL)
+        {
+            fprintf(stderr, "pool_create: allocation failed.\n");
+            free(p);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_cond_init(&p->done, NULL);
+
+    for (size_t i = 0; i + 1 < nthreads; ++i)
+    {
+        if (pthread_create(&p->threads[i], NULL, pool_worker, p) != 0)
+        {
+            fprintf(stderr, "pool_create: failed to start worker %zu.\n", i);
+            pool_destroy(p);
+            return NULL;
+        }
+        p->nworkers++;
+    }
+
+    return p;
+}
+
+/**
+ * @brief 停止并回收线程池 / Stop and free a thread pool.
+ *
+ * @param p 线程池，可为 NULL / Pool, may be NULL
+ */
+void pool_destroy(pool_t *p)
+{
+    if (p == NULL)
+        return;
+
+    pthread_mutex_lock(&p->mu);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->mu);
+
+    for (size_t i = 0; i < p->nworkers; ++i)
+        pthread_join(p->threads[i], NULL);
+
+    pthread_cond_destroy(&p->done);
+    pthread_cond_destroy(&p->work);
+    pthread_mutex_destroy(&p->mu);
+    free(p->threads);
+    free(p);
+}
+
+/**
+ * @brief 线程总数（含调用线程）/ Total thread count including the caller.
+ */
+size_t pool_size(const pool_t *p)
+{
+    return (p == NULL) ? 1 : p->nworkers + 1;
+}
+
+/**
+ * @brief 并行执行区间任务 / Run a range task in parallel.
+ *
+ * @param p 线程池；NULL 时在调用线程上串行执行 / Pool; NULL runs serially on the caller
+ * @param n 下标总数 / Index count
+ * @param grain 每块下标数（>0）/ Indices per chunk (> 0)
+ * @param fn 任务 / Task
+ * @param ctx 上下文 / Context
+ * @return 0 表示全部成功；非 0 表示至少一块失败。
+ *         0 if every chunk succeeded; non-zero if any failed.
+ *
+ * @note 阻塞直到所有块完成；同一线程池不可被多个线程同时调用。
+ *       Blocks until every chunk is done; do not call on one pool from
+ *       several threads at once.
+ */
+int pool_run(pool_t *p, size_t n, size_t grain, pool_task_fn fn, void *ctx)
+{
+    if (fn == NULL || grain == 0)
+    {
+        fprintf(stderr, "pool_run: invalid argument.\n");
+        return -1;
+    }
+    if (n == 0)
+        return 0;
+
+    if (p == NULL || p->nworkers == 0)
+    {
+        for (size_t b = 0; b < n; b += grain)
+        {
+            if (fn(ctx, b, (n - b < grain) ? n : b + grain) != 0)
+                return -1;
+        }
+        return 0;
+    }
+
+    pthread_mutex_lock(&p->mu);
+    p->fn = fn;
+    p->ctx = ctx;
+    p->n = n;
+    p->grain = grain;
+    p->next = 0;
+    p->failed = 0;
+    pthread_cond_broadcast(&p->work);
+
+    while (p->next < p->n)
+        pool_run_chunk(p);
+    while (p->active > 0)
+        pthread_cond_wait(&p->done, &p->mu);
+
+    int rc = p->failed ? -1 : 0;
+    p->fn = NULL;
+    p->ctx = NULL;
+    pthread_mutex_unlock(&p->mu);
+    return rc;
+}
+
+/**
+ * @brief 在线逻辑 CPU 数 / Number of online logical CPUs.
+ */
+size_t pool_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (si.dwNumberOfProcessors > 0) ? (size_t)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (size_t)n : 1;
+#endif
+}
@@ -4,9 +4,12 @@
  */
 
 #include "seq.h"
+#include "stats.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 /**
  * @brief 初始化序列 / Initialize a sequence object.
@@ -36,6 +39,7 @@ int seq_init(seq_t *s, size_t len)
         return 0;
     }
 
+    const uint64_t t0 = STATS_START();
     s->data = (seq_sample_t *)calloc(len, sizeof(seq_sample_t));
     if (s->data == NULL)
     {
@@ -44,6 +48,7 @@ int seq_init(seq_t *s, size_t len)
     }
 
     s->length = len;
+    STATS_RECORD(STATS_ALLOC, t0, len, 0, len * sizeof(seq_sample_t));
     return 0;
 }
 
@@ -191,3 +196,350 @@ seq_sample_t seq_window_get(const seq_window_t *w, size_t i)
     size_t idx = (w->start + i) % w->capacity;
     return w->buf[idx];
 }
+
+/**
+ * @brief 初始化镜像滑动窗口 / Initialize a mirrored sliding window.
+ *
+ * @param w 窗口指针，不能为空。/ Window pointer, must not be NULL.
+ * @param capacity 窗口长度，必须 > 0；存储向上取到 2 的幂。
+ *                 Window length, must be > 0; storage is rounded up to a power of two.
+ * @return 0 表示成功；非 0 表示参数无效或内存分配失败。
+ *         0 on success; non-zero on invalid argument or allocation failure.
+ */
+int seq_mwindow_init(seq_mwindow_t *w, size_t capacity)
+{
+    if (w == NULL)
+    {
+        fprintf(stderr, "seq_mwindow_init: window pointer is NULL.\n");
+        return -1;
+    }
+
+    w->buf = NULL;
+    w->size = 0;
+    w->mask = 0;
+    w->capacity = 0;
+    w->head = 0;
+    w->count = 0;
+
+    if (capacity == 0)
+    {
+        fprintf(stderr, "seq_mwindow_init: capacity must be greater than zero.\n");
+        return -1;
+    }
+
+    size_t size = 1;
+    while (size < capacity && size <= SIZE_MAX / 4 / sizeof(seq_sample_t))
+        size <<= 1;
+    if (size < capacity)
+    {
+        fprintf(stderr, "seq_mwindow_init: capacity too large.\n");
+        return -1;
+    }
+
+    w->buf = (seq_sample_t *)calloc(2 * size, sizeof(seq_sample_t));
+    if (w->buf == NULL)
+    {
+        fprintf(stderr, "seq_mwindow_init: failed to allocate buffer.\n");
+        return -1;
+    }
+
+    w->size = size;
+    w->mask = size - 1;
+    w->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief 释放镜像滑动窗口 / Free a mirrored sliding window.
+ *
+ * @param w 窗口指针，可以为 NULL。/ Window pointer, can be NULL.
+ */
+void seq_mwindow_free(seq_mwindow_t *w)
+{
+    if (w == NULL)
+        return;
+
+    free(w->buf);
+    w->buf = NULL;
+    w->size = 0;
+    w->mask = 0;
+    w->capacity = 0;
+    w->head = 0;
+    w->count = 0;
+}
+
+/**
+ * @brief 向镜像窗口批量推入样本 / Push a block of samples into a mirrored window.
+ *
+ * @param w 已初始化的窗口；热路径不做检查。/ Initialized window; not checked on this hot path.
+ * @param x 样本，按时间顺序 / Samples in time order
+ * @param n 样本数，可以超过窗口长度 / Sample count, may exceed the window length
+ *
+ * @note 结果与逐个 seq_mwindow_push() 相同；每份副本至多两次 memcpy，超出 size 的部分直接跳过。
+ *       Same result as pushing one at a time; at most two memcpy per copy, and
+ *       samples that would be overwritten within the call are skipped.
+ */
+void seq_mwindow_push_n(seq_mwindow_t *w, const seq_sample_t *x, size_t n)
+{
+    const size_t total = n;
+
+    if (n > w->size)
+    {
+        /* 只有最后 size 个样本留得下来 / only the last size samples survive */
+        w->head = (w->head + (n - w->size)) & w->mask;
+        x += n - w->size;
+        n = w->size;
+    }
+
+    size_t first = w->size - w->head;
+    if (first > n)
+        first = n;
+    memcpy(w->buf + w->head, x, first * sizeof(seq_sample_t));
+    memcpy(w->buf + w->head + w->size, x, first * sizeof(seq_sample_t));
+    if (n > first)
+    {
+        memcpy(w->buf, x + first, (n - first) * sizeof(seq_sample_t));
+        memcpy(w->buf + w->size, x + first, (n - first) * sizeof(seq_sample_t));
+    }
+    w->head = (w->head + n) & w->mask;
+    w->count = (total >= w->capacity - w->count) ? w->capacity : w->count + total;
+}
+
+/**
+ * @brief 以整个序列为视图 / View a whole sequence.
+ *
+ * @param v 视图，不能为空 / View, must not be NULL
+ * @param s 序列，不能为空 / Sequence, must not be NULL
+ * @return 0 表示成功；非 0 表示参数无效。
+ *         0 on success; non-zero on invalid argument.
+ *
+ * @note 视图期间 s 不可释放或改动。/ s must stay alive and unchanged while viewed.
+ */
+int seq_view_of(seq_view_t *v, const seq_t *s)
+{
+    if (v == NULL || s == NULL || (s->data == NULL && s->length != 0))
+    {
+        fprintf(stderr, "seq_view_of: null pointer argument.\n");
+        return -1;
+    }
+
+    v->base = s->data;
+    v->stride = 1;
+    v->count = s->length;
+    v->lead = 0;
+    v->length = s->length;
+    return 0;
+}
+
+/**
+ * @brief 读取视图第 i 个元素 / Read element i of a view.
+ *
+ * @param v 视图 / View
+ * @param i 下标，须小于 v->length / Index, must be below v->length
+ * @return 元素值；越界时为 0 / Element value; 0 out of range
+ */
+seq_sample_t seq_view_get(const seq_view_t *v, size_t i)
+{
+    if (v == NULL || i < v->lead || i - v->lead >= v->count)
+        return (seq_sample_t)0;
+    return v->base[(ptrdiff_t)(i - v->lead) * v->stride];
+}
+
+/**
+ * @brief 原地反转视图 / Reverse a view in place.
+ *
+ * @param v 视图 / View
+ * @return 0 表示成功；非 0 表示参数无效。
+ *         0 on success; non-zero on invalid argument.
+ *
+ * @note 步长取负，前后零区对换，不触碰样本。
+ *       Negates the stride and swaps the zero regions without touching samples.
+ */
+int seq_view_reverse(seq_view_t *v)
+{
+    if (v == NULL)
+    {
+        fprintf(stderr, "seq_view_reverse: view pointer is NULL.\n");
+        return -1;
+    }
+
+    if (v->count != 0)
+        v->base += (ptrdiff_t)(v->count - 1) * v->stride;
+    v->stride = -v->stride;
+    v->lead = v->length - v->lead - v->count;
+    return 0;
+}
+
+/**
+ * @brief 原地下采样视图：y[n] = x[n·factor] / Downsample a view in place.
+ *
+ * @param v 视图 / View
+ * @param factor 下采样因子，必须 > 0 / Factor, must be > 0
+ * @return 0 表示成功；非 0 表示参数无效或步长溢出。
+ *         0 on success; non-zero on invalid argument or stride overflow.
+ *
+ * @note 输出长度为 length / factor（向下取整）。/ The length becomes length / factor, rounded down.
+ */
+int seq_view_downsample(seq_view_t *v, size_t factor)
+{
+    if (v == NULL || factor == 0)
+    {
+        fprintf(stderr, "seq_view_downsample: invalid argument.\n");
+        return -1;
+    }
+
+    size_t mag = (size_t)(v->stride < 0 ? -v->stride : v->stride);
+    if (factor > (size_t)PTRDIFF_MAX || (mag != 0 && factor > (size_t)PTRDIFF_MAX / mag))
+    {
+        fprintf(stderr, "seq_view_downsample: stride overflow (factor=%zu).\n", factor);
+        return -1;
+    }
+
+    size_t len = v->length / factor;
+    /* 第一个落入存储区的输出下标 i0 = ceil(lead / factor) / first output inside the stored run */
+    size_t i0 = v->lead / factor + (v->lead % factor != 0);
+    size_t count = 0;
+
+    if (i0 < len)
+    {
+        size_t s0 = i0 * factor - v->lead;
+        if (s0 < v->count)
+        {
+            count = (v->count - s0 - 1) / factor + 1;
+            v->base += (ptrdiff_t)s0 * v->stride;
+        }
+        if (count > len - i0)
+            count = len - i0;
+    }
+    else
+    {
+        i0 = len;
+    }
+
+    v->stride *= (ptrdiff_t)factor;
+    v->count = count;
+    v->lead = i0;
+    v->length = len;
+    return 0;
+}
+
+/**
+ * @brief 原地平移视图，长度不变：y[n] = x[n - k]，移入处补零 / Shift a view in place, keeping its length.
+ *
+ * @param v 视图 / View
+ * @param k 平移量：> 0 为延迟，< 0 为提前 / Shift: > 0 delays, < 0 advances
+ * @return 0 表示成功；非 0 表示参数无效。
+ *         0 on success; non-zero on invalid argument.
+ */
+int seq_view_shift(seq_view_t *v, ptrdiff_t k)
+{
+    if (v == NULL)
+    {
+        fprintf(stderr, "seq_view_shift: view pointer is NULL.\n");
+        return -1;
+    }
+
+    if (k >= 0)
+    {
+        size_t d = (size_t)k;
+        size_t keep = (d < v->length) ? v->length - d : 0;
+        if (v->lead >= keep)
+        {
+            v->count = 0;
+            v->lead = v->length;
+            return 0;
+        }
+        if (v->count > keep - v->lead)
+            v->count = keep - v->lead;
+        v->lead += d;
+        return 0;
+    }
+
+    size_t a = (size_t)(-(k + 1)) + 1;
+    if (a <= v->lead)
+    {
+        v->lead -= a;
+        return 0;
+    }
+    size_t skip = a - v->lead;
+    if (skip >= v->count)
+    {
+        v->count = 0;
+        v->lead = v->length;
+        return 0;
+    }
+    v->base += (ptrdiff_t)skip * v->stride;
+    v->count -= skip;
+    v->lead = 0;
+    return 0;
+}
+
+/**
+ * @brief 原地前后补零 / Zero pad a view in place.
+ *
+ * @param v 视图 / View
+ * @param front 前部补零个数 / Zeros to prepend
+ * @param back 尾部补零个数 / Zeros to append
+ * @return 0 表示成功；非 0 表示参数无效或长度溢出。
+ *         0 on success; non-zero on invalid argument or length overflow.
+ */
+int seq_view_pad(seq_view_t *v, size_t front, size_t back)
+{
+    if (v == NULL)
+    {
+        fprintf(stderr, "seq_view_pad: view pointer is NULL.\n");
+        return -1;
+    }
+    if (front > SIZE_MAX - v->length || back > SIZE_MAX - v->length - front)
+    {
+        fprintf(stderr, "seq_view_pad: length overflow.\n");
+        return -1;
+    }
+
+    v->lead += front;
+    v->length += front + back;
+    return 0;
+}
+
+/**
+ * @brief 一趟收集视图到调用方缓冲区 / Gather a view into a caller-owned buffer in one pass.
+ *
+ * @param v 视图 / View
+ * @param out 输出缓冲区，不得与视图存储重叠 / Output buffer; must not overlap the view storage
+ * @param cap 输出容量，须 ≥ v->length / Capacity, at least v->length
+ * @param n_out 实际写入的样本数 / Samples written
+ * @return 0 表示成功；非 0 表示错误。
+ */
+int seq_view_copy_into(const seq_view_t *v, seq_sample_t *out, size_t cap, size_t *n_out)
+{
+    if (v == NULL || n_out == NULL || (out == NULL && v->length != 0))
+    {
+        fprintf(stderr, "seq_view_copy_into: null pointer argument.\n");
+        return -1;
+    }
+    if (cap < v->length)
+    {
+        fprintf(stderr, "seq_view_copy_into: capacity %zu is below the view length %zu.\n",
+                cap, v->length);
+        return -1;
+    }
+
+    size_t i = 0;
+    for (; i < v->lead; ++i)
+        out[i] = (seq_sample_t)0;
+    if (v->stride == 1)
+    {
+        for (size_t k = 0; k < v->count; ++k)
+            out[i + k] = v->base[k];
+    }
+    else
+    {
+        for (size_t k = 0; k < v->count; ++k)
+            out[i + k] = v->base[(ptrdiff_t)k * v->stride];
+    }
+    for (i += v->count; i < v->length; ++i)
+        out[i] = (seq_sample_t)0;
+
+    *n_out = v->length;
+    return 0;
+}
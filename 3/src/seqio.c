@@ -0,0 +1,632 @@
+/**
+ * @file seqio.c
+ * @brief 二进制与内存映射序列 I/O 实现 / Implementation of binary and memory-mapped sequence I/O
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "seqio.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+/* 非零拷贝读写时的分块样本数 / samples per chunk when converting */
+#define SEQIO_CHUNK 2048
+
+/* 内部工具：主机是否为小端 / internal helper: is the host little-endian */
+static int seqio_host_le(void)
+{
+    const unsigned short one = 1;
+    return *(const unsigned char *)&one == 1;
+}
+
+/* 内部工具：大端主机上反转字节序 / internal helper: byte-swap on big-endian hosts */
+static void seqio_to_le(unsigned char *p, size_t n)
+{
+    if (seqio_host_le())
+        return;
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+        unsigned char t = p[i];
+        p[i] = p[n - 1 - i];
+        p[n - 1 - i] = t;
+    }
+}
+
+/* 内部工具：该格式是否与 seq_sample_t 的内存布局一致，可直接使用 /
+ * internal helper: does this format match the seq_sample_t layout */
+static int seqio_native(seq_fmt_t fmt)
+{
+    if (!seqio_host_le())
+        return 0;
+#if SEQ_SAMPLE_IS_FIXED
+    return fmt == SEQ_FMT_S16; /* s16 即 Q15 码值 / s16 is the raw Q15 code */
+#elif SEQ_SAMPLE_IS_DOUBLE
+    return fmt == SEQ_FMT_F64;
+#else
+    return fmt == SEQ_FMT_F32;
+#endif
+}
+
+/* 内部工具：解码 n 个小端样本 / internal helper: decode n little-endian samples */
+static void seqio_decode(const unsigned char *src, seq_fmt_t fmt, seq_sample_t *dst, size_t n)
+{
+    unsigned char b[8];
+
+    if (seqio_native(fmt))
+    {
+        memcpy(dst, src, n * sizeof(seq_sample_t));
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (fmt == SEQ_FMT_F64)
+        {
+            double v;
+            memcpy(b, src + 8 * i, 8);
+            seqio_to_le(b, 8);
+            memcpy(&v, b, 8);
+            dst[i] = seq_sample_from_double(v);
+        }
+        else if (fmt == SEQ_FMT_F32)
+        {
+            float v;
+            memcpy(b, src + 4 * i, 4);
+            seqio_to_le(b, 4);
+            memcpy(&v, b, 4);
+            dst[i] = seq_sample_from_double((double)v);
+        }
+        else
+        {
+            unsigned int u = (unsigned int)src[2 * i] | ((unsigned int)src[2 * i + 1] << 8);
+            dst[i] = (seq_sample_t)((u >= 0x8000u) ? (int)u - 0x10000 : (int)u);
+        }
+    }
+}
+
+/* 内部工具：编码 n 个样本为小端 / internal helper: encode n samples as little-endian */
+static void seqio_encode(const seq_sample_t *src, seq_fmt_t fmt, unsigned char *dst, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        double x = seq_sample_to_double(src[i]);
+        if (fmt == SEQ_FMT_F64)
+        {
+            memcpy(dst + 8 * i, &x, 8);
+            seqio_to_le(dst + 8 * i, 8);
+        }
+        else if (fmt == SEQ_FMT_F32)
+        {
+            float v = (float)x;
+            memcpy(dst + 4 * i, &v, 4);
+            seqio_to_le(dst + 4 * i, 4);
+        }
+        else
+        {
+            /* 四舍五入并饱和；NaN 写为 0 / round, saturate; NaN becomes 0 */
+            int v;
+#if SEQ_SAMPLE_IS_FIXED
+            v = (int)src[i];
+#else
+            if (x != x)
+                v = 0;
+            else if (x >= 32767.0)
+                v = 32767;
+            else if (x <= -32768.0)
+                v = -32768;
+            else
+                v = (int)((x >= 0.0) ? x + 0.5 : x - 0.5);
+#endif
+            dst[2 * i] = (unsigned char)((unsigned int)v & 0xFFu);
+            dst[2 * i + 1] = (unsigned char)(((unsigned int)v >> 8) & 0xFFu);
+        }
+    }
+}
+
+/**
+ * @brief 解析格式名 / Parse a format name.
+ *
+ * @param name text / f64 / f32 / s16
+ * @param fmt 输出格式 / Output format
+ * @return 0 表示成功；非 0 表示未知格式。
+ *         0 on success; non-zero for an unknown name.
+ */
+int seq_fmt_parse(const char *name, seq_fmt_t *fmt)
+{
+    if (name == NULL || fmt == NULL)
+        return -1;
+
+    if (strcmp(name, "text") == 0)
+        *fmt = SEQ_FMT_TEXT;
+    else if (strcmp(name, "f64") == 0)
+        *fmt = SEQ_FMT_F64;
+    else if (strcmp(name, "f32") == 0)
+        *fmt = SEQ_FMT_F32;
+    else if (strcmp(name, "s16") == 0)
+        *fmt = SEQ_FMT_S16;
+    else
+        return -1;
+    return 0;
+}
+
+/**
+ * @brief 每样本字节数，文本格式为 0 / Bytes per sample, 0 for text.
+ */
+size_t seq_fmt_size(seq_fmt_t fmt)
+{
+    switch (fmt)
+    {
+    case SEQ_FMT_F64:
+        return 8;
+    case SEQ_FMT_F32:
+        return 4;
+    case SEQ_FMT_S16:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 把流切换为二进制模式（仅 Windows 需要）/ Switch a stream to binary mode (Windows only).
+ */
+void seq_io_binary_mode(FILE *fp)
+{
+#ifdef _WIN32
+    if (fp != NULL)
+        _setmode(_fileno(fp), _O_BINARY);
+#else
+    (void)fp;
+#endif
+}
+
+/**
+ * @brief 打开二进制读取器 / Open a binary reader.
+ *
+ * @param r 读取器 / Reader
+ * @param fp 输入流 / Input stream
+ * @param fmt 二进制样本格式 / Binary sample format
+ * @return 0 表示成功；非 0 表示参数无效。
+ *         0 on success; non-zero on invalid arguments.
+ *
+ * @note 普通文件被私有、可写地映射：写入映射内的序列只影响本进程。
+ *       Regular files are mapped private and writable: writing to a sequence
+ *       inside the mapping only affects this process.
+ */
+int seq_reader_open(seq_reader_t *r, FILE *fp, seq_fmt_t fmt)
+{
+    if (r == NULL || fp == NULL || seq_fmt_size(fmt) == 0)
+    {
+        fprintf(stderr, "seq_reader_open: invalid argument.\n");
+        return -1;
+    }
+
+    r->fp = fp;
+    r->fmt = fmt;
+    r->map = NULL;
+    r->map_len = 0;
+    r->pos = 0;
+
+#ifndef _WIN32
+    struct stat sb;
+    long off = ftell(fp);
+    if (fstat(fileno(fp), &sb) == 0 && S_ISREG(sb.st_mode) && off >= 0 && (off_t)off < sb.st_size)
+    {
+        void *base = mmap(NULL, (size_t)sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                          fileno(fp), 0);
+        if (base != MAP_FAILED)
+        {
+            posix_madvise(base, (size_t)sb.st_size, POSIX_MADV_SEQUENTIAL);
+            r->map = (unsigned char *)base;
+            r->map_len = (size_t)sb.st_size;
+            r->pos = (size_t)off;
+        }
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief 关闭读取器并解除映射 / Close the reader and unmap the input.
+ *
+ * @note 关闭后不得再使用零拷贝载入的序列。
+ *       Zero-copy sequences must not be used after closing.
+ */
+void seq_reader_close(seq_reader_t *r)
+{
+    if (r == NULL)
+        return;
+#ifndef _WIN32
+    if (r->map != NULL)
+        munmap(r->map, r->map_len);
+#endif
+    r->map = NULL;
+    r->map_len = 0;
+    r->pos = 0;
+}
+
+/* 内部工具：读取恰好 n 字节 / internal helper: read exactly n bytes */
+static int seqio_read_bytes(seq_reader_t *r, void *dst, size_t n)
+{
+    if (r->map != NULL)
+    {
+        if (r->map_len - r->pos < n)
+            return -1;
+        memcpy(dst, r->map + r->pos, n);
+        r->pos += n;
+        return 0;
+    }
+    return (fread(dst, 1, n, r->fp) == n) ? 0 : -1;
+}
+
+/**
+ * @brief 读取一个 8 字节小端无符号整数 / Read an 8-byte little-endian unsigned integer.
+ *
+ * @return 0 表示成功；非 0 表示输入结束或截断。
+ *         0 on success; non-zero at end of input or on truncation.
+ */
+int seq_reader_u64(seq_reader_t *r, uint64_t *v)
+{
+    unsigned char b[8];
+
+    if (r == NULL || v == NULL || seqio_read_bytes(r, b, 8) != 0)
+        return -1;
+
+    *v = 0;
+    for (int i = 7; i >= 0; --i)
+        *v = (*v << 8) | b[i];
+    return 0;
+}
+
+/**
+ * @brief 读取一条带长度头的序列 / Read one length-prefixed sequence.
+ *
+ * @param r 读取器 / Reader
+ * @param s 输出序列，用 seq_reader_release 释放 / Output, release with seq_reader_release
+ * @return 0 表示成功；非 0 表示失败。
+ *         0 on success; non-zero on failure.
+ *
+ * @note 映射输入、格式与 seq_sample_t 一致且地址对齐时 s->data 直接指向映射（零拷贝）。
+ *       For mapped input whose format matches seq_sample_t at an aligned
+ *       offset, s->data points straight into the mapping (zero-copy).
+ */
+int seq_reader_seq(seq_reader_t *r, seq_t *s)
+{
+    uint64_t len = 0;
+
+    if (r == NULL || s == NULL)
+    {
+        fprintf(stderr, "seq_reader_seq: NULL pointer argument.\n");
+        return -1;
+    }
+
+    const size_t sz = seq_fmt_size(r->fmt);
+    if (seq_reader_u64(r, &len) != 0)
+    {
+        fprintf(stderr, "seq_reader_seq: failed to read sequence length.\n");
+        return -1;
+    }
+    if (len > SIZE_MAX / sz)
+    {
+        fprintf(stderr, "seq_reader_seq: sequence length too large.\n");
+        return -1;
+    }
+
+    if (r->map != NULL)
+    {
+        if (r->map_len - r->pos < (size_t)len * sz)
+        {
+            fprintf(stderr, "seq_reader_seq: truncated sequence data.\n");
+            return -1;
+        }
+        if (seqio_native(r->fmt) && len > 0 && (uintptr_t)(r->map + r->pos) % sizeof(seq_sample_t) == 0)
+        {
+            s->data = (seq_sample_t *)(void *)(r->map + r->pos);
+            s->length = (size_t)len;
+            r->pos += (size_t)len * sz;
+            return 0;
+        }
+        if (seq_init(s, (size_t)len) != 0)
+            return -1;
+        seqio_decode(r->map + r->pos, r->fmt, s->data, (size_t)len);
+        r->pos += (size_t)len * sz;
+        return 0;
+    }
+
+    if (seq_init(s, (size_t)len) != 0)
+        return -1;
+    size_t got = 0;
+    if (seq_reader_samples(r, s->data, (size_t)len, &got) != 0 || got != (size_t)len)
+    {
+        fprintf(stderr, "seq_reader_seq: truncated sequence data.\n");
+        seq_free(s);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 读取至多 cap 个原始样本 / Read up to cap raw samples.
+ *
+ * @param n 实际读取数；少于 cap 表示输入结束 / Samples read; fewer than cap means end of input
+ * @return 0 表示成功；非 0 表示末尾有不完整样本。
+ *         0 on success; non-zero on a trailing partial sample.
+ */
+int seq_reader_samples(seq_reader_t *r, seq_sample_t *out, size_t cap, size_t *n)
+{
+    if (r == NULL || out == NULL || n == NULL)
+    {
+        fprintf(stderr, "seq_reader_samples: NULL pointer argument.\n");
+        return -1;
+    }
+
+    const size_t sz = seq_fmt_size(r->fmt);
+    *n = 0;
+
+    if (r->map != NULL)
+    {
+        size_t avail = (r->map_len - r->pos) / sz;
+        size_t take = (avail < cap) ? avail : cap;
+        seqio_decode(r->map + r->pos, r->fmt, out, take);
+        r->pos += take * sz;
+        *n = take;
+        if (take < cap && r->pos != r->map_len)
+        {
+            fprintf(stderr, "seq_reader_samples: trailing partial sample.\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (seqio_native(r->fmt))
+    {
+        size_t bytes = fread(out, 1, cap * sz, r->fp);
+        *n = bytes / sz;
+        if (bytes % sz != 0)
+        {
+            fprintf(stderr, "seq_reader_samples: trailing partial sample.\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    while (*n < cap)
+    {
+        unsigned char raw[SEQIO_CHUNK * 8];
+        size_t want = (cap - *n < SEQIO_CHUNK) ? cap - *n : SEQIO_CHUNK;
+        size_t bytes = fread(raw, 1, want * sz, r->fp);
+        if (bytes % sz != 0)
+        {
+            fprintf(stderr, "seq_reader_samples: trailing partial sample.\n");
+            return -1;
+        }
+        seqio_decode(raw, r->fmt, out + *n, bytes / sz);
+        *n += bytes / sz;
+        if (bytes < want * sz)
+            break;
+    }
+    return 0;
+}
+
+/**
+ * @brief 释放由读取器载入的序列 / Release a sequence loaded by the reader.
+ *
+ * @note 指向映射内部的序列只被重置，其余的调用 seq_free。
+ *       Sequences inside the mapping are just reset; others go through seq_free.
+ */
+void seq_reader_release(const seq_reader_t *r, seq_t *s)
+{
+    if (s == NULL)
+        return;
+
+    if (r != NULL && r->map != NULL && s->data != NULL)
+    {
+        uintptr_t p = (uintptr_t)s->data;
+        uintptr_t b = (uintptr_t)r->map;
+        if (p >= b && p < b + r->map_len)
+        {
+            s->data = NULL;
+            s->length = 0;
+            return;
+        }
+    }
+    seq_free(s);
+}
+
+/* 内部工具：定位到字节偏移（支持 2 GiB 以上）/ internal helper: seek to a byte offset beyond 2 GiB too */
+static int seqio_seek(FILE *fp, uint64_t off)
+{
+#ifdef _WIN32
+    return _fseeki64(fp, (__int64)off, SEEK_SET);
+#else
+    return fseeko(fp, (off_t)off, SEEK_SET);
+#endif
+}
+
+/**
+ * @brief 打开文件中的一条序列 / Open a sequence stored in a file.
+ *
+ * @param f 输出描述 / Output descriptor
+ * @param fp 可定位的输入流 / Seekable input stream
+ * @param fmt 二进制样本格式 / Binary sample format
+ * @param offset 长度字段的字节偏移 / Byte offset of the u64 length field
+ * @return 0 表示成功；非 0 表示参数无效、不可定位或长度超出文件。
+ *         0 on success; non-zero on invalid arguments, an unseekable stream or a length past the file end.
+ *
+ * @note 只读取 8 字节长度，样本留在文件中。Only the 8-byte length is read; samples stay in the file.
+ */
+int seq_file_open(seq_file_t *f, FILE *fp, seq_fmt_t fmt, uint64_t offset)
+{
+    const size_t sz = seq_fmt_size(fmt);
+    unsigned char b[8];
+
+    if (f == NULL || fp == NULL || sz == 0)
+    {
+        fprintf(stderr, "seq_file_open: invalid argument.\n");
+        return -1;
+    }
+    if (seqio_seek(fp, offset) != 0 || fread(b, 1, 8, fp) != 8)
+    {
+        fprintf(stderr, "seq_file_open: cannot read the length at offset %llu (input must be a seekable file).\n",
+                (unsigned long long)offset);
+        return -1;
+    }
+
+    uint64_t len = 0;
+    for (int i = 7; i >= 0; --i)
+        len = (len << 8) | b[i];
+
+    /* 校验样本确实在文件内 / check the samples really are in the file */
+    if (len > (UINT64_MAX - offset - 8) / sz ||
+        (len > 0 && (seqio_seek(fp, offset + 8 + (len - 1) * sz) != 0 || fread(b, 1, sz, fp) != sz)))
+    {
+        fprintf(stderr, "seq_file_open: sequence of length %llu runs past the end of the input.\n",
+                (unsigned long long)len);
+        return -1;
+    }
+
+    f->fp = fp;
+    f->fmt = fmt;
+    f->offset = offset + 8;
+    f->length = len;
+    return 0;
+}
+
+/**
+ * @brief 序列之后的字节偏移，即下一条序列的位置 / Byte offset just past the sequence, where the next one starts.
+ */
+uint64_t seq_file_end(const seq_file_t *f)
+{
+    return (f == NULL) ? 0 : f->offset + f->length * seq_fmt_size(f->fmt);
+}
+
+/**
+ * @brief 读取下标 [first, first + n) 的样本 / Read the samples at indices [first, first + n).
+ *
+ * @param f 文件中的序列 / File-backed sequence
+ * @param first 起始下标 / First index
+ * @param out 输出 / Output (n samples)
+ * @param n 个数 / Count
+ * @return 0 表示成功；非 0 表示读取失败。/ 0 on success; non-zero on a read failure.
+ *
+ * @note 超出 [0, length) 的部分填 0，便于分块处理末块。
+ *       Indices past the length read as 0, which suits the last block of chunked processing.
+ */
+int seq_file_read(const seq_file_t *f, uint64_t first, seq_sample_t *out, size_t n)
+{
+    if (f == NULL || (out == NULL && n > 0))
+    {
+        fprintf(stderr, "seq_file_read: NULL pointer argument.\n");
+        return -1;
+    }
+
+    const size_t sz = seq_fmt_size(f->fmt);
+    size_t take = (first >= f->length) ? 0 : (f->length - first < n) ? (size_t)(f->length - first) : n;
+
+    for (size_t i = take; i < n; ++i)
+        out[i] = 0;
+    if (take == 0)
+        return 0;
+
+    if (seqio_seek(f->fp, f->offset + first * sz) != 0)
+    {
+        fprintf(stderr, "seq_file_read: seek failed.\n");
+        return -1;
+    }
+
+    if (seqio_native(f->fmt))
+    {
+        if (fread(out, sz, take, f->fp) != take)
+        {
+            fprintf(stderr, "seq_file_read: short read.\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    for (size_t done = 0; done < take;)
+    {
+        unsigned char raw[SEQIO_CHUNK * 8];
+        size_t want = (take - done < SEQIO_CHUNK) ? take - done : SEQIO_CHUNK;
+        if (fread(raw, sz, want, f->fp) != want)
+        {
+            fprintf(stderr, "seq_file_read: short read.\n");
+            return -1;
+        }
+        seqio_decode(raw, f->fmt, out + done, want);
+        done += want;
+    }
+    return 0;
+}
+
+/**
+ * @brief 写出一个 8 字节小端无符号整数 / Write an 8-byte little-endian unsigned integer.
+ */
+int seq_io_write_u64(FILE *fp, uint64_t v)
+{
+    unsigned char b[8];
+    for (int i = 0; i < 8; ++i)
+        b[i] = (unsigned char)((v >> (8 * i)) & 0xFFu);
+    return (fp != NULL && fwrite(b, 1, 8, fp) == 8) ? 0 : -1;
+}
+
+/**
+ * @brief 以二进制格式写出 n 个样本 / Write n samples in a binary format.
+ *
+ * @return 0 表示成功；非 0 表示写失败。
+ *         0 on success; non-zero on a write failure.
+ */
+int seq_io_write(FILE *fp, seq_fmt_t fmt, const seq_sample_t *v, size_t n)
+{
+    const size_t sz = seq_fmt_size(fmt);
+
+    if (fp == NULL || (n > 0 && v == NULL) || sz == 0)
+    {
+        fprintf(stderr, "seq_io_write: invalid argument.\n");
+        return -1;
+    }
+
+    if (seqio_native(fmt))
+        return (fwrite(v, sz, n, fp) == n) ? 0 : -1;
+
+    for (size_t done = 0; done < n;)
+    {
+        unsigned char raw[SEQIO_CHUNK * 8];
+        size_t take = (n - done < SEQIO_CHUNK) ? n - done : SEQIO_CHUNK;
+        seqio_encode(v + done, fmt, raw, take);
+        if (fwrite(raw, sz, take, fp) != take)
+            return -1;
+        done += take;
+    }
+    return 0;
+}
+
+/**
+ * @brief 写出一条带长度头的序列 / Write one length-prefixed sequence.
+ */
+int seq_io_write_seq(FILE *fp, seq_fmt_t fmt, const seq_t *s)
+{
+    if (s == NULL)
+    {
+        fprintf(stderr, "seq_io_write_seq: NULL sequence pointer.\n");
+        return -1;
+    }
+    if (seq_io_write_u64(fp, (uint64_t)s->length) != 0)
+        return -1;
+    return seq_io_write(fp, fmt, s->data, s->length);
+}
@@ -0,0 +1,508 @@
+/**
+ * @file simd.c
+ * @brief 向量化 double 内核实现 / Implementation of vectorized double kernels
+ *
+ * x86 上各内核以 GCC target 属性单独编译，运行时按 CPU 能力选择；
+ * AArch64 上 NEON 总是可用。其他编译器/平台只用标量实现。
+ * On x86 each kernel is compiled with a GCC target attribute and chosen at
+ * run time from the CPU features; NEON is always present on AArch64. Other
+ * compilers and platforms use the scalar code only.
+ */
+
+#include "simd.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define SIMD_NEON 0
+#endif
+
+/* 逐位一致要求乘加不被合并为 FMA（target("avx512f") 等函数里的标量尾部也一样），
+ * 不依赖 -std=c11 隐含的 -ffp-contract=off。
+ * Bit-identical results need a*b + c left unfused, scalar tails inside the
+ * target("avx512f") functions included; do not rely on -std=c11 implying
+ * -ffp-contract=off. */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/* 每个分块同时计算的向量个数（寄存器分块）/ vectors per register-blocked tile */
+#define SIMD_TILE_VECS 4
+
+typedef void (*simd_binop_fn)(const double *a, const double *b, double *y, size_t n);
+typedef void (*simd_tile_fn)(const double *w, ptrdiff_t wstep, size_t taps,
+                             const double *x, ptrdiff_t xstep, double *y, size_t count);
+
+/**
+ * @brief 一组内核 / One kernel set
+ */
+typedef struct
+{
+    simd_binop_fn add;
+    simd_binop_fn mul;
+    simd_tile_fn tile;
+} simd_kernels_t;
+
+/* === 标量 (Scalar) === */
+
+static void simd_add_scalar(const double *a, const double *b, double *y, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        y[i] = a[i] + b[i];
+}
+
+static void simd_mul_scalar(const double *a, const double *b, double *y, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        y[i] = a[i] * b[i];
+}
+
+static void simd_tile_scalar(const double *w, ptrdiff_t wstep, size_t taps,
+                             const double *x, ptrdiff_t xstep, double *y, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        double acc = 0.0;
+        for (size_t t = 0; t < taps; ++t)
+            acc += w[(ptrdiff_t)t * wstep] * x[(ptrdiff_t)i + (ptrdiff_t)t * xstep];
+        y[i] = acc;
+    }
+}
+
+/* === x86 SSE2 / AVX2 / AVX-512F === */
+#if SIMD_X86
+
+__attribute__((target("sse2")))
+static void simd_add_sse2(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    simd_add_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void simd_mul_sse2(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    simd_mul_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void simd_tile_sse2(const double *w, ptrdiff_t wstep, size_t taps,
+                           const double *x, ptrdiff_t xstep, double *y, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 * SIMD_TILE_VECS <= count; i += 2 * SIMD_TILE_VECS)
+    {
+        __m128d c0 = _mm_setzero_pd(), c1 = _mm_setzero_pd();
+        __m128d c2 = _mm_setzero_pd(), c3 = _mm_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m128d wv = _mm_set1_pd(w[(ptrdiff_t)t * wstep]);
+            const double *p = x + (ptrdiff_t)i + (ptrdiff_t)t * xstep;
+            c0 = _mm_add_pd(c0, _mm_mul_pd(wv, _mm_loadu_pd(p)));
+            c1 = _mm_add_pd(c1, _mm_mul_pd(wv, _mm_loadu_pd(p + 2)));
+            c2 = _mm_add_pd(c2, _mm_mul_pd(wv, _mm_loadu_pd(p + 4)));
+            c3 = _mm_add_pd(c3, _mm_mul_pd(wv, _mm_loadu_pd(p + 6)));
+        }
+        _mm_storeu_pd(y + i, c0);
+        _mm_storeu_pd(y + i + 2, c1);
+        _mm_storeu_pd(y + i + 4, c2);
+        _mm_storeu_pd(y + i + 6, c3);
+    }
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d c0 = _mm_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m128d wv = _mm_set1_pd(w[(ptrdiff_t)t * wstep]);
+            c0 = _mm_add_pd(c0, _mm_mul_pd(wv, _mm_loadu_pd(x + (ptrdiff_t)i + (ptrdiff_t)t * xstep)));
+        }
+        _mm_storeu_pd(y + i, c0);
+    }
+    simd_tile_scalar(w, wstep, taps, x + i, xstep, y + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void simd_add_avx2(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    simd_add_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void simd_mul_avx2(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    simd_mul_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void simd_tile_avx2(const double *w, ptrdiff_t wstep, size_t taps,
+                           const double *x, ptrdiff_t xstep, double *y, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 * SIMD_TILE_VECS <= count; i += 4 * SIMD_TILE_VECS)
+    {
+        __m256d c0 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+        __m256d c2 = _mm256_setzero_pd(), c3 = _mm256_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m256d wv = _mm256_set1_pd(w[(ptrdiff_t)t * wstep]);
+            const double *p = x + (ptrdiff_t)i + (ptrdiff_t)t * xstep;
+            c0 = _mm256_add_pd(c0, _mm256_mul_pd(wv, _mm256_loadu_pd(p)));
+            c1 = _mm256_add_pd(c1, _mm256_mul_pd(wv, _mm256_loadu_pd(p + 4)));
+            c2 = _mm256_add_pd(c2, _mm256_mul_pd(wv, _mm256_loadu_pd(p + 8)));
+            c3 = _mm256_add_pd(c3, _mm256_mul_pd(wv, _mm256_loadu_pd(p + 12)));
+        }
+        _mm256_storeu_pd(y + i, c0);
+        _mm256_storeu_pd(y + i + 4, c1);
+        _mm256_storeu_pd(y + i + 8, c2);
+        _mm256_storeu_pd(y + i + 12, c3);
+    }
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d c0 = _mm256_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m256d wv = _mm256_set1_pd(w[(ptrdiff_t)t * wstep]);
+            c0 = _mm256_add_pd(c0, _mm256_mul_pd(wv, _mm256_loadu_pd(x + (ptrdiff_t)i + (ptrdiff_t)t * xstep)));
+        }
+        _mm256_storeu_pd(y + i, c0);
+    }
+    simd_tile_scalar(w, wstep, taps, x + i, xstep, y + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+static void simd_add_avx512(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    simd_add_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void simd_mul_avx512(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    simd_mul_scalar(a + i, b + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void simd_tile_avx512(const double *w, ptrdiff_t wstep, size_t taps,
+                             const double *x, ptrdiff_t xstep, double *y, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 * SIMD_TILE_VECS <= count; i += 8 * SIMD_TILE_VECS)
+    {
+        __m512d c0 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+        __m512d c2 = _mm512_setzero_pd(), c3 = _mm512_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m512d wv = _mm512_set1_pd(w[(ptrdiff_t)t * wstep]);
+            const double *p = x + (ptrdiff_t)i + (ptrdiff_t)t * xstep;
+            c0 = _mm512_add_pd(c0, _mm512_mul_pd(wv, _mm512_loadu_pd(p)));
+            c1 = _mm512_add_pd(c1, _mm512_mul_pd(wv, _mm512_loadu_pd(p + 8)));
+            c2 = _mm512_add_pd(c2, _mm512_mul_pd(wv, _mm512_loadu_pd(p + 16)));
+            c3 = _mm512_add_pd(c3, _mm512_mul_pd(wv, _mm512_loadu_pd(p + 24)));
+        }
+        _mm512_storeu_pd(y + i, c0);
+        _mm512_storeu_pd(y + i + 8, c1);
+        _mm512_storeu_pd(y + i + 16, c2);
+        _mm512_storeu_pd(y + i + 24, c3);
+    }
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d c0 = _mm512_setzero_pd();
+        for (size_t t = 0; t < taps; ++t)
+        {
+            __m512d wv = _mm512_set1_pd(w[(ptrdiff_t)t * wstep]);
+            c0 = _mm512_add_pd(c0, _mm512_mul_pd(wv, _mm512_loadu_pd(x + (ptrdiff_t)i + (ptrdiff_t)t * xstep)));
+        }
+        _mm512_storeu_pd(y + i, c0);
+    }
+    simd_tile_scalar(w, wstep, taps, x + i, xstep, y + i, count - i);
+}
+
+#endif /* SIMD_X86 */
+
+/* === AArch64 NEON === */
+#if SIMD_NEON
+
+static void simd_add_neon(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        vst1q_f64(y + i, vaddq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    simd_add_scalar(a + i, b + i, y + i, n - i);
+}
+
+static void simd_mul_neon(const double *a, const double *b, double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        vst1q_f64(y + i, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    simd_mul_scalar(a + i, b + i, y + i, n - i);
+}
+
+static void simd_tile_neon(const double *w, ptrdiff_t wstep, size_t taps,
+                           const double *x, ptrdiff_t xstep, double *y, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 * SIMD_TILE_VECS <= count; i += 2 * SIMD_TILE_VECS)
+    {
+        float64x2_t c0 = vdupq_n_f64(0.0), c1 = vdupq_n_f64(0.0);
+        float64x2_t c2 = vdupq_n_f64(0.0), c3 = vdupq_n_f64(0.0);
+        for (size_t t = 0; t < taps; ++t)
+        {
+            float64x2_t wv = vdupq_n_f64(w[(ptrdiff_t)t * wstep]);
+            const double *p = x + (ptrdiff_t)i + (ptrdiff_t)t * xstep;
+            /* 分开乘加，避免 vfmaq 改变舍入 / separate mul+add so rounding matches scalar */
+            c0 = vaddq_f64(c0, vmulq_f64(wv, vld1q_f64(p)));
+            c1 = vaddq_f64(c1, vmulq_f64(wv, vld1q_f64(p + 2)));
+            c2 = vaddq_f64(c2, vmulq_f64(wv, vld1q_f64(p + 4)));
+            c3 = vaddq_f64(c3, vmulq_f64(wv, vld1q_f64(p + 6)));
+        }
+        vst1q_f64(y + i, c0);
+        vst1q_f64(y + i + 2, c1);
+        vst1q_f64(y + i + 4, c2);
+        vst1q_f64(y + i + 6, c3);
+    }
+    simd_tile_scalar(w, wstep, taps, x + i, xstep, y + i, count - i);
+}
+
+#endif /* SIMD_NEON */
+
+/* 内部工具：按指令集取内核 / internal helper: kernels of one ISA */
+static simd_kernels_t simd_kernels_of(simd_isa_t isa)
+{
+    simd_kernels_t k = {simd_add_scalar, simd_mul_scalar, simd_tile_scalar};
+
+    switch (isa)
+    {
+#if SIMD_X86
+    case SIMD_ISA_SSE2:
+        k.add = simd_add_sse2;
+        k.mul = simd_mul_sse2;
+        k.tile = simd_tile_sse2;
+        break;
+    case SIMD_ISA_AVX2:
+        k.add = simd_add_avx2;
+        k.mul = simd_mul_avx2;
+        k.tile = simd_tile_avx2;
+        break;
+    case SIMD_ISA_AVX512:
+        k.add = simd_add_avx512;
+        k.mul = simd_mul_avx512;
+        k.tile = simd_tile_avx512;
+        break;
+#endif
+#if SIMD_NEON
+    case SIMD_ISA_NEON:
+        k.add = simd_add_neon;
+        k.mul = simd_mul_neon;
+        k.tile = simd_tile_neon;
+        break;
+#endif
+    default:
+        break;
+    }
+    return k;
+}
+
+/* 当前选用的指令集与内核；未初始化时首次调用检测 / active ISA, detected on first use */
+static int simd_ready = 0;
+static simd_isa_t simd_active = SIMD_ISA_SCALAR;
+static simd_kernels_t simd_table;
+
+/* 内部工具：检测可用的最宽指令集 / internal helper: detect the widest supported ISA */
+static simd_isa_t simd_detect(void)
+{
+    if (simd_isa_supported(SIMD_ISA_AVX512))
+        return SIMD_ISA_AVX512;
+    if (simd_isa_supported(SIMD_ISA_AVX2))
+        return SIMD_ISA_AVX2;
+    if (simd_isa_supported(SIMD_ISA_SSE2))
+        return SIMD_ISA_SSE2;
+    if (simd_isa_supported(SIMD_ISA_NEON))
+        return SIMD_ISA_NEON;
+    return SIMD_ISA_SCALAR;
+}
+
+/* 内部工具：取当前内核表 / internal helper: current kernel table */
+static const simd_kernels_t *simd_kernels(void)
+{
+    if (!simd_ready)
+    {
+        simd_active = simd_detect();
+        simd_table = simd_kernels_of(simd_active);
+        simd_ready = 1;
+    }
+    return &simd_table;
+}
+
+/**
+ * @brief 查询指令集在本机是否可用 / Check whether an ISA is usable on this machine.
+ *
+ * @param isa 指令集 / ISA
+ * @return 1 表示可用；0 表示不可用或未编译。/ 1 if usable; 0 if unsupported or not compiled in.
+ */
+int simd_isa_supported(simd_isa_t isa)
+{
+    switch (isa)
+    {
+    case SIMD_ISA_SCALAR:
+        return 1;
+#if SIMD_X86
+    case SIMD_ISA_SSE2:
+        return __builtin_cpu_supports("sse2") ? 1 : 0;
+    case SIMD_ISA_AVX2:
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+    case SIMD_ISA_AVX512:
+        return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+#if SIMD_NEON
+    case SIMD_ISA_NEON:
+        return 1;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 当前选用的指令集 / Currently selected ISA.
+ *
+ * @note 首次调用时检测 CPU；多线程使用前应先在主线程调用一次。
+ *       Detects the CPU on first use; call once from the main thread before
+ *       running kernels concurrently.
+ */
+simd_isa_t simd_get_isa(void)
+{
+    simd_kernels();
+    return simd_active;
+}
+
+/**
+ * @brief 强制指定指令集（测试与基准用）/ Force an ISA (for tests and benchmarks).
+ *
+ * @param isa 指令集 / ISA
+ * @return 0 表示成功；非 0 表示本机不支持。/ 0 on success; non-zero if unsupported here.
+ */
+int simd_set_isa(simd_isa_t isa)
+{
+    if (!simd_isa_supported(isa))
+        return -1;
+
+    simd_active = isa;
+    simd_table = simd_kernels_of(isa);
+    simd_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief 指令集名称 / ISA name.
+ */
+const char *simd_isa_name(simd_isa_t isa)
+{
+    switch (isa)
+    {
+    case SIMD_ISA_SSE2:
+        return "sse2";
+    case SIMD_ISA_AVX2:
+        return "avx2";
+    case SIMD_ISA_AVX512:
+        return "avx512";
+    case SIMD_ISA_NEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief 解析指令集名称 / Parse an ISA name.
+ *
+ * @param name scalar / sse2 / avx2 / avx512 / neon
+ * @param isa 输出 / Output
+ * @return 0 表示成功；非 0 表示未知名称。/ 0 on success; non-zero for an unknown name.
+ */
+int simd_isa_parse(const char *name, simd_isa_t *isa)
+{
+    if (name == NULL || isa == NULL)
+        return -1;
+
+    for (int i = SIMD_ISA_SCALAR; i <= SIMD_ISA_NEON; ++i)
+    {
+        if (strcmp(name, simd_isa_name((simd_isa_t)i)) == 0)
+        {
+            *isa = (simd_isa_t)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief y[i] = a[i] + b[i]
+ */
+void simd_add_f64(const double *a, const double *b, double *y, size_t n)
+{
+    simd_kernels()->add(a, b, y, n);
+}
+
+/**
+ * @brief y[i] = a[i] * b[i]
+ */
+void simd_mul_f64(const double *a, const double *b, double *y, size_t n)
+{
+    simd_kernels()->mul(a, b, y, n);
+}
+
+/**
+ * @brief 多输出点积分块 / Multi-output dot-product tile.
+ *
+ * y[i] = Σ_{t=0}^{taps-1} w[t·wstep] · x[i + t·xstep]，0 ≤ i < count。
+ *
+ * @param w 权重基址 / weight base pointer
+ * @param wstep 权重步长（±1）/ weight stride (±1)
+ * @param taps 项数 / number of terms
+ * @param x 数据基址，所有访问下标必须合法 / data base; every index touched must be valid
+ * @param xstep 数据随 t 的步长（±1）/ data stride per term (±1)
+ * @param y 输出 / output
+ * @param count 输出个数 / number of outputs
+ *
+ * @note 相邻输出读取相邻数据，故按输出方向向量化，每次广播一个权重并同时
+ *       更新 SIMD_TILE_VECS 个累加向量；t 的累加顺序与标量循环相同。
+ *       Neighbouring outputs read neighbouring data, so lanes run along the
+ *       outputs: one weight is broadcast per term and SIMD_TILE_VECS
+ *       accumulator vectors are updated together, summing t in scalar order.
+ */
+void simd_dot_tile_f64(const double *w, ptrdiff_t wstep, size_t taps,
+                       const double *x, ptrdiff_t xstep,
+                       double *y, size_t count)
+{
+    simd_kernels()->tile(w, wstep, taps, x, xstep, y, count);
+}
@@ -0,0 +1,584 @@
+/**
+ * @file snapshot.c
+ * @brief 窗口与相关器状态的快照实现 / Snapshot implementation for window and correlator state
+ *
+ * 布局：头部（魔数 "SQWS"、版本、种类、样本精度），随后是该种类的状态。窗口只保存其中的
+ * count 个样本（最旧在前）与写入位置，镜像副本在恢复时重建；样本按本构建的精度编码
+ * （double 为 f64，float 为 f32，Q15 为 u16），所以不同精度的快照会被拒绝。
+ * 恢复分两趟：第一趟只校验，第二趟才写入，失败时状态保持原样。
+ * Layout: a header (magic "SQWS", version, kind, sample precision) followed
+ * by the state of that kind. A window stores only its count samples, oldest
+ * first, and its write position; the mirror copies are rebuilt on restore.
+ * Samples are encoded in the precision of this build (f64 for double, f32
+ * for float, u16 for Q15), so a snapshot of another precision is refused.
+ * Restoring takes two passes: the first only validates and the second
+ * writes, so a failure leaves the state as it was.
+ */
+
+#include "snapshot.h"
+#include "snapio.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* 快照魔数 / snapshot magic */
+static const char snapshot_magic[4] = {'S', 'Q', 'W', 'S'};
+
+/* 快照种类 / snapshot kinds */
+#define SNAPSHOT_KIND_WINDOW 1u
+#define SNAPSHOT_KIND_MWINDOW 2u
+#define SNAPSHOT_KIND_CORR 3u
+#define SNAPSHOT_KIND_WINSTAT 4u
+
+/* 本构建的样本精度标记 / sample precision tag of this build */
+#if SEQ_SAMPLE_IS_FIXED
+#define SNAPSHOT_PRECISION 2u
+#elif SEQ_SAMPLE_IS_DOUBLE
+#define SNAPSHOT_PRECISION 0u
+#else
+#define SNAPSHOT_PRECISION 1u
+#endif
+
+/* 内部工具：按本构建的精度写一个样本 / write one sample in the precision of this build */
+static void snapshot_put_sample(snap_writer_t *w, seq_sample_t x)
+{
+#if SEQ_SAMPLE_IS_FIXED
+    snap_put_u16(w, (uint16_t)x);
+#elif SEQ_SAMPLE_IS_DOUBLE
+    snap_put_f64(w, x);
+#else
+    snap_put_f32(w, x);
+#endif
+}
+
+/* 内部工具：读一个样本 / read one sample */
+static seq_sample_t snapshot_get_sample(snap_reader_t *r)
+{
+#if SEQ_SAMPLE_IS_FIXED
+    return (seq_sample_t)snap_get_u16(r);
+#elif SEQ_SAMPLE_IS_DOUBLE
+    return snap_get_f64(r);
+#else
+    return snap_get_f32(r);
+#endif
+}
+
+/* 内部工具：写头部 / write the header */
+static void snapshot_put_header(snap_writer_t *w, uint32_t kind)
+{
+    snap_put_header(w, snapshot_magic, SNAPSHOT_VERSION);
+    snap_put_u32(w, kind);
+    snap_put_u32(w, SNAPSHOT_PRECISION);
+}
+
+/* 内部工具：写镜像窗口的状态 / write the state of a mirrored window */
+static void snapshot_put_mwindow(snap_writer_t *w, const seq_mwindow_t *mw)
+{
+    const seq_sample_t *data = seq_mwindow_data(mw);
+
+    snap_put_u64(w, mw->capacity);
+    snap_put_u64(w, mw->head);
+    snap_put_u64(w, mw->count);
+    for (size_t i = 0; i < mw->count; ++i)
+        snapshot_put_sample(w, data[i]);
+}
+
+/* 内部工具：读镜像窗口的状态，apply 为 0 时只校验 / read the state of a mirrored window, validating only when apply is 0 */
+static int snapshot_get_mwindow(snap_reader_t *r, seq_mwindow_t *mw, int apply)
+{
+    const uint64_t capacity = snap_get_u64(r);
+    const uint64_t head = snap_get_u64(r);
+    const uint64_t count = snap_get_u64(r);
+
+    if (r->fail || capacity != mw->capacity || head >= mw->size || count > capacity)
+        return -1;
+
+    for (size_t i = 0; i < (size_t)count; ++i)
+    {
+        const seq_sample_t x = snapshot_get_sample(r);
+        if (apply)
+        {
+            const size_t slot = (size_t)(head - count + i) & mw->mask;
+            mw->buf[slot] = x;
+            mw->buf[slot + mw->size] = x;
+        }
+    }
+    if (r->fail)
+        return -1;
+    if (apply)
+    {
+        mw->head = (size_t)head;
+        mw->count = (size_t)count;
+    }
+    return 0;
+}
+
+/* 内部工具：写滑动窗口的状态 / write the state of a sliding window */
+static void snapshot_put_window(snap_writer_t *w, const void *obj)
+{
+    const seq_window_t *sw = (const seq_window_t *)obj;
+
+    snapshot_put_header(w, SNAPSHOT_KIND_WINDOW);
+    snap_put_u64(w, sw->capacity);
+    snap_put_u64(w, sw->count);
+    for (size_t i = 0; i < sw->count; ++i)
+        snapshot_put_sample(w, seq_window_get(sw, i));
+}
+
+/* 内部工具：读滑动窗口的状态；恢复后起点归零，内容与顺序不变 /
+   read the state of a sliding window; the start is reset to 0, contents and order unchanged */
+static int snapshot_get_window(snap_reader_t *r, void *obj, int apply)
+{
+    seq_window_t *sw = (seq_window_t *)obj;
+    const uint64_t capacity = snap_get_u64(r);
+    const uint64_t count = snap_get_u64(r);
+
+    if (r->fail || capacity != sw->capacity || count > capacity)
+        return -1;
+
+    for (size_t i = 0; i < (size_t)count; ++i)
+    {
+        const seq_sample_t x = snapshot_get_sample(r);
+        if (apply)
+            sw->buf[i] = x;
+    }
+    if (r->fail)
+        return -1;
+    if (apply)
+    {
+        sw->start = 0;
+        sw->count = (size_t)count;
+    }
+    return 0;
+}
+
+/* 内部工具：写单个镜像窗口 / write a lone mirrored window */
+static void snapshot_put_mwindow_only(snap_writer_t *w, const void *obj)
+{
+    snapshot_put_header(w, SNAPSHOT_KIND_MWINDOW);
+    snapshot_put_mwindow(w, (const seq_mwindow_t *)obj);
+}
+
+/* 内部工具：读单个镜像窗口 / read a lone mirrored window */
+static int snapshot_get_mwindow_only(snap_reader_t *r, void *obj, int apply)
+{
+    return snapshot_get_mwindow(r, (seq_mwindow_t *)obj, apply);
+}
+
+/* 内部工具：写增量相关器 / write an incremental correlator */
+static void snapshot_put_corr(snap_writer_t *w, const void *obj)
+{
+    const seq_corr_stream_t *cs = (const seq_corr_stream_t *)obj;
+
+    snapshot_put_header(w, SNAPSHOT_KIND_CORR);
+    snap_put_u64(w, cs->resync_period);
+    snap_put_u64(w, cs->since_sync);
+    snap_put_f64(w, cs->mean_x);
+    snap_put_f64(w, cs->mean_y);
+    snap_put_f64(w, cs->m2x);
+    snap_put_f64(w, cs->m2y);
+    snap_put_f64(w, cs->cxy);
+    snapshot_put_mwindow(w, &cs->wa);
+    snapshot_put_mwindow(w, &cs->wb);
+}
+
+/* 内部工具：读增量相关器 / read an incremental correlator */
+static int snapshot_get_corr(snap_reader_t *r, void *obj, int apply)
+{
+    seq_corr_stream_t *cs = (seq_corr_stream_t *)obj;
+    const uint64_t resync_period = snap_get_u64(r);
+    const uint64_t since_sync = snap_get_u64(r);
+    const double mean_x = snap_get_f64(r);
+    const double mean_y = snap_get_f64(r);
+    const double m2x = snap_get_f64(r);
+    const double m2y = snap_get_f64(r);
+    const double cxy = snap_get_f64(r);
+
+    if (r->fail || resync_period != cs->resync_period || since_sync >= resync_period)
+        return -1;
+    if (snapshot_get_mwindow(r, &cs->wa, apply) != 0 || snapshot_get_mwindow(r, &cs->wb, apply) != 0)
+        return -1;
+    if (!apply)
+        return 0;
+
+    cs->since_sync = (size_t)since_sync;
+    cs->mean_x = mean_x;
+    cs->mean_y = mean_y;
+    cs->m2x = m2x;
+    cs->m2y = m2y;
+    cs->cxy = cxy;
+    return 0;
+}
+
+/* 内部工具：写单调队列，只写 head..tail 之间的绝对下标 / write a monotonic deque, only the absolute indices between head and tail */
+static void snapshot_put_deque(snap_writer_t *w, const size_t *q, size_t head, size_t tail, size_t mask)
+{
+    snap_put_u64(w, head);
+    snap_put_u64(w, tail);
+    for (size_t k = head; k != tail; ++k)
+        snap_put_u64(w, q[k & mask]);
+}
+
+/* 内部工具：读单调队列；下标须在窗口内，且按时间递增 /
+   read a monotonic deque; indices must lie in the window and increase */
+static int snapshot_get_deque(snap_reader_t *r, const seq_winstat_t *ws, uint64_t t, size_t *q,
+                              size_t *head_out, size_t *tail_out, int apply)
+{
+    const uint64_t head = snap_get_u64(r);
+    const uint64_t tail = snap_get_u64(r);
+    const size_t mask = ws->w.mask;
+    uint64_t prev = 0;
+
+    if (r->fail || tail - head > ws->w.size || (t > 0 && tail == head) || (t == 0 && tail != head))
+        return -1;
+
+    for (uint64_t k = head; k != tail; ++k)
+    {
+        const uint64_t j = snap_get_u64(r);
+        if (r->fail || j >= t || t - j > ws->w.capacity || (k != head && j <= prev))
+            return -1;
+        prev = j;
+        if (apply)
+            q[(size_t)k & mask] = (size_t)j;
+    }
+    if (apply)
+    {
+        *head_out = (size_t)head;
+        *tail_out = (size_t)tail;
+    }
+    return 0;
+}
+
+/* 内部工具：写窗口统计 / write window statistics */
+static void snapshot_put_winstat(snap_writer_t *w, const void *obj)
+{
+    const seq_winstat_t *ws = (const seq_winstat_t *)obj;
+
+    snapshot_put_header(w, SNAPSHOT_KIND_WINSTAT);
+    snap_put_u64(w, ws->resync_period);
+    snap_put_u64(w, ws->since_sync);
+    snap_put_u64(w, ws->t);
+    snap_put_f64(w, ws->mean);
+    snap_put_f64(w, ws->m2);
+    snapshot_put_mwindow(w, &ws->w);
+    snapshot_put_deque(w, ws->qmin, ws->qmin_head, ws->qmin_tail, ws->w.mask);
+    snapshot_put_deque(w, ws->qmax, ws->qmax_head, ws->qmax_tail, ws->w.mask);
+}
+
+/* 内部工具：读窗口统计；窗口写入位置须与已推入的样本数相符 /
+   read window statistics; the window write position must agree with the sample count */
+static int snapshot_get_winstat(snap_reader_t *r, void *obj, int apply)
+{
+    seq_winstat_t *ws = (seq_winstat_t *)obj;
+    const uint64_t resync_period = snap_get_u64(r);
+    const uint64_t since_sync = snap_get_u64(r);
+    const uint64_t t = snap_get_u64(r);
+    const double mean = snap_get_f64(r);
+    const double m2 = snap_get_f64(r);
+    const size_t pos = r->pos;
+
+    if (r->fail || resync_period != ws->resync_period || since_sync >= resync_period)
+        return -1;
+
+    /* 窗口的头部三项先行校验，与 t 对照 / check the window's leading fields against t first */
+    const uint64_t capacity = snap_get_u64(r);
+    const uint64_t head = snap_get_u64(r);
+    const uint64_t count = snap_get_u64(r);
+    if (r->fail || capacity != ws->w.capacity || head != (t & ws->w.mask) ||
+        count != ((t < capacity) ? t : capacity))
+        return -1;
+    r->pos = pos;
+
+    if (snapshot_get_mwindow(r, &ws->w, apply) != 0 ||
+        snapshot_get_deque(r, ws, t, ws->qmin, &ws->qmin_head, &ws->qmin_tail, apply) != 0 ||
+        snapshot_get_deque(r, ws, t, ws->qmax, &ws->qmax_head, &ws->qmax_tail, apply) != 0)
+        return -1;
+    if (!apply)
+        return 0;
+
+    ws->since_sync = (size_t)since_sync;
+    ws->t = (size_t)t;
+    ws->mean = mean;
+    ws->m2 = m2;
+    return 0;
+}
+
+/* 内部工具：快照大小 / snapshot size */
+static size_t snapshot_size(void (*put)(snap_writer_t *, const void *), const void *obj)
+{
+    snap_writer_t w;
+    size_t len = 0;
+
+    snap_writer_init(&w, NULL, 0);
+    put(&w, obj);
+    snap_writer_finish(&w, &len);
+    return len;
+}
+
+/* 内部工具：写快照 / write a snapshot */
+static int snapshot_write(const char *fn, void (*put)(snap_writer_t *, const void *), const void *obj,
+                          unsigned char *buf, size_t cap, size_t *len)
+{
+    snap_writer_t w;
+
+    if (buf == NULL || len == NULL)
+    {
+        fprintf(stderr, "%s: null pointer argument.\n", fn);
+        return -1;
+    }
+    snap_writer_init(&w, buf, cap);
+    put(&w, obj);
+    if (snap_writer_finish(&w, len) != 0)
+    {
+        fprintf(stderr, "%s: buffer too small (%zu bytes needed).\n", fn, *len);
+        return -1;
+    }
+    return 0;
+}
+
+/* 内部工具：两趟恢复，先校验再写入 / two-pass restore, validate then write */
+static int snapshot_read(const char *fn, uint32_t kind, int (*get)(snap_reader_t *, void *, int), void *obj,
+                         const unsigned char *buf, size_t len)
+{
+    for (int apply = 0; apply <= 1; ++apply)
+    {
+        snap_reader_t r;
+        uint32_t version = 0;
+
+        if (snap_reader_init(&r, buf, len) != 0 || snap_get_header(&r, snapshot_magic, &version) != 0)
+        {
+            fprintf(stderr, "%s: corrupt snapshot (checksum mismatch or truncated).\n", fn);
+            return -1;
+        }
+        if (version != SNAPSHOT_VERSION)
+        {
+            fprintf(stderr, "%s: unsupported snapshot version %u.\n", fn, (unsigned)version);
+            return -1;
+        }
+        if (snap_get_u32(&r) != kind)
+        {
+            fprintf(stderr, "%s: snapshot holds another kind of state.\n", fn);
+            return -1;
+        }
+        if (snap_get_u32(&r) != SNAPSHOT_PRECISION)
+        {
+            fprintf(stderr, "%s: snapshot was taken with another sample precision.\n", fn);
+            return -1;
+        }
+        if (get(&r, obj, apply) != 0 || !snap_reader_done(&r))
+        {
+            fprintf(stderr, "%s: snapshot does not match this state.\n", fn);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 滑动窗口的快照大小 / Snapshot size of a sliding window.
+ *
+ * @param w 已初始化的窗口 / Initialized window
+ * @return 字节数；窗口无效时为 0 / Byte count, 0 for an invalid window
+ */
+size_t seq_window_snapshot_size(const seq_window_t *w)
+{
+    if (w == NULL || w->buf == NULL)
+        return 0;
+    return snapshot_size(snapshot_put_window, w);
+}
+
+/**
+ * @brief 把滑动窗口写成快照 / Write a sliding window as a snapshot.
+ *
+ * @param w 已初始化的窗口 / Initialized window
+ * @param buf 快照缓冲 / Snapshot buffer
+ * @param cap 缓冲容量，至少 seq_window_snapshot_size(w) / Capacity, at least seq_window_snapshot_size(w)
+ * @param len 输出：快照字节数 / Out: snapshot bytes
+ * @return 0 表示成功；非 0 表示参数无效或缓冲不足。/ 0 on success; non-zero on invalid arguments or a short buffer.
+ */
+int seq_window_snapshot(const seq_window_t *w, unsigned char *buf, size_t cap, size_t *len)
+{
+    if (w == NULL || w->buf == NULL)
+    {
+        fprintf(stderr, "seq_window_snapshot: invalid window.\n");
+        return -1;
+    }
+    return snapshot_write("seq_window_snapshot", snapshot_put_window, w, buf, cap, len);
+}
+
+/**
+ * @brief 从快照恢复滑动窗口 / Restore a sliding window from a snapshot.
+ *
+ * @param w 以相同容量初始化的窗口 / Window initialized with the same capacity
+ * @param buf 快照 / Snapshot
+ * @param len 快照字节数 / Snapshot bytes
+ * @return 0 表示成功；快照损坏、版本或精度不同、与窗口不符时返回非 0，且不修改 w。
+ *         0 on success; non-zero, leaving w untouched, for a corrupt snapshot,
+ *         another version or precision, or one that does not match the window.
+ */
+int seq_window_restore(seq_window_t *w, const unsigned char *buf, size_t len)
+{
+    if (w == NULL || w->buf == NULL)
+    {
+        fprintf(stderr, "seq_window_restore: invalid window.\n");
+        return -1;
+    }
+    return snapshot_read("seq_window_restore", SNAPSHOT_KIND_WINDOW, snapshot_get_window, w, buf, len);
+}
+
+/**
+ * @brief 镜像窗口的快照大小 / Snapshot size of a mirrored window.
+ *
+ * @param w 已初始化的窗口 / Initialized window
+ * @return 字节数；窗口无效时为 0 / Byte count, 0 for an invalid window
+ */
+size_t seq_mwindow_snapshot_size(const seq_mwindow_t *w)
+{
+    if (w == NULL || w->buf == NULL)
+        return 0;
+    return snapshot_size(snapshot_put_mwindow_only, w);
+}
+
+/**
+ * @brief 把镜像窗口写成快照 / Write a mirrored window as a snapshot.
+ *
+ * @param w 已初始化的窗口 / Initialized window
+ * @param buf 快照缓冲 / Snapshot buffer
+ * @param cap 缓冲容量 / Capacity
+ * @param len 输出：快照字节数 / Out: snapshot bytes
+ * @return 0 表示成功；非 0 表示参数无效或缓冲不足。/ 0 on success; non-zero on invalid arguments or a short buffer.
+ */
+int seq_mwindow_snapshot(const seq_mwindow_t *w, unsigned char *buf, size_t cap, size_t *len)
+{
+    if (w == NULL || w->buf == NULL)
+    {
+        fprintf(stderr, "seq_mwindow_snapshot: invalid window.\n");
+        return -1;
+    }
+    return snapshot_write("seq_mwindow_snapshot", snapshot_put_mwindow_only, w, buf, cap, len);
+}
+
+/**
+ * @brief 从快照恢复镜像窗口 / Restore a mirrored window from a snapshot.
+ *
+ * @param w 以相同容量初始化的窗口 / Window initialized with the same capacity
+ * @param buf 快照 / Snapshot
+ * @param len 快照字节数 / Snapshot bytes
+ * @return 同 seq_window_restore() / As seq_window_restore()
+ */
+int seq_mwindow_restore(seq_mwindow_t *w, const unsigned char *buf, size_t len)
+{
+    if (w == NULL || w->buf == NULL)
+    {
+        fprintf(stderr, "seq_mwindow_restore: invalid window.\n");
+        return -1;
+    }
+    return snapshot_read("seq_mwindow_restore", SNAPSHOT_KIND_MWINDOW, snapshot_get_mwindow_only, w, buf, len);
+}
+
+/**
+ * @brief 增量相关器的快照大小 / Snapshot size of an incremental correlator.
+ *
+ * @param cs 已初始化的相关器 / Initialized correlator
+ * @return 字节数；相关器无效时为 0 / Byte count, 0 for an invalid correlator
+ */
+size_t seq_corr_stream_snapshot_size(const seq_corr_stream_t *cs)
+{
+    if (cs == NULL || cs->wa.buf == NULL || cs->wb.buf == NULL)
+        return 0;
+    return snapshot_size(snapshot_put_corr, cs);
+}
+
+/**
+ * @brief 把增量相关器写成快照 / Write an incremental correlator as a snapshot.
+ *
+ * @param cs 已初始化的相关器 / Initialized correlator
+ * @param buf 快照缓冲 / Snapshot buffer
+ * @param cap 缓冲容量 / Capacity
+ * @param len 输出：快照字节数 / Out: snapshot bytes
+ * @return 0 表示成功；非 0 表示参数无效或缓冲不足。/ 0 on success; non-zero on invalid arguments or a short buffer.
+ *
+ * @note 两个窗口与全部矩都按位保存，恢复后下一次重同步的时机也不变。
+ *       Both windows and every moment are kept bit for bit, so even the next
+ *       resync happens at the same push after a restore.
+ */
+int seq_corr_stream_snapshot(const seq_corr_stream_t *cs, unsigned char *buf, size_t cap, size_t *len)
+{
+    if (cs == NULL || cs->wa.buf == NULL || cs->wb.buf == NULL)
+    {
+        fprintf(stderr, "seq_corr_stream_snapshot: invalid correlator.\n");
+        return -1;
+    }
+    return snapshot_write("seq_corr_stream_snapshot", snapshot_put_corr, cs, buf, cap, len);
+}
+
+/**
+ * @brief 从快照恢复增量相关器 / Restore an incremental correlator from a snapshot.
+ *
+ * @param cs 以相同窗口长度与重同步周期初始化的相关器 / Correlator initialized with the same window length and resync period
+ * @param buf 快照 / Snapshot
+ * @param len 快照字节数 / Snapshot bytes
+ * @return 同 seq_window_restore() / As seq_window_restore()
+ */
+int seq_corr_stream_restore(seq_corr_stream_t *cs, const unsigned char *buf, size_t len)
+{
+    if (cs == NULL || cs->wa.buf == NULL || cs->wb.buf == NULL)
+    {
+        fprintf(stderr, "seq_corr_stream_restore: invalid correlator.\n");
+        return -1;
+    }
+    return snapshot_read("seq_corr_stream_restore", SNAPSHOT_KIND_CORR, snapshot_get_corr, cs, buf, len);
+}
+
+/**
+ * @brief 窗口统计的快照大小 / Snapshot size of window statistics.
+ *
+ * @param ws 已初始化的统计器 / Initialized statistics
+ * @return 字节数；统计器无效时为 0 / Byte count, 0 for invalid statistics
+ */
+size_t seq_winstat_snapshot_size(const seq_winstat_t *ws)
+{
+    if (ws == NULL || ws->w.buf == NULL)
+        return 0;
+    return snapshot_size(snapshot_put_winstat, ws);
+}
+
+/**
+ * @brief 把窗口统计写成快照 / Write window statistics as a snapshot.
+ *
+ * @param ws 已初始化的统计器 / Initialized statistics
+ * @param buf 快照缓冲 / Snapshot buffer
+ * @param cap 缓冲容量 / Capacity
+ * @param len 输出：快照字节数 / Out: snapshot bytes
+ * @return 0 表示成功；非 0 表示参数无效或缓冲不足。/ 0 on success; non-zero on invalid arguments or a short buffer.
+ *
+ * @note 已推入的样本数 t 一并保存，可作为恢复后接续输入的位置。
+ *       The pushed-sample count t is saved too and gives the input position to resume from.
+ */
+int seq_winstat_snapshot(const seq_winstat_t *ws, unsigned char *buf, size_t cap, size_t *len)
+{
+    if (ws == NULL || ws->w.buf == NULL)
+    {
+        fprintf(stderr, "seq_winstat_snapshot: invalid statistics.\n");
+        return -1;
+    }
+    return snapshot_write("seq_winstat_snapshot", snapshot_put_winstat, ws, buf, cap, len);
+}
+
+/**
+ * @brief 从快照恢复窗口统计 / Restore window statistics from a snapshot.
+ *
+ * @param ws 以相同窗口长度与重同步周期初始化的统计器 / Statistics initialized with the same window length and resync period
+ * @param buf 快照 / Snapshot
+ * @param len 快照字节数 / Snapshot bytes
+ * @return 同 seq_window_restore() / As seq_window_restore()
+ */
+int seq_winstat_restore(seq_winstat_t *ws, const unsigned char *buf, size_t len)
+{
+    if (ws == NULL || ws->w.buf == NULL)
+    {
+        fprintf(stderr, "seq_winstat_restore: invalid statistics.\n");
+        return -1;
+    }
+    return snapshot_read("seq_winstat_restore", SNAPSHOT_KIND_WINSTAT, snapshot_get_winstat, ws, buf, len);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file stats.c
+ * @brief 逐运算计数与计时实现 / Per-operation counters and timers implementation
+ *
+ * @note 计数器为全局状态，不加锁。并行运算只在调用线程记录一次，
+ *       因此只要从一个线程调用运算接口即可。
+ *       Counters are unlocked global state. Parallel operations record once
+ *       on the calling thread, so it is enough to call the operations from
+ *       a single thread.
+ */
+
+#include "stats.h"
+
+#include <time.h>
+
+/* 运行时开关 / run-time switch */
+static int stats_on = 0;
+
+/* 各项累计值 / accumulated entries */
+static stats_entry_t stats_entries[STATS_COUNT];
+
+/* 事件回调 / event hook */
+static stats_hook_fn stats_hook = NULL;
+static void *stats_hook_ctx = NULL;
+
+/* 统计项名，与 CLI 模式名一致 / entry names, matching the CLI modes */
+static const char *const stats_names[STATS_COUNT] = {
+    "add", "mul", "conv-linear", "conv-circular", "corr-cross",
+    "corr-window", "corr-stream", "win-stats", "detect", "expr", "io/parse", "io/format", "alloc"};
+
+/* 内部工具：当前时间（纳秒）/ current time in ns */
+static uint64_t stats_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 开启或关闭记录 / Turn recording on or off.
+ *
+ * @param on 非 0 开启 / Non-zero to turn on
+ * @return 0 表示成功；以 SEQ_NO_STATS 编译时开启返回非 0。
+ *         0 on success; non-zero when turning on in a SEQ_NO_STATS build.
+ */
+int stats_enable(int on)
+{
+#ifdef SEQ_NO_STATS
+    if (on)
+    {
+        fprintf(stderr, "stats_enable: statistics were compiled out (SEQ_NO_STATS).\n");
+        return -1;
+    }
+#endif
+    stats_on = on ? 1 : 0;
+    return 0;
+}
+
+/**
+ * @brief 是否正在记录 / Whether recording is on.
+ *
+ * @return 非 0 表示开启 / Non-zero if on
+ */
+int stats_enabled(void)
+{
+    return stats_on;
+}
+
+/**
+ * @brief 清零全部统计 / Clear every entry.
+ */
+void stats_reset(void)
+{
+    for (size_t i = 0; i < STATS_COUNT; ++i)
+        stats_entries[i] = (stats_entry_t){0};
+}
+
+/**
+ * @brief 注册事件回调 / Register the event hook.
+ *
+ * @param hook 回调，NULL 取消 / Hook, NULL to remove it
+ * @param ctx 回调上下文 / Hook context
+ *
+ * @note 回调在记录线程上同步执行，应尽量轻量。
+ *       The hook runs synchronously on the recording thread and should stay cheap.
+ */
+void stats_set_hook(stats_hook_fn hook, void *ctx)
+{
+    stats_hook = hook;
+    stats_hook_ctx = ctx;
+}
+
+/**
+ * @brief 遍历非空统计项，用于导出到外部监控 / Visit non-empty entries, e.g. to export them.
+ *
+ * @param visit 遍历回调 / Visitor
+ * @param ctx 回调上下文 / Visitor context
+ */
+void stats_visit(stats_visit_fn visit, void *ctx)
+{
+    if (visit == NULL)
+        return;
+    for (size_t i = 0; i < STATS_COUNT; ++i)
+    {
+        if (stats_entries[i].calls != 0)
+            visit(ctx, stats_names[i], &stats_entries[i]);
+    }
+}
+
+/* 内部工具：stats_dump 的遍历回调 / visitor behind stats_dump */
+static void stats_dump_row(void *ctx, const char *name, const stats_entry_t *e)
+{
+    uint64_t n = (e->samples_in > e->samples_out) ? e->samples_in : e->samples_out;
+    fprintf((FILE *)ctx, "[stats] %-14s %10llu %12llu %12llu %12llu %11.3f %10.2f\n", name,
+            (unsigned long long)e->calls, (unsigned long long)e->samples_in,
+            (unsigned long long)e->samples_out, (unsigned long long)e->bytes,
+            (double)e->ns / 1e6, (n != 0) ? (double)e->ns / (double)n : 0.0);
+}
+
+/**
+ * @brief 以表格输出非空统计项 / Print non-empty entries as a table.
+ *
+ * @param fp 输出流 / Output stream
+ *
+ * @note 每行一项：调用次数、输入输出样本数、分配字节、总毫秒和每样本纳秒
+ *       （按输入输出中较大者计）。
+ *       One row per entry: calls, input and output samples, bytes allocated,
+ *       total milliseconds and nanoseconds per sample (of the larger of input
+ *       and output).
+ */
+void stats_dump(FILE *fp)
+{
+    if (fp == NULL)
+        return;
+    fprintf(fp, "[stats] %-14s %10s %12s %12s %12s %11s %10s\n", "entry", "calls",
+            "samples_in", "samples_out", "bytes", "ms", "ns/sample");
+    stats_visit(stats_dump_row, fp);
+}
+
+/**
+ * @brief 记录点内部使用：开始计时 / Record-point helper: start timing.
+ *
+ * @return 当前时间（纳秒）；未开启时为 0 / Current time in ns; 0 when off
+ */
+uint64_t stats_start(void)
+{
+    return stats_on ? stats_now_ns() : 0;
+}
+
+/**
+ * @brief 记录点内部使用：记录一次调用 / Record-point helper: record one call.
+ *
+ * @param id 统计项 / Entry
+ * @param t0 stats_start() 的返回值 / Value returned by stats_start()
+ * @param n_in 输入样本数 / Input samples
+ * @param n_out 输出样本数 / Output samples
+ * @param bytes 分配字节数 / Bytes allocated
+ */
+void stats_record(stats_id_t id, uint64_t t0, size_t n_in, size_t n_out, size_t bytes)
+{
+    if (!stats_on || (size_t)id >= STATS_COUNT)
+        return;
+
+    stats_entry_t d;
+    d.calls = 1;
+    d.samples_in = n_in;
+    d.samples_out = n_out;
+    d.bytes = bytes;
+    d.ns = (t0 != 0) ? stats_now_ns() - t0 : 0;
+
+    stats_entry_t *e = &stats_entries[id];
+    e->calls += d.calls;
+    e->samples_in += d.samples_in;
+    e->samples_out += d.samples_out;
+    e->bytes += d.bytes;
+    e->ns += d.ns;
+
+    if (stats_hook != NULL)
+        stats_hook(stats_hook_ctx, stats_names[id], &d);
+}
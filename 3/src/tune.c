@@ -0,0 +1,535 @@
+/**
+ * @file tune.c
+ * @brief 内核调优与分发表实现 / Kernel tuning and dispatch table implementation
+ *
+ * 校准时依次装入“全部为某一路径”的表并计时公开接口本身，所以测到的正是调用时会走的代码，
+ * 包括校验、暂存与线程池开销。缓存文件由 ../common/snapio.h 编码，带版本与校验。
+ * Calibration installs a table forcing one path everywhere and times the
+ * public entry points themselves, so it measures exactly the code a call
+ * will run, checks, scratch and pool overhead included. The cache file is
+ * encoded with ../common/snapio.h, versioned and checksummed.
+ */
+
+#include "tune.h"
+#include "ops.h"
+#include "sample.h"
+#include "simd.h"
+#include "snapio.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* 缓存文件魔数 / cache file magic */
+static const char tune_magic[4] = {'S', 'Q', 'T', 'N'};
+
+/* 每批计时的最短时长（纳秒）/ shortest timed batch in ns */
+#define TUNE_BATCH_NS 1000000u
+
+/* 每个候选计时的批数，取最快一批 / timed batches per candidate, the fastest one counts */
+#define TUNE_BATCHES 3
+
+/* 直接求和慢于最快路径这么多倍后，同一行更长的档不再计时直接求和 /
+   once direct sums are this many times slower than the best, longer classes of the row skip them */
+#define TUNE_PRUNE 4.0
+
+/* 更“重”的路径须至少快这么多才被选中，避免噪声在交叉点附近来回切换 /
+   a heavier path must be at least this much faster to be chosen, so noise does not flip crossovers */
+#define TUNE_MARGIN 1.05
+
+/* 本构建的样本精度标记 / sample precision tag of this build */
+#if SEQ_SAMPLE_IS_FIXED
+#define TUNE_PRECISION 2u
+#elif SEQ_SAMPLE_IS_DOUBLE
+#define TUNE_PRECISION 0u
+#else
+#define TUNE_PRECISION 1u
+#endif
+
+/* 当前装入的分发表 / installed dispatch table */
+static tune_table_t tune_active;
+static int tune_active_on = 0;
+
+/* 校准的测试数据 / calibration operands */
+typedef struct
+{
+    seq_sample_t *a;   /**< 长序列 / long operand */
+    seq_sample_t *b;   /**< 短序列 / short operand */
+    seq_sample_t *out; /**< 输出 / output */
+    ops_ctx_t ctx;     /**< 暂存 / scratch */
+} tune_bench_t;
+
+/* 内部工具：当前时间（纳秒）/ current time in ns */
+static uint64_t tune_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* 内部工具：长度分档 floor(log2 n)，n 为 0 时记为 0 / length class floor(log2 n), 0 for n = 0 */
+static uint32_t tune_class(size_t n)
+{
+    uint32_t c = 0;
+    while (n > 1)
+    {
+        n >>= 1;
+        ++c;
+    }
+    return c;
+}
+
+/* 内部工具：一档的代表长度 3·2^(c-1)，c = 0 时为 1 / representative length 3·2^(c-1) of class c, 1 for c = 0 */
+static size_t tune_rep(uint32_t c)
+{
+    return (c == 0) ? 1 : (size_t)3 << (c - 1);
+}
+
+/* 内部工具：按本机与本构建填写表头 / fill the header for this host and build */
+static void tune_header(tune_table_t *t)
+{
+    t->precision = TUNE_PRECISION;
+    t->accum_bytes = (uint32_t)sizeof(seq_accum_t);
+    t->isa = (uint32_t)simd_get_isa();
+    t->threads = ops_get_threads();
+}
+
+/* 内部工具：装入处处为 path 的表 / install a table forcing path everywhere */
+static void tune_force(tune_path_t path)
+{
+    memset(tune_active.path, (int)path, sizeof(tune_active.path));
+    tune_active.max_class = TUNE_CLASSES - 1;
+    tune_active_on = 1;
+}
+
+/* 内部工具：以 la、lb 长度的操作数执行一次 op / run op once on operands of lengths la and lb */
+static int tune_run(tune_op_t op, tune_bench_t *bn, size_t la, size_t lb)
+{
+    seq_t a = {bn->a, la};
+    seq_t b = {bn->b, lb};
+    size_t n = 0;
+
+    if (op == TUNE_OP_CONV_LINEAR)
+        return seq_conv_linear_into(&bn->ctx, &a, &b, bn->out, la + lb - 1, &n);
+    if (op == TUNE_OP_CONV_CIRCULAR)
+        return seq_conv_circular_into(&bn->ctx, &a, &b, bn->out, la, &n);
+    return seq_corr_cross_into(&a, &b, bn->out, la + lb - 1, &n);
+}
+
+/* 内部工具：强制 path 时每次调用的最短耗时（纳秒），失败为负 /
+   fastest time per call in ns with path forced, negative on failure */
+static double tune_time(tune_op_t op, tune_path_t path, tune_bench_t *bn, size_t la, size_t lb)
+{
+    double best = -1.0;
+
+    tune_force(path);
+    for (int k = 0; k < TUNE_BATCHES; ++k)
+    {
+        const uint64_t t0 = tune_now_ns();
+        uint64_t elapsed = 0;
+        size_t reps = 0;
+        do
+        {
+            if (tune_run(op, bn, la, lb) != 0)
+                return -1.0;
+            ++reps;
+            elapsed = tune_now_ns() - t0;
+        } while (elapsed < TUNE_BATCH_NS);
+
+        const double per = (double)elapsed / (double)reps;
+        if (best < 0.0 || per < best)
+            best = per;
+    }
+    return best;
+}
+
+/* 内部工具：为一档挑选最快路径；*direct_lost 为真时不再计时直接求和 /
+   pick the fastest path of one cell; timing of direct sums is skipped once *direct_lost is set */
+static int tune_cell(tune_op_t op, tune_bench_t *bn, size_t la, size_t lb, int *direct_lost, unsigned char *out)
+{
+    const int threaded = ops_get_threads() > 1;
+    double t_direct = -1.0, t_threaded = -1.0;
+
+    double t_fft = tune_time(op, TUNE_PATH_FFT, bn, la, lb);
+    if (t_fft < 0.0)
+        return -1;
+    if (!*direct_lost)
+    {
+        t_direct = tune_time(op, TUNE_PATH_DIRECT, bn, la, lb);
+        if (t_direct < 0.0)
+            return -1;
+        if (threaded)
+        {
+            t_threaded = tune_time(op, TUNE_PATH_THREADED, bn, la, lb);
+            if (t_threaded < 0.0)
+                return -1;
+        }
+    }
+
+    /* 按 直接 → 多线程 → FFT 的顺序，后者须快出 TUNE_MARGIN 才替换 /
+       in the order direct, threaded, FFT, a later path must win by TUNE_MARGIN */
+    tune_path_t path = TUNE_PATH_FFT;
+    double best = t_fft;
+    if (t_direct >= 0.0)
+    {
+        path = TUNE_PATH_DIRECT;
+        best = t_direct;
+        if (t_threaded >= 0.0 && t_threaded * TUNE_MARGIN < best)
+        {
+            path = TUNE_PATH_THREADED;
+            best = t_threaded;
+        }
+        if (t_fft * TUNE_MARGIN < best)
+        {
+            path = TUNE_PATH_FFT;
+            best = t_fft;
+        }
+        if (t_direct > TUNE_PRUNE * best && (t_threaded < 0.0 || t_threaded > TUNE_PRUNE * best))
+            *direct_lost = 1;
+    }
+    *out = (unsigned char)path;
+    return 0;
+}
+
+/**
+ * @brief 在本机上校准分发表 / Calibrate a dispatch table on this host.
+ *
+ * @param t 输出的分发表 / Output table
+ * @param max_len 校准的最大长度，0 表示 TUNE_MAX_LEN_DEFAULT / Largest length calibrated, 0 for TUNE_MAX_LEN_DEFAULT
+ * @param log 进度输出，可为 NULL / Progress output, may be NULL
+ * @return 0 表示成功；非 0 表示内存不足或运算失败。/ 0 on success; non-zero on allocation or operation failure.
+ *
+ * @note 以当前的线程数（ops_set_threads()）与指令集（simd_set_isa()）计时，并记入表头。
+ *       每档以长度 3·2^(c-1) 代表，线性卷积与互相关取 La = max、Lb = min。
+ *       校准期间装入的表会被替换，结束时恢复原状；不要与其他线程上的运算并发。
+ *       Timed with the current thread count (ops_set_threads()) and ISA
+ *       (simd_set_isa()), which go into the header. Each class is represented
+ *       by the length 3·2^(c-1); linear convolution and cross-correlation use
+ *       La = max, Lb = min. The installed table is replaced while calibrating
+ *       and put back at the end; do not run operations on other threads meanwhile.
+ */
+int tune_calibrate(tune_table_t *t, size_t max_len, FILE *log)
+{
+    if (t == NULL)
+    {
+        fprintf(stderr, "tune_calibrate: null pointer argument.\n");
+        return -1;
+    }
+
+    uint32_t top = tune_class((max_len > 0) ? max_len : TUNE_MAX_LEN_DEFAULT);
+    if (top > TUNE_CLASSES - 1)
+        top = TUNE_CLASSES - 1;
+    const size_t len = tune_rep(top);
+
+    tune_bench_t bn;
+    memset(&bn, 0, sizeof(bn));
+    bn.a = (seq_sample_t *)malloc(len * sizeof(seq_sample_t));
+    bn.b = (seq_sample_t *)malloc(len * sizeof(seq_sample_t));
+    bn.out = (seq_sample_t *)malloc(2 * len * sizeof(seq_sample_t));
+    if (bn.a == NULL || bn.b == NULL || bn.out == NULL || ops_ctx_init(&bn.ctx, 0) != 0)
+    {
+        fprintf(stderr, "tune_calibrate: failed to allocate %zu-sample operands.\n", len);
+        free(bn.a);
+        free(bn.b);
+        free(bn.out);
+        return -1;
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        bn.a[i] = seq_sample_from_double(0.5 * ((double)((i * 7919) % 2001) / 2000.0 - 0.5));
+        bn.b[i] = seq_sample_from_double(0.5 * ((double)((i * 104729) % 1999) / 1998.0 - 0.5));
+    }
+
+    const tune_table_t saved = tune_active;
+    const int saved_on = tune_active_on;
+    static const char *const names[TUNE_OP_COUNT] = {"conv-linear", "conv-circular", "corr"};
+    int rc = 0;
+
+    memset(t, 0, sizeof(*t));
+    tune_header(t);
+    t->max_class = top;
+
+    for (int op = 0; op < TUNE_OP_COUNT && rc == 0; ++op)
+    {
+        const uint64_t t0 = tune_now_ns();
+        if (op == TUNE_OP_CONV_CIRCULAR)
+        {
+            int lost = 0;
+            for (uint32_t c = 0; c <= top && rc == 0; ++c)
+                rc = tune_cell((tune_op_t)op, &bn, tune_rep(c), tune_rep(c), &lost, &t->path[op][c][c]);
+        }
+        else
+        {
+            for (uint32_t cmax = 0; cmax <= top && rc == 0; ++cmax)
+            {
+                int lost = 0;
+                for (uint32_t cmin = 0; cmin <= cmax && rc == 0; ++cmin)
+                    rc = tune_cell((tune_op_t)op, &bn, tune_rep(cmax), tune_rep(cmin), &lost,
+                                   &t->path[op][cmin][cmax]);
+            }
+        }
+        if (log != NULL && rc == 0)
+            fprintf(log, "tune: %s calibrated up to length class 2^%u in %.2f s\n", names[op], (unsigned)top,
+                    (double)(tune_now_ns() - t0) * 1e-9);
+    }
+
+    tune_active = saved;
+    tune_active_on = saved_on;
+    ops_ctx_free(&bn.ctx);
+    free(bn.a);
+    free(bn.b);
+    free(bn.out);
+    if (rc != 0)
+        fprintf(stderr, "tune_calibrate: a kernel failed during calibration.\n");
+    return rc;
+}
+
+/* 内部工具：写出缓存文件内容 / write the cache file body */
+static void tune_put(snap_writer_t *w, const tune_table_t *t)
+{
+    snap_put_header(w, tune_magic, TUNE_VERSION);
+    snap_put_u32(w, t->precision);
+    snap_put_u32(w, t->accum_bytes);
+    snap_put_u32(w, t->isa);
+    snap_put_u64(w, t->threads);
+    snap_put_u32(w, t->max_class);
+    for (int op = 0; op < TUNE_OP_COUNT; ++op)
+        for (uint32_t cmax = 0; cmax <= t->max_class; ++cmax)
+            for (uint32_t cmin = 0; cmin <= cmax; ++cmin)
+                snap_put_u16(w, t->path[op][cmin][cmax]);
+}
+
+/**
+ * @brief 把分发表写入缓存文件 / Save a dispatch table to a cache file.
+ *
+ * @param t 分发表 / Table
+ * @param path 文件路径，先写临时文件再改名 / File path, written via a temporary file and a rename
+ * @return 0 表示成功；非 0 表示失败。/ 0 on success; non-zero on failure.
+ */
+int tune_save(const tune_table_t *t, const char *path)
+{
+    snap_writer_t w;
+    size_t len = 0;
+
+    if (t == NULL || path == NULL || t->max_class >= TUNE_CLASSES)
+    {
+        fprintf(stderr, "tune_save: invalid arguments.\n");
+        return -1;
+    }
+
+    /* 先计数再写入 / count first, then write */
+    snap_writer_init(&w, NULL, 0);
+    tune_put(&w, t);
+    snap_writer_finish(&w, &len);
+
+    unsigned char *buf = (unsigned char *)malloc(len);
+    if (buf == NULL)
+    {
+        fprintf(stderr, "tune_save: out of memory.\n");
+        return -1;
+    }
+    snap_writer_init(&w, buf, len);
+    tune_put(&w, t);
+    int rc = snap_writer_finish(&w, &len);
+    if (rc == 0)
+        rc = snap_file_write(path, buf, len);
+    free(buf);
+    return rc;
+}
+
+/**
+ * @brief 从缓存文件载入分发表 / Load a dispatch table from a cache file.
+ *
+ * @param t 输出的分发表 / Output table
+ * @param path 文件路径 / File path
+ * @return 0 表示成功；文件缺失、损坏或版本不同时返回非 0。
+ *         0 on success; non-zero for a missing or corrupt file or another version.
+ *
+ * @note 只检查文件本身；是否适用于本机与本构建由 tune_check() 判断。
+ *       Only the file itself is checked; tune_check() decides whether it fits this host and build.
+ */
+int tune_load(tune_table_t *t, const char *path)
+{
+    if (t == NULL || path == NULL)
+    {
+        fprintf(stderr, "tune_load: null pointer argument.\n");
+        return -1;
+    }
+
+    unsigned char *buf = NULL;
+    size_t len = 0;
+    if (snap_file_read(path, &buf, &len) != 0)
+        return -1;
+
+    snap_reader_t r;
+    uint32_t version = 0;
+    int rc = -1;
+    memset(t, 0, sizeof(*t));
+    if (snap_reader_init(&r, buf, len) != 0 || snap_get_header(&r, tune_magic, &version) != 0)
+    {
+        fprintf(stderr, "tune_load: '%s' is not a tuning cache or is damaged.\n", path);
+    }
+    else if (version != TUNE_VERSION)
+    {
+        fprintf(stderr, "tune_load: unsupported cache version %u.\n", (unsigned)version);
+    }
+    else
+    {
+        t->precision = snap_get_u32(&r);
+        t->accum_bytes = snap_get_u32(&r);
+        t->isa = snap_get_u32(&r);
+        t->threads = snap_get_u64(&r);
+        t->max_class = snap_get_u32(&r);
+        rc = (r.fail || t->max_class >= TUNE_CLASSES) ? -1 : 0;
+        for (int op = 0; op < TUNE_OP_COUNT && rc == 0; ++op)
+            for (uint32_t cmax = 0; cmax <= t->max_class && rc == 0; ++cmax)
+                for (uint32_t cmin = 0; cmin <= cmax && rc == 0; ++cmin)
+                {
+                    const uint16_t p = snap_get_u16(&r);
+                    if (p >= TUNE_PATH_COUNT)
+                        rc = -1;
+                    t->path[op][cmin][cmax] = (unsigned char)p;
+                }
+        if (rc != 0 || !snap_reader_done(&r))
+        {
+            fprintf(stderr, "tune_load: malformed table in '%s'.\n", path);
+            rc = -1;
+        }
+    }
+    free(buf);
+    return rc;
+}
+
+/**
+ * @brief 检查分发表是否适用于本机与本构建 / Check that a table fits this host and build.
+ *
+ * @param t 分发表 / Table
+ * @return 0 表示适用；非 0 表示精度、累加器、指令集或线程数不同（原因写到 stderr）。
+ *         0 if it fits; non-zero if the precision, accumulator, ISA or thread count differs (reason on stderr).
+ */
+int tune_check(const tune_table_t *t)
+{
+    tune_table_t here;
+
+    if (t == NULL)
+    {
+        fprintf(stderr, "tune_check: null pointer argument.\n");
+        return -1;
+    }
+    tune_header(&here);
+    if (t->precision != here.precision || t->accum_bytes != here.accum_bytes)
+    {
+        fprintf(stderr, "tune_check: table was calibrated for another sample precision (this build: %s).\n",
+                SEQ_PRECISION_NAME);
+        return -1;
+    }
+    if (t->isa != here.isa)
+    {
+        fprintf(stderr, "tune_check: table was calibrated with another SIMD kernel set (now %s).\n",
+                simd_isa_name(simd_get_isa()));
+        return -1;
+    }
+    if (t->threads != here.threads)
+    {
+        fprintf(stderr, "tune_check: table was calibrated with %llu threads, now %llu.\n",
+                (unsigned long long)t->threads, (unsigned long long)here.threads);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 装入分发表，之后的调用按表选择路径 / Install a table; later calls pick their paths from it.
+ *
+ * @param t 分发表（复制一份）；NULL 表示卸下，回到内置规则 / Table (copied); NULL uninstalls and restores the built-in rules
+ *
+ * @note 与 ops_set_fft_threshold() 相同，应在运算开始前调用，不要与其他线程上的运算并发。
+ *       Like ops_set_fft_threshold(), call it before operations start, never
+ *       concurrently with operations on other threads.
+ */
+void tune_install(const tune_table_t *t)
+{
+    if (t == NULL)
+    {
+        tune_active_on = 0;
+        return;
+    }
+    tune_active = *t;
+    if (tune_active.max_class >= TUNE_CLASSES)
+        tune_active.max_class = TUNE_CLASSES - 1;
+    tune_active_on = 1;
+}
+
+/**
+ * @brief 查表得到一次调用的路径 / Look up the path of one call.
+ *
+ * @param op 运算 / Operation
+ * @param lmin 较短输入的长度（圆周卷积为 N）/ Shorter input length (N for circular convolution)
+ * @param lmax 较长输入的长度（圆周卷积为 N）/ Longer input length (N for circular convolution)
+ * @return 路径；未装表时为 TUNE_PATH_AUTO / Path; TUNE_PATH_AUTO when no table is installed
+ */
+tune_path_t tune_path(tune_op_t op, size_t lmin, size_t lmax)
+{
+    if (!tune_active_on || (unsigned)op >= TUNE_OP_COUNT)
+        return TUNE_PATH_AUTO;
+
+    uint32_t cmin = tune_class(lmin);
+    uint32_t cmax = tune_class(lmax);
+    if (cmax > tune_active.max_class)
+        cmax = tune_active.max_class;
+    if (cmin > cmax)
+        cmin = cmax;
+    return (tune_path_t)tune_active.path[op][cmin][cmax];
+}
+
+/**
+ * @brief 路径名 / Path name.
+ *
+ * @param path 路径 / Path
+ * @return "auto"、"direct"、"threaded" 或 "fft" / "auto", "direct", "threaded" or "fft"
+ */
+const char *tune_path_name(tune_path_t path)
+{
+    static const char *const names[TUNE_PATH_COUNT] = {"auto", "direct", "threaded", "fft"};
+    return ((unsigned)path < TUNE_PATH_COUNT) ? names[path] : "unknown";
+}
+
+/**
+ * @brief 以文本打印分发表 / Print a dispatch table as text.
+ *
+ * @param t 分发表 / Table
+ * @param fp 输出 / Output
+ *
+ * @note 每个运算一块：行为较长输入的分档，列为较短输入的分档，
+ *       D 直接、T 多线程、F FFT、. 内置规则。
+ *       One block per operation: rows are the longer input's class and columns
+ *       the shorter one's; D direct, T threaded, F FFT, . built-in rules.
+ */
+void tune_print(const tune_table_t *t, FILE *fp)
+{
+    static const char *const names[TUNE_OP_COUNT] = {"conv-linear", "conv-circular", "corr"};
+    static const char marks[TUNE_PATH_COUNT] = {'.', 'D', 'T', 'F'};
+
+    if (t == NULL || fp == NULL)
+        return;
+
+    fprintf(fp, "precision %s, simd %s, threads %llu\n", SEQ_PRECISION_NAME,
+            simd_isa_name((simd_isa_t)t->isa), (unsigned long long)t->threads);
+    for (int op = 0; op < TUNE_OP_COUNT; ++op)
+    {
+        fprintf(fp, "%s (rows: longer length >= 2^c, columns: shorter length class 0..c)\n", names[op]);
+        for (uint32_t cmax = 0; cmax <= t->max_class && cmax < TUNE_CLASSES; ++cmax)
+        {
+            fprintf(fp, "  2^%-2u ", (unsigned)cmax);
+            for (uint32_t cmin = 0; cmin <= cmax; ++cmin)
+            {
+                const unsigned p = t->path[op][cmin][cmax];
+                if (op == TUNE_OP_CONV_CIRCULAR && cmin != cmax)
+                    fputc(' ', fp);
+                else
+                    fputc((p < TUNE_PATH_COUNT) ? marks[p] : '?', fp);
+            }
+            fputc('\n', fp);
+        }
+    }
+}
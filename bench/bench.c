@@ -0,0 +1,404 @@
+/**
+ * @file bench.c
+ * @brief 微基准测试框架实现 / Microbenchmark harness implementation
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ===================== 分配计数 / Allocation counting ===================== */
+
+#ifdef BENCH_COUNT_ALLOCS
+#include <stdatomic.h>
+
+/* 链接时以 -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc 把库中的调用重定向到这里；
+ * 线程池的工作线程也会分配，故用原子计数。
+ * Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so library calls
+ * land here; pool workers allocate too, hence the atomics. */
+static atomic_size_t bench_alloc_count;
+static atomic_size_t bench_alloc_bytes;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t count, size_t n);
+void *__real_realloc(void *p, size_t n);
+void *__wrap_malloc(size_t n);
+void *__wrap_calloc(size_t count, size_t n);
+void *__wrap_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n)
+{
+    atomic_fetch_add_explicit(&bench_alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bench_alloc_bytes, n, memory_order_relaxed);
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t count, size_t n)
+{
+    atomic_fetch_add_explicit(&bench_alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bench_alloc_bytes, count * n, memory_order_relaxed);
+    return __real_calloc(count, n);
+}
+
+void *__wrap_realloc(void *p, size_t n)
+{
+    atomic_fetch_add_explicit(&bench_alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bench_alloc_bytes, n, memory_order_relaxed);
+    return __real_realloc(p, n);
+}
+
+static void bench_alloc_snapshot(size_t *count, size_t *bytes)
+{
+    *count = atomic_load_explicit(&bench_alloc_count, memory_order_relaxed);
+    *bytes = atomic_load_explicit(&bench_alloc_bytes, memory_order_relaxed);
+}
+#define BENCH_ALLOCS_COUNTED 1
+#else
+static void bench_alloc_snapshot(size_t *count, size_t *bytes)
+{
+    *count = 0;
+    *bytes = 0;
+}
+#define BENCH_ALLOCS_COUNTED 0
+#endif
+
+/* ===================== 计时 / Timing ===================== */
+
+/* 内部工具：当前时间（纳秒）/ internal helper: current time in ns */
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* 内部工具：连续调用 iters 次并返回耗时（纳秒），失败返回 < 0
+ * internal helper: call fn iters times and return the elapsed ns, < 0 on failure */
+static double bench_time(bench_fn fn, void *ctx, size_t iters)
+{
+    double t0 = bench_now_ns();
+    for (size_t i = 0; i < iters; ++i)
+    {
+        if (fn(ctx) != 0)
+            return -1.0;
+    }
+    return bench_now_ns() - t0;
+}
+
+/* 内部工具：表格输出流；JSON 写往 stdout 时改用 stderr
+ * internal helper: stream for the table; stderr when the JSON goes to stdout */
+static FILE *bench_table(const bench_suite_t *s)
+{
+    return (s->json_path != NULL && strcmp(s->json_path, "-") == 0) ? stderr : stdout;
+}
+
+/* ===================== 命令行 / Command line ===================== */
+
+static void bench_usage(const char *suite)
+{
+    fprintf(stderr,
+            "Usage: %s_bench [options]\n"
+            "  --sizes=N,N,...   problem sizes (default " BENCH_SIZES_DEFAULT ")\n"
+            "  --min-ms=T        minimum timed milliseconds per benchmark (default %.0f)\n"
+            "  --filter=S        only run benchmarks whose name contains S\n"
+            "  --json=PATH       write results as JSON (\"-\" for stdout)\n"
+            "  --baseline=PATH   compare against a JSON baseline; exit 1 on regressions\n"
+            "  --tolerance=PCT   allowed slowdown before a regression (default %.0f)\n",
+            suite, BENCH_MIN_MS_DEFAULT, BENCH_TOLERANCE_DEFAULT);
+}
+
+/* 内部工具：解析逗号分隔的规模列表 / internal helper: parse a comma-separated size list */
+static int bench_parse_sizes(bench_suite_t *s, const char *text)
+{
+    s->nsizes = 0;
+    while (*text != '\0')
+    {
+        char *end = NULL;
+        unsigned long long v = strtoull(text, &end, 10);
+        if (end == text || v == 0 || s->nsizes == BENCH_MAX_SIZES || (*end != ',' && *end != '\0'))
+            return -1;
+        s->sizes[s->nsizes++] = (size_t)v;
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return (s->nsizes > 0) ? 0 : -1;
+}
+
+/**
+ * @brief 初始化基准套件并解析公共选项 / Initialize a suite and parse the common options.
+ *
+ * @param s 套件 / Suite
+ * @param suite 套件名，写入 JSON / Suite name, written to the JSON
+ * @param argc 参数个数 / Argument count
+ * @param argv 参数表 / Argument vector
+ * @return 0 表示成功；非 0 表示选项无效（已打印用法）。
+ *         0 on success; non-zero on an invalid option (usage is printed).
+ */
+int bench_suite_init(bench_suite_t *s, const char *suite, int argc, char **argv)
+{
+    if (s == NULL || suite == NULL)
+    {
+        fprintf(stderr, "bench_suite_init: null pointer argument.\n");
+        return -1;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->suite = suite;
+    s->min_ms = BENCH_MIN_MS_DEFAULT;
+    s->tolerance = BENCH_TOLERANCE_DEFAULT;
+    bench_parse_sizes(s, BENCH_SIZES_DEFAULT);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        int bad = 0;
+
+        if (strncmp(arg, "--sizes=", 8) == 0)
+            bad = bench_parse_sizes(s, arg + 8) != 0;
+        else if (strncmp(arg, "--min-ms=", 9) == 0)
+            bad = (s->min_ms = strtod(arg + 9, NULL)) <= 0.0;
+        else if (strncmp(arg, "--filter=", 9) == 0)
+            s->filter = arg + 9;
+        else if (strncmp(arg, "--json=", 7) == 0)
+            s->json_path = arg + 7;
+        else if (strncmp(arg, "--baseline=", 11) == 0)
+            s->baseline = arg + 11;
+        else if (strncmp(arg, "--tolerance=", 12) == 0)
+            bad = (s->tolerance = strtod(arg + 12, NULL)) < 0.0;
+        else
+            bad = 1;
+
+        if (bad)
+        {
+            fprintf(stderr, "bench: invalid option '%s'.\n", arg);
+            bench_usage(suite);
+            return -1;
+        }
+    }
+
+    fprintf(bench_table(s), "%-28s %9s %12s %10s %10s %12s\n", "benchmark", "n", "ns/sample", "GB/s", "allocs", "alloc-bytes");
+    return 0;
+}
+
+/**
+ * @brief 测量一项基准 / Measure one benchmark.
+ *
+ * @param s 套件 / Suite
+ * @param name 名称 / Name
+ * @param n 问题规模，用于与基线配对 / Problem size, used to pair with the baseline
+ * @param samples 每次迭代处理的样本数 / Samples processed per iteration
+ * @param bytes 每次迭代读写的字节数 / Bytes read and written per iteration
+ * @param fn 单次迭代回调 / One-iteration callback
+ * @param ctx 回调上下文 / Callback context
+ * @return 0 表示已测量或被过滤；非 0 表示回调失败或内存不足。
+ *         0 when measured or filtered out; non-zero if the callback failed or on out of memory.
+ *
+ * @note 先预热一次，再把迭代次数加倍直到一轮不短于 min_ms / BENCH_ROUNDS，
+ *       然后计时 BENCH_ROUNDS 轮取最快一轮；分配次数按全部计时轮平均。
+ *       One warm-up call, then the iteration count doubles until a round lasts
+ *       at least min_ms / BENCH_ROUNDS; BENCH_ROUNDS rounds are timed and the
+ *       fastest is kept. Allocations are averaged over all timed rounds.
+ */
+int bench_run(bench_suite_t *s, const char *name, size_t n,
+              size_t samples, size_t bytes, bench_fn fn, void *ctx)
+{
+    if (s == NULL || name == NULL || fn == NULL)
+    {
+        fprintf(stderr, "bench_run: null pointer argument.\n");
+        return -1;
+    }
+    if (s->filter != NULL && strstr(name, s->filter) == NULL)
+        return 0;
+
+    if (s->count == s->cap)
+    {
+        size_t cap = s->cap ? 2 * s->cap : 64;
+        bench_result_t *r = (bench_result_t *)realloc(s->results, cap * sizeof(bench_result_t));
+        if (r == NULL)
+        {
+            fprintf(stderr, "bench_run: failed to allocate results.\n");
+            return -1;
+        }
+        s->results = r;
+        s->cap = cap;
+    }
+
+    double round_ns = s->min_ms * 1e6 / BENCH_ROUNDS;
+    size_t iters = 1;
+    double t = bench_time(fn, ctx, 1);
+    while (t >= 0.0 && (t = bench_time(fn, ctx, iters)) >= 0.0 && t < round_ns)
+        iters *= 2;
+
+    double best = t;
+    size_t c0, b0, c1, b1;
+    bench_alloc_snapshot(&c0, &b0);
+    for (int r = 0; r < BENCH_ROUNDS && t >= 0.0; ++r)
+    {
+        t = bench_time(fn, ctx, iters);
+        if (t >= 0.0 && t < best)
+            best = t;
+    }
+    bench_alloc_snapshot(&c1, &b1);
+
+    if (t < 0.0)
+    {
+        fprintf(stderr, "bench_run: %s n=%zu failed.\n", name, n);
+        s->failed = 1;
+        return -1;
+    }
+
+    bench_result_t *res = &s->results[s->count++];
+    double total = (double)iters * BENCH_ROUNDS;
+    double per_iter = best / (double)iters;
+
+    snprintf(res->name, sizeof(res->name), "%s", name);
+    res->n = n;
+    res->ns_per_sample = per_iter / (double)(samples ? samples : 1);
+    res->gb_per_s = (double)bytes / per_iter;
+    res->allocs_per_iter = BENCH_ALLOCS_COUNTED ? (double)(c1 - c0) / total : -1.0;
+    res->bytes_per_iter = BENCH_ALLOCS_COUNTED ? (double)(b1 - b0) / total : -1.0;
+
+    if (BENCH_ALLOCS_COUNTED)
+        fprintf(bench_table(s), "%-28s %9zu %12.3f %10.3f %10.2f %12.0f\n", res->name, n, res->ns_per_sample,
+               res->gb_per_s, res->allocs_per_iter, res->bytes_per_iter);
+    else
+        fprintf(bench_table(s), "%-28s %9zu %12.3f %10.3f %10s %12s\n", res->name, n, res->ns_per_sample,
+               res->gb_per_s, "n/a", "n/a");
+    fflush(bench_table(s));
+    return 0;
+}
+
+/* ===================== 输出与比较 / Output and comparison ===================== */
+
+/* 内部工具：写出 JSON，每项一行便于 diff 与读回 / internal helper: write JSON, one result per line for diffs and reading back */
+static int bench_write_json(const bench_suite_t *s, FILE *fp)
+{
+    fprintf(fp, "{\n  \"suite\": \"%s\",\n  \"allocs_counted\": %s,\n  \"results\": [\n",
+            s->suite, BENCH_ALLOCS_COUNTED ? "true" : "false");
+    for (size_t i = 0; i < s->count; ++i)
+    {
+        const bench_result_t *r = &s->results[i];
+        fprintf(fp, "    {\"name\": \"%s\", \"n\": %zu, \"ns_per_sample\": %.6g, \"gb_per_s\": %.6g, ",
+                r->name, r->n, r->ns_per_sample, r->gb_per_s);
+        if (r->allocs_per_iter >= 0.0)
+            fprintf(fp, "\"allocs_per_iter\": %.6g, \"bytes_per_iter\": %.6g}", r->allocs_per_iter, r->bytes_per_iter);
+        else
+            fprintf(fp, "\"allocs_per_iter\": null, \"bytes_per_iter\": null}");
+        fprintf(fp, "%s\n", (i + 1 < s->count) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    return ferror(fp) ? -1 : 0;
+}
+
+/* 内部工具：从 bench_write_json 的一行读回一项 / internal helper: read one result back from a bench_write_json line */
+static int bench_parse_line(const char *line, bench_result_t *r)
+{
+    const char *p = strstr(line, "\"name\": \"");
+    const char *q;
+    if (p == NULL)
+        return -1;
+    p += 9;
+    q = strchr(p, '"');
+    if (q == NULL || (size_t)(q - p) >= sizeof(r->name))
+        return -1;
+    memcpy(r->name, p, (size_t)(q - p));
+    r->name[q - p] = '\0';
+
+    if ((p = strstr(q, "\"n\": ")) == NULL || sscanf(p + 5, "%zu", &r->n) != 1)
+        return -1;
+    if ((p = strstr(q, "\"ns_per_sample\": ")) == NULL || sscanf(p + 17, "%lf", &r->ns_per_sample) != 1)
+        return -1;
+    r->allocs_per_iter = -1.0;
+    if ((p = strstr(q, "\"allocs_per_iter\": ")) != NULL)
+        sscanf(p + 19, "%lf", &r->allocs_per_iter);
+    return 0;
+}
+
+/* 内部工具：与基线比较，返回回归项数，读取失败返回 < 0
+ * internal helper: compare with the baseline; returns the regression count, < 0 if it cannot be read */
+static long bench_compare(const bench_suite_t *s)
+{
+    FILE *fp = fopen(s->baseline, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "bench: cannot open baseline '%s'.\n", s->baseline);
+        return -1;
+    }
+
+    char line[512];
+    size_t compared = 0;
+    long regressions = 0;
+    double limit = 1.0 + s->tolerance / 100.0;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        bench_result_t base;
+        if (bench_parse_line(line, &base) != 0)
+            continue;
+
+        for (size_t i = 0; i < s->count; ++i)
+        {
+            const bench_result_t *cur = &s->results[i];
+            if (cur->n != base.n || strcmp(cur->name, base.name) != 0)
+                continue;
+
+            ++compared;
+            if (base.ns_per_sample > 0.0 && cur->ns_per_sample > base.ns_per_sample * limit)
+            {
+                fprintf(stderr, "bench: REGRESSION %s n=%zu: %.3f ns/sample vs %.3f baseline (%+.1f%%)\n",
+                        cur->name, cur->n, cur->ns_per_sample, base.ns_per_sample,
+                        100.0 * (cur->ns_per_sample / base.ns_per_sample - 1.0));
+                ++regressions;
+            }
+            /* 分配次数是确定的，任何增加都算回归 / allocation counts are deterministic, any increase regresses */
+            if (base.allocs_per_iter >= 0.0 && cur->allocs_per_iter > base.allocs_per_iter + 0.01)
+            {
+                fprintf(stderr, "bench: REGRESSION %s n=%zu: %.2f allocs/iter vs %.2f baseline\n",
+                        cur->name, cur->n, cur->allocs_per_iter, base.allocs_per_iter);
+                ++regressions;
+            }
+            break;
+        }
+    }
+    fclose(fp);
+
+    fprintf(stderr, "bench: %zu results compared with '%s' (tolerance %.0f%%), %ld regressions.\n",
+            compared, s->baseline, s->tolerance, regressions);
+    return regressions;
+}
+
+/**
+ * @brief 写出结果、比较基线并释放套件 / Write results, compare with the baseline and free the suite.
+ *
+ * @param s 套件 / Suite
+ * @return 进程退出码：0 表示全部通过；1 表示有项失败、有回归或输出失败。
+ *         Process exit code: 0 if everything passed; 1 on failures, regressions or output errors.
+ */
+int bench_suite_finish(bench_suite_t *s)
+{
+    if (s == NULL)
+        return 1;
+
+    int status = s->failed;
+    if (s->json_path != NULL)
+    {
+        int to_stdout = strcmp(s->json_path, "-") == 0;
+        FILE *fp = to_stdout ? stdout : fopen(s->json_path, "w");
+        if (fp == NULL || bench_write_json(s, fp) != 0)
+        {
+            fprintf(stderr, "bench: failed to write '%s'.\n", s->json_path);
+            status = 1;
+        }
+        if (fp != NULL && !to_stdout)
+            fclose(fp);
+    }
+    if (s->baseline != NULL && bench_compare(s) != 0)
+        status = 1;
+
+    free(s->results);
+    s->results = NULL;
+    s->count = s->cap = 0;
+    return status;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file bench.h
+ * @brief 微基准测试框架接口 / Microbenchmark harness interface
+ *
+ * 2/（seqops）与 3/（dsp_seq）的基准程序共用此框架：计时、分配计数、
+ * 文本表格与 JSON 输出，以及与基线文件的回归比较。
+ * Shared by the 2/ (seqops) and 3/ (dsp_seq) benchmark drivers: timing,
+ * allocation counting, table and JSON output, and regression checks
+ * against a baseline file.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+
+/** 默认问题规模 / Default problem sizes */
+#define BENCH_SIZES_DEFAULT "1024,16384,262144"
+
+/** 默认每项最短计时（毫秒）/ Default minimum timed duration per benchmark in ms */
+#define BENCH_MIN_MS_DEFAULT 40.0
+
+/** 计时轮数，报告最快一轮 / Timed rounds; the fastest one is reported */
+#define BENCH_ROUNDS 5
+
+/** 默认回归容差（百分比）/ Default regression tolerance in percent */
+#define BENCH_TOLERANCE_DEFAULT 10.0
+
+/** 最多支持的规模个数 / Maximum number of sizes in a sweep */
+#define BENCH_MAX_SIZES 16
+
+/**
+ * @brief 单次迭代回调 / One-iteration callback
+ *
+ * @return 0 表示成功；非 0 表示失败，该项被跳过 / 0 on success; non-zero skips the benchmark
+ */
+typedef int (*bench_fn)(void *ctx);
+
+/**
+ * @brief 一项测量结果 / One measurement
+ */
+typedef struct
+{
+    char name[64];          /**< 名称，如 "block/fir" / name such as "block/fir" */
+    size_t n;               /**< 问题规模 / problem size */
+    double ns_per_sample;   /**< 每样本纳秒 / nanoseconds per sample */
+    double gb_per_s;        /**< 读写吞吐 / read + write throughput in GB/s */
+    double allocs_per_iter; /**< 每次迭代的堆分配次数，未计数时 < 0 / heap allocations per iteration, < 0 if not counted */
+    double bytes_per_iter;  /**< 每次迭代的分配字节数 / bytes allocated per iteration */
+} bench_result_t;
+
+/**
+ * @brief 基准套件 / Benchmark suite
+ */
+typedef struct
+{
+    const char *suite;             /**< 套件名 / suite name */
+    size_t sizes[BENCH_MAX_SIZES]; /**< 规模列表 / size sweep */
+    size_t nsizes;                 /**< 规模个数 / number of sizes */
+    double min_ms;                 /**< 每项最短计时 / minimum timed duration */
+    const char *filter;            /**< 名称子串过滤，NULL 为全部 / name substring filter, NULL for all */
+    const char *json_path;         /**< JSON 输出路径，"-" 为 stdout / JSON path, "-" for stdout */
+    const char *baseline;          /**< 基线 JSON 路径 / baseline JSON path */
+    double tolerance;              /**< 回归容差（百分比）/ regression tolerance in percent */
+    bench_result_t *results;       /**< 结果数组 / results */
+    size_t count;                  /**< 结果个数 / number of results */
+    size_t cap;                    /**< 结果容量 / result capacity */
+    int failed;                    /**< 是否有项失败 / whether any benchmark failed */
+} bench_suite_t;
+
+/* === 接口声明 (Function declarations) === */
+int bench_suite_init(bench_suite_t *s, const char *suite, int argc, char **argv);
+int bench_run(bench_suite_t *s, const char *name, size_t n,
+              size_t samples, size_t bytes, bench_fn fn, void *ctx);
+int bench_suite_finish(bench_suite_t *s);
+
+#endif /* BENCH_H */
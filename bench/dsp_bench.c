@@ -0,0 +1,299 @@
+/**
+ * @file dsp_bench.c
+ * @brief 3/ 序列运算库（dsp_seq）的基准程序 / Benchmarks for the 3/ sequence library (dsp_seq)
+ *
+ * 测量加法、乘法、线性 / 圆周卷积、互相关（短核与等长）、预先准备核的卷积 / 相关计划
+ * 以及两种滑动窗口相关：每步重算的 seq_corr_window_norm 与增量的 seq_corr_stream_t。
+ * Measures addition, multiplication, linear / circular convolution,
+ * cross-correlation (short kernel and equal length), convolution /
+ * correlation plans with a prepared kernel and both sliding-window
+ * correlators: seq_corr_window_norm recomputed per step and the incremental
+ * seq_corr_stream_t.
+ * 表达式 diff(delay(a, d) · b + a) 分别按融合求值 (expr/fused) 与逐步调用 (expr/steps) 测量。
+ * The expression diff(delay(a, d) · b + a) is measured fused (expr/fused)
+ * and as one call per step (expr/steps).
+ */
+
+#include "bench.h"
+#include "ops.h"
+#include "expr.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** 短核长度 / Short kernel length */
+#define DB_KERNEL 32
+/** 计划基准的核长度（走 FFT 路径）/ Kernel length of the plan benchmarks (FFT path) */
+#define DB_PLAN_KERNEL 512
+/** 滑动窗口长度 / Sliding window length */
+#define DB_WINDOW 256
+/** 等长直接互相关的最大规模（O(N²)）/ Largest size for equal-length direct correlation (O(N²)) */
+#define DB_DIRECT_MAX 16384
+/** 表达式基准的延迟 / Delay of the expression benchmark */
+#define DB_EXPR_DELAY 3
+
+/**
+ * @brief 一项基准的上下文 / Context of one benchmark
+ */
+typedef struct
+{
+    seq_t a;              /**< 输入 A / input A */
+    seq_t b;              /**< 输入 B / input B */
+    seq_t out;            /**< 分配接口的输出 / output of the allocating API */
+    seq_sample_t *buf;    /**< 调用方输出缓冲 / caller output buffer */
+    size_t cap;           /**< 输出容量 / output capacity */
+    ops_ctx_t ctx;        /**< 运算上下文 / operation context */
+    seq_corr_stream_t cs; /**< 增量相关器 / incremental correlator */
+    seq_window_t wa;      /**< 逐步重算的窗口 A / window A of the recompute run */
+    seq_window_t wb;      /**< 逐步重算的窗口 B / window B of the recompute run */
+    seq_conv_plan_t plan; /**< 以 B 为核的计划 / plan with B as the kernel */
+    expr_t expr;          /**< 融合表达式 / fused expression */
+    int root;             /**< 融合表达式的根 / root of the fused expression */
+    expr_t step_delay;    /**< 逐步求值的 delay(a) / delay(a) of the step-by-step run */
+    expr_t step_diff;     /**< 逐步求值的 diff(t) / diff(t) of the step-by-step run */
+    seq_t tmp[3];         /**< 逐步求值的临时序列 / temporaries of the step-by-step run */
+} db_ctx_t;
+
+static int db_add(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    int rc = seq_add(&c->a, &c->b, &c->out);
+    seq_free(&c->out);
+    return rc;
+}
+
+static int db_mul(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    int rc = seq_mul(&c->a, &c->b, &c->out);
+    seq_free(&c->out);
+    return rc;
+}
+
+static int db_conv_linear(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    int rc = seq_conv_linear(&c->a, &c->b, &c->out);
+    seq_free(&c->out);
+    return rc;
+}
+
+/* 复用上下文与调用方缓冲区，预热后不分配 / reuses the context and caller buffer, allocation-free after warm-up */
+static int db_conv_linear_into(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n_out;
+    return seq_conv_linear_into(&c->ctx, &c->a, &c->b, c->buf, c->cap, &n_out);
+}
+
+static int db_conv_circular(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    int rc = seq_conv_circular(&c->a, &c->b, &c->out);
+    seq_free(&c->out);
+    return rc;
+}
+
+/* 核频谱与暂存已在计划中，每次只做块变换 / kernel spectrum and scratch live in the plan; only block transforms per call */
+static int db_conv_plan(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n_out;
+    return seq_conv_plan_exec(&c->plan, &c->a, c->buf, c->cap, &n_out);
+}
+
+static int db_corr_plan(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n_out;
+    return seq_conv_plan_exec(&c->plan, &c->a, c->buf, c->cap, &n_out);
+}
+
+static int db_corr_cross(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    int rc = seq_corr_cross(&c->a, &c->b, &c->out);
+    seq_free(&c->out);
+    return rc;
+}
+
+static int db_corr_cross_into(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n_out;
+    return seq_corr_cross_into(&c->a, &c->b, c->buf, c->cap, &n_out);
+}
+
+/* 一趟分块求值，无临时序列 / one blocked pass, no temporaries */
+static int db_expr_fused(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n_out;
+    return expr_eval_into(&c->expr, c->root, c->buf, c->cap, &n_out);
+}
+
+/* 每步一次完整读写，临时序列已预先分配 / a full pass per step over preallocated temporaries */
+static int db_expr_steps(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    size_t n = c->a.length;
+    size_t n_out;
+    if (expr_eval_into(&c->step_delay, 1, c->tmp[0].data, n, &n_out) != 0 ||
+        seq_mul_into(&c->tmp[0], &c->b, c->tmp[1].data, n, &n_out) != 0 ||
+        seq_add_into(&c->tmp[1], &c->a, c->tmp[2].data, n, &n_out) != 0)
+        return -1;
+    return expr_eval_into(&c->step_diff, 1, c->buf, c->cap, &n_out);
+}
+
+/* 内部工具：搭建两种表达式求值 / internal helper: build both expression runs */
+static int db_expr_setup(db_ctx_t *c)
+{
+    expr_init(&c->expr);
+    expr_init(&c->step_delay);
+    expr_init(&c->step_diff);
+
+    int a = expr_leaf(&c->expr, &c->a);
+    int b = expr_leaf(&c->expr, &c->b);
+    c->root = expr_diff(&c->expr, expr_add(&c->expr, expr_mul(&c->expr, expr_delay(&c->expr, a, DB_EXPR_DELAY, 0), b), a));
+    if (c->root < 0)
+        return -1;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (seq_init(&c->tmp[i], c->a.length) != 0)
+            return -1;
+    }
+    if (expr_delay(&c->step_delay, expr_leaf(&c->step_delay, &c->a), DB_EXPR_DELAY, 0) != 1 ||
+        expr_diff(&c->step_diff, expr_leaf(&c->step_diff, &c->tmp[2])) != 1)
+        return -1;
+    return 0;
+}
+
+/* 每推入一对样本重算一次窗口相关，O(W) / recompute the windowed correlation per pushed pair, O(W) */
+static int db_corr_window(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+    seq_window_t *wa = &c->wa;
+    seq_window_t *wb = &c->wb;
+
+    for (size_t i = 0; i < c->a.length; ++i)
+    {
+        seq_window_push(wa, c->a.data[i]);
+        seq_window_push(wb, c->b.data[i]);
+        if (seq_corr_window_norm(wa, wb, &c->buf[i]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* 增量相关器，O(1) / incremental correlator, O(1) */
+static int db_corr_stream(void *arg)
+{
+    db_ctx_t *c = (db_ctx_t *)arg;
+
+    for (size_t i = 0; i < c->a.length; ++i)
+    {
+        if (seq_corr_stream_push(&c->cs, c->a.data[i], c->b.data[i]) != 0 ||
+            seq_corr_stream_get(&c->cs, &c->buf[i]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* 内部工具：填充伪随机序列 / internal helper: fill a pseudo-random sequence */
+static int db_fill(seq_t *s, size_t len)
+{
+    if (seq_init(s, len) != 0)
+        return -1;
+    for (size_t i = 0; i < len; ++i)
+        s->data[i] = seq_sample_from_double(0.5 * ((double)rand() / RAND_MAX - 0.5));
+    return 0;
+}
+
+/* 内部工具：以 A、B 长度准备上下文并测量 / internal helper: set up A and B of the given lengths and measure */
+static void db_measure(bench_suite_t *s, const char *name, size_t la, size_t lb, size_t lout, bench_fn fn)
+{
+    db_ctx_t c = {0};
+    srand(1);
+
+    int plan_rc = 0;
+    if (db_fill(&c.a, la) == 0 && db_fill(&c.b, lb) == 0)
+    {
+        if (fn == db_conv_plan)
+            plan_rc = seq_conv_plan_init(&c.plan, &c.b, la);
+        else if (fn == db_corr_plan)
+            plan_rc = seq_corr_plan_init(&c.plan, &c.b, la);
+        else if (fn == db_expr_fused || fn == db_expr_steps)
+            plan_rc = db_expr_setup(&c);
+    }
+
+    if (c.a.length != la || c.b.length != lb || plan_rc != 0 || ops_ctx_init(&c.ctx, 0) != 0 ||
+        seq_corr_stream_init(&c.cs, DB_WINDOW, 0) != 0 || seq_window_init(&c.wa, DB_WINDOW) != 0 ||
+        seq_window_init(&c.wb, DB_WINDOW) != 0 ||
+        (c.buf = (seq_sample_t *)malloc(lout * sizeof(seq_sample_t))) == NULL)
+    {
+        fprintf(stderr, "dsp_bench: failed to set up %s n=%zu.\n", name, la);
+        s->failed = 1;
+    }
+    else
+    {
+        c.cap = lout;
+        /* 窗口先填满，只测稳态 / fill the windows first so only the steady state is timed */
+        for (size_t i = 0; i < DB_WINDOW && i < la; ++i)
+        {
+            seq_corr_stream_push(&c.cs, c.a.data[i], c.b.data[i]);
+            seq_window_push(&c.wa, c.a.data[i]);
+            seq_window_push(&c.wb, c.b.data[i]);
+        }
+        bench_run(s, name, la, la, (la + lb + lout) * sizeof(seq_sample_t), fn, &c);
+    }
+
+    free(c.buf);
+    expr_free(&c.expr);
+    expr_free(&c.step_delay);
+    expr_free(&c.step_diff);
+    for (int i = 0; i < 3; ++i)
+        seq_free(&c.tmp[i]);
+    seq_conv_plan_free(&c.plan);
+    seq_corr_stream_free(&c.cs);
+    seq_window_free(&c.wa);
+    seq_window_free(&c.wb);
+    ops_ctx_free(&c.ctx);
+    seq_free(&c.a);
+    seq_free(&c.b);
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "dsp", argc, argv) != 0)
+        return 2;
+
+    for (size_t z = 0; z < suite.nsizes; ++z)
+    {
+        size_t n = suite.sizes[z];
+        size_t k = (n < DB_KERNEL) ? n : DB_KERNEL;
+        size_t kp = (n < DB_PLAN_KERNEL) ? n : DB_PLAN_KERNEL;
+
+        db_measure(&suite, "add", n, n, n, db_add);
+        db_measure(&suite, "mul", n, n, n, db_mul);
+        db_measure(&suite, "expr/fused", n, n, n, db_expr_fused);
+        db_measure(&suite, "expr/steps", n, n, n, db_expr_steps);
+        db_measure(&suite, "conv-linear/k32", n, k, n + k - 1, db_conv_linear);
+        db_measure(&suite, "conv-linear/equal", n, n, 2 * n - 1, db_conv_linear);
+        db_measure(&suite, "conv-linear-into/equal", n, n, 2 * n - 1, db_conv_linear_into);
+        db_measure(&suite, "conv-linear-into/k512", n, kp, n + kp - 1, db_conv_linear_into);
+        db_measure(&suite, "conv-plan/k512", n, kp, n + kp - 1, db_conv_plan);
+        db_measure(&suite, "conv-circular", n, n, n, db_conv_circular);
+        db_measure(&suite, "corr-cross/k32", n, k, n + k - 1, db_corr_cross);
+        if (n * kp <= DB_DIRECT_MAX * DB_DIRECT_MAX)
+            db_measure(&suite, "corr-cross-into/k512", n, kp, n + kp - 1, db_corr_cross_into);
+        db_measure(&suite, "corr-plan/k512", n, kp, n + kp - 1, db_corr_plan);
+        if (n <= DB_DIRECT_MAX)
+            db_measure(&suite, "corr-cross/equal", n, n, 2 * n - 1, db_corr_cross);
+        db_measure(&suite, "corr-window/w256", n, n, n, db_corr_window);
+        db_measure(&suite, "corr-stream/w256", n, n, n, db_corr_stream);
+    }
+
+    return bench_suite_finish(&suite);
+}
@@ -0,0 +1,315 @@
+/**
+ * @file seqops_bench.c
+ * @brief 2/ 序列操作库（seqops）的基准程序 / Benchmarks for the 2/ sequence library (seqops)
+ *
+ * 对 seq_op_type 的每个操作测量四条路径：分配输出的离线接口 (finite)、
+ * 写入调用方缓冲区的 seq_apply_into (into)、逐样本 seq_stream_step (step)
+ * 与块接口 seq_stream_process (block)。
+ * Measures four paths for every op in seq_op_type: the allocating offline API
+ * (finite), seq_apply_into into a caller buffer (into), per-sample
+ * seq_stream_step (step) and block seq_stream_process (block).
+ * 重排操作另测零拷贝视图 (view)，并对比 reverse → downsample → delay 串联时
+ * 逐步分配 (finite) 与视图一次收集 (view) 的差别。
+ * Re-indexing ops also measure zero-copy views (view), and the chain
+ * reverse → downsample → delay is compared step by step (finite) against a
+ * single view gather (view).
+ */
+
+#include "bench.h"
+#include "sequence.h"
+#include "view.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** FIR 抽头数 / FIR taps */
+#define SB_FIR_TAPS 64
+/** 重采样因子与抽头数 / Resampling factors and taps */
+#define SB_RS_UP 3
+#define SB_RS_DOWN 2
+#define SB_RS_TAPS 48
+/** 滑动 DFT 窗口长度与频点 / Sliding DFT window length and bins */
+#define SB_SDFT_N 256
+static const size_t sb_sdft_bins[] = {3, 17, 40, 101};
+#define SB_SDFT_NBINS (sizeof(sb_sdft_bins) / sizeof(sb_sdft_bins[0]))
+/** 补零、延迟与上下采样的参数 / Parameter for padding, delay and rate changes */
+#define SB_PARAM_SHIFT 64
+#define SB_PARAM_RATE 3
+
+/**
+ * @brief 操作描述 / Op descriptor
+ */
+typedef struct
+{
+    seq_op_type op;   /**< 操作 / op */
+    const char *name; /**< 名称 / name */
+    size_t param;     /**< 主参数 / main parameter */
+} sb_op_t;
+
+static const sb_op_t sb_ops[] = {
+    {SEQ_OP_PAD_FRONT, "pad-front", SB_PARAM_SHIFT},
+    {SEQ_OP_PAD_BACK, "pad-back", SB_PARAM_SHIFT},
+    {SEQ_OP_DELAY, "delay", SB_PARAM_SHIFT},
+    {SEQ_OP_ADVANCE, "advance", SB_PARAM_SHIFT},
+    {SEQ_OP_REVERSE, "reverse", 0},
+    {SEQ_OP_UPSAMPLE, "upsample", SB_PARAM_RATE},
+    {SEQ_OP_DOWNSAMPLE, "downsample", SB_PARAM_RATE},
+    {SEQ_OP_DIFF, "diff", 0},
+    {SEQ_OP_CUMSUM, "cumsum", 0},
+    {SEQ_OP_FIR, "fir", SB_FIR_TAPS},
+    {SEQ_OP_RESAMPLE, "resample", SB_RS_TAPS},
+    {SEQ_OP_SDFT, "sdft", SB_SDFT_N},
+};
+
+/** 串联基准的描述，只用其名称 / Descriptor of the chain benchmark, only its name is used */
+static const sb_op_t sb_chain = {SEQ_OP_REVERSE, "rev+down+delay", 0};
+
+/**
+ * @brief 一项基准的上下文 / Context of one benchmark
+ */
+typedef struct
+{
+    const sb_op_t *op; /**< 操作 / op */
+    seq_t src;         /**< 输入 / input */
+    seq_t dst;         /**< 离线输出 / offline output */
+    double *out;       /**< 调用方输出缓冲 / caller output buffer */
+    size_t cap;        /**< 输出容量 / output capacity */
+    size_t n_out;      /**< 最近一次迭代的输出个数 / outputs of the last iteration */
+    seq_stream_t st;   /**< 流式状态 / streaming state */
+    double taps[SB_FIR_TAPS > SB_RS_TAPS ? SB_FIR_TAPS : SB_RS_TAPS]; /**< 滤波器 / filter */
+} sb_ctx_t;
+
+/* 离线接口：每次迭代分配新输出并释放 / offline API: a fresh output is allocated and freed per iteration */
+static int sb_finite(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    const seq_t *s = &c->src;
+    size_t p = c->op->param;
+    seq_err_t rc;
+
+    switch (c->op->op)
+    {
+    case SEQ_OP_PAD_FRONT:
+        rc = seq_pad_front(s, p, &c->dst);
+        break;
+    case SEQ_OP_PAD_BACK:
+        rc = seq_pad_back(s, p, &c->dst);
+        break;
+    case SEQ_OP_DELAY:
+        rc = seq_delay(s, p, 0.0, &c->dst);
+        break;
+    case SEQ_OP_ADVANCE:
+        rc = seq_advance(s, p, 0.0, &c->dst);
+        break;
+    case SEQ_OP_REVERSE:
+        rc = seq_reverse(s, &c->dst);
+        break;
+    case SEQ_OP_UPSAMPLE:
+        rc = seq_upsample(s, p, &c->dst);
+        break;
+    case SEQ_OP_DOWNSAMPLE:
+        rc = seq_downsample(s, p, &c->dst);
+        break;
+    case SEQ_OP_DIFF:
+        rc = seq_diff(s, &c->dst);
+        break;
+    case SEQ_OP_CUMSUM:
+        rc = seq_cumsum(s, &c->dst);
+        break;
+    case SEQ_OP_FIR:
+        rc = seq_fir_filter(s, c->taps, SB_FIR_TAPS, &c->dst);
+        break;
+    case SEQ_OP_RESAMPLE:
+        rc = seq_resample(s, SB_RS_UP, SB_RS_DOWN, c->taps, SB_RS_TAPS, &c->dst);
+        break;
+    case SEQ_OP_SDFT:
+        rc = seq_sliding_dft(s, SB_SDFT_N, sb_sdft_bins, SB_SDFT_NBINS, &c->dst);
+        break;
+    default:
+        rc = SEQ_ERR_UNSUPPORTED;
+        break;
+    }
+
+    c->n_out = c->dst.length;
+    seq_free(&c->dst);
+    return rc == SEQ_OK ? 0 : -1;
+}
+
+/* 调用方缓冲区：不分配 / caller buffer: no allocation */
+static int sb_into(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    return seq_apply_into(c->op->op, &c->src, c->op->param, 0.0, c->out, c->cap, &c->n_out) == SEQ_OK ? 0 : -1;
+}
+
+/* 零拷贝视图：O(1) 改写后一次收集 / zero-copy view: an O(1) rewrite, then one gather */
+static int sb_view(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    seq_view_t v;
+    if (seq_view_of(&c->src, &v) != SEQ_OK || seq_view_apply(c->op->op, &v, c->op->param, 0.0, &v) != SEQ_OK)
+        return -1;
+    return seq_view_copy_into(&v, c->out, c->cap, &c->n_out) == SEQ_OK ? 0 : -1;
+}
+
+/* 串联，逐步分配：每一步一趟读写 / chain step by step: one pass over memory per step */
+static int sb_chain_finite(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    seq_t t1 = {0};
+    seq_t t2 = {0};
+    seq_err_t rc = seq_reverse(&c->src, &t1);
+    if (rc == SEQ_OK)
+        rc = seq_downsample(&t1, SB_PARAM_RATE, &t2);
+    if (rc == SEQ_OK)
+        rc = seq_delay(&t2, SB_PARAM_SHIFT, 0.0, &c->dst);
+    c->n_out = c->dst.length;
+    seq_free(&t1);
+    seq_free(&t2);
+    seq_free(&c->dst);
+    return rc == SEQ_OK ? 0 : -1;
+}
+
+/* 串联，视图：三次 O(1) 改写，一次收集 / chain as a view: three O(1) rewrites, one gather */
+static int sb_chain_view(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    seq_view_t v;
+    if (seq_view_of(&c->src, &v) != SEQ_OK || seq_view_reverse(&v, &v) != SEQ_OK ||
+        seq_view_downsample(&v, SB_PARAM_RATE, &v) != SEQ_OK || seq_view_delay(&v, SB_PARAM_SHIFT, 0.0, &v) != SEQ_OK)
+        return -1;
+    return seq_view_copy_into(&v, c->out, c->cap, &c->n_out) == SEQ_OK ? 0 : -1;
+}
+
+/* 逐样本：每个输入前与最后都取空待输出样本 / per sample: pending outputs are drained before each input and at the end */
+static int sb_step(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    size_t k = 0;
+
+    for (size_t i = 0; i <= c->src.length; ++i)
+    {
+        int has = 1;
+        while (has)
+        {
+            if (k == c->cap || seq_stream_step(&c->st, 0, 0.0, c->out + k, &has) != SEQ_OK)
+                return -1;
+            k += (size_t)has;
+        }
+        if (i == c->src.length)
+            break;
+        if (k == c->cap || seq_stream_step(&c->st, 1, c->src.data[i], c->out + k, &has) != SEQ_OK)
+            return -1;
+        k += (size_t)has;
+    }
+    c->n_out = k;
+    return 0;
+}
+
+/* 块接口：一次送入全部输入 / block API: the whole input in one call */
+static int sb_block(void *arg)
+{
+    sb_ctx_t *c = (sb_ctx_t *)arg;
+    return seq_stream_process(&c->st, c->src.data, c->src.length, c->out, c->cap, &c->n_out) == SEQ_OK ? 0 : -1;
+}
+
+/* 内部工具：按操作初始化流式状态 / internal helper: initialize the streaming state for the op */
+static seq_err_t sb_stream_init(sb_ctx_t *c)
+{
+    if (c->op->op == SEQ_OP_FIR)
+        return seq_stream_init_fir(&c->st, c->taps, SB_FIR_TAPS, 0);
+    if (c->op->op == SEQ_OP_RESAMPLE)
+        return seq_stream_init_resample(&c->st, SB_RS_UP, SB_RS_DOWN, c->taps, SB_RS_TAPS);
+    if (c->op->op == SEQ_OP_SDFT)
+        return seq_stream_init_sdft(&c->st, SB_SDFT_N, sb_sdft_bins, SB_SDFT_NBINS);
+    return seq_stream_init(&c->st, c->op->op, c->op->param, 0, 0.0);
+}
+
+/* 内部工具：预热一次取得输出个数后测量 / internal helper: one call for the output count, then measure */
+static void sb_measure(bench_suite_t *s, const char *path, sb_ctx_t *c, bench_fn fn)
+{
+    char name[64];
+    size_t n = c->src.length;
+
+    snprintf(name, sizeof(name), "%s/%s", path, c->op->name);
+    if (fn(c) != 0)
+    {
+        fprintf(stderr, "seqops_bench: %s n=%zu failed.\n", name, n);
+        s->failed = 1;
+        return;
+    }
+    bench_run(s, name, n, n, (n + c->n_out) * sizeof(double), fn, c);
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "seqops", argc, argv) != 0)
+        return 2;
+
+    for (size_t z = 0; z < suite.nsizes; ++z)
+    {
+        size_t n = suite.sizes[z];
+
+        for (size_t o = 0; o < sizeof(sb_ops) / sizeof(sb_ops[0]); ++o)
+        {
+            sb_ctx_t c = {0};
+            c.op = &sb_ops[o];
+            if (seq_alloc(&c.src, n) != SEQ_OK)
+                return 2;
+            srand(1);
+            for (size_t i = 0; i < n; ++i)
+                c.src.data[i] = (double)rand() / RAND_MAX - 0.5;
+            for (size_t i = 0; i < sizeof(c.taps) / sizeof(c.taps[0]); ++i)
+                c.taps[i] = 1.0 / (double)(i + 1);
+
+            sb_measure(&suite, "finite", &c, sb_finite);
+
+            /* 按 2n 个输入取上界，覆盖上一次迭代留在状态中的部分块
+             * the bound for 2n inputs covers a partial block carried over from the previous iteration */
+            size_t cap = 0;
+            if (seq_online_capable(c.op->op, 1) && sb_stream_init(&c) == SEQ_OK)
+                cap = seq_stream_output_bound(&c.st, 2 * n);
+            int offline = c.op->op != SEQ_OP_FIR && c.op->op != SEQ_OP_RESAMPLE && c.op->op != SEQ_OP_SDFT;
+            if (!offline || seq_output_length(c.op->op, n, c.op->param, &c.cap) != SEQ_OK || c.cap < cap)
+                c.cap = cap;
+            c.out = (double *)malloc((c.cap ? c.cap : 1) * sizeof(double));
+            if (c.out == NULL)
+                return 2;
+
+            if (offline)
+                sb_measure(&suite, "into", &c, sb_into);
+            if (offline && c.op->op != SEQ_OP_UPSAMPLE && c.op->op != SEQ_OP_DIFF && c.op->op != SEQ_OP_CUMSUM)
+                sb_measure(&suite, "view", &c, sb_view);
+            if (c.st.active)
+            {
+                sb_measure(&suite, "block", &c, sb_block);
+                seq_stream_dispose(&c.st);
+                if (sb_stream_init(&c) == SEQ_OK)
+                    sb_measure(&suite, "step", &c, sb_step);
+            }
+
+            seq_stream_dispose(&c.st);
+            free(c.out);
+            seq_free(&c.src);
+        }
+
+        sb_ctx_t c = {0};
+        c.op = &sb_chain;
+        if (seq_alloc(&c.src, n) != SEQ_OK)
+            return 2;
+        srand(1);
+        for (size_t i = 0; i < n; ++i)
+            c.src.data[i] = (double)rand() / RAND_MAX - 0.5;
+        c.cap = n / SB_PARAM_RATE;
+        c.out = (double *)malloc((c.cap ? c.cap : 1) * sizeof(double));
+        if (c.out == NULL)
+            return 2;
+        sb_measure(&suite, "finite", &c, sb_chain_finite);
+        sb_measure(&suite, "view", &c, sb_chain_view);
+        free(c.out);
+        seq_free(&c.src);
+    }
+
+    return bench_suite_finish(&suite);
+}
@@ -0,0 +1,674 @@
+/**
+ * @file numtext.c
+ * @brief 文本数值的快速解析与格式化实现 / Fast text number parsing and formatting implementation
+ *
+ * 解析：尾数不超过 19 位有效数字、取值 ≤ 2^53 且十进制指数在 ±22 内时，
+ * 一次乘或除以精确的 10 的幂即得正确舍入结果（Clinger 快速路径），其余交给 strtod。
+ * 格式化：%.Pg（P ≤ 15）把 |v|·10^s（|s| ≤ 22）分解为双字长的精确值，舍入到 P 位整数，
+ * 真正的平局按偶数处理，因此与 printf 逐字节一致；超出范围时交给 snprintf。
+ * Parsing: with at most 19 significant digits, a value ≤ 2^53 and a decimal
+ * exponent within ±22, one multiplication or division by an exact power of
+ * ten is correctly rounded (Clinger's fast path); everything else goes to
+ * strtod. Formatting: %.Pg (P ≤ 15) splits |v|·10^s (|s| ≤ 22) into an
+ * exact double-double, rounds it to a P-digit integer with true ties going
+ * to even, and so matches printf byte for byte; anything outside that range
+ * goes to snprintf.
+ */
+
+#include "numtext.h"
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 快速路径要求 double 运算不带扩展精度 / the fast paths need double arithmetic without excess precision */
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define NUM_FAST 1
+#else
+#define NUM_FAST 0
+#endif
+
+/** 回退路径可处理的最长记号 / Longest token the fallback path accepts */
+#define NUM_FALLBACK_MAX 512
+
+/** 快速格式化支持的最大精度 / Largest precision of the fast formatter */
+#define NUM_FAST_PREC 15
+
+/* 精确可表示的 10 的幂 / exactly representable powers of ten */
+static const double num_p10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* 整数的 10 的幂 / integer powers of ten */
+static const uint64_t num_u10[17] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull};
+
+/* 字符类：1 为空白（同 C 区域的 isspace），2 为缓冲末尾的 NUL 哨兵 / character class: 1 for whitespace (isspace in the C locale), 2 for the NUL sentinel ending the buffer */
+static const unsigned char num_class[256] = {
+    [' '] = 1, ['\n'] = 1, ['\t'] = 1, ['\r'] = 1, ['\v'] = 1, ['\f'] = 1, ['\0'] = 2};
+
+/* 两位十进制数字表 / two-digit decimal table */
+static const char num_digits2[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* 内部工具：累加 s[i..] 的十进制数字到 w / accumulate the decimal digits at s[i..] into w */
+static size_t num_digits(const char *s, size_t i, size_t len, uint64_t *w)
+{
+    uint64_t acc = *w;
+    for (; i < len && (unsigned)(s[i] - '0') < 10u; ++i)
+        acc = acc * 10 + (uint64_t)(s[i] - '0');
+    *w = acc;
+    return i;
+}
+
+/* 内部工具：交给 strtod 解析前缀；strict 时像 strtod + errno 检查那样拒绝 ERANGE，否则像 scanf("%lf") 那样接受 /
+   parse a prefix with strtod; strict rejects ERANGE like strtod plus an errno check, otherwise it is accepted like scanf("%lf") */
+static size_t num_scan_fallback(const char *s, size_t len, double *out, int strict)
+{
+    char tmp[NUM_FALLBACK_MAX + 1];
+    char *end = NULL;
+
+    if (len > NUM_FALLBACK_MAX)
+        len = NUM_FALLBACK_MAX;
+    memcpy(tmp, s, len);
+    tmp[len] = '\0';
+
+    errno = 0;
+    double v = strtod(tmp, &end);
+    if (end == tmp || (strict && errno == ERANGE))
+        return 0;
+    *out = v;
+    return (size_t)(end - tmp);
+}
+
+/* 内部工具：num_scan_double 与 num_scan_double_strict 的共同实现；快速路径的结果总在正规数范围内 /
+   shared body of num_scan_double and num_scan_double_strict; fast-path results are always normal numbers */
+static size_t num_scan(const char *s, size_t len, double *out, int strict)
+{
+    if (s == NULL || out == NULL || len == 0)
+        return 0;
+
+#if NUM_FAST
+    size_t i = 0;
+    int neg = 0;
+    if (s[i] == '-' || s[i] == '+')
+    {
+        neg = (s[i] == '-');
+        ++i;
+    }
+
+    uint64_t w = 0;
+    size_t nd = 0; /* 有效数字个数 / significant digits */
+    int zeros = 0; /* 前导零也算作数字 / leading zeros count as digits too */
+    int e10 = 0;
+
+    for (; i < len && s[i] == '0'; ++i)
+        zeros = 1;
+    size_t i0 = i;
+    i = num_digits(s, i, len, &w);
+    nd = i - i0;
+    if (i < len && s[i] == '.')
+    {
+        ++i;
+        if (nd == 0)
+        {
+            for (; i < len && s[i] == '0'; ++i, --e10)
+                zeros = 1;
+        }
+        i0 = i;
+        i = num_digits(s, i, len, &w);
+        nd += i - i0;
+        e10 -= (int)(i - i0);
+    }
+    if ((nd == 0 && !zeros) || nd > 19)
+        return num_scan_fallback(s, len, out, strict);
+
+    if (i < len && (s[i] == 'e' || s[i] == 'E'))
+    {
+        size_t j = i + 1;
+        int eneg = 0;
+        int ev = 0;
+        if (j < len && (s[j] == '-' || s[j] == '+'))
+        {
+            eneg = (s[j] == '-');
+            ++j;
+        }
+        if (j < len && s[j] >= '0' && s[j] <= '9')
+        {
+            for (; j < len && s[j] >= '0' && s[j] <= '9'; ++j)
+            {
+                if (ev < 100000)
+                    ev = ev * 10 + (s[j] - '0');
+            }
+            e10 += eneg ? -ev : ev;
+            i = j;
+        }
+    }
+
+    /* 紧跟字母或小数点时（十六进制、inf 之类）由 strtod 裁决 / letters or a dot right after (hex, inf...) are left to strtod */
+    if (i < len && (s[i] == '.' || (s[i] >= 'a' && s[i] <= 'z') || (s[i] >= 'A' && s[i] <= 'Z')))
+        return num_scan_fallback(s, len, out, strict);
+
+    double v;
+    if (w == 0)
+        v = 0.0;
+    else if (w <= (1ull << 53) && e10 >= -22 && e10 <= 22)
+        v = (e10 >= 0) ? (double)w * num_p10[e10] : (double)w / num_p10[-e10];
+    else
+        return num_scan_fallback(s, len, out, strict);
+
+    *out = neg ? -v : v;
+    return i;
+#else
+    return num_scan_fallback(s, len, out, strict);
+#endif
+}
+
+/**
+ * @brief 解析十进制数前缀 / Parse a decimal number prefix.
+ *
+ * @param s 文本，不要求以 NUL 结尾 / Text, need not be NUL-terminated
+ * @param len 文本长度 / Text length
+ * @param out 解析结果 / Parsed value
+ * @return 消耗的字符数；0 表示不是数。/ Characters consumed; 0 if there is no number.
+ *
+ * @note 接受 strtod 的全部语法（不跳过前导空白），结果与 strtod 逐位一致；与 scanf("%lf") 相同，
+ *       下溢（次正规数或 0）与上溢（±HUGE_VAL）照常返回。
+ *       Accepts the whole strtod syntax (without skipping leading whitespace)
+ *       and is bit-identical to strtod; as with scanf("%lf"), underflow
+ *       (subnormal or 0) and overflow (±HUGE_VAL) are returned as usual.
+ */
+size_t num_scan_double(const char *s, size_t len, double *out)
+{
+    return num_scan(s, len, out, 0);
+}
+
+/**
+ * @brief 解析十进制数前缀，拒绝超出范围的值 / Parse a decimal number prefix, rejecting out-of-range values.
+ *
+ * @param s 文本，不要求以 NUL 结尾 / Text, need not be NUL-terminated
+ * @param len 文本长度 / Text length
+ * @param out 解析结果 / Parsed value
+ * @return 消耗的字符数；0 表示不是数或超出范围（ERANGE）。
+ *         Characters consumed; 0 if there is no number or it is out of range (ERANGE).
+ *
+ * @note 同 num_scan_double()，但与 strtod 加 errno 检查相同，ERANGE 时返回 0。
+ *       As num_scan_double(), but like strtod with an errno check it returns 0 on ERANGE.
+ */
+size_t num_scan_double_strict(const char *s, size_t len, double *out)
+{
+    return num_scan(s, len, out, 1);
+}
+
+/**
+ * @brief 解析整个记号为 double / Parse a whole token as a double.
+ *
+ * @param s 记号 / Token
+ * @param len 记号长度 / Token length
+ * @param out 解析结果 / Parsed value
+ * @return 0 表示成功；非 0 表示不是数、有多余字符或超出范围。
+ *         0 on success; non-zero if it is not a number, has trailing characters or is out of range.
+ */
+int num_parse_double(const char *s, size_t len, double *out)
+{
+    if (len == 0 || num_scan_double_strict(s, len, out) != len)
+        return -1;
+    return 0;
+}
+
+/**
+ * @brief 解析整个记号为非负整数 / Parse a whole token as a non-negative integer.
+ *
+ * @param s 记号，只含十进制数字 / Token of decimal digits only
+ * @param len 记号长度 / Token length
+ * @param out 解析结果 / Parsed value
+ * @return 0 表示成功；非 0 表示非法或溢出。
+ *         0 on success; non-zero if invalid or overflowing.
+ */
+int num_parse_size(const char *s, size_t len, size_t *out)
+{
+    size_t v = 0;
+
+    if (s == NULL || out == NULL || len == 0)
+        return -1;
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (s[i] < '0' || s[i] > '9')
+            return -1;
+        size_t d = (size_t)(s[i] - '0');
+        if (v > (SIZE_MAX - d) / 10)
+            return -1;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return 0;
+}
+
+#if NUM_FAST
+/* 内部工具：精确乘积 a·b = p + e（Dekker 分裂）/ exact product a·b = p + e (Dekker split) */
+static double num_two_prod(double a, double b, double *e)
+{
+    const double split = 134217729.0; /* 2^27 + 1 */
+    double p = a * b;
+    double ca = split * a, cb = split * b;
+    double ah = ca - (ca - a), al = a - ah;
+    double bh = cb - (cb - b), bl = b - bh;
+    *e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;
+}
+
+/* 内部工具：把 av·10^s 舍入到整数，平局取偶 / round av·10^s to an integer, ties to even */
+static int num_round_scaled(double av, int s, uint64_t *n)
+{
+    double hi, lo;
+
+    if (s >= 0)
+    {
+        hi = num_two_prod(av, num_p10[s], &lo);
+    }
+    else
+    {
+        /* 正确舍入商的余数精确可表示，其符号即误差方向 / the remainder of a correctly rounded quotient is exact; its sign gives the error direction */
+        double pl;
+        hi = av / num_p10[-s];
+        double ph = num_two_prod(hi, num_p10[-s], &pl);
+        lo = (av - ph) - pl;
+    }
+    if (!(hi < 9007199254740992.0)) /* 2^53：此后整数不再精确 / integers stop being exact */
+        return -1;
+
+    /* hi 是 ulp(hi) ≤ 1 的整数倍且 |hi - 真值| ≤ ulp(hi)/2，只有小数部分恰为 0.5 时需要 lo 决定舍入。
+     * hi is a multiple of ulp(hi) ≤ 1 within ulp(hi)/2 of the true value, so
+     * lo only decides the rounding when the fraction is exactly 0.5. */
+    uint64_t m = (uint64_t)hi;
+    double frac = hi - (double)m;
+    if (frac > 0.5 || (frac == 0.5 && (lo > 0.0 || (lo == 0.0 && (m & 1u) != 0))))
+        ++m;
+    *n = m;
+    return 0;
+}
+#endif
+
+/* 内部工具：写出十进制指数 e±XX / write a decimal exponent e±XX */
+static char *num_put_exp(char *p, int x)
+{
+    *p++ = 'e';
+    *p++ = (x < 0) ? '-' : '+';
+    if (x < 0)
+        x = -x;
+    if (x >= 100)
+    {
+        *p++ = (char)('0' + x / 100);
+        x %= 100;
+    }
+    *p++ = (char)('0' + x / 10);
+    *p++ = (char)('0' + x % 10);
+    return p;
+}
+
+/**
+ * @brief 按 %.Pg 格式化 / Format as %.Pg.
+ *
+ * @param buf 输出缓冲，至少 NUM_FORMAT_MAX 字节 / Output buffer of at least NUM_FORMAT_MAX bytes
+ * @param v 数值 / Value
+ * @param prec 有效数字位数，同 printf 的精度 / Significant digits, as printf's precision
+ * @return 写入的字符数（不含 NUL）/ Characters written, NUL excluded
+ *
+ * @note 输出与 snprintf(buf, n, "%.*g", prec, v) 逐字节一致。
+ *       The output is byte-identical to snprintf(buf, n, "%.*g", prec, v).
+ */
+size_t num_format_g(char *buf, double v, int prec)
+{
+    if (prec <= 0)
+        prec = 1;
+
+#if NUM_FAST
+    if (prec <= NUM_FAST_PREC && isfinite(v))
+    {
+        char *p = buf;
+        if (signbit(v))
+            *p++ = '-';
+        double av = fabs(v);
+        if (av == 0.0)
+        {
+            *p++ = '0';
+            *p = '\0';
+            return (size_t)(p - buf);
+        }
+
+        /* 先由二进制指数估计十进制指数，再按舍入结果校正 / estimate the decimal exponent from the binary one, then fix it up */
+        uint64_t bits;
+        memcpy(&bits, &av, sizeof(bits));
+        int e2 = (int)(bits >> 52) - 1023;
+        /* ⌊e2·log10(2)⌋，负数按向下取整 / floor(e2·log10(2)), rounding down for negatives too */
+        int k = (e2 >= 0) ? (e2 * 78913) >> 18 : -((-e2 * 78913 + (1 << 18) - 1) >> 18);
+        uint64_t n = 0;
+        int ok = 0;
+        for (int tries = 0; tries < 3 && !ok; ++tries)
+        {
+            int s = prec - 1 - k;
+            if (s < -22 || s > 22)
+                break;
+            if (num_round_scaled(av, s, &n) != 0 || n >= num_u10[prec])
+                ++k;
+            else if (n < num_u10[prec - 1])
+                --k;
+            else
+                ok = 1;
+        }
+
+        if (ok)
+        {
+            char d[NUM_FAST_PREC + 1];
+            int i = prec;
+            while (i >= 2)
+            {
+                memcpy(d + i - 2, num_digits2 + 2 * (n % 100), 2);
+                n /= 100;
+                i -= 2;
+            }
+            if (i == 1)
+                d[0] = (char)('0' + n);
+            int nd = prec;
+            while (nd > 1 && d[nd - 1] == '0')
+                --nd;
+
+            if (k < -4 || k >= prec)
+            {
+                *p++ = d[0];
+                if (nd > 1)
+                {
+                    *p++ = '.';
+                    memcpy(p, d + 1, (size_t)(nd - 1));
+                    p += nd - 1;
+                }
+                p = num_put_exp(p, k);
+            }
+            else if (k >= 0)
+            {
+                memcpy(p, d, (size_t)(k + 1));
+                p += k + 1;
+                if (nd > k + 1)
+                {
+                    *p++ = '.';
+                    memcpy(p, d + k + 1, (size_t)(nd - k - 1));
+                    p += nd - k - 1;
+                }
+            }
+            else
+            {
+                *p++ = '0';
+                *p++ = '.';
+                for (int i = 0; i < -k - 1; ++i)
+                    *p++ = '0';
+                memcpy(p, d, (size_t)nd);
+                p += nd;
+            }
+            *p = '\0';
+            return (size_t)(p - buf);
+        }
+    }
+#endif
+
+    int r = snprintf(buf, NUM_FORMAT_MAX, "%.*g", prec, v);
+    if (r < 0)
+    {
+        buf[0] = '\0';
+        return 0;
+    }
+    return ((size_t)r < NUM_FORMAT_MAX) ? (size_t)r : NUM_FORMAT_MAX - 1;
+}
+
+/**
+ * @brief 初始化记号读取器 / Initialize a token reader.
+ *
+ * @param r 读取器 / Reader
+ * @param fp 输入流 / Input stream
+ * @param cap 缓冲大小，0 取 NUM_READER_BLOCK；也是单个记号的最大长度 / Buffer size, 0 for NUM_READER_BLOCK; also the longest token
+ * @return 0 表示成功；非 0 表示参数非法或内存不足。
+ *         0 on success; non-zero on invalid arguments or allocation failure.
+ */
+int num_reader_init(num_reader_t *r, FILE *fp, size_t cap)
+{
+    if (r == NULL || fp == NULL)
+    {
+        fprintf(stderr, "num_reader_init: null pointer argument.\n");
+        return -1;
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->cap = (cap != 0) ? cap : NUM_READER_BLOCK;
+    r->buf = (char *)malloc(r->cap + 1);
+    if (r->buf == NULL)
+    {
+        fprintf(stderr, "num_reader_init: failed to allocate buffer.\n");
+        return -1;
+    }
+    r->buf[0] = '\0';
+    r->fp = fp;
+    return 0;
+}
+
+/**
+ * @brief 释放读取器 / Free a reader.
+ *
+ * @param r 读取器，可以为 NULL / Reader, may be NULL
+ */
+void num_reader_free(num_reader_t *r)
+{
+    if (r == NULL)
+        return;
+    free(r->buf);
+    memset(r, 0, sizeof(*r));
+}
+
+/* 内部工具：追加一行（或填满缓冲）/ append one line, or as much as fits */
+static void num_reader_fill(num_reader_t *r)
+{
+    size_t room = r->cap + 1 - r->len;
+    if (room > INT_MAX)
+        room = INT_MAX;
+    if (fgets(r->buf + r->len, (int)room, r->fp) == NULL)
+    {
+        r->eof = 1;
+        r->buf[r->len] = '\0';
+        return;
+    }
+    r->len += strlen(r->buf + r->len);
+}
+
+/* 内部工具：把 pos 起的未读数据移到开头再续读 / move the unread data from pos to the front and read on */
+static int num_reader_refill(num_reader_t *r)
+{
+    size_t n = r->len - r->pos;
+    if (n == r->cap)
+    {
+        fprintf(stderr, "num_reader: token longer than %zu bytes.\n", r->cap);
+        return -1;
+    }
+    memmove(r->buf, r->buf + r->pos, n);
+    r->pos = 0;
+    r->len = n;
+    r->buf[n] = '\0';
+    num_reader_fill(r);
+    return 0;
+}
+
+/* 内部工具：跳过空白，返回下一个记号的起点 / skip whitespace and return where the next token starts */
+static size_t num_reader_skip(num_reader_t *r)
+{
+    /* buf[len] 恒为 NUL 哨兵，扫描不必再比较边界 / buf[len] is always the NUL sentinel, so scans need no bound checks */
+    const unsigned char *b = (const unsigned char *)r->buf;
+    size_t p = r->pos;
+    while (num_class[b[p]] == 1)
+        ++p;
+    r->pos = p;
+    return p;
+}
+
+/**
+ * @brief 读取下一个空白分隔记号 / Read the next whitespace-separated token.
+ *
+ * @param r 读取器 / Reader
+ * @param tok 记号起点，指向读取器缓冲，下次读取前有效 / Token start inside the reader buffer, valid until the next read
+ * @param len 记号长度 / Token length
+ * @return 0 表示读到记号；1 表示输入结束；-1 表示记号长于缓冲。
+ *         0 for a token; 1 at end of input; -1 if a token is longer than the buffer.
+ */
+int num_read_token(num_reader_t *r, const char **tok, size_t *len)
+{
+    if (r == NULL || r->buf == NULL || tok == NULL || len == NULL)
+        return -1;
+
+    for (;;)
+    {
+        const unsigned char *b = (const unsigned char *)r->buf;
+        size_t p = num_reader_skip(r);
+
+        if (p == r->len && r->eof)
+            return 1;
+        size_t e = p;
+        while (num_class[b[e]] == 0)
+            ++e;
+        if (p < r->len && (e < r->len || r->eof))
+        {
+            *tok = r->buf + p;
+            *len = e - p;
+            r->pos = e;
+            return 0;
+        }
+        /* 没有数据或记号可能被缓冲末尾截断 / no data, or the token may be cut by the buffer end */
+        if (num_reader_refill(r) != 0)
+            return -1;
+    }
+}
+
+/**
+ * @brief 读取下一个数 / Read the next number.
+ *
+ * @param r 读取器 / Reader
+ * @param out 解析结果 / Parsed value
+ * @return 0 表示成功；1 表示输入结束；-1 表示下一个记号不是数，该记号不被消耗，
+ *         可再用 num_read_token() 取出（例如检查 END 之类的结束记号）。
+ *         0 on success; 1 at end of input; -1 if the next token is not a
+ *         number, in which case it is left unread for num_read_token()
+ *         (e.g. to check for an END marker).
+ *
+ * @note 直接在缓冲上边解析边定界，每个字节只扫描一次。
+ *       Parses in place while finding the token end, so each byte is scanned once.
+ */
+int num_read_double(num_reader_t *r, double *out)
+{
+    if (r == NULL || r->buf == NULL || out == NULL)
+        return -1;
+
+    for (;;)
+    {
+        const unsigned char *b = (const unsigned char *)r->buf;
+        size_t p = num_reader_skip(r);
+
+        if (p == r->len)
+        {
+            if (r->eof)
+                return 1;
+        }
+        else
+        {
+            double v;
+            size_t e = p + num_scan_double(r->buf + p, r->len - p, &v);
+            if (e > p && num_class[b[e]] != 0 && (e < r->len || r->eof))
+            {
+                r->pos = e;
+                *out = v;
+                return 0;
+            }
+            while (num_class[b[e]] == 0)
+                ++e;
+            if (e < r->len || r->eof)
+                return -1;
+        }
+        if (num_reader_refill(r) != 0)
+            return -1;
+    }
+}
+
+/**
+ * @brief 读取下一个非负整数 / Read the next non-negative integer.
+ *
+ * @param r 读取器 / Reader
+ * @param out 解析结果 / Parsed value
+ * @return 0 表示成功；1 表示输入结束；-1 表示记号不是非负整数。
+ *         0 on success; 1 at end of input; -1 if the token is not a non-negative integer.
+ */
+int num_read_size(num_reader_t *r, size_t *out)
+{
+    const char *tok;
+    size_t len;
+    int rc = num_read_token(r, &tok, &len);
+    if (rc != 0)
+        return rc;
+    return (num_parse_size(tok, len, out) == 0) ? 0 : -1;
+}
+
+/**
+ * @brief 初始化写出器 / Initialize a writer.
+ *
+ * @param w 写出器 / Writer
+ * @param fp 输出流 / Output stream
+ */
+void num_writer_init(num_writer_t *w, FILE *fp)
+{
+    w->fp = fp;
+    w->len = 0;
+    w->err = 0;
+}
+
+/**
+ * @brief 以 %.Pg 写出一个数 / Write one number as %.Pg.
+ *
+ * @param w 写出器 / Writer
+ * @param v 数值 / Value
+ * @param prec 有效数字位数 / Significant digits
+ */
+void num_write_g(num_writer_t *w, double v, int prec)
+{
+    if (w->len + NUM_FORMAT_MAX > NUM_WRITER_BLOCK)
+        num_writer_flush(w);
+    w->len += num_format_g(w->buf + w->len, v, prec);
+}
+
+/**
+ * @brief 写出一个字符 / Write one character.
+ *
+ * @param w 写出器 / Writer
+ * @param c 字符 / Character
+ */
+void num_write_char(num_writer_t *w, char c)
+{
+    if (w->len == NUM_WRITER_BLOCK)
+        num_writer_flush(w);
+    w->buf[w->len++] = c;
+}
+
+/**
+ * @brief 把缓冲写到输出流 / Write the buffer out to the stream.
+ *
+ * @param w 写出器 / Writer
+ * @return 0 表示至今所有写出都成功；非 0 表示有写失败。
+ *         0 if every write so far succeeded; non-zero otherwise.
+ */
+int num_writer_flush(num_writer_t *w)
+{
+    if (w->len > 0 && fwrite(w->buf, 1, w->len, w->fp) != w->len)
+        w->err = 1;
+    w->len = 0;
+    return w->err ? -1 : 0;
+}
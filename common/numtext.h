@@ -0,0 +1,90 @@
+/**
+ * @file numtext.h
+ * @brief 文本数值的快速解析与格式化接口 / Fast text number parsing and formatting interface
+ *
+ * 1/、2/ 与 3/ 的文本路径共用：按块缓冲的空白分隔记号读取、与 strtod 逐位一致的
+ * 十进制解析，以及与 printf("%.Ng") 逐字节一致的格式化。常见输入走整数运算的快速路径，
+ * 其余（超长尾数、十六进制、inf/nan、极端指数）回退到 strtod / snprintf，因此结果不变。
+ * 超出范围（ERANGE）的值：num_scan_double 与它取代的 scanf("%lf") 一样照常返回，
+ * num_scan_double_strict / num_parse_double 与它们取代的 strtod 加 errno 检查一样拒绝。
+ * 快速路径只认 '.' 作小数点，不查询区域设置；程序不调用 setlocale，回退路径同样处于 C 区域。
+ * Shared by the text paths of 1/, 2/ and 3/: block-buffered reading of
+ * whitespace-separated tokens, decimal parsing bit-identical to strtod, and
+ * formatting byte-identical to printf("%.Ng"). Common inputs take a fast
+ * path; the rest (long mantissas, hex floats, inf/nan, extreme exponents)
+ * fall back to strtod / snprintf, so results never change. Out-of-range
+ * (ERANGE) values are returned by num_scan_double, as by the scanf("%lf")
+ * it replaces, and rejected by num_scan_double_strict / num_parse_double,
+ * as by the strtod-plus-errno checks they replace. The fast paths
+ * only know '.' and never consult the locale; the programs never call
+ * setlocale, so the fallbacks run in the C locale as well.
+ */
+
+#ifndef NUMTEXT_H
+#define NUMTEXT_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/** 读取器默认缓冲大小（字节）/ Default reader buffer size in bytes */
+#define NUM_READER_BLOCK (64 * 1024)
+
+/** 写出器缓冲大小（字节）/ Writer buffer size in bytes */
+#define NUM_WRITER_BLOCK 8192
+
+/** num_format_g 所需的最小缓冲（含结尾 NUL）/ Minimum buffer for num_format_g, NUL included */
+#define NUM_FORMAT_MAX 40
+
+/**
+ * @brief 空白分隔记号读取器 / Reader of whitespace-separated tokens
+ *
+ * @note 按行调用 fgets 填充缓冲，因此交互输入逐行即可处理，而整行大量样本的
+ *       输入一次填满缓冲。读取器会预读当前行，之后同一流不应再混用 scanf。
+ *       The buffer is refilled with fgets, so interactive input is handled
+ *       line by line while long lines of samples fill the buffer at once.
+ *       The reader consumes the current line ahead, so do not mix scanf on
+ *       the same stream afterwards.
+ */
+typedef struct
+{
+    FILE *fp;   /**< 输入流 / input stream */
+    char *buf;  /**< 缓冲区，末尾多留一个 NUL / buffer with room for a trailing NUL */
+    size_t cap; /**< 缓冲容量（不含 NUL）/ capacity without the NUL */
+    size_t pos; /**< 下一个未读字节 / next unread byte */
+    size_t len; /**< 有效字节数 / valid bytes */
+    int eof;    /**< 输入已结束 / input has ended */
+} num_reader_t;
+
+/**
+ * @brief 数值写出器：格式化到缓冲，满了或 flush 时整块 fwrite / Number writer: formats into a buffer, fwrite'd in blocks
+ *
+ * @note 与同一 FILE 上的 printf 交替使用前须先 num_writer_flush()。
+ *       Flush with num_writer_flush() before interleaving printf on the same FILE.
+ */
+typedef struct
+{
+    FILE *fp;                    /**< 输出流 / output stream */
+    size_t len;                  /**< 已缓冲字节数 / buffered bytes */
+    int err;                     /**< 是否有写失败 / whether a write failed */
+    char buf[NUM_WRITER_BLOCK];  /**< 缓冲区 / buffer */
+} num_writer_t;
+
+/* === 接口声明 (Function declarations) === */
+size_t num_scan_double(const char *s, size_t len, double *out);
+size_t num_scan_double_strict(const char *s, size_t len, double *out);
+int num_parse_double(const char *s, size_t len, double *out);
+int num_parse_size(const char *s, size_t len, size_t *out);
+size_t num_format_g(char *buf, double v, int prec);
+
+int num_reader_init(num_reader_t *r, FILE *fp, size_t cap);
+void num_reader_free(num_reader_t *r);
+int num_read_token(num_reader_t *r, const char **tok, size_t *len);
+int num_read_double(num_reader_t *r, double *out);
+int num_read_size(num_reader_t *r, size_t *out);
+
+void num_writer_init(num_writer_t *w, FILE *fp);
+void num_write_g(num_writer_t *w, double v, int prec);
+void num_write_char(num_writer_t *w, char c);
+int num_writer_flush(num_writer_t *w);
+
+#endif /* NUMTEXT_H */
@@ -0,0 +1,251 @@
+/**
+ * @file ring.c
+ * @brief 单生产者单消费者的无锁块环形缓冲实现 / Lock-free single-producer single-consumer block ring implementation
+ *
+ * head 与 tail 是只增不减的计数，槽号取低位；tail - head 即已提交未归还的槽数。
+ * 提交以 release 写 tail、取出以 acquire 读 tail（归还与取得空槽对 head 同理），
+ * 因此槽内容在对端看到新下标时已经可见。
+ * head and tail are counters that only grow, and the slot is their low bits;
+ * tail - head is the number of committed slots not yet released. Committing
+ * stores tail with release and peeking loads it with acquire (likewise for
+ * head on release and acquire), so a slot's contents are visible by the time
+ * the other side sees the new index.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "ring.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+/* 等待时先自旋的次数，再让出 CPU 的次数 / spins, then yields, before a waiting side starts sleeping */
+#define RING_SPINS 64
+#define RING_YIELDS 64
+
+/* 内部工具：等待一轮，越等越久 / wait one round, longer the longer it has waited */
+static void ring_backoff(unsigned *rounds)
+{
+    if (*rounds < RING_SPINS)
+    {
+        ++*rounds;
+        return;
+    }
+    if (*rounds < RING_SPINS + RING_YIELDS)
+    {
+        ++*rounds;
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+        return;
+    }
+    /* 对端明显更慢（如终端输出）：休眠而不是空转 / the other side is clearly slower (e.g. a terminal): sleep rather than spin */
+#ifdef _WIN32
+    Sleep(1);
+#else
+    struct timespec ts = {0, 50000};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/**
+ * @brief 初始化环 / Initialize a ring.
+ *
+ * @param r 环 / Ring
+ * @param slots 槽数，向上取到 2 的幂（至少 2）/ Slot count, rounded up to a power of two (at least 2)
+ * @param slot_size 每槽字节数 / Bytes per slot
+ * @return 0 表示成功；非 0 表示参数非法或内存不足。
+ *         0 on success; non-zero on invalid arguments or allocation failure.
+ */
+int ring_init(ring_t *r, size_t slots, size_t slot_size)
+{
+    if (r == NULL || slots == 0 || slot_size == 0)
+    {
+        fprintf(stderr, "ring_init: invalid arguments.\n");
+        return -1;
+    }
+
+    size_t n = 2;
+    while (n < slots && n <= SIZE_MAX / 4)
+        n <<= 1;
+    if (n < slots || slot_size > SIZE_MAX - (RING_CACHE_LINE - 1))
+    {
+        fprintf(stderr, "ring_init: ring too large.\n");
+        return -1;
+    }
+    size_t stride = (slot_size + RING_CACHE_LINE - 1) / RING_CACHE_LINE * RING_CACHE_LINE;
+    if (stride > (SIZE_MAX - RING_CACHE_LINE) / n)
+    {
+        fprintf(stderr, "ring_init: ring too large.\n");
+        return -1;
+    }
+
+    r->mem = malloc(n * stride + RING_CACHE_LINE);
+    r->lens = (size_t *)calloc(n, sizeof(size_t));
+    if (r->mem == NULL || r->lens == NULL)
+    {
+        fprintf(stderr, "ring_init: failed to allocate %zu slots of %zu bytes.\n", n, slot_size);
+        free(r->mem);
+        free(r->lens);
+        r->mem = NULL;
+        r->lens = NULL;
+        return -1;
+    }
+
+    uintptr_t base = (uintptr_t)r->mem;
+    base = (base + RING_CACHE_LINE - 1) / RING_CACHE_LINE * RING_CACHE_LINE;
+    r->slots = (unsigned char *)base;
+    r->stride = stride;
+    r->mask = n - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->closed, 0);
+    atomic_init(&r->aborted, 0);
+    r->tail_seen = 0;
+    r->head_seen = 0;
+    r->status = 0;
+    return 0;
+}
+
+/**
+ * @brief 释放环，两端线程都须已停止使用 / Free a ring once neither thread uses it any more.
+ *
+ * @param r 环，可以为 NULL / Ring, may be NULL
+ */
+void ring_free(ring_t *r)
+{
+    if (r == NULL)
+        return;
+    free(r->mem);
+    free(r->lens);
+    r->mem = NULL;
+    r->slots = NULL;
+    r->lens = NULL;
+}
+
+/**
+ * @brief 生产者：取得下一个空槽，环满时等待 / Producer: get the next free slot, waiting while the ring is full.
+ *
+ * @param r 环 / Ring
+ * @return 槽起点（按缓存行对齐）；消费者已 ring_abort() 时为 NULL。
+ *         Start of the slot (cache-line aligned); NULL once the consumer has called ring_abort().
+ *
+ * @note 提交前再次调用返回同一个槽，因此可以取得槽后决定不提交。
+ *       Calling again before committing returns the same slot, so a slot may be acquired and then left uncommitted.
+ */
+void *ring_acquire(ring_t *r)
+{
+    const size_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    unsigned rounds = 0;
+
+    for (;;)
+    {
+        if (atomic_load_explicit(&r->aborted, memory_order_acquire))
+            return NULL;
+        if (t - r->head_seen <= r->mask)
+            break;
+        r->head_seen = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (t - r->head_seen <= r->mask)
+            break;
+        ring_backoff(&rounds);
+    }
+    return r->slots + (t & r->mask) * r->stride;
+}
+
+/**
+ * @brief 生产者：提交 ring_acquire() 取得的槽 / Producer: commit the slot from ring_acquire().
+ *
+ * @param r 环 / Ring
+ * @param n 槽中的元素数，原样交给消费者 / Elements in the slot, handed to the consumer as is
+ */
+void ring_commit(ring_t *r, size_t n)
+{
+    const size_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    r->lens[t & r->mask] = n;
+    atomic_store_explicit(&r->tail, t + 1, memory_order_release);
+}
+
+/**
+ * @brief 生产者：不再提交，已提交的槽仍会被取走 / Producer: no more commits; committed slots are still delivered.
+ *
+ * @param r 环 / Ring
+ * @param status 0 表示正常结束，非 0 表示失败，消费者由 ring_status() 读取。
+ *               0 for a normal end, non-zero for a failure; the consumer reads it with ring_status().
+ */
+void ring_close(ring_t *r, int status)
+{
+    r->status = status;
+    atomic_store_explicit(&r->closed, 1, memory_order_release);
+}
+
+/**
+ * @brief 消费者：取得下一个已提交槽，环空时等待 / Consumer: get the next committed slot, waiting while the ring is empty.
+ *
+ * @param r 环 / Ring
+ * @param n 槽中的元素数 / Elements in the slot
+ * @return 槽起点；生产者已 ring_close() 且槽已取完时为 NULL。
+ *         Start of the slot; NULL once the producer has closed the ring and every slot was taken.
+ */
+const void *ring_peek(ring_t *r, size_t *n)
+{
+    const size_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned rounds = 0;
+
+    while (h == r->tail_seen)
+    {
+        /* 先读 closed 再读 tail：关闭前的最后一次提交不会漏掉 / closed before tail, so the last commit before closing is never missed */
+        const int closed = atomic_load_explicit(&r->closed, memory_order_acquire);
+        r->tail_seen = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (h != r->tail_seen)
+            break;
+        if (closed)
+            return NULL;
+        ring_backoff(&rounds);
+    }
+    *n = r->lens[h & r->mask];
+    return r->slots + (h & r->mask) * r->stride;
+}
+
+/**
+ * @brief 消费者：归还 ring_peek() 取得的槽 / Consumer: release the slot from ring_peek().
+ *
+ * @param r 环 / Ring
+ */
+void ring_release(ring_t *r)
+{
+    const size_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+}
+
+/**
+ * @brief 消费者：提前退出，之后生产者的 ring_acquire() 返回 NULL / Consumer: leave early; the producer's ring_acquire() then returns NULL.
+ *
+ * @param r 环 / Ring
+ */
+void ring_abort(ring_t *r)
+{
+    atomic_store_explicit(&r->aborted, 1, memory_order_release);
+}
+
+/**
+ * @brief 消费者：ring_peek() 返回 NULL 后读取生产者的结束状态 / Consumer: the producer's final status once ring_peek() returned NULL.
+ *
+ * @param r 环 / Ring
+ * @return ring_close() 的状态 / Status given to ring_close()
+ */
+int ring_status(const ring_t *r)
+{
+    return r->status;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file ring.h
+ * @brief 单生产者单消费者的无锁块环形缓冲接口 / Lock-free single-producer single-consumer block ring interface
+ *
+ * 2/ 与 3/ 的流式 CLI 用它连接输入、计算、输出三个线程。环中是固定个数、固定字节数的槽，
+ * 生产者取得空槽、原地填入后提交，消费者按序取出、用完后归还，全程不复制样本也不加锁：
+ * 两端各自只写自己的下标（分处不同缓存行），并缓存对端下标，只有看似满或空时才重新读取。
+ * 环满时生产者等待，环空时消费者等待，即背压；等待先自旋、再让出 CPU、最后短暂休眠。
+ * The streaming CLIs of 2/ and 3/ use it to connect their input, compute and
+ * output threads. The ring holds a fixed number of fixed-size slots: the
+ * producer acquires a free slot, fills it in place and commits it; the
+ * consumer takes slots in order and releases them when done. No samples are
+ * copied and no locks are taken: each side only writes its own index (on its
+ * own cache line) and caches the other one, re-reading it only when the ring
+ * looks full or empty. A full ring makes the producer wait and an empty one
+ * makes the consumer wait, which is the backpressure; waiting spins first,
+ * then yields the CPU, then sleeps briefly.
+ *
+ * @note 每个环恰好一个生产者线程与一个消费者线程。生产者以 ring_close() 结束（可带失败状态），
+ *       消费者以 ring_abort() 提前退出，此后生产者的 ring_acquire() 返回 NULL。
+ *       Exactly one producer thread and one consumer thread per ring. The
+ *       producer ends with ring_close() (optionally with a failure status);
+ *       the consumer leaves early with ring_abort(), after which the
+ *       producer's ring_acquire() returns NULL.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/** 缓存行大小（字节），用于隔开两端的下标 / Cache line size in bytes, used to keep the two indices apart */
+#define RING_CACHE_LINE 64
+
+/**
+ * @brief 块环形缓冲 / Block ring
+ */
+typedef struct
+{
+    void *mem;             /**< 分配的内存 / allocated memory */
+    unsigned char *slots;  /**< 按缓存行对齐的槽存储，每槽 stride 字节 / cache-aligned slot storage, stride bytes per slot */
+    size_t *lens;          /**< 各槽提交的元素数 / elements committed to each slot */
+    size_t stride;         /**< 槽间距（按缓存行取整）/ slot pitch, rounded to a cache line */
+    size_t mask;           /**< 槽数减一（槽数为 2 的幂）/ slot count minus one (a power of two) */
+
+    _Alignas(RING_CACHE_LINE) atomic_size_t head; /**< 下一个待读槽，消费者写 / next slot to read, written by the consumer */
+    size_t tail_seen;                             /**< 消费者缓存的 tail / the consumer's copy of tail */
+
+    _Alignas(RING_CACHE_LINE) atomic_size_t tail; /**< 下一个待写槽，生产者写 / next slot to write, written by the producer */
+    size_t head_seen;                             /**< 生产者缓存的 head / the producer's copy of head */
+    int status;                                   /**< ring_close() 的状态 / status given to ring_close() */
+
+    _Alignas(RING_CACHE_LINE) atomic_int closed;  /**< 生产者已结束 / the producer has finished */
+    atomic_int aborted;                           /**< 消费者已退出 / the consumer has left */
+} ring_t;
+
+/* === 接口声明 (Function declarations) === */
+int ring_init(ring_t *r, size_t slots, size_t slot_size);
+void ring_free(ring_t *r);
+
+void *ring_acquire(ring_t *r);
+void ring_commit(ring_t *r, size_t n);
+void ring_close(ring_t *r, int status);
+
+const void *ring_peek(ring_t *r, size_t *n);
+void ring_release(ring_t *r);
+void ring_abort(ring_t *r);
+int ring_status(const ring_t *r);
+
+#endif /* RING_H */
@@ -0,0 +1,430 @@
+/**
+ * @file snapio.c
+ * @brief 状态快照的二进制编解码实现 / Binary encoding implementation for state snapshots
+ *
+ * 快照布局：4 字节魔数、u32 版本号、调用方字段、8 字节 FNV-1a 校验（覆盖此前全部字节）。
+ * 写文件时先写到 "<path>.tmp" 再改名覆盖，进程在写入途中退出也不会留下半个快照。
+ * Snapshot layout: a 4-byte magic, a u32 version, the caller's fields and an
+ * 8-byte FNV-1a checksum over every byte before it. Files are written to
+ * "<path>.tmp" first and renamed over the target, so a process dying halfway
+ * through a write never leaves half a snapshot behind.
+ */
+
+#include "snapio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FNV-1a 64 位乘数 / FNV-1a 64-bit prime */
+#define SNAP_FNV_PRIME 0x100000001b3ULL
+
+/* 内部工具：主机是否为小端 / whether the host is little-endian */
+static int snap_host_le(void)
+{
+    const uint16_t one = 1;
+    unsigned char b;
+    memcpy(&b, &one, 1);
+    return b == 1;
+}
+
+/* 内部工具：追加 n 字节的小端整数 / append an n-byte little-endian integer */
+static void snap_put_le(snap_writer_t *w, uint64_t v, size_t n)
+{
+    if (w->buf != NULL && w->len + n <= w->cap)
+    {
+        for (size_t i = 0; i < n; ++i)
+            w->buf[w->len + i] = (unsigned char)(v >> (8 * i));
+    }
+    w->len += n;
+}
+
+/* 内部工具：读取 n 字节的小端整数，越界时置 fail / read an n-byte little-endian integer, setting fail past the end */
+static uint64_t snap_get_le(snap_reader_t *r, size_t n)
+{
+    uint64_t v = 0;
+    if (r->fail || r->len - r->pos < n)
+    {
+        r->fail = 1;
+        return 0;
+    }
+    for (size_t i = 0; i < n; ++i)
+        v |= (uint64_t)r->buf[r->pos + i] << (8 * i);
+    r->pos += n;
+    return v;
+}
+
+/**
+ * @brief FNV-1a 64 位校验 / FNV-1a 64-bit checksum.
+ *
+ * @param p 数据 / Data
+ * @param n 字节数 / Byte count
+ * @return 校验值 / Checksum
+ */
+uint64_t snap_checksum(const unsigned char *p, size_t n)
+{
+    return snap_checksum_update(SNAP_CHECKSUM_INIT, p, n);
+}
+
+/**
+ * @brief 在已有校验值上续算 / Continue a checksum over more bytes.
+ *
+ * 分段续算与对拼接后的字节一次计算结果相同。
+ * Updating piecewise gives the same value as one pass over the concatenated bytes.
+ *
+ * @param h 此前的校验值（首段为 SNAP_CHECKSUM_INIT）/ Checksum so far (SNAP_CHECKSUM_INIT for the first piece)
+ * @param p 数据 / Data
+ * @param n 字节数 / Byte count
+ * @return 新的校验值 / Updated checksum
+ */
+uint64_t snap_checksum_update(uint64_t h, const unsigned char *p, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= SNAP_FNV_PRIME;
+    }
+    return h;
+}
+
+/**
+ * @brief 初始化写入端 / Initialize a writer.
+ *
+ * @param w 写入端 / Writer
+ * @param buf 目标缓冲，NULL 表示只计数 / Destination, NULL to count only
+ * @param cap 缓冲容量 / Buffer capacity
+ */
+void snap_writer_init(snap_writer_t *w, unsigned char *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = (buf != NULL) ? cap : 0;
+    w->len = 0;
+}
+
+/**
+ * @brief 写入魔数与版本号 / Write the magic and the version.
+ *
+ * @param w 写入端 / Writer
+ * @param magic 4 字节魔数 / 4-byte magic
+ * @param version 格式版本 / Format version
+ */
+void snap_put_header(snap_writer_t *w, const char magic[4], uint32_t version)
+{
+    for (size_t i = 0; i < 4; ++i)
+        snap_put_le(w, (unsigned char)magic[i], 1);
+    snap_put_u32(w, version);
+}
+
+/** @brief 写入 u16 / Write a u16. */
+void snap_put_u16(snap_writer_t *w, uint16_t v)
+{
+    snap_put_le(w, v, 2);
+}
+
+/** @brief 写入 u32 / Write a u32. */
+void snap_put_u32(snap_writer_t *w, uint32_t v)
+{
+    snap_put_le(w, v, 4);
+}
+
+/** @brief 写入 u64 / Write a u64. */
+void snap_put_u64(snap_writer_t *w, uint64_t v)
+{
+    snap_put_le(w, v, 8);
+}
+
+/** @brief 按位模式写入 float / Write a float by its bit pattern. */
+void snap_put_f32(snap_writer_t *w, float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    snap_put_le(w, bits, 4);
+}
+
+/** @brief 按位模式写入 double / Write a double by its bit pattern. */
+void snap_put_f64(snap_writer_t *w, double v)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    snap_put_le(w, bits, 8);
+}
+
+/**
+ * @brief 写入 n 个 double；小端主机上整段复制 / Write n doubles, one block copy on little-endian hosts.
+ *
+ * @param w 写入端 / Writer
+ * @param v 数据，n 为 0 时可为 NULL / Data, may be NULL when n is 0
+ * @param n 个数 / Count
+ */
+void snap_put_f64s(snap_writer_t *w, const double *v, size_t n)
+{
+    if (n == 0)
+        return;
+    if (snap_host_le())
+    {
+        if (w->buf != NULL && w->len + n * sizeof(double) <= w->cap)
+            memcpy(w->buf + w->len, v, n * sizeof(double));
+        w->len += n * sizeof(double);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i)
+        snap_put_f64(w, v[i]);
+}
+
+/**
+ * @brief 追加校验尾 / Append the checksum trailer.
+ *
+ * @param w 写入端 / Writer
+ * @param len 输出：快照总字节数（含校验尾）/ Out: total snapshot bytes, trailer included
+ * @return 0 表示成功；缓冲不足时返回 -1（len 仍给出所需大小）。
+ *         0 on success; -1 if the buffer was too small (len still gives the size needed).
+ */
+int snap_writer_finish(snap_writer_t *w, size_t *len)
+{
+    const size_t body = w->len;
+    const int fits = (w->buf != NULL && body + SNAP_CHECKSUM_BYTES <= w->cap);
+
+    snap_put_u64(w, fits ? snap_checksum(w->buf, body) : 0);
+    if (len != NULL)
+        *len = w->len;
+    return fits ? 0 : -1;
+}
+
+/**
+ * @brief 初始化读取端并核对校验尾 / Initialize a reader and verify the checksum trailer.
+ *
+ * @param r 读取端 / Reader
+ * @param buf 快照 / Snapshot
+ * @param len 快照字节数（含校验尾）/ Snapshot bytes, trailer included
+ * @return 0 表示校验通过；过短或校验不符时返回 -1。
+ *         0 if the checksum matches; -1 if the snapshot is too short or does not match.
+ */
+int snap_reader_init(snap_reader_t *r, const unsigned char *buf, size_t len)
+{
+    r->buf = buf;
+    r->len = 0;
+    r->pos = 0;
+    r->fail = 1;
+    if (buf == NULL || len < 8 + SNAP_CHECKSUM_BYTES)
+        return -1;
+
+    r->len = len;
+    r->pos = len - SNAP_CHECKSUM_BYTES;
+    r->fail = 0;
+    const uint64_t want = snap_get_le(r, SNAP_CHECKSUM_BYTES);
+    r->len = len - SNAP_CHECKSUM_BYTES;
+    r->pos = 0;
+    if (snap_checksum(buf, r->len) != want)
+    {
+        r->fail = 1;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 核对魔数并读取版本号 / Check the magic and read the version.
+ *
+ * @param r 读取端 / Reader
+ * @param magic 期望的 4 字节魔数 / Expected 4-byte magic
+ * @param version 输出：格式版本 / Out: format version
+ * @return 0 表示魔数一致；否则返回 -1。0 if the magic matches, else -1.
+ */
+int snap_get_header(snap_reader_t *r, const char magic[4], uint32_t *version)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (snap_get_le(r, 1) != (unsigned char)magic[i])
+        {
+            r->fail = 1;
+            return -1;
+        }
+    }
+    *version = snap_get_u32(r);
+    return r->fail ? -1 : 0;
+}
+
+/** @brief 读取 u16 / Read a u16. */
+uint16_t snap_get_u16(snap_reader_t *r)
+{
+    return (uint16_t)snap_get_le(r, 2);
+}
+
+/** @brief 读取 u32 / Read a u32. */
+uint32_t snap_get_u32(snap_reader_t *r)
+{
+    return (uint32_t)snap_get_le(r, 4);
+}
+
+/** @brief 读取 u64 / Read a u64. */
+uint64_t snap_get_u64(snap_reader_t *r)
+{
+    return snap_get_le(r, 8);
+}
+
+/** @brief 按位模式读取 float / Read a float by its bit pattern. */
+float snap_get_f32(snap_reader_t *r)
+{
+    const uint32_t bits = (uint32_t)snap_get_le(r, 4);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/** @brief 按位模式读取 double / Read a double by its bit pattern. */
+double snap_get_f64(snap_reader_t *r)
+{
+    const uint64_t bits = snap_get_le(r, 8);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief 读取 n 个 double / Read n doubles.
+ *
+ * @param r 读取端 / Reader
+ * @param dst 目标，NULL 表示只跳过（用于先校验后写入）/ Destination, NULL to skip (to validate before writing)
+ * @param n 个数 / Count
+ */
+void snap_get_f64s(snap_reader_t *r, double *dst, size_t n)
+{
+    if (r->fail || (r->len - r->pos) / sizeof(double) < n)
+    {
+        r->fail = 1;
+        return;
+    }
+    if (dst == NULL)
+    {
+        r->pos += n * sizeof(double);
+        return;
+    }
+    if (snap_host_le())
+    {
+        memcpy(dst, r->buf + r->pos, n * sizeof(double));
+        r->pos += n * sizeof(double);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = snap_get_f64(r);
+}
+
+/**
+ * @brief 是否恰好读完且未越界 / Whether the reader consumed every byte without running past the end.
+ *
+ * @param r 读取端 / Reader
+ * @return 非 0 表示读完 / Non-zero when done
+ */
+int snap_reader_done(const snap_reader_t *r)
+{
+    return !r->fail && r->pos == r->len;
+}
+
+/**
+ * @brief 原子地写快照文件：写入 "<path>.tmp" 后改名覆盖 / Write a snapshot file atomically via "<path>.tmp" and a rename.
+ *
+ * @param path 目标路径 / Target path
+ * @param buf 快照 / Snapshot
+ * @param len 字节数 / Byte count
+ * @return 0 表示成功；非 0 表示失败（原文件保持不变）。
+ *         0 on success; non-zero on failure (the old file is left untouched).
+ */
+int snap_file_write(const char *path, const unsigned char *buf, size_t len)
+{
+    if (path == NULL || buf == NULL)
+    {
+        fprintf(stderr, "snap_file_write: invalid arguments.\n");
+        return -1;
+    }
+
+    const size_t plen = strlen(path);
+    char *tmp = (char *)malloc(plen + 5);
+    if (tmp == NULL)
+    {
+        fprintf(stderr, "snap_file_write: out of memory.\n");
+        return -1;
+    }
+    memcpy(tmp, path, plen);
+    memcpy(tmp + plen, ".tmp", 5);
+
+    FILE *fp = fopen(tmp, "wb");
+    int rc = -1;
+    if (fp != NULL)
+    {
+        const int wrote = fwrite(buf, 1, len, fp) == len;
+        const int closed = fclose(fp) == 0;
+        if (wrote && closed)
+        {
+            rc = rename(tmp, path);
+            /* Windows 上 rename 不覆盖已有文件 / rename does not replace an existing file on Windows */
+            if (rc != 0 && remove(path) == 0)
+                rc = rename(tmp, path);
+        }
+        if (rc != 0)
+            remove(tmp);
+    }
+    if (rc != 0)
+        fprintf(stderr, "snap_file_write: cannot write '%s'.\n", path);
+    free(tmp);
+    return rc;
+}
+
+/**
+ * @brief 读入整个快照文件 / Read a whole snapshot file.
+ *
+ * @param path 路径 / Path
+ * @param buf 输出：malloc 得到的内容，由调用方 free / Out: malloc'ed contents, freed by the caller
+ * @param len 输出：字节数 / Out: byte count
+ * @return 0 表示成功；非 0 表示失败。0 on success, non-zero on failure.
+ */
+int snap_file_read(const char *path, unsigned char **buf, size_t *len)
+{
+    unsigned char *data = NULL;
+    size_t n = 0;
+    size_t cap = 0;
+
+    if (path == NULL || buf == NULL || len == NULL)
+    {
+        fprintf(stderr, "snap_file_read: invalid arguments.\n");
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "snap_file_read: cannot open '%s'.\n", path);
+        return -1;
+    }
+    for (;;)
+    {
+        if (n == cap)
+        {
+            const size_t ncap = (cap > 0) ? 2 * cap : 4096;
+            unsigned char *grown = (unsigned char *)realloc(data, ncap);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "snap_file_read: out of memory.\n");
+                free(data);
+                fclose(fp);
+                return -1;
+            }
+            data = grown;
+            cap = ncap;
+        }
+        const size_t got = fread(data + n, 1, cap - n, fp);
+        n += got;
+        if (got == 0)
+            break;
+    }
+    if (ferror(fp))
+    {
+        fprintf(stderr, "snap_file_read: read error on '%s'.\n", path);
+        free(data);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    *buf = data;
+    *len = n;
+    return 0;
+}